@@ -27,6 +27,7 @@
 
 #include <picoapi.h>
 #include <picoapid.h>
+#include <picoextapi.h>
 #include <picoos.h>
 
 
@@ -95,9 +96,21 @@ size_t myread(FILE *source, char **buffer) {
     } while (1);
 }
 
+/* writes 'bytes' bytes of 16 bit or float samples */
+static picoos_bool putSamples(picoos_SDFile sdOutFile, int useFloat,
+        int8_t * buffer, size_t bytes) {
+    if (useFloat) {
+        return picoos_sdfPutFloatSamples(sdOutFile, bytes / 4,
+                (picoos_single *) buffer);
+    }
+    return picoos_sdfPutSamples(sdOutFile, bytes / 2, (picoos_int16 *) buffer);
+}
+
 int main(int argc, const char *argv[]) {
     char * wavefile = NULL;
     char * lang = "en-US";
+    int rate = SAMPLE_FREQ_16KHZ;
+    int useFloat = 0;
     int langIndex = -1, langIndexTmp = -1;
     char * text = NULL;
     int8_t * buffer;
@@ -112,6 +125,10 @@ int main(int argc, const char *argv[]) {
 		  "Write output to this WAV file (extension SHOULD be .wav)", "filename.wav" },
 		{ "lang", 'l', POPT_ARG_STRING | POPT_ARGFLAG_SHOW_DEFAULT, &lang, 0,
 		  "Language", "lang" },
+		{ "rate", 'r', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT, &rate, 0,
+		  "Sample rate (8000, 16000, 22050, 24000 or 48000)", "Hz" },
+		{ "float", 'f', POPT_ARG_NONE, &useFloat, 0,
+		  "Write 32 bit float samples (wav format 3)", NULL },
 		POPT_AUTOHELP
 		POPT_TABLEEND
 	};
@@ -262,6 +279,20 @@ int main(int argc, const char *argv[]) {
         goto unloadUtppResource;
     }
 
+    /* Set the output sample rate. */
+    if((ret = picoext_setVoiceOption( picoSystem, (const pico_Char *) PICO_VOICE_NAME, PICOEXT_VOICEOPT_SIG_RATE, rate ))) {
+        pico_getSystemStatusMessage(picoSystem, ret, outMessage);
+        fprintf(stderr, "Cannot set the sample rate to %i (%i): %s\n", rate, ret, outMessage);
+        goto unloadUtppResource;
+    }
+
+    /* Set the output format. */
+    if(useFloat && (ret = picoext_setVoiceOption( picoSystem, (const pico_Char *) PICO_VOICE_NAME, PICOEXT_VOICEOPT_SIG_FORMAT, PICO_DATA_FLOAT_32BIT ))) {
+        pico_getSystemStatusMessage(picoSystem, ret, outMessage);
+        fprintf(stderr, "Cannot set float output (%i): %s\n", ret, outMessage);
+        goto unloadUtppResource;
+    }
+
     /* Create a new Pico engine. */
     if((ret = pico_newEngine( picoSystem, (const pico_Char *) PICO_VOICE_NAME, &picoEngine ))) {
         pico_getSystemStatusMessage(picoSystem, ret, outMessage);
@@ -282,7 +313,7 @@ int main(int argc, const char *argv[]) {
 
     picoos_bool done = TRUE;
     if(TRUE != (done = picoos_sdfOpenOut(common, &sdOutFile,
-        (picoos_char *) wavefile, SAMPLE_FREQ_16KHZ, PICOOS_ENC_LIN)))
+        (picoos_char *) wavefile, rate, useFloat ? PICOOS_ENC_FLOAT : PICOOS_ENC_LIN)))
     {
         fprintf(stderr, "Cannot open output wave file\n");
         ret = 1;
@@ -318,10 +349,7 @@ int main(int argc, const char *argv[]) {
                     memcpy(buffer+bufused, (int8_t *) outbuf, bytes_recv);
                     bufused += bytes_recv;
                 } else {
-                    done = picoos_sdfPutSamples(
-                                        sdOutFile,
-                                        bufused / 2,
-                                        (picoos_int16*) (buffer));
+                    done = putSamples(sdOutFile, useFloat, buffer, bufused);
                     bufused = 0;
                     memcpy(buffer, (int8_t *) outbuf, bytes_recv);
                     bufused += bytes_recv;
@@ -330,10 +358,7 @@ int main(int argc, const char *argv[]) {
         } while (PICO_STEP_BUSY == getstatus);
         /* This chunk of synthesis is finished; pass the remaining samples. */
         if (!picoSynthAbort) {
-                    done = picoos_sdfPutSamples(
-                                        sdOutFile,
-                                        bufused / 2,
-                                        (picoos_int16*) (buffer));
+                    done = putSamples(sdOutFile, useFloat, buffer, bufused);
         }
         picoSynthAbort = 0;
     }
@@ -145,6 +145,8 @@ int main(int argc, const char *argv[]) {
     float speed_scale = 1.0f;
     float formant_shift = 0.0f;
     int show_stats = 0;
+    pico_quality_context_t quality;
+    char * speed_text = NULL;
 #endif
 
     /* Parsing options */
@@ -237,7 +239,7 @@ int main(int argc, const char *argv[]) {
 #if PICO_USE_QUALITY_ENHANCE
     /* Initialize quality enhancements */
     printf("Initializing PicoTTS with quality enhancements...\n");
-    if (pico_quality_init() != PICO_OK) {
+    if (pico_quality_init(&quality) != PICO_OK) {
         fprintf(stderr, "Warning: Failed to initialize quality enhancements\n");
     } else {
         printf("Quality enhancements enabled\n");
@@ -246,19 +248,19 @@ int main(int argc, const char *argv[]) {
         if (voice_profile) {
             printf("Applying voice profile: %s\n", voice_profile);
             if (!strcmp(voice_profile, "male")) {
-                pico_apply_voice_profile(PICO_VOICE_PROFILE_MALE);
+                pico_apply_voice_profile(&quality, PICO_VOICE_PROFILE_MALE);
             } else if (!strcmp(voice_profile, "female")) {
-                pico_apply_voice_profile(PICO_VOICE_PROFILE_FEMALE);
+                pico_apply_voice_profile(&quality, PICO_VOICE_PROFILE_FEMALE);
             } else if (!strcmp(voice_profile, "child")) {
-                pico_apply_voice_profile(PICO_VOICE_PROFILE_CHILD);
+                pico_apply_voice_profile(&quality, PICO_VOICE_PROFILE_CHILD);
             } else if (!strcmp(voice_profile, "robot")) {
-                pico_apply_voice_profile(PICO_VOICE_PROFILE_ROBOT);
+                pico_apply_voice_profile(&quality, PICO_VOICE_PROFILE_ROBOT);
             } else if (!strcmp(voice_profile, "slow")) {
-                pico_apply_voice_profile(PICO_VOICE_PROFILE_SLOW);
+                pico_apply_voice_profile(&quality, PICO_VOICE_PROFILE_SLOW);
             } else if (!strcmp(voice_profile, "fast")) {
-                pico_apply_voice_profile(PICO_VOICE_PROFILE_FAST);
+                pico_apply_voice_profile(&quality, PICO_VOICE_PROFILE_FAST);
             } else if (!strcmp(voice_profile, "default")) {
-                pico_apply_voice_profile(PICO_VOICE_PROFILE_DEFAULT);
+                pico_apply_voice_profile(&quality, PICO_VOICE_PROFILE_DEFAULT);
             } else {
                 fprintf(stderr, "Warning: Unknown voice profile '%s', using default\n", voice_profile);
             }
@@ -268,11 +270,11 @@ int main(int argc, const char *argv[]) {
         if (quality_mode) {
             printf("Setting quality mode: %s\n", quality_mode);
             if (!strcmp(quality_mode, "speed")) {
-                pico_set_quality_mode(PICO_QUALITY_MODE_SPEED);
+                pico_set_quality_mode(&quality, PICO_QUALITY_MODE_SPEED);
             } else if (!strcmp(quality_mode, "balanced")) {
-                pico_set_quality_mode(PICO_QUALITY_MODE_BALANCED);
+                pico_set_quality_mode(&quality, PICO_QUALITY_MODE_BALANCED);
             } else if (!strcmp(quality_mode, "high")) {
-                pico_set_quality_mode(PICO_QUALITY_MODE_QUALITY);
+                pico_set_quality_mode(&quality, PICO_QUALITY_MODE_QUALITY);
             } else {
                 fprintf(stderr, "Warning: Unknown quality mode '%s', using balanced\n", quality_mode);
             }
@@ -281,12 +283,12 @@ int main(int argc, const char *argv[]) {
         /* Apply custom parameters */
         if (pitch_scale != 1.0f || speed_scale != 1.0f || formant_shift != 0.0f) {
             pico_voice_params_t params;
-            pico_get_voice_params(&params);
+            pico_get_voice_params(&quality, &params);
             params.pitch_scale = pitch_scale;
             params.speed_scale = speed_scale;
             params.formant_shift = formant_shift;
             
-            if (pico_set_voice_params(&params) == PICO_OK) {
+            if (pico_set_voice_params(&quality, &params) == PICO_OK) {
                 printf("Custom parameters: pitch=%.2f, speed=%.2f, formant=%.0fHz\n",
                        pitch_scale, speed_scale, formant_shift);
             } else {
@@ -374,6 +376,26 @@ int main(int argc, const char *argv[]) {
         goto unloadUtppResource;
     }
 
+#if PICO_USE_QUALITY_ENHANCE
+    /* Pitch, formant and noise shaping are done by the engine's signal
+       generation, set up from the voice options at engine creation */
+    if((ret = pico_quality_set_voice_options(&quality, picoSystem, (const pico_Char *) PICO_VOICE_NAME))) {
+        pico_getSystemStatusMessage(picoSystem, ret, outMessage);
+        fprintf(stderr, "Cannot set the voice options (%i): %s\n", ret, outMessage);
+        goto unloadUtppResource;
+    }
+
+    /* Speed is applied as <speed> markup around the text */
+    if (pico_get_speed_level(&quality) != 100) {
+        size_t len = strlen(text) + 40;
+        if ((speed_text = malloc(len)) != NULL) {
+            snprintf(speed_text, len, "<speed level=\"%i\">%s</speed>",
+                     (int) pico_get_speed_level(&quality), text);
+            text = speed_text;
+        }
+    }
+#endif
+
     /* Create a new Pico engine */
     if((ret = pico_newEngine(picoSystem, (const pico_Char *) PICO_VOICE_NAME, &picoEngine))) {
         pico_getSystemStatusMessage(picoSystem, ret, outMessage);
@@ -458,7 +480,7 @@ int main(int argc, const char *argv[]) {
     /* Show statistics if requested */
     if (show_stats) {
         pico_quality_stats_t stats;
-        if (pico_get_quality_stats(&stats) == PICO_OK) {
+        if (pico_get_quality_stats(&quality, &stats) == PICO_OK) {
             printf("\nQuality Enhancement Statistics:\n");
             printf("  Noise samples generated: %u\n", stats.noise_samples_generated);
             printf("  Filter updates: %u\n", stats.filter_updates);
@@ -468,7 +490,8 @@ int main(int argc, const char *argv[]) {
     }
     
     /* Cleanup quality enhancements */
-    pico_quality_cleanup();
+    pico_quality_cleanup(&quality);
+    free(speed_text);
 #endif
 
 disposeEngine:
@@ -0,0 +1,3180 @@
+/* picobench.c
+ *
+ * Copyright (C) 2024 PicoTTS Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *   Microbenchmarks for individual parts of the Pico engine. Each
+ *   benchmark is selected by name on the command line, e.g.
+ *
+ *     picobench lex lang/en-US_ta.bin
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+
+#include <picoapi.h>
+#include <picoapid.h>
+#include <picoextapi.h>
+#include <picoos.h>
+#include <picorsrc.h>
+#include <picoknow.h>
+#include <picoklex.h>
+#include <picoktab.h>
+#include <picokdt.h>
+#include <picodata.h>
+#include <picopam.h>
+#include <picosigk.h>
+#include <picofftsg.h>
+#include <picosigrs.h>
+#include <picosigts.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define BENCH_CYCLES 1
+#endif
+
+#define PICO_MEM_SIZE       8000000
+#define BENCH_VOICE_NAME    "BenchVoice"
+
+/* lexicon layout, cf. picoklex.c */
+#define LEX_SIE_SIZE        5
+#define LEX_BLOCK_SIZE      512
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* bench system with a set of resources combined into one voice */
+typedef struct {
+    void *mem;
+    pico_System system;
+    pico_Resource resource[4];
+    int numResources;
+    picorsrc_Voice voice;
+} bench_t;
+
+static int benchOpen(bench_t *b, int numFiles, char *files[])
+{
+    pico_Retstring msg;
+    pico_Retstring name;
+    int i, ret;
+
+    memset(b, 0, sizeof(*b));
+    b->mem = malloc(PICO_MEM_SIZE);
+    if ((NULL == b->mem) || pico_initialize(b->mem, PICO_MEM_SIZE, &b->system)) {
+        fprintf(stderr, "cannot initialize pico\n");
+        return 1;
+    }
+    ret = pico_createVoiceDefinition(b->system, (const pico_Char *)BENCH_VOICE_NAME);
+    for (i = 0; (0 == ret) && (i < numFiles) && (i < 4); i++) {
+        ret = pico_loadResource(b->system, (const pico_Char *)files[i], &b->resource[i]);
+        if (0 == ret) {
+            b->numResources++;
+            pico_getResourceName(b->system, b->resource[i], name);
+            ret = pico_addResourceToVoiceDefinition(b->system,
+                    (const pico_Char *)BENCH_VOICE_NAME, (const pico_Char *)name);
+        }
+    }
+    if (0 == ret) {
+        ret = picorsrc_createVoice(b->system->rm, (picoos_char *)BENCH_VOICE_NAME, &b->voice);
+    }
+    if (ret) {
+        pico_getSystemStatusMessage(b->system, ret, msg);
+        fprintf(stderr, "cannot load resources (%i): %s\n", ret, msg);
+        return 1;
+    }
+    return 0;
+}
+
+static void benchClose(bench_t *b)
+{
+    int i;
+
+    if (NULL != b->voice) {
+        picorsrc_releaseVoice(b->system->rm, &b->voice);
+    }
+    pico_releaseVoiceDefinition(b->system, (const pico_Char *)BENCH_VOICE_NAME);
+    for (i = 0; i < b->numResources; i++) {
+        pico_unloadResource(b->system, &b->resource[i]);
+    }
+    pico_terminate(&b->system);
+    free(b->mem);
+}
+
+static void benchMemUsage(bench_t *b)
+{
+    pico_Int32 used, incr, max;
+
+    picoext_getSystemMemUsage(b->system, 0, &used, &incr, &max);
+    printf("system memory used: %d bytes\n", (int)used);
+}
+
+/* read a text file into a null-terminated buffer */
+static char *readText(const char *fileName)
+{
+    FILE *f;
+    long len;
+    char *text;
+
+    f = fopen(fileName, "rb");
+    if (NULL == f) {
+        fprintf(stderr, "cannot open %s\n", fileName);
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    text = malloc(len + 1);
+    if ((NULL != text) && (fread(text, 1, len, f) != (size_t)len)) {
+        free(text);
+        text = NULL;
+    }
+    if (NULL != text) {
+        text[len] = '\0';
+    }
+    fclose(f);
+    return text;
+}
+
+/* synthesize 'text' (and a trailing flush); returns the number of samples
+   or -1 on error, a checksum of the samples is returned in 'sum' and the
+   speech data is written to 'out' unless NULL */
+static long benchSpeakTo(pico_Engine engine, const char *text, unsigned long *sum,
+                         FILE *out)
+{
+    const pico_Char *p = (const pico_Char *)text;
+    pico_Int32 rem = (pico_Int32)strlen(text) + 1;
+    pico_Int16 sent, recv, type, chunk;
+    pico_Int16 buf[512];
+    long samples = 0;
+    int ret, i;
+
+    *sum = 0;
+    while (rem > 0) {
+        chunk = (rem > 30000) ? 30000 : (pico_Int16)rem;
+        if (pico_putTextUtf8(engine, p, chunk, &sent)) {
+            return -1;
+        }
+        rem -= sent;
+        p += sent;
+        do {
+            ret = pico_getData(engine, buf, sizeof(buf), &recv, &type);
+            if ((PICO_STEP_BUSY != ret) && (PICO_STEP_IDLE != ret)) {
+                return -1;
+            }
+            for (i = 0; i < recv / 2; i++) {
+                *sum = *sum * 31 + (unsigned short)buf[i];
+            }
+            if ((NULL != out) && (recv > 0)) {
+                fwrite(buf, 1, recv, out);
+            }
+            samples += recv / 2;
+        } while (PICO_STEP_BUSY == ret);
+    }
+    return samples;
+}
+
+static long benchSpeak(pico_Engine engine, const char *text, unsigned long *sum)
+{
+    return benchSpeakTo(engine, text, sum, NULL);
+}
+
+
+/* ****************************************************************************/
+/* lex: lexicon lookups over all graphs of the main lexicon                   */
+/* ****************************************************************************/
+
+static int benchLex(int argc, char *argv[])
+{
+    bench_t b;
+    picoknow_KnowledgeBase kb;
+    picoklex_Lex lex;
+    picoklex_lexl_result_t lexres;
+    picoos_uint8 *lexblocks;
+    picoos_uint32 nrblocks, lexpos, lexposEnd, numGraphs, numFound, i;
+    picoos_uint32 *graphPos;
+    int iter, numIter;
+    double t0, t1;
+
+    if (argc < 1) {
+        fprintf(stderr, "usage: picobench lex <ta.bin> [iterations]\n");
+        return 1;
+    }
+    numIter = (argc > 1) ? atoi(argv[1]) : 20;
+    if (benchOpen(&b, 1, argv)) {
+        return 1;
+    }
+    benchMemUsage(&b);
+
+    kb = b.voice->kbArray[PICOKNOW_KBID_LEX_MAIN];
+    lex = picoklex_getLex(kb);
+    if ((NULL == kb) || (NULL == lex)) {
+        fprintf(stderr, "resource has no main lexicon\n");
+        benchClose(&b);
+        return 1;
+    }
+
+    /* collect the positions of all lexentries */
+    nrblocks = kb->base[0] | ((picoos_uint32)kb->base[1] << 8);
+    lexblocks = kb->base + 2 + nrblocks * LEX_SIE_SIZE;
+    lexposEnd = nrblocks * LEX_BLOCK_SIZE;
+    graphPos = malloc(lexposEnd / 2 * sizeof(picoos_uint32));
+    numGraphs = 0;
+    lexpos = 0;
+    while (lexpos < lexposEnd) {
+        graphPos[numGraphs++] = lexpos;
+        lexpos += lexblocks[lexpos];
+        lexpos += lexblocks[lexpos];
+        while ((lexpos < lexposEnd) && (0 == lexblocks[lexpos])) {
+            lexpos++;
+        }
+    }
+
+    numFound = 0;
+    t0 = now();
+    for (iter = 0; iter < numIter; iter++) {
+        for (i = 0; i < numGraphs; i++) {
+            lexpos = graphPos[i];
+            numFound += picoklex_lexLookup(lex, &lexblocks[lexpos + 1],
+                                           lexblocks[lexpos] - 1, &lexres);
+        }
+    }
+    t1 = now();
+
+    printf("lexentries: %u, found: %u\n", numGraphs, numFound / numIter);
+    printf("lookups/sec: %.0f\n", (double)numGraphs * numIter / (t1 - t0));
+
+    free(graphPos);
+    benchClose(&b);
+    return 0;
+}
+
+
+/* ****************************************************************************/
+/* graphs: graph table lookups as done by the tokenizer                      */
+/* ****************************************************************************/
+
+/* encode code point 'c' as null-terminated UTF8 */
+static void benchUtf8(picoos_uint32 c, picoos_uchar *s)
+{
+    if (c < 0x80) {
+        *s++ = (picoos_uchar)c;
+    } else if (c < 0x800) {
+        *s++ = (picoos_uchar)(0xc0 | (c >> 6));
+        *s++ = (picoos_uchar)(0x80 | (c & 0x3f));
+    } else if (c < 0x10000) {
+        *s++ = (picoos_uchar)(0xe0 | (c >> 12));
+        *s++ = (picoos_uchar)(0x80 | ((c >> 6) & 0x3f));
+        *s++ = (picoos_uchar)(0x80 | (c & 0x3f));
+    } else {
+        *s++ = (picoos_uchar)(0xf0 | (c >> 18));
+        *s++ = (picoos_uchar)(0x80 | ((c >> 12) & 0x3f));
+        *s++ = (picoos_uchar)(0x80 | ((c >> 6) & 0x3f));
+        *s++ = (picoos_uchar)(0x80 | (c & 0x3f));
+    }
+    *s = 0;
+}
+
+/* decode the first code point of 'str' */
+static picoos_uint32 benchUtf32(const picoos_uchar *s)
+{
+    if (s[0] < 0x80) {
+        return s[0];
+    } else if (s[0] < 0xe0) {
+        return ((s[0] & 0x1f) << 6) | (s[1] & 0x3f);
+    } else if (s[0] < 0xf0) {
+        return ((s[0] & 0x0f) << 12) | ((s[1] & 0x3f) << 6) | (s[2] & 0x3f);
+    }
+    return ((s[0] & 0x07) << 18) | ((s[1] & 0x3f) << 12)
+            | ((s[2] & 0x3f) << 6) | (s[3] & 0x3f);
+}
+
+static int benchGraphs(int argc, char *argv[])
+{
+    bench_t b;
+    picoktab_Graphs graphs;
+    picoos_uchar from[8], to[8], lowercase[8], gs1[8], gs2[8];
+    picoos_uint8 propset, ttype, tsubtype, value, punct, type;
+    picoos_int8 subtype;
+    picoos_uchar (*chars)[8];
+    picoktab_graph_props_t props;
+    picoos_uint32 numEntries, numChars, c, cTo, i, id, sum, sumProps;
+    int iter, numIter;
+    double t0, t1;
+
+    if (argc < 1) {
+        fprintf(stderr, "usage: picobench graphs <ta.bin> [iterations]\n");
+        return 1;
+    }
+    numIter = (argc > 1) ? atoi(argv[1]) : 200;
+    if (benchOpen(&b, 1, argv)) {
+        return 1;
+    }
+    benchMemUsage(&b);
+
+    graphs = picoktab_getGraphs(b.voice->kbArray[PICOKNOW_KBID_TAB_GRAPHS]);
+    if (NULL == graphs) {
+        fprintf(stderr, "resource has no graph table\n");
+        benchClose(&b);
+        return 1;
+    }
+
+    /* every char of every graph range, plus a few chars that are missing */
+    numEntries = picoktab_graphsGetNumEntries(graphs);
+    numChars = 0;
+    for (i = 0; i < numEntries; i++) {
+        picoktab_graphsGetGraphInfo(graphs, (picoos_uint16)i, from, to,
+                &propset, &ttype, &tsubtype, &value, lowercase, gs1, gs2,
+                &punct);
+        numChars += benchUtf32(to) - benchUtf32(from) + 1;
+    }
+    chars = malloc((numChars + 4) * sizeof(*chars));
+    numChars = 0;
+    for (i = 0; i < numEntries; i++) {
+        picoktab_graphsGetGraphInfo(graphs, (picoos_uint16)i, from, to,
+                &propset, &ttype, &tsubtype, &value, lowercase, gs1, gs2,
+                &punct);
+        cTo = benchUtf32(to);
+        for (c = benchUtf32(from); c <= cTo; c++) {
+            benchUtf8(c, chars[numChars++]);
+        }
+    }
+    benchUtf8(0x7f, chars[numChars++]);
+    benchUtf8(0x2fff, chars[numChars++]);
+    benchUtf8(0xfffd, chars[numChars++]);
+    benchUtf8(0x1f600, chars[numChars++]);
+
+    sum = 0;
+    t0 = now();
+    for (iter = 0; iter < numIter; iter++) {
+        for (i = 0; i < numChars; i++) {
+            type = PICODATA_ITEMINFO1_TOKTYPE_UNDEFINED;
+            subtype = -1;
+            id = picoktab_graphOffset(graphs, chars[i]);
+            if (id > 0) {
+                picoktab_getIntPropTokenType(graphs, id, &type);
+                picoktab_getIntPropTokenSubType(graphs, id, &subtype);
+            }
+            sum = sum * 31 + id + type + (picoos_uint8)subtype;
+        }
+    }
+    t1 = now();
+
+    printf("graph entries: %u, chars: %u, checksum: %08x\n", numEntries,
+           numChars, sum);
+    printf("lookups/sec: %.0f\n", (double)numChars * numIter / (t1 - t0));
+
+    /* the same with the precomputed properties */
+    sumProps = 0;
+    t0 = now();
+    for (iter = 0; iter < numIter; iter++) {
+        for (i = 0; i < numChars; i++) {
+            picoktab_getGraphProps(graphs, chars[i], &props);
+            sumProps = sumProps * 31 + props.graphsOffset + props.tokenType
+                    + (picoos_uint8)props.tokenSubType;
+        }
+    }
+    t1 = now();
+    printf("props lookups/sec: %.0f (%s)\n",
+           (double)numChars * numIter / (t1 - t0),
+           (sumProps == sum) ? "identical" : "DIFFERS");
+
+    free(chars);
+    benchClose(&b);
+    return (sumProps == sum) ? 0 : 1;
+}
+
+
+/* ****************************************************************************/
+/* kdt: decision tree classification with random input vectors               */
+/* ****************************************************************************/
+
+#define BENCH_KDT_NUM_VEC   4096
+
+/* classify random input vectors with the tree 'kbid' and add the results
+   to 'sum'; returns the number of classifications */
+static long benchKdtTree(bench_t *b, int kbid, unsigned *sum)
+{
+    picoknow_KnowledgeBase kb = b->voice->kbArray[kbid];
+    picokdt_classify_result_t res;
+    picokdt_classify_vecresult_t vres;
+    picoos_uint8 vec[PICOKDT_NRATT_PAM];
+    picoos_uint16 in[PICOKDT_NRATT_POSD];
+    picoos_uint8 word[12];
+    picoos_uint16 out;
+    picoos_uint8 flag, ok;
+    long n = 0;
+    int i, j, len;
+
+    if (NULL == kb) {
+        return 0;
+    }
+    srand(kbid);
+    for (i = 0; i < BENCH_KDT_NUM_VEC; i++) {
+        out = 0;
+        res.class = 0;
+        len = 3 + rand() % 8;
+        for (j = 0; j < len; j++) {
+            word[j] = 'a' + rand() % 26;
+        }
+        switch (kbid) {
+            case PICOKNOW_KBID_DT_POSP:
+                ok = picokdt_dtPosPconstructInVec(picokdt_getDtPosP(kb), word, len, 0)
+                    && picokdt_dtPosPclassify(picokdt_getDtPosP(kb))
+                    && picokdt_dtPosPdecomposeOutClass(picokdt_getDtPosP(kb), &res);
+                break;
+            case PICOKNOW_KBID_DT_POSD:
+                for (j = 0; j < PICOKDT_NRATT_POSD; j++) {
+                    in[j] = rand() % 16;
+                }
+                ok = picokdt_dtPosDconstructInVec(picokdt_getDtPosD(kb), in)
+                    && picokdt_dtPosDclassify(picokdt_getDtPosD(kb), &out)
+                    && picokdt_dtPosDdecomposeOutClass(picokdt_getDtPosD(kb), &res);
+                break;
+            case PICOKNOW_KBID_DT_G2P:
+                flag = 0;
+                vres.nr = 0;
+                ok = picokdt_dtG2PconstructInVec(picokdt_getDtG2P(kb), word, len,
+                        rand() % len, rand() % 16, 0, 0, &flag, 0, 0, 0)
+                    && picokdt_dtG2Pclassify(picokdt_getDtG2P(kb), &out)
+                    && picokdt_dtG2PdecomposeOutClass(picokdt_getDtG2P(kb), &vres);
+                res.class = vres.nr ? vres.classvec[0] : 0;
+                break;
+            case PICOKNOW_KBID_DT_PHR:
+                ok = picokdt_dtPHRconstructInVec(picokdt_getDtPHR(kb),
+                        rand() % 16, rand() % 16, rand() % 16, rand() % 16,
+                        rand() % 16, rand() % 10, rand() % 10, rand() % 30)
+                    && picokdt_dtPHRclassify(picokdt_getDtPHR(kb))
+                    && picokdt_dtPHRdecomposeOutClass(picokdt_getDtPHR(kb), &res);
+                break;
+            case PICOKNOW_KBID_DT_ACC:
+                ok = picokdt_dtACCconstructInVec(picokdt_getDtACC(kb),
+                        rand() % 16, rand() % 16, rand() % 16, rand() % 16,
+                        rand() % 16, rand() % 3, rand() % 3, rand() % 10,
+                        rand() % 30, rand() % 10, rand() % 30, rand() % 10,
+                        rand() % 30)
+                    && picokdt_dtACCclassify(picokdt_getDtACC(kb), &out)
+                    && picokdt_dtACCdecomposeOutClass(picokdt_getDtACC(kb), &res);
+                break;
+            default:
+                for (j = 0; j < PICOKDT_NRATT_PAM; j++) {
+                    vec[j] = rand() % 40;
+                }
+                ok = picokdt_dtPAMconstructInVec(picokdt_getDtPAM(kb), vec,
+                                                 PICOKDT_NRATT_PAM)
+                    && picokdt_dtPAMclassify(picokdt_getDtPAM(kb))
+                    && picokdt_dtPAMdecomposeOutClass(picokdt_getDtPAM(kb), &res);
+                break;
+        }
+        *sum = *sum * 31 + (ok ? 1 + res.class + out : 0);
+        n++;
+    }
+    return n;
+}
+
+static int benchKdt(int argc, char *argv[])
+{
+    static const int kbids[] = {
+        PICOKNOW_KBID_DT_POSP, PICOKNOW_KBID_DT_POSD, PICOKNOW_KBID_DT_G2P,
+        PICOKNOW_KBID_DT_PHR, PICOKNOW_KBID_DT_ACC, PICOKNOW_KBID_DT_DUR,
+        PICOKNOW_KBID_DT_LFZ1, PICOKNOW_KBID_DT_LFZ2, PICOKNOW_KBID_DT_LFZ3,
+        PICOKNOW_KBID_DT_LFZ4, PICOKNOW_KBID_DT_LFZ5, PICOKNOW_KBID_DT_MGC1,
+        PICOKNOW_KBID_DT_MGC2, PICOKNOW_KBID_DT_MGC3, PICOKNOW_KBID_DT_MGC4,
+        PICOKNOW_KBID_DT_MGC5
+    };
+    bench_t b;
+    unsigned sum;
+    long n;
+    int iter, numIter;
+    size_t i;
+    double t0, t1;
+
+    if (argc < 2) {
+        fprintf(stderr, "usage: picobench kdt <ta.bin> <sg.bin> [iterations]\n");
+        return 1;
+    }
+    numIter = (argc > 2) ? atoi(argv[2]) : 20;
+    if (benchOpen(&b, 2, argv)) {
+        return 1;
+    }
+    benchMemUsage(&b);
+
+    sum = 0;
+    n = 0;
+    t0 = now();
+    for (iter = 0; iter < numIter; iter++) {
+        for (i = 0; i < sizeof(kbids) / sizeof(kbids[0]); i++) {
+            n += benchKdtTree(&b, kbids[i], &sum);
+        }
+    }
+    t1 = now();
+    printf("classifications: %ld, checksum: %08x\n", n / numIter, sum);
+    printf("classifications/sec: %.0f\n", (double)n / (t1 - t0));
+
+    benchClose(&b);
+    return 0;
+}
+
+
+/* ****************************************************************************/
+/* g2p: right-to-left G2P of long random words, per grapheme and per word    */
+/* ****************************************************************************/
+
+#define BENCH_G2P_NUM_WORDS 512
+
+/* run the G2P tree over all graphemes of random words of 8 to 40 letters,
+   constructing the input vectors per grapheme or from a prepared word */
+static long benchG2PRun(picokdt_DtG2P dt, int perWord, unsigned *sum)
+{
+    static picokdt_g2p_word_t wordAtt;
+    picokdt_classify_vecresult_t vres;
+    picoos_uint8 word[40];
+    picoos_uint16 out, h1, h2, h3;
+    picoos_uint8 flag, ok, pos;
+    long n = 0;
+    int i, j, len;
+
+    srand(1);
+    for (i = 0; i < BENCH_G2P_NUM_WORDS; i++) {
+        len = 8 + rand() % 33;
+        for (j = 0; j < len; j++) {
+            word[j] = 'a' + rand() % 26;
+        }
+        pos = rand() % 16;
+        if (perWord && !picokdt_dtG2PprepareWord(dt, &wordAtt, word, len, pos)) {
+            return 0;
+        }
+        flag = 0;
+        h1 = h2 = h3 = PICOKDT_HISTORY_ZERO;
+        for (j = len - 1; j >= 0; j--) {
+            out = 0;
+            vres.nr = 0;
+            if (perWord) {
+                ok = picokdt_dtG2PconstructWordInVec(dt, &wordAtt, j, 0, 0,
+                                                     &flag, h1, h2, h3);
+            } else {
+                ok = picokdt_dtG2PconstructInVec(dt, word, len, j, pos, 0, 0,
+                                                 &flag, h1, h2, h3);
+            }
+            ok = ok && picokdt_dtG2Pclassify(dt, &out)
+                && picokdt_dtG2PdecomposeOutClass(dt, &vres);
+            *sum = *sum * 31 + (ok ? 1 + out + (vres.nr ? vres.classvec[0] : 0) : 0);
+            h3 = h2;
+            h2 = h1;
+            h1 = out;
+            n++;
+        }
+    }
+    return n;
+}
+
+static int benchG2P(int argc, char *argv[])
+{
+    picoknow_KnowledgeBase kb;
+    bench_t b;
+    unsigned sum[2];
+    long n;
+    int iter, numIter, perWord;
+    double t0, t1;
+
+    if (argc < 1) {
+        fprintf(stderr, "usage: picobench g2p <ta.bin> [iterations]\n");
+        return 1;
+    }
+    numIter = (argc > 1) ? atoi(argv[1]) : 20;
+    if (benchOpen(&b, 1, argv)) {
+        return 1;
+    }
+    kb = b.voice->kbArray[PICOKNOW_KBID_DT_G2P];
+    if (NULL == kb) {
+        fprintf(stderr, "no G2P tree in %s\n", argv[0]);
+        benchClose(&b);
+        return 1;
+    }
+
+    for (perWord = 0; perWord < 2; perWord++) {
+        sum[perWord] = 0;
+        n = 0;
+        t0 = now();
+        for (iter = 0; iter < numIter; iter++) {
+            n += benchG2PRun(picokdt_getDtG2P(kb), perWord, &sum[perWord]);
+        }
+        t1 = now();
+        printf("%s: graphemes: %ld, checksum: %08x, graphemes/sec: %.0f\n",
+               perWord ? "per word" : "per grapheme", n / numIter,
+               sum[perWord], (double)n / (t1 - t0));
+    }
+
+    benchClose(&b);
+    return (sum[0] == sum[1]) ? 0 : 1;
+}
+
+
+/* ****************************************************************************/
+/* pcache: synthesis with and without a pronunciation cache                  */
+/* ****************************************************************************/
+
+static int benchPcacheRun(bench_t *b, const char *text, int numIter,
+                          const char *label, unsigned long *sum)
+{
+    pico_Engine engine;
+    long samples = 0;
+    int iter;
+    double t0, t1;
+
+    if (pico_newEngine(b->system, (const pico_Char *)BENCH_VOICE_NAME, &engine)) {
+        fprintf(stderr, "cannot create engine\n");
+        return 1;
+    }
+    t0 = now();
+    for (iter = 0; (iter < numIter) && (samples >= 0); iter++) {
+        samples = benchSpeak(engine, text, sum);
+    }
+    t1 = now();
+    pico_disposeEngine(b->system, &engine);
+    if (samples < 0) {
+        fprintf(stderr, "synthesis failed\n");
+        return 1;
+    }
+    printf("%-8s %ld samples, %.1f ms/pass\n", label, samples,
+           (t1 - t0) * 1000.0 / numIter);
+    return 0;
+}
+
+static int benchPcache(int argc, char *argv[])
+{
+    bench_t b;
+    char *text;
+    unsigned long sumRef, sum;
+    pico_Uint32 entries, hits, misses;
+    int numIter, ret;
+
+    if (argc < 3) {
+        fprintf(stderr, "usage: picobench pcache <ta.bin> <sg.bin> <text> "
+                "[iterations] [cachefile]\n");
+        return 1;
+    }
+    numIter = (argc > 3) ? atoi(argv[3]) : 5;
+    text = readText(argv[2]);
+    if ((NULL == text) || benchOpen(&b, 2, argv)) {
+        free(text);
+        return 1;
+    }
+
+    ret = benchPcacheRun(&b, text, numIter, "nocache", &sumRef);
+    if (0 == ret) {
+        ret = picoext_createPronCache(b.system,
+                (const pico_Char *)BENCH_VOICE_NAME, 4096);
+    }
+    if ((0 == ret) && (argc > 4)) {
+        /* warm start from a previous run, if the file exists */
+        if (picoext_loadPronCache(b.system, (const pico_Char *)BENCH_VOICE_NAME,
+                (const pico_Char *)argv[4])) {
+            printf("no cache loaded from %s\n", argv[4]);
+        }
+    }
+    if (0 == ret) {
+        ret = benchPcacheRun(&b, text, numIter, "pcache", &sum);
+    }
+    if (0 == ret) {
+        picoext_getPronCacheStats(b.system, (const pico_Char *)BENCH_VOICE_NAME,
+                &entries, &hits, &misses);
+        printf("cache entries: %u, hits: %u, misses: %u\n",
+               (unsigned)entries, (unsigned)hits, (unsigned)misses);
+        printf("output %s\n", (sum == sumRef) ? "identical" : "DIFFERS");
+        benchMemUsage(&b);
+        if (sum != sumRef) {
+            ret = 1;
+        }
+    }
+    if ((0 == ret) && (argc > 4)) {
+        ret = picoext_savePronCache(b.system, (const pico_Char *)BENCH_VOICE_NAME,
+                (const pico_Char *)argv[4]);
+    }
+
+    /* the bench voice holds no reference to the cache, release it first so
+       that the voice definition can be released */
+    picoext_releasePronCache(b.system, (const pico_Char *)BENCH_VOICE_NAME);
+    benchClose(&b);
+    free(text);
+    return (0 == ret) ? 0 : 1;
+}
+
+
+/* ****************************************************************************/
+/* dtcache: synthesis with the decision tree cache disabled and enabled      */
+/* ****************************************************************************/
+
+/* synthesize 'text' with a new engine, with or without its decision tree
+   cache; the cache statistics are returned in 'hits' and 'misses' */
+static int benchDtCacheRun(bench_t *b, const char *text, int numIter,
+                           int enabled, unsigned long *sum,
+                           pico_Uint32 *hits, pico_Uint32 *misses)
+{
+    pico_Engine engine;
+    pico_Int16 rate;
+    long samples = 0;
+    int iter;
+    double t0, t1;
+
+    if (pico_newEngine(b->system, (const pico_Char *)BENCH_VOICE_NAME, &engine)) {
+        fprintf(stderr, "cannot create engine\n");
+        return 1;
+    }
+    if (picoext_setDtCacheEnabled(engine, enabled)) {
+        fprintf(stderr, "no decision tree cache, build with "
+                "-DPICO_USE_DT_CACHE=1\n");
+        pico_disposeEngine(b->system, &engine);
+        return 1;
+    }
+    t0 = now();
+    for (iter = 0; (iter < numIter) && (samples >= 0); iter++) {
+        samples = benchSpeak(engine, text, sum);
+    }
+    t1 = now();
+    picoext_getDtCacheStats(engine, hits, misses, &rate);
+    pico_disposeEngine(b->system, &engine);
+    if (samples < 0) {
+        fprintf(stderr, "synthesis failed\n");
+        return 1;
+    }
+    printf("%-8s %ld samples, %.1f ms/pass\n", enabled ? "dtcache" : "nocache",
+           samples, (t1 - t0) * 1000.0 / numIter);
+    return 0;
+}
+
+static int benchDtCache(int argc, char *argv[])
+{
+    bench_t b;
+    char *text;
+    unsigned long sumRef, sum;
+    pico_Uint32 hits, misses;
+    int numIter, ret;
+
+    if (argc < 3) {
+        fprintf(stderr, "usage: picobench dtcache <ta.bin> <sg.bin> <text> "
+                "[iterations]\n");
+        return 1;
+    }
+    numIter = (argc > 3) ? atoi(argv[3]) : 5;
+    text = readText(argv[2]);
+    if ((NULL == text) || benchOpen(&b, 2, argv)) {
+        free(text);
+        return 1;
+    }
+
+    ret = benchDtCacheRun(&b, text, numIter, 0, &sumRef, &hits, &misses);
+    if (0 == ret) {
+        ret = benchDtCacheRun(&b, text, numIter, 1, &sum, &hits, &misses);
+    }
+    if (0 == ret) {
+        printf("hits: %u, misses: %u, hit rate: %u%%\n",
+               (unsigned)hits, (unsigned)misses,
+               (unsigned)((hits + misses > 0) ? hits * 100 / (hits + misses) : 0));
+        printf("output %s\n", (sum == sumRef) ? "identical" : "DIFFERS");
+        if (sum != sumRef) {
+            ret = 1;
+        }
+    }
+
+    benchClose(&b);
+    free(text);
+    return (0 == ret) ? 0 : 1;
+}
+
+
+/* ****************************************************************************/
+/* cepsolver: synthesis with the scalar and the lane MGC solvers             */
+/* ****************************************************************************/
+
+/* synthesize 'text' with a new engine using MGC solver 'solver' */
+static int benchCepSolverRun(bench_t *b, const char *text, int numIter,
+                             int solver, unsigned long *sum)
+{
+    static const char *names[] = { "scalar", "fixed", "float" };
+    pico_Engine engine;
+    long samples = 0;
+    int iter;
+    double t0, t1;
+
+    if (picoext_setVoiceOption(b->system, (const pico_Char *)BENCH_VOICE_NAME,
+            PICOEXT_VOICEOPT_CEP_SOLVER, solver)
+            || pico_newEngine(b->system, (const pico_Char *)BENCH_VOICE_NAME, &engine)) {
+        fprintf(stderr, "cannot create engine\n");
+        return 1;
+    }
+    t0 = now();
+    for (iter = 0; (iter < numIter) && (samples >= 0); iter++) {
+        samples = benchSpeak(engine, text, sum);
+    }
+    t1 = now();
+    pico_disposeEngine(b->system, &engine);
+    if (samples < 0) {
+        fprintf(stderr, "synthesis failed\n");
+        return 1;
+    }
+    printf("%-8s %ld samples, %.1f ms/pass\n", names[solver], samples,
+           (t1 - t0) * 1000.0 / numIter);
+    return 0;
+}
+
+static int benchCepSolver(int argc, char *argv[])
+{
+    bench_t b;
+    char *text;
+    unsigned long sumRef, sum;
+    int numIter, ret;
+
+    if (argc < 3) {
+        fprintf(stderr, "usage: picobench cepsolver <ta.bin> <sg.bin> <text> "
+                "[iterations]\n");
+        return 1;
+    }
+    numIter = (argc > 3) ? atoi(argv[3]) : 5;
+    text = readText(argv[2]);
+    if ((NULL == text) || benchOpen(&b, 2, argv)) {
+        free(text);
+        return 1;
+    }
+
+    ret = benchCepSolverRun(&b, text, numIter, PICOEXT_CEP_SOLVER_SCALAR, &sumRef);
+    if (0 == ret) {
+        ret = benchCepSolverRun(&b, text, numIter, PICOEXT_CEP_SOLVER_LANES_FIXED, &sum);
+    }
+    if (0 == ret) {
+        /* the fixed point lanes must give the same output */
+        printf("fixed output %s\n", (sum == sumRef) ? "identical" : "DIFFERS");
+        if (sum != sumRef) {
+            ret = 1;
+        }
+    }
+    if (0 == ret) {
+        ret = benchCepSolverRun(&b, text, numIter, PICOEXT_CEP_SOLVER_LANES_FLOAT, &sum);
+    }
+
+    benchClose(&b);
+    free(text);
+    return (0 == ret) ? 0 : 1;
+}
+
+/* synthesis without and with the expanded pdfs; the expansion cannot be
+   undone while the resource is loaded, so the reference runs first */
+static int benchPdfExpand(int argc, char *argv[])
+{
+    bench_t b;
+    char *text;
+    pico_Engine engine;
+    pico_Int32 used0, used1, incr, maxUsed;
+    unsigned long sum[2];
+    long samples = 0;
+    int numIter, iter, expand, ret = 0;
+    double t0, t1;
+
+    if (argc < 3) {
+        fprintf(stderr, "usage: picobench pdfexpand <ta.bin> <sg.bin> <text> "
+                "[iterations]\n");
+        return 1;
+    }
+    numIter = (argc > 3) ? atoi(argv[3]) : 5;
+    text = readText(argv[2]);
+    if ((NULL == text) || benchOpen(&b, 2, argv)) {
+        free(text);
+        return 1;
+    }
+
+    for (expand = 0; (expand < 2) && (0 == ret); expand++) {
+        picoext_getSystemMemUsage(b.system, 0, &used0, &incr, &maxUsed);
+        if (picoext_setVoiceOption(b.system, (const pico_Char *)BENCH_VOICE_NAME,
+                PICOEXT_VOICEOPT_PDF_EXPAND, expand)
+                || pico_newEngine(b.system, (const pico_Char *)BENCH_VOICE_NAME, &engine)) {
+            fprintf(stderr, "cannot create engine\n");
+            ret = 1;
+            break;
+        }
+        t0 = now();
+        for (iter = 0; (iter < numIter) && (samples >= 0); iter++) {
+            samples = benchSpeak(engine, text, &sum[expand]);
+        }
+        t1 = now();
+        pico_disposeEngine(b.system, &engine);
+        /* the engine memory is returned, the expanded pdfs stay */
+        picoext_getSystemMemUsage(b.system, 0, &used1, &incr, &maxUsed);
+        if (samples < 0) {
+            fprintf(stderr, "synthesis failed\n");
+            ret = 1;
+            break;
+        }
+        printf("%-8s %ld samples, %.1f ms/pass, system memory +%ld bytes\n",
+               expand ? "expanded" : "packed", samples,
+               (t1 - t0) * 1000.0 / numIter, (long) (used1 - used0));
+    }
+    if (0 == ret) {
+        printf("expanded output %s\n",
+               (sum[1] == sum[0]) ? "identical" : "DIFFERS");
+        if (sum[1] != sum[0]) {
+            ret = 1;
+        }
+    }
+
+    benchClose(&b);
+    free(text);
+    return ret;
+}
+
+/* synthesis without and with silent pause frames in SIG (voice option
+   PICOEXT_VOICEOPT_SIG_SILENCE); meant for texts with many pauses, e.g.
+   prompts separated by <break/> */
+static int benchSilence(int argc, char *argv[])
+{
+    bench_t b;
+    char *text;
+    pico_Engine engine;
+    unsigned long sum;
+    long samples = 0;
+    int numIter, iter, silence, ret = 0;
+    double t0, t1, ms[2];
+
+    if (argc < 3) {
+        fprintf(stderr, "usage: picobench silence <ta.bin> <sg.bin> <text> "
+                "[iterations]\n");
+        return 1;
+    }
+    numIter = (argc > 3) ? atoi(argv[3]) : 5;
+    text = readText(argv[2]);
+    if ((NULL == text) || benchOpen(&b, 2, argv)) {
+        free(text);
+        return 1;
+    }
+
+    for (silence = 0; (silence < 2) && (0 == ret); silence++) {
+        if (picoext_setVoiceOption(b.system, (const pico_Char *)BENCH_VOICE_NAME,
+                PICOEXT_VOICEOPT_SIG_SILENCE, silence)
+                || pico_newEngine(b.system, (const pico_Char *)BENCH_VOICE_NAME, &engine)) {
+            fprintf(stderr, "cannot create engine\n");
+            ret = 1;
+            break;
+        }
+        t0 = now();
+        for (iter = 0; (iter < numIter) && (samples >= 0); iter++) {
+            samples = benchSpeak(engine, text, &sum);
+        }
+        t1 = now();
+        pico_disposeEngine(b.system, &engine);
+        if (samples < 0) {
+            fprintf(stderr, "synthesis failed\n");
+            ret = 1;
+            break;
+        }
+        ms[silence] = (t1 - t0) * 1000.0 / numIter;
+        printf("%-8s %ld samples, %.1f ms/pass\n",
+               silence ? "silence" : "default", samples, ms[silence]);
+    }
+    if (0 == ret) {
+        printf("saved %.1f%%\n", 100.0 * (ms[0] - ms[1]) / ms[0]);
+    }
+
+    benchClose(&b);
+    free(text);
+    return ret;
+}
+
+/* ****************************************************************************/
+/* sigkernels: SIG vector kernels against the scalar reference               */
+/* ****************************************************************************/
+
+#define BENCH_SIGK_FRAMES   64
+#define BENCH_SIGK_LEN      256     /* PICODSP_FFTSIZE */
+#define BENCH_SIGK_NUM      12
+#define BENCH_SIGK_TAPS     64      /* resampler taps, 8kHz output */
+
+static const char *benchSigkNames[BENCH_SIGK_NUM] = {
+    "mac", "macReverse", "shiftRight", "addShiftLeft", "divide",
+    "normResult", "melToLin", "dot16", "ulaw", "alaw", "mulShift", "expShift"
+};
+
+/* frames of kernel input; v is modified by the kernels */
+typedef struct {
+    picoos_int32 v[BENCH_SIGK_FRAMES][2 * BENCH_SIGK_LEN];
+    picoos_int32 x[BENCH_SIGK_FRAMES][BENCH_SIGK_LEN];
+    picoos_int32 f[BENCH_SIGK_FRAMES];
+    picoos_int16 loc[BENCH_SIGK_FRAMES];
+    picoos_int16 A[BENCH_SIGK_LEN];
+    picoos_single r[BENCH_SIGK_FRAMES];
+    picoos_int16 s[BENCH_SIGK_FRAMES][BENCH_SIGK_TAPS];
+    picoos_int16 h[BENCH_SIGK_TAPS];
+    picoos_int32 dot[BENCH_SIGK_FRAMES];
+    picoos_uint8 g711[BENCH_SIGK_FRAMES][BENCH_SIGK_TAPS];
+} bench_sigk_t;
+
+static picoos_int32 benchSigkRand(picoos_int32 range)
+{
+    unsigned long r = ((unsigned long) rand() << 16) ^ (unsigned long) rand();
+    return (picoos_int32) ((long) (r % (2 * (unsigned long) range + 1)) - range);
+}
+
+/* random frames in the value ranges of picosig2 (no overflow in the
+   scalar reference) */
+static void benchSigkInit(int kernel, bench_sigk_t *d)
+{
+    int i, j;
+
+    srand(kernel + 1);
+    for (i = 0; i < BENCH_SIGK_FRAMES; i++) {
+        d->f[i] = benchSigkRand(1 << 10);
+        d->loc[i] = (picoos_int16) (rand() % (BENCH_SIGK_LEN + 1));
+        for (j = 0; j < 2 * BENCH_SIGK_LEN; j++) {
+            switch (kernel) {
+                case 3: d->v[i][j] = benchSigkRand(1 << 20); break;
+                case 4: d->v[i][j] = benchSigkRand(0x7fffffff); break;
+                case 5: d->v[i][j] = benchSigkRand(1 << 28); break;
+                case 10: d->v[i][j] = rand() % (1 << 14); break;
+                default: d->v[i][j] = benchSigkRand(1 << 24); break;
+            }
+        }
+        for (j = 0; j < BENCH_SIGK_LEN; j++) {
+            switch (kernel) {
+                case 3: d->x[i][j] = benchSigkRand(1 << 28); break;
+                case 5: d->x[i][j] = rand() % (1 << 29); break;
+                case 6: d->x[i][j] = rand() % 33; break;
+                case 11: d->x[i][j] = benchSigkRand(0x7fffffff) >> (rand() % 8); break;
+                default: d->x[i][j] = benchSigkRand(1 << 12); break;
+            }
+        }
+        for (j = 0; j < BENCH_SIGK_TAPS; j++) {
+            d->s[i][j] = (picoos_int16) benchSigkRand(32767);
+        }
+        if ((8 == kernel) || (9 == kernel)) {
+            d->s[i][0] = -32768;    /* G.711 clipping and sign edge cases */
+            d->s[i][1] = 32767;
+            d->s[i][2] = -1;
+            d->s[i][3] = 0;
+        }
+        if (0 == i % 8) {
+            d->v[i][0] = 0;     /* sign and exact division edge cases */
+            d->v[i][1] = -1;
+            d->v[i][2] = d->f[i] * 3;
+            d->v[i][3] = -(d->f[i] * 3);
+        }
+    }
+    /* filter taps in Q14 with |h| summing to less than 2 */
+    for (j = 0; j < BENCH_SIGK_TAPS; j++) {
+        d->h[j] = (picoos_int16) benchSigkRand(1 << 9);
+    }
+    /* mel-to-linear indexes: non-decreasing, A[i] >= i */
+    for (i = 0, j = 0; i < BENCH_SIGK_LEN / 2; i++) {
+        j += rand() % 3;
+        if (j < i) {
+            j = i;
+        }
+        if (j > BENCH_SIGK_LEN - 2) {
+            j = BENCH_SIGK_LEN - 2;
+        }
+        d->A[i] = (picoos_int16) j;
+    }
+}
+
+static void benchSigkRun(const picosigk_kernels_t *k, int kernel, bench_sigk_t *d)
+{
+    int i;
+
+    for (i = 0; i < BENCH_SIGK_FRAMES; i++) {
+        picoos_int32 *v = d->v[i];
+        switch (kernel) {
+            case 0: k->mac(v + d->loc[i], d->x[i], d->f[i], BENCH_SIGK_LEN); break;
+            case 1: k->macReverse(v + d->loc[i] + BENCH_SIGK_LEN - 1, d->x[i],
+                    d->f[i], BENCH_SIGK_LEN); break;
+            case 2: k->shiftRight(v, 18, BENCH_SIGK_LEN); break;
+            case 3: k->addShiftLeft(d->x[i], v, 9, BENCH_SIGK_LEN); break;
+            case 4: k->divide(v, (d->f[i] < 0) ? -d->f[i] + 1 : d->f[i] + 1,
+                    BENCH_SIGK_LEN); break;
+            case 5: d->r[i] = k->normResult(BENCH_SIGK_LEN, v, d->x[i]); break;
+            case 6: k->melToLin(v, d->A, d->x[i], BENCH_SIGK_LEN / 2); break;
+            case 7: d->dot[i] = k->dot16(d->s[i], d->h, BENCH_SIGK_TAPS); break;
+            case 8: k->ulaw(d->s[i], d->g711[i], BENCH_SIGK_TAPS - 1); break;
+            case 9: k->alaw(d->s[i], d->g711[i], BENCH_SIGK_TAPS - 1); break;
+            case 10: k->mulShift(v, d->x[i], v + BENCH_SIGK_LEN, 12,
+                    BENCH_SIGK_LEN); break;
+            default: k->expShift(v, d->x[i], 26, BENCH_SIGK_LEN); break;
+        }
+    }
+}
+
+/* each kernel on random frames (time per call and comparison with the
+   scalar kernels), then synthesis with each kernel set */
+static int benchSigKernels(int argc, char *argv[])
+{
+    static bench_sigk_t init, ref, work;
+    const picosigk_kernels_t *k;
+    bench_t b;
+    char *text;
+    pico_Engine engine;
+    unsigned long sum, sumRef = 0;
+    long samples = 0;
+    int numIter, iter, kernel, isa, ret = 0;
+    double t0, t;
+
+    if (argc < 3) {
+        fprintf(stderr, "usage: picobench sigkernels <ta.bin> <sg.bin> <text> "
+                "[iterations]\n");
+        return 1;
+    }
+    numIter = (argc > 3) ? atoi(argv[3]) : 5;
+
+    for (kernel = 0; kernel < BENCH_SIGK_NUM; kernel++) {
+        benchSigkInit(kernel, &init);
+        ref = init;
+        benchSigkRun(picosigk_getKernels(PICOSIGK_SCALAR), kernel, &ref);
+        printf("%-12s", benchSigkNames[kernel]);
+        for (isa = PICOSIGK_SCALAR; isa < PICOSIGK_NUM; isa++) {
+            k = picosigk_getKernels(isa);
+            if (NULL == k) {
+                continue;
+            }
+            t = 0;
+            for (iter = 0; iter < 200; iter++) {
+                work = init;
+                t0 = now();
+                benchSigkRun(k, kernel, &work);
+                t += now() - t0;
+            }
+            printf("  %s %.0f ns", k->name, t * 1e9 / (200 * BENCH_SIGK_FRAMES));
+            if (memcmp(work.v, ref.v, sizeof(ref.v))
+                    || memcmp(work.x, ref.x, sizeof(ref.x))
+                    || memcmp(work.r, ref.r, sizeof(ref.r))
+                    || memcmp(work.dot, ref.dot, sizeof(ref.dot))
+                    || memcmp(work.g711, ref.g711, sizeof(ref.g711))) {
+                printf(" DIFFERS");
+                ret = 1;
+            }
+        }
+        printf("\n");
+    }
+
+    text = readText(argv[2]);
+    if ((NULL == text) || benchOpen(&b, 2, argv)) {
+        free(text);
+        return 1;
+    }
+    for (isa = PICOSIGK_SCALAR; (isa < PICOSIGK_NUM) && (samples >= 0); isa++) {
+        k = picosigk_getKernels(isa);
+        if (NULL == k) {
+            continue;
+        }
+        if (picoext_setVoiceOption(b.system, (const pico_Char *)BENCH_VOICE_NAME,
+                PICOEXT_VOICEOPT_SIG_KERNELS, isa)
+                || pico_newEngine(b.system, (const pico_Char *)BENCH_VOICE_NAME, &engine)) {
+            fprintf(stderr, "cannot create engine\n");
+            ret = 1;
+            break;
+        }
+        t0 = now();
+        for (iter = 0; (iter < numIter) && (samples >= 0); iter++) {
+            samples = benchSpeak(engine, text, &sum);
+        }
+        t = now() - t0;
+        pico_disposeEngine(b.system, &engine);
+        if (samples < 0) {
+            fprintf(stderr, "synthesis failed\n");
+            ret = 1;
+            break;
+        }
+        if (PICOSIGK_SCALAR == isa) {
+            sumRef = sum;
+        }
+        printf("%-8s %ld samples, %.1f ms/pass%s\n", k->name, samples,
+               t * 1000.0 / numIter, (sum == sumRef) ? "" : ", output DIFFERS");
+        if (sum != sumRef) {
+            ret = 1;
+        }
+    }
+
+    benchClose(&b);
+    free(text);
+    return ret;
+}
+
+/* engine creation and disposal: time per engine and engine memory */
+static int benchEngine(int argc, char *argv[])
+{
+    bench_t b;
+    pico_Engine engine;
+    pico_Int32 used, incr, maxUsed;
+    int numIter, iter, ret = 0;
+    double t0, t1;
+
+    if (argc < 2) {
+        fprintf(stderr, "usage: picobench engine <ta.bin> <sg.bin> [iterations]\n");
+        return 1;
+    }
+    numIter = (argc > 2) ? atoi(argv[2]) : 1000;
+    if (benchOpen(&b, 2, argv)) {
+        return 1;
+    }
+
+    t0 = now();
+    for (iter = 0; (iter < numIter) && (0 == ret); iter++) {
+        if (pico_newEngine(b.system, (const pico_Char *)BENCH_VOICE_NAME, &engine)) {
+            fprintf(stderr, "cannot create engine\n");
+            ret = 1;
+        } else {
+            if (iter == 0) {
+                picoext_getEngineMemUsage(engine, 0, &used, &incr, &maxUsed);
+            }
+            pico_disposeEngine(b.system, &engine);
+        }
+    }
+    t1 = now();
+    if (0 == ret) {
+        printf("%.1f us/engine, engine memory used: %d bytes\n",
+               (t1 - t0) * 1e6 / numIter, (int)used);
+    }
+
+    benchClose(&b);
+    return ret;
+}
+
+/* PAM alone on a long paragraph of synthetic syllables: sentences of 40
+   to 80 syllables, words of 1 to 3 syllables, phrases of 3 to 5 words */
+
+#define BENCH_PAM_NUM_SENT  60
+
+typedef struct {
+    picodata_ProcessingUnit pu;
+    picodata_CharBuffer cbIn, cbOut;
+    unsigned long sum;
+    long numOut;
+} bench_pam_t;
+
+/* let PAM consume everything in its input buffer */
+static int benchPamRun(bench_pam_t *p)
+{
+    picoos_uint8 buf[256];
+    picoos_uint16 len, n;
+    picodata_step_result_t res;
+    int i;
+
+    do {
+        res = p->pu->step(p->pu, 0, &n);
+        while (PICO_OK == picodata_cbGetItem(p->cbOut, buf, sizeof(buf), &len)) {
+            for (i = 0; i < len; i++) {
+                p->sum = p->sum * 31 + buf[i];
+            }
+            p->numOut++;
+        }
+    } while ((PICODATA_PU_BUSY == res) || (PICODATA_PU_ATOMIC == res)
+            || (PICODATA_PU_OUT_FULL == res));
+    return (PICODATA_PU_ERROR == res) ? 1 : 0;
+}
+
+static int benchPamPut(bench_pam_t *p, picoos_uint8 type, picoos_uint8 info1,
+                       picoos_uint8 info2, const picoos_uint8 *content,
+                       picoos_uint8 len)
+{
+    picoos_uint8 item[4 + 16];
+    picoos_uint16 n;
+
+    item[0] = type;
+    item[1] = info1;
+    item[2] = info2;
+    item[3] = len;
+    memcpy(item + 4, content, len);
+    if (PICO_OK != picodata_cbPutItem(p->cbIn, item, 4 + len, &n)) {
+        return 1;
+    }
+    return benchPamRun(p);
+}
+
+/* one paragraph; returns the number of syllables or -1 on error */
+static long benchPamParagraph(bench_pam_t *p, const picoos_uint8 *vowels,
+                              int numVowels, const picoos_uint8 *cons,
+                              int numCons)
+{
+    picoos_uint8 syll[8];
+    long numSyll = 0;
+    int sent, len, s, w, nw, np, ns, j, err;
+
+    srand(1);
+    err = 0;
+    for (sent = 0; (sent < BENCH_PAM_NUM_SENT) && !err; sent++) {
+        err |= benchPamPut(p, PICODATA_ITEM_BOUND, PICODATA_ITEMINFO1_BOUND_SBEG,
+                PICODATA_ITEMINFO2_BOUNDTYPE_T, NULL, 0);
+        len = 40 + rand() % 41;
+        s = 0;
+        np = 3 + rand() % 3;
+        nw = 0;
+        while ((s < len) && !err) {
+            ns = 1 + rand() % 3;
+            for (w = 0; (w < ns) && (s < len); w++, s++) {
+                j = 0;
+                if (rand() % 3) {
+                    syll[j++] = cons[rand() % numCons];
+                }
+                if (rand() % 4 == 0) {
+                    syll[j++] = cons[rand() % numCons];
+                }
+                syll[j++] = vowels[rand() % numVowels];
+                if (rand() % 2) {
+                    syll[j++] = cons[rand() % numCons];
+                }
+                err |= benchPamPut(p, PICODATA_ITEM_SYLLPHON, 0,
+                        (w == 0) ? PICODATA_ACC1 + rand() % 4 : PICODATA_ACC0,
+                        syll, (picoos_uint8) j);
+                numSyll++;
+            }
+            if (s >= len) {
+                break;
+            }
+            if (++nw < np) {
+                err |= benchPamPut(p, PICODATA_ITEM_BOUND,
+                        PICODATA_ITEMINFO1_BOUND_PHR0,
+                        PICODATA_ITEMINFO2_BOUNDTYPE_P, NULL, 0);
+            } else {
+                err |= benchPamPut(p, PICODATA_ITEM_BOUND, (rand() % 2)
+                        ? PICODATA_ITEMINFO1_BOUND_PHR1 : PICODATA_ITEMINFO1_BOUND_PHR3,
+                        PICODATA_ITEMINFO2_BOUNDTYPE_P, NULL, 0);
+                np = 3 + rand() % 3;
+                nw = 0;
+            }
+        }
+        err |= benchPamPut(p, PICODATA_ITEM_BOUND, PICODATA_ITEMINFO1_BOUND_SEND,
+                PICODATA_ITEMINFO2_BOUNDTYPE_T, NULL, 0);
+    }
+    return err ? -1 : numSyll;
+}
+
+static int benchPam(int argc, char *argv[])
+{
+    bench_t b;
+    bench_pam_t p;
+    picoos_Common common;
+    picoktab_Phones phones;
+    picoos_uint8 vowels[256], cons[256];
+    int numVowels = 0, numCons = 0, lo = 256, hi = 0, id, iter, numIter;
+    long numSyll = 0;
+    double t0, t1;
+
+    if (argc < 2) {
+        fprintf(stderr, "usage: picobench pam <ta.bin> <sg.bin> [iterations]\n");
+        return 1;
+    }
+    numIter = (argc > 2) ? atoi(argv[2]) : 5;
+    if (benchOpen(&b, 2, argv)) {
+        return 1;
+    }
+    common = b.system->common;
+
+    /* syllable carriers, and as consonants the other ordinary phones in
+       their id range */
+    phones = picoktab_getPhones(b.voice->kbArray[PICOKNOW_KBID_TAB_PHONES]);
+    for (id = 1; id < 256; id++) {
+        if (picoktab_isSyllCarrier(phones, (picoos_uint8) id)) {
+            vowels[numVowels++] = (picoos_uint8) id;
+            lo = (id < lo) ? id : lo;
+            hi = (id > hi) ? id : hi;
+        }
+    }
+    for (id = lo; id <= hi; id++) {
+        if (!picoktab_isSyllCarrier(phones, (picoos_uint8) id)
+                && !picoktab_isPrimstress(phones, (picoos_uint8) id)
+                && !picoktab_isSecstress(phones, (picoos_uint8) id)
+                && !picoktab_isSyllbound(phones, (picoos_uint8) id)
+                && !picoktab_isWordbound(phones, (picoos_uint8) id)
+                && !picoktab_isPause(phones, (picoos_uint8) id)) {
+            cons[numCons++] = (picoos_uint8) id;
+        }
+    }
+    if ((0 == numVowels) || (0 == numCons)) {
+        fprintf(stderr, "no phones\n");
+        benchClose(&b);
+        return 1;
+    }
+
+    memset(&p, 0, sizeof(p));
+    p.cbIn = picodata_newCharBuffer(common->mm, common, PICODATA_BUFSIZE_PAM);
+    p.cbOut = picodata_newCharBuffer(common->mm, common, PICODATA_BUFSIZE_PAM);
+    if ((NULL != p.cbIn) && (NULL != p.cbOut)) {
+        p.pu = picopam_newPamUnit(common->mm, common, p.cbIn, p.cbOut, b.voice);
+    }
+    if (NULL == p.pu) {
+        fprintf(stderr, "cannot create PAM\n");
+        numSyll = -1;
+    }
+
+    t0 = now();
+    for (iter = 0; (iter < numIter) && (numSyll >= 0); iter++) {
+        p.sum = 0;
+        p.numOut = 0;
+        numSyll = benchPamParagraph(&p, vowels, numVowels, cons, numCons);
+    }
+    t1 = now();
+    if (numSyll > 0) {
+        printf("%ld syllables, %ld items out, %.2f us/syllable, checksum %08lx\n",
+               numSyll, p.numOut, (t1 - t0) * 1e6 / ((double) numSyll * numIter),
+               p.sum & 0xffffffffUL);
+    } else {
+        fprintf(stderr, "PAM failed\n");
+    }
+
+    if (NULL != p.pu) {
+        picodata_disposeProcessingUnit(common->mm, &p.pu);
+    }
+    picodata_disposeCharBuffer(common->mm, &p.cbOut);
+    picodata_disposeCharBuffer(common->mm, &p.cbIn);
+    benchClose(&b);
+    return (numSyll > 0) ? 0 : 1;
+}
+
+
+/* ****************************************************************************/
+
+/* ****************************************************************************/
+/* fft: SIG FFT backends against the reference                               */
+/* ****************************************************************************/
+
+#define BENCH_FFT_FRAMES    64
+#define BENCH_FFT_LEN       256     /* PICODSP_FFTSIZE */
+
+/* frames of transform input, as in picosig2: the inverse real FFT of the
+   spectrum and the cosine transform of the mel cepstrum (m4 + 1 values) */
+typedef struct {
+    picoos_int32 r[BENCH_FFT_FRAMES][BENCH_FFT_LEN];
+    picoos_int32 c[BENCH_FFT_FRAMES][BENCH_FFT_LEN / 2 + 1];
+} bench_fft_t;
+
+/* time stamp in cycles where available, else in ns */
+static double benchFftStamp(void)
+{
+#if defined(BENCH_CYCLES)
+    return (double) __rdtsc();
+#else
+    return now() * 1e9;
+#endif
+}
+
+static void benchFftRun(const picofftsg_backend_t *f, int dct, bench_fft_t *d)
+{
+    int i;
+
+    for (i = 0; i < BENCH_FFT_FRAMES; i++) {
+        if (dct) {
+            f->dfct(BENCH_FFT_LEN / 2, d->c[i]);
+        } else {
+            f->rdft(BENCH_FFT_LEN, -1, d->r[i]);
+        }
+    }
+}
+
+/* each transform per backend on random frames (time per frame and
+   comparison with the reference), then synthesis with each backend */
+static int benchFft(int argc, char *argv[])
+{
+    static const char *names[2] = { "rdft", "dfct" };
+    static bench_fft_t init, ref, work;
+    const picofftsg_backend_t *f;
+    bench_t b;
+    char *text;
+    pico_Engine engine;
+    unsigned long sum, sumRef = 0;
+    long samples = 0;
+    int numIter, iter, dct, id, i, j, ret = 0;
+    double t0, t;
+
+    if (argc < 3) {
+        fprintf(stderr, "usage: picobench fft <ta.bin> <sg.bin> <text> "
+                "[iterations]\n");
+        return 1;
+    }
+    numIter = (argc > 3) ? atoi(argv[3]) : 5;
+
+    srand(1);
+    for (i = 0; i < BENCH_FFT_FRAMES; i++) {
+        for (j = 0; j < BENCH_FFT_LEN; j++) {
+            init.r[i][j] = benchSigkRand(1 << 24);
+        }
+        for (j = 0; j <= BENCH_FFT_LEN / 2; j++) {
+            init.c[i][j] = benchSigkRand(1 << 24);
+        }
+    }
+    for (dct = 0; dct < 2; dct++) {
+        ref = init;
+        benchFftRun(picofftsg_getBackend(PICOFFTSG_OOURA), dct, &ref);
+        printf("%-6s", names[dct]);
+        for (id = PICOFFTSG_OOURA; id < PICOFFTSG_NUM; id++) {
+            f = picofftsg_getBackend(id);
+            if (NULL == f) {
+                continue;
+            }
+            t = 0;
+            for (iter = 0; iter < 200; iter++) {
+                work = init;
+                t0 = benchFftStamp();
+                benchFftRun(f, dct, &work);
+                t += benchFftStamp() - t0;
+            }
+#if defined(BENCH_CYCLES)
+            printf("  %s %.0f cycles", f->name, t / (200 * BENCH_FFT_FRAMES));
+#else
+            printf("  %s %.0f ns", f->name, t / (200 * BENCH_FFT_FRAMES));
+#endif
+            if (memcmp(&work, &ref, sizeof(ref))) {
+                printf(" DIFFERS");
+                ret = 1;
+            }
+        }
+        printf("\n");
+    }
+
+    text = readText(argv[2]);
+    if ((NULL == text) || benchOpen(&b, 2, argv)) {
+        free(text);
+        return 1;
+    }
+    for (id = PICOFFTSG_OOURA; (id < PICOFFTSG_NUM) && (samples >= 0); id++) {
+        f = picofftsg_getBackend(id);
+        if (NULL == f) {
+            continue;
+        }
+        if (picoext_setVoiceOption(b.system, (const pico_Char *)BENCH_VOICE_NAME,
+                PICOEXT_VOICEOPT_SIG_FFT, id)
+                || pico_newEngine(b.system, (const pico_Char *)BENCH_VOICE_NAME, &engine)) {
+            fprintf(stderr, "cannot create engine\n");
+            ret = 1;
+            break;
+        }
+        t0 = now();
+        for (iter = 0; (iter < numIter) && (samples >= 0); iter++) {
+            samples = benchSpeak(engine, text, &sum);
+        }
+        t = now() - t0;
+        pico_disposeEngine(b.system, &engine);
+        if (samples < 0) {
+            fprintf(stderr, "synthesis failed\n");
+            ret = 1;
+            break;
+        }
+        if (PICOFFTSG_OOURA == id) {
+            sumRef = sum;
+        }
+        printf("%-8s %ld samples, %.1f ms/pass%s\n", f->name, samples,
+               t * 1000.0 / numIter, (sum == sumRef) ? "" : ", output DIFFERS");
+        if (sum != sumRef) {
+            ret = 1;
+        }
+    }
+
+    benchClose(&b);
+    free(text);
+    return ret;
+}
+
+/* synthesis with SIG batches of 1, 2, 4 and 8 frames (voice option
+   PICOEXT_VOICEOPT_SIG_BATCH); the output must be the same as frame by
+   frame */
+static int benchSigBatch(int argc, char *argv[])
+{
+    static const int frames[] = { 1, 2, 4, 8 };
+    bench_t b;
+    char *text;
+    pico_Engine engine;
+    pico_Int32 used, incr, maxUsed;
+    unsigned long sum, sumRef = 0;
+    long samples = 0;
+    int numIter, iter, i, ret = 0;
+    double t0, t1;
+
+    if (argc < 3) {
+        fprintf(stderr, "usage: picobench sigbatch <ta.bin> <sg.bin> <text> "
+                "[iterations]\n");
+        return 1;
+    }
+    numIter = (argc > 3) ? atoi(argv[3]) : 5;
+    text = readText(argv[2]);
+    if ((NULL == text) || benchOpen(&b, 2, argv)) {
+        free(text);
+        return 1;
+    }
+
+    for (i = 0; (i < (int) (sizeof(frames) / sizeof(frames[0]))) && (0 == ret); i++) {
+        if (picoext_setVoiceOption(b.system, (const pico_Char *)BENCH_VOICE_NAME,
+                PICOEXT_VOICEOPT_SIG_BATCH, frames[i])
+                || pico_newEngine(b.system, (const pico_Char *)BENCH_VOICE_NAME, &engine)) {
+            fprintf(stderr, "cannot create engine\n");
+            ret = 1;
+            break;
+        }
+        t0 = now();
+        for (iter = 0; (iter < numIter) && (samples >= 0); iter++) {
+            samples = benchSpeak(engine, text, &sum);
+        }
+        t1 = now();
+        picoext_getEngineMemUsage(engine, 0, &used, &incr, &maxUsed);
+        pico_disposeEngine(b.system, &engine);
+        if (samples < 0) {
+            fprintf(stderr, "synthesis failed\n");
+            ret = 1;
+            break;
+        }
+        if (0 == i) {
+            sumRef = sum;
+        }
+        printf("batch %d  %ld samples, %.1f ms/pass, engine memory %d bytes%s\n",
+               frames[i], samples, (t1 - t0) * 1000.0 / numIter, (int) used,
+               (sum == sumRef) ? "" : ", output DIFFERS");
+        if (sum != sumRef) {
+            ret = 1;
+        }
+    }
+
+    benchClose(&b);
+    free(text);
+    return ret;
+}
+
+/* ****************************************************************************/
+/* voices: per-engine pitch, formant and noise shaping profiles             */
+/* ****************************************************************************/
+
+typedef struct {
+    const char *name;
+    pico_Int32 pitch, formant, noise;   /* PICOEXT_VOICEOPT_SIG_* */
+} bench_voice_t;
+
+static const bench_voice_t benchVoices[] = {
+    { "default", 0, 0, 0 },
+    { "neutral", 100, 0, 0 },           /* must sound as the default */
+    { "male", 80, -120, 0 },
+    { "female", 125, 150, 0 },
+    { "bright", 0, 0, 0x76543210 },     /* +1.5dB per kHz of noise */
+    { "dark", 110, -60, 0x89abcdef }
+};
+
+#define BENCH_NUM_VOICES    ((int) (sizeof(benchVoices) / sizeof(benchVoices[0])))
+
+static int benchVoiceEngine(bench_t *b, const bench_voice_t *v, pico_Engine *engine)
+{
+    const pico_Char *name = (const pico_Char *) BENCH_VOICE_NAME;
+    pico_Retstring msg;
+    int ret;
+
+    ret = picoext_setVoiceOption(b->system, name, PICOEXT_VOICEOPT_SIG_PITCH, v->pitch);
+    if (0 == ret) {
+        ret = picoext_setVoiceOption(b->system, name, PICOEXT_VOICEOPT_SIG_FORMANT,
+                v->formant);
+    }
+    if (0 == ret) {
+        ret = picoext_setVoiceOption(b->system, name, PICOEXT_VOICEOPT_SIG_NOISE,
+                v->noise);
+    }
+    if (0 == ret) {
+        ret = pico_newEngine(b->system, name, engine);
+    }
+    if (ret) {
+        pico_getSystemStatusMessage(b->system, ret, msg);
+        fprintf(stderr, "cannot create engine for voice %s (%i): %s\n", v->name,
+                ret, msg);
+        return 1;
+    }
+    return 0;
+}
+
+/* synthesis state of one of several engines run in turns */
+typedef struct {
+    pico_Engine engine;
+    const pico_Char *p;
+    pico_Int32 rem;
+    int busy, done;
+    unsigned long sum;
+} bench_turn_t;
+
+/* one pico_getData of 's' (with the next text chunk if its engine is
+   idle), the checksum as in benchSpeakTo; 1 on error */
+static int benchTurn(bench_turn_t *s)
+{
+    pico_Int16 sent, recv, type, chunk;
+    pico_Int16 buf[512];
+    int ret, i;
+
+    if (s->done) {
+        return 0;
+    }
+    if (!s->busy) {
+        if (s->rem <= 0) {
+            s->done = 1;
+            return 0;
+        }
+        chunk = (s->rem > 30000) ? 30000 : (pico_Int16) s->rem;
+        if (pico_putTextUtf8(s->engine, s->p, chunk, &sent)) {
+            return 1;
+        }
+        s->rem -= sent;
+        s->p += sent;
+    }
+    ret = pico_getData(s->engine, buf, sizeof(buf), &recv, &type);
+    if ((PICO_STEP_BUSY != ret) && (PICO_STEP_IDLE != ret)) {
+        return 1;
+    }
+    for (i = 0; i < recv / 2; i++) {
+        s->sum = s->sum * 31 + (unsigned short) buf[i];
+    }
+    s->busy = (PICO_STEP_BUSY == ret);
+    return 0;
+}
+
+/* synthesis with each profile of benchVoices (the time per pass against
+   the default voice), then two engines (of two systems, one engine each)
+   with different profiles in turns, whose output must be the same as one
+   after the other */
+static int benchVoiceProfiles(int argc, char *argv[])
+{
+    bench_t b, b2;
+    char *text;
+    pico_Engine engine;
+    pico_Int32 used, incr, maxUsed;
+    bench_turn_t turn[2];
+    unsigned long sum[BENCH_NUM_VOICES], sumNext;
+    long samples = 0;
+    int numIter, iter, i, ret = 0;
+    double t0, t, tRef = 0;
+
+    if (argc < 3) {
+        fprintf(stderr, "usage: picobench voices <ta.bin> <sg.bin> <text> "
+                "[iterations]\n");
+        return 1;
+    }
+    numIter = (argc > 3) ? atoi(argv[3]) : 5;
+    text = readText(argv[2]);
+    if ((NULL == text) || benchOpen(&b, 2, argv)) {
+        free(text);
+        return 1;
+    }
+
+    for (i = 0; (i < BENCH_NUM_VOICES) && (0 == ret); i++) {
+        if (benchVoiceEngine(&b, &benchVoices[i], &engine)) {
+            ret = 1;
+            break;
+        }
+        /* the random phase of the unvoiced frames goes on from pass to
+           pass, the output of the first pass is compared */
+        t0 = now();
+        for (iter = 0; (iter < numIter) && (samples >= 0); iter++) {
+            samples = benchSpeak(engine, text, (0 == iter) ? &sum[i] : &sumNext);
+        }
+        t = (now() - t0) * 1000.0 / numIter;
+        picoext_getEngineMemUsage(engine, 0, &used, &incr, &maxUsed);
+        pico_disposeEngine(b.system, &engine);
+        if (samples < 0) {
+            fprintf(stderr, "synthesis failed\n");
+            ret = 1;
+            break;
+        }
+        if (0 == i) {
+            tRef = t;
+        }
+        printf("%-8s %ld samples, %.1f ms/pass (%+.1f%%), engine memory %d bytes%s\n",
+               benchVoices[i].name, samples, t, (t / tRef - 1.0) * 100.0, (int) used,
+               ((1 == i) && (sum[1] != sum[0])) ? ", output DIFFERS" : "");
+        if ((1 == i) && (sum[1] != sum[0])) {
+            ret = 1;
+        }
+    }
+
+    /* male and female engines at the same time */
+    if ((0 == ret) && benchOpen(&b2, 2, argv)) {
+        ret = 1;
+    } else if ((0 == ret) && benchVoiceEngine(&b, &benchVoices[2], &turn[0].engine)) {
+        benchClose(&b2);
+        ret = 1;
+    } else if ((0 == ret) && benchVoiceEngine(&b2, &benchVoices[3], &turn[1].engine)) {
+        pico_disposeEngine(b.system, &turn[0].engine);
+        benchClose(&b2);
+        ret = 1;
+    } else if (0 == ret) {
+        for (i = 0; i < 2; i++) {
+            turn[i].p = (const pico_Char *) text;
+            turn[i].rem = (pico_Int32) strlen(text) + 1;
+            turn[i].busy = turn[i].done = 0;
+            turn[i].sum = 0;
+        }
+        while (!(turn[0].done && turn[1].done) && (0 == ret)) {
+            ret = benchTurn(&turn[0]) || benchTurn(&turn[1]);
+        }
+        pico_disposeEngine(b.system, &turn[0].engine);
+        pico_disposeEngine(b2.system, &turn[1].engine);
+        benchClose(&b2);
+        if (ret) {
+            fprintf(stderr, "synthesis failed\n");
+        } else {
+            printf("%s and %s in turns%s\n", benchVoices[2].name, benchVoices[3].name,
+                   ((turn[0].sum == sum[2]) && (turn[1].sum == sum[3]))
+                   ? ", output as one after the other" : ", output DIFFERS");
+            ret = (turn[0].sum != sum[2]) || (turn[1].sum != sum[3]);
+        }
+    }
+
+    benchClose(&b);
+    free(text);
+    return ret;
+}
+
+/* ****************************************************************************/
+/* fixedpoint: SIG output against a reference from another build            */
+/* ****************************************************************************/
+
+#define BENCH_SNR_FRAME     256     /* samples per frame of the segmental SNR */
+#define BENCH_SNR_MIN       40.0    /* dB, below this the outputs differ */
+
+/* SNR and segmental SNR (mean over the frames with signal, each limited to
+   -10..100 dB) of the 16 bit PCM files 'test' against 'ref'; 1 if their
+   lengths differ */
+static int benchSnr(FILE *ref, FILE *test, double *snr, double *segSnr,
+                    int *maxDiff)
+{
+    short r[BENCH_SNR_FRAME], t[BENCH_SNR_FRAME];
+    double sig = 0, err = 0, fsig, ferr, seg = 0, d;
+    size_t nr, nt, i;
+    long numSeg = 0;
+
+    *maxDiff = 0;
+    rewind(ref);
+    rewind(test);
+    do {
+        nr = fread(r, 2, BENCH_SNR_FRAME, ref);
+        nt = fread(t, 2, BENCH_SNR_FRAME, test);
+        if (nr != nt) {
+            return 1;
+        }
+        fsig = ferr = 0;
+        for (i = 0; i < nr; i++) {
+            d = (double) r[i] - t[i];
+            fsig += (double) r[i] * r[i];
+            ferr += d * d;
+            if (fabs(d) > *maxDiff) {
+                *maxDiff = (int) fabs(d);
+            }
+        }
+        sig += fsig;
+        err += ferr;
+        if (fsig > 0) {
+            d = (ferr > 0) ? 10 * log10(fsig / ferr) : 100;
+            seg += (d < -10) ? -10 : (d > 100) ? 100 : d;
+            numSeg++;
+        }
+    } while (nr == BENCH_SNR_FRAME);
+    *snr = (err > 0) ? 10 * log10(sig / err) : 100;
+    *segSnr = (numSeg > 0) ? seg / numSeg : 100;
+    return 0;
+}
+
+/* synthesis time (cycles per sample on x86, else ns) and, against the
+   output of another build in 'pcmfile' (written by the first run), SNR
+   and segmental SNR; meant for the fixed point build (PICO_USE_FIXED_POINT)
+   against the floating point build */
+static int benchFixedPoint(int argc, char *argv[])
+{
+    bench_t b;
+    char *text;
+    pico_Engine engine;
+    FILE *ref, *out;
+    unsigned long sum;
+    long samples = 0;
+    int numIter, iter, maxDiff, ret = 0;
+    double t0, t1, stamp, snr, segSnr;
+
+    if (argc < 4) {
+        fprintf(stderr, "usage: picobench fixedpoint <ta.bin> <sg.bin> <text> "
+                "<pcmfile> [iterations]\n");
+        return 1;
+    }
+    numIter = (argc > 4) ? atoi(argv[4]) : 5;
+    text = readText(argv[2]);
+    if ((NULL == text) || benchOpen(&b, 2, argv)) {
+        free(text);
+        return 1;
+    }
+    if (pico_newEngine(b.system, (const pico_Char *)BENCH_VOICE_NAME, &engine)) {
+        fprintf(stderr, "cannot create engine\n");
+        benchClose(&b);
+        free(text);
+        return 1;
+    }
+
+    /* the output of the first pass goes to the reference file if there is
+       none yet, else to a temporary file */
+    ref = fopen(argv[3], "rb");
+    out = (NULL == ref) ? fopen(argv[3], "w+b") : tmpfile();
+    if (NULL == out) {
+        fprintf(stderr, "cannot write output\n");
+        ret = 1;
+    }
+    t0 = now();
+    stamp = benchFftStamp();
+    for (iter = 0; (iter < numIter) && (samples >= 0) && (0 == ret); iter++) {
+        samples = benchSpeakTo(engine, text, &sum, (0 == iter) ? out : NULL);
+    }
+    stamp = benchFftStamp() - stamp;
+    t1 = now();
+    pico_disposeEngine(b.system, &engine);
+    if ((0 == ret) && (samples <= 0)) {
+        fprintf(stderr, "synthesis failed\n");
+        ret = 1;
+    }
+
+    if (0 == ret) {
+#if defined(PICO_FIXED_POINT_ENABLED)
+        printf("fixed point: ");
+#else
+        printf("floating point: ");
+#endif
+#if defined(BENCH_CYCLES)
+        printf("%ld samples, %.1f ms/pass, %.0f cycles/sample\n", samples,
+               (t1 - t0) * 1000.0 / numIter, stamp / ((double) numIter * samples));
+#else
+        printf("%ld samples, %.1f ms/pass, %.0f ns/sample\n", samples,
+               (t1 - t0) * 1000.0 / numIter, stamp / ((double) numIter * samples));
+#endif
+        if (NULL == ref) {
+            printf("reference written to %s\n", argv[3]);
+        } else if (benchSnr(ref, out, &snr, &segSnr, &maxDiff)) {
+            printf("output length DIFFERS from %s\n", argv[3]);
+            ret = 1;
+        } else {
+            printf("against %s: SNR %.1f dB, segmental SNR %.1f dB, "
+                   "max difference %d\n", argv[3], snr, segSnr, maxDiff);
+            if (snr < BENCH_SNR_MIN) {
+                ret = 1;
+            }
+        }
+    }
+    if (NULL != ref) {
+        fclose(ref);
+    }
+    if (NULL != out) {
+        fclose(out);
+    }
+
+    benchClose(&b);
+    free(text);
+    return ret;
+}
+
+
+/* ****************************************************************************/
+/* resample: output rates of the engine against resampling afterwards        */
+/* ****************************************************************************/
+
+#define BENCH_RS_ZEROS      16      /* as in picosigrs.c */
+#define BENCH_RS_MIN_SNR    60.0    /* dB, below this the resamplers differ */
+
+/* speech data synthesized by 'engine' ('n' bytes), NULL on failure */
+static unsigned char *benchSpeakBytes(pico_Engine engine, const char *text,
+                                      long *n)
+{
+    FILE *f;
+    unsigned char *data = NULL;
+    unsigned long sum;
+
+    f = tmpfile();
+    if (NULL == f) {
+        return NULL;
+    }
+    *n = (benchSpeakTo(engine, text, &sum, f) < 0) ? -1 : ftell(f);
+    if (*n > 0) {
+        data = (unsigned char *) malloc(*n);
+        rewind(f);
+        if ((NULL != data) && (fread(data, 1, *n, f) != (size_t) *n)) {
+            free(data);
+            data = NULL;
+        }
+    }
+    fclose(f);
+    return data;
+}
+
+/* 16 bit PCM synthesized by 'engine' ('n' samples), NULL on failure */
+static short *benchSpeakPcm(pico_Engine engine, const char *text, long *n)
+{
+    short *pcm = (short *) benchSpeakBytes(engine, text, n);
+
+    *n /= 2;
+    return pcm;
+}
+
+static double benchI0(double x)
+{
+    double s = 1.0, t = 1.0;
+    int k;
+
+    for (k = 1; t > 1e-12 * s; k++) {
+        t *= (x / (2 * k)) * (x / (2 * k));
+        s += t;
+    }
+    return s;
+}
+
+/* the resampler a client would run on the 16kHz output: polyphase FIR in
+   single precision with the filter of picosigrs.c computed in double
+   precision, no quantization of taps or history */
+typedef struct {
+    int L, M, K;
+    float *taps;
+} bench_rs_t;
+
+static int benchRsInit(bench_rs_t *r, int rate)
+{
+    int g, p, k, a = rate, b = 16000;
+    double s, t, x, h, sum;
+
+    while (b != 0) {
+        g = a % b;
+        a = b;
+        b = g;
+    }
+    r->L = rate / a;
+    r->M = 16000 / a;
+    s = (r->L < r->M) ? (double) r->L / r->M : 1.0;
+    r->K = (int) ceil(BENCH_RS_ZEROS / s);
+    r->K = (r->K + 3) & ~3;
+    r->taps = (float *) malloc(r->L * 2 * r->K * sizeof(float));
+    if (NULL == r->taps) {
+        return 1;
+    }
+    for (p = 0; p < r->L; p++) {
+        sum = 0;
+        for (k = 0; k < 2 * r->K; k++) {
+            t = fabs(((r->K - 1 - k) + (double) p / r->L) * s);
+            h = 0;
+            if (t < BENCH_RS_ZEROS) {
+                x = 0.92 * t;
+                h = (x == 0) ? 0.92 : 0.92 * sin(M_PI * x) / (M_PI * x);
+                h *= benchI0(7.0 * sqrt(1 - (t / BENCH_RS_ZEROS) * (t / BENCH_RS_ZEROS)))
+                        / benchI0(7.0);
+            }
+            r->taps[p * 2 * r->K + k] = (float) h;
+            sum += h;
+        }
+        for (k = 0; k < 2 * r->K; k++) {
+            r->taps[p * 2 * r->K + k] /= (float) sum;
+        }
+    }
+    return 0;
+}
+
+/* resamples x[0..n-1] to y, returns the number of output samples; output
+   sample j is at input time j * M / L, as in the engine */
+static long benchRsRun(const bench_rs_t *r, const short *x, long n, short *y)
+{
+    long j, i, p, m;
+    int k, T = 2 * r->K;
+    const float *h;
+    float acc;
+
+    for (j = 0; ; j++) {
+        i = (j * r->M) / r->L;
+        p = (j * r->M) % r->L;
+        if (i + r->K >= n) {
+            break;
+        }
+        h = &(r->taps[p * T]);
+        acc = 0;
+        for (k = 0; k < T; k++) {
+            m = i + 1 - r->K + k;
+            if (m >= 0) {
+                acc += h[k] * x[m];
+            }
+        }
+        acc += (acc >= 0) ? 0.5f : -0.5f;
+        y[j] = (short) ((acc > 32767) ? 32767 : ((acc < -32768) ? -32768 : acc));
+    }
+    return j;
+}
+
+/* the resampler stage of the engine alone on x[0..n-1], in hops of
+   PICOSIGRS_MAX_IN samples as in SIG */
+static long benchRsStage(picosigrs_Resampler r, const short *x, long n,
+                         short *y)
+{
+    long i, m = 0;
+
+    picosigrs_reset(r);
+    for (i = 0; i < n; i += PICOSIGRS_MAX_IN) {
+        m += picosigrs_process(r, (const picoos_int16 *) &x[i],
+                (picoos_int16) ((n - i < PICOSIGRS_MAX_IN) ? n - i : PICOSIGRS_MAX_IN),
+                (picoos_int16 *) &y[m]);
+    }
+    return m;
+}
+
+/* synthesis at 16kHz, then per output rate: synthesis with the rate as
+   engine option, the resampler stage of the engine alone on the 16kHz
+   output, and the 16kHz output resampled afterwards. The stage must give
+   the engine output, which must have the same length as and be close to
+   the output resampled afterwards */
+static int benchResample(int argc, char *argv[])
+{
+    static const int rates[] = { 8000, 22050, 24000, 48000 };
+    bench_t b;
+    bench_rs_t rs;
+    char *text;
+    pico_Engine engine;
+    picoos_MemoryManager mm;
+    picosigrs_Resampler stage;
+    void *mem;
+    short *pcm16 = NULL, *pcm = NULL, *down = NULL, *staged = NULL;
+    long n16 = 0, n = 0, nDown = 0, nStaged = 0, j;
+    pico_Int32 used, incr, maxUsed;
+    unsigned long sum;
+    int numIter, iter, i, ret = 0;
+    double t0, t16 = 0, t, tStage, tDown, sig, err;
+
+    if (argc < 3) {
+        fprintf(stderr, "usage: picobench resample <ta.bin> <sg.bin> <text> "
+                "[iterations]\n");
+        return 1;
+    }
+    numIter = (argc > 3) ? atoi(argv[3]) : 5;
+    text = readText(argv[2]);
+    if ((NULL == text) || benchOpen(&b, 2, argv)) {
+        free(text);
+        return 1;
+    }
+
+    for (i = -1; (i < (int) (sizeof(rates) / sizeof(rates[0]))) && (0 == ret); i++) {
+        if (picoext_setVoiceOption(b.system, (const pico_Char *)BENCH_VOICE_NAME,
+                PICOEXT_VOICEOPT_SIG_RATE, (i < 0) ? 0 : rates[i])
+                || pico_newEngine(b.system, (const pico_Char *)BENCH_VOICE_NAME, &engine)) {
+            fprintf(stderr, "cannot create engine\n");
+            ret = 1;
+            break;
+        }
+        pcm = benchSpeakPcm(engine, text, &n);
+        t0 = now();
+        for (iter = 0; (iter < numIter) && (NULL != pcm); iter++) {
+            benchSpeak(engine, text, &sum);
+        }
+        t = (now() - t0) * 1000.0 / numIter;
+        picoext_getEngineMemUsage(engine, 0, &used, &incr, &maxUsed);
+        pico_disposeEngine(b.system, &engine);
+        if (NULL == pcm) {
+            fprintf(stderr, "synthesis failed\n");
+            ret = 1;
+            break;
+        }
+        if (i < 0) {
+            pcm16 = pcm;
+            n16 = n;
+            t16 = t;
+            printf("16000 Hz  %ld samples, %.1f ms/pass, engine memory %d bytes\n",
+                   n, t, (int) used);
+            continue;
+        }
+
+        mem = malloc(picosigrs_getMemSize(rates[i]) + 1024);
+        mm = (NULL == mem) ? NULL : picoos_newMemoryManager(mem,
+                picosigrs_getMemSize(rates[i]) + 1024, FALSE);
+        stage = (NULL == mm) ? NULL : picosigrs_newResampler(mm, rates[i],
+                picosigk_getKernels(PICOSIGK_AUTO));
+        if ((NULL == stage) || benchRsInit(&rs, rates[i])) {
+            fprintf(stderr, "cannot create resampler\n");
+            free(mem);
+            free(pcm);
+            ret = 1;
+            break;
+        }
+        staged = (short *) malloc((n16 * rs.L / rs.M + 2) * sizeof(short));
+        down = (short *) malloc((n16 * rs.L / rs.M + 2) * sizeof(short));
+        t0 = now();
+        for (iter = 0; (iter < numIter) && (NULL != staged); iter++) {
+            nStaged = benchRsStage(stage, pcm16, n16, staged);
+        }
+        tStage = (now() - t0) * 1000.0 / numIter;
+        t0 = now();
+        for (iter = 0; (iter < numIter) && (NULL != down); iter++) {
+            nDown = benchRsRun(&rs, pcm16, n16, down);
+        }
+        tDown = (now() - t0) * 1000.0 / numIter;
+        printf("%5d Hz  %ld samples, %.1f ms/pass (%+.1f ms), engine memory %d bytes;"
+               " stage %.1f ms/pass, afterwards %.1f ms/pass", rates[i], n, t,
+               t - t16, (int) used, tStage, tDown);
+        if ((NULL == staged) || (nStaged != n)
+                || memcmp(staged, pcm, n * sizeof(short))) {
+            printf(", stage DIFFERS from engine\n");
+            ret = 1;
+        } else if ((NULL == down) || (n != nDown)) {
+            printf(", length DIFFERS (%ld)\n", nDown);
+            ret = 1;
+        } else {
+            sig = err = 0;
+            for (j = 0; j < n; j++) {
+                sig += (double) down[j] * down[j];
+                err += (double) (pcm[j] - down[j]) * (pcm[j] - down[j]);
+            }
+            t = (err > 0) ? 10.0 * log10(sig / err) : 999.0;
+            printf(", SNR %.1f dB against it\n", t);
+            if (t < BENCH_RS_MIN_SNR) {
+                ret = 1;
+            }
+        }
+        free(rs.taps);
+        free(mem);
+        free(staged);
+        free(down);
+        free(pcm);
+    }
+
+    free(pcm16);
+    benchClose(&b);
+    free(text);
+    return ret;
+}
+
+/* ****************************************************************************/
+/* encode: output encoders in SIG against encoding afterwards                 */
+/* ****************************************************************************/
+
+/* reference encoders as in the ITU-T G.191 and IMA reference code, with a
+   segment search instead of the segment table and vector kernels */
+static int benchG711Segment(int v, int end)
+{
+    int seg;
+
+    for (seg = 0; (seg < 8) && (v > end); seg++) {
+        end = 2 * end + 1;
+    }
+    return seg;
+}
+
+static unsigned char benchUlaw(int pcm)
+{
+    int mask = 0xff, seg;
+
+    pcm >>= 2;
+    if (pcm < 0) {
+        pcm = -pcm;
+        mask = 0x7f;
+    }
+    if (pcm > 8159) {
+        pcm = 8159;
+    }
+    pcm += 33;
+    seg = benchG711Segment(pcm, 0x3f);
+    if (seg >= 8) {
+        return (unsigned char) (0x7f ^ mask);
+    }
+    return (unsigned char) (((seg << 4) | ((pcm >> (seg + 1)) & 0x0f)) ^ mask);
+}
+
+static unsigned char benchAlaw(int pcm)
+{
+    int mask = 0xd5, seg;
+
+    pcm >>= 3;
+    if (pcm < 0) {
+        pcm = -pcm - 1;
+        mask = 0x55;
+    }
+    seg = benchG711Segment(pcm, 0x1f);
+    return (unsigned char) (((seg << 4) | ((pcm >> ((seg < 2) ? 1 : seg)) & 0x0f)) ^ mask);
+}
+
+static const int benchAdpcmStep[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37,
+    41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173,
+    190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658,
+    724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484,
+    7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818,
+    18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const int benchAdpcmIndex[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+/* IMA ADPCM of 'n' samples, two per byte with the first in the low
+   nibble; returns the number of bytes */
+static long benchAdpcm(const short *x, long n, unsigned char *y)
+{
+    int pred = 0, index = 0, step, diff, vpdiff, code;
+    long i;
+
+    for (i = 0; i < n; i++) {
+        step = benchAdpcmStep[index];
+        diff = x[i] - pred;
+        code = (diff < 0) ? 8 : 0;
+        if (diff < 0) {
+            diff = -diff;
+        }
+        vpdiff = step >> 3;
+        if (diff >= step) {
+            code |= 4;
+            diff -= step;
+            vpdiff += step;
+        }
+        if (diff >= step >> 1) {
+            code |= 2;
+            diff -= step >> 1;
+            vpdiff += step >> 1;
+        }
+        if (diff >= step >> 2) {
+            code |= 1;
+            vpdiff += step >> 2;
+        }
+        pred += (code & 8) ? -vpdiff : vpdiff;
+        pred = (pred > 32767) ? 32767 : ((pred < -32768) ? -32768 : pred);
+        index += benchAdpcmIndex[code];
+        index = (index < 0) ? 0 : ((index > 88) ? 88 : index);
+        if (i & 1) {
+            y[i / 2] |= (unsigned char) (code << 4);
+        } else {
+            y[i / 2] = (unsigned char) code;
+        }
+    }
+    return n / 2;
+}
+
+static long benchEncode(int format, const short *x, long n, unsigned char *y)
+{
+    long i;
+
+    if (PICO_DATA_IMA_ADPCM_4BIT == format) {
+        return benchAdpcm(x, n, y);
+    }
+    for (i = 0; i < n; i++) {
+        y[i] = (PICO_DATA_ULAW_8BIT == format) ? benchUlaw(x[i]) : benchAlaw(x[i]);
+    }
+    return n;
+}
+
+/* synthesis as 16 bit PCM, then per output format: synthesis with the
+   format as engine option and the PCM encoded afterwards by the
+   reference encoders, which must give the same bytes */
+static int benchEncodeFormats(int argc, char *argv[])
+{
+    static const int formats[] = {
+        PICO_DATA_ULAW_8BIT, PICO_DATA_ALAW_8BIT, PICO_DATA_IMA_ADPCM_4BIT
+    };
+    static const char *names[] = { "ulaw", "alaw", "adpcm" };
+    bench_t b;
+    char *text;
+    pico_Engine engine;
+    short *pcm = NULL, dummy[64];
+    unsigned char *data, *ref;
+    long n16 = 0, n, nRef = 0;
+    pico_Int16 recv, type;
+    unsigned long sum;
+    int numIter, iter, i, ret = 0;
+    double t0, t16 = 0, t, tAfter;
+
+    if (argc < 3) {
+        fprintf(stderr, "usage: picobench encode <ta.bin> <sg.bin> <text> "
+                "[iterations]\n");
+        return 1;
+    }
+    numIter = (argc > 3) ? atoi(argv[3]) : 5;
+    text = readText(argv[2]);
+    if ((NULL == text) || benchOpen(&b, 2, argv)) {
+        free(text);
+        return 1;
+    }
+
+    for (i = -1; (i < (int) (sizeof(formats) / sizeof(formats[0]))) && (0 == ret); i++) {
+        if (picoext_setVoiceOption(b.system, (const pico_Char *)BENCH_VOICE_NAME,
+                PICOEXT_VOICEOPT_SIG_FORMAT, (i < 0) ? 0 : formats[i])
+                || pico_newEngine(b.system, (const pico_Char *)BENCH_VOICE_NAME, &engine)) {
+            fprintf(stderr, "cannot create engine\n");
+            ret = 1;
+            break;
+        }
+        data = benchSpeakBytes(engine, text, &n);
+        t0 = now();
+        for (iter = 0; (iter < numIter) && (NULL != data); iter++) {
+            benchSpeak(engine, text, &sum);
+        }
+        t = (now() - t0) * 1000.0 / numIter;
+        pico_getData(engine, dummy, sizeof(dummy), &recv, &type);
+        pico_disposeEngine(b.system, &engine);
+        if (NULL == data) {
+            fprintf(stderr, "synthesis failed\n");
+            ret = 1;
+            break;
+        }
+        if (i < 0) {
+            pcm = (short *) data;
+            n16 = n / 2;
+            t16 = t;
+            printf("pcm16  %ld bytes, %.1f ms/pass\n", n, t);
+            continue;
+        }
+
+        ref = (unsigned char *) malloc(n16 + 1);
+        t0 = now();
+        for (iter = 0; (iter < numIter) && (NULL != ref); iter++) {
+            nRef = benchEncode(formats[i], pcm, n16, ref);
+        }
+        tAfter = (now() - t0) * 1000.0 / numIter;
+        printf("%-6s %ld bytes (%.0f%%), %.1f ms/pass (%+.1f ms); afterwards"
+               " %.2f ms/pass", names[i], n, 50.0 * n / n16, t, t - t16, tAfter);
+        if (type != formats[i]) {
+            printf(", data type %d\n", type);
+            ret = 1;
+        } else if ((NULL == ref) || (n != nRef) || memcmp(data, ref, n)) {
+            printf(", DIFFERS from encoding afterwards\n");
+            ret = 1;
+        } else {
+            printf("\n");
+        }
+        free(ref);
+        free(data);
+    }
+
+    free(pcm);
+    benchClose(&b);
+    free(text);
+    return ret;
+}
+
+
+/* ****************************************************************************/
+/* float: float output against 16 bit PCM converted afterwards               */
+/* ****************************************************************************/
+
+#define BENCH_FLOAT_GAIN    0.5f    /* of a mixer converting the PCM to float */
+
+/* synthesis as 16 bit PCM and as float; where the PCM is not clipped, the
+   float samples must be the PCM ones within 1 LSB (the PCM is rounded
+   towards zero). Also the time a mixer takes to convert the PCM to float
+   with a gain afterwards */
+static int benchFloat(int argc, char *argv[])
+{
+    bench_t b;
+    char *text;
+    pico_Engine engine;
+    short *pcm = NULL, dummy[64];
+    float *data = NULL, *mix;
+    long n16 = 0, n = 0, i, numClipped = 0;
+    pico_Int16 recv, type = 0;
+    unsigned long sum;
+    int numIter, iter, f, ret = 0;
+    double t0, t16 = 0, t, tAfter, d, maxDiff = 0, peak = 0;
+
+    if (argc < 3) {
+        fprintf(stderr, "usage: picobench float <ta.bin> <sg.bin> <text> "
+                "[iterations]\n");
+        return 1;
+    }
+    numIter = (argc > 3) ? atoi(argv[3]) : 5;
+    text = readText(argv[2]);
+    if ((NULL == text) || benchOpen(&b, 2, argv)) {
+        free(text);
+        return 1;
+    }
+
+    for (f = 0; (f < 2) && (0 == ret); f++) {
+        if (picoext_setVoiceOption(b.system, (const pico_Char *)BENCH_VOICE_NAME,
+                PICOEXT_VOICEOPT_SIG_FORMAT, f ? PICO_DATA_FLOAT_32BIT : 0)) {
+            fprintf(stderr, "no float output (fixed point build?)\n");
+            ret = 1;
+            break;
+        }
+        if (pico_newEngine(b.system, (const pico_Char *)BENCH_VOICE_NAME, &engine)) {
+            fprintf(stderr, "cannot create engine\n");
+            ret = 1;
+            break;
+        }
+        if (f) {
+            data = (float *) benchSpeakBytes(engine, text, &n);
+            n /= sizeof(float);
+        } else {
+            pcm = benchSpeakPcm(engine, text, &n16);
+        }
+        t0 = now();
+        for (iter = 0; (iter < numIter) && (NULL != (f ? (void *) data : (void *) pcm)); iter++) {
+            benchSpeak(engine, text, &sum);
+        }
+        t = (now() - t0) * 1000.0 / numIter;
+        pico_getData(engine, dummy, sizeof(dummy), &recv, &type);
+        pico_disposeEngine(b.system, &engine);
+        if (NULL == (f ? (void *) data : (void *) pcm)) {
+            fprintf(stderr, "synthesis failed\n");
+            ret = 1;
+        } else if (!f) {
+            t16 = t;
+            printf("pcm16  %ld samples, %.1f ms/pass\n", n16, t);
+        }
+    }
+
+    if (0 == ret) {
+        mix = (float *) malloc(n16 * sizeof(float) + 1);
+        t0 = now();
+        for (iter = 0; (iter < numIter) && (NULL != mix); iter++) {
+            for (i = 0; i < n16; i++) {
+                mix[i] = pcm[i] * (BENCH_FLOAT_GAIN / 32768.0f);
+            }
+        }
+        tAfter = (now() - t0) * 1000.0 / numIter;
+        for (i = 0; (i < n) && (i < n16); i++) {
+            d = data[i] * 32768.0;
+            if (fabs(d) > peak) {
+                peak = fabs(d);
+            }
+            if ((d > 32767.0) || (d < -32768.0)) {
+                numClipped++;
+            } else if (fabs(d - pcm[i]) > maxDiff) {
+                maxDiff = fabs(d - pcm[i]);
+            }
+        }
+        printf("float  %ld samples, %.1f ms/pass (%+.1f ms); PCM to float"
+               " afterwards %.2f ms/pass\n", n, t, t - t16, tAfter);
+        printf("       peak %.2f dBFS, %ld samples clipped in the PCM,"
+               " %.2f LSB from the PCM elsewhere", 20.0 * log10(peak / 32768.0 + 1e-30),
+               numClipped, maxDiff);
+        if (type != PICO_DATA_FLOAT_32BIT) {
+            printf(", data type %d\n", type);
+            ret = 1;
+        } else if ((n != n16) || (maxDiff > 1.0)) {
+            printf(", DIFFERS from the PCM\n");
+            ret = 1;
+        } else {
+            printf("\n");
+        }
+        free(mix);
+    }
+
+    free(data);
+    free(pcm);
+    benchClose(&b);
+    free(text);
+    return ret;
+}
+
+/* ****************************************************************************/
+/* tempo: WSOLA in SIG against <speed> markup                                 */
+/* ****************************************************************************/
+
+#define BENCH_TS_FRAME      256     /* samples per frame of the spectral distance */
+#define BENCH_TS_HOP        128
+#define BENCH_TS_BANDS      32
+#define BENCH_TS_FLOOR      1e4     /* band power floor, about -80dB of full scale */
+
+/* in-place radix-2 FFT of re/im[0..n-1], n a power of 2 */
+static void benchTsFft(double *re, double *im, int n)
+{
+    int i, j, k, m;
+    double a, wr, wi, tr, ti;
+
+    for (i = 1, j = 0; i < n; i++) {
+        for (k = n >> 1; j & k; k >>= 1) {
+            j ^= k;
+        }
+        j |= k;
+        if (i < j) {
+            tr = re[i]; re[i] = re[j]; re[j] = tr;
+            ti = im[i]; im[i] = im[j]; im[j] = ti;
+        }
+    }
+    for (m = 2; m <= n; m <<= 1) {
+        for (k = 0; k < m / 2; k++) {
+            a = -2.0 * M_PI * k / m;
+            wr = cos(a);
+            wi = sin(a);
+            for (i = k; i < n; i += m) {
+                j = i + m / 2;
+                tr = wr * re[j] - wi * im[j];
+                ti = wr * im[j] + wi * re[j];
+                re[j] = re[i] - tr;
+                im[j] = im[i] - ti;
+                re[i] += tr;
+                im[i] += ti;
+            }
+        }
+    }
+}
+
+/* log band powers (dB) of the Hann windowed frames of x[0..n-1],
+   BENCH_TS_BANDS per frame; returns the number of frames, 'dB' is
+   allocated */
+static long benchTsBands(const short *x, long n, double **dB)
+{
+    double re[BENCH_TS_FRAME], im[BENCH_TS_FRAME], e;
+    long f, numFrames;
+    int i, k, w = BENCH_TS_FRAME / 2 / BENCH_TS_BANDS;
+
+    numFrames = (n < BENCH_TS_FRAME) ? 0 : (n - BENCH_TS_FRAME) / BENCH_TS_HOP + 1;
+    *dB = (double *) malloc((numFrames + 1) * BENCH_TS_BANDS * sizeof(double));
+    if (NULL == *dB) {
+        return -1;
+    }
+    for (f = 0; f < numFrames; f++) {
+        for (i = 0; i < BENCH_TS_FRAME; i++) {
+            re[i] = x[f * BENCH_TS_HOP + i]
+                    * (0.5 - 0.5 * cos(2.0 * M_PI * i / BENCH_TS_FRAME));
+            im[i] = 0;
+        }
+        benchTsFft(re, im, BENCH_TS_FRAME);
+        for (k = 0; k < BENCH_TS_BANDS; k++) {
+            e = 0;
+            for (i = k * w; i < (k + 1) * w; i++) {
+                e += re[i] * re[i] + im[i] * im[i];
+            }
+            (*dB)[f * BENCH_TS_BANDS + k] = 10.0 * log10(e / w + BENCH_TS_FLOOR);
+        }
+    }
+    return numFrames;
+}
+
+/* log spectral distance (dB) of 'x' to the reference 'r' (of another
+   tempo), averaged along the dynamic time warping path between their
+   frames */
+static double benchTsDistance(const double *r, long nr, const double *x, long nx)
+{
+    double *cost[2], *len[2], d, c, l;
+    long i, j;
+    int k, cur;
+
+    for (k = 0; k < 2; k++) {
+        cost[k] = (double *) malloc(nx * sizeof(double));
+        len[k] = (double *) malloc(nx * sizeof(double));
+    }
+    d = -1;
+    if ((nr > 0) && (nx > 0) && (NULL != cost[0]) && (NULL != cost[1])
+            && (NULL != len[0]) && (NULL != len[1])) {
+        for (i = 0; i < nr; i++) {
+            cur = i & 1;
+            for (j = 0; j < nx; j++) {
+                d = 0;
+                for (k = 0; k < BENCH_TS_BANDS; k++) {
+                    c = r[i * BENCH_TS_BANDS + k] - x[j * BENCH_TS_BANDS + k];
+                    d += c * c;
+                }
+                d = sqrt(d / BENCH_TS_BANDS);
+                if ((0 == i) && (0 == j)) {
+                    c = 0;
+                    l = 0;
+                } else if (0 == i) {
+                    c = cost[cur][j - 1];
+                    l = len[cur][j - 1];
+                } else if (0 == j) {
+                    c = cost[!cur][j];
+                    l = len[!cur][j];
+                } else {
+                    c = cost[!cur][j - 1];
+                    l = len[!cur][j - 1];
+                    if (cost[!cur][j] < c) {
+                        c = cost[!cur][j];
+                        l = len[!cur][j];
+                    }
+                    if (cost[cur][j - 1] < c) {
+                        c = cost[cur][j - 1];
+                        l = len[cur][j - 1];
+                    }
+                }
+                cost[cur][j] = c + d;
+                len[cur][j] = l + 1;
+            }
+        }
+        cur = (nr - 1) & 1;
+        d = cost[cur][nx - 1] / len[cur][nx - 1];
+    }
+    for (k = 0; k < 2; k++) {
+        free(cost[k]);
+        free(len[k]);
+    }
+    return d;
+}
+
+/* the stretcher stage of the engine alone on x[0..n-1], in hops of 64
+   samples as in SIG */
+static long benchTsStage(picosigts_Stretcher s, const short *x, long n,
+                         short *y)
+{
+    long i, m = 0;
+
+    picosigts_reset(s);
+    for (i = 0; i < n; i += PICOSIGTS_MAX_IN) {
+        m += picosigts_process(s, (const picoos_int16 *) &x[i],
+                (picoos_int16) ((n - i < PICOSIGTS_MAX_IN) ? n - i : PICOSIGTS_MAX_IN),
+                (picoos_int16 *) &y[m]);
+    }
+    return m;
+}
+
+/* synthesis of 'text' with SIG tempo 'tempo' (0: default) and the time
+   per pass; NULL on failure */
+static short *benchTsSpeak(bench_t *b, const char *text, int tempo, int numIter,
+                           long *n, double *t)
+{
+    pico_Engine engine;
+    pico_Retstring msg;
+    unsigned long sum;
+    short *pcm = NULL;
+    double t0;
+    int iter, ret;
+
+    ret = picoext_setVoiceOption(b->system, (const pico_Char *)BENCH_VOICE_NAME,
+            PICOEXT_VOICEOPT_SIG_TEMPO, tempo);
+    if (0 == ret) {
+        ret = pico_newEngine(b->system, (const pico_Char *)BENCH_VOICE_NAME, &engine);
+    }
+    if (ret) {
+        pico_getSystemStatusMessage(b->system, ret, msg);
+        fprintf(stderr, "cannot create engine (%i): %s\n", ret, msg);
+        return NULL;
+    }
+    /* the first pass only: the random phase continues in the next ones */
+    pcm = benchSpeakPcm(engine, text, n);
+    t0 = now();
+    for (iter = 0; (iter < numIter) && (NULL != pcm); iter++) {
+        benchSpeak(engine, text, &sum);
+    }
+    *t = (now() - t0) * 1000.0 / numIter;
+    pico_disposeEngine(b->system, &engine);
+    if (NULL == pcm) {
+        fprintf(stderr, "synthesis failed\n");
+    }
+    return pcm;
+}
+
+/* per tempo of 150, 200 and 300%: synthesis with <speed> markup (fewer
+   frames) and with the SIG tempo option (WSOLA on all frames), the time
+   per pass, the actual speed-up and the log spectral distance to the
+   output at 100%, time aligned. The stretcher stage alone on the output
+   at 100% must give the output of the engine; tempo 100 must give the
+   default output */
+static int benchTempo(int argc, char *argv[])
+{
+    static const int tempos[] = { 150, 200, 300 };
+    bench_t b;
+    char *text, *fast = NULL;
+    picoos_MemoryManager mm;
+    picosigts_Stretcher stage;
+    void *mem;
+    short *pcm1, *pcm, *staged;
+    double *dB1 = NULL, *dB;
+    long n1 = 0, n, nStaged = 0, nf1, nf;
+    int numIter, iter, i, m, ret = 0;
+    double t0, t1 = 0, t, tStage, d;
+
+    if (argc < 3) {
+        fprintf(stderr, "usage: picobench tempo <ta.bin> <sg.bin> <text> "
+                "[iterations]\n");
+        return 1;
+    }
+    numIter = (argc > 3) ? atoi(argv[3]) : 5;
+    text = readText(argv[2]);
+    if ((NULL == text) || benchOpen(&b, 2, argv)) {
+        free(text);
+        return 1;
+    }
+    fast = (char *) malloc(strlen(text) + 64);
+    pcm1 = benchTsSpeak(&b, text, 0, numIter, &n1, &t1);
+    nf1 = (NULL == pcm1) ? -1 : benchTsBands(pcm1, n1, &dB1);
+    if ((NULL == fast) || (nf1 < 0)) {
+        ret = 1;
+    } else {
+        printf("100%%  %ld samples, %.1f ms/pass\n", n1, t1);
+        pcm = benchTsSpeak(&b, text, 100, 1, &n, &t);
+        if ((NULL == pcm) || (n != n1) || memcmp(pcm, pcm1, n * sizeof(short))) {
+            printf("tempo 100 DIFFERS from the default\n");
+            ret = 1;
+        }
+        free(pcm);
+    }
+
+    for (i = 0; (i < (int) (sizeof(tempos) / sizeof(tempos[0]))) && (0 == ret); i++) {
+        for (m = 0; (m < 2) && (0 == ret); m++) {
+            if (0 == m) {
+                sprintf(fast, "<speed level=\"%d\">%s</speed>", tempos[i], text);
+                pcm = benchTsSpeak(&b, fast, 0, numIter, &n, &t);
+            } else {
+                pcm = benchTsSpeak(&b, text, tempos[i], numIter, &n, &t);
+            }
+            nf = (NULL == pcm) ? -1 : benchTsBands(pcm, n, &dB);
+            if (nf < 0) {
+                free(pcm);
+                ret = 1;
+                break;
+            }
+            d = benchTsDistance(dB1, nf1, dB, nf);
+            printf("%3d%%  %-6s %ld samples (%.2fx), %.1f ms/pass (%.0f%%), "
+                   "LSD %.2f dB", tempos[i], (0 == m) ? "speed" : "WSOLA", n,
+                   (double) n1 / n, t, 100.0 * t / t1, d);
+            free(dB);
+            if (0 == m) {
+                printf("\n");
+                free(pcm);
+                continue;
+            }
+
+            mem = malloc(picosigts_getMemSize(tempos[i]) + 1024);
+            mm = (NULL == mem) ? NULL : picoos_newMemoryManager(mem,
+                    picosigts_getMemSize(tempos[i]) + 1024, FALSE);
+            stage = (NULL == mm) ? NULL : picosigts_newStretcher(mm, tempos[i],
+                    picosigk_getKernels(PICOSIGK_AUTO));
+            staged = (short *) malloc(n1 * sizeof(short));
+            tStage = 0;
+            if ((NULL != stage) && (NULL != staged)) {
+                t0 = now();
+                for (iter = 0; iter < numIter; iter++) {
+                    nStaged = benchTsStage(stage, pcm1, n1, staged);
+                }
+                tStage = (now() - t0) * 1000.0 / numIter;
+            }
+            printf("; stage %.1f ms/pass", tStage);
+            if ((NULL == staged) || (NULL == stage) || (nStaged != n)
+                    || memcmp(staged, pcm, n * sizeof(short))) {
+                printf(", stage DIFFERS from engine\n");
+                ret = 1;
+            } else {
+                printf("\n");
+            }
+            free(staged);
+            free(mem);
+            free(pcm);
+        }
+    }
+
+    free(dB1);
+    free(pcm1);
+    free(fast);
+    benchClose(&b);
+    free(text);
+    return ret;
+}
+
+/* ****************************************************************************/
+/* fastmath: math profiles of SIG against the precise one                     */
+/* ****************************************************************************/
+
+#define BENCH_MATH_LEN      129     /* PICODSP_HFFTSIZE_P1 */
+#define BENCH_MATH_FRAMES   64
+#define BENCH_MATH_SHIFT    27      /* PICODSP_ENVSPEC_SHIFT: amplitude exp(x / 2^27) */
+#define BENCH_MATH_NUM      5
+#define BENCH_MATH_PROFILES 3
+
+static const char *benchMathNames[BENCH_MATH_NUM] = {
+    "picoos_quick_exp", "exp", "pico_fix_exp_quick", "pico_fix_exp",
+    "pico_fix_exp_fast"
+};
+
+/* exp(x / 2^xShift) * 2^yShift by method 'm' */
+static double benchMathExp(int m, picoos_int32 x, int xShift, int yShift)
+{
+    switch (m) {
+        case 0: return picoos_quick_exp(ldexp(x, -xShift)) * ldexp(1, yShift);
+        case 1: return exp(ldexp(x, -xShift)) * ldexp(1, yShift);
+        case 2: return pico_fix_exp_quick(x, xShift, yShift);
+        case 3: return pico_fix_exp(x, xShift, yShift);
+        default: return pico_fix_exp_fast(x, xShift, yShift);
+    }
+}
+
+/* maximum relative error of method 'm' for arguments -20..20 in steps of
+   1/1024, with the results scaled to 2^28..2^30 (no truncation error) */
+static double benchMathError(int m)
+{
+    picoos_int32 x;
+    double e, eMax = 0;
+    int yShift;
+
+    for (x = -20 * (1 << 26); x <= 20 * (1 << 26); x += 1 << 16) {
+        yShift = 28 - (int) floor(ldexp(x, -26) * M_LOG2E);
+        e = fabs(ldexp(benchMathExp(m, x, 26, yShift), -yShift)
+                / exp(ldexp(x, -26)) - 1);
+        eMax = (e > eMax) ? e : eMax;
+    }
+    return eMax;
+}
+
+/* the envelope amplitudes of 'frames' frames by method 'm' as in env_spec */
+static void benchMathRun(int m, const picosigk_kernels_t *k,
+                         picoos_int32 x[][BENCH_MATH_LEN],
+                         picoos_int32 y[][BENCH_MATH_LEN])
+{
+    const double mult = ldexp(1, -BENCH_MATH_SHIFT);
+    int i, j;
+
+    for (i = 0; i < BENCH_MATH_FRAMES; i++) {
+        switch (m) {
+            case 0:
+                for (j = 0; j < BENCH_MATH_LEN; j++) {
+                    y[i][j] = (picoos_int32) picoos_quick_exp(x[i][j] * mult);
+                }
+                break;
+            case 1:
+                for (j = 0; j < BENCH_MATH_LEN; j++) {
+                    y[i][j] = (picoos_int32) exp(x[i][j] * mult);
+                }
+                break;
+            case 2:
+                for (j = 0; j < BENCH_MATH_LEN; j++) {
+                    y[i][j] = pico_fix_exp_quick(x[i][j], BENCH_MATH_SHIFT, 0);
+                }
+                break;
+            case 3:
+                for (j = 0; j < BENCH_MATH_LEN; j++) {
+                    y[i][j] = pico_fix_exp(x[i][j], BENCH_MATH_SHIFT, 0);
+                }
+                break;
+            default:
+                k->expShift(y[i], x[i], BENCH_MATH_SHIFT, BENCH_MATH_LEN);
+                break;
+        }
+    }
+}
+
+/* SNR (dB) and log spectral distance (dB, frame by frame) of x to r */
+static void benchMathDistance(const short *r, const double *rdB, long nf,
+                              const short *x, long n, double *snr, double *lsd)
+{
+    double *dB, sig = 0, err = 0, d, c;
+    long i;
+    int k;
+
+    for (i = 0; i < n; i++) {
+        sig += (double) r[i] * r[i];
+        err += (double) (x[i] - r[i]) * (x[i] - r[i]);
+    }
+    *snr = (err > 0) ? 10.0 * log10(sig / err) : 999.0;
+    *lsd = -1;
+    if (benchTsBands(x, n, &dB) == nf) {
+        *lsd = 0;
+        for (i = 0; i < nf; i++) {
+            d = 0;
+            for (k = 0; k < BENCH_TS_BANDS; k++) {
+                c = rdB[i * BENCH_TS_BANDS + k] - dB[i * BENCH_TS_BANDS + k];
+                d += c * c;
+            }
+            *lsd += sqrt(d / BENCH_TS_BANDS);
+        }
+        *lsd /= (nf > 0) ? nf : 1;
+    }
+    free(dB);
+}
+
+/* the exponential alone: maximum relative error of each method and time
+   per envelope amplitude (the fast one per kernel set), then synthesis
+   in the precise, default and fast profiles (voice option
+   PICOEXT_VOICEOPT_SIG_MATH), the best time of passes taken in turn,
+   and SNR and log spectral distance to the precise one. The fast
+   profile must be closer to it than the default */
+static int benchFastMath(int argc, char *argv[])
+{
+    static const int profiles[BENCH_MATH_PROFILES] = { PICOEXT_SIG_MATH_PRECISE,
+            PICOEXT_SIG_MATH_DEFAULT, PICOEXT_SIG_MATH_FAST };
+    static const char *profileNames[BENCH_MATH_PROFILES] = {
+            "precise", "default", "fast" };
+    static picoos_int32 x[BENCH_MATH_FRAMES][BENCH_MATH_LEN];
+    static picoos_int32 y[BENCH_MATH_FRAMES][BENCH_MATH_LEN];
+    const picosigk_kernels_t *k = NULL;
+    bench_t b[BENCH_MATH_PROFILES];
+    char *text;
+    pico_Engine engine[BENCH_MATH_PROFILES] = { NULL, NULL, NULL };
+    pico_Retstring msg;
+    short *pcm[BENCH_MATH_PROFILES] = { NULL, NULL, NULL };
+    long n[BENCH_MATH_PROFILES];
+    double best[BENCH_MATH_PROFILES];
+    double *refdB = NULL;
+    long nf;
+    unsigned long sum;
+    int numIter, iter, m, isa, i, j, ret = 0;
+    double t0, t, snr, lsd, lsdDefault = 0;
+
+    if (argc < 3) {
+        fprintf(stderr, "usage: picobench fastmath <ta.bin> <sg.bin> <text> "
+                "[iterations]\n");
+        return 1;
+    }
+    numIter = (argc > 3) ? atoi(argv[3]) : 5;
+
+    /* arguments of the amplitudes: -12..4 */
+    srand(1);
+    for (i = 0; i < BENCH_MATH_FRAMES; i++) {
+        for (j = 0; j < BENCH_MATH_LEN; j++) {
+            x[i][j] = (picoos_int32) ((rand() % 16384 - 12288) * (1 << 14));
+        }
+    }
+    for (m = 0; m < BENCH_MATH_NUM; m++) {
+        for (isa = PICOSIGK_SCALAR; isa < ((m < 4) ? PICOSIGK_SCALAR + 1 : PICOSIGK_NUM);
+                isa++) {
+            k = picosigk_getKernels(isa);
+            if (NULL == k) {
+                continue;
+            }
+            t = 1e9;
+            for (iter = 0; iter < 20; iter++) {
+                t0 = now();
+                benchMathRun(m, k, x, y);
+                t0 = now() - t0;
+                t = (t0 < t) ? t0 : t;
+            }
+            printf("%-18s %-7s %5.2f ns  max. relative error %.2e\n",
+                   benchMathNames[m], (m < 4) ? "" : k->name,
+                   t * 1e9 / (BENCH_MATH_FRAMES * BENCH_MATH_LEN),
+                   benchMathError(m));
+        }
+    }
+
+    text = readText(argv[2]);
+    if (NULL == text) {
+        return 1;
+    }
+    /* one system per engine */
+    memset(b, 0, sizeof(b));
+    for (i = 0; (i < BENCH_MATH_PROFILES) && (0 == ret); i++) {
+        ret = benchOpen(&b[i], 2, argv);
+        if (ret) {
+            ret = 1;
+            break;
+        }
+        ret = picoext_setVoiceOption(b[i].system, (const pico_Char *)BENCH_VOICE_NAME,
+                PICOEXT_VOICEOPT_SIG_MATH, profiles[i]);
+        if (0 == ret) {
+            ret = pico_newEngine(b[i].system, (const pico_Char *)BENCH_VOICE_NAME,
+                    &engine[i]);
+        }
+        if (ret) {
+            pico_getSystemStatusMessage(b[i].system, ret, msg);
+            fprintf(stderr, "cannot create engine (%i): %s\n", ret, msg);
+            ret = 1;
+            break;
+        }
+        /* the first pass only: the random phase continues in the next ones */
+        pcm[i] = benchSpeakPcm(engine[i], text, &n[i]);
+        if (NULL == pcm[i]) {
+            fprintf(stderr, "synthesis failed\n");
+            ret = 1;
+        }
+        best[i] = 1e9;
+    }
+    /* in turn, so that all profiles see the same load of the machine */
+    for (iter = 0; (iter < numIter) && (0 == ret); iter++) {
+        for (i = 0; i < BENCH_MATH_PROFILES; i++) {
+            t0 = now();
+            benchSpeak(engine[i], text, &sum);
+            t = (now() - t0) * 1000.0;
+            best[i] = (t < best[i]) ? t : best[i];
+        }
+    }
+    for (i = 0; i < BENCH_MATH_PROFILES; i++) {
+        if (NULL != engine[i]) {
+            pico_disposeEngine(b[i].system, &engine[i]);
+        }
+    }
+
+    nf = (0 == ret) ? benchTsBands(pcm[0], n[0], &refdB) : -1;
+    for (i = 0; (i < BENCH_MATH_PROFILES) && (nf >= 0); i++) {
+        printf("%-8s %ld samples, %.1f ms/pass", profileNames[i], n[i], best[i]);
+        if (0 == i) {
+            printf("\n");
+        } else if (n[i] != n[0]) {
+            printf(", length DIFFERS\n");
+            ret = 1;
+        } else {
+            benchMathDistance(pcm[0], refdB, nf, pcm[i], n[i], &snr, &lsd);
+            printf(" (%+.1f%%), SNR %.1f dB, LSD %.3f dB against precise\n",
+                   100.0 * (best[i] - best[0]) / best[0], snr, lsd);
+            if (PICOEXT_SIG_MATH_DEFAULT == profiles[i]) {
+                lsdDefault = lsd;
+            } else if ((lsd < 0) || (lsd > lsdDefault)) {
+                ret = 1;
+            }
+        }
+    }
+    if (nf < 0) {
+        ret = 1;
+    }
+
+    free(refdB);
+    for (i = 0; i < BENCH_MATH_PROFILES; i++) {
+        free(pcm[i]);
+        if (NULL != b[i].system) {
+            benchClose(&b[i]);
+        }
+    }
+    free(text);
+    return ret;
+}
+
+typedef struct {
+    const char *name;
+    int (*run)(int argc, char *argv[]);
+    const char *help;
+} bench_entry_t;
+
+static const bench_entry_t benches[] = {
+    { "lex", benchLex, "<ta.bin> [iterations]  main lexicon lookups" },
+    { "graphs", benchGraphs, "<ta.bin> [iterations]  graph table lookups" },
+    { "kdt", benchKdt, "<ta.bin> <sg.bin> [iterations]  decision tree classification" },
+    { "g2p", benchG2P, "<ta.bin> [iterations]  G2P of long words, per grapheme and per word" },
+    { "pcache", benchPcache, "<ta.bin> <sg.bin> <text> [iterations] [cachefile]"
+      "  synthesis with pronunciation cache" },
+    { "dtcache", benchDtCache, "<ta.bin> <sg.bin> <text> [iterations]"
+      "  synthesis with decision tree cache" },
+    { "cepsolver", benchCepSolver, "<ta.bin> <sg.bin> <text> [iterations]"
+      "  synthesis with the scalar and lane MGC solvers" },
+    { "pdfexpand", benchPdfExpand, "<ta.bin> <sg.bin> <text> [iterations]"
+      "  synthesis with packed and expanded LFZ/MGC pdfs" },
+    { "silence", benchSilence, "<ta.bin> <sg.bin> <text> [iterations]"
+      "  synthesis without and with silent pause frames" },
+    { "pam", benchPam, "<ta.bin> <sg.bin> [iterations]"
+      "  PAM stage alone on a long paragraph, per syllable" },
+    { "sigkernels", benchSigKernels, "<ta.bin> <sg.bin> <text> [iterations]"
+      "  SIG vector kernels and synthesis per kernel set" },
+    { "fft", benchFft, "<ta.bin> <sg.bin> <text> [iterations]"
+      "  SIG FFT backends and synthesis per backend" },
+    { "sigbatch", benchSigBatch, "<ta.bin> <sg.bin> <text> [iterations]"
+      "  synthesis with SIG batches of 1 to 8 frames" },
+    { "voices", benchVoiceProfiles, "<ta.bin> <sg.bin> <text> [iterations]"
+      "  pitch, formant and noise profiles, two engines in turns" },
+    { "fixedpoint", benchFixedPoint, "<ta.bin> <sg.bin> <text> <pcmfile> [iterations]"
+      "  synthesis time, SNR against the output of another build" },
+    { "resample", benchResample, "<ta.bin> <sg.bin> <text> [iterations]"
+      "  synthesis at 8 to 48kHz against resampling afterwards" },
+    { "encode", benchEncodeFormats, "<ta.bin> <sg.bin> <text> [iterations]"
+      "  G.711 and IMA ADPCM output against encoding afterwards" },
+    { "float", benchFloat, "<ta.bin> <sg.bin> <text> [iterations]"
+      "  float output against 16 bit PCM converted afterwards" },
+    { "tempo", benchTempo, "<ta.bin> <sg.bin> <text> [iterations]"
+      "  WSOLA in SIG against <speed> markup at 150 to 300%" },
+    { "fastmath", benchFastMath, "<ta.bin> <sg.bin> <text> [iterations]"
+      "  exp of the SIG math profiles, synthesis against the precise one" },
+    { "engine", benchEngine, "<ta.bin> <sg.bin> [iterations]"
+      "  engine creation and disposal, engine memory" },
+};
+
+int main(int argc, char *argv[])
+{
+    size_t i;
+
+    if (argc >= 2) {
+        for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+            if (0 == strcmp(argv[1], benches[i].name)) {
+                return benches[i].run(argc - 2, argv + 2);
+            }
+        }
+    }
+    fprintf(stderr, "usage: %s <benchmark> [args]\n", argv[0]);
+    for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+        fprintf(stderr, "  %s %s\n", benches[i].name, benches[i].help);
+    }
+    return 1;
+}
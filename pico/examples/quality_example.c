@@ -21,69 +21,72 @@
 /* Example 1: Basic initialization with quality enhancements */
 void example_basic_initialization(void)
 {
+    pico_quality_context_t ctx;
     printf("\n=== Example 1: Basic Initialization ===\n");
     
     /* Initialize quality enhancement module */
-    if (pico_quality_init() == PICO_OK) {
+    if (pico_quality_init(&ctx) == PICO_OK) {
         printf("✓ Quality enhancement initialized\n");
     }
     
     /* Check current quality mode */
-    int mode = pico_get_quality_mode();
+    int mode = pico_get_quality_mode(&ctx);
     printf("Current quality mode: %d (0=Speed, 1=Balanced, 2=Quality)\n", mode);
     
     /* Cleanup */
-    pico_quality_cleanup();
+    pico_quality_cleanup(&ctx);
 }
 
 /* Example 2: Voice customization for different use cases */
 void example_voice_customization(void)
 {
+    pico_quality_context_t ctx;
     printf("\n=== Example 2: Voice Customization ===\n");
     
-    pico_quality_init();
+    pico_quality_init(&ctx);
     pico_voice_params_t params;
     
     /* Use case 1: Female voice */
     printf("\n--- Female Voice Preset ---\n");
-    pico_apply_voice_profile(PICO_VOICE_PROFILE_FEMALE);
-    pico_get_voice_params(&params);
+    pico_apply_voice_profile(&ctx, PICO_VOICE_PROFILE_FEMALE);
+    pico_get_voice_params(&ctx, &params);
     printf("Pitch scale: %.2f\n", params.pitch_scale);
     printf("Formant shift: %.0f Hz\n", params.formant_shift);
     /* Synthesize: "Hello, how can I help you today?" */
     
     /* Use case 2: Male voice */
     printf("\n--- Male Voice Preset ---\n");
-    pico_apply_voice_profile(PICO_VOICE_PROFILE_MALE);
-    pico_get_voice_params(&params);
+    pico_apply_voice_profile(&ctx, PICO_VOICE_PROFILE_MALE);
+    pico_get_voice_params(&ctx, &params);
     printf("Pitch scale: %.2f\n", params.pitch_scale);
     printf("Formant shift: %.0f Hz\n", params.formant_shift);
     /* Synthesize: "Good morning, welcome to the system" */
     
     /* Use case 3: Child voice */
     printf("\n--- Child Voice Preset ---\n");
-    pico_apply_voice_profile(PICO_VOICE_PROFILE_CHILD);
-    pico_get_voice_params(&params);
+    pico_apply_voice_profile(&ctx, PICO_VOICE_PROFILE_CHILD);
+    pico_get_voice_params(&ctx, &params);
     printf("Pitch scale: %.2f\n", params.pitch_scale);
     printf("Speed scale: %.2f\n", params.speed_scale);
     /* Synthesize: "Hi! Let's play a game!" */
     
     /* Use case 4: Fast notification voice */
     printf("\n--- Fast Notification Voice ---\n");
-    pico_apply_voice_profile(PICO_VOICE_PROFILE_FAST);
-    pico_get_voice_params(&params);
+    pico_apply_voice_profile(&ctx, PICO_VOICE_PROFILE_FAST);
+    pico_get_voice_params(&ctx, &params);
     printf("Speed scale: %.2f\n", params.speed_scale);
     /* Synthesize: "You have 3 new messages" */
     
-    pico_quality_cleanup();
+    pico_quality_cleanup(&ctx);
 }
 
 /* Example 3: Custom voice parameters */
 void example_custom_voice(void)
 {
+    pico_quality_context_t ctx;
     printf("\n=== Example 3: Custom Voice Parameters ===\n");
     
-    pico_quality_init();
+    pico_quality_init(&ctx);
     
     /* Create custom voice parameters */
     pico_voice_params_t custom_params = {
@@ -98,26 +101,27 @@ void example_custom_voice(void)
         printf("✓ Custom parameters are valid\n");
         
         /* Apply custom parameters */
-        pico_set_voice_params(&custom_params);
+        pico_set_voice_params(&ctx, &custom_params);
         printf("✓ Custom voice parameters applied\n");
         printf("  Pitch: %.2fx\n", custom_params.pitch_scale);
         printf("  Speed: %.2fx\n", custom_params.speed_scale);
         printf("  Formant shift: %.0f Hz\n", custom_params.formant_shift);
     }
     
-    pico_quality_cleanup();
+    pico_quality_cleanup(&ctx);
 }
 
 /* Example 4: Quality modes for different scenarios */
 void example_quality_modes(void)
 {
+    pico_quality_context_t ctx;
     printf("\n=== Example 4: Quality Modes ===\n");
     
-    pico_quality_init();
+    pico_quality_init(&ctx);
     
     /* Speed mode - for quick notifications */
     printf("\n--- Speed Mode (fastest, lower quality) ---\n");
-    pico_set_quality_mode(PICO_QUALITY_MODE_SPEED);
+    pico_set_quality_mode(&ctx, PICO_QUALITY_MODE_SPEED);
     printf("Quality mode: Speed\n");
     printf("Best for: Notifications, alerts, time-critical messages\n");
     printf("Expected RTF: ~0.25 (4x real-time)\n");
@@ -125,7 +129,7 @@ void example_quality_modes(void)
     
     /* Balanced mode - default, good quality and speed */
     printf("\n--- Balanced Mode (default) ---\n");
-    pico_set_quality_mode(PICO_QUALITY_MODE_BALANCED);
+    pico_set_quality_mode(&ctx, PICO_QUALITY_MODE_BALANCED);
     printf("Quality mode: Balanced\n");
     printf("Best for: General TTS, voice assistants, smart home\n");
     printf("Expected RTF: ~0.35 (2.8x real-time)\n");
@@ -133,27 +137,28 @@ void example_quality_modes(void)
     
     /* Quality mode - for high-quality speech */
     printf("\n--- Quality Mode (best quality, slower) ---\n");
-    pico_set_quality_mode(PICO_QUALITY_MODE_QUALITY);
+    pico_set_quality_mode(&ctx, PICO_QUALITY_MODE_QUALITY);
     printf("Quality mode: Quality\n");
     printf("Best for: Audiobooks, long-form content, accessibility\n");
     printf("Expected RTF: ~0.55 (1.8x real-time)\n");
     /* Synthesize: "Chapter one. It was the best of times, it was the worst of times..." */
     
-    pico_quality_cleanup();
+    pico_quality_cleanup(&ctx);
 }
 
 /* Example 5: Enhanced prosody for better intonation */
 void example_prosody_enhancement(void)
 {
+    pico_quality_context_t ctx;
     printf("\n=== Example 5: Prosody Enhancement ===\n");
     
-    pico_quality_init();
+    pico_quality_init(&ctx);
     
     /* Standard prosody */
     printf("\n--- Standard Prosody ---\n");
-    pico_reset_prosody_params();
+    pico_reset_prosody_params(&ctx);
     pico_prosody_params_t prosody;
-    pico_get_prosody_params(&prosody);
+    pico_get_prosody_params(&ctx, &prosody);
     printf("Emphasis: %.2f, Pause: %.2f, Question boost: %d%%\n",
            prosody.emphasis_scale, prosody.pause_scale, prosody.question_boost);
     /* Synthesize: "How are you doing today?" */
@@ -163,7 +168,7 @@ void example_prosody_enhancement(void)
     prosody.emphasis_scale = 1.4f;   /* More emphasis */
     prosody.pause_scale = 1.3f;      /* Longer pauses */
     prosody.question_boost = 80;     /* Stronger questions */
-    pico_set_prosody_params(&prosody);
+    pico_set_prosody_params(&ctx, &prosody);
     printf("Emphasis: %.2f, Pause: %.2f, Question boost: %d%%\n",
            prosody.emphasis_scale, prosody.pause_scale, prosody.question_boost);
     /* Synthesize: "THIS is VERY important! Do you understand?" */
@@ -173,20 +178,21 @@ void example_prosody_enhancement(void)
     prosody.emphasis_scale = 0.7f;   /* Less emphasis */
     prosody.pause_scale = 0.8f;      /* Shorter pauses */
     prosody.question_boost = 30;     /* Gentler questions */
-    pico_set_prosody_params(&prosody);
+    pico_set_prosody_params(&ctx, &prosody);
     printf("Emphasis: %.2f, Pause: %.2f, Question boost: %d%%\n",
            prosody.emphasis_scale, prosody.pause_scale, prosody.question_boost);
     /* Synthesize: "Please remain calm and follow the instructions" */
     
-    pico_quality_cleanup();
+    pico_quality_cleanup(&ctx);
 }
 
 /* Example 6: Improved excitation (noise shaping) for better consonants */
 void example_noise_shaping(void)
 {
+    pico_quality_context_t ctx;
     printf("\n=== Example 6: Improved Excitation ===\n");
     
-    pico_quality_init();
+    pico_quality_init(&ctx);
     
     /* Initialize noise filter with LPC coefficients */
     pico_noise_filter_t filter;
@@ -221,29 +227,26 @@ void example_noise_shaping(void)
     printf("  \"She sells seashells by the seashore\"\n");
     printf("  \"The quick brown fox jumps over the lazy dog\"\n");
     
-    pico_quality_cleanup();
+    pico_quality_cleanup(&ctx);
 }
 
 /* Example 7: Statistics and monitoring */
 void example_statistics(void)
 {
+    pico_quality_context_t ctx;
     printf("\n=== Example 7: Quality Statistics ===\n");
     
-    pico_quality_init();
+    pico_quality_init(&ctx);
     
     /* Perform some operations */
     pico_voice_params_t params = {1.2f, 1.0f, 100.0f, PICO_QUALITY_MODE_BALANCED};
-    pico_set_voice_params(&params);
+    pico_set_voice_params(&ctx, &params);
     
     /* Generate some noise */
-    pico_noise_filter_t filter;
     short coeffs[8] = {0};
-    pico_noise_filter_init(&filter, coeffs, 8);
-    
-    unsigned int seed = 12345;
-    for (int i = 0; i < 100; i++) {
-        pico_generate_shaped_noise(&filter, &seed);
-    }
+    short noise[100];
+    pico_quality_set_noise_filter(&ctx, coeffs, 8);
+    pico_quality_generate_noise(&ctx, noise, 100);
     
     /* Apply some transformations */
     for (int i = 0; i < 50; i++) {
@@ -253,7 +256,7 @@ void example_statistics(void)
     
     /* Get statistics */
     pico_quality_stats_t stats;
-    if (pico_get_quality_stats(&stats) == PICO_OK) {
+    if (pico_get_quality_stats(&ctx, &stats) == PICO_OK) {
         printf("Quality Enhancement Statistics:\n");
         printf("  Noise samples generated: %u\n", stats.noise_samples_generated);
         printf("  Filter updates: %u\n", stats.filter_updates);
@@ -262,36 +265,37 @@ void example_statistics(void)
     }
     
     /* Reset statistics */
-    pico_reset_quality_stats();
+    pico_reset_quality_stats(&ctx);
     printf("\n✓ Statistics reset\n");
     
-    pico_quality_cleanup();
+    pico_quality_cleanup(&ctx);
 }
 
 /* Example 8: Complete synthesis workflow with quality enhancements */
 void example_complete_workflow(void)
 {
+    pico_quality_context_t ctx;
     printf("\n=== Example 8: Complete Synthesis Workflow ===\n");
     
     /* Initialize quality enhancements */
-    pico_quality_init();
+    pico_quality_init(&ctx);
     
     /* Set desired voice profile */
     printf("\n1. Setting voice profile to FEMALE...\n");
-    pico_apply_voice_profile(PICO_VOICE_PROFILE_FEMALE);
+    pico_apply_voice_profile(&ctx, PICO_VOICE_PROFILE_FEMALE);
     
     /* Set quality mode */
     printf("2. Setting quality mode to BALANCED...\n");
-    pico_set_quality_mode(PICO_QUALITY_MODE_BALANCED);
+    pico_set_quality_mode(&ctx, PICO_QUALITY_MODE_BALANCED);
     
     /* Adjust prosody for expressiveness */
     printf("3. Adjusting prosody for expressiveness...\n");
     pico_prosody_params_t prosody = {1.2f, 1.1f, 60};
-    pico_set_prosody_params(&prosody);
+    pico_set_prosody_params(&ctx, &prosody);
     
     /* Display final configuration */
     pico_voice_params_t voice;
-    pico_get_voice_params(&voice);
+    pico_get_voice_params(&ctx, &voice);
     printf("\nFinal Configuration:\n");
     printf("  Voice: Female\n");
     printf("  Pitch scale: %.2fx\n", voice.pitch_scale);
@@ -313,7 +317,7 @@ void example_complete_workflow(void)
     
     printf("\n✓ Workflow complete\n");
     
-    pico_quality_cleanup();
+    pico_quality_cleanup(&ctx);
 }
 
 /* Main program */
@@ -15,6 +15,7 @@ LOCAL_SRC_FILES := \
 	picodbg.c \
 	picoextapi.c \
 	picofftsg.c \
+	picofixedpoint.c \
 	picokdbg.c \
 	picokdt.c \
 	picokfst.c \
@@ -26,11 +27,16 @@ LOCAL_SRC_FILES := \
 	picoos.c \
 	picopal.c \
 	picopam.c \
+	picopcache.c \
 	picopr.c \
 	picorsrc.c \
 	picosa.c \
 	picosig.c \
 	picosig2.c \
+	picosigk.c \
+	picosigrs.c \
+	picosigenc.c \
+	picosigts.c \
 	picospho.c \
 	picotok.c \
 	picotrns.c \
@@ -32,6 +32,7 @@
 #include "picodata.h"
 #include "picoacph.h"
 #include "picokdt.h"
+#include "picodtcache.h"
 #include "picoklex.h"
 #include "picoktab.h"
 
@@ -367,6 +368,24 @@ static picoos_uint8 acphPhrItemSeqGetPosLeft(register picodata_ProcessingUnit th
 }
 
 
+/* decision tree cache key: POS window followed by the numeric attributes */
+static picoos_uint16 acphDtCacheKey(picoos_uint8 *key,
+                                    const picoos_uint8 *valbuf,
+                                    const picoos_uint16 *nrs,
+                                    const picoos_uint8 nrnrs) {
+    picoos_uint16 keylen;
+    picoos_uint8 i;
+
+    for (keylen = 0; keylen < 5; keylen++) {
+        key[keylen] = valbuf[keylen];
+    }
+    for (i = 0; i < nrnrs; i++) {
+        keylen = picodt_cache_key_put16(key, keylen, nrs[i]);
+    }
+    return keylen;
+}
+
+
 /* right-to-left, for each WORDPHON do phr */
 static pico_status_t acphSubPhrasing(register picodata_ProcessingUnit this,
                                    register acph_subobj_t *acph) {
@@ -381,6 +400,12 @@ static pico_status_t acphSubPhrasing(register picodata_ProcessingUnit this,
     picoos_uint8 okay;
     picoos_uint8 nosubphrases;
     picoos_int32 i;
+    picodt_cache_t *dtCache = this->voice->dtCache;
+    picoos_uint8 dtCached;
+    picoos_uint8 key[11];
+    picoos_uint16 nrs[3];
+    picoos_uint16 keylen = 0;
+    picoos_uint32 hash = 0;
 
     /* set initial values */
     okay = TRUE;
@@ -469,8 +494,19 @@ static pico_status_t acphSubPhrasing(register picodata_ProcessingUnit this,
                        valbuf[4], nrwordspre, nrwordsfol, nrsyllsfol));
 
         /* no continue so far => subphrasing needed */
+        dtCached = FALSE;
+        if (picodt_cache_is_enabled(dtCache)) {
+            nrs[0] = nrwordspre;
+            nrs[1] = nrwordsfol;
+            nrs[2] = nrsyllsfol;
+            keylen = acphDtCacheKey(key, valbuf, nrs, 3);
+            hash = picodt_compute_extended_hash(key, keylen);
+            dtCached = picodt_cache_lookup(dtCache, PICOKNOW_KBID_DT_PHR,
+                                           key, keylen, hash, &dtres, NULL);
+        }
         /* construct input vector, which is set in dtphr */
-        if (!picokdt_dtPHRconstructInVec(acph->dtphr, valbuf[0], valbuf[1],
+        if (!dtCached &&
+            !picokdt_dtPHRconstructInVec(acph->dtphr, valbuf[0], valbuf[1],
                                          valbuf[2], valbuf[3], valbuf[4],
                                          nrwordspre, nrwordsfol, nrsyllsfol)) {
             /* error constructing invec */
@@ -480,7 +516,7 @@ static pico_status_t acphSubPhrasing(register picodata_ProcessingUnit this,
             okay = FALSE;
         }
         /* classify */
-        if (okay && (!picokdt_dtPHRclassify(acph->dtphr))) {
+        if (okay && !dtCached && (!picokdt_dtPHRclassify(acph->dtphr))) {
             /* error doing classification */
             PICODBG_WARN(("problem classifying"));
             picoos_emRaiseWarning(this->common->em, PICO_WARN_CLASSIFICATION,
@@ -488,13 +524,18 @@ static pico_status_t acphSubPhrasing(register picodata_ProcessingUnit this,
             okay = FALSE;
         }
         /* decompose */
-        if (okay && (!picokdt_dtPHRdecomposeOutClass(acph->dtphr, &dtres))) {
+        if (okay && !dtCached &&
+            (!picokdt_dtPHRdecomposeOutClass(acph->dtphr, &dtres))) {
             /* error decomposing */
             PICODBG_WARN(("problem decomposing"));
             picoos_emRaiseWarning(this->common->em, PICO_WARN_OUTVECTOR,
                                   NULL, NULL);
             okay = FALSE;
         }
+        if (okay && !dtCached && picodt_cache_is_enabled(dtCache)) {
+            picodt_cache_insert(dtCache, PICOKNOW_KBID_DT_PHR, key, keylen,
+                                hash, &dtres, 0);
+        }
 
         if (okay && dtres.set) {
             PICODBG_DEBUG(("%d - inpos: %d, out: %d", i,valbuf[2],dtres.class));
@@ -800,6 +841,12 @@ static pico_status_t acphAccentuation(register picodata_ProcessingUnit this,
     picoos_uint8 okay;
     picoos_int32 upbound;   /* index of last WORDPHON item (with POS) */
     picoos_uint16 i;
+    picodt_cache_t *dtCache = this->voice->dtCache;
+    picoos_uint8 dtCached;
+    picoos_uint8 key[21];
+    picoos_uint16 nrs[8];
+    picoos_uint16 keylen = 0;
+    picoos_uint32 hash = 0;
 
     /* set initial values */
     okay = TRUE;
@@ -902,8 +949,25 @@ static pico_status_t acphAccentuation(register picodata_ProcessingUnit this,
                        nrwordsfol, nrsyllsfol, footwordsfol, footsyllsfol));
 
         /* no continue so far => accentuation needed */
+        dtCached = FALSE;
+        if (okay && picodt_cache_is_enabled(dtCache)) {
+            nrs[0] = hist1;
+            nrs[1] = hist2;
+            nrs[2] = nrwordspre;
+            nrs[3] = nrsyllspre;
+            nrs[4] = nrwordsfol;
+            nrs[5] = nrsyllsfol;
+            nrs[6] = footwordsfol;
+            nrs[7] = footsyllsfol;
+            keylen = acphDtCacheKey(key, valbuf, nrs, 8);
+            hash = picodt_compute_extended_hash(key, keylen);
+            dtCached = picodt_cache_lookup(dtCache, PICOKNOW_KBID_DT_ACC,
+                                           key, keylen, hash, &dtres,
+                                           &prevout);
+        }
         /* construct input vector, which is set in dtacc */
-        if (!picokdt_dtACCconstructInVec(acph->dtacc, valbuf[0], valbuf[1],
+        if (!dtCached &&
+            !picokdt_dtACCconstructInVec(acph->dtacc, valbuf[0], valbuf[1],
                                          valbuf[2], valbuf[3], valbuf[4],
                                          hist1, hist2, nrwordspre, nrsyllspre,
                                          nrwordsfol, nrsyllsfol, footwordsfol,
@@ -915,7 +979,8 @@ static pico_status_t acphAccentuation(register picodata_ProcessingUnit this,
             okay = FALSE;
         }
         /* classify */
-        if (okay && (!picokdt_dtACCclassify(acph->dtacc, &prevout))) {
+        if (okay && !dtCached &&
+            (!picokdt_dtACCclassify(acph->dtacc, &prevout))) {
             /* error doing classification */
             PICODBG_WARN(("problem classifying"));
             picoos_emRaiseWarning(this->common->em, PICO_WARN_CLASSIFICATION,
@@ -923,13 +988,18 @@ static pico_status_t acphAccentuation(register picodata_ProcessingUnit this,
             okay = FALSE;
         }
         /* decompose */
-        if (okay && (!picokdt_dtACCdecomposeOutClass(acph->dtacc, &dtres))) {
+        if (okay && !dtCached &&
+            (!picokdt_dtACCdecomposeOutClass(acph->dtacc, &dtres))) {
             /* error decomposing */
             PICODBG_WARN(("problem decomposing"));
             picoos_emRaiseWarning(this->common->em, PICO_WARN_OUTVECTOR,
                                   NULL, NULL);
             okay = FALSE;
         }
+        if (okay && !dtCached && picodt_cache_is_enabled(dtCache)) {
+            picodt_cache_insert(dtCache, PICOKNOW_KBID_DT_ACC, key, keylen,
+                                hash, &dtres, prevout);
+        }
 
         if (dtres.class > 255) {
             PICODBG_WARN(("dt class outside valid range, setting to ACC0"));
@@ -653,7 +653,9 @@ PICO_FUNC pico_getData(
         }
     }
 
-    *outDataType = PICO_DATA_PCM_16BIT;
+    *outDataType = picoctrl_isValidEngineHandle((picoctrl_Engine) engine)
+            ? picoctrl_engGetOutputDataType((picoctrl_Engine) engine)
+            : PICO_DATA_PCM_16BIT;
     return status;
 }
 
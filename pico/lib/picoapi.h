@@ -401,7 +401,8 @@ PICO_FUNC pico_putTextUtf8(
    repeatedly till 'outBytesReceived' bytes are returned in
    'outBuffer'. The type of data returned in 'outBuffer' (e.g. 8 or 16
    bit PCM samples) is returned in 'outDataType' and depends on the
-   lingware resources. Possible 'outDataType' values are listed in
+   lingware resources and the voice option PICOEXT_VOICEOPT_SIG_FORMAT
+   (see picoextapi.h). Possible 'outDataType' values are listed in
    picodefs.h (PICO_DATA_*).
    This function returns PICO_STEP_BUSY while processing input and
    producing speech output. Once all data is returned and there is no
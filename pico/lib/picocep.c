@@ -62,6 +62,7 @@
 #include "picokpdf.h"
 #include "picodsp.h"
 #include "picocep.h"
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -70,7 +71,16 @@ extern "C" {
 }
 #endif
 
+#if defined(PICO_USE_CEP_WINDOW)
+/* sliding window, see picocep.h; the window starts with the last
+   PICOCEP_WIN_HIST frames already output (needed to set up the next rows) */
+#define PICOCEP_WIN_HIST 2
+#define PICOCEP_MAXWINLEN (PICOCEP_WIN_HIST + PICOCEP_WIN_STEP + PICOCEP_WIN_LOOKAHEAD)
+#else
 #define PICOCEP_MAXWINLEN 10000  /* maximum number of frames that can be smoothed, i.e. maximum sentence length */
+#endif
+/* lane solvers, see picocep.h: number of coefficients solved in lockstep */
+#define PICOCEP_LANES 8
 #define PICOCEP_MSGSTR_SIZE 32
 #define PICOCEP_IN_BUFF_SIZE PICODATA_BUFSIZE_DEFAULT
 
@@ -142,6 +152,28 @@ int numlongmult = 0, numshortmult = 0;
 /* item num restriction: maximum size of all item contents together in cont */
 #define PICOCEP_MAXSIZE_CBUF 7680 /* (128 * PICOCEP_MAXNR_HEADX) */
 
+/* forward elimination state of the last two rows of a window for one
+   cepstral dimension, used to continue the elimination in the next window */
+typedef struct
+{
+    picoos_int32 diag0[2], diag1[2], diag2[2], WUm[2];
+    picoos_uint8 rowscpow[2];
+} picocep_fwdstate_t;
+
+/* the same for the floating point lane solver (L D L' factorization) */
+typedef struct
+{
+    picoos_single D[2], L1[2], L2[2], y[2];
+} picocep_fwdstatef_t;
+
+/* element of the lane solver buffers; the rows are set up in fixed point
+   and converted in place by the floating point solver */
+typedef union
+{
+    picoos_int32 i;
+    picoos_single f;
+} picocep_lane_t;
+
 typedef struct
 {
     picodata_itemhead_t head;
@@ -192,6 +224,13 @@ typedef struct cep_subobj
             diag2[PICOCEP_MAXWINLEN], WUm[PICOCEP_MAXWINLEN],
             invdiag0[PICOCEP_MAXWINLEN];
 
+    /* MGC solver; the lane solvers use the coefficient-major buffers
+       lane*[frame * PICOCEP_LANES + lane] (NULL for the scalar solver) */
+    picoos_uint8 solver;
+    picocep_lane_t * lanes;
+    picocep_lane_t * laneDiag0, * laneDiag1, * laneDiag2, * laneWUm,
+            * laneInv;
+
     /*---------------------- constants --------------------------------------*/
     picoos_int32 xi[5], x1[2], x2[3], xm[3], xn[2];
     picoos_int32 xsqi[5], xsq1[2], xsq2[3], xsqm[3], xsqn[2];
@@ -205,6 +244,19 @@ typedef struct cep_subobj
     picoos_uint16 indicesMGC[PICOCEP_MAXWINLEN];
     picoos_uint16 indexReadPos, indexWritePos;
     picoos_uint16 activeEndPos; /* end position of indices to be considered */
+    picoos_uint16 emitStartPos; /* first index to be output; indices before are left context */
+#if defined(PICO_USE_CEP_WINDOW)
+    picoos_uint16 phoneState, phoneFrame; /* where to resume a partially buffered phone */
+    /* elimination state at emitStartPos, valid if fwdValid */
+    picocep_fwdstate_t fwdLFZ[PICOKPDF_MAX_MUL_LFZ_CEPORDER];
+    picocep_fwdstate_t fwdMGC[PICOKPDF_MAX_MUL_MGC_CEPORDER];
+    picocep_fwdstatef_t fwdMGCf[PICOKPDF_MAX_MUL_MGC_CEPORDER]; /* PICOCEP_SOLVER_LANES_FLOAT */
+    picoos_bool fwdValid;
+    /* previous window's solution for the first frames of the next step */
+    picoos_int16 mergeF0[PICOCEP_WIN_OVERLAP * PICOKPDF_MAX_MUL_LFZ_CEPORDER];
+    picoos_int16 mergeXCep[PICOCEP_WIN_OVERLAP * PICOKPDF_MAX_MUL_MGC_CEPORDER];
+    picoos_uint16 mergeLen;
+#endif
 
     /* this is used for input and output */
     picoos_uint8 phoneId[PICOCEP_MAXWINLEN]; /* synchronised with indexReadPos */
@@ -243,18 +295,27 @@ typedef struct cep_subobj
 
 static void initSmoothing(cep_subobj_t * cep);
 
-static picoos_int32 getFromPdf(picokpdf_PdfMUL pdf, picoos_uint32 vecstart,
+static picoos_int32 getFromPdf(picokpdf_PdfMUL pdf, picoos_uint16 pdfindex,
         picoos_uint8 cepnum, picocep_WantMeanOrIvar_t wantMeanOrIvar,
         picocep_WantStaticOrDelta_t wantStaticOrDeltax);
 
+static picoos_int32 getFromPdfPacked(picokpdf_PdfMUL pdf,
+        picoos_uint32 vecstart, picoos_uint8 cepnum,
+        picocep_WantMeanOrIvar_t wantMeanOrIvar,
+        picocep_WantStaticOrDelta_t wantStaticOrDeltax);
+
 static void invMatrix(cep_subobj_t * cep, picoos_uint16 N,
         picoos_int16 *smoothcep, picoos_uint8 cepnum,
-        picokpdf_PdfMUL pdf, picoos_uint8 invpow, picoos_uint8 invDoubleDec);
+        picokpdf_PdfMUL pdf, picoos_uint8 invpow, picoos_uint8 invDoubleDec,
+        picoos_uint16 b, picoos_uint16 e, picocep_fwdstate_t * fwd);
 
 static picoos_uint8 makeWUWandWUm(cep_subobj_t * cep, picokpdf_PdfMUL pdf,
         picoos_uint16 *indices, picoos_uint16 b, picoos_uint16 N,
         picoos_uint8 cepnum);
 
+static void smoothLanes(cep_subobj_t * cep, picokpdf_PdfMUL pdf,
+        picoos_uint16 N, picoos_uint16 b, picoos_uint16 e);
+
 static void getDirect(picokpdf_PdfMUL pdf, picoos_uint16 *indices,
         picoos_uint16 activeEndPos,
         picoos_uint8 cepnum, picoos_int16 *smoothcep);
@@ -269,6 +330,12 @@ static void treat_phone(cep_subobj_t * cep, picodata_itemhead_t * ihead);
 
 static picoos_uint8 forwardingItem(picodata_itemhead_t * ihead);
 
+#if defined(PICO_USE_CEP_WINDOW)
+static void mergeWindow(cep_subobj_t * cep);
+
+static void shiftWindow(cep_subobj_t * cep);
+#endif
+
 static picodata_step_result_t cepStep(register picodata_ProcessingUnit this,
         picoos_int16 mode, picoos_uint16 * numBytesOutput);
 
@@ -308,6 +375,12 @@ static pico_status_t cepInitialize(register picodata_ProcessingUnit this, picoos
     /* indices* */
     cep->indexReadPos = 0;
     cep->indexWritePos = 0;
+    cep->emitStartPos = 0;
+#if defined(PICO_USE_CEP_WINDOW)
+    cep->phoneState = cep->phoneFrame = 0;
+    cep->fwdValid = FALSE;
+    cep->mergeLen = 0;
+#endif
     /* outCep, outF0, outVoiced */
     cep->outXCepReadPos = 0;
     cep->outXCepWritePos = 0;
@@ -397,6 +470,9 @@ static pico_status_t cepSubObjDeallocate(register picodata_ProcessingUnit this,
 #endif
     if (NULL != this) {
         cep_subobj_t * cep = (cep_subobj_t *) this->subObj;
+        if (NULL != cep->lanes) {
+            picoos_deallocate(this->common->mm, (void *) &cep->lanes);
+        }
         picoos_deallocate(this->common->mm, (void *) &cep->outXCep);
         picoos_deallocate(this->common->mm, (void *) &cep->outVoiced);
         picoos_deallocate(this->common->mm, (void *) &cep->outF0);
@@ -463,11 +539,39 @@ picodata_ProcessingUnit picocep_newCepUnit(picoos_MemoryManager mm,
         picoos_deallocate(mm, (void*) &this);
         return NULL;
     }
+
+    /* work buffers of the lane solvers; the engine memory has been sized
+       for them (picocep_getSolverMemSize), else use the scalar solver */
+    cep->solver = (picoos_uint8) voice->options[PICORSRC_VOPT_CEP_SOLVER];
+    cep->lanes = NULL;
+    if (PICOCEP_SOLVER_SCALAR != cep->solver) {
+        cep->lanes = (picocep_lane_t *) picoos_allocate(this->common->mm,
+                5 * PICOCEP_MAXWINLEN * PICOCEP_LANES * sizeof(picocep_lane_t));
+        if (NULL == cep->lanes) {
+            PICODBG_WARN(("no memory for the lane solver, using the scalar solver"));
+            cep->solver = PICOCEP_SOLVER_SCALAR;
+        } else {
+            cep->laneDiag0 = cep->lanes;
+            cep->laneDiag1 = cep->laneDiag0 + PICOCEP_MAXWINLEN * PICOCEP_LANES;
+            cep->laneDiag2 = cep->laneDiag1 + PICOCEP_MAXWINLEN * PICOCEP_LANES;
+            cep->laneWUm = cep->laneDiag2 + PICOCEP_MAXWINLEN * PICOCEP_LANES;
+            cep->laneInv = cep->laneWUm + PICOCEP_MAXWINLEN * PICOCEP_LANES;
+        }
+    }
     cepInitialize(this, PICO_RESET_FULL);
 
     return this;
 }/*picocep_newCepUnit*/
 
+picoos_objsize_t picocep_getSolverMemSize(picoos_int32 solver)
+{
+    if (PICOCEP_SOLVER_SCALAR == solver) {
+        return 0;
+    }
+    /* plus allocation overhead */
+    return 5 * PICOCEP_MAXWINLEN * PICOCEP_LANES * sizeof(picocep_lane_t) + 64;
+}
+
 /* --------------------------------------------
  *   processing and internal functions
  * --------------------------------------------
@@ -874,6 +978,9 @@ static void initSmoothing(cep_subobj_t * cep)
  * @param    invpow :  fixed point base for inverse
  * @param    invDoubleDec : boolean indicating that result of picocep_fixptinv has fixed point base 2*bigpow
  *             picocep_fixptmult absorbs double decimal size by dividing its result by extra factor big
+ * @param    b : first frame to be solved; if b > 0, the elimination of rows b-2 and b-1 is taken from fwd
+ * @param    e : if e > 0, the elimination of rows e-2 and e-1 is saved to fwd
+ * @param    fwd : elimination state (only used if b > 0 or e > 0)
  * @return  void
  * @remarks diag0, diag1, diag2, WUm, invdiag0  globals needed in this function (object members in pico)
  * @callgraph
@@ -881,9 +988,10 @@ static void initSmoothing(cep_subobj_t * cep)
  */
 static void invMatrix(cep_subobj_t * cep, picoos_uint16 N,
         picoos_int16 *smoothcep, picoos_uint8 cepnum,
-        picokpdf_PdfMUL pdf, picoos_uint8 invpow, picoos_uint8 invDoubleDec)
+        picokpdf_PdfMUL pdf, picoos_uint8 invpow, picoos_uint8 invDoubleDec,
+        picoos_uint16 b, picoos_uint16 e, picocep_fwdstate_t * fwd)
 {
-    picoos_int32 j, v1, v2, h;
+    picoos_int32 j, j0, v1, v2, h;
     picoos_uint32 k;
     picoos_uint8 rowscpow, prevrowscpow;
     picoos_uint8 ceporder = pdf->ceporder;
@@ -892,25 +1000,39 @@ static void invMatrix(cep_subobj_t * cep, picoos_uint16 N,
 
     /* LDL factorization */
     prevrowscpow = 0;
-    cep->invdiag0[0] = picocep_fixptInvDiagEle(cep->diag0[0], &rowscpow,
-            bigpow, invpow); /* inverse has fixed point basis 1<<invpow */
-    if (cep->diag1[0] >= 0)
-      cep->diag1[0] <<= rowscpow;
-    else
-      cep->diag1[0] = -(-cep->diag1[0] << rowscpow);
-    cep->diag1[0] = picocep_fixptinv(cep->diag1[0],
-            cep->invdiag0[0], bigpow, invpow, invDoubleDec); /* perform division via inverse */
-    if (cep->diag2[0] >= 0)
-      cep->diag2[0] <<= rowscpow;
-    else
-      cep->diag2[0] = -(-cep->diag2[0] << rowscpow);
-    cep->diag2[0] = picocep_fixptinv(cep->diag2[0],
-            cep->invdiag0[0], bigpow, invpow, invDoubleDec);
-    if (cep->WUm[0] >= 0)
-      cep->WUm[0] = (cep->WUm[0]) << rowscpow; /* if diag0 too low, multiply LHS and RHS of row in matrix equation by 1<<rowscpow */
-    else
-      cep->WUm[0] = -(-cep->WUm[0] << rowscpow); /* if diag0 too low, multiply LHS and RHS of row in matrix equation by 1<<rowscpow */
-    for (j = 1; j < N; j++) {
+    if (b > 0) {
+        /* continue the elimination of the previous window */
+        for (j = 0; j < 2; j++) {
+            cep->diag0[b - 2 + j] = fwd->diag0[j];
+            cep->diag1[b - 2 + j] = fwd->diag1[j];
+            cep->diag2[b - 2 + j] = fwd->diag2[j];
+            cep->WUm[b - 2 + j] = fwd->WUm[j];
+        }
+        prevrowscpow = fwd->rowscpow[0];
+        rowscpow = fwd->rowscpow[1];
+        j0 = b;
+    } else {
+        cep->invdiag0[0] = picocep_fixptInvDiagEle(cep->diag0[0], &rowscpow,
+                bigpow, invpow); /* inverse has fixed point basis 1<<invpow */
+        if (cep->diag1[0] >= 0)
+          cep->diag1[0] <<= rowscpow;
+        else
+          cep->diag1[0] = -(-cep->diag1[0] << rowscpow);
+        cep->diag1[0] = picocep_fixptinv(cep->diag1[0],
+                cep->invdiag0[0], bigpow, invpow, invDoubleDec); /* perform division via inverse */
+        if (cep->diag2[0] >= 0)
+          cep->diag2[0] <<= rowscpow;
+        else
+          cep->diag2[0] = -(-cep->diag2[0] << rowscpow);
+        cep->diag2[0] = picocep_fixptinv(cep->diag2[0],
+                cep->invdiag0[0], bigpow, invpow, invDoubleDec);
+        if (cep->WUm[0] >= 0)
+          cep->WUm[0] = (cep->WUm[0]) << rowscpow; /* if diag0 too low, multiply LHS and RHS of row in matrix equation by 1<<rowscpow */
+        else
+          cep->WUm[0] = -(-cep->WUm[0] << rowscpow); /* if diag0 too low, multiply LHS and RHS of row in matrix equation by 1<<rowscpow */
+        j0 = 1;
+    }
+    for (j = j0; j < N; j++) {
         /* do forward substitution */
         cep->WUm[j] = cep->WUm[j] - picocep_fixptmult(cep->diag1[j - 1],
                 cep->WUm[j - 1], bigpow, invDoubleDec);
@@ -954,10 +1076,19 @@ static void invMatrix(cep_subobj_t * cep, picoos_uint16 N,
               cep->diag2[j] = picocep_fixptinv(-(-cep->diag2[j] << rowscpow),
                       cep->invdiag0[j], bigpow, invpow, invDoubleDec); /* eliminate column j below pivot */
         }
+        if ((e > 0) && (j + 2 >= e) && (j < e)) {
+            /* save the elimination for the next window */
+            h = j + 2 - e;
+            fwd->diag0[h] = cep->diag0[j];
+            fwd->diag1[h] = cep->diag1[j];
+            fwd->diag2[h] = cep->diag2[j];
+            fwd->WUm[h] = cep->WUm[j];
+            fwd->rowscpow[h] = rowscpow;
+        }
     }
 
     /* divide all entries of WUm by diag0 */
-    for (j = 0; j < N; j++) {
+    for (j = b; j < N; j++) {
         cep->WUm[j] = picocep_fixptinv(cep->WUm[j], cep->invdiag0[j], bigpow,
                 invpow, invDoubleDec);
         if (invDoubleDec == 1) {
@@ -966,7 +1097,7 @@ static void invMatrix(cep_subobj_t * cep, picoos_uint16 N,
     }
 
     /* backward substitution */
-    for (j = N - 2; j >= 0; j--) {
+    for (j = N - 2; j >= b; j--) {
         cep->WUm[j] = cep->WUm[j] - picocep_fixptmult(cep->diag1[j], cep->WUm[j
                 + 1], bigpow, invDoubleDec);
         if (j < N - 2) {
@@ -976,8 +1107,8 @@ static void invMatrix(cep_subobj_t * cep, picoos_uint16 N,
     }
     /* copy N frames into smoothcep (only for coeff # "cepnum")  */
     /* coefficients normalized to occupy short; for correct waveform energy, divide by (1<<(bigpow-meanpow)) then convert e.g. to picoos_single */
-    k = cepnum;
-    for (j = 0; j < N; j++) {
+    k = b * ceporder + cepnum;
+    for (j = b; j < N; j++) {
         smoothcep[k] = (picoos_int16)(cep->WUm[j]/(1<<meanpow));
         k += ceporder;
     }
@@ -1004,11 +1135,10 @@ static picoos_uint8 makeWUWandWUm(cep_subobj_t * cep, picokpdf_PdfMUL pdf,
 {
     picoos_uint16 Id[2], Idd[3];
     /*picoos_uint32      vecstart, k;*/
-    picoos_uint32 vecstart;
+    picoos_uint16 pdfindex;
     picoos_int32 *x = NULL, *xsq = NULL;
     picoos_int32 mean, ivar;
     picoos_uint16 i, j, numd = 0, numdd = 0;
-    picoos_uint8 vecsize = pdf->vecsize;
     picoos_int32 prev_WUm, prev_diag0, prev_diag1, prev_diag1_1, prev_diag2;
 
     prev_WUm = prev_diag0 = prev_diag1 = prev_diag1_1 = prev_diag2 = 0;
@@ -1053,11 +1183,11 @@ static picoos_uint8 makeWUWandWUm(cep_subobj_t * cep, picokpdf_PdfMUL pdf,
             cep->diag0[i] = prev_diag0;
             cep->WUm[i] = prev_WUm;
         } else {
-            vecstart = indices[b + i] * vecsize;
-            ivar = getFromPdf(pdf, vecstart, cepnum, PICOCEP_WANTIVAR,
+            pdfindex = indices[b + i];
+            ivar = getFromPdf(pdf, pdfindex, cepnum, PICOCEP_WANTIVAR,
                     PICOCEP_WANTSTATIC);
             prev_diag0 = cep->diag0[i] = ivar << 2; /* multiply ivar by 4 (4 used to be first entry of xsq) */
-            mean = getFromPdf(pdf, vecstart, cepnum, PICOCEP_WANTMEAN,
+            mean = getFromPdf(pdf, pdfindex, cepnum, PICOCEP_WANTMEAN,
                     PICOCEP_WANTSTATIC);
             if (mean >= 0)
               prev_WUm = cep->WUm[i] = mean << 1; /* multiply mean by 2 (2 used to be first entry of x) */
@@ -1067,12 +1197,12 @@ static picoos_uint8 makeWUWandWUm(cep_subobj_t * cep, picokpdf_PdfMUL pdf,
 
         /* process delta means and delta inverse variances */
         for (j = 0; j < numd; j++) {
-            vecstart = indices[b + Id[j]] * vecsize;
-            ivar = getFromPdf(pdf, vecstart, cepnum, PICOCEP_WANTIVAR,
+            pdfindex = indices[b + Id[j]];
+            ivar = getFromPdf(pdf, pdfindex, cepnum, PICOCEP_WANTIVAR,
                     PICOCEP_WANTDELTA);
             cep->diag0[i] += xsq[j] * ivar;
 
-            mean = getFromPdf(pdf, vecstart, cepnum, PICOCEP_WANTMEAN,
+            mean = getFromPdf(pdf, pdfindex, cepnum, PICOCEP_WANTMEAN,
                     PICOCEP_WANTDELTA);
             if (mean != 0) {
                 cep->WUm[i] += x[j] * mean;
@@ -1081,12 +1211,12 @@ static picoos_uint8 makeWUWandWUm(cep_subobj_t * cep, picokpdf_PdfMUL pdf,
 
         /* process delta delta means and delta delta inverse variances */
         for (j = 0; j < numdd; j++) {
-            vecstart = indices[b + Idd[j]] * vecsize;
-            ivar = getFromPdf(pdf, vecstart, cepnum, PICOCEP_WANTIVAR,
+            pdfindex = indices[b + Idd[j]];
+            ivar = getFromPdf(pdf, pdfindex, cepnum, PICOCEP_WANTIVAR,
                     PICOCEP_WANTDELTA2);
             cep->diag0[i] += xsq[numd + j] * ivar;
 
-            mean = getFromPdf(pdf, vecstart, cepnum, PICOCEP_WANTMEAN,
+            mean = getFromPdf(pdf, pdfindex, cepnum, PICOCEP_WANTMEAN,
                     PICOCEP_WANTDELTA2);
             if (mean != 0) {
                 cep->WUm[i] += x[numd + j] * mean;
@@ -1102,12 +1232,12 @@ static picoos_uint8 makeWUWandWUm(cep_subobj_t * cep, picokpdf_PdfMUL pdf,
                 if (i > 0 && indices[b + i + 1] == indices[b + i]) {
                     cep->diag1[i] = prev_diag1;
                 } else {
-                    vecstart = indices[b + i + 1] * vecsize;
+                    pdfindex = indices[b + i + 1];
                     /*
                      diag1[i] = getFromPdf(pdf, vecstart, numvuv, ceporder, numdeltas, cepnum,
                      bigpow, meanpowUm, ivarpow, PICOCEP_WANTIVAR, PICOCEP_WANTDELTA2);
                      */
-                    prev_diag1 = cep->diag1[i] = getFromPdf(pdf, vecstart,
+                    prev_diag1 = cep->diag1[i] = getFromPdf(pdf, pdfindex,
                             cepnum, PICOCEP_WANTIVAR, PICOCEP_WANTDELTA2);
                 }
                 /*
@@ -1122,13 +1252,13 @@ static picoos_uint8 makeWUWandWUm(cep_subobj_t * cep, picokpdf_PdfMUL pdf,
                 if (i > 1 && indices[b + i] == indices[b + i - 1]) {
                     cep->diag1[i] += prev_diag1_1;
                 } else {
-                    vecstart = indices[b + i] * vecsize;
+                    pdfindex = indices[b + i];
                     /*
                      k = vecstart + pdf->numvuv + pdf->ceporder * 2 + pdf->numdeltas * 3 + pdf->ceporder * 2 + cepnum;
                      cep->diag1[i] += (picoos_int32)(pdf->content[k]) << pdf->bigpow; */
                     /* cepnum'th delta delta ivar */
 
-                    prev_diag1_1 = getFromPdf(pdf, vecstart, cepnum,
+                    prev_diag1_1 = getFromPdf(pdf, pdfindex, cepnum,
                             PICOCEP_WANTIVAR, PICOCEP_WANTDELTA2);
                     cep->diag1[i] += prev_diag1_1;
                 }
@@ -1143,16 +1273,16 @@ static picoos_uint8 makeWUWandWUm(cep_subobj_t * cep, picokpdf_PdfMUL pdf,
         if (i > 0 && indices[b + i + 1] == indices[b + i]) {
             cep->diag2[i] = prev_diag2;
         } else {
-            vecstart = indices[b + i + 1] * vecsize;
+            pdfindex = indices[b + i + 1];
             /*
              k = vecstart + pdf->numvuv + pdf->ceporder * 2 + pdf->numdeltas * 3 + pdf->ceporder * 2 + cepnum;
              cep->diag2[i] = (picoos_int32)(pdf->content[k]) << pdf->bigpow;
              k -= pdf->ceporder;
              ivar = (picoos_int32)(pdf->content[k]) << pdf->bigpow;
              */
-            cep->diag2[i] = getFromPdf(pdf, vecstart, cepnum, PICOCEP_WANTIVAR,
+            cep->diag2[i] = getFromPdf(pdf, pdfindex, cepnum, PICOCEP_WANTIVAR,
                     PICOCEP_WANTDELTA2);
-            ivar = getFromPdf(pdf, vecstart, cepnum, PICOCEP_WANTIVAR,
+            ivar = getFromPdf(pdf, pdfindex, cepnum, PICOCEP_WANTIVAR,
                     PICOCEP_WANTDELTA);
             cep->diag2[i] -= (ivar + 2) / 4;
             prev_diag2 = cep->diag2[i];
@@ -1162,20 +1292,610 @@ static picoos_uint8 makeWUWandWUm(cep_subobj_t * cep, picokpdf_PdfMUL pdf,
     return 0;
 }/* makeWUWandWUm */
 
+/* --------------------------------------------
+ *   lane solvers
+ * --------------------------------------------
+ */
+
+/* a * 2^pow, shifting the absolute value of negative a (as in invMatrix) */
+#define PICOCEP_SHL(a, pow) (((a) >= 0) ? ((a) << (pow)) : -(-(a) << (pow)))
+
+/**
+ * perform inversion of diagonal element of WUW matrix; same result as
+ * picocep_fixptInvDiagEle, with one 64 bit division instead of the bitwise
+ * long division
+ * @param    d : diagonal element to be inverted
+ * @param    rowscpow (int) : fixed point base for each dimension of the vectors stored in the database
+ * @param    bigpow (int) : fixed point base used during cepstral smoothing
+ * @param    invpow : fixed point base of inverted pivot elements
+ * @return   inverted pivot element
+ * @note
+ * - d is guaranteed positive
+ * - the long division computes the quotient bits down to bit 1 and
+ *   rounds with the remainder, i.e. it yields (2^(invpow+bigpow) + b/2) / b
+ * @callgraph
+ * @callergraph
+ */
+static picoos_int32 picocep_fixptInvDiagEle64(picoos_uint32 d,
+        picoos_uint8* rowscpow, picoos_uint8 bigpow, picoos_uint8 invpow)
+{
+    picoos_uint32 b;
+    picoos_uint8 dlen;
+
+    dlen = picocep_highestBitU(d);
+    if (invpow + bigpow > 30 + dlen) {
+        *rowscpow = invpow + bigpow - 30 - dlen;
+    } else {
+        *rowscpow = 0;
+    }
+    b = d << (*rowscpow);
+    return (picoos_int32) (((((uint64_t) 1) << (invpow + bigpow)) + (b >> 1))
+            / b);
+}
+
+/**
+ * like makeWUWandWUm for PICOCEP_LANES cepstral dimensions at once
+ * @param    cep : PU sub object pointer
+ * @param    pdf :  pdf resource
+ * @param    indices : indices of pdf vectors for all frames in current sentence
+ * @param    N :  number of frames to be smoothed
+ * @param    cepnum :  first cepstral dimension to be treated
+ * @param    nl :  number of cepstral dimensions to be treated (at most PICOCEP_LANES)
+ * @return  void
+ * @remarks fills laneDiag0, laneDiag1, laneDiag2, laneWUm; the lanes
+ *          from nl on are set to the identity
+ * @callgraph
+ * @callergraph
+ */
+static void makeWUWandWUmLanes(cep_subobj_t * cep, picokpdf_PdfMUL pdf,
+        picoos_uint16 *indices, picoos_uint16 N, picoos_uint8 cepnum,
+        picoos_uint8 nl)
+{
+    picoos_uint16 Id[2], Idd[3];
+    picoos_uint16 pdfindex;
+    picoos_int32 *x = NULL, *xsq = NULL;
+    picoos_int32 mean, ivar;
+    picoos_uint16 i, j, numd = 0, numdd = 0;
+    picoos_uint8 l;
+    picocep_lane_t *d0, *d1, *d2, *wum;
+    picoos_int32 prev_WUm[PICOCEP_LANES], prev_diag0[PICOCEP_LANES],
+            prev_diag1[PICOCEP_LANES], prev_diag1_1[PICOCEP_LANES],
+            prev_diag2[PICOCEP_LANES];
+
+    for (i = 0; i < N; i++) {
+
+        if ((1 < i) && (i < N - 2)) {
+            x = cep->xi;
+            xsq = cep->xsqi;
+            numd = 2;
+            numdd = 3;
+            Id[0] = Idd[0] = i - 1;
+            Id[1] = Idd[2] = i + 1;
+            Idd[1] = i;
+        } else if (i == 0) {
+            x = cep->x1;
+            xsq = cep->xsq1;
+            numd = numdd = 1;
+            Id[0] = Idd[0] = 1;
+        } else if (i == 1) {
+            x = cep->x2;
+            xsq = cep->xsq2;
+            numd = 1;
+            numdd = 2;
+            Id[0] = Idd[1] = 2;
+            Idd[0] = 1;
+        } else if (i == N - 2) {
+            x = cep->xm;
+            xsq = cep->xsqm;
+            numd = 1;
+            numdd = 2;
+            Id[0] = Idd[0] = N - 3;
+            Idd[1] = N - 2;
+        } else if (i == N - 1) {
+            x = cep->xn;
+            xsq = cep->xsqn;
+            numd = numdd = 1;
+            Id[0] = Idd[0] = N - 2;
+        }
+        d0 = cep->laneDiag0 + i * PICOCEP_LANES;
+        d1 = cep->laneDiag1 + i * PICOCEP_LANES;
+        wum = cep->laneWUm + i * PICOCEP_LANES;
+
+        /* process static means and static inverse variances */
+        if (i > 0 && indices[i] == indices[i - 1]) {
+            for (l = 0; l < nl; l++) {
+                d0[l].i = prev_diag0[l];
+                wum[l].i = prev_WUm[l];
+            }
+        } else {
+            pdfindex = indices[i];
+            for (l = 0; l < nl; l++) {
+                ivar = getFromPdf(pdf, pdfindex, cepnum + l, PICOCEP_WANTIVAR,
+                        PICOCEP_WANTSTATIC);
+                prev_diag0[l] = d0[l].i = ivar << 2;
+                mean = getFromPdf(pdf, pdfindex, cepnum + l, PICOCEP_WANTMEAN,
+                        PICOCEP_WANTSTATIC);
+                prev_WUm[l] = wum[l].i = PICOCEP_SHL(mean, 1);
+            }
+        }
+
+        /* process delta means and delta inverse variances */
+        for (j = 0; j < numd; j++) {
+            pdfindex = indices[Id[j]];
+            for (l = 0; l < nl; l++) {
+                ivar = getFromPdf(pdf, pdfindex, cepnum + l, PICOCEP_WANTIVAR,
+                        PICOCEP_WANTDELTA);
+                d0[l].i += xsq[j] * ivar;
+                mean = getFromPdf(pdf, pdfindex, cepnum + l, PICOCEP_WANTMEAN,
+                        PICOCEP_WANTDELTA);
+                wum[l].i += x[j] * mean;
+            }
+        }
+
+        /* process delta delta means and delta delta inverse variances */
+        for (j = 0; j < numdd; j++) {
+            pdfindex = indices[Idd[j]];
+            for (l = 0; l < nl; l++) {
+                ivar = getFromPdf(pdf, pdfindex, cepnum + l, PICOCEP_WANTIVAR,
+                        PICOCEP_WANTDELTA2);
+                d0[l].i += xsq[numd + j] * ivar;
+                mean = getFromPdf(pdf, pdfindex, cepnum + l, PICOCEP_WANTMEAN,
+                        PICOCEP_WANTDELTA2);
+                wum[l].i += x[numd + j] * mean;
+            }
+        }
+
+        for (l = 0; l < nl; l++) {
+            d0[l].i = (d0[l].i + 2) / 4; /* long DIV with rounding */
+            wum[l].i = (wum[l].i + 1) / 2; /* long DIV with rounding */
+        }
+
+        /* calculate diag(A,-1) */
+        if (i < N - 1) {
+            if (i < N - 2) {
+                if (i > 0 && indices[i + 1] == indices[i]) {
+                    for (l = 0; l < nl; l++) {
+                        d1[l].i = prev_diag1[l];
+                    }
+                } else {
+                    pdfindex = indices[i + 1];
+                    for (l = 0; l < nl; l++) {
+                        prev_diag1[l] = d1[l].i = getFromPdf(pdf, pdfindex,
+                                cepnum + l, PICOCEP_WANTIVAR, PICOCEP_WANTDELTA2);
+                    }
+                }
+            } else {
+                for (l = 0; l < nl; l++) {
+                    d1[l].i = 0;
+                }
+            }
+            if (i > 0) {
+                if (i > 1 && indices[i] == indices[i - 1]) {
+                    for (l = 0; l < nl; l++) {
+                        d1[l].i += prev_diag1_1[l];
+                    }
+                } else {
+                    pdfindex = indices[i];
+                    for (l = 0; l < nl; l++) {
+                        prev_diag1_1[l] = getFromPdf(pdf, pdfindex, cepnum + l,
+                                PICOCEP_WANTIVAR, PICOCEP_WANTDELTA2);
+                        d1[l].i += prev_diag1_1[l];
+                    }
+                }
+            }
+            for (l = 0; l < nl; l++) {
+                d1[l].i *= -2;
+            }
+        }
+    }
+
+    /* calculate diag(A,-2) */
+    for (i = 0; i < N - 2; i++) {
+        d2 = cep->laneDiag2 + i * PICOCEP_LANES;
+        if (i > 0 && indices[i + 1] == indices[i]) {
+            for (l = 0; l < nl; l++) {
+                d2[l].i = prev_diag2[l];
+            }
+        } else {
+            pdfindex = indices[i + 1];
+            for (l = 0; l < nl; l++) {
+                d2[l].i = getFromPdf(pdf, pdfindex, cepnum + l,
+                        PICOCEP_WANTIVAR, PICOCEP_WANTDELTA2);
+                ivar = getFromPdf(pdf, pdfindex, cepnum + l, PICOCEP_WANTIVAR,
+                        PICOCEP_WANTDELTA);
+                d2[l].i -= (ivar + 2) / 4;
+                prev_diag2[l] = d2[l].i;
+            }
+        }
+    }
+
+    /* unused lanes: identity with zero right hand side */
+    for (i = 0; i < N; i++) {
+        for (l = nl; l < PICOCEP_LANES; l++) {
+            cep->laneDiag0[i * PICOCEP_LANES + l].i = 1;
+            cep->laneDiag1[i * PICOCEP_LANES + l].i = 0;
+            cep->laneDiag2[i * PICOCEP_LANES + l].i = 0;
+            cep->laneWUm[i * PICOCEP_LANES + l].i = 0;
+        }
+    }
+}/* makeWUWandWUmLanes */
+
+/**
+ * like invMatrix for nl cepstral dimensions at once; each step is done
+ * for all lanes before the next one
+ * @param    cep : PU sub object pointer
+ * @param    N
+ * @param    smoothcep : pointer to picoos_int16, sequence of smoothed cepstral vectors
+ * @param    cepnum :  first cepstral dimension to be treated
+ * @param    nl :  number of cepstral dimensions to be treated (at most PICOCEP_LANES)
+ * @param    pdf :  pdf resource
+ * @param    invpow :  fixed point base for inverse
+ * @param    invDoubleDec : boolean indicating that result of picocep_fixptinv has fixed point base 2*bigpow
+ * @param    b : first frame to be solved; if b > 0, the elimination of rows b-2 and b-1 is taken from fwd
+ * @param    e : if e > 0, the elimination of rows e-2 and e-1 is saved to fwd
+ * @param    fwd : elimination state of the nl dimensions (only used if b > 0 or e > 0)
+ * @return  void
+ * @callgraph
+ * @callergraph
+ */
+static void invMatrixLanesFixed(cep_subobj_t * cep, picoos_uint16 N,
+        picoos_int16 *smoothcep, picoos_uint8 cepnum, picoos_uint8 nl,
+        picokpdf_PdfMUL pdf, picoos_uint8 invpow, picoos_uint8 invDoubleDec,
+        picoos_uint16 b, picoos_uint16 e, picocep_fwdstate_t * fwd)
+{
+    picoos_int32 j, j0, v1, v2, h;
+    picoos_uint32 k, p, p1, p2;
+    picoos_uint8 l;
+    picoos_uint8 rowscpow[PICOCEP_LANES], prevrowscpow[PICOCEP_LANES];
+    picoos_uint8 ceporder = pdf->ceporder;
+    picoos_uint8 bigpow = pdf->bigpow;
+    picoos_uint8 meanpow = pdf->meanpow;
+    picocep_lane_t *d0 = cep->laneDiag0, *d1 = cep->laneDiag1,
+            *d2 = cep->laneDiag2, *wum = cep->laneWUm, *inv = cep->laneInv;
+
+    /* LDL factorization */
+    for (l = 0; l < nl; l++) {
+        prevrowscpow[l] = 0;
+    }
+    if (b > 0) {
+        /* continue the elimination of the previous window */
+        for (j = 0; j < 2; j++) {
+            p = (b - 2 + j) * PICOCEP_LANES;
+            for (l = 0; l < nl; l++) {
+                d0[p + l].i = fwd[l].diag0[j];
+                d1[p + l].i = fwd[l].diag1[j];
+                d2[p + l].i = fwd[l].diag2[j];
+                wum[p + l].i = fwd[l].WUm[j];
+            }
+        }
+        for (l = 0; l < nl; l++) {
+            prevrowscpow[l] = fwd[l].rowscpow[0];
+            rowscpow[l] = fwd[l].rowscpow[1];
+        }
+        j0 = b;
+    } else {
+        for (l = 0; l < nl; l++) {
+            inv[l].i = picocep_fixptInvDiagEle64(d0[l].i, &rowscpow[l],
+                    bigpow, invpow);
+            d1[l].i = picocep_fixptinv(PICOCEP_SHL(d1[l].i, rowscpow[l]),
+                    inv[l].i, bigpow, invpow, invDoubleDec);
+            d2[l].i = picocep_fixptinv(PICOCEP_SHL(d2[l].i, rowscpow[l]),
+                    inv[l].i, bigpow, invpow, invDoubleDec);
+            wum[l].i = PICOCEP_SHL(wum[l].i, rowscpow[l]);
+        }
+        j0 = 1;
+    }
+    for (j = j0; j < N; j++) {
+        p = j * PICOCEP_LANES;
+        p1 = p - PICOCEP_LANES;
+        p2 = p1 - PICOCEP_LANES; /* only used if j > 1 */
+        for (l = 0; l < nl; l++) {
+            /* do forward substitution */
+            wum[p + l].i -= picocep_fixptmult(d1[p1 + l].i, wum[p1 + l].i,
+                    bigpow, invDoubleDec);
+            if (j > 1) {
+                wum[p + l].i -= picocep_fixptmult(d2[p2 + l].i, wum[p2 + l].i,
+                        bigpow, invDoubleDec);
+            }
+
+            /* update row j */
+            v1 = picocep_fixptmult(d1[p1 + l].i / (1 << rowscpow[l]),
+                    d0[p1 + l].i, bigpow, invDoubleDec);
+            d0[p + l].i -= picocep_fixptmult(d1[p1 + l].i, v1, bigpow,
+                    invDoubleDec);
+            if (j > 1) {
+                v2 = picocep_fixptmult(d2[p2 + l].i / (1 << prevrowscpow[l]),
+                        d0[p2 + l].i, bigpow, invDoubleDec);
+                d0[p + l].i -= picocep_fixptmult(d2[p2 + l].i, v2, bigpow,
+                        invDoubleDec);
+            }
+            prevrowscpow[l] = rowscpow[l];
+            inv[p + l].i = picocep_fixptInvDiagEle64(d0[p + l].i,
+                    &rowscpow[l], bigpow, invpow);
+            wum[p + l].i = PICOCEP_SHL(wum[p + l].i, rowscpow[l]);
+            if (j < N - 1) {
+                h = d1[p + l].i - picocep_fixptmult(d2[p1 + l].i, v1, bigpow,
+                        invDoubleDec);
+                d1[p + l].i = picocep_fixptinv(PICOCEP_SHL(h, rowscpow[l]),
+                        inv[p + l].i, bigpow, invpow, invDoubleDec);
+            }
+            if (j < N - 2) {
+                d2[p + l].i = picocep_fixptinv(
+                        PICOCEP_SHL(d2[p + l].i, rowscpow[l]), inv[p + l].i,
+                        bigpow, invpow, invDoubleDec);
+            }
+        }
+        if ((e > 0) && (j + 2 >= e) && (j < e)) {
+            /* save the elimination for the next window */
+            h = j + 2 - e;
+            for (l = 0; l < nl; l++) {
+                fwd[l].diag0[h] = d0[p + l].i;
+                fwd[l].diag1[h] = d1[p + l].i;
+                fwd[l].diag2[h] = d2[p + l].i;
+                fwd[l].WUm[h] = wum[p + l].i;
+                fwd[l].rowscpow[h] = rowscpow[l];
+            }
+        }
+    }
+
+    /* divide all entries of WUm by diag0 */
+    for (j = b; j < N; j++) {
+        p = j * PICOCEP_LANES;
+        for (l = 0; l < nl; l++) {
+            wum[p + l].i = picocep_fixptinv(wum[p + l].i, inv[p + l].i,
+                    bigpow, invpow, invDoubleDec);
+            if (invDoubleDec == 1) {
+                wum[p + l].i = picocep_fixptdivpow(wum[p + l].i, bigpow);
+            }
+        }
+    }
+
+    /* backward substitution */
+    for (j = N - 2; j >= b; j--) {
+        p = j * PICOCEP_LANES;
+        for (l = 0; l < nl; l++) {
+            wum[p + l].i -= picocep_fixptmult(d1[p + l].i,
+                    wum[p + PICOCEP_LANES + l].i, bigpow, invDoubleDec);
+            if (j < N - 2) {
+                wum[p + l].i -= picocep_fixptmult(d2[p + l].i,
+                        wum[p + 2 * PICOCEP_LANES + l].i, bigpow, invDoubleDec);
+            }
+        }
+    }
+
+    /* copy N frames into smoothcep (coeffs cepnum to cepnum+nl-1) */
+    for (j = b; j < N; j++) {
+        p = j * PICOCEP_LANES;
+        k = j * ceporder + cepnum;
+        for (l = 0; l < nl; l++) {
+            smoothcep[k + l] = (picoos_int16) (wum[p + l].i / (1 << meanpow));
+        }
+    }
+}/* invMatrixLanesFixed */
+
+/**
+ * solve the banded systems set up by makeWUWandWUmLanes in floating point
+ * by L D L' factorization, all PICOCEP_LANES lanes in each step
+ * @param    cep : PU sub object pointer
+ * @param    N
+ * @param    smoothcep : pointer to picoos_int16, sequence of smoothed cepstral vectors
+ * @param    cepnum :  first cepstral dimension to be treated
+ * @param    nl :  number of cepstral dimensions to be output (at most PICOCEP_LANES)
+ * @param    pdf :  pdf resource
+ * @param    b : first frame to be solved; if b > 0, the factorization of rows b-2 and b-1 is taken from fwd
+ * @param    e : if e > 0, the factorization of rows e-2 and e-1 is saved to fwd
+ * @param    fwd : factorization state of the nl dimensions (only used if b > 0 or e > 0)
+ * @return  void
+ * @remarks the rows are converted in place: laneDiag0 -> D, laneDiag1 -> L1
+ *          (below the diagonal), laneDiag2 -> L2, laneWUm -> solution,
+ *          laneInv -> 1/D
+ * @callgraph
+ * @callergraph
+ */
+static void invMatrixLanesFloat(cep_subobj_t * cep, picoos_uint16 N,
+        picoos_int16 *smoothcep, picoos_uint8 cepnum, picoos_uint8 nl,
+        picokpdf_PdfMUL pdf, picoos_uint16 b, picoos_uint16 e,
+        picocep_fwdstatef_t * fwd)
+{
+    picoos_int32 j, j0;
+    picoos_uint32 k, p, h;
+    picoos_uint8 l;
+    picoos_uint8 ceporder = pdf->ceporder;
+    picoos_single scale, v;
+    picocep_lane_t *D = cep->laneDiag0, *L1 = cep->laneDiag1,
+            *L2 = cep->laneDiag2, *y = cep->laneWUm, *invD = cep->laneInv;
+    picocep_lane_t *D1, *D2, *L11, *L21, *L22, *y1, *y2;
+    picocep_lane_t zero[PICOCEP_LANES];
+
+    for (l = 0; l < PICOCEP_LANES; l++) {
+        zero[l].f = 0;
+    }
+    j0 = 0;
+    if (b > 0) {
+        /* continue the factorization of the previous window */
+        for (j = 0; j < 2; j++) {
+            p = (b - 2 + j) * PICOCEP_LANES;
+            for (l = 0; l < PICOCEP_LANES; l++) {
+                if (l < nl) {
+                    D[p + l].f = fwd[l].D[j];
+                    L1[p + l].f = fwd[l].L1[j];
+                    L2[p + l].f = fwd[l].L2[j];
+                    y[p + l].f = fwd[l].y[j];
+                } else {
+                    D[p + l].f = 1;
+                    L1[p + l].f = L2[p + l].f = y[p + l].f = 0;
+                }
+            }
+        }
+        j0 = b;
+    }
+
+    /* factorization and forward substitution; rows before 0 are zero */
+    for (j = j0; j < N; j++) {
+        p = j * PICOCEP_LANES;
+        if (j > 0) {
+            D1 = D + p - PICOCEP_LANES;
+            L11 = L1 + p - PICOCEP_LANES;
+            L21 = L2 + p - PICOCEP_LANES;
+            y1 = y + p - PICOCEP_LANES;
+        } else {
+            D1 = L11 = L21 = y1 = zero;
+        }
+        if (j > 1) {
+            D2 = D + p - 2 * PICOCEP_LANES;
+            L22 = L2 + p - 2 * PICOCEP_LANES;
+            y2 = y + p - 2 * PICOCEP_LANES;
+        } else {
+            D2 = L22 = y2 = zero;
+        }
+        for (l = 0; l < PICOCEP_LANES; l++) {
+            v = (picoos_single) D[p + l].i - L11[l].f * L11[l].f * D1[l].f
+                    - L22[l].f * L22[l].f * D2[l].f;
+            D[p + l].f = v;
+            invD[p + l].f = 1.0f / v;
+            y[p + l].f = (picoos_single) y[p + l].i - L11[l].f * y1[l].f
+                    - L22[l].f * y2[l].f;
+        }
+        if (j < N - 1) {
+            for (l = 0; l < PICOCEP_LANES; l++) {
+                L1[p + l].f = ((picoos_single) L1[p + l].i
+                        - L21[l].f * L11[l].f * D1[l].f) * invD[p + l].f;
+            }
+        }
+        if (j < N - 2) {
+            for (l = 0; l < PICOCEP_LANES; l++) {
+                L2[p + l].f = (picoos_single) L2[p + l].i * invD[p + l].f;
+            }
+        }
+        if ((e > 0) && (j + 2 >= e) && (j < e)) {
+            /* save the factorization for the next window */
+            h = j + 2 - e;
+            for (l = 0; l < nl; l++) {
+                fwd[l].D[h] = D[p + l].f;
+                fwd[l].L1[h] = L1[p + l].f;
+                fwd[l].L2[h] = L2[p + l].f;
+                fwd[l].y[h] = y[p + l].f;
+            }
+        }
+    }
+
+    /* divide by D and backward substitution */
+    for (j = N - 1; j >= b; j--) {
+        p = j * PICOCEP_LANES;
+        if (j == N - 1) {
+            for (l = 0; l < PICOCEP_LANES; l++) {
+                y[p + l].f = y[p + l].f * invD[p + l].f;
+            }
+        } else if (j == N - 2) {
+            for (l = 0; l < PICOCEP_LANES; l++) {
+                y[p + l].f = y[p + l].f * invD[p + l].f
+                        - L1[p + l].f * y[p + PICOCEP_LANES + l].f;
+            }
+        } else {
+            for (l = 0; l < PICOCEP_LANES; l++) {
+                y[p + l].f = y[p + l].f * invD[p + l].f
+                        - L1[p + l].f * y[p + PICOCEP_LANES + l].f
+                        - L2[p + l].f * y[p + 2 * PICOCEP_LANES + l].f;
+            }
+        }
+    }
+
+    /* copy N frames into smoothcep (coeffs cepnum to cepnum+nl-1), scaled
+       like the fixed point solution */
+    scale = (picoos_single) cep->scmeanMGC;
+    for (j = b; j < N; j++) {
+        p = j * PICOCEP_LANES;
+        k = j * ceporder + cepnum;
+        for (l = 0; l < nl; l++) {
+            v = y[p + l].f * scale;
+            if (v > 32767.0f) {
+                v = 32767.0f;
+            } else if (v < -32768.0f) {
+                v = -32768.0f;
+            }
+            smoothcep[k + l] = (picoos_int16) v;
+        }
+    }
+}/* invMatrixLanesFloat */
+
+/**
+ * smooth all MGC dimensions with the lane solver
+ * @param    cep : PU sub object pointer
+ * @param    pdf :  pdf resource (MGC)
+ * @param    N, b, e : as for invMatrix
+ * @return  void
+ * @callgraph
+ * @callergraph
+ */
+static void smoothLanes(cep_subobj_t * cep, picokpdf_PdfMUL pdf,
+        picoos_uint16 N, picoos_uint16 b, picoos_uint16 e)
+{
+    picoos_uint8 cepnum, nl;
+    picocep_fwdstate_t * fwd = NULL;
+    picocep_fwdstatef_t * fwdf = NULL;
+
+    for (cepnum = 0; cepnum < pdf->ceporder; cepnum += PICOCEP_LANES) {
+        nl = pdf->ceporder - cepnum;
+        if (nl > PICOCEP_LANES) {
+            nl = PICOCEP_LANES;
+        }
+#if defined(PICO_USE_CEP_WINDOW)
+        fwd = &cep->fwdMGC[cepnum];
+        fwdf = &cep->fwdMGCf[cepnum];
+#endif
+        makeWUWandWUmLanes(cep, pdf, cep->indicesMGC, N, cepnum, nl);
+        if (PICOCEP_SOLVER_LANES_FLOAT == cep->solver) {
+            invMatrixLanesFloat(cep, N, cep->outXCep + cep->outXCepWritePos,
+                    cepnum, nl, pdf, b, e, fwdf);
+        } else {
+            invMatrixLanesFixed(cep, N, cep->outXCep + cep->outXCepWritePos,
+                    cepnum, nl, pdf, PICOCEP_MGCINVPOW, PICOCEP_MGCDOUBLEDEC,
+                    b, e, fwd);
+        }
+    }
+}/* smoothLanes */
+
 /**
  * Retrieve actual values for MGC from PDF resource
- * @param    pdf :  pointer to picoos_uint8, sequence of pdf vectors, each vector of length 1+ceporder*2+numdeltas*3+ceporder*3
- * @param    vecstart : indices of pdf vectors for all frames in current sentence
+ * @param    pdf :  pdf resource
+ * @param    pdfindex : index of the pdf vector
  * @param    cepnum :  cepstral dimension to be treated
  * @param    wantMeanOrIvar :  flag to select mean or variance values
  * @param    wantStaticOrDeltax :  flag to select static or delta values
  * @return  the actual value retrieved
+ * @remarks taken from the expanded table if the pdf has been expanded
+ *          (see picokpdf_expandPdfMUL), else decoded from the quantized
+ *          vector
  * @callgraph
  * @callergraph
  */
-static picoos_int32 getFromPdf(picokpdf_PdfMUL pdf, picoos_uint32 vecstart,
+static picoos_int32 getFromPdf(picokpdf_PdfMUL pdf, picoos_uint16 pdfindex,
         picoos_uint8 cepnum, picocep_WantMeanOrIvar_t wantMeanOrIvar,
         picocep_WantStaticOrDelta_t wantStaticOrDeltax)
+{
+    if (NULL != pdf->expanded) {
+        return pdf->expanded[PICOKPDF_MUL_EXPANDED_POS(pdf, pdfindex,
+                wantMeanOrIvar * 3 + wantStaticOrDeltax, cepnum)];
+    }
+    return getFromPdfPacked(pdf, (picoos_uint32) pdfindex * pdf->vecsize,
+            cepnum, wantMeanOrIvar, wantStaticOrDeltax);
+}
+
+/**
+ * Decode actual values for MGC from the quantized PDF vector
+ * @param    pdf :  pointer to picoos_uint8, sequence of pdf vectors, each vector of length 1+ceporder*2+numdeltas*3+ceporder*3
+ * @param    vecstart : start of the pdf vector within pdf->content
+ * @param    cepnum :  cepstral dimension to be treated
+ * @param    wantMeanOrIvar :  flag to select mean or variance values
+ * @param    wantStaticOrDeltax :  flag to select static or delta values
+ * @return  the actual value retrieved
+ * @callgraph
+ * @callergraph
+ */
+static picoos_int32 getFromPdfPacked(picokpdf_PdfMUL pdf,
+        picoos_uint32 vecstart, picoos_uint8 cepnum,
+        picocep_WantMeanOrIvar_t wantMeanOrIvar,
+        picocep_WantStaticOrDelta_t wantStaticOrDeltax)
 {
     picoos_uint8 s, ind;
     picoos_uint8 *p;
@@ -1312,7 +2032,7 @@ static picoos_int32 getFromPdf(picokpdf_PdfMUL pdf, picoos_uint32 vecstart,
                 return 0;
                         break;
                     default:
-                PICODBG_ERROR(("getFromPdf: unknown type wantStaticOrDeltax = %i\n", wantStaticOrDeltax));
+                PICODBG_ERROR(("getFromPdfPacked: unknown type wantStaticOrDeltax = %i\n", wantStaticOrDeltax));
                         return 0;
             }
                 break;
@@ -1368,10 +2088,9 @@ static void getDirect(picokpdf_PdfMUL pdf, picoos_uint16 *indices,
 {
     picoos_uint16 i;
     picoos_uint32 j;
-    picoos_uint32 vecstart;
+    picoos_uint16 pdfindex;
     picoos_int32 mean, ivar;
     picoos_int32 prev_mean;
-    picoos_uint8 vecsize = pdf->vecsize;
     picoos_uint8 order = pdf->ceporder;
 
     j = cepnum;
@@ -1380,10 +2099,10 @@ static void getDirect(picokpdf_PdfMUL pdf, picoos_uint16 *indices,
         if (i > 0 && indices[i] == indices[i - 1]) {
             mean = prev_mean;
         } else {
-            vecstart = indices[i] * vecsize;
-            mean = getFromPdf(pdf, vecstart, cepnum, PICOCEP_WANTMEAN,
+            pdfindex = indices[i];
+            mean = getFromPdf(pdf, pdfindex, cepnum, PICOCEP_WANTMEAN,
                     PICOCEP_WANTSTATIC);
-            ivar = getFromPdf(pdf, vecstart, cepnum, PICOCEP_WANTIVAR,
+            ivar = getFromPdf(pdf, pdfindex, cepnum, PICOCEP_WANTIVAR,
                     PICOCEP_WANTSTATIC);
             prev_mean = mean = picocep_fixptdiv(mean, ivar, pdf->bigpow);
         }
@@ -1453,6 +2172,11 @@ static void treat_phone(cep_subobj_t * cep, picodata_itemhead_t * ihead)
     /* set state and frame to the first state and frame in the phone to be considered */
     state = 0; /* the first state to be considered */
     frame = 0; /* the first frame to be considered */
+#if defined(PICO_USE_CEP_WINDOW)
+    /* resume a phone that did not fit into the previous window */
+    state = cep->phoneState;
+    frame = cep->phoneFrame;
+#endif
     /* numFramesPerState: 2 byte, lf0Index: 2 byte, mgcIndex: 2 byte -> 6 bytes per state */
     PICODBG_DEBUG(("skipping to phone state %i ",state));
     pos = cep->inReadPos + PICODATA_ITEM_HEADSIZE + state * 6;
@@ -1479,6 +2203,10 @@ static void treat_phone(cep_subobj_t * cep, picodata_itemhead_t * ihead)
 
         /* are we reaching the end of the index buffers? */
         if ((cep->indexWritePos - frame) + frames > PICOCEP_MAXWINLEN) {
+#if defined(PICO_USE_CEP_WINDOW)
+            cep->phoneState = state;
+            cep->phoneFrame = PICOCEP_MAXWINLEN - (cep->indexWritePos - frame);
+#endif
             /* number of frames that will still fit */
             frames = PICOCEP_MAXWINLEN - (cep->indexWritePos - frame);
             bufferFull = TRUE;
@@ -1500,6 +2228,15 @@ static void treat_phone(cep_subobj_t * cep, picodata_itemhead_t * ihead)
             frames = get_pi_uint16(cep->inBuf, &pos);
         }
     }
+#if defined(PICO_USE_CEP_WINDOW)
+    if (bufferFull) {
+        /* keep the phone item, the remaining frames go into the next window */
+        PICODBG_DEBUG(("window full, phone continues at state %i frame %i",
+                        cep->phoneState, cep->phoneFrame));
+        return;
+    }
+    cep->phoneState = cep->phoneFrame = 0;
+#endif
     /* consume the phone item */
     cep->inReadPos = cep->nextInPos;
     /* */
@@ -1524,6 +2261,108 @@ static picoos_uint8 forwardingItem(picodata_itemhead_t * ihead)
     }
 }
 
+#if defined(PICO_USE_CEP_WINDOW)
+/**
+ * cross-fades the first frames of the current step with the previous
+ * window's solution of the same frames (overlap-merge)
+ * @param    cep : the CEP PU sub-object handle
+ * @callgraph
+ * @callergraph
+ */
+static void mergeWindow(cep_subobj_t * cep)
+{
+    picoos_uint16 i, j;
+    picoos_uint32 k;
+    picoos_int32 wnew, wold, wsum;
+    picoos_uint8 lfzorder = cep->pdflfz->ceporder;
+    picoos_uint8 mgcorder = cep->pdfmgc->ceporder;
+
+    wsum = cep->mergeLen + 1;
+    for (i = 0; i < cep->mergeLen; i++) {
+        /* weight of the new solution rises linearly over the merge range */
+        wnew = i + 1;
+        wold = wsum - wnew;
+        k = (cep->emitStartPos + i) * lfzorder;
+        for (j = 0; j < lfzorder; j++, k++) {
+            cep->outF0[k] = (picoos_int16) ((wold * cep->mergeF0[i * lfzorder
+                    + j] + wnew * cep->outF0[k]) / wsum);
+        }
+        k = (cep->emitStartPos + i) * mgcorder;
+        for (j = 0; j < mgcorder; j++, k++) {
+            cep->outXCep[k] = (picoos_int16) ((wold * cep->mergeXCep[i
+                    * mgcorder + j] + wnew * cep->outXCep[k]) / wsum);
+        }
+    }
+    cep->mergeLen = 0;
+}
+
+/**
+ * prepares the window for the next step after frames
+ * [emitStartPos,activeEndPos[ have been output: keeps the current
+ * solution of the following frames for merging, drops all but
+ * PICOCEP_WIN_HIST frames of left context and moves the remaining
+ * indices and pending items to the beginning of the buffers
+ * @param    cep : the CEP PU sub-object handle
+ * @callgraph
+ * @callergraph
+ */
+static void shiftWindow(cep_subobj_t * cep)
+{
+    picoos_uint16 shift, i, cfirst;
+    picoos_uint8 lfzorder = cep->pdflfz->ceporder;
+    picoos_uint8 mgcorder = cep->pdfmgc->ceporder;
+
+    /* solution of the lookahead frames to be merged with the next window */
+    cep->mergeLen = cep->indexWritePos - cep->activeEndPos;
+    if (cep->mergeLen > PICOCEP_WIN_OVERLAP) {
+        cep->mergeLen = PICOCEP_WIN_OVERLAP;
+    }
+    picoos_mem_copy(cep->outF0 + cep->activeEndPos * lfzorder, cep->mergeF0,
+            cep->mergeLen * lfzorder * sizeof(picoos_int16));
+    picoos_mem_copy(cep->outXCep + cep->activeEndPos * mgcorder,
+            cep->mergeXCep, cep->mergeLen * mgcorder * sizeof(picoos_int16));
+
+    cep->emitStartPos = cep->activeEndPos;
+    if (cep->emitStartPos > PICOCEP_WIN_HIST) {
+        shift = cep->emitStartPos - PICOCEP_WIN_HIST;
+        picoos_mem_copy(cep->indicesLFZ + shift, cep->indicesLFZ,
+                (cep->indexWritePos - shift) * sizeof(picoos_uint16));
+        picoos_mem_copy(cep->indicesMGC + shift, cep->indicesMGC,
+                (cep->indexWritePos - shift) * sizeof(picoos_uint16));
+        picoos_mem_copy(cep->phoneId + shift, cep->phoneId,
+                (cep->indexWritePos - shift) * sizeof(picoos_uint8));
+        cep->indexWritePos -= shift;
+        cep->emitStartPos -= shift;
+        for (i = cep->headxBottom; i < cep->headxWritePos; i++) {
+            cep->headx[i].frame -= shift;
+        }
+    }
+    cep->indexReadPos = cep->emitStartPos;
+    cep->activeEndPos = PICOCEP_MAXWINLEN;
+
+    /* move pending items (and their contents) to the beginning */
+    if (cep->headxBottom > 0) {
+        cfirst = cep->cbufWritePos;
+        for (i = cep->headxBottom; i < cep->headxWritePos; i++) {
+            if ((cep->headx[i].head.len > 0) && (cep->headx[i].cind < cfirst)) {
+                cfirst = cep->headx[i].cind;
+            }
+        }
+        for (i = cep->headxBottom; i < cep->headxWritePos; i++) {
+            if (cep->headx[i].head.len > 0) {
+                cep->headx[i].cind -= cfirst;
+            }
+            cep->headx[i - cep->headxBottom] = cep->headx[i];
+        }
+        picoos_mem_copy(cep->cbuf + cfirst, cep->cbuf,
+                cep->cbufWritePos - cfirst);
+        cep->cbufWritePos -= cfirst;
+        cep->headxWritePos -= cep->headxBottom;
+        cep->headxBottom = 0;
+    }
+}
+#endif
+
 /**
  * performs a step of the cep processing
  * @param    this : pointer to current PU (Control Unit)
@@ -1597,6 +2436,16 @@ static picodata_step_result_t cepStep(register picodata_ProcessingUnit this,
 
                 PICODBG_TRACE(("PARSE"));
 
+#if defined(PICO_USE_CEP_WINDOW)
+                if (cep->indexWritePos >= cep->emitStartPos
+                        + PICOCEP_WIN_STEP + PICOCEP_WIN_LOOKAHEAD) {
+                    /* enough right context to output the next step */
+                    cep->activeEndPos = cep->emitStartPos + PICOCEP_WIN_STEP;
+                    PICODBG_DEBUG(("cep: PARSE window complete; setting activeEndPos to %i",cep->activeEndPos));
+                    cep->procState = PICOCEP_STEPSTATE_PROCESS_SMOOTH;
+                    break;
+                }
+#endif
                 PICODBG_DEBUG(("getting info from inBuf in range: [%i,%i[", cep->inReadPos, cep->inWritePos));
                 if (cep->inWritePos <= cep->inReadPos) {
                     /* no more items in inBuf */
@@ -1684,7 +2533,7 @@ static picodata_step_result_t cepStep(register picodata_ProcessingUnit this,
                     /* do we have to forward? */
                     if (forwardingItem(&ihead)) {
                         /* if no active frames, output immediately */
-                        if (cep->indexWritePos <= 0) {
+                        if (cep->indexWritePos <= cep->emitStartPos) {
                             /* copy item to outBuf */
                             PICODBG_DEBUG(("PARSE copy item in inBuf to outBuf"));
                             picodata_copy_item(cep->inBuf + cep->inReadPos,
@@ -1732,6 +2581,9 @@ static picodata_step_result_t cepStep(register picodata_ProcessingUnit this,
                             cep->headxWritePos++;
                         } else {
                             /* buffer full, smooth and output whatever we got */
+#if defined(PICO_USE_CEP_WINDOW)
+                            cep->activeEndPos = cep->indexWritePos;
+#endif
                             PICODBG_DEBUG(("PARSE is forced to smooth prematurely; setting activeEndPos to %i", cep->activeEndPos));
                             cep->procState = PICOCEP_STEPSTATE_PROCESS_SMOOTH;
                             /* don't consume item yet */
@@ -1752,11 +2604,28 @@ static picodata_step_result_t cepStep(register picodata_ProcessingUnit this,
 
                     /* picoos_uint16 framesTreated = 0; */
                     picoos_uint8 cepnum;
-                    picoos_uint16 N;
-
+                    picoos_uint16 N, b, e;
+                    picocep_fwdstate_t * fwd = NULL;
+
+#if defined(PICO_USE_CEP_WINDOW)
+                    /* the whole window is smoothed, frames [emitStartPos,activeEndPos[ are output */
+                    N = cep->indexWritePos;
+                    /* continue the elimination of the previous window */
+                    b = cep->fwdValid ? cep->emitStartPos : 0;
+                    /* keep the elimination at the end of the step for the next window
+                     * unless these rows are affected by the end of the window */
+                    e = 0;
+                    if (!cep->sentenceEnd && (cep->activeEndPos >= b + 2)
+                            && (cep->activeEndPos >= 3) && (cep->activeEndPos + 1 < N)) {
+                        e = cep->activeEndPos;
+                    }
+                    cep->fwdValid = (e > 0);
+#else
                     N = cep->activeEndPos; /* numframes in current step */
+                    b = e = 0;
+#endif
 
-                    /* the range to be smoothed starts at 0 and is N long */
+                    /* the range to be smoothed starts at b and ends at N */
 
                     /* smooth each cepstral dimension separately */
                     /* still to be experimented if higher order coeff can remain unsmoothed, i.e. simple copy from pdf */
@@ -1771,47 +2640,63 @@ static picodata_step_result_t cepStep(register picodata_ProcessingUnit this,
                     /* smooth f0 */
                     pdf = cep->pdflfz;
                     for (cepnum = 0; cepnum < pdf->ceporder; cepnum++) {
-                        if (cep->activeEndPos <= 0) {
+                        if (N <= b) {
                             /* do nothing */
-                        } else if (3 < N) {
+                        } else if ((3 < N) || (b > 0)) {
+#if defined(PICO_USE_CEP_WINDOW)
+                            fwd = &cep->fwdLFZ[cepnum];
+#endif
                             makeWUWandWUm(cep, pdf, cep->indicesLFZ, 0, N,
                                     cepnum); /* update diag0, diag1, diag2, WUm */
                             invMatrix(cep, N, cep->outF0 + cep->outF0WritePos, cepnum, pdf,
-                                    PICOCEP_LFZINVPOW, PICOCEP_LFZDOUBLEDEC);
+                                    PICOCEP_LFZINVPOW, PICOCEP_LFZDOUBLEDEC, b, e, fwd);
                         } else {
-                            getDirect(pdf, cep->indicesLFZ, cep->activeEndPos,
+                            getDirect(pdf, cep->indicesLFZ, N,
                                     cepnum, cep->outF0 + cep->outF0WritePos);
                         }
                     }/* end for cepnum  */
-                    cep->outF0WritePos += cep->activeEndPos * pdf->ceporder;
+                    cep->outF0WritePos += N * pdf->ceporder;
+                    cep->outF0ReadPos = cep->emitStartPos * pdf->ceporder;
 
                     /* smooth mgc */
                     pdf = cep->pdfmgc;
-                    for (cepnum = 0; cepnum < pdf->ceporder; cepnum++) {
-                        if (cep->activeEndPos <= 0) {
-                            /* do nothing */
-                        } else if (3 < N) {
-                            makeWUWandWUm(cep, pdf, cep->indicesMGC, 0, N,
-                                    cepnum); /* update diag0, diag1, diag2, WUm */
-                            invMatrix(cep, N, cep->outXCep
-                                            + cep->outXCepWritePos, cepnum,
-                                    pdf, PICOCEP_MGCINVPOW,
-                                    PICOCEP_MGCDOUBLEDEC);
-                        } else {
-                            getDirect(pdf, cep->indicesMGC, cep->activeEndPos,
-                                    cepnum, cep->outXCep + cep->outXCepWritePos);
-                        }
-                    }/* end for cepnum  */
-                    cep->outXCepWritePos += cep->activeEndPos * pdf->ceporder;
+                    if ((NULL != cep->lanes) && (N > b) && ((3 < N) || (b > 0))) {
+                        smoothLanes(cep, pdf, N, b, e);
+                    } else {
+                        for (cepnum = 0; cepnum < pdf->ceporder; cepnum++) {
+                            if (N <= b) {
+                                /* do nothing */
+                            } else if ((3 < N) || (b > 0)) {
+#if defined(PICO_USE_CEP_WINDOW)
+                                fwd = &cep->fwdMGC[cepnum];
+#endif
+                                makeWUWandWUm(cep, pdf, cep->indicesMGC, 0, N,
+                                        cepnum); /* update diag0, diag1, diag2, WUm */
+                                invMatrix(cep, N, cep->outXCep
+                                                + cep->outXCepWritePos, cepnum,
+                                        pdf, PICOCEP_MGCINVPOW,
+                                        PICOCEP_MGCDOUBLEDEC, b, e, fwd);
+                            } else {
+                                getDirect(pdf, cep->indicesMGC, N,
+                                        cepnum, cep->outXCep + cep->outXCepWritePos);
+                            }
+                        }/* end for cepnum  */
+                    }
+                    cep->outXCepWritePos += N * pdf->ceporder;
+                    cep->outXCepReadPos = cep->emitStartPos * pdf->ceporder;
 
-                    getVoiced(pdf, cep->indicesMGC, cep->activeEndPos, cep->outVoiced
+                    getVoiced(pdf, cep->indicesMGC, N, cep->outVoiced
                                     + cep->outVoicedWritePos);
-                    cep->outVoicedWritePos += cep->activeEndPos;
+                    cep->outVoicedWritePos += N;
+                    cep->outVoicedReadPos = cep->emitStartPos;
 
+#if defined(PICO_USE_CEP_WINDOW)
+                    mergeWindow(cep);
+#endif
                 }
                 /* setting indexReadPos to the next active index to be used. (will be advanced by FRAME when
                  * reading the phoneId */
-                cep->indexReadPos = 0;
+                cep->indexReadPos = cep->emitStartPos;
                 cep->procState = PICOCEP_STEPSTATE_PROCESS_FRAME;
                 return PICODATA_PU_BUSY; /*data to feed*/
 
@@ -1958,13 +2843,23 @@ static picodata_step_result_t cepStep(register picodata_ProcessingUnit this,
                     initSmoothing(cep);
                     cep->sentenceEnd = FALSE;
                     cep->indexReadPos = cep->indexWritePos = 0;
+                    cep->emitStartPos = 0;
+#if defined(PICO_USE_CEP_WINDOW)
+                    cep->fwdValid = FALSE;
+                    cep->mergeLen = 0;
+#endif
                     cep->activeEndPos = PICOCEP_MAXWINLEN;
                     cep->headxBottom = cep->headxWritePos = 0;
                     cep->cbufWritePos = 0;
                     cep->procState = PICOCEP_STEPSTATE_PROCESS_PARSE;
                 } else {
                     /*------------  no more frames can be output but sentence end not reached ----------------------------------------*/
+#if defined(PICO_USE_CEP_WINDOW)
+                    /* step done, keep left context and continue filling the window */
+                    shiftWindow(cep);
+#else
                     PICODBG_DEBUG(("Maximum number of frames per sentence reached"));
+#endif
                     cep->procState = PICOCEP_STEPSTATE_PROCESS_PARSE;
                 }
                 /*----------------------------------------------------*/
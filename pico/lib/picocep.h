@@ -40,6 +40,62 @@ extern "C" {
 }
 #endif
 
+/* By default the parameter generation (MLPG) smoothes the frames of a
+   whole sentence at once; the work and output buffers are sized for
+   the longest sentence (10000 frames, some 780KB of engine memory) and
+   no frame is passed on to SIG before the sentence is complete.
+
+   When PICO_USE_CEP_WINDOW is defined, the frames are smoothed in a
+   sliding window instead: as soon as PICOCEP_WIN_STEP frames plus
+   PICOCEP_WIN_LOOKAHEAD frames of right context are available, the
+   PICOCEP_WIN_STEP frames are smoothed and output. The forward
+   elimination of the banded system is continued from the previous
+   window, so the left context is exact; the backward substitution
+   starts at the end of the lookahead. The first PICOCEP_WIN_OVERLAP
+   frames of each step are cross-faded with the previous window's
+   solution of the same frames. The buffers then hold PICOCEP_WIN_STEP
+   + PICOCEP_WIN_LOOKAHEAD frames (some 50KB with the default sizes),
+   and the engine memory is reduced accordingly
+   (PICOCTRL_DEFAULT_ENGINE_SIZE). The result deviates slightly from
+   the whole-sentence solution near the window boundaries.
+   Enable with: -DPICO_USE_CEP_WINDOW=1 */
+
+#if defined(PICO_USE_CEP_WINDOW)
+#ifndef PICOCEP_WIN_STEP
+#define PICOCEP_WIN_STEP       512
+#endif
+#ifndef PICOCEP_WIN_LOOKAHEAD
+#define PICOCEP_WIN_LOOKAHEAD  128
+#endif
+#ifndef PICOCEP_WIN_OVERLAP
+#define PICOCEP_WIN_OVERLAP      8  /* at most PICOCEP_WIN_LOOKAHEAD */
+#endif
+#endif
+
+/* The MGC trajectories are smoothed by one of the following solvers,
+   selected per voice definition (voice option PICORSRC_VOPT_CEP_SOLVER)
+   when the engine is created:
+   - PICOCEP_SOLVER_SCALAR: one coefficient after the other (default)
+   - PICOCEP_SOLVER_LANES_FIXED: blocks of 8 coefficients are set up and
+     solved in lockstep, stored coefficient-major so that each step runs
+     over adjacent lanes; same fixed point arithmetic and output as the
+     scalar solver
+   - PICOCEP_SOLVER_LANES_FLOAT: as above, but the banded system is
+     factorized in single precision floating point; the lane loops have
+     no branches and vectorize. The output differs from the fixed point
+     solution by rounding.
+   The lane buffers hold PICOCEP_LANES values per frame, i.e. some 1.6MB
+   of additional engine memory for whole sentences and 100KB with
+   PICO_USE_CEP_WINDOW (see picocep_getSolverMemSize). F0 is always
+   smoothed by the scalar solver. */
+
+#define PICOCEP_SOLVER_SCALAR       0
+#define PICOCEP_SOLVER_LANES_FIXED  1
+#define PICOCEP_SOLVER_LANES_FLOAT  2
+
+/* additional engine memory needed by 'solver' */
+picoos_objsize_t picocep_getSolverMemSize(picoos_int32 solver);
+
 /* ******************************************************************************
  *   items related to the generic interface
  ********************************************************************************/
@@ -27,6 +27,7 @@
  */
 
 #include "picodefs.h"
+#include "picoapi.h"
 #include "picoos.h"
 #include "picodbg.h"
 #include "picodata.h"
@@ -576,6 +577,12 @@ picoctrl_Engine picoctrl_newEngine(picoos_MemoryManager mm,
     picoos_uint8 done= TRUE;
 
     picoos_uint16 bSize;
+    picoos_objsize_t engSize;
+    picoos_int32 solver;
+    picoos_int32 batch;
+    picoos_int32 rate;
+    picoos_int32 tempo;
+    picoos_int32 formant, noise;
 
     picoos_MemoryManager engMM;
     picoos_ExceptionManager engEM;
@@ -594,14 +601,38 @@ picoctrl_Engine picoctrl_newEngine(picoos_MemoryManager mm,
         this->cbIn = NULL;
         this->cbOut = NULL;
 
-        this->raw_mem = picoos_allocate(mm, PICOCTRL_DEFAULT_ENGINE_SIZE);
+        /* voice options needing more engine memory */
+        engSize = PICOCTRL_DEFAULT_ENGINE_SIZE;
+        if (PICO_OK == picorsrc_getVoiceOption(rm, voiceName,
+                PICORSRC_VOPT_CEP_SOLVER, &solver)) {
+            engSize += picocep_getSolverMemSize(solver);
+        }
+        if (PICO_OK == picorsrc_getVoiceOption(rm, voiceName,
+                PICORSRC_VOPT_SIG_BATCH, &batch)) {
+            engSize += picosig_getBatchMemSize(batch);
+        }
+        if (PICO_OK == picorsrc_getVoiceOption(rm, voiceName,
+                PICORSRC_VOPT_SIG_RATE, &rate)) {
+            engSize += picosig_getRateMemSize(rate);
+        }
+        if (PICO_OK == picorsrc_getVoiceOption(rm, voiceName,
+                PICORSRC_VOPT_SIG_TEMPO, &tempo)) {
+            engSize += picosig_getTempoMemSize(tempo);
+        }
+        if ((PICO_OK == picorsrc_getVoiceOption(rm, voiceName,
+                PICORSRC_VOPT_SIG_FORMANT, &formant))
+                && (PICO_OK == picorsrc_getVoiceOption(rm, voiceName,
+                PICORSRC_VOPT_SIG_NOISE, &noise))) {
+            engSize += picosig_getVoiceMemSize(formant, noise);
+        }
+        this->raw_mem = picoos_allocate(mm, engSize);
         if (NULL == this->raw_mem) {
             done = FALSE;
         }
     }
 
     if (done) {
-        engMM = picoos_newMemoryManager(this->raw_mem, PICOCTRL_DEFAULT_ENGINE_SIZE,
+        engMM = picoos_newMemoryManager(this->raw_mem, engSize,
                     /*enableMemProt*/ FALSE);
         done = (NULL != engMM);
     }
@@ -616,6 +647,16 @@ picoctrl_Engine picoctrl_newEngine(picoos_MemoryManager mm,
 
         done = (PICO_OK == picorsrc_createVoice(rm,voiceName,&(this->voice)));
     }
+#if defined(PICO_DT_CACHE_ENABLED)
+    if (done) {
+        /* the cache is an optimization only, run without it if it does
+           not fit */
+        if (PICO_OK != picodt_cache_initialize(this->common->mm,
+                &(this->voice->dtCache))) {
+            this->voice->dtCache = NULL;
+        }
+    }
+#endif
     if (done)  {
         bSize = picodata_get_default_buf_size(PICODATA_PUTYPE_TEXT);
 
@@ -665,6 +706,8 @@ void picoctrl_disposeEngine(picoos_MemoryManager mm, picorsrc_ResourceManager rm
 {
     if (NULL != (*this)) {
         if (NULL != (*this)->voice) {
+            picodt_cache_deallocate((*this)->common->mm,
+                    &((*this)->voice->dtCache));
             picorsrc_releaseVoice(rm,&((*this)->voice));
         }
         if(NULL != (*this)->control) {
@@ -709,6 +752,39 @@ picoos_Common picoctrl_engGetCommon(picoctrl_Engine this) {
     }
 }/*picoctrl_engGetCommon*/
 
+/**
+ * returns the decision tree cache of an engine
+ * @param    this : handle of the engine
+ * @return    the engine's decision tree cache
+ * @return    NULL if error or if the engine has no cache
+ * @callgraph
+ * @callergraph
+ */
+picodt_cache_t * picoctrl_engGetDtCache(picoctrl_Engine this) {
+    if ((NULL == this) || (NULL == this->voice)) {
+        return NULL;
+    } else {
+        return this->voice->dtCache;
+    }
+}/*picoctrl_engGetDtCache*/
+
+/**
+ * returns the type of the speech data of an engine
+ * @param    this : handle of the engine
+ * @return    the output format of the signal generation (voice option
+ *            PICORSRC_VOPT_SIG_FORMAT), PICO_DATA_PCM_16BIT if not set
+ * @callgraph
+ * @callergraph
+ */
+picoos_int16 picoctrl_engGetOutputDataType(picoctrl_Engine this) {
+    if ((NULL == this) || (NULL == this->voice)
+            || (0 == this->voice->options[PICORSRC_VOPT_SIG_FORMAT])) {
+        return PICO_DATA_PCM_16BIT;
+    } else {
+        return (picoos_int16) this->voice->options[PICORSRC_VOPT_SIG_FORMAT];
+    }
+}/*picoctrl_engGetOutputDataType*/
+
 /**
  * feed raw 'text' into 'engine'. text may contain '\\0'.
  * @param    this : handle of the engine
@@ -44,7 +44,26 @@ extern "C" {
 /* temporarily increased for preprocessing
 #define PICOCTRL_DEFAULT_ENGINE_SIZE 200000
 */
-#define PICOCTRL_DEFAULT_ENGINE_SIZE 1000000
+#if defined(PICO_USE_TRNS_CACHE)
+/* transduction caches of SA and SPHO, see picotrns.h */
+#define PICOCTRL_TRNS_CACHE_SIZE 24000
+#else
+#define PICOCTRL_TRNS_CACHE_SIZE 0
+#endif
+#if defined(PICO_DT_CACHE_ENABLED)
+/* decision tree cache, see picodtcache.h */
+#define PICOCTRL_DT_CACHE_SIZE (sizeof(picodt_cache_t) + 64)
+#else
+#define PICOCTRL_DT_CACHE_SIZE 0
+#endif
+#if defined(PICO_USE_CEP_WINDOW)
+/* sliding-window parameter generation, see picocep.h */
+#define PICOCTRL_BASE_ENGINE_SIZE 300000
+#else
+#define PICOCTRL_BASE_ENGINE_SIZE 1000000
+#endif
+#define PICOCTRL_DEFAULT_ENGINE_SIZE (PICOCTRL_BASE_ENGINE_SIZE \
+        + PICOCTRL_TRNS_CACHE_SIZE + PICOCTRL_DT_CACHE_SIZE)
 
 typedef struct picoctrl_engine * picoctrl_Engine;
 
@@ -74,6 +93,12 @@ pico_status_t picoctrl_engReset(
 
 picoos_Common picoctrl_engGetCommon(picoctrl_Engine this);
 
+/* decision tree cache of the engine, NULL if none */
+picodt_cache_t * picoctrl_engGetDtCache(picoctrl_Engine this);
+
+/* type of the speech data of the engine, PICO_DATA_* */
+picoos_int16 picoctrl_engGetOutputDataType(picoctrl_Engine this);
+
 picodata_step_result_t picoctrl_engFetchOutputItemBytes(
         picoctrl_Engine engine,
         picoos_char * buffer,
@@ -171,6 +171,20 @@ typedef signed int pico_Status;
 /* 16 bit PCM samples, native endianness of platform */
 #define PICO_DATA_PCM_16BIT             (pico_Int16)  1
 
+/* G.711 mu-law, one byte per sample */
+#define PICO_DATA_ULAW_8BIT             (pico_Int16)  2
+
+/* G.711 A-law, one byte per sample */
+#define PICO_DATA_ALAW_8BIT             (pico_Int16)  3
+
+/* IMA ADPCM, 4 bit per sample, the first sample in the low nibble of a
+   byte; one continuous stream from engine creation or reset on */
+#define PICO_DATA_IMA_ADPCM_4BIT        (pico_Int16)  4
+
+/* 32 bit IEEE float samples, native endianness of platform, full scale
+   at +-1.0 and not clipped */
+#define PICO_DATA_FLOAT_32BIT           (pico_Int16)  5
+
 #ifdef __cplusplus
 }
 #endif
@@ -39,7 +39,9 @@ extern "C" {
 /*----------------------------CONSTANTS ----------------------*/
 /*Normalization factors used at the start and at the end of the sig*/
 #define PICODSP_START_FLOAT_NORM      0.41f
+#define PICODSP_START_FIX_NORM        26870 /* PICODSP_START_FLOAT_NORM in Q16 */
 #define PICODSP_ENVSPEC_K1            0.5f
+#define PICODSP_ENVSPEC_SHIFT         27    /* log2(PICODSP_FIX_SCALE1 / PICODSP_ENVSPEC_K1) */
 #define PICODSP_ENVSPEC_K2            2
 #define PICODSP_GETEXC_K1             1024
 #define PICODSP_FIXRESP_NORM          4096.0f
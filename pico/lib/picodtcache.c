@@ -27,10 +27,13 @@
  * ============================================================================ */
 
 /**
- * Get cache index from hash
+ * Get cache index from hash; the trees of PAM share input vectors, the
+ * tree id spreads them over different slots
  */
-static inline picoos_uint16 get_cache_index(picoos_uint32 hash) {
-    return (picoos_uint16)(hash & (PICO_DT_CACHE_SIZE - 1));
+static inline picoos_uint16 get_cache_index(picoos_uint32 hash,
+                                            picoos_uint16 tree_id) {
+    hash ^= (picoos_uint32)tree_id * 2654435761U;
+    return (picoos_uint16)((hash ^ (hash >> 16)) & (PICO_DT_CACHE_SIZE - 1));
 }
 
 /**
@@ -39,16 +42,19 @@ static inline picoos_uint16 get_cache_index(picoos_uint32 hash) {
 static inline picoos_uint16 find_lru_entry(picodt_cache_t *cache, 
                                            picoos_uint16 start_index) {
     picoos_uint16 lru_index = start_index;
-    picoos_uint8 min_access = 255;
+    picoos_uint16 max_age = 0;
     
     /* Search a small window around the hash index */
     for (picoos_uint16 i = 0; i < 4; i++) {
         picoos_uint16 idx = (start_index + i) & (PICO_DT_CACHE_SIZE - 1);
+        picoos_uint16 age;
         if (!cache->entries[idx].valid) {
             return idx;  /* Found empty slot */
         }
-        if (cache->entries[idx].access_count < min_access) {
-            min_access = cache->entries[idx].access_count;
+        /* the clock wraps around, compare ages rather than stamps */
+        age = (picoos_uint16)(cache->clock - cache->entries[idx].access_count);
+        if (age >= max_age) {
+            max_age = age;
             lru_index = idx;
         }
     }
@@ -56,6 +62,28 @@ static inline picoos_uint16 find_lru_entry(picodt_cache_t *cache,
     return lru_index;
 }
 
+/**
+ * Check whether entry holds key
+ */
+static inline picoos_uint8 entry_matches(const picodt_cache_entry_t *entry,
+                                         picoos_uint16 tree_id,
+                                         const picoos_uint8 *key,
+                                         picoos_uint16 key_len,
+                                         picoos_uint32 context_hash) {
+    picoos_uint16 i;
+    
+    if (!entry->valid || entry->context_hash != context_hash ||
+        entry->tree_id != tree_id || entry->key_len != key_len) {
+        return 0;
+    }
+    for (i = 0; i < key_len; i++) {
+        if (entry->key[i] != key[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
 /* ============================================================================
  * Public API Implementation
  * ============================================================================ */
@@ -63,8 +91,8 @@ static inline picoos_uint16 find_lru_entry(picodt_cache_t *cache,
 /**
  * Initialize decision tree cache
  */
-picoos_uint8 picodt_cache_initialize(picoos_MemoryManager mm, 
-                                     picodt_cache_t **cache) {
+pico_status_t picodt_cache_initialize(picoos_MemoryManager mm,
+                                      picodt_cache_t **cache) {
     picodt_cache_t *new_cache;
     
     if (cache == NULL) {
@@ -128,43 +156,38 @@ void picodt_cache_clear(picodt_cache_t *cache) {
 }
 
 /**
- * Lookup PDF index in cache
+ * Lookup classification result in cache
  */
 picoos_uint8 picodt_cache_lookup(picodt_cache_t *cache,
-                                 picoos_uint32 context_hash,
                                  picoos_uint16 tree_id,
-                                 picoos_uint16 *pdf_index) {
-    if (!picodt_cache_is_enabled(cache) || pdf_index == NULL) {
+                                 const picoos_uint8 *key,
+                                 picoos_uint16 key_len,
+                                 picoos_uint32 context_hash,
+                                 picokdt_classify_result_t *result,
+                                 picoos_uint16 *treeout) {
+    picodt_cache_entry_t *entry;
+    
+    if (!picodt_cache_is_enabled(cache) || result == NULL ||
+        key_len > PICO_DT_CACHE_MAX_KEYLEN) {
         return 0;
     }
     
-    picoos_uint16 index = get_cache_index(context_hash);
-    
-    /* Check primary slot */
-    if (cache->entries[index].valid &&
-        cache->entries[index].context_hash == context_hash &&
-        cache->entries[index].tree_id == tree_id) {
-        
-        /* Cache hit! */
-        *pdf_index = cache->entries[index].pdf_index;
-        cache->entries[index].access_count = cache->clock++;
-        cache->stats.hits++;
-        return 1;
-    }
+    picoos_uint16 index = get_cache_index(context_hash, tree_id);
     
-    /* Check nearby slots for collision handling */
-    for (picoos_uint16 i = 1; i < 4; i++) {
-        picoos_uint16 idx = (index + i) & (PICO_DT_CACHE_SIZE - 1);
+    /* Check primary slot and nearby slots for collision handling */
+    for (picoos_uint16 i = 0; i < 4; i++) {
+        entry = &cache->entries[(index + i) & (PICO_DT_CACHE_SIZE - 1)];
         
-        if (cache->entries[idx].valid &&
-            cache->entries[idx].context_hash == context_hash &&
-            cache->entries[idx].tree_id == tree_id) {
-            
-            /* Cache hit in collision slot */
-            *pdf_index = cache->entries[idx].pdf_index;
-            cache->entries[idx].access_count = cache->clock++;
+        if (entry_matches(entry, tree_id, key, key_len, context_hash)) {
+            *result = entry->result;
+            if (treeout != NULL) {
+                *treeout = entry->treeout;
+            }
+            entry->access_count = cache->clock++;
             cache->stats.hits++;
-            cache->stats.collisions++;
+            if (i > 0) {
+                cache->stats.collisions++;
+            }
             return 1;
         }
     }
@@ -175,42 +198,42 @@ picoos_uint8 picodt_cache_lookup(picodt_cache_t *cache,
 }
 
 /**
- * Insert PDF index into cache
+ * Insert classification result into cache
  */
 void picodt_cache_insert(picodt_cache_t *cache,
-                         picoos_uint32 context_hash,
                          picoos_uint16 tree_id,
-                         picoos_uint16 pdf_index) {
-    if (!picodt_cache_is_enabled(cache)) {
-        return;
-    }
-    
-    picoos_uint16 index = get_cache_index(context_hash);
+                         const picoos_uint8 *key,
+                         picoos_uint16 key_len,
+                         picoos_uint32 context_hash,
+                         const picokdt_classify_result_t *result,
+                         picoos_uint16 treeout) {
+    picodt_cache_entry_t *entry;
+    picoos_uint16 i;
     
-    /* Try to insert in primary slot */
-    if (!cache->entries[index].valid) {
-        /* Empty slot, insert directly */
-        cache->entries[index].context_hash = context_hash;
-        cache->entries[index].pdf_index = pdf_index;
-        cache->entries[index].tree_id = tree_id;
-        cache->entries[index].valid = 1;
-        cache->entries[index].access_count = cache->clock++;
+    if (!picodt_cache_is_enabled(cache) || result == NULL ||
+        key_len > PICO_DT_CACHE_MAX_KEYLEN) {
         return;
     }
     
-    /* Collision - find LRU entry */
-    index = find_lru_entry(cache, index);
+    /* Use an empty slot of the window or evict the LRU entry */
+    entry = &cache->entries[find_lru_entry(cache,
+                                           get_cache_index(context_hash,
+                                                           tree_id))];
     
-    if (cache->entries[index].valid) {
+    if (entry->valid) {
         cache->stats.evictions++;
     }
     
-    /* Insert in LRU slot */
-    cache->entries[index].context_hash = context_hash;
-    cache->entries[index].pdf_index = pdf_index;
-    cache->entries[index].tree_id = tree_id;
-    cache->entries[index].valid = 1;
-    cache->entries[index].access_count = cache->clock++;
+    entry->context_hash = context_hash;
+    entry->tree_id = tree_id;
+    entry->treeout = treeout;
+    entry->result = *result;
+    entry->key_len = (picoos_uint8)key_len;
+    for (i = 0; i < key_len; i++) {
+        entry->key[i] = key[i];
+    }
+    entry->valid = 1;
+    entry->access_count = cache->clock++;
 }
 
 /**
@@ -18,16 +18,26 @@
  *
  * Decision Tree Cache for PAM optimization (Phase 2)
  * 
- * Caches frequent decision tree traversal results to avoid
- * repeated tree walks for common phoneme contexts.
+ * Caches decision tree classification results to avoid repeated tree
+ * walks for recurring contexts. The key is the complete input vector
+ * as constructed for the tree (plus the tree's knowledge base id), so a
+ * hit returns exactly what the tree walk would have returned; hashes are
+ * only used to find the slot.
  * 
- * Expected performance:
- * - 50-70% cache hit rate for common contexts
- * - 20-30% PAM stage speedup
- * - Only 1-2 KB memory overhead
+ * The cache belongs to an engine (created with the engine's voice) and
+ * is shared by all tree users of that engine: PAM (duration, pitch and
+ * spectrum trees), ACPH (phrasing, accentuation) and SA/WA (POS
+ * disambiguation and prediction). G2P is not cached here, its trees
+ * depend on the preceding outputs of the same word and whole words are
+ * covered by the pronunciation cache (picopcache.h).
+ * 
+ * Memory: 76 bytes of engine memory per entry, i.e. 152 KB with the
+ * default size (10 KB on embedded platforms). Each phone takes 11 PAM
+ * entries, smaller caches mainly help with short repeated prompts.
  * 
  * Usage:
  *   Enable with: -DPICO_USE_DT_CACHE=1
+ *   Hit rate: picoext_getDtCacheStats()
  */
 
 #ifndef PICODTCACHE_H_
@@ -35,6 +45,8 @@
 
 #include "picodefs.h"
 #include "picoos.h"
+#include "picokdt.h"
+#include "picoembedded.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -54,17 +66,24 @@ extern "C" {
     #ifdef PICO_EMBEDDED_PLATFORM
         #define PICO_DT_CACHE_SIZE 128  /* Smaller for embedded */
     #else
-        #define PICO_DT_CACHE_SIZE 256  /* Larger for desktop */
+        #define PICO_DT_CACHE_SIZE 2048 /* Larger for desktop */
     #endif
 #endif
 
+/* Maximum key length (PAM input vectors are 60 bytes); longer keys are
+   not cached */
+#define PICO_DT_CACHE_MAX_KEYLEN 60
+
 /* Cache entry structure */
 typedef struct {
-    picoos_uint32 context_hash;  /* Hash of linguistic context */
-    picoos_uint16 pdf_index;     /* Cached PDF result */
+    picoos_uint32 context_hash;  /* Hash of key */
     picoos_uint16 tree_id;       /* Which tree this applies to */
+    picoos_uint16 treeout;       /* Raw tree output (POS-D/ACC history) */
+    picokdt_classify_result_t result; /* Cached classification result */
+    picoos_uint16 access_count;  /* LRU counter */
     picoos_uint8  valid;         /* Is this entry valid? */
-    picoos_uint8  access_count;  /* LRU counter */
+    picoos_uint8  key_len;       /* Length of key */
+    picoos_uint8  key[PICO_DT_CACHE_MAX_KEYLEN]; /* Tree input vector */
 } picodt_cache_entry_t;
 
 /* Cache statistics (for profiling) */
@@ -80,7 +99,7 @@ typedef struct {
     picodt_cache_entry_t entries[PICO_DT_CACHE_SIZE];
     picodt_cache_stats_t stats;
     picoos_uint8 enabled;
-    picoos_uint8 clock;  /* Global clock for LRU */
+    picoos_uint16 clock;  /* Global clock for LRU */
 } picodt_cache_t;
 
 /* ============================================================================
@@ -93,8 +112,8 @@ typedef struct {
  * @param cache Pointer to cache structure
  * @return PICO_OK on success
  */
-picoos_uint8 picodt_cache_initialize(picoos_MemoryManager mm, 
-                                     picodt_cache_t **cache);
+pico_status_t picodt_cache_initialize(picoos_MemoryManager mm,
+                                      picodt_cache_t **cache);
 
 /**
  * Deallocate decision tree cache
@@ -111,29 +130,41 @@ void picodt_cache_deallocate(picoos_MemoryManager mm,
 void picodt_cache_clear(picodt_cache_t *cache);
 
 /**
- * Lookup PDF index in cache
+ * Lookup classification result in cache
  * @param cache Cache structure
- * @param context_hash Hash of linguistic context
- * @param tree_id Decision tree identifier
- * @param pdf_index Output: PDF index if found
+ * @param tree_id Decision tree identifier (knowledge base id)
+ * @param key Tree input vector
+ * @param key_len Length of key
+ * @param context_hash picodt_compute_extended_hash(key, key_len)
+ * @param result Output: classification result if found
+ * @param treeout Output: raw tree output if found (may be NULL)
  * @return 1 if found (cache hit), 0 if not found (cache miss)
  */
 picoos_uint8 picodt_cache_lookup(picodt_cache_t *cache,
-                                 picoos_uint32 context_hash,
                                  picoos_uint16 tree_id,
-                                 picoos_uint16 *pdf_index);
+                                 const picoos_uint8 *key,
+                                 picoos_uint16 key_len,
+                                 picoos_uint32 context_hash,
+                                 picokdt_classify_result_t *result,
+                                 picoos_uint16 *treeout);
 
 /**
- * Insert PDF index into cache
+ * Insert classification result into cache
  * @param cache Cache structure
- * @param context_hash Hash of linguistic context
- * @param tree_id Decision tree identifier
- * @param pdf_index PDF index to cache
+ * @param tree_id Decision tree identifier (knowledge base id)
+ * @param key Tree input vector
+ * @param key_len Length of key (not cached if > PICO_DT_CACHE_MAX_KEYLEN)
+ * @param context_hash picodt_compute_extended_hash(key, key_len)
+ * @param result Classification result to cache
+ * @param treeout Raw tree output to cache
  */
 void picodt_cache_insert(picodt_cache_t *cache,
-                         picoos_uint32 context_hash,
                          picoos_uint16 tree_id,
-                         picoos_uint16 pdf_index);
+                         const picoos_uint8 *key,
+                         picoos_uint16 key_len,
+                         picoos_uint32 context_hash,
+                         const picokdt_classify_result_t *result,
+                         picoos_uint16 treeout);
 
 /**
  * Get cache statistics
@@ -208,6 +239,18 @@ picoos_uint32 picodt_compute_extended_hash(const picoos_uint8 *features,
  * Inline Helpers
  * ============================================================================ */
 
+/**
+ * Append a 16 bit attribute value to a key
+ * @return New key length
+ */
+static inline picoos_uint16 picodt_cache_key_put16(picoos_uint8 *key,
+                                                   picoos_uint16 key_len,
+                                                   picoos_uint16 value) {
+    key[key_len] = (picoos_uint8)(value >> 8);
+    key[key_len + 1] = (picoos_uint8)(value & 0xff);
+    return key_len + 2;
+}
+
 /**
  * Check if cache is enabled
  */
@@ -33,6 +33,11 @@
 #include "picoextapi.h"
 #include "picoapid.h"
 #include "picorsrc.h"
+#include "picopcache.h"
+#include "picodtcache.h"
+#include "picosigrs.h"
+#include "picosigenc.h"
+#include "picosigts.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -252,6 +257,337 @@ PICO_FUNC picoext_loadResourceFromMemory(
 }
 
 
+
+/* *** Pronunciation cache ****************************************************/
+
+PICO_FUNC picoext_createPronCache(
+        pico_System system,
+        const pico_Char *voiceName,
+        const pico_Uint32 maxEntries
+        )
+{
+    pico_Status status = PICO_OK;
+
+    if (!is_valid_system_handle(system)) {
+        status = PICO_ERR_INVALID_HANDLE;
+    } else if (voiceName == NULL) {
+        status = PICO_ERR_NULLPTR_ACCESS;
+    } else {
+        picoos_emReset(system->common->em);
+        status = picorsrc_createPronCache(system->rm,
+                (picoos_char *) voiceName, maxEntries);
+    }
+
+    return status;
+}
+
+
+PICO_FUNC picoext_releasePronCache(
+        pico_System system,
+        const pico_Char *voiceName
+        )
+{
+    pico_Status status = PICO_OK;
+
+    if (!is_valid_system_handle(system)) {
+        status = PICO_ERR_INVALID_HANDLE;
+    } else if (voiceName == NULL) {
+        status = PICO_ERR_NULLPTR_ACCESS;
+    } else {
+        picoos_emReset(system->common->em);
+        status = picorsrc_releasePronCache(system->rm,
+                (picoos_char *) voiceName);
+    }
+
+    return status;
+}
+
+
+static pico_Status getPronCache(
+        pico_System system,
+        const pico_Char *voiceName,
+        picopcache_PronCache *pronCache
+        )
+{
+    pico_Status status;
+
+    picoos_emReset(system->common->em);
+    status = picorsrc_getPronCache(system->rm, (picoos_char *) voiceName,
+            pronCache);
+    if ((PICO_OK == status) && (NULL == *pronCache)) {
+        status = picoos_emRaiseException(system->common->em,
+                PICO_EXC_NAME_UNDEFINED, NULL,
+                (picoos_char *) "pronunciation cache of voice %s", voiceName);
+    }
+    return status;
+}
+
+
+PICO_FUNC picoext_sharePronCache(
+        pico_System ownerSystem,
+        const pico_Char *ownerVoiceName,
+        pico_System system,
+        const pico_Char *voiceName
+        )
+{
+    pico_Status status = PICO_OK;
+    picopcache_PronCache pronCache;
+
+    if (!is_valid_system_handle(ownerSystem) || !is_valid_system_handle(system)) {
+        status = PICO_ERR_INVALID_HANDLE;
+    } else if ((ownerVoiceName == NULL) || (voiceName == NULL)) {
+        status = PICO_ERR_NULLPTR_ACCESS;
+    } else {
+        status = getPronCache(ownerSystem, ownerVoiceName, &pronCache);
+        if (PICO_OK == status) {
+            picoos_emReset(system->common->em);
+            status = picorsrc_sharePronCache(system->rm,
+                    (picoos_char *) voiceName, pronCache);
+        }
+    }
+
+    return status;
+}
+
+
+PICO_FUNC picoext_loadPronCache(
+        pico_System system,
+        const pico_Char *voiceName,
+        const pico_Char *fileName
+        )
+{
+    pico_Status status = PICO_OK;
+    picopcache_PronCache pronCache;
+
+    if (!is_valid_system_handle(system)) {
+        status = PICO_ERR_INVALID_HANDLE;
+    } else if ((voiceName == NULL) || (fileName == NULL)) {
+        status = PICO_ERR_NULLPTR_ACCESS;
+    } else {
+        status = getPronCache(system, voiceName, &pronCache);
+        if (PICO_OK == status) {
+            status = picopcache_load(system->common, pronCache,
+                    (picoos_char *) fileName);
+        }
+    }
+
+    return status;
+}
+
+
+PICO_FUNC picoext_savePronCache(
+        pico_System system,
+        const pico_Char *voiceName,
+        const pico_Char *fileName
+        )
+{
+    pico_Status status = PICO_OK;
+    picopcache_PronCache pronCache;
+
+    if (!is_valid_system_handle(system)) {
+        status = PICO_ERR_INVALID_HANDLE;
+    } else if ((voiceName == NULL) || (fileName == NULL)) {
+        status = PICO_ERR_NULLPTR_ACCESS;
+    } else {
+        status = getPronCache(system, voiceName, &pronCache);
+        if (PICO_OK == status) {
+            status = picopcache_save(system->common, pronCache,
+                    (picoos_char *) fileName);
+        }
+    }
+
+    return status;
+}
+
+
+PICO_FUNC picoext_getPronCacheStats(
+        pico_System system,
+        const pico_Char *voiceName,
+        pico_Uint32 *outNumEntries,
+        pico_Uint32 *outHits,
+        pico_Uint32 *outMisses
+        )
+{
+    pico_Status status = PICO_OK;
+    picopcache_PronCache pronCache;
+    picoos_uint32 numEntries, hits, misses;
+
+    if (!is_valid_system_handle(system)) {
+        status = PICO_ERR_INVALID_HANDLE;
+    } else if ((voiceName == NULL) || (outNumEntries == NULL)
+            || (outHits == NULL) || (outMisses == NULL)) {
+        status = PICO_ERR_NULLPTR_ACCESS;
+    } else {
+        status = getPronCache(system, voiceName, &pronCache);
+        if (PICO_OK == status) {
+            picopcache_getStats(pronCache, &numEntries, &hits, &misses);
+            *outNumEntries = numEntries;
+            *outHits = hits;
+            *outMisses = misses;
+        }
+    }
+
+    return status;
+}
+
+
+/* *** Decision tree cache ****************************************************/
+
+static pico_Status getDtCache(
+        pico_Engine engine,
+        picodt_cache_t **dtCache
+        )
+{
+    picoos_Common common = picoctrl_engGetCommon((picoctrl_Engine) engine);
+
+    picoos_emReset(common->em);
+    *dtCache = picoctrl_engGetDtCache((picoctrl_Engine) engine);
+    if (NULL == *dtCache) {
+        return picoos_emRaiseException(common->em, PICO_EXC_NAME_UNDEFINED,
+                NULL, (picoos_char *) "decision tree cache");
+    }
+    return PICO_OK;
+}
+
+
+PICO_FUNC picoext_setDtCacheEnabled(
+        pico_Engine engine,
+        pico_Int16 enabled
+        )
+{
+    pico_Status status = PICO_OK;
+    picodt_cache_t *dtCache;
+
+    if (!picoctrl_isValidEngineHandle((picoctrl_Engine) engine)) {
+        status = PICO_ERR_INVALID_HANDLE;
+    } else {
+        status = getDtCache(engine, &dtCache);
+        if (PICO_OK == status) {
+            picodt_cache_set_enabled(dtCache, (picoos_uint8) (enabled != 0));
+        }
+    }
+
+    return status;
+}
+
+
+PICO_FUNC picoext_getDtCacheStats(
+        pico_Engine engine,
+        pico_Uint32 *outHits,
+        pico_Uint32 *outMisses,
+        pico_Int16 *outHitRate
+        )
+{
+    pico_Status status = PICO_OK;
+    picodt_cache_t *dtCache;
+    picodt_cache_stats_t stats;
+
+    if (!picoctrl_isValidEngineHandle((picoctrl_Engine) engine)) {
+        status = PICO_ERR_INVALID_HANDLE;
+    } else if ((outHits == NULL) || (outMisses == NULL)
+            || (outHitRate == NULL)) {
+        status = PICO_ERR_NULLPTR_ACCESS;
+    } else {
+        status = getDtCache(engine, &dtCache);
+        if (PICO_OK == status) {
+            picodt_cache_get_stats(dtCache, &stats);
+            *outHits = stats.hits;
+            *outMisses = stats.misses;
+            *outHitRate = picodt_cache_hit_rate(dtCache);
+        }
+    }
+
+    return status;
+}
+
+/* *** Voice options **********************************************************/
+
+PICO_FUNC picoext_setVoiceOption(
+        pico_System system,
+        const pico_Char *voiceName,
+        const pico_Int16 option,
+        const pico_Int32 value
+        )
+{
+    pico_Status status = PICO_OK;
+
+    if (!is_valid_system_handle(system)) {
+        status = PICO_ERR_INVALID_HANDLE;
+    } else if (voiceName == NULL) {
+        status = PICO_ERR_NULLPTR_ACCESS;
+    } else if ((option < 0) || (option >= PICORSRC_NUM_VOPTS)) {
+        status = PICO_ERR_INVALID_ARGUMENT;
+    } else if ((PICOEXT_VOICEOPT_CEP_SOLVER == option)
+            && ((value < PICOEXT_CEP_SOLVER_SCALAR)
+                    || (value > PICOEXT_CEP_SOLVER_LANES_FLOAT))) {
+        status = PICO_ERR_INVALID_ARGUMENT;
+    } else if ((PICOEXT_VOICEOPT_SIG_KERNELS == option)
+            && ((value < PICOEXT_SIG_KERNELS_AUTO)
+                    || (value > PICOEXT_SIG_KERNELS_NEON))) {
+        status = PICO_ERR_INVALID_ARGUMENT;
+    } else if ((PICOEXT_VOICEOPT_SIG_FFT == option)
+            && ((value < PICOEXT_SIG_FFT_AUTO)
+                    || (value > PICOEXT_SIG_FFT_AVX2))) {
+        status = PICO_ERR_INVALID_ARGUMENT;
+    } else if ((PICOEXT_VOICEOPT_SIG_BATCH == option)
+            && ((value < 0) || (value > PICOEXT_SIG_BATCH_MAX))) {
+        status = PICO_ERR_INVALID_ARGUMENT;
+    } else if ((PICOEXT_VOICEOPT_SIG_RATE == option) && (value != 0)
+            && (value != PICOSIGRS_IN_RATE) && !picosigrs_isSupportedRate(value)) {
+        status = PICO_ERR_INVALID_ARGUMENT;
+    } else if ((PICOEXT_VOICEOPT_SIG_FORMAT == option) && (value != 0)
+            && !picosigenc_isSupportedFormat(value)) {
+        status = PICO_ERR_INVALID_ARGUMENT;
+    } else if ((PICOEXT_VOICEOPT_SIG_PITCH == option) && (value != 0)
+            && ((value < PICOEXT_SIG_PITCH_MIN) || (value > PICOEXT_SIG_PITCH_MAX))) {
+        status = PICO_ERR_INVALID_ARGUMENT;
+    } else if ((PICOEXT_VOICEOPT_SIG_FORMANT == option)
+            && ((value < -PICOEXT_SIG_FORMANT_MAX) || (value > PICOEXT_SIG_FORMANT_MAX))) {
+        status = PICO_ERR_INVALID_ARGUMENT;
+    } else if ((PICOEXT_VOICEOPT_SIG_MATH == option)
+            && ((value < PICOEXT_SIG_MATH_DEFAULT) || (value > PICOEXT_SIG_MATH_FAST))) {
+        status = PICO_ERR_INVALID_ARGUMENT;
+    } else if ((PICOEXT_VOICEOPT_SIG_TEMPO == option) && (value != 0)
+            && (value != 100) && !picosigts_isSupportedTempo(value)) {
+        status = PICO_ERR_INVALID_ARGUMENT;
+    } else if (((PICOEXT_VOICEOPT_PDF_EXPAND == option)
+                    || (PICOEXT_VOICEOPT_SIG_SILENCE == option))
+            && ((value < 0) || (value > 1))) {
+        status = PICO_ERR_INVALID_ARGUMENT;
+    } else {
+        picoos_emReset(system->common->em);
+        status = picorsrc_setVoiceOption(system->rm,
+                (picoos_char *) voiceName, (picoos_uint8) option, value);
+    }
+
+    return status;
+}
+
+
+PICO_FUNC picoext_getVoiceOption(
+        pico_System system,
+        const pico_Char *voiceName,
+        const pico_Int16 option,
+        pico_Int32 *outValue
+        )
+{
+    pico_Status status = PICO_OK;
+
+    if (!is_valid_system_handle(system)) {
+        status = PICO_ERR_INVALID_HANDLE;
+    } else if ((voiceName == NULL) || (outValue == NULL)) {
+        status = PICO_ERR_NULLPTR_ACCESS;
+    } else if ((option < 0) || (option >= PICORSRC_NUM_VOPTS)) {
+        status = PICO_ERR_INVALID_ARGUMENT;
+    } else {
+        picoos_emReset(system->common->em);
+        status = picorsrc_getVoiceOption(system->rm,
+                (picoos_char *) voiceName, (picoos_uint8) option, outValue);
+    }
+
+    return status;
+}
+
 #ifdef __cplusplus
 }
 #endif
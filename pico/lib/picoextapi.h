@@ -192,6 +192,248 @@ PICO_FUNC picoext_loadResourceFromMemory(
         pico_Resource *outResource
         );
 
+/* *** Pronunciation cache ****************************************************/
+
+/**
+   Creates a word pronunciation cache for voice definition 'voiceName'.
+   The cache maps words that go through lexicon lookup or G2P (graph or
+   lexicon index plus part of speech) to their final phoneme sequence.
+   It is shared by all engines created for this voice definition
+   afterwards (engines created before keep running without it) and
+   released together with the voice definition.
+
+   Each entry takes about 120 bytes of system memory, 'maxEntries' must
+   be in the range 1..16384.
+*/
+PICO_FUNC picoext_createPronCache(
+        pico_System system,
+        const pico_Char *voiceName,
+        const pico_Uint32 maxEntries
+        );
+
+/* Lets voice definition 'voiceName' of 'system' use the pronunciation
+   cache of voice definition 'ownerVoiceName' of 'ownerSystem', e.g. to
+   share one cache between systems that run in different threads. Both
+   voice definitions must consist of the same resources. The owner's
+   cache stays busy until the sharing voice definition is released. */
+PICO_FUNC picoext_sharePronCache(
+        pico_System ownerSystem,
+        const pico_Char *ownerVoiceName,
+        pico_System system,
+        const pico_Char *voiceName
+        );
+
+/* Releases the pronunciation cache of a voice definition. Fails with
+   PICO_EXC_RESOURCE_BUSY while engines or other systems use the cache. */
+PICO_FUNC picoext_releasePronCache(
+        pico_System system,
+        const pico_Char *voiceName
+        );
+
+/* Adds the entries saved in 'fileName' to the pronunciation cache of a
+   voice definition. Files written for a different set of resources are
+   rejected with PICO_EXC_UNEXPECTED_FILE_TYPE. */
+PICO_FUNC picoext_loadPronCache(
+        pico_System system,
+        const pico_Char *voiceName,
+        const pico_Char *fileName
+        );
+
+/* Saves the pronunciation cache of a voice definition to 'fileName'. */
+PICO_FUNC picoext_savePronCache(
+        pico_System system,
+        const pico_Char *voiceName,
+        const pico_Char *fileName
+        );
+
+/* Returns the number of cached words and the number of cache hits and
+   misses since the cache was created. */
+PICO_FUNC picoext_getPronCacheStats(
+        pico_System system,
+        const pico_Char *voiceName,
+        pico_Uint32 *outNumEntries,
+        pico_Uint32 *outHits,
+        pico_Uint32 *outMisses
+        );
+
+
+/* *** Decision tree cache ****************************************************/
+
+/* Enables (enabled != 0) or disables the decision tree cache of an
+   engine, see picodtcache.h. Fails with PICO_EXC_NAME_UNDEFINED if the
+   library was built without the cache (PICO_USE_DT_CACHE). */
+PICO_FUNC picoext_setDtCacheEnabled(
+        pico_Engine engine,
+        pico_Int16 enabled
+        );
+
+/* Returns the number of decision tree cache hits and misses since the
+   engine was created and the hit rate in percent. */
+PICO_FUNC picoext_getDtCacheStats(
+        pico_Engine engine,
+        pico_Uint32 *outHits,
+        pico_Uint32 *outMisses,
+        pico_Int16 *outHitRate
+        );
+
+
+/* *** Voice options **********************************************************/
+
+/* Options of a voice definition. They are 0 initially and take effect
+   for the engines created afterwards for that voice definition. */
+
+/* how the parameter generation smoothes the MGC coefficient trajectories */
+#define PICOEXT_VOICEOPT_CEP_SOLVER         0
+#define PICOEXT_CEP_SOLVER_SCALAR           0  /* one coefficient at a time */
+#define PICOEXT_CEP_SOLVER_LANES_FIXED      1  /* 8 coefficients in lockstep, same output;
+                                                  needs 1.6MB more system memory per engine
+                                                  (100KB with PICO_USE_CEP_WINDOW) */
+#define PICOEXT_CEP_SOLVER_LANES_FLOAT      2  /* as above in floating point, faster;
+                                                  the output differs slightly */
+
+/* 1: the LFZ and MGC pdfs of the voice are dequantized once into int32
+   tables when the first engine is created with the option, instead of
+   for every frame during synthesis. The tables take 1.6 to 2.2MB of
+   system memory depending on the voice (see picokpdf.h), are shared by
+   all engines using the resource and stay until it is unloaded. Same
+   output. */
+#define PICOEXT_VOICEOPT_PDF_EXPAND         1
+
+/* 1: pause frames (the pause phone, e.g. from punctuation or <break>)
+   are synthesized with zero excitation: the preceding sound decays as
+   usual and is followed by digital silence instead of the low-level
+   noise of the pause model. Once the decay is output, the spectral
+   processing of the signal generation is skipped for the rest of the
+   pause, which saves most of its cost on pause-heavy prompts. */
+#define PICOEXT_VOICEOPT_SIG_SILENCE        2
+
+/* vector kernels of the signal generation (see picosigk.h); all give
+   the same output. Sets that are not compiled in (PICO_USE_SIG_SIMD)
+   or not supported by the CPU fall back to the scalar kernels. */
+#define PICOEXT_VOICEOPT_SIG_KERNELS        3
+#define PICOEXT_SIG_KERNELS_AUTO            0  /* best set supported by the CPU */
+#define PICOEXT_SIG_KERNELS_SCALAR          1  /* reference */
+#define PICOEXT_SIG_KERNELS_SSE41           2
+#define PICOEXT_SIG_KERNELS_AVX2            3
+#define PICOEXT_SIG_KERNELS_NEON            4  /* AArch64 */
+
+/* FFT and cosine transform backend of the signal generation (see
+   picofftsg.h); all give the same output. A backend that is not
+   compiled in (PICO_USE_SIG_SIMD) or not supported by the CPU falls
+   back to the reference. */
+#define PICOEXT_VOICEOPT_SIG_FFT            4
+#define PICOEXT_SIG_FFT_AUTO                0  /* best backend supported by the CPU */
+#define PICOEXT_SIG_FFT_OOURA               1  /* reference */
+#define PICOEXT_SIG_FFT_AVX2                2  /* x86-64 */
+
+/* number of frames the signal generation processes together, 0 or 1
+   (frame by frame) up to PICOEXT_SIG_BATCH_MAX. Each step of the
+   synthesis runs for all frames of a batch before the next one, which
+   keeps its tables in cache, at the price of up to that many frames
+   (4ms each) of additional latency. Same output. Batches need about
+   6KB more engine memory per frame and are not used together with
+   PICOEXT_VOICEOPT_SIG_SILENCE, and with PICO_EMBEDDED_PLATFORM the
+   batch is limited by the SIG output buffer to 7 frames. */
+#define PICOEXT_VOICEOPT_SIG_BATCH          5
+#define PICOEXT_SIG_BATCH_MAX               8
+
+/* sample rate of the output in Hz: 0 or 16000 (the rate of the
+   synthesis), 8000, 22050, 24000 or 48000. Other rates are converted
+   from 16kHz in the signal generation by a polyphase FIR filter (see
+   picosigrs.h), which adds 1ms (8kHz: 2ms) of latency and some 28KB
+   (22.05kHz) or less than 1KB (the others) of engine memory. The
+   output stays 16 bit PCM with at most 32 samples per pico_getData
+   call. */
+#define PICOEXT_VOICEOPT_SIG_RATE           6
+
+/* format of the output: 0 or PICO_DATA_PCM_16BIT, PICO_DATA_ULAW_8BIT,
+   PICO_DATA_ALAW_8BIT, PICO_DATA_IMA_ADPCM_4BIT or PICO_DATA_FLOAT_32BIT
+   (see picodefs.h), returned as 'outDataType' by pico_getData. The
+   samples are encoded in the signal generation as they are produced
+   (see picosigenc.h), at the output rate of PICOEXT_VOICEOPT_SIG_RATE.
+   G.711 gives one byte and IMA ADPCM half a byte per sample; the ADPCM
+   stream starts with predictor and step index 0 when the engine is
+   created or reset. Float gives 4 bytes per sample (at most 16 samples,
+   64 bytes per pico_getData call) with the volume applied and without
+   clipping at 16kHz; resampled to other rates it has been 16 bit in
+   between. Float is not available in fixed point builds. Output saved
+   with the <save> command stays 16 bit PCM, for float it is a float wav
+   file (format 3). */
+#define PICOEXT_VOICEOPT_SIG_FORMAT         7
+
+/* The next three options change the voice in the signal generation,
+   without any additional processing per frame: the pitch scale is
+   folded into the pitch modifier, the formant shift into the
+   mel-to-linear interpolation tables and the noise shaping into the
+   random phase spectrum of the unvoiced excitation. The tables are
+   built when the engine is created (less than 2KB of engine memory).
+   See picoqualityenhance.h for voice profiles on top of them. */
+
+/* pitch scale in percent, 0 or 100 (unchanged) or PICOEXT_SIG_PITCH_MIN
+   to PICOEXT_SIG_PITCH_MAX. It multiplies the <pitch> markup level. */
+#define PICOEXT_VOICEOPT_SIG_PITCH          8
+#define PICOEXT_SIG_PITCH_MIN               50
+#define PICOEXT_SIG_PITCH_MAX               200
+
+/* formant shift in Hz, -PICOEXT_SIG_FORMANT_MAX to PICOEXT_SIG_FORMANT_MAX:
+   the displacement of a formant at 1kHz. The spectral envelope is
+   warped by a first order all-pass (the frequency warping of the
+   mel-cepstrum, so 0Hz and 8kHz stay where they are), e.g. by +150Hz
+   for a higher, shorter vocal tract, -120Hz for a longer one. */
+#define PICOEXT_VOICEOPT_SIG_FORMANT        9
+#define PICOEXT_SIG_FORMANT_MAX             500
+
+/* spectral shaping of the noise excitation of unvoiced sounds and of
+   the unvoiced bands of voiced sounds: eight 4 bit gains, bits 4k to
+   4k+3 for the band around (k + 0.5)kHz, each a signed step of 1.5dB
+   (-8: -12dB to 7: +10.5dB), interpolated linearly in between; 0 is
+   flat (unchanged). picoqualityenhance.h derives the gains from an
+   all-pole noise filter. */
+#define PICOEXT_VOICEOPT_SIG_NOISE          10
+
+/* tempo of the output in percent, 0 or 100 (the tempo of the synthesis)
+   or 101 to PICOEXT_SIG_TEMPO_MAX. The synthesized speech is time scaled
+   in the signal generation (WSOLA, see picosigts.h) without changing the
+   pitch, pauses included; <speed> markup still applies to the synthesis
+   before. Every frame is synthesized all the same, so this is slower
+   than the same tempo by <speed> markup, which shortens the predicted
+   durations instead; it is exact and leaves the phone durations in
+   proportion. It adds up to 28ms of latency and some 2.7KB of engine
+   memory. */
+#define PICOEXT_VOICEOPT_SIG_TEMPO          11
+#define PICOEXT_SIG_TEMPO_MAX               400
+
+/* math profile of the signal generation: the exponentials of the
+   envelope amplitude of every spectral bin and of the pitch of every
+   frame. The default is the approximation the engine has always used
+   (for the amplitudes and the unvoiced pitch a relative error up to 4%).
+   PRECISE evaluates them by libm (fixed point: 2e-6). FAST takes the
+   amplitudes from a cubic polynomial in 32 bit integers, vectorized with
+   the SIG kernels (relative error below 2.5e-4, see pico_fix_exp_fast),
+   and the pitch as PRECISE. The phases come from tables in all profiles.
+   picobench fastmath compares them. */
+#define PICOEXT_VOICEOPT_SIG_MATH           12
+#define PICOEXT_SIG_MATH_DEFAULT            0
+#define PICOEXT_SIG_MATH_PRECISE            1
+#define PICOEXT_SIG_MATH_FAST               2
+
+/* Sets option 'option' of voice definition 'voiceName' to 'value'. Fails
+   with PICO_ERR_INVALID_ARGUMENT for unknown options or values. */
+PICO_FUNC picoext_setVoiceOption(
+        pico_System system,
+        const pico_Char *voiceName,
+        const pico_Int16 option,
+        const pico_Int32 value
+        );
+
+/* Returns the value of option 'option' of voice definition 'voiceName'. */
+PICO_FUNC picoext_getVoiceOption(
+        pico_System system,
+        const pico_Char *voiceName,
+        const pico_Int16 option,
+        pico_Int32 *outValue
+        );
+
 #ifdef __cplusplus
 }
 #endif
@@ -30,6 +30,12 @@
 #include "picofftsg.h"
 #include "picodbg.h"
 
+#if defined(PICO_USE_SIG_SIMD) && (defined(__GNUC__) || defined(__clang__)) \
+    && defined(__x86_64__)
+#define PICOFFTSG_X86_AVX2 1
+#include <immintrin.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -462,7 +468,7 @@ void rdft(picoos_int32 n, picoos_int32 isgn, PICOFFTSG_FFTTYPE *a)
 }
 
 
-picoos_single norm_result(picoos_int32 m2, PICOFFTSG_FFTTYPE *tmpX, PICOFFTSG_FFTTYPE *norm_window)
+pico_param_t norm_result(picoos_int32 m2, PICOFFTSG_FFTTYPE *tmpX, const PICOFFTSG_FFTTYPE *norm_window)
 {
     picoos_int16 nI;
     PICOFFTSG_FFTTYPE a,b, E;
@@ -476,10 +482,15 @@ picoos_single norm_result(picoos_int32 m2, PICOFFTSG_FFTTYPE *tmpX, PICOFFTSG_FF
     }
 
     if (E>0) {
+#if defined(PICO_FIXED_POINT_ENABLED)
+        /* sqrt(E/16) in Q12 */
+        return (pico_param_t)(pico_fix_sqrt64((uint64_t)E << 20)/m2);
+#else
         return (picoos_single)sqrt((double)E/16.0)/m2;
+#endif
     }
     else {
-        return 0.0;
+        return 0;
     }
 }
 
@@ -3269,6 +3280,767 @@ void dctsub4(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
     a[m] = Mult_W_W(wki, a[m]);
 }
 
+
+/* ***********************************************************************************************/
+/* FFT backends */
+/* ***********************************************************************************************/
+
+static const picofftsg_backend_t fftsgOoura = {
+    "ooura",
+    rdft,
+    dfct_nmf
+};
+
+#if defined(PICOFFTSG_X86_AVX2)
+
+/*
+  AVX2 backend
+
+  rdft(256, -1, a) and dfct_nmf(128, a) are split into the passes of the
+  Ooura routines, and every value is computed by the same integer expression
+  as there: the passes only change the order in which independent butterflies
+  are done. Complex vectors hold 4 values as (re, im) pairs; the 8-point
+  leaves are done on 8 blocks at once after a transpose.
+
+  The twiddle factors that the routines compute by recurrence are taken from
+  tables with the exact values of the recurrences, shifted right by 15 like
+  the first operand of Mult_W_W. For a complex x the tables c and s give
+  c * x + s * (x.i, x.r), s holds the signs. Positions where the routines
+  multiply differently (or not at all) are done in scalar and have zero
+  entries. The tables are constant and shared by all engines.
+ */
+
+/* rftbsub(256): positions p = 2..129, index p - 2 */
+static const PICOFFTSG_FFTTYPE fftsgRftbsub256W[2][128] = {
+    {
+        7987, 7987, 7787, 7787, 7586, 7586, 7386, 7386,
+        7186, 7186, 6987, 6987, 6788, 6788, 6591, 6591,
+        6394, 6394, 6198, 6198, 6004, 6004, 5811, 5811,
+        5619, 5619, 5429, 5429, 5241, 5241, 5054, 5054,
+        4870, 4870, 4687, 4687, 4506, 4506, 4328, 4328,
+        4152, 4152, 3978, 3978, 3807, 3807, 3639, 3639,
+        3473, 3473, 3310, 3310, 3150, 3150, 2993, 2993,
+        2839, 2839, 2689, 2689, 2542, 2542, 2398, 2398,
+        2257, 2257, 2121, 2121, 1987, 1987, 1858, 1858,
+        1732, 1732, 1611, 1611, 1493, 1493, 1379, 1379,
+        1270, 1270, 1164, 1164, 1063, 1063, 966, 966,
+        874, 874, 786, 786, 702, 702, 623, 623,
+        548, 548, 478, 478, 413, 413, 352, 352,
+        296, 296, 245, 245, 198, 198, 157, 157,
+        120, 120, 88, 88, 61, 61, 39, 39,
+        22, 22, 9, 9, 2, 2, 0, 0
+    },
+    {
+        8189, -8189, 8182, -8182, 8169, -8169, 8152, -8152,
+        8130, -8130, 8102, -8102, 8070, -8070, 8034, -8034,
+        7992, -7992, 7945, -7945, 7894, -7894, 7838, -7838,
+        7777, -7777, 7712, -7712, 7642, -7642, 7567, -7567,
+        7488, -7488, 7404, -7404, 7316, -7316, 7223, -7223,
+        7126, -7126, 7025, -7025, 6920, -6920, 6810, -6810,
+        6696, -6696, 6578, -6578, 6457, -6457, 6331, -6331,
+        6202, -6202, 6068, -6068, 5931, -5931, 5791, -5791,
+        5647, -5647, 5500, -5500, 5349, -5349, 5195, -5195,
+        5039, -5039, 4878, -4878, 4716, -4716, 4550, -4550,
+        4381, -4381, 4210, -4210, 4036, -4036, 3860, -3860,
+        3682, -3682, 3501, -3501, 3319, -3319, 3134, -3134,
+        2947, -2947, 2759, -2759, 2569, -2569, 2377, -2377,
+        2184, -2184, 1990, -1990, 1794, -1794, 1597, -1597,
+        1400, -1400, 1201, -1201, 1002, -1002, 802, -802,
+        602, -602, 401, -401, 201, -201, 0, 0
+    }
+};
+
+/* cftb1st(256): c1, s1, c3, s3 of the positions j = 0..63 */
+static const PICOFFTSG_FFTTYPE fftsgCftb1st256W[4][64] = {
+    {
+        0, 0, 16364, 16364, 16305, 16305, 16206, 16206,
+        16069, 16069, 15893, 15893, 15679, 15679, 15427, 15427,
+        15138, 15138, 14812, 14812, 14451, 14451, 14055, 14055,
+        13625, 13625, 13163, 13163, 12668, 12668, 12144, 12144,
+        0, 0, 10998, 10998, 10389, 10389, 9755, 9755,
+        9098, 9098, 8419, 8419, 7719, 7719, 7001, 7001,
+        6266, 6266, 5517, 5517, 4753, 4753, 3979, 3979,
+        3194, 3194, 2403, 2403, 1605, 1605, 803, 803
+    },
+    {
+        0, 0, -803, 803, -1605, 1605, -2403, 2403,
+        -3194, 3194, -3979, 3979, -4753, 4753, -5517, 5517,
+        -6266, 6266, -7001, 7001, -7719, 7719, -8419, 8419,
+        -9098, 9098, -9755, 9755, -10389, 10389, -10998, 10998,
+        0, 0, -12144, 12144, -12668, 12668, -13163, 13163,
+        -13625, 13625, -14055, 14055, -14451, 14451, -14812, 14812,
+        -15138, 15138, -15427, 15427, -15679, 15679, -15893, 15893,
+        -16069, 16069, -16206, 16206, -16305, 16305, -16364, 16364
+    },
+    {
+        0, 0, 16206, 16206, 15678, 15678, 14811, 14811,
+        13623, 13623, 12140, 12140, 10394, 10394, 8423, 8423,
+        6270, 6270, 3981, 3981, 1606, 1606, -803, -803,
+        -3195, -3195, -5518, -5518, -7722, -7722, -9759, -9759,
+        0, 0, -13160, -13160, -14450, -14450, -15426, -15426,
+        -16069, -16069, -16364, -16364, -16305, -16305, -15892, -15892,
+        -15136, -15136, -14052, -14052, -12664, -12664, -11002, -11002,
+        -9102, -9102, -7004, -7004, -4755, -4755, -2404, -2404
+    },
+    {
+        0, 0, -2404, 2404, -4755, 4755, -7004, 7004,
+        -9102, 9102, -11002, 11002, -12664, 12664, -14052, 14052,
+        -15136, 15136, -15892, 15892, -16305, 16305, -16364, 16364,
+        -16069, 16069, -15426, 15426, -14450, 14450, -13160, 13160,
+        0, 0, -9759, 9759, -7722, 7722, -5518, 5518,
+        -3195, 3195, -803, 803, 1606, -1606, 3981, -3981,
+        6270, -6270, 8423, -8423, 10394, -10394, 12140, -12140,
+        13623, -13623, 14811, -14811, 15678, -15678, 16206, -16206
+    }
+};
+
+/* cftmdl1(64): c1, s1, c3, s3 of the positions j = 0..15 */
+static const PICOFFTSG_FFTTYPE fftsgCftmdl1W[4][16] = {
+    {
+        0, 0, 16069, 16069, 15137, 15137, 13623, 13623,
+        0, 0, 9101, 9101, 6269, 6269, 3196, 3196
+    },
+    {
+        0, 0, -3196, 3196, -6269, 6269, -9101, 9101,
+        0, 0, -13623, 13623, -15137, 15137, -16069, 16069
+    },
+    {
+        0, 0, 13622, 13622, 6270, 6270, -3194, -3194,
+        0, 0, -16069, -16069, -15135, -15135, -9102, -9102
+    },
+    {
+        0, 0, -9102, 9102, -15135, 15135, -16069, 16069,
+        0, 0, -3194, 3194, 6270, -6270, 13622, -13622
+    }
+};
+
+/* cftmdl2(64): c0, s0, c1, s1, c2, s2, c3, s3 of the positions j = 0..15 */
+static const PICOFFTSG_FFTTYPE fftsgCftmdl2W[8][16] = {
+    {
+        0, 0, 16305, 16305, 16069, 16069, 15678, 15678,
+        15136, 15136, 14449, 14449, 13622, 13622, 12665, 12665
+    },
+    {
+        0, 0, -1605, 1605, -3195, 3195, -4755, 4755,
+        -6269, 6269, -7724, 7724, -9103, 9103, -10393, 10393
+    },
+    {
+        0, 0, 15678, 15678, 13622, 13622, 10394, 10394,
+        6269, 6269, 1605, 1605, -3196, -3196, -7723, -7723
+    },
+    {
+        0, 0, -4756, 4756, -9102, 9102, -12664, 12664,
+        -15136, 15136, -16305, 16305, -16068, 16068, -14449, 14449
+    },
+    {
+        0, 0, 10393, 10393, 9103, 9103, 7724, 7724,
+        6269, 6269, 4755, 4755, 3195, 3195, 1605, 1605
+    },
+    {
+        0, 0, -12665, 12665, -13622, 13622, -14449, 14449,
+        -15136, 15136, -15678, 15678, -16069, 16069, -16305, 16305
+    },
+    {
+        0, 0, -14449, -14449, -16068, -16068, -16305, -16305,
+        -15136, -15136, -12664, -12664, -9102, -9102, -4756, -4756
+    },
+    {
+        0, 0, -7723, 7723, -3196, 3196, 1605, -1605,
+        6269, -6269, 10394, -10394, 13622, -13622, 15678, -15678
+    }
+};
+
+/* dctsub(64): the factors of a[p] and a[64 - p], p = 1..32, index p - 1 */
+static const PICOFFTSG_FFTTYPE fftsgDctsub64W[2][32] = {
+    {
+        8390, 8583, 8772, 8955, 9133, 9305, 9471, 9632,
+        9787, 9936, 10079, 10216, 10347, 10472, 10590, 10702,
+        10808, 10907, 11000, 11085, 11165, 11237, 11303, 11362,
+        11414, 11459, 11497, 11529, 11553, 11571, 11581, 0
+    },
+    {
+        7988, 7780, 7567, 7349, 7127, 6901, 6671, 6436,
+        6198, 5956, 5710, 5461, 5209, 4954, 4695, 4434,
+        4170, 3904, 3635, 3364, 3091, 2816, 2539, 2261,
+        1982, 1701, 1419, 1137, 854, 570, 286, 0
+    }
+};
+
+/* rftfsub(64): positions p = 2..33, index p - 2 */
+static const PICOFFTSG_FFTTYPE fftsgRftfsub64W[2][32] = {
+    {
+        7385, 7385, 6590, 6590, 5811, 5811, 5054, 5054,
+        4328, 4328, 3638, 3638, 2993, 2993, 2398, 2398,
+        1858, 1858, 1379, 1379, 966, 966, 623, 623,
+        352, 352, 157, 157, 39, 39, 0, 0
+    },
+    {
+        -8152, 8152, -8033, 8033, -7838, 7838, -7567, 7567,
+        -7223, 7223, -6810, 6810, -6331, 6331, -5791, 5791,
+        -5195, 5195, -4550, 4550, -3860, 3860, -3134, 3134,
+        -2377, 2377, -1597, 1597, -802, 802, 0, 0
+    }
+};
+
+/* 7 bit reversal */
+static const picoos_uint8 fftsgBitrv128[128] = {
+    0, 64, 32, 96, 16, 80, 48, 112, 8, 72, 40, 104, 24, 88, 56, 120,
+    4, 68, 36, 100, 20, 84, 52, 116, 12, 76, 44, 108, 28, 92, 60, 124,
+    2, 66, 34, 98, 18, 82, 50, 114, 10, 74, 42, 106, 26, 90, 58, 122,
+    6, 70, 38, 102, 22, 86, 54, 118, 14, 78, 46, 110, 30, 94, 62, 126,
+    1, 65, 33, 97, 17, 81, 49, 113, 9, 73, 41, 105, 25, 89, 57, 121,
+    5, 69, 37, 101, 21, 85, 53, 117, 13, 77, 45, 109, 29, 93, 61, 125,
+    3, 67, 35, 99, 19, 83, 51, 115, 11, 75, 43, 107, 27, 91, 59, 123,
+    7, 71, 39, 103, 23, 87, 55, 119, 15, 79, 47, 111, 31, 95, 63, 127
+};
+
+#define FFTSG_AVX2 __attribute__((target("avx2")))
+
+#define FFTSG_LOAD(p)       _mm256_loadu_si256((const __m256i *)(p))
+#define FFTSG_STORE(p, v)   _mm256_storeu_si256((__m256i *)(p), (v))
+#define FFTSG_ADD(x, y)     _mm256_add_epi32((x), (y))
+#define FFTSG_SUB(x, y)     _mm256_sub_epi32((x), (y))
+#define FFTSG_MWW(w, x)     _mm256_mullo_epi32((w), fftsgSm14Avx2(x))
+
+/* the data operand of Mult_W_W: sign(x) * (|x| >> 14) */
+FFTSG_AVX2 static __m256i fftsgSm14Avx2(__m256i x)
+{
+    return _mm256_sign_epi32(_mm256_srai_epi32(_mm256_abs_epi32(x), 14), x);
+}
+
+/* complex product of x with the twiddle factors at c and s */
+FFTSG_AVX2 static __m256i fftsgTwiddleAvx2(__m256i x, const PICOFFTSG_FFTTYPE *c,
+        const PICOFFTSG_FFTTYPE *s)
+{
+    x = fftsgSm14Avx2(x);
+    return _mm256_add_epi32(_mm256_mullo_epi32(FFTSG_LOAD(c), x),
+            _mm256_mullo_epi32(FFTSG_LOAD(s), _mm256_shuffle_epi32(x, 0xb1)));
+}
+
+/* exchanges the values (step 1) or the complex values (step 2) at bit
+   reversed positions of a[0..n*step-1], n = 2^k <= 128 */
+static void fftsgBitrv(PICOFFTSG_FFTTYPE *a, picoos_int32 n, picoos_int32 step)
+{
+    picoos_int32 i, k, s;
+    PICOFFTSG_FFTTYPE x;
+
+    for (s = 0; (128 >> s) > n; s++) {
+    }
+    for (i = 0; i < n; i++) {
+        k = fftsgBitrv128[i] >> s;
+        if (i < k) {
+            x = a[i * step];
+            a[i * step] = a[k * step];
+            a[k * step] = x;
+            if (2 == step) {
+                x = a[i * 2 + 1];
+                a[i * 2 + 1] = a[k * 2 + 1];
+                a[k * 2 + 1] = x;
+            }
+        }
+    }
+}
+
+/* rftbsub(256, a) or rftfsub(64, a) with their tables: the complex values at
+   p and n - p, p = 2..n/2 - 2; p = n/2 is paired with itself with zero
+   twiddle factors and stays unchanged */
+FFTSG_AVX2 static void fftsgRftsubAvx2(picoos_int32 n, PICOFFTSG_FFTTYPE *a,
+        const PICOFFTSG_FFTTYPE *c, const PICOFFTSG_FFTTYPE *s)
+{
+    const __m256i cj = _mm256_setr_epi32(1, -1, 1, -1, 1, -1, 1, -1);
+    __m256i p, q, y;
+    picoos_int32 j;
+
+    for (j = 2; j < (n >> 1); j += 8) {
+        p = FFTSG_LOAD(a + j);
+        q = _mm256_permute4x64_epi64(FFTSG_LOAD(a + n - 6 - j), 0x1b);
+        y = fftsgTwiddleAvx2(FFTSG_SUB(p, _mm256_sign_epi32(q, cj)),
+                c + j - 2, s + j - 2);
+        FFTSG_STORE(a + j, FFTSG_SUB(p, y));
+        FFTSG_STORE(a + n - 6 - j, _mm256_permute4x64_epi64(
+                FFTSG_ADD(q, _mm256_sign_epi32(y, cj)), 0x1b));
+    }
+}
+
+/* position j (0 or m/2) of fftsgCftmdl1Avx2 from its input x[0..7] */
+static void fftsgCftmdl1Pos(PICOFFTSG_FFTTYPE *a, picoos_int32 m,
+        picoos_int32 j, const PICOFFTSG_FFTTYPE *x)
+{
+    PICOFFTSG_FFTTYPE x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+
+    x0r = x[0] + x[4];
+    x0i = x[1] + x[5];
+    x1r = x[0] - x[4];
+    x1i = x[1] - x[5];
+    x2r = x[2] + x[6];
+    x2i = x[3] + x[7];
+    x3r = x[2] - x[6];
+    x3i = x[3] - x[7];
+    a[j] = x0r + x2r;
+    a[j + 1] = x0i + x2i;
+    a[j + m] = x0r - x2r;
+    a[j + m + 1] = x0i - x2i;
+    x0r = x1r - x3i;
+    x0i = x1i + x3r;
+    x2r = x1r + x3i;
+    x2i = x1i - x3r;
+    if (0 == j) {
+        a[2 * m] = x0r;
+        a[2 * m + 1] = x0i;
+        a[3 * m] = x2r;
+        a[3 * m + 1] = x2i;
+    } else {
+        a[j + 2 * m] = Mult_W_W(WR5000, (x0r - x0i));
+        a[j + 2 * m + 1] = Mult_W_W(WR5000, (x0i + x0r));
+        a[j + 3 * m] = -Mult_W_W(WR5000, (x2r + x2i));
+        a[j + 3 * m + 1] = -Mult_W_W(WR5000, (x2i - x2r));
+    }
+}
+
+/* cftmdl1 on the quarters of m values of a[0..4m-1] with the tables w (c1,
+   s1, c3, s3 of m values each); with conj the same on the complex conjugate
+   of the input, which is cftb1st */
+FFTSG_AVX2 static void fftsgCftmdl1Avx2(PICOFFTSG_FFTTYPE *a, picoos_int32 m,
+        const PICOFFTSG_FFTTYPE *w, picoos_int32 conj)
+{
+    const __m256i cj = conj ? _mm256_setr_epi32(1, -1, 1, -1, 1, -1, 1, -1)
+            : _mm256_set1_epi32(1);
+    const __m256i ni = _mm256_setr_epi32(-1, 1, -1, 1, -1, 1, -1, 1);
+    PICOFFTSG_FFTTYPE x[2][8];
+    __m256i x0, x1, x2, x3;
+    picoos_int32 i, j;
+
+    for (i = 0; i < 2; i++) {
+        for (j = 0; j < 4; j++) {
+            x[i][2 * j] = a[j * m + i * (m >> 1)];
+            x[i][2 * j + 1] = conj ? -a[j * m + i * (m >> 1) + 1]
+                    : a[j * m + i * (m >> 1) + 1];
+        }
+    }
+    for (j = 0; j < m; j += 8) {
+        x0 = _mm256_sign_epi32(FFTSG_LOAD(a + j), cj);
+        x2 = _mm256_sign_epi32(FFTSG_LOAD(a + 2 * m + j), cj);
+        x1 = FFTSG_SUB(x0, x2);
+        x0 = FFTSG_ADD(x0, x2);
+        x2 = _mm256_sign_epi32(FFTSG_LOAD(a + m + j), cj);
+        x3 = _mm256_sign_epi32(FFTSG_LOAD(a + 3 * m + j), cj);
+        x3 = _mm256_sign_epi32(_mm256_shuffle_epi32(FFTSG_SUB(x2, x3), 0xb1), ni);
+        x2 = FFTSG_ADD(x2, _mm256_sign_epi32(FFTSG_LOAD(a + 3 * m + j), cj));
+        FFTSG_STORE(a + j, FFTSG_ADD(x0, x2));
+        FFTSG_STORE(a + m + j, FFTSG_SUB(x0, x2));
+        FFTSG_STORE(a + 2 * m + j, fftsgTwiddleAvx2(FFTSG_ADD(x1, x3),
+                w + j, w + m + j));
+        FFTSG_STORE(a + 3 * m + j, fftsgTwiddleAvx2(FFTSG_SUB(x1, x3),
+                w + 2 * m + j, w + 3 * m + j));
+    }
+    fftsgCftmdl1Pos(a, m, 0, x[0]);
+    fftsgCftmdl1Pos(a, m, m >> 1, x[1]);
+}
+
+/* cftmdl2(64, a) with fftsgCftmdl2W; position 0 in scalar */
+FFTSG_AVX2 static void fftsgCftmdl2Avx2(PICOFFTSG_FFTTYPE *a)
+{
+    const __m256i ni = _mm256_setr_epi32(-1, 1, -1, 1, -1, 1, -1, 1);
+    const PICOFFTSG_FFTTYPE (*w)[16] = fftsgCftmdl2W;
+    PICOFFTSG_FFTTYPE x[8], x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i, y0r, y0i;
+    __m256i a0, a1, a2, a3, y0, y2;
+    picoos_int32 j;
+
+    for (j = 0; j < 4; j++) {
+        x[2 * j] = a[16 * j];
+        x[2 * j + 1] = a[16 * j + 1];
+    }
+    for (j = 0; j < 16; j += 8) {
+        a0 = FFTSG_LOAD(a + j);
+        a1 = FFTSG_LOAD(a + 16 + j);
+        a2 = _mm256_sign_epi32(_mm256_shuffle_epi32(FFTSG_LOAD(a + 32 + j), 0xb1), ni);
+        a3 = _mm256_sign_epi32(_mm256_shuffle_epi32(FFTSG_LOAD(a + 48 + j), 0xb1), ni);
+        y0 = fftsgTwiddleAvx2(FFTSG_ADD(a0, a2), w[0] + j, w[1] + j);
+        y2 = fftsgTwiddleAvx2(FFTSG_ADD(a1, a3), w[4] + j, w[5] + j);
+        FFTSG_STORE(a + j, FFTSG_ADD(y0, y2));
+        FFTSG_STORE(a + 16 + j, FFTSG_SUB(y0, y2));
+        y0 = fftsgTwiddleAvx2(FFTSG_SUB(a0, a2), w[2] + j, w[3] + j);
+        y2 = fftsgTwiddleAvx2(FFTSG_SUB(a1, a3), w[6] + j, w[7] + j);
+        FFTSG_STORE(a + 32 + j, FFTSG_ADD(y0, y2));
+        FFTSG_STORE(a + 48 + j, FFTSG_SUB(y0, y2));
+    }
+    x0r = x[0] - x[5];
+    x0i = x[1] + x[4];
+    x1r = x[0] + x[5];
+    x1i = x[1] - x[4];
+    x2r = x[2] - x[7];
+    x2i = x[3] + x[6];
+    x3r = x[2] + x[7];
+    x3i = x[3] - x[6];
+    y0r = Mult_W_W(WR5000, (x2r - x2i));
+    y0i = Mult_W_W(WR5000, (x2i + x2r));
+    a[0] = x0r + y0r;
+    a[1] = x0i + y0i;
+    a[16] = x0r - y0r;
+    a[17] = x0i - y0i;
+    y0r = Mult_W_W(WR5000, (x3r - x3i));
+    y0i = Mult_W_W(WR5000, (x3i + x3r));
+    a[32] = x1r - y0i;
+    a[33] = x1i + y0r;
+    a[48] = x1r + y0i;
+    a[49] = x1i - y0r;
+}
+
+/* in place transpose of the 8x8 matrix r[0..7] */
+FFTSG_AVX2 static void fftsgTransposeAvx2(__m256i *r)
+{
+    __m256i t[8], u[8];
+    picoos_int32 i;
+
+    for (i = 0; i < 8; i += 2) {
+        t[i] = _mm256_unpacklo_epi32(r[i], r[i + 1]);
+        t[i + 1] = _mm256_unpackhi_epi32(r[i], r[i + 1]);
+    }
+    for (i = 0; i < 8; i += 4) {
+        u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+        u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+        u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+        u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+    }
+    for (i = 0; i < 4; i++) {
+        r[i] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+        r[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+    }
+}
+
+/* v[i] = value i of the 16-value blocks a + b[0..nb-1], nb <= 8, one block
+   per lane (zero for missing blocks), and back */
+FFTSG_AVX2 static void fftsgLoadLeavesAvx2(const PICOFFTSG_FFTTYPE *a,
+        const picoos_uint8 *b, picoos_int32 nb, __m256i *v)
+{
+    picoos_int32 i;
+
+    for (i = 0; i < 8; i++) {
+        v[i] = (i < nb) ? FFTSG_LOAD(a + b[i]) : _mm256_setzero_si256();
+        v[i + 8] = (i < nb) ? FFTSG_LOAD(a + b[i] + 8) : _mm256_setzero_si256();
+    }
+    fftsgTransposeAvx2(v);
+    fftsgTransposeAvx2(v + 8);
+}
+
+FFTSG_AVX2 static void fftsgStoreLeavesAvx2(PICOFFTSG_FFTTYPE *a,
+        const picoos_uint8 *b, picoos_int32 nb, __m256i *v)
+{
+    picoos_int32 i;
+
+    fftsgTransposeAvx2(v);
+    fftsgTransposeAvx2(v + 8);
+    for (i = 0; i < nb; i++) {
+        FFTSG_STORE(a + b[i], v[i]);
+        FFTSG_STORE(a + b[i] + 8, v[i + 8]);
+    }
+}
+
+/* cftf081 on the blocks a + b[0..nb-1] */
+FFTSG_AVX2 static void fftsgCftf081Avx2(PICOFFTSG_FFTTYPE *a,
+        const picoos_uint8 *b, picoos_int32 nb)
+{
+    const __m256i wn4r = _mm256_set1_epi32(WR5000 >> 15);
+    __m256i v[16], x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i,
+        y0r, y0i, y1r, y1i, y2r, y2i, y3r, y3i,
+        y4r, y4i, y5r, y5i, y6r, y6i, y7r, y7i;
+
+    fftsgLoadLeavesAvx2(a, b, nb, v);
+    x0r = FFTSG_ADD(v[0], v[8]);
+    x0i = FFTSG_ADD(v[1], v[9]);
+    x1r = FFTSG_SUB(v[0], v[8]);
+    x1i = FFTSG_SUB(v[1], v[9]);
+    x2r = FFTSG_ADD(v[4], v[12]);
+    x2i = FFTSG_ADD(v[5], v[13]);
+    x3r = FFTSG_SUB(v[4], v[12]);
+    x3i = FFTSG_SUB(v[5], v[13]);
+    y0r = FFTSG_ADD(x0r, x2r);
+    y0i = FFTSG_ADD(x0i, x2i);
+    y2r = FFTSG_SUB(x0r, x2r);
+    y2i = FFTSG_SUB(x0i, x2i);
+    y1r = FFTSG_SUB(x1r, x3i);
+    y1i = FFTSG_ADD(x1i, x3r);
+    y3r = FFTSG_ADD(x1r, x3i);
+    y3i = FFTSG_SUB(x1i, x3r);
+    x0r = FFTSG_ADD(v[2], v[10]);
+    x0i = FFTSG_ADD(v[3], v[11]);
+    x1r = FFTSG_SUB(v[2], v[10]);
+    x1i = FFTSG_SUB(v[3], v[11]);
+    x2r = FFTSG_ADD(v[6], v[14]);
+    x2i = FFTSG_ADD(v[7], v[15]);
+    x3r = FFTSG_SUB(v[6], v[14]);
+    x3i = FFTSG_SUB(v[7], v[15]);
+    y4r = FFTSG_ADD(x0r, x2r);
+    y4i = FFTSG_ADD(x0i, x2i);
+    y6r = FFTSG_SUB(x0r, x2r);
+    y6i = FFTSG_SUB(x0i, x2i);
+    x0r = FFTSG_SUB(x1r, x3i);
+    x0i = FFTSG_ADD(x1i, x3r);
+    x2r = FFTSG_ADD(x1r, x3i);
+    x2i = FFTSG_SUB(x1i, x3r);
+    y5r = FFTSG_MWW(wn4r, FFTSG_SUB(x0r, x0i));
+    y5i = FFTSG_MWW(wn4r, FFTSG_ADD(x0r, x0i));
+    y7r = FFTSG_MWW(wn4r, FFTSG_SUB(x2r, x2i));
+    y7i = FFTSG_MWW(wn4r, FFTSG_ADD(x2r, x2i));
+    v[8] = FFTSG_ADD(y1r, y5r);
+    v[9] = FFTSG_ADD(y1i, y5i);
+    v[10] = FFTSG_SUB(y1r, y5r);
+    v[11] = FFTSG_SUB(y1i, y5i);
+    v[12] = FFTSG_SUB(y3r, y7i);
+    v[13] = FFTSG_ADD(y3i, y7r);
+    v[14] = FFTSG_ADD(y3r, y7i);
+    v[15] = FFTSG_SUB(y3i, y7r);
+    v[0] = FFTSG_ADD(y0r, y4r);
+    v[1] = FFTSG_ADD(y0i, y4i);
+    v[2] = FFTSG_SUB(y0r, y4r);
+    v[3] = FFTSG_SUB(y0i, y4i);
+    v[4] = FFTSG_SUB(y2r, y6i);
+    v[5] = FFTSG_ADD(y2i, y6r);
+    v[6] = FFTSG_ADD(y2r, y6i);
+    v[7] = FFTSG_SUB(y2i, y6r);
+    fftsgStoreLeavesAvx2(a, b, nb, v);
+}
+
+/* cftf082 on the blocks a + b[0..nb-1] */
+FFTSG_AVX2 static void fftsgCftf082Avx2(PICOFFTSG_FFTTYPE *a,
+        const picoos_uint8 *b, picoos_int32 nb)
+{
+    const __m256i wn4r = _mm256_set1_epi32(WR5000 >> 15);
+    const __m256i wk1r = _mm256_set1_epi32(WR2500 >> 15);
+    const __m256i wk1i = _mm256_set1_epi32(WI2500 >> 15);
+    __m256i v[16], x0r, x0i, x1r, x1i,
+        y0r, y0i, y1r, y1i, y2r, y2i, y3r, y3i,
+        y4r, y4i, y5r, y5i, y6r, y6i, y7r, y7i;
+
+    fftsgLoadLeavesAvx2(a, b, nb, v);
+    y0r = FFTSG_SUB(v[0], v[9]);
+    y0i = FFTSG_ADD(v[1], v[8]);
+    y1r = FFTSG_ADD(v[0], v[9]);
+    y1i = FFTSG_SUB(v[1], v[8]);
+    x0r = FFTSG_SUB(v[4], v[13]);
+    x0i = FFTSG_ADD(v[5], v[12]);
+    y2r = FFTSG_MWW(wn4r, FFTSG_SUB(x0r, x0i));
+    y2i = FFTSG_MWW(wn4r, FFTSG_ADD(x0i, x0r));
+    x0r = FFTSG_ADD(v[4], v[13]);
+    x0i = FFTSG_SUB(v[5], v[12]);
+    y3r = FFTSG_MWW(wn4r, FFTSG_SUB(x0r, x0i));
+    y3i = FFTSG_MWW(wn4r, FFTSG_ADD(x0i, x0r));
+    x0r = FFTSG_SUB(v[2], v[11]);
+    x0i = FFTSG_ADD(v[3], v[10]);
+    y4r = FFTSG_SUB(FFTSG_MWW(wk1r, x0r), FFTSG_MWW(wk1i, x0i));
+    y4i = FFTSG_ADD(FFTSG_MWW(wk1r, x0i), FFTSG_MWW(wk1i, x0r));
+    x0r = FFTSG_ADD(v[2], v[11]);
+    x0i = FFTSG_SUB(v[3], v[10]);
+    y5r = FFTSG_SUB(FFTSG_MWW(wk1i, x0r), FFTSG_MWW(wk1r, x0i));
+    y5i = FFTSG_ADD(FFTSG_MWW(wk1i, x0i), FFTSG_MWW(wk1r, x0r));
+    x0r = FFTSG_SUB(v[6], v[15]);
+    x0i = FFTSG_ADD(v[7], v[14]);
+    y6r = FFTSG_SUB(FFTSG_MWW(wk1i, x0r), FFTSG_MWW(wk1r, x0i));
+    y6i = FFTSG_ADD(FFTSG_MWW(wk1i, x0i), FFTSG_MWW(wk1r, x0r));
+    x0r = FFTSG_ADD(v[6], v[15]);
+    x0i = FFTSG_SUB(v[7], v[14]);
+    y7r = FFTSG_SUB(FFTSG_MWW(wk1r, x0r), FFTSG_MWW(wk1i, x0i));
+    y7i = FFTSG_ADD(FFTSG_MWW(wk1r, x0i), FFTSG_MWW(wk1i, x0r));
+    x0r = FFTSG_ADD(y0r, y2r);
+    x0i = FFTSG_ADD(y0i, y2i);
+    x1r = FFTSG_ADD(y4r, y6r);
+    x1i = FFTSG_ADD(y4i, y6i);
+    v[0] = FFTSG_ADD(x0r, x1r);
+    v[1] = FFTSG_ADD(x0i, x1i);
+    v[2] = FFTSG_SUB(x0r, x1r);
+    v[3] = FFTSG_SUB(x0i, x1i);
+    x0r = FFTSG_SUB(y0r, y2r);
+    x0i = FFTSG_SUB(y0i, y2i);
+    x1r = FFTSG_SUB(y4r, y6r);
+    x1i = FFTSG_SUB(y4i, y6i);
+    v[4] = FFTSG_SUB(x0r, x1i);
+    v[5] = FFTSG_ADD(x0i, x1r);
+    v[6] = FFTSG_ADD(x0r, x1i);
+    v[7] = FFTSG_SUB(x0i, x1r);
+    x0r = FFTSG_SUB(y1r, y3i);
+    x0i = FFTSG_ADD(y1i, y3r);
+    x1r = FFTSG_SUB(y5r, y7r);
+    x1i = FFTSG_SUB(y5i, y7i);
+    v[8] = FFTSG_ADD(x0r, x1r);
+    v[9] = FFTSG_ADD(x0i, x1i);
+    v[10] = FFTSG_SUB(x0r, x1r);
+    v[11] = FFTSG_SUB(x0i, x1i);
+    x0r = FFTSG_ADD(y1r, y3i);
+    x0i = FFTSG_SUB(y1i, y3r);
+    x1r = FFTSG_ADD(y5r, y7r);
+    x1i = FFTSG_ADD(y5i, y7i);
+    v[12] = FFTSG_SUB(x0r, x1i);
+    v[13] = FFTSG_ADD(x0i, x1r);
+    v[14] = FFTSG_ADD(x0r, x1i);
+    v[15] = FFTSG_SUB(x0i, x1r);
+    fftsgStoreLeavesAvx2(a, b, nb, v);
+}
+
+/* rdft(256, -1, a); other sizes and the forward transform by rdft */
+FFTSG_AVX2 static void fftsgRdftAvx2(picoos_int32 n, picoos_int32 isgn,
+        PICOFFTSG_FFTTYPE *a)
+{
+    /* the leaves of cftleaf(256, 1, a) */
+    static const picoos_uint8 leaf081[11] = {
+        0, 32, 48, 64, 96, 128, 160, 176, 192, 224, 240
+    };
+    static const picoos_uint8 leaf082[5] = {
+        16, 80, 112, 144, 208
+    };
+    const __m256i cj = _mm256_setr_epi32(1, -1, 1, -1, 1, -1, 1, -1);
+    picoos_int32 j;
+
+    if ((256 != n) || (isgn >= 0)) {
+        rdft(n, isgn, a);
+        return;
+    }
+    a[1] = (a[0] - a[1]) / 2;
+    a[0] -= a[1];
+    fftsgRftsubAvx2(256, a, fftsgRftbsub256W[0], fftsgRftbsub256W[1]);
+
+    /* cftbsub(256, a): cftb1st, cftleaf and bitrv2conj */
+    fftsgCftmdl1Avx2(a, 64, fftsgCftb1st256W[0], 1);
+    fftsgCftmdl1Avx2(a, 16, fftsgCftmdl1W[0], 0);
+    fftsgCftmdl2Avx2(a + 64);
+    fftsgCftmdl1Avx2(a + 128, 16, fftsgCftmdl1W[0], 0);
+    fftsgCftmdl1Avx2(a + 192, 16, fftsgCftmdl1W[0], 0);
+    fftsgCftf081Avx2(a, leaf081, 8);
+    fftsgCftf081Avx2(a, leaf081 + 8, 3);
+    fftsgCftf082Avx2(a, leaf082, 5);
+    for (j = 0; j < 256; j += 8) {
+        FFTSG_STORE(a + j, _mm256_sign_epi32(FFTSG_LOAD(a + j), cj));
+    }
+    fftsgBitrv(a, 128, 2);
+}
+
+/* ddct(64, 1, a) */
+FFTSG_AVX2 static void fftsgDdct64Avx2(PICOFFTSG_FFTTYPE *a)
+{
+    const __m256i rev = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    __m256i p, q, u, v;
+    PICOFFTSG_FFTTYPE xr;
+    picoos_int32 j;
+
+    /* dctsub(64, a): a[p] and a[64 - p], p = 1..31, with a[32] in scalar */
+    xr = a[32];
+    for (j = 1; j < 32; j += 8) {
+        p = fftsgSm14Avx2(FFTSG_LOAD(a + j));
+        q = fftsgSm14Avx2(_mm256_permutevar8x32_epi32(FFTSG_LOAD(a + 57 - j), rev));
+        u = FFTSG_LOAD(fftsgDctsub64W[0] + j - 1);
+        v = FFTSG_LOAD(fftsgDctsub64W[1] + j - 1);
+        FFTSG_STORE(a + j, FFTSG_ADD(_mm256_mullo_epi32(v, p),
+                _mm256_mullo_epi32(u, q)));
+        FFTSG_STORE(a + 57 - j, _mm256_permutevar8x32_epi32(FFTSG_SUB(
+                _mm256_mullo_epi32(u, p), _mm256_mullo_epi32(v, q)), rev));
+    }
+    a[32] = Mult_W_W(WR5000, xr);
+
+    /* cftfsub(64, a) */
+    fftsgCftmdl1Avx2(a, 16, fftsgCftmdl1W[0], 0);
+    cftf081(a);
+    cftf082(&a[16]);
+    cftf081(&a[32]);
+    cftf081(&a[48]);
+    fftsgBitrv(a, 32, 2);
+
+    fftsgRftsubAvx2(64, a, fftsgRftfsub64W[0], fftsgRftfsub64W[1]);
+
+    /* a[j - 1] = a[j] - a[j + 1], a[j] += a[j + 1] for even j */
+    xr = a[0] - a[1];
+    for (j = 0; j < 64; j += 8) {
+        p = FFTSG_LOAD(a + j + 1);
+        FFTSG_STORE(a + j, _mm256_blend_epi32(FFTSG_ADD(FFTSG_LOAD(a + j), p),
+                FFTSG_SUB(p, FFTSG_LOAD(a + j + 2)), 0xaa));
+    }
+    a[63] = xr;
+}
+
+/* dfct_nmf(128, a); other sizes by dfct_nmf */
+FFTSG_AVX2 static void fftsgDfctAvx2(picoos_int32 n, PICOFFTSG_FFTTYPE *a)
+{
+    const __m256i rev = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    picoos_int32 j, k, m, mh;
+    PICOFFTSG_FFTTYPE xr, xi, yr, yi, an;
+    __m256i p, q;
+
+    if (128 != n) {
+        dfct_nmf(n, a);
+        return;
+    }
+    for (j = 0; j < 64; j += 8) {
+        p = FFTSG_LOAD(a + j);
+        q = _mm256_permutevar8x32_epi32(FFTSG_LOAD(a + 121 - j), rev);
+        FFTSG_STORE(a + j, FFTSG_SUB(p, q));
+        FFTSG_STORE(a + 121 - j, _mm256_permutevar8x32_epi32(FFTSG_ADD(p, q), rev));
+    }
+    an = a[n];
+    m = n >> 1;
+    while (m >= 2) {
+        if (64 == m) {
+            fftsgDdct64Avx2(a);
+        } else {
+            ddct(m, 1, a);
+        }
+        if (m > 2) {
+            fftsgBitrv(a, m, 1);
+        }
+        mh = m >> 1;
+        xi = a[m];
+        a[m] = a[0];
+        a[0] = an - xi;
+        an += xi;
+        for (j = 1, k = m - 1; j < mh; j++, k--) {
+            xr = a[m + k];
+            xi = a[m + j];
+            yr = a[j];
+            yi = a[k];
+            a[m + j] = yr;
+            a[m + k] = yi;
+            a[j] = xr - xi;
+            a[k] = xr + xi;
+        }
+        xr = a[mh];
+        a[mh] = a[m + mh];
+        a[m + mh] = xr;
+        m = mh;
+    }
+    xi = a[1];
+    a[1] = a[0];
+    a[0] = an + xi;
+    a[n] = an - xi;
+    fftsgBitrv(a, n, 1);
+}
+
+static const picofftsg_backend_t fftsgAvx2 = {
+    "avx2",
+    fftsgRdftAvx2,
+    fftsgDfctAvx2
+};
+
+#endif /* PICOFFTSG_X86_AVX2 */
+
+const picofftsg_backend_t *picofftsg_getBackend(picoos_int32 id)
+{
+    switch (id) {
+        case PICOFFTSG_AUTO:
+#if defined(PICOFFTSG_X86_AVX2)
+            if (NULL != picofftsg_getBackend(PICOFFTSG_AVX2)) {
+                return &fftsgAvx2;
+            }
+#endif
+            return &fftsgOoura;
+        case PICOFFTSG_OOURA:
+            return &fftsgOoura;
+#if defined(PICOFFTSG_X86_AVX2)
+        case PICOFFTSG_AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") ? &fftsgAvx2 : NULL;
+#endif
+        default:
+            return NULL;
+    }
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -30,6 +30,7 @@
 
 #include "picoos.h"
 #include "picodsp.h"
+#include "picofixedpoint.h"
 
 
 #ifdef __cplusplus
@@ -45,7 +46,41 @@ extern "C" {
 extern void rdft(int n, int isgn, PICOFFTSG_FFTTYPE *a);
 extern void dfct(int n, float *a, int VAL_SHIFT);
 extern void dfct_nmf(int n, int *a);
-extern float norm_result(int m2, PICOFFTSG_FFTTYPE *tmpX, PICOFFTSG_FFTTYPE *norm_window);
+extern pico_param_t norm_result(int m2, PICOFFTSG_FFTTYPE *tmpX, const PICOFFTSG_FFTTYPE *norm_window);
+
+/* FFT backends of the signal generation
+
+   SIG does its transforms through a backend: the Ooura routines above
+   (the reference) or a vectorized implementation. All backends give
+   bit-identical results. The AVX2 backend (x86-64, GCC or Clang, built
+   with -DPICO_USE_SIG_SIMD=1, selected by CPUID) does the 256-point
+   inverse real FFT of the impulse response and the 128-point cosine
+   transform of the envelope with precomputed twiddle factors (the exact
+   values of the Ooura recurrences) and bit reversal tables shared by all
+   engines; other sizes and directions go to the reference routines.
+
+   Timing per backend: picobench fft */
+
+#define PICOFFTSG_AUTO     0  /* best backend supported by the CPU */
+#define PICOFFTSG_OOURA    1  /* reference */
+#define PICOFFTSG_AVX2     2
+#define PICOFFTSG_NUM      3
+
+typedef struct picofftsg_backend {
+    const char *name;
+
+    /* real DFT of a[0..n-1] in place, see rdft */
+    void (*rdft)(picoos_int32 n, picoos_int32 isgn, PICOFFTSG_FFTTYPE *a);
+
+    /* cosine transform of the real symmetric DFT of a[0..n] in place,
+       see dfct_nmf */
+    void (*dfct)(picoos_int32 n, PICOFFTSG_FFTTYPE *a);
+} picofftsg_backend_t;
+
+/* returns backend 'id' (PICOFFTSG_*), or the best supported backend for
+   PICOFFTSG_AUTO; NULL if the backend is not compiled in or the CPU does
+   not support it */
+const picofftsg_backend_t *picofftsg_getBackend(picoos_int32 id);
 
 #ifdef __cplusplus
 }
@@ -67,3 +67,137 @@ pico_q15_t pico_q15_recip_approx(pico_q15_t x) {
     
     return (pico_q15_t)guess;
 }
+
+/* 2^(k/32) for k = 0..31 in Q30 */
+static const int32_t fixExp2Tbl[32] = {
+    1073741824, 1097253708, 1121280436, 1145833280, 1170923762, 1196563654,
+    1222764986, 1249540052, 1276901417, 1304861917, 1333434672, 1362633090,
+    1392470869, 1422962010, 1454120821, 1485961921, 1518500250, 1551751076,
+    1585730000, 1620452965, 1655936265, 1692196547, 1729250827, 1767116489,
+    1805811301, 1845353420, 1885761398, 1927054196, 1969251188, 2012372174,
+    2056437387, 2101467502
+};
+
+#define FIX_LOG2E_Q30   1549082005  /* log2(e) */
+#define FIX_LN2_Q30     744261118   /* ln(2) */
+
+/* m * 2^sh for a positive mantissa m, truncated and saturated */
+static int32_t fixScale(int64_t m, int sh)
+{
+    if (sh >= 0) {
+        if ((sh > 30) || (m > (INT32_MAX >> sh))) {
+            return INT32_MAX;
+        }
+        return (int32_t)(m << sh);
+    }
+    if (sh < -62) {
+        return 0;
+    }
+    return (int32_t)(m >> -sh);
+}
+
+/**
+ * exp(x) = 2^t with t = x * log2(e) = n + k/32 + r: 2^(k/32) from the
+ * table, 2^r by its second order Taylor polynomial (r < 1/32)
+ */
+int32_t pico_fix_exp(int32_t x, int xShift, int yShift) {
+    int64_t t, u, m;
+    int32_t n, k, r;
+
+    /* t in Q24 */
+    t = ((int64_t)x * FIX_LOG2E_Q30) >> (xShift + 6);
+    n = (int32_t)(t >> 24);
+    k = (int32_t)((t >> 19) & 31);
+    r = (int32_t)(t & 0x7FFFF);
+
+    /* 2^r = e^(r ln2) in Q30 */
+    u = ((int64_t)r * FIX_LN2_Q30) >> 24;
+    m = ((int64_t)1 << 30) + u + ((u * u) >> 31);
+    m = (m * fixExp2Tbl[k]) >> 30;
+
+    return fixScale(m, n + yShift - 30);
+}
+
+/**
+ * picoos_quick_exp builds the double 2^e * (1 + f) from the integer
+ * 1512775.375 * x + 1072632447 as its upper 32 bits (exponent e and the
+ * upper 20 bits of the mantissa f); the same in integers
+ */
+int32_t pico_fix_exp_quick(int32_t x, int xShift, int yShift) {
+    int64_t p;
+    int32_t i, e;
+
+    /* 1512775.375 = 12102203 / 8, truncated towards zero as by the cast */
+    p = (int64_t)x * 12102203;
+    if (p >= 0) {
+        p >>= (xShift + 3);
+    } else {
+        p = -((-p) >> (xShift + 3));
+    }
+    if (p > (INT32_MAX - 1072632447)) {
+        return INT32_MAX;
+    }
+    if (p < -1072632447) {
+        return 0;
+    }
+    i = (int32_t)p + 1072632447;
+    e = (i >> 20) - 1023;
+    return fixScale((int64_t)((i & 0xFFFFF) | 0x100000), e + yShift - 20);
+}
+
+/**
+ * t = x * log2(e) = n + f in Q26 with log2(e) in Q14 plus a correction
+ * (23637 + 473 / 4096), 2^f = p / 2^15 by Horner in Q15 with rounding:
+ * no product exceeds 31 bits for arguments in -20..20
+ */
+int32_t pico_fix_exp_fast(int32_t x, int xShift, int yShift) {
+    int32_t a, t, n, f, p, e;
+
+    /* argument in Q12, rounded */
+    if (xShift > 12) {
+        a = ((x >> (xShift - 13)) + 1) >> 1;
+    } else if (x > (PICO_FIX_EXP_FAST_MAX >> (12 - xShift))) {
+        a = PICO_FIX_EXP_FAST_MAX;
+    } else if (x < -(PICO_FIX_EXP_FAST_MAX >> (12 - xShift))) {
+        a = -PICO_FIX_EXP_FAST_MAX;
+    } else {
+        a = x << (12 - xShift);
+    }
+    a = (a > PICO_FIX_EXP_FAST_MAX) ? PICO_FIX_EXP_FAST_MAX : a;
+    a = (a < -PICO_FIX_EXP_FAST_MAX) ? -PICO_FIX_EXP_FAST_MAX : a;
+
+    t = a * 23637 + ((a * 473) >> 12);
+    n = t >> 26;
+    f = (t & 0x3FFFFFF) >> 11;
+    p = ((PICO_FIX_EXP_FAST_C3 * f + 16384) >> 15) + PICO_FIX_EXP_FAST_C2;
+    p = ((p * f + 16384) >> 15) + PICO_FIX_EXP_FAST_C1;
+    p = ((p * f + 16384) >> 15) + 32768;
+
+    e = n - 15 + yShift;
+    if (e >= 0) {
+        if ((e > 16) || (p > (INT32_MAX >> e))) {
+            return INT32_MAX;
+        }
+        return p << e;
+    }
+    return (e <= -31) ? 0 : (p >> -e);
+}
+
+uint32_t pico_fix_sqrt64(uint64_t x) {
+    uint64_t res = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > x) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (x >= res + bit) {
+            x -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)res;
+}
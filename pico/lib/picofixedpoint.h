@@ -23,8 +23,14 @@
  * Q15 format: 1 sign bit + 15 fractional bits (range: -1.0 to ~1.0)
  * Q31 format: 1 sign bit + 31 fractional bits (range: -1.0 to ~1.0)
  *
+ * With fixed point the signal generation (picosig, picosig2, the SIG
+ * kernels and FFT) is integer only: the frame parameters are Q12 values
+ * (pico_param_t) and the exponentials and square roots are computed by
+ * the functions below.
+ *
  * Usage:
  *   Enable with: -DPICO_USE_FIXED_POINT=1
+ *   Accuracy and timing against floating point: picobench fixedpoint
  */
 
 #ifndef PICOFIXEDPOINT_H_
@@ -246,6 +252,81 @@ static inline void pico_q15_vector_add(const pico_q15_t *a,
     #define PICO_DSP_SUB(a, b)      ((a) - (b))
 #endif
 
+/* ============================================================================
+ * DSP Parameters
+ * ============================================================================ */
+
+/* Scalar parameters of the signal generation (pitch, energy, voicing,
+ * pitch/volume/speaker modifiers) are single precision floats, or Q12
+ * values in 32 bits with fixed point. PICO_PARAM is meant for constants
+ * only, it is evaluated at compile time. */
+#define PICO_PARAM_SHIFT 12
+
+#ifdef PICO_FIXED_POINT_ENABLED
+    typedef int32_t pico_param_t;
+    #define PICO_PARAM(f)           ((pico_param_t) ((f) * (1 << PICO_PARAM_SHIFT)))
+    #define PICO_PARAM_RATIO(n, d)  ((pico_param_t) ((((int32_t) (n) << PICO_PARAM_SHIFT) + (d) / 2) / (d)))
+    #define PICO_PARAM_MULT(a, b)   ((pico_param_t) (((int64_t) (a) * (b)) >> PICO_PARAM_SHIFT))
+    #define PICO_PARAM_TO_INT(a)    ((int32_t) (((a) >= 0) ? ((a) >> PICO_PARAM_SHIFT) : -((-(a)) >> PICO_PARAM_SHIFT)))
+#else
+    typedef float pico_param_t;
+    #define PICO_PARAM(f)           ((pico_param_t) (f))
+    #define PICO_PARAM_RATIO(n, d)  ((pico_param_t) (n) / (pico_param_t) (d))
+    #define PICO_PARAM_MULT(a, b)   ((a) * (b))
+    #define PICO_PARAM_TO_INT(a)    ((int32_t) (a))
+#endif
+
+/* ============================================================================
+ * Fixed-Point Functions
+ * ============================================================================ */
+
+/**
+ * Exponential in fixed point
+ * @param x Argument, scaled by 2^xShift
+ * @param xShift Fractional bits of x
+ * @param yShift Fractional bits of the result
+ * @return exp(x / 2^xShift) * 2^yShift, truncated; INT32_MAX on overflow.
+ *         The relative error is below 1e-5.
+ */
+int32_t pico_fix_exp(int32_t x, int xShift, int yShift);
+
+/**
+ * Exponential in fixed point, with the same piecewise linear
+ * approximation as picoos_quick_exp (relative error up to 4%)
+ * @param x Argument, scaled by 2^xShift
+ * @param xShift Fractional bits of x
+ * @param yShift Fractional bits of the result
+ * @return exp(x / 2^xShift) * 2^yShift, truncated; INT32_MAX on overflow
+ */
+int32_t pico_fix_exp_quick(int32_t x, int xShift, int yShift);
+
+/**
+ * Exponential in fixed point with 32 bit integer operations only, for
+ * the fast math profile of the signal generation (vectorized as the
+ * expShift kernel, see picosigk.h): exp(x) = 2^n * 2^f with 2^f by a
+ * cubic polynomial in Q15. The argument is rounded to 1/4096 and clamped
+ * to -20..20. The relative error is below 2.5e-4 (1.2e-4 of the
+ * rounding, 1.1e-4 of the polynomial), before the truncation.
+ * @param x Argument, scaled by 2^xShift
+ * @param xShift Fractional bits of x
+ * @param yShift Fractional bits of the result
+ * @return exp(x / 2^xShift) * 2^yShift, truncated; INT32_MAX on overflow
+ */
+int32_t pico_fix_exp_fast(int32_t x, int xShift, int yShift);
+
+/* pico_fix_exp_fast: argument limit 20 in Q12, coefficients of 2^f in Q15 */
+#define PICO_FIX_EXP_FAST_MAX   81920
+#define PICO_FIX_EXP_FAST_C1    22781
+#define PICO_FIX_EXP_FAST_C2    7453
+#define PICO_FIX_EXP_FAST_C3    2529
+
+/**
+ * Integer square root
+ * @param x Input value
+ * @return floor(sqrt(x))
+ */
+uint32_t pico_fix_sqrt64(uint64_t x);
+
 /* ============================================================================
  * Fast Approximations (Phase 2)
  * ============================================================================ */
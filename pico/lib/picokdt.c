@@ -237,6 +237,10 @@ typedef enum {
  *  derived from : picoknow_KnowledgeBase
  */
 
+#if defined(PICO_USE_KDT_EXPAND)
+typedef struct kdt_xtree * kdt_XTree;
+#endif
+
 /* subobj shared by all decision trees */
 typedef struct {
     picokdt_kdttype_t type;
@@ -256,6 +260,11 @@ typedef struct {
     /* direct output vector (no output mapping) */
     picoos_uint8 dset;    /* TRUE if class set, FALSE otherwise */
     picoos_uint16 dclass;
+
+#if defined(PICO_USE_KDT_EXPAND)
+    /* expanded tree, NULL if the bit-packed tree body is used */
+    kdt_XTree xtree;
+#endif
 } kdt_subobj_t;
 
 /* subobj specific for each decision tree type */
@@ -383,6 +392,9 @@ static pico_status_t kdtDtInitialize(register picoknow_KnowledgeBase this,
         }
         dtp->dset = 0;
         dtp->dclass = 0;
+#if defined(PICO_USE_KDT_EXPAND)
+        dtp->xtree = NULL;
+#endif
         PICODBG_DEBUG(("tree init: nratt: %d, posomt: %d, postree: %d",
                        dtp->nrattributes, (dtp->outmaptable - dtp->inpmaptable),
                        (dtp->tree - dtp->inpmaptable)));
@@ -629,9 +641,18 @@ static pico_status_t kdtPamInitialize(register picoknow_KnowledgeBase this,
 }
 
 
+#if defined(PICO_USE_KDT_EXPAND)
+static void kdtExpandTree(kdt_subobj_t *dt, picoos_Common common);
+#endif
+
 static pico_status_t kdtSubObjDeallocate(register picoknow_KnowledgeBase this,
                                          picoos_MemoryManager mm) {
     if (NULL != this) {
+#if defined(PICO_USE_KDT_EXPAND)
+        if (NULL != this->subObj) {
+            picoos_deallocate(mm, (void *) &((kdt_subobj_t *)this->subObj)->xtree);
+        }
+#endif
         picoos_deallocate(mm, (void *) &this->subObj);
     }
     return PICO_OK;
@@ -710,6 +731,10 @@ pico_status_t picokdt_specializeDtKnowledgeBase(picoknow_KnowledgeBase this,
         picoos_deallocate(common->mm, (void *) &this->subObj);
         return picoos_emRaiseException(common->em, status, NULL, NULL);
     }
+#if defined(PICO_USE_KDT_EXPAND)
+    /* all tree subobjs start with the common kdt_subobj_t */
+    kdtExpandTree((kdt_subobj_t *)this->subObj, common);
+#endif
     return PICO_OK;
 }
 
@@ -1200,6 +1225,337 @@ static picoos_int8 kdtAskTree(register kdt_subobj_t *this,
 }
 
 
+#if defined(PICO_USE_KDT_EXPAND)
+
+/* ************************************************************/
+/* decision tree support functions, expanded tree */
+/* ************************************************************/
+
+/* The expanded tree holds the nodes in depth-first order, root first.
+   Each node refers to its forks, a fork either is a decision (class)
+   or the index of the child node. Discrete nodes additionally refer to
+   their nrforks-1 subsets; the bit masks of eBitMask subsets are
+   unpacked into 32 bit words, bit k of the mask being bit k of the
+   group. */
+
+#define KDT_XFORK_DECIDE    0x80000000u
+
+/* max. depth of the trees that are expanded (bounds the recursion) */
+#define KDT_XTREE_MAXDEPTH  256
+
+typedef struct {
+    picoos_uint8 type;       /* kdt_nodetypes_t */
+    picoos_uint8 question;   /* attribute index, may be invalid */
+    picoos_uint16 nrforks;
+    picoos_uint32 forks;     /* index of the first fork */
+    picoos_uint32 arg;       /* continuous: threshold; discrete: index of
+                                the first subset */
+} kdt_xnode_t;
+
+typedef struct {
+    picoos_uint8 type;       /* kdt_subsettypes_t */
+    picoos_uint8 reserved;
+    picoos_uint16 first;     /* (first) value or start of the group */
+    picoos_uint16 second;    /* second value or size of the group */
+    picoos_uint16 reserved2;
+    picoos_uint32 mask;      /* eBitMask: index of the first mask word */
+} kdt_xsubset_t;
+
+typedef struct kdt_xtree {
+    kdt_xnode_t *nodes;
+    picoos_uint32 *forks;
+    kdt_xsubset_t *subsets;
+    picoos_uint32 *masks;
+} kdt_xtree_t;
+
+/* expansion state; the tree is parsed twice, first to count the
+   elements (xtree == NULL), then to fill the tables */
+typedef struct {
+    kdt_subobj_t *dt;
+    kdt_xtree_t *xtree;
+    picoos_uint32 nrnodes;
+    picoos_uint32 nrforks;
+    picoos_uint32 nrsubsets;
+    picoos_uint32 nrmasks;
+} kdt_xparse_t;
+
+
+/* Name    :   kdtExpandNode
+   Function:   parses the node at iByteNo, iBitNo and, recursively, its
+               children in the same way as kdtAskTree
+   Returns :   the node index, -1 if the node cannot be expanded
+*/
+static picoos_int32 kdtExpandNode(kdt_xparse_t *xp, picoos_uint32 iByteNo,
+                                  picoos_int8 iBitNo, picoos_uint16 depth) {
+    kdt_subobj_t *this = xp->dt;
+    kdt_xnode_t node;
+    kdt_xsubset_t subset;
+    picoos_uint32 iNode, iFork, iSubset, val, i, k;
+    picoos_uint32 childByteNo;
+    picoos_int8 childBitNo;
+    picoos_int32 iChild;
+
+    if (depth > KDT_XTREE_MAXDEPTH) {
+        return -1;
+    }
+    iNode = xp->nrnodes++;
+    node.type = (picoos_uint8)kdtGetShiftVal(this, PICOKDT_NODETYPE_NRBITS,
+                                             &iByteNo, &iBitNo);
+    node.question = (picoos_uint8)kdtGetShiftVal(this, this->vfields[eQuestion],
+                                                 &iByteNo, &iBitNo);
+    node.nrforks = 0;
+    node.forks = xp->nrforks;
+    node.arg = 0;
+
+    /* kdtAskTree fails at a node with an invalid question, the rest of
+       the node is never read */
+    if (node.question < this->nrattributes) {
+        switch (node.type) {
+            case eNBinary:
+                node.nrforks = 2;
+                break;
+            case eNContinuous:
+                node.nrforks = 2;
+                node.arg = kdtGetShiftVal(this,
+                        kdtGetQFieldsVal(this, node.question, eCut),
+                        &iByteNo, &iBitNo);
+                break;
+            case eNDiscrete:
+                val = kdtGetShiftVal(this,
+                        kdtGetQFieldsVal(this, node.question, eForkCount),
+                        &iByteNo, &iBitNo);
+                if (val > 0xffff) {
+                    return -1;
+                }
+                node.nrforks = (picoos_uint16)val;
+                node.arg = xp->nrsubsets;
+                for (i = 0; (i + 1) < node.nrforks; i++) {
+                    iSubset = xp->nrsubsets++;
+                    subset.type = (picoos_uint8)kdtGetShiftVal(this,
+                            PICOKDT_SUBSETTYPE_NRBITS, &iByteNo, &iBitNo);
+                    subset.reserved = 0;
+                    subset.reserved2 = 0;
+                    subset.second = 0;
+                    subset.mask = 0;
+                    val = kdtGetShiftVal(this,
+                            kdtGetQFieldsVal(this, node.question, eBitNo),
+                            &iByteNo, &iBitNo);
+                    if (val > 0xffff) {
+                        return -1;
+                    }
+                    subset.first = (picoos_uint16)val;
+                    if (eOneValue != subset.type) {
+                        val = kdtGetShiftVal(this,
+                                kdtGetQFieldsVal(this, node.question, eBitCount),
+                                &iByteNo, &iBitNo);
+                        if (val > 0xffff) {
+                            return -1;
+                        }
+                        subset.second = (picoos_uint16)val;
+                    }
+                    if (eBitMask == subset.type) {
+                        subset.mask = xp->nrmasks;
+                        xp->nrmasks += (subset.second + 31) / 32;
+                        for (k = 0; k < subset.second; k++) {
+                            if ((NULL != xp->xtree)
+                                && ((this->treebody[iByteNo] & (1 << iBitNo)) > 0)) {
+                                xp->xtree->masks[subset.mask + k / 32] |=
+                                    (picoos_uint32)1 << (k % 32);
+                            }
+                            kdt_jump(1, &iByteNo, &iBitNo);
+                        }
+                    }
+                    if (NULL != xp->xtree) {
+                        xp->xtree->subsets[iSubset] = subset;
+                    }
+                }
+                break;
+            default:
+                /* eNTerminal: no forks, kdtAskTree fails */
+                break;
+        }
+    }
+
+    node.forks = xp->nrforks;
+    xp->nrforks += node.nrforks;
+    for (i = 0; i < node.nrforks; i++) {
+        iFork = node.forks + i;
+        if (!kdtGetShiftVal(this, PICOKDT_ISDECIDE_NRBITS, &iByteNo, &iBitNo)) {
+            val = kdtGetShiftVal(this, kdtGetQFieldsVal(this, node.question, eJump),
+                                 &iByteNo, &iBitNo);
+            childByteNo = iByteNo;
+            childBitNo = iBitNo;
+            kdt_jump(val, &childByteNo, &childBitNo);
+            iChild = kdtExpandNode(xp, childByteNo, childBitNo, depth + 1);
+            if (iChild < 0) {
+                return -1;
+            }
+            val = (picoos_uint32)iChild;
+        } else {
+            /* kdtAskTree truncates the decision to dclass */
+            val = KDT_XFORK_DECIDE | (picoos_uint16)kdtGetShiftVal(this,
+                    this->vfields[eDecide], &iByteNo, &iBitNo);
+        }
+        if (NULL != xp->xtree) {
+            xp->xtree->forks[iFork] = val;
+        }
+    }
+    if (NULL != xp->xtree) {
+        xp->xtree->nodes[iNode] = node;
+    }
+    return (picoos_int32)iNode;
+}
+
+
+/* Name    :   kdtExpandTree
+   Function:   builds the expanded tree of 'dt'; if the tree cannot be
+               expanded (depth, values out of range, no memory)
+               dt->xtree stays NULL
+*/
+static void kdtExpandTree(kdt_subobj_t *dt, picoos_Common common) {
+    kdt_xparse_t xp;
+    kdt_xtree_t *xtree;
+    picoos_uint32 size;
+
+    xp.dt = dt;
+    xp.xtree = NULL;
+    xp.nrnodes = xp.nrforks = xp.nrsubsets = xp.nrmasks = 0;
+    if (kdtExpandNode(&xp, 0, 7, 0) < 0) {
+        PICODBG_WARN(("tree type %d not expanded", dt->type));
+        return;
+    }
+
+    size = sizeof(kdt_xtree_t)
+        + xp.nrnodes * sizeof(kdt_xnode_t)
+        + xp.nrforks * sizeof(picoos_uint32)
+        + xp.nrsubsets * sizeof(kdt_xsubset_t)
+        + xp.nrmasks * sizeof(picoos_uint32);
+    xtree = picoos_allocate(common->mm, size);
+    if (NULL == xtree) {
+        PICODBG_WARN(("no memory to expand tree type %d (%d bytes)",
+                      dt->type, size));
+        return;
+    }
+    xtree->nodes = (kdt_xnode_t *)(xtree + 1);
+    xtree->forks = (picoos_uint32 *)(xtree->nodes + xp.nrnodes);
+    xtree->subsets = (kdt_xsubset_t *)(xtree->forks + xp.nrforks);
+    xtree->masks = (picoos_uint32 *)(xtree->subsets + xp.nrsubsets);
+    picoos_mem_set(xtree->masks, 0, xp.nrmasks * sizeof(picoos_uint32));
+
+    xp.xtree = xtree;
+    xp.nrnodes = xp.nrforks = xp.nrsubsets = xp.nrmasks = 0;
+    kdtExpandNode(&xp, 0, 7, 0);
+    dt->xtree = xtree;
+    PICODBG_INFO(("tree type %d expanded: %d nodes, %d bytes",
+                  dt->type, xp.nrnodes, size));
+}
+
+
+/* Name    :   kdtAskXTree
+   Function:   traverses the expanded tree, same results as repeated
+               calls of kdtAskTree
+   Returns :   =0    solution found
+               <0    error, no solution found
+*/
+static picoos_int8 kdtAskXTree(register kdt_subobj_t *this,
+                               picoos_uint16 *invec,
+                               const kdt_nratt_t invecmax) {
+    const kdt_xtree_t *xtree = this->xtree;
+    const kdt_xnode_t *node;
+    const kdt_xsubset_t *subset;
+    picoos_int32 iVal, iID, i;
+    picoos_uint32 fork;
+
+    node = &xtree->nodes[0];
+    while (TRUE) {
+        if ((node->question >= this->nrattributes) || (node->question >= invecmax)) {
+            this->dset = FALSE;
+            return -1;    /* iQuestion invalid */
+        }
+        iVal = invec[node->question];
+        switch (node->type) {
+            case eNBinary:
+                iID = iVal;
+                break;
+            case eNContinuous:
+                iID = (iVal <= (picoos_int32)node->arg) ? 0 : 1;
+                break;
+            case eNDiscrete:
+                /* default tree branch if no subset matches */
+                iID = node->nrforks - 1;
+                subset = &xtree->subsets[node->arg];
+                for (i = 0; i < (node->nrforks - 1); i++, subset++) {
+                    if (eOneValue == subset->type) {
+                        if (iVal == subset->first) {
+                            break;
+                        }
+                    } else if (eTwoValues == subset->type) {
+                        if ((iVal == subset->first) || (iVal == subset->second)) {
+                            break;
+                        }
+                    } else if ((iVal >= subset->first)
+                               && (iVal < (subset->first + subset->second))) {
+                        if (eWithoutBitMask == subset->type) {
+                            break;
+                        }
+                        fork = (picoos_uint32)(iVal - subset->first);
+                        if (xtree->masks[subset->mask + fork / 32]
+                            & ((picoos_uint32)1 << (fork % 32))) {
+                            break;
+                        }
+                    }
+                }
+                if (i < (node->nrforks - 1)) {
+                    iID = i;
+                }
+                break;
+            default:
+                iID = -1;
+                break;
+        }
+        if ((iID < 0) || (iID >= node->nrforks)) {
+            this->dset = FALSE;
+            return -1;    /* problem determining a class */
+        }
+        fork = xtree->forks[node->forks + iID];
+        if (fork & KDT_XFORK_DECIDE) {
+            this->dclass = (picoos_uint16)fork;
+            this->dset = TRUE;
+            return 0;    /* solution found */
+        }
+        node = &xtree->nodes[fork];
+    }
+}
+
+#endif /* PICO_USE_KDT_EXPAND */
+
+
+/* Name    :   kdtClassify
+   Function:   applies the tree to the input vector
+   Returns :   =0    solution found, class in this->dclass
+               <0    error, no solution found
+*/
+static picoos_int8 kdtClassify(register kdt_subobj_t *this,
+                               picoos_uint16 *invec,
+                               const kdt_nratt_t invecmax) {
+    picoos_uint32 iByteNo;
+    picoos_int8 iBitNo;
+    picoos_int8 rv;
+
+#if defined(PICO_USE_KDT_EXPAND)
+    if (NULL != this->xtree) {
+        return kdtAskXTree(this, invec, invecmax);
+    }
+#endif
+    iByteNo = 0;
+    iBitNo = 7;
+    while ((rv = kdtAskTree(this, invec, invecmax, &iByteNo, &iBitNo)) > 0) {
+        PICODBG_TRACE(("asking tree"));
+    }
+    return rv;
+}
+
+
 
 /* ************************************************************/
 /* decision tree support functions, mappings */
@@ -1859,20 +2215,13 @@ picoos_uint8 picokdt_dtPosPconstructInVec(const picokdt_DtPosP this,
 
 
 picoos_uint8 picokdt_dtPosPclassify(const picokdt_DtPosP this) {
-    picoos_uint32 iByteNo;
-    picoos_int8 iBitNo;
     picoos_int8 rv;
     kdtposp_subobj_t *dtposp;
     kdt_subobj_t *dt;
 
     dtposp = (kdtposp_subobj_t *)this;
     dt = &(dtposp->dt);
-    iByteNo = 0;
-    iBitNo = 7;
-    while ((rv = kdtAskTree(dt, dtposp->invec, PICOKDT_NRATT_POSP,
-                            &iByteNo, &iBitNo)) > 0) {
-        PICODBG_TRACE(("asking tree"));
-    }
+    rv = kdtClassify(dt, dtposp->invec, PICOKDT_NRATT_POSP);
     PICODBG_DEBUG(("done: %d", dt->dclass));
     return ((rv == 0) && dt->dset);
 }
@@ -1942,20 +2291,13 @@ picoos_uint8 picokdt_dtPosDconstructInVec(const picokdt_DtPosD this,
 
 picoos_uint8 picokdt_dtPosDclassify(const picokdt_DtPosD this,
                                     picoos_uint16 *treeout) {
-    picoos_uint32 iByteNo;
-    picoos_int8 iBitNo;
     picoos_int8 rv;
     kdtposd_subobj_t *dtposd;
     kdt_subobj_t *dt;
 
     dtposd = (kdtposd_subobj_t *)this;
     dt = &(dtposd->dt);
-    iByteNo = 0;
-    iBitNo = 7;
-    while ((rv = kdtAskTree(dt, dtposd->invec, PICOKDT_NRATT_POSD,
-                            &iByteNo, &iBitNo)) > 0) {
-        PICODBG_TRACE(("asking tree"));
-    }
+    rv = kdtClassify(dt, dtposd->invec, PICOKDT_NRATT_POSD);
     PICODBG_DEBUG(("done: %d", dt->dclass));
     if ((rv == 0) && dt->dset) {
         *treeout = dt->dclass;
@@ -2033,6 +2375,47 @@ static picoos_uint16 kdtGetUTF8Nr(const picoos_uint8 *utfgraph,
 }
 
 
+/* map a graph attribute value of the G2P tree, using the fallback
+   value if there is no mapping; FALSE if attribute set to zero */
+static picoos_uint8 kdtG2PmapGraph(kdtg2p_subobj_t *dtg2p,
+                                   const picoos_uint8 iAttr,
+                                   const picoos_uint8 *utf8char,
+                                   picoos_uint16 *outval) {
+    picoos_uint16 fallback = 0;
+
+    if (!kdtMapInGraph(&(dtg2p->dt), iAttr, utf8char, PICOBASE_UTF8_MAXLEN,
+                       outval, &fallback)) {
+        if (fallback) {
+            *outval = fallback;
+        } else {
+            PICODBG_WARN(("setting attribute %d to zero", iAttr));
+            *outval = 0;
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/* same for a fixed attribute of the G2P tree */
+static picoos_uint8 kdtG2PmapFixed(kdtg2p_subobj_t *dtg2p,
+                                   const picoos_uint8 iAttr,
+                                   const picoos_uint16 inval,
+                                   picoos_uint16 *outval) {
+    picoos_uint16 fallback = 0;
+
+    if (!kdtMapInFixed(&(dtg2p->dt), iAttr, inval, outval, &fallback)) {
+        if (fallback) {
+            *outval = fallback;
+        } else {
+            PICODBG_WARN(("setting attribute %d to zero", iAttr));
+            *outval = 0;
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+
 picoos_uint8 picokdt_dtG2PconstructInVec(const picokdt_DtG2P this,
                                          const picoos_uint8 *graph,
                                          const picoos_uint16 graphlen,
@@ -2045,7 +2428,6 @@ picoos_uint8 picokdt_dtG2PconstructInVec(const picokdt_DtG2P this,
                                          const picoos_uint16 phonech2,
                                          const picoos_uint16 phonech3) {
     kdtg2p_subobj_t *dtg2p;
-    picoos_uint16 fallback = 0;
     picoos_uint8 iAttr;
     picoos_uint8 utf8char[PICOBASE_UTF8_MAXLEN + 1];
     picoos_uint16 inval;
@@ -2109,17 +2491,9 @@ picoos_uint8 picokdt_dtG2PconstructInVec(const picokdt_DtG2P this,
             utf8char[1] = '\0';
         }
 
-        if (!kdtMapInGraph(&(dtg2p->dt), iAttr,
-                           utf8char, PICOBASE_UTF8_MAXLEN,
-                           &(dtg2p->invec[iAttr]),
-                           &fallback)) {
-            if (fallback) {
-                dtg2p->invec[iAttr] = fallback;
-            } else {
-                PICODBG_WARN(("setting attribute %d to zero", iAttr));
-                dtg2p->invec[iAttr] = 0;
-                retval = FALSE;
-            }
+        if (!kdtG2PmapGraph(dtg2p, iAttr, utf8char,
+                            &(dtg2p->invec[iAttr]))) {
+            retval = FALSE;
         }
         PICODBG_TRACE(("invec %d %c", iAttr, utf8char[0]));
         cinv--;
@@ -2146,17 +2520,9 @@ picoos_uint8 picokdt_dtG2PconstructInVec(const picokdt_DtG2P this,
                 utf8char[1] = '\0';
             }
         }
-        if (!kdtMapInGraph(&(dtg2p->dt), iAttr,
-                           utf8char, PICOBASE_UTF8_MAXLEN,
-                           &(dtg2p->invec[iAttr]),
-                           &fallback)) {
-            if (fallback) {
-                dtg2p->invec[iAttr] = fallback;
-            } else {
-                PICODBG_WARN(("setting attribute %d to zero", iAttr));
-                dtg2p->invec[iAttr] = 0;
-                retval = FALSE;
-            }
+        if (!kdtG2PmapGraph(dtg2p, iAttr, utf8char,
+                            &(dtg2p->invec[iAttr]))) {
+            retval = FALSE;
         }
         PICODBG_TRACE(("invec %d %c", iAttr, utf8char[0]));
         cinv--;
@@ -2195,15 +2561,9 @@ picoos_uint8 picokdt_dtG2PconstructInVec(const picokdt_DtG2P this,
 
         PICODBG_TRACE(("invec %d %d", iAttr, inval));
 
-        if (!kdtMapInFixed(&(dtg2p->dt), iAttr, inval,
-                           &(dtg2p->invec[iAttr]), &fallback)) {
-            if (fallback) {
-                dtg2p->invec[iAttr] = fallback;
-            } else {
-                PICODBG_WARN(("setting attribute %d to zero", iAttr));
-                dtg2p->invec[iAttr] = 0;
-                retval = FALSE;
-            }
+        if (!kdtG2PmapFixed(dtg2p, iAttr, inval,
+                            &(dtg2p->invec[iAttr]))) {
+            retval = FALSE;
         }
     }
 
@@ -2222,22 +2582,166 @@ picoos_uint8 picokdt_dtG2PconstructInVec(const picokdt_DtG2P this,
 
 
 
+picoos_uint8 picokdt_dtG2PprepareWord(const picokdt_DtG2P this,
+                                      picokdt_g2p_word_t *word,
+                                      const picoos_uint8 *graph,
+                                      const picoos_uint16 graphlen,
+                                      const picoos_uint8 pos) {
+    kdtg2p_subobj_t *dtg2p;
+    picoos_uint8 utf8char[PICOBASE_UTF8_MAXLEN + 1];
+    picoos_int32 utfgraphlen;
+    picoos_uint32 bytepos;
+    picoos_uint8 iAttr;
+    picoos_uint8 i;
+    picoos_uint8 n;
+
+    dtg2p = (kdtg2p_subobj_t *)this;
+    word->nrgraphs = 0;
+
+    utfgraphlen = picobase_utf8_length(graph, graphlen);
+    if ((utfgraphlen <= 0) || (utfgraphlen > PICOKDT_G2P_MAXWORDGRAPHS)) {
+        return FALSE;
+    }
+    n = (picoos_uint8)utfgraphlen;
+
+    /* map each grapheme once for each of the graph attributes */
+    bytepos = 0;
+    for (i = 0; i < n; i++) {
+        if (!picobase_get_next_utf8char(graph, graphlen, &bytepos,
+                                        utf8char)) {
+            return FALSE;
+        }
+        for (iAttr = 0; iAttr < 9; iAttr++) {
+            word->graphok[iAttr][i] =
+                kdtG2PmapGraph(dtg2p, iAttr, utf8char,
+                               &(word->graph[iAttr][i]));
+        }
+    }
+    if (bytepos != graphlen) {
+        /* graph terminated early, positions would not match */
+        return FALSE;
+    }
+
+    /* values outside of the word */
+    for (iAttr = 0; iAttr < 9; iAttr++) {
+        word->graphok[iAttr][n] =
+            kdtG2PmapGraph(dtg2p, iAttr, PICOKDT_OUTSIDEGRAPH_DEFSTR,
+                           &(word->graph[iAttr][n]));
+        word->graphok[iAttr][n + 1] =
+            kdtG2PmapGraph(dtg2p, iAttr, PICOKDT_OUTSIDEGRAPH_EOW_DEFSTR,
+                           &(word->graph[iAttr][n + 1]));
+    }
+
+    word->posok = kdtG2PmapFixed(dtg2p, 9, pos, &(word->pos));
+    word->nrgraphs = n;
+    return TRUE;
+}
+
+
+picoos_uint8 picokdt_dtG2PconstructWordInVec(const picokdt_DtG2P this,
+                                             const picokdt_g2p_word_t *word,
+                                             const picoos_uint8 graphnr,
+                                             const picoos_uint8 nrvow,
+                                             const picoos_uint8 ordvow,
+                                             picoos_uint8 *primstressflag,
+                                             const picoos_uint16 phonech1,
+                                             const picoos_uint16 phonech2,
+                                             const picoos_uint16 phonech3) {
+    kdtg2p_subobj_t *dtg2p;
+    picoos_uint8 iAttr;
+    picoos_uint16 inval;
+    picoos_int16 cinv;
+    picoos_int16 utfcount;
+    picoos_int16 n;
+    picoos_int16 ind;
+    picoos_uint8 retval;
+
+    dtg2p = (kdtg2p_subobj_t *)this;
+    retval = TRUE;
+    inval = 0;
+    dtg2p->inveclen = 0;
+
+    n = word->nrgraphs;
+    utfcount = graphnr + 1;
+    if ((n == 0) || (utfcount > n)) {
+        return FALSE;
+    }
+
+    /* graph attributes, same selection as in picokdt_dtG2PconstructInVec;
+       left context and current */
+    cinv = 4;
+    for (iAttr = 0; iAttr < 5; iAttr++) {
+        if (utfcount > cinv) {
+            ind = utfcount - cinv - 1;
+        } else if ((utfcount == cinv) && (iAttr != 4)) {
+            ind = n + 1;
+        } else {
+            ind = n;
+        }
+        dtg2p->invec[iAttr] = word->graph[iAttr][ind];
+        retval = retval && word->graphok[iAttr][ind];
+        cinv--;
+    }
+
+    /* right context */
+    cinv = n;
+    for (iAttr = 5; iAttr < 9; iAttr++) {
+        if (utfcount <= (cinv - 1)) {
+            ind = utfcount + n - cinv;
+        } else if (utfcount == cinv) {
+            ind = n + 1;
+        } else {
+            ind = n;
+        }
+        dtg2p->invec[iAttr] = word->graph[iAttr][ind];
+        retval = retval && word->graphok[iAttr][ind];
+        cinv--;
+    }
+
+    dtg2p->invec[9] = word->pos;
+    retval = retval && word->posok;
+
+    /* per-grapheme attributes, MapInFixed */
+    for (iAttr = 10; iAttr < PICOKDT_NRATT_G2P; iAttr++) {
+        switch (iAttr) {
+            case 10:
+                inval = nrvow;
+                break;
+            case 11:
+                inval = ordvow;
+                break;
+            case 12:
+                inval = (*primstressflag == 1) ? 1 : 0;
+                break;
+            case 13:
+                inval = phonech1;
+                break;
+            case 14:
+                inval = phonech2;
+                break;
+            case 15:
+                inval = phonech3;
+                break;
+        }
+        if (!kdtG2PmapFixed(dtg2p, iAttr, inval, &(dtg2p->invec[iAttr]))) {
+            retval = FALSE;
+        }
+    }
+
+    dtg2p->inveclen = PICOKDT_NRINPMT_G2P;
+    return retval;
+}
+
+
 picoos_uint8 picokdt_dtG2Pclassify(const picokdt_DtG2P this,
                                    picoos_uint16 *treeout) {
-    picoos_uint32 iByteNo;
-    picoos_int8 iBitNo;
     picoos_int8 rv;
     kdtg2p_subobj_t *dtg2p;
     kdt_subobj_t *dt;
 
     dtg2p = (kdtg2p_subobj_t *)this;
     dt = &(dtg2p->dt);
-    iByteNo = 0;
-    iBitNo = 7;
-    while ((rv = kdtAskTree(dt, dtg2p->invec, PICOKDT_NRATT_G2P,
-                            &iByteNo, &iBitNo)) > 0) {
-        PICODBG_TRACE(("asking tree"));
-    }
+    rv = kdtClassify(dt, dtg2p->invec, PICOKDT_NRATT_G2P);
     PICODBG_TRACE(("done: %d", dt->dclass));
     if ((rv == 0) && dt->dset) {
         *treeout = dt->dclass;
@@ -2330,20 +2834,13 @@ picoos_uint8 picokdt_dtPHRconstructInVec(const picokdt_DtPHR this,
 
 
 picoos_uint8 picokdt_dtPHRclassify(const picokdt_DtPHR this) {
-    picoos_uint32 iByteNo;
-    picoos_int8 iBitNo;
     picoos_int8 rv;
     kdtphr_subobj_t *dtphr;
     kdt_subobj_t *dt;
 
     dtphr = (kdtphr_subobj_t *)this;
     dt = &(dtphr->dt);
-    iByteNo = 0;
-    iBitNo = 7;
-    while ((rv = kdtAskTree(dt, dtphr->invec, PICOKDT_NRATT_PHR,
-                            &iByteNo, &iBitNo)) > 0) {
-        PICODBG_TRACE(("asking tree"));
-    }
+    rv = kdtClassify(dt, dtphr->invec, PICOKDT_NRATT_PHR);
     PICODBG_DEBUG(("done: %d", dt->dclass));
     return ((rv == 0) && dt->dset);
 }
@@ -2460,20 +2957,13 @@ picoos_uint8 picokdt_dtPAMconstructInVec(const picokdt_DtPAM this,
 
 
 picoos_uint8 picokdt_dtPAMclassify(const picokdt_DtPAM this) {
-    picoos_uint32 iByteNo;
-    picoos_int8 iBitNo;
     picoos_int8 rv;
     kdtpam_subobj_t *dtpam;
     kdt_subobj_t *dt;
 
     dtpam = (kdtpam_subobj_t *)this;
     dt = &(dtpam->dt);
-    iByteNo = 0;
-    iBitNo = 7;
-    while ((rv = kdtAskTree(dt, dtpam->invec, PICOKDT_NRATT_PAM,
-                            &iByteNo, &iBitNo)) > 0) {
-        PICODBG_TRACE(("asking tree"));
-    }
+    rv = kdtClassify(dt, dtpam->invec, PICOKDT_NRATT_PAM);
     PICODBG_DEBUG(("done: %d", dt->dclass));
     return ((rv == 0) && dt->dset);
 }
@@ -2592,20 +3082,13 @@ picoos_uint8 picokdt_dtACCconstructInVec(const picokdt_DtACC this,
 
 picoos_uint8 picokdt_dtACCclassify(const picokdt_DtACC this,
                                    picoos_uint16 *treeout) {
-    picoos_uint32 iByteNo;
-    picoos_int8 iBitNo;
     picoos_int8 rv;
     kdtacc_subobj_t *dtacc;
     kdt_subobj_t *dt;
 
     dtacc = (kdtacc_subobj_t *)this;
     dt = &(dtacc->dt);
-    iByteNo = 0;
-    iBitNo = 7;
-    while ((rv = kdtAskTree(dt, dtacc->invec, PICOKDT_NRATT_ACC,
-                            &iByteNo, &iBitNo)) > 0) {
-        PICODBG_TRACE(("asking tree"));
-    }
+    rv = kdtClassify(dt, dtacc->invec, PICOKDT_NRATT_ACC);
     PICODBG_TRACE(("done: %d", dt->dclass));
     if ((rv == 0) && dt->dset) {
         *treeout = dt->dclass;
@@ -59,6 +59,16 @@ extern "C" {
 /* ************************************************************/
 
 
+/* When PICO_USE_KDT_EXPAND is defined, every tree is expanded at load
+   time into arrays of fixed-size node records with resolved child
+   indices and the subset bit masks unpacked, so that classification no
+   longer decodes the bit-packed tree body on every query. The results
+   are identical to the bit-packed traversal. The expanded trees need
+   additional system memory (about 1.1MB for en-US, 700KB to 950KB for
+   the other languages); trees that cannot be expanded fall back to the
+   bit-packed traversal.
+   Enable with: -DPICO_USE_KDT_EXPAND=1 */
+
 /* ************************************************************/
 /* defines and functions to create specialized kb, */
 /* to be used by picorsrc only */
@@ -320,6 +330,57 @@ picoos_uint8 picokdt_dtG2Pclassify(const picokdt_DtG2P this,
 picoos_uint8 picokdt_dtG2PdecomposeOutClass(const picokdt_DtG2P this,
                                   picokdt_classify_vecresult_t *dtvres);
 
+/* word-level G2P input vector construction: the graph attributes
+   (invec[0:8]) of all graphemes of a word and the POS attribute are
+   mapped once per word with picokdt_dtG2PprepareWord; the input vector
+   of each grapheme is then assembled with picokdt_dtG2PconstructWordInVec
+   from the prepared values, giving the same result as
+   picokdt_dtG2PconstructInVec. The graphemes are still classified one at
+   a time since invec[12:15] depend on the phones predicted for the
+   following graphemes. */
+
+/* maximum number of graphemes (UTF8 chars) of a prepared word */
+#define PICOKDT_G2P_MAXWORDGRAPHS 64
+
+typedef struct {
+    picoos_uint8 nrgraphs;   /* nr of graphemes in word, 0 if not prepared */
+    picoos_uint8 posok;
+    picoos_uint16 pos;       /* mapped POS attribute */
+    /* mapped graph attributes per grapheme; index nrgraphs holds the
+       value for PICOKDT_OUTSIDEGRAPH_DEFCH, nrgraphs+1 the value for
+       PICOKDT_OUTSIDEGRAPH_EOW_DEFCH */
+    picoos_uint16 graph[9][PICOKDT_G2P_MAXWORDGRAPHS + 2];
+    picoos_uint8 graphok[9][PICOKDT_G2P_MAXWORDGRAPHS + 2];
+} picokdt_g2p_word_t;
+
+/* prepare the graph and POS attributes of the word 'graph'
+   graph:         the grapheme string of the word
+   graphlen:      length of graph in number of bytes
+   pos:           the part of speech of the word
+   returns:       TRUE if okay, FALSE if the word is not valid UTF8 or
+                  longer than PICOKDT_G2P_MAXWORDGRAPHS graphemes; use
+                  picokdt_dtG2PconstructInVec in this case
+*/
+picoos_uint8 picokdt_dtG2PprepareWord(const picokdt_DtG2P this,
+                                      picokdt_g2p_word_t *word,
+                                      const picoos_uint8 *graph,
+                                      const picoos_uint16 graphlen,
+                                      const picoos_uint8 pos);
+
+/* construct a G2P input vector for grapheme 'graphnr' [0..] of a word
+   prepared with picokdt_dtG2PprepareWord; the remaining arguments and
+   the return value are the same as for picokdt_dtG2PconstructInVec
+*/
+picoos_uint8 picokdt_dtG2PconstructWordInVec(const picokdt_DtG2P this,
+                                             const picokdt_g2p_word_t *word,
+                                             const picoos_uint8 graphnr,
+                                             const picoos_uint8 nrvow,
+                                             const picoos_uint8 ordvow,
+                                             picoos_uint8 *primstressflag,
+                                             const picoos_uint16 phonech1,
+                                             const picoos_uint16 phonech2,
+                                             const picoos_uint16 phonech3);
+
 
 /* ************************************************************/
 /* decision tree phrasing (PHR) functions */
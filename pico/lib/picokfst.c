@@ -40,6 +40,12 @@ extern "C" {
 
 #define FileHdrSize 4       /* size of FST file header */
 
+#if defined(PICO_USE_KFST_EXPAND)
+/* maximum size in bytes of the expanded pair alphabet and input epsilon
+   transitions of one FST; larger FSTs are accessed in packed form */
+#define KFST_MAX_EXPANDED_SIZE 16384
+#endif
+
 
 
 /* ************************************************************/
@@ -54,6 +60,21 @@ extern "C" {
 
 typedef struct kfst_subobj * kfst_SubObj;
 
+#if defined(PICO_USE_KFST_EXPAND)
+/* expanded symbol pair or input epsilon transition */
+typedef struct {
+    picokfst_symid_t sym;             /* output symbol; PICOKFST_SYMID_ILLEG terminates a list */
+    picoos_int16 val;                 /* pair class or end state */
+} kfst_xpair_t;
+
+/* expanded pair alphabet cell (input symbol) */
+typedef struct {
+    picokfst_symid_t inSym;
+    picoos_uint16 next;               /* index+1 of next cell with same hash, 0 if none */
+    picoos_uint16 pairs;              /* index of the first pair of inSym in xpairs */
+} kfst_xcell_t;
+#endif
+
 typedef struct kfst_subobj{
     picoos_uint8 * fstStream;         /* the byte stream base address */
     picoos_int32 hdrLen;              /* length of file header */
@@ -67,6 +88,17 @@ typedef struct kfst_subobj{
     picoos_int32 transTabPos;         /* absolute address of the start of the transition table */
     picoos_int32 inEpsStateTabPos;    /* absolute address of the start of the input epsilon transition table */
     picoos_int32 accStateTabPos;      /* absolute address of the table of accepting states */
+
+#if defined(PICO_USE_KFST_EXPAND)
+    /* pair alphabet and input epsilon transitions expanded at load time;
+       NULL if not expanded. The search states of the pair and input
+       epsilon searches are then indices into xpairs */
+    void * xmem;                      /* allocated block holding the arrays below */
+    picoos_uint16 * xhashHead;        /* per hash bucket: index+1 of first cell, 0 if empty */
+    kfst_xcell_t * xcells;
+    picoos_uint16 * xepsHead;         /* per state-1: index+1 of first input epsilon transition in xpairs, 0 if none */
+    kfst_xpair_t * xpairs;
+#endif
 } kfst_subobj_t;
 
 
@@ -137,6 +169,124 @@ static void BytesToNum (picoos_uint8 * stream, picoos_uint32 * pos, picoos_int32
 }
 
 
+#if defined(PICO_USE_KFST_EXPAND)
+/* ************************************************************/
+/* expanding the pair alphabet and input epsilon transitions */
+/* ************************************************************/
+
+/* decodes the list of (symbol,value) pairs at stream position 'pos',
+   terminated by PICOKFST_SYMID_ILLEG, into 'xpairs' at '*nrPairs' (if
+   'xpairs' is not NULL); '*nrPairs' is incremented by the list length
+   including the terminator */
+static void kfstExpandPairs (kfst_SubObj fst, picoos_uint32 pos, kfst_xpair_t * xpairs,
+                             picoos_uint32 * nrPairs)
+{
+    picoos_int32 sym;
+    picoos_int32 val;
+
+    do {
+        BytesToNum(fst->fstStream,& pos,& sym);
+        val = -1;
+        if (sym != PICOKFST_SYMID_ILLEG) {
+            BytesToNum(fst->fstStream,& pos,& val);
+        }
+        if (NULL != xpairs) {
+            xpairs[*nrPairs].sym = (picokfst_symid_t)sym;
+            xpairs[*nrPairs].val = (picoos_int16)val;
+        }
+        (*nrPairs)++;
+    } while ((sym != PICOKFST_SYMID_ILLEG) && ((*nrPairs) < 0xFFFF));
+}
+
+/* walks the pair alphabet and input epsilon tables; counts the cells
+   and pairs if 'fst->xmem' is NULL, otherwise fills the expanded arrays */
+static void kfstExpandTables (kfst_SubObj fst, picoos_uint32 * nrCells, picoos_uint32 * nrPairs)
+{
+    picoos_uint32 pos;
+    picoos_int32 offs;
+    picoos_int32 h;
+    picoos_int32 state;
+    picoos_int32 cellPos;
+    picoos_int32 inSym;
+    picoos_int32 nextOffs;
+    picoos_bool fill;
+
+    fill = (NULL != fst->xmem);
+    (*nrCells) = 0;
+    (*nrPairs) = 0;
+    for (h = 0; (h < fst->alphaHashTabSize) && ((*nrPairs) < 0xFFFF); h++) {
+        pos = fst->alphaHashTabPos + (h * 4);
+        FixedBytesToSignedNum(fst->fstStream,4,& pos,& offs);
+        if (fill) {
+            fst->xhashHead[h] = (offs > 0) ? (*nrCells) + 1 : 0;
+        }
+        cellPos = fst->alphaHashTabPos + offs;
+        nextOffs = offs;
+        while ((nextOffs > 0) && ((*nrPairs) < 0xFFFF)) {
+            pos = cellPos;
+            BytesToNum(fst->fstStream,& pos,& inSym);
+            BytesToNum(fst->fstStream,& pos,& nextOffs);
+            if (fill) {
+                fst->xcells[*nrCells].inSym = (picokfst_symid_t)inSym;
+                fst->xcells[*nrCells].next = (nextOffs > 0) ? (*nrCells) + 2 : 0;
+                fst->xcells[*nrCells].pairs = (*nrPairs);
+            }
+            (*nrCells)++;
+            kfstExpandPairs(fst, pos, fill ? fst->xpairs : NULL, nrPairs);
+            cellPos = cellPos + nextOffs;
+        }
+    }
+    for (state = 1; (state <= fst->nrStates) && ((*nrPairs) < 0xFFFF); state++) {
+        pos = fst->inEpsStateTabPos + (state - 1) * 4;
+        FixedBytesToSignedNum(fst->fstStream,4,& pos,& offs);
+        if (fill) {
+            fst->xepsHead[state - 1] = (offs > 0) ? (*nrPairs) + 1 : 0;
+        }
+        if (offs > 0) {
+            kfstExpandPairs(fst, fst->inEpsStateTabPos + offs,
+                            fill ? fst->xpairs : NULL, nrPairs);
+        }
+    }
+}
+
+/* expands the pair alphabet and input epsilon transitions if the
+   expanded form fits into KFST_MAX_EXPANDED_SIZE; the FST remains in
+   packed form otherwise, or if there is not enough memory */
+static void kfstExpand (kfst_SubObj fst, picoos_MemoryManager mm)
+{
+    picoos_uint32 nrCells;
+    picoos_uint32 nrPairs;
+    picoos_uint32 headSize;
+    picoos_uint32 size;
+    picoos_uint8 * mem;
+
+    fst->xmem = NULL;
+    if ((fst->alphaHashTabSize <= 0) || (fst->nrStates <= 0)) {
+        return;
+    }
+    kfstExpandTables(fst, & nrCells, & nrPairs);
+    headSize = (fst->alphaHashTabSize + fst->nrStates) * sizeof(picoos_uint16);
+    headSize = (headSize + 3) & ~3;
+    size = headSize + nrCells * sizeof(kfst_xcell_t) + nrPairs * sizeof(kfst_xpair_t);
+    if ((nrPairs >= 0xFFFF) || (size > KFST_MAX_EXPANDED_SIZE)) {
+        PICODBG_DEBUG(("FST not expanded, size %d", size));
+        return;
+    }
+    mem = (picoos_uint8 *) picoos_allocate(mm, size);
+    if (NULL == mem) {
+        return;
+    }
+    fst->xmem = mem;
+    fst->xhashHead = (picoos_uint16 *) mem;
+    fst->xepsHead = fst->xhashHead + fst->alphaHashTabSize;
+    fst->xcells = (kfst_xcell_t *) (mem + headSize);
+    fst->xpairs = (kfst_xpair_t *) (fst->xcells + nrCells);
+    kfstExpandTables(fst, & nrCells, & nrPairs);
+    PICODBG_DEBUG(("FST expanded: %d cells, %d pairs, %d bytes", nrCells, nrPairs, size));
+}
+#endif /* PICO_USE_KFST_EXPAND */
+
+
 /* ************************************************************/
 /* setting up FST from byte stream */
 /* ************************************************************/
@@ -177,6 +327,10 @@ static pico_status_t kfstInitialize(register picoknow_KnowledgeBase this,
     kfst->accStateTabPos = kfst->hdrLen + offs;
     /* -CT- */
 
+#if defined(PICO_USE_KFST_EXPAND)
+    kfstExpand(kfst, common->mm);
+#endif
+
     return PICO_OK;
 }
 
@@ -185,6 +339,11 @@ static pico_status_t kfstSubObjDeallocate(register picoknow_KnowledgeBase this,
         picoos_MemoryManager mm)
 {
     if (NULL != this) {
+#if defined(PICO_USE_KFST_EXPAND)
+        if (NULL != this->subObj) {
+            picoos_deallocate(mm, & ((kfst_subobj_t *) this->subObj)->xmem);
+        }
+#endif
         picoos_deallocate(mm, (void *) &this->subObj);
     }
     return PICO_OK;
@@ -283,6 +442,20 @@ extern void picokfst_kfstStartPairSearch (picokfst_FST this, picokfst_symid_t in
     (*searchState) =  -1;
     (*inSymFound) = 0;
     h = inSym % fst->alphaHashTabSize;
+#if defined(PICO_USE_KFST_EXPAND)
+    if (NULL != fst->xmem) {
+        offs = (h >= 0) ? fst->xhashHead[h] : 0;
+        while (offs > 0) {
+            if (fst->xcells[offs - 1].inSym == inSym) {
+                (*searchState) = fst->xcells[offs - 1].pairs;
+                (*inSymFound) = 1;
+                return;
+            }
+            offs = fst->xcells[offs - 1].next;
+        }
+        return;
+    }
+#endif
     pos = fst->alphaHashTabPos + (h * 4);
     FixedBytesToSignedNum(fst->fstStream,4,& pos,& offs);
     if (offs > 0) {
@@ -318,6 +491,19 @@ extern void picokfst_kfstGetNextPair (picokfst_FST this, picoos_int32 * searchSt
         (*pairFound) = 0;
         (*outSym) = PICOKFST_SYMID_ILLEG;
         (*pairClass) =  -1;
+#if defined(PICO_USE_KFST_EXPAND)
+    } else if (NULL != fst->xmem) {
+        *outSym = fst->xpairs[*searchState].sym;
+        if ((*outSym) != PICOKFST_SYMID_ILLEG) {
+            *pairClass = fst->xpairs[*searchState].val;
+            (*pairFound) = 1;
+            (*searchState)++;
+        } else {
+            (*pairFound) = 0;
+            (*pairClass) =  -1;
+            (*searchState) =  -1;
+        }
+#endif
     } else {
         pos = (*searchState);
         BytesToNum(fst->fstStream,& pos,& val);
@@ -352,9 +538,14 @@ extern void picokfst_kfstGetTrans (picokfst_FST this, picokfst_state_t startStat
         (*endState) = 0;
     } else {
         index = (startState - 1) * fst->nrClasses + transClass - 1;
-        pos = fst->transTabPos + (index * fst->transTabEntrySize);
-        FixedBytesToUnsignedNum(fst->fstStream,fst->transTabEntrySize,& pos,& endStateX);
-        (*endState) = endStateX;
+        if (fst->transTabEntrySize == 1) {
+            /* the table is already dense; single byte entries need no decoding */
+            (*endState) = fst->fstStream[fst->transTabPos + index];
+        } else {
+            pos = fst->transTabPos + (index * fst->transTabEntrySize);
+            FixedBytesToUnsignedNum(fst->fstStream,fst->transTabEntrySize,& pos,& endStateX);
+            (*endState) = endStateX;
+        }
     }
 }
 
@@ -370,6 +561,15 @@ extern void picokfst_kfstStartInEpsTransSearch (picokfst_FST this, picokfst_stat
     kfst_SubObj fst = (kfst_SubObj) this;
     (*searchState) =  -1;
     (*inEpsTransFound) = 0;
+#if defined(PICO_USE_KFST_EXPAND)
+    if ((startState > 0) && (startState <= fst->nrStates) && (NULL != fst->xmem)) {
+        if (fst->xepsHead[startState - 1] > 0) {
+            (*searchState) = fst->xepsHead[startState - 1] - 1;
+            (*inEpsTransFound) = 1;
+        }
+        return;
+    }
+#endif
     if ((startState > 0) && (startState <= fst->nrStates)) {
         pos = fst->inEpsStateTabPos + (startState - 1) * 4;
         FixedBytesToSignedNum(fst->fstStream,4,& pos,& offs);
@@ -395,6 +595,19 @@ extern void picokfst_kfstGetNextInEpsTrans (picokfst_FST this, picoos_int32 * se
         (*inEpsTransFound) = 0;
         (*outSym) = PICOKFST_SYMID_ILLEG;
         (*endState) = 0;
+#if defined(PICO_USE_KFST_EXPAND)
+    } else if (NULL != fst->xmem) {
+        *outSym = fst->xpairs[*searchState].sym;
+        if ((*outSym) != PICOKFST_SYMID_ILLEG) {
+            *endState = fst->xpairs[*searchState].val;
+            (*inEpsTransFound) = 1;
+            (*searchState)++;
+        } else {
+            (*inEpsTransFound) = 0;
+            (*endState) = 0;
+            (*searchState) =  -1;
+        }
+#endif
     } else {
         pos = (*searchState);
         BytesToNum(fst->fstStream,& pos,& val);
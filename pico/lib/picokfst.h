@@ -79,6 +79,17 @@ enum picofst_transduction_mode {
 };
 
 
+/* When PICO_USE_KFST_EXPAND is defined, the pair alphabet and the input
+   epsilon transitions of every FST are decoded at load time into arrays
+   of fixed-size records, so that the pair and input epsilon searches no
+   longer decode variable-length numbers from the packed byte stream.
+   The transition table is already a dense state x class table and is
+   read in place. FSTs whose expanded form would exceed 16KB, or that
+   cannot be expanded for lack of memory, are accessed in packed form.
+   The expanded FSTs need 12KB to 25KB of additional system memory per
+   language.
+   Enable with: -DPICO_USE_KFST_EXPAND=1 */
+
 /* ************************************************************/
 /* function to create specialized kb, */
 /* to be used by knowledge layer (picorsrc) only */
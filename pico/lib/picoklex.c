@@ -126,6 +126,18 @@ extern "C" {
 #define PICOKLEX_NEEDS_G2P   5
 
 
+#if defined(PICO_USE_LEX_HASH)
+/* graph hash index: open addressing with linear probing; each slot
+   holds (lexpos + 1) in the lower PICOKLEX_HASH_POSBITS bits and the
+   upper bits of the graph hash as tag, 0 marks an empty slot. With
+   the table at most half full almost all lookups are decided by the
+   first slot, and the tag avoids comparing graphs of other slots */
+#define PICOKLEX_HASH_POSBITS    24
+#define PICOKLEX_HASH_POSMASK    0x00ffffff
+#define PICOKLEX_HASH_TAGMASK    0xff000000
+#endif
+
+
 /* ************************************************************/
 /* lexicon type and loading */
 /* ************************************************************/
@@ -142,9 +154,18 @@ typedef struct klex_subobj
     picoos_uint16 nrblocks; /* nr lexblocks = nr eles in searchind */
     picoos_uint8 *searchind;
     picoos_uint8 *lexblocks;
+#if defined(PICO_USE_LEX_HASH)
+    picoos_uint32 hashmask; /* nr hash slots - 1, slots is power of 2 */
+    picoos_uint32 *hashind; /* NULL if no hash index available */
+#endif
 } klex_subobj_t;
 
 
+#if defined(PICO_USE_LEX_HASH)
+static void klexHashInitialize(klex_subobj_t *klex, picoos_Common common);
+#endif
+
+
 static pico_status_t klexInitialize(register picoknow_KnowledgeBase this,
                                     picoos_Common common)
 {
@@ -171,6 +192,9 @@ static pico_status_t klexInitialize(register picoknow_KnowledgeBase this,
         }
         klex->lexblocks = this->base + PICOKLEX_LEX_NRBLOCKS_SIZE +
                              (klex->nrblocks * (PICOKLEX_LEX_SIE_SIZE));
+#if defined(PICO_USE_LEX_HASH)
+        klexHashInitialize(klex, common);
+#endif
         return PICO_OK;
     } else {
         return picoos_emRaiseException(common->em, PICO_EXC_FILE_CORRUPT,
@@ -183,6 +207,12 @@ static pico_status_t klexSubObjDeallocate(register picoknow_KnowledgeBase this,
                                           picoos_MemoryManager mm)
 {
     if (NULL != this) {
+#if defined(PICO_USE_LEX_HASH)
+        if (NULL != this->subObj) {
+            picoos_deallocate(mm,
+                    (void *) &(((klex_subobj_t *) this->subObj)->hashind));
+        }
+#endif
         picoos_deallocate(mm, (void *) &this->subObj);
     }
     return PICO_OK;
@@ -475,6 +505,146 @@ static void klex_lexblockLookup(klex_SubObj this,
 }
 
 
+/* ************************************************************/
+/* functions on graph hash index */
+/* ************************************************************/
+
+#if defined(PICO_USE_LEX_HASH)
+
+/* FNV-1a hash over the graph bytes */
+static picoos_uint32 klex_hashGraph(const picoos_uint8 *graph,
+                                    const picoos_uint16 graphlen)
+{
+    picoos_uint32 hash = 2166136261U;
+    picoos_uint16 i;
+
+    for (i = 0; i < graphlen; i++) {
+        hash ^= graph[i];
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+
+/* advance from lexentry at 'lexpos' to the next lexentry, skipping the
+   zero padding at the end of a lexblock */
+static picoos_uint32 klex_nextEntry(const klex_subobj_t *klex,
+                                    picoos_uint32 lexpos,
+                                    const picoos_uint32 lexposEnd)
+{
+    lexpos += klex->lexblocks[lexpos];
+    lexpos += klex->lexblocks[lexpos];
+    while ((lexpos < lexposEnd) && (klex->lexblocks[lexpos] == 0)) {
+        lexpos++;
+    }
+    return lexpos;
+}
+
+
+static void klex_hashInsert(klex_subobj_t *klex, const picoos_uint32 lexpos)
+{
+    picoos_uint32 hash, i;
+    picoos_uint8 *lexentry = &(klex->lexblocks[lexpos]);
+
+    hash = klex_hashGraph(&(lexentry[1]), (picoos_uint16)(lexentry[0] - 1));
+    i = hash & klex->hashmask;
+    while (klex->hashind[i] != 0) {
+        i = (i + 1) & klex->hashmask;
+    }
+    klex->hashind[i] = (hash & PICOKLEX_HASH_TAGMASK) | (lexpos + 1);
+}
+
+
+/* build the graph hash index; only the first of several lexentries
+   with identical graph is entered, the others follow it directly in
+   the lexblocks. If there is not enough memory the lexicon is used
+   without hash index. */
+static void klexHashInitialize(klex_subobj_t *klex, picoos_Common common)
+{
+    picoos_uint32 lexpos, lexposEnd, prevpos, nrgraphs, nrslots, i;
+
+    klex->hashind = NULL;
+    klex->hashmask = 0;
+
+    lexposEnd = (picoos_uint32)klex->nrblocks * PICOKLEX_LEXBLOCK_SIZE;
+    if ((klex->nrblocks == 0) || (lexposEnd >= PICOKLEX_HASH_POSMASK)) {
+        return;
+    }
+
+    /* count distinct graphs */
+    nrgraphs = 0;
+    prevpos = lexposEnd;
+    lexpos = 0;
+    while (lexpos < lexposEnd) {
+        if ((prevpos == lexposEnd) ||
+            (klex_lexMatch(&(klex->lexblocks[lexpos]),
+                           &(klex->lexblocks[prevpos + 1]),
+                           (picoos_uint16)(klex->lexblocks[prevpos] - 1)) != 0)) {
+            nrgraphs++;
+        }
+        prevpos = lexpos;
+        lexpos = klex_nextEntry(klex, lexpos, lexposEnd);
+    }
+
+    /* at most half of the slots are used */
+    nrslots = 2;
+    while (nrslots < 2 * nrgraphs) {
+        nrslots <<= 1;
+    }
+    klex->hashind = picoos_allocate(common->mm,
+                                    nrslots * sizeof(picoos_uint32));
+    if (NULL == klex->hashind) {
+        PICODBG_WARN(("no memory for lex hash index (%d slots)", nrslots));
+        return;
+    }
+    klex->hashmask = nrslots - 1;
+    for (i = 0; i < nrslots; i++) {
+        klex->hashind[i] = 0;
+    }
+
+    prevpos = lexposEnd;
+    lexpos = 0;
+    while (lexpos < lexposEnd) {
+        if ((prevpos == lexposEnd) ||
+            (klex_lexMatch(&(klex->lexblocks[lexpos]),
+                           &(klex->lexblocks[prevpos + 1]),
+                           (picoos_uint16)(klex->lexblocks[prevpos] - 1)) != 0)) {
+            klex_hashInsert(klex, lexpos);
+        }
+        prevpos = lexpos;
+        lexpos = klex_nextEntry(klex, lexpos, lexposEnd);
+    }
+    PICODBG_DEBUG(("lex hash index: %d graphs, %d slots", nrgraphs, nrslots));
+}
+
+
+/* returns the position of the first lexentry for graph, or
+   lexposEnd if graph is not in the lexicon */
+static picoos_uint32 klex_hashLookup(const klex_subobj_t *klex,
+                                     const picoos_uint8 *graph,
+                                     const picoos_uint16 graphlen)
+{
+    picoos_uint32 hash, tag, slot, i, lexpos;
+
+    hash = klex_hashGraph(graph, graphlen);
+    tag = hash & PICOKLEX_HASH_TAGMASK;
+    i = hash & klex->hashmask;
+    while ((slot = klex->hashind[i]) != 0) {
+        if ((slot & PICOKLEX_HASH_TAGMASK) == tag) {
+            lexpos = (slot & PICOKLEX_HASH_POSMASK) - 1;
+            if (klex_lexMatch(&(klex->lexblocks[lexpos]), graph,
+                              graphlen) == 0) {
+                return lexpos;
+            }
+        }
+        i = (i + 1) & klex->hashmask;
+    }
+    return (picoos_uint32)klex->nrblocks * PICOKLEX_LEXBLOCK_SIZE;
+}
+
+#endif /* PICO_USE_LEX_HASH */
+
+
 /* ************************************************************/
 /* lexicon lookup functions */
 /* ************************************************************/
@@ -512,6 +682,19 @@ picoos_uint8 picoklex_lexLookup(const picoklex_Lex this,
         /* no searchindex, no lexblock */
         PICODBG_WARN(("no searchindex, no lexblock"));
         return FALSE;
+#if defined(PICO_USE_LEX_HASH)
+    } else if (NULL != klex->hashind) {
+        /* all lexentries with this graph follow the one found by the
+           hash index, collect them up to the end of the lexblocks */
+        lexposEnd = (picoos_uint32)klex->nrblocks * PICOKLEX_LEXBLOCK_SIZE;
+        lexposStart = klex_hashLookup(klex, graph, graphlen);
+        if (lexposStart < lexposEnd) {
+            klex_lexblockLookup(klex, lexposStart, lexposEnd, graph,
+                                graphlen, lexres);
+        }
+        PICODBG_DEBUG(("hash lookup done, %d found", lexres->nrres));
+        return (lexres->nrres > 0);
+#endif
     } else {
         lbnr = klex_getLexblockNr(klex, tgraph);
         PICODBG_ASSERT(lbnr < klex->nrblocks);
@@ -40,6 +40,19 @@ extern "C" {
 #endif
 
 
+/* ************************************************************/
+/* optional graph hash index */
+/* ************************************************************/
+
+/* When PICO_USE_LEX_HASH is defined, a hash index from graph to
+   lexentry position is built when the lexicon kb is specialized. It
+   lives next to the kb in resource memory and is shared by all
+   engines using the kb. It uses 8 to 16 bytes per distinct graph
+   (128KB for the en-US main lexicon) of additional system memory, so
+   it is off by default.
+
+   Enable with: -DPICO_USE_LEX_HASH=1 */
+
 /* ************************************************************/
 /* function to create specialized kb, */
 /* to be used by picorsrc only */
@@ -153,6 +153,7 @@ static pico_status_t kpdfMULInitialize(register picoknow_KnowledgeBase this,
                                        NULL, NULL);
     }
     pdfmul = (picokpdf_pdfmul_t *)this->subObj;
+    pdfmul->expanded = NULL;
 
     pos = 0;
 
@@ -280,6 +281,7 @@ static pico_status_t kpdfMULSubObjDeallocate(register picoknow_KnowledgeBase thi
         pdfmul = (picokpdf_pdfmul_t *)this->subObj;
         picoos_deallocate(mm,(void *) &(pdfmul->meanpowUm));
         picoos_deallocate(mm,(void *) &(pdfmul->ivarpow));
+        picoos_deallocate(mm,(void *) &(pdfmul->expanded));
         picoos_deallocate(mm, (void *) &(this->subObj));
     }
     return PICO_OK;
@@ -356,6 +358,110 @@ pico_status_t picokpdf_specializePdfKnowledgeBase(picoknow_KnowledgeBase this,
 }
 
 
+/* ************************************************************/
+/* pdf MUL expansion */
+/* ************************************************************/
+
+/* int16 at p, times 2^pow (shifting the absolute value of negative
+   values, as the cepstral smoothing PU does) */
+static picoos_int32 kpdfMULMean(const picoos_uint8 *p, picoos_uint8 pow) {
+    picoos_int32 mean;
+
+    mean = ((picoos_int32) ((picoos_int16) (p[1] << 8))) | p[0];
+    if (mean >= 0) {
+        return mean << pow;
+    }
+    return -(-mean << pow);
+}
+
+/* decode mean ('field' 0..2) or ivar ('field' 3..5) of coefficient
+   'cepnum' of the vector at 'vecstart'; for the sparse deltas the index
+   lists are searched the same way as in the cepstral smoothing PU */
+static picoos_int32 kpdfMULDecode(const picokpdf_pdfmul_t *pdfmul,
+                                  picoos_uint32 vecstart,
+                                  picoos_uint8 field, picoos_uint8 cepnum) {
+    const picoos_uint8 *v = pdfmul->content + vecstart + pdfmul->numvuv;
+    picoos_uint8 order = pdfmul->ceporder;
+    picoos_uint8 stream = field % KPDF_NUMSTREAMS;
+    picoos_uint8 cc = stream * order + cepnum;
+    picoos_uint8 s, ind;
+
+    if (field >= KPDF_NUMSTREAMS) {
+        if (pdfmul->numdeltas == 0xFF) {
+            return (picoos_int32) v[order * 6 + cc] << pdfmul->ivarpow[cc];
+        }
+        return (picoos_int32) v[order * 2 + pdfmul->numdeltas * 3
+                                + cc] << pdfmul->ivarpow[cc];
+    }
+    if ((pdfmul->numdeltas == 0xFF) || (0 == stream)) {
+        return kpdfMULMean(v + cc * 2, pdfmul->meanpowUm[cc]);
+    }
+    if (1 == stream) {
+        /* ascending search of the sparse delta indices */
+        s = 0;
+        ind = 0;
+        while ((s < pdfmul->numdeltas)
+               && ((ind < cepnum) || ((ind == 0) && (cepnum == 0)))) {
+            ind = v[order * 2 + s];
+            if (ind == cepnum) {
+                return kpdfMULMean(v + order * 2 + pdfmul->numdeltas + s * 2,
+                                   pdfmul->meanpowUm[cc]);
+            }
+            s++;
+        }
+    } else {
+        /* descending search of the sparse delta delta indices */
+        s = pdfmul->numdeltas;
+        ind = 2 * order;
+        while ((s-- > 0) && (ind > order + cepnum)) {
+            ind = v[order * 2 + s];
+            if (ind == order + cepnum) {
+                return kpdfMULMean(v + order * 2 + pdfmul->numdeltas + s * 2,
+                                   pdfmul->meanpowUm[cc]);
+            }
+        }
+    }
+    return 0;
+}
+
+pico_status_t picokpdf_expandPdfMUL(picoknow_KnowledgeBase this,
+                                    picoos_Common common) {
+    picokpdf_pdfmul_t *pdfmul;
+    picoos_int32 *e;
+    picoos_uint16 i;
+    picoos_uint8 f, c;
+
+    if ((NULL == this) || (NULL == this->subObj)) {
+        return PICO_ERR_NULLPTR_ACCESS;
+    }
+    pdfmul = (picokpdf_pdfmul_t *)this->subObj;
+    if (NULL != pdfmul->expanded) {
+        return PICO_OK;
+    }
+    pdfmul->expanded = picoos_allocate(common->mm,
+            (picoos_objsize_t) pdfmul->numframes * PICOKPDF_MUL_NUMFIELDS
+            * pdfmul->ceporder * sizeof(picoos_int32));
+    if (NULL == pdfmul->expanded) {
+        PICODBG_WARN(("no memory to expand MUL pdf"));
+        return PICO_EXC_OUT_OF_MEM;
+    }
+    e = pdfmul->expanded;
+    for (i = 0; i < pdfmul->numframes; i++) {
+        for (f = 0; f < PICOKPDF_MUL_NUMFIELDS; f++) {
+            for (c = 0; c < pdfmul->ceporder; c++) {
+                *e++ = kpdfMULDecode(pdfmul,
+                        (picoos_uint32) i * pdfmul->vecsize, f, c);
+            }
+        }
+    }
+    PICODBG_DEBUG(("expanded MUL pdf: %i vectors, %i bytes",
+                   pdfmul->numframes, (picoos_int32) pdfmul->numframes
+                   * PICOKPDF_MUL_NUMFIELDS * pdfmul->ceporder
+                   * sizeof(picoos_int32)));
+    return PICO_OK;
+}
+
+
 /* ************************************************************/
 /* pdf getPdf* */
 /* ************************************************************/
@@ -122,6 +122,7 @@ typedef struct picokpdf_pdfmul {
     picoos_uint8 *meanpowUm;  /* KPDF_NUMSTREAMS x ceporder values */
     picoos_uint8 *ivarpow;    /* KPDF_NUMSTREAMS x ceporder values */
     picoos_uint8 *content;
+    picoos_int32 *expanded;   /* NULL or numframes x PICOKPDF_MUL_NUMFIELDS x ceporder values, see picokpdf_expandPdfMUL */
 } picokpdf_pdfmul_t;
 
 /* subobj specific for pdf phs type */
@@ -152,6 +153,33 @@ picokpdf_PdfPHS picokpdf_getPdfPHS(picoknow_KnowledgeBase this);
 /* PDF MUL functions */
 /* ************************************************************/
 
+/* The means and inverse variances of a MUL pdf are stored quantized
+   (int16 means and uint8 inverse variances, each with a per coefficient
+   scale, deltas possibly sparse) and are dequantized by the cepstral
+   smoothing PU each time a frame is set up. picokpdf_expandPdfMUL
+   decodes all vectors once into a table of int32 values, scaled exactly
+   as the PU uses them: per pdf vector PICOKPDF_MUL_NUMFIELDS rows of
+   ceporder values, in the order static mean, delta mean, delta delta
+   mean, static ivar, delta ivar, delta delta ivar (missing sparse deltas
+   are 0). The table costs numframes x 6 x ceporder x 4 bytes of system
+   memory (LFZ and MGC together: 2.0MB for en-US, 2.2MB for fr-FR, 1.6MB
+   for the other voices), is shared by all engines using the resource and
+   freed with it. It is built on request of a voice (voice option
+   PICORSRC_VOPT_PDF_EXPAND), calling it again is a no-op. Returns
+   PICO_EXC_OUT_OF_MEM without raising an exception if the table does
+   not fit; the pdf then stays usable as it is. */
+
+#define PICOKPDF_MUL_NUMFIELDS 6
+
+/* position of value 'cepnum' of row 'field' of pdf vector 'index' in the
+   expanded table */
+#define PICOKPDF_MUL_EXPANDED_POS(pdf, index, field, cepnum) \
+    ((((picoos_uint32) (index) * PICOKPDF_MUL_NUMFIELDS + (field)) \
+            * (pdf)->ceporder) + (cepnum))
+
+pico_status_t picokpdf_expandPdfMUL(picoknow_KnowledgeBase this,
+                                    picoos_Common common);
+
 #ifdef __cplusplus
 }
 #endif
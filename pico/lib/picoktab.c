@@ -191,15 +191,191 @@ static picoos_uint32 ktab_propOffset (const picoktab_Graphs this, picoos_uint32
 
 typedef struct ktabgraphs_subobj *ktabgraphs_SubObj;
 
+/* Single characters of the Basic Multilingual Plane are mapped directly to
+   their graph with a two-level table: 'pageMap' holds the page number of
+   each block of KTAB_GRAPHS_PAGE_SIZE code points, page 0 being all empty,
+   and 'pages' holds the graph number + 1 of each code point (0: no graph).
+   'props' holds the precomputed properties of each graph. The tables are
+   only allocated for the pages containing graphs, which usually is a
+   couple of pages (about 2KB). If they cannot be built, all lookups use
+   the binary search. */
+#define KTAB_GRAPHS_PAGE_BITS           8
+#define KTAB_GRAPHS_PAGE_SIZE           (1 << KTAB_GRAPHS_PAGE_BITS)
+#define KTAB_GRAPHS_NR_PAGES            (0x10000 >> KTAB_GRAPHS_PAGE_BITS)
+#define KTAB_GRAPHS_MAX_PAGES           255
+
 typedef struct ktabgraphs_subobj {
     picoos_uint16 nrOffset;
     picoos_uint16 sizeOffset;
 
     picoos_uint8 * offsetTable;
     picoos_uint8 * graphTable;
+
+    picoktab_graph_props_t * props;
+    picoos_uint16 * pages;
+    picoos_uint8 * pageMap;
 } ktabgraphs_subobj_t;
 
 
+static picoos_uint32 ktab_searchGraph(const picoktab_Graphs this,
+        picoos_uchar * utf8graph, picoos_int32 * graphIndex);
+static void ktab_getGraphProps(const picoktab_Graphs this,
+        picoos_uint32 graphsOffset, picoktab_graph_props_t * props);
+
+
+/* get offset to graph number 'graphIndex' */
+static picoos_uint32 ktab_graphIndexOffset(const ktabgraphs_subobj_t * g,
+        picoos_int32 graphIndex)
+{
+    if (g->sizeOffset == 1) {
+        return g->offsetTable[graphIndex];
+    } else {
+        return g->offsetTable[2 * graphIndex]
+                + 256 * g->offsetTable[2 * graphIndex + 1];
+    }
+}
+
+
+/* code point of the UTF8 char at 'utf8' (at most PICOBASE_UTF8_MAXLEN
+   bytes, as determined by picobase_det_utf8_length) */
+static picoos_uint32 ktab_utf8ToUtf32(const picoos_uchar * utf8)
+{
+    switch (picobase_det_utf8_length(utf8[0])) {
+        case 1:
+            return utf8[0];
+        case 2:
+            return ((utf8[0] & 0x1f) << 6) | (utf8[1] & 0x3f);
+        case 3:
+            return ((utf8[0] & 0x0f) << 12) | ((utf8[1] & 0x3f) << 6)
+                    | (utf8[2] & 0x3f);
+        default:
+            return ((utf8[0] & 0x07) << 18) | ((utf8[1] & 0x3f) << 12)
+                    | ((utf8[2] & 0x3f) << 6) | (utf8[3] & 0x3f);
+    }
+}
+
+
+/* zero-terminated UTF8 char of BMP code point 'c' */
+static void ktab_utf32ToUtf8(picoos_uint32 c, picoos_uchar * utf8)
+{
+    if (c < 0x80) {
+        *utf8++ = (picoos_uchar) c;
+    } else if (c < 0x800) {
+        *utf8++ = (picoos_uchar) (0xc0 | (c >> 6));
+        *utf8++ = (picoos_uchar) (0x80 | (c & 0x3f));
+    } else {
+        *utf8++ = (picoos_uchar) (0xe0 | (c >> 12));
+        *utf8++ = (picoos_uchar) (0x80 | ((c >> 6) & 0x3f));
+        *utf8++ = (picoos_uchar) (0x80 | (c & 0x3f));
+    }
+    *utf8 = 0;
+}
+
+
+/* Returns the graph number + 1 of 'utf8graph' (0 if it has no graph) if
+   it can be looked up in the direct-mapped table, i.e. if it is a single
+   well-formed UTF8 char of the BMP, and -1 otherwise */
+static picoos_int32 ktab_mappedGraph(const ktabgraphs_subobj_t * g,
+        const picoos_uchar * utf8graph)
+{
+    picoos_uint32 c;
+
+    if (NULL == g->pageMap) {
+        return -1;
+    }
+    if (utf8graph[0] < 0x80) {
+        if ((0 == utf8graph[0]) || (0 != utf8graph[1])) {
+            return -1;
+        }
+        c = utf8graph[0];
+    } else if ((utf8graph[0] >= 0xc2) && (utf8graph[0] < 0xe0)) {
+        if (((utf8graph[1] & 0xc0) != 0x80) || (0 != utf8graph[2])) {
+            return -1;
+        }
+        c = ((utf8graph[0] & 0x1f) << 6) | (utf8graph[1] & 0x3f);
+    } else if ((utf8graph[0] >= 0xe0) && (utf8graph[0] < 0xf0)) {
+        if (((utf8graph[1] & 0xc0) != 0x80) || ((utf8graph[2] & 0xc0) != 0x80)
+                || (0 != utf8graph[3])) {
+            return -1;
+        }
+        c = ((utf8graph[0] & 0x0f) << 12) | ((utf8graph[1] & 0x3f) << 6)
+                | (utf8graph[2] & 0x3f);
+        if (c < 0x800) {
+            return -1; /* overlong */
+        }
+    } else {
+        return -1;
+    }
+    return g->pages[(g->pageMap[c >> KTAB_GRAPHS_PAGE_BITS] << KTAB_GRAPHS_PAGE_BITS)
+                    + (c & (KTAB_GRAPHS_PAGE_SIZE - 1))];
+}
+
+
+/* build the direct-mapped table; the table entries are the results of the
+   binary search, so both lookups are guaranteed to agree */
+static void ktabGraphsBuildMap(ktabgraphs_subobj_t * g, picoos_Common common)
+{
+    picoos_uint8 used[KTAB_GRAPHS_NR_PAGES];
+    picobase_utf8char utf8;
+    picoos_uint32 graphsOffset, c, cFrom, cTo, page, nrPages, size;
+    picoos_uint32 propOffset;
+    picoos_int32 i, m;
+
+    /* determine the pages containing graphs */
+    picoos_mem_set(used, 0, sizeof(used));
+    for (i = 0; i < g->nrOffset; i++) {
+        graphsOffset = ktab_graphIndexOffset(g, i);
+        cFrom = ktab_utf8ToUtf32(&g->graphTable[graphsOffset + 1]);
+        propOffset = ktab_propOffset((picoktab_Graphs) g, graphsOffset, KTAB_GRAPH_PROPSET_TO);
+        cTo = (propOffset > 0) ? ktab_utf8ToUtf32(&g->graphTable[graphsOffset + propOffset]) : cFrom;
+        for (c = cFrom; (c <= cTo) && (c < 0x10000); c += KTAB_GRAPHS_PAGE_SIZE) {
+            used[c >> KTAB_GRAPHS_PAGE_BITS] = 1;
+        }
+        if ((cFrom <= cTo) && (cTo < 0x10000)) {
+            used[cTo >> KTAB_GRAPHS_PAGE_BITS] = 1;
+        }
+    }
+    nrPages = 0;
+    for (page = 0; page < KTAB_GRAPHS_NR_PAGES; page++) {
+        nrPages += used[page];
+    }
+    if (nrPages > KTAB_GRAPHS_MAX_PAGES) {
+        return;
+    }
+
+    size = g->nrOffset * sizeof(picoktab_graph_props_t)
+            + (nrPages + 1) * KTAB_GRAPHS_PAGE_SIZE * sizeof(picoos_uint16)
+            + KTAB_GRAPHS_NR_PAGES;
+    g->props = picoos_allocate(common->mm, size);
+    if (NULL == g->props) {
+        PICODBG_WARN(("no memory for direct-mapped graph table (%i bytes)", size));
+        return;
+    }
+    g->pages = (picoos_uint16 *) &g->props[g->nrOffset];
+    g->pageMap = (picoos_uint8 *) &g->pages[(nrPages + 1) * KTAB_GRAPHS_PAGE_SIZE];
+    picoos_mem_set(g->pages, 0, (nrPages + 1) * KTAB_GRAPHS_PAGE_SIZE * sizeof(picoos_uint16));
+    nrPages = 0;
+    for (page = 0; page < KTAB_GRAPHS_NR_PAGES; page++) {
+        g->pageMap[page] = used[page] ? (picoos_uint8) ++nrPages : 0;
+    }
+
+    for (i = 0; i < g->nrOffset; i++) {
+        graphsOffset = ktab_graphIndexOffset(g, i);
+        ktab_getGraphProps((picoktab_Graphs) g, graphsOffset, &g->props[i]);
+        cFrom = ktab_utf8ToUtf32(&g->graphTable[graphsOffset + 1]);
+        propOffset = ktab_propOffset((picoktab_Graphs) g, graphsOffset, KTAB_GRAPH_PROPSET_TO);
+        cTo = (propOffset > 0) ? ktab_utf8ToUtf32(&g->graphTable[graphsOffset + propOffset]) : cFrom;
+        for (c = cFrom; (c <= cTo) && (c < 0x10000); c++) {
+            ktab_utf32ToUtf8(c, utf8);
+            if (ktab_searchGraph((picoktab_Graphs) g, utf8, &m) > 0) {
+                g->pages[(g->pageMap[c >> KTAB_GRAPHS_PAGE_BITS] << KTAB_GRAPHS_PAGE_BITS)
+                         + (c & (KTAB_GRAPHS_PAGE_SIZE - 1))] = (picoos_uint16) (m + 1);
+            }
+        }
+    }
+    PICODBG_DEBUG(("direct-mapped graph table: %i pages, %i bytes", nrPages, size));
+}
+
 
 static pico_status_t ktabGraphsInitialize(register picoknow_KnowledgeBase this,
                                           picoos_Common common) {
@@ -216,12 +392,22 @@ static pico_status_t ktabGraphsInitialize(register picoknow_KnowledgeBase this,
     ktabgraphs->sizeOffset  = (int)(this->base[KTAB_START_GRAPHS_SIZE_OFFSET]);
     ktabgraphs->offsetTable = &(this->base[KTAB_START_GRAPHS_OFFSET_TABLE]);
     ktabgraphs->graphTable  = &(this->base[KTAB_START_GRAPHS_GRAPH_TABLE]);
+    ktabgraphs->props = NULL;
+    ktabgraphs->pages = NULL;
+    ktabgraphs->pageMap = NULL;
+    ktabGraphsBuildMap(ktabgraphs, common);
     return PICO_OK;
 }
 
 static pico_status_t ktabGraphsSubObjDeallocate(register picoknow_KnowledgeBase this,
                                                 picoos_MemoryManager mm) {
+    ktabgraphs_subobj_t * ktabgraphs;
+
     if (NULL != this) {
+        ktabgraphs = (ktabgraphs_subobj_t *) this->subObj;
+        if (NULL != ktabgraphs) {
+            picoos_deallocate(mm, (void *) &ktabgraphs->props);
+        }
         picoos_deallocate(mm, (void *) &this->subObj);
     }
     return PICO_OK;
@@ -261,11 +447,15 @@ picoos_uint8 picoktab_hasVowellikeProp(const picoktab_Graphs this,
 
   picoos_uint8 ui8App;
   picoos_uint32 graphsOffset;
+  picoktab_graph_props_t props;
   ktabgraphs_subobj_t * g = (ktabgraphs_SubObj)this;
 
   ui8App = graphlenmax;        /* avoid warning "var not used in this function"*/
 
-  graphsOffset = picoktab_graphOffset (this, (picoos_uchar *)graph);
+  if (picoktab_getGraphProps(this, (picoos_uchar *)graph, &props)) {
+    return props.tokenType == PICODATA_ITEMINFO1_TOKTYPE_LETTERV;
+  }
+  graphsOffset = 0;
   return g->graphTable[graphsOffset + ktab_propOffset (this, graphsOffset, KTAB_GRAPH_PROPSET_TOKENTYPE)] == PICODATA_ITEMINFO1_TOKTYPE_LETTERV;
 }
 
@@ -366,7 +556,9 @@ static picoos_uint32 ktab_propOffset(const picoktab_Graphs this,
 }
 
 
-picoos_uint32 picoktab_graphOffset (const picoktab_Graphs this, picoos_uchar * utf8graph)
+/* binary search of 'utf8graph' in the graph table; returns the graph
+   offset (0 if not found) and the graph number in 'graphIndex' */
+static picoos_uint32 ktab_searchGraph (const picoktab_Graphs this, picoos_uchar * utf8graph, picoos_int32 * graphIndex)
 {  ktabgraphs_subobj_t * g = (ktabgraphs_SubObj)this;
    picoos_int32 a, b, m;
    picoos_uint32 graphsOffset;
@@ -411,6 +603,7 @@ picoos_uint32 picoktab_graphOffset (const picoktab_Graphs this, picoos_uchar * u
        if (utfGEfrom && utfLEto) {
          /* PICODBG_DEBUG(("picoktab_graphOffset: utf char '%s' found", utf8graph));
           */
+         *graphIndex = m;
          return graphsOffset;
        }
        if (!utfGEfrom) {
@@ -422,10 +615,61 @@ picoos_uint32 picoktab_graphOffset (const picoktab_Graphs this, picoos_uchar * u
      } while (a<=b);
    }
    PICODBG_DEBUG(("picoktab_graphOffset: utf char '%s' not found", utf8graph));
+   *graphIndex = -1;
    return 0;
 }
 
 
+picoos_uint32 picoktab_graphOffset (const picoktab_Graphs this, picoos_uchar * utf8graph)
+{
+  ktabgraphs_subobj_t * g = (ktabgraphs_SubObj)this;
+  picoos_int32 n;
+
+  n = ktab_mappedGraph(g, utf8graph);
+  if (n > 0) {
+    return g->props[n-1].graphsOffset;
+  }
+  else if (n == 0) {
+    return 0;
+  }
+  return ktab_searchGraph(this, utf8graph, &n);
+}
+
+
+/* decode the properties of the graph at 'graphsOffset' */
+static void ktab_getGraphProps (const picoktab_Graphs this, picoos_uint32 graphsOffset, picoktab_graph_props_t * props)
+{
+  props->graphsOffset = (picoos_uint16)graphsOffset;
+  props->tokenType = PICODATA_ITEMINFO1_TOKTYPE_UNDEFINED;
+  props->tokenSubType = -1;
+  props->lowercase[0] = NULLC;
+  if (graphsOffset > 0) {
+    picoktab_getIntPropTokenType(this, graphsOffset, &props->tokenType);
+    picoktab_getIntPropTokenSubType(this, graphsOffset, &props->tokenSubType);
+    picoktab_getStrPropLowercase(this, graphsOffset, props->lowercase);
+  }
+}
+
+
+picoos_bool picoktab_getGraphProps (const picoktab_Graphs this, picoos_uchar * utf8graph, picoktab_graph_props_t * props)
+{
+  ktabgraphs_subobj_t * g = (ktabgraphs_SubObj)this;
+  picoos_int32 n;
+
+  n = ktab_mappedGraph(g, utf8graph);
+  if (n > 0) {
+    *props = g->props[n-1];
+  }
+  else if (n == 0) {
+    ktab_getGraphProps(this, 0, props);
+  }
+  else {
+    ktab_getGraphProps(this, ktab_searchGraph(this, utf8graph, &n), props);
+  }
+  return props->graphsOffset > 0;
+}
+
+
 
 
 picoos_bool  picoktab_getIntPropTokenType (const picoktab_Graphs this, picoos_uint32 graphsOffset, picoos_uint8 * stokenType)
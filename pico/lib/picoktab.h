@@ -37,6 +37,7 @@
 
 #include "picoos.h"
 #include "picoknow.h"
+#include "picobase.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -87,6 +88,25 @@ picoos_uint32 picoktab_graphOffset(const picoktab_Graphs this,
                                    picoos_uchar * utf8graph);
 
 
+/* precomputed properties of a graph: 'graphsOffset' is the graph offset
+   as returned by picoktab_graphOffset (0 if the graph does not exist);
+   'tokenType' is PICODATA_ITEMINFO1_TOKTYPE_UNDEFINED and 'tokenSubType'
+   is -1 if the graph has no such property, 'lowercase' is empty if the
+   graph has no LOWERCASE property */
+typedef struct picoktab_graph_props {
+    picoos_uint16 graphsOffset;
+    picoos_uint8 tokenType;
+    picoos_int8 tokenSubType;
+    picobase_utf8char lowercase;
+} picoktab_graph_props_t;
+
+/* get the properties of 'utf8graph' in one step; returns TRUE if the graph
+   exists. Single characters of the Basic Multilingual Plane are looked up
+   in a direct-mapped table built when the kb is specialized */
+picoos_bool picoktab_getGraphProps(const picoktab_Graphs this,
+                                   picoos_uchar * utf8graph,
+                                   picoktab_graph_props_t * props);
+
 /* check if UTF8 char 'graph' has property vowellike, return non-zero
    if 'ch' has the property, 0 otherwise */
 picoos_uint8 picoktab_hasVowellikeProp(const picoktab_Graphs this,
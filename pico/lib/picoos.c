@@ -1422,7 +1422,7 @@ typedef struct picoos_sd_file
     picoos_uint32 nrFileSamples;
     picoos_int16 buf[PICOOS_SDF_BUF_LEN];
     picoos_int32 bufPos;
-    picoos_uint8 bBuf[2*PICOOS_SDF_BUF_LEN];
+    picoos_uint8 bBuf[4*PICOOS_SDF_BUF_LEN]; /* PICOOS_ENC_FLOAT: the samples */
     picoos_bool aborted;
 } picoos_sd_file_t;
 
@@ -1690,6 +1690,11 @@ static picoos_bool picoos_writeWavHeader(picoos_File f, picoos_uint32 sf,
             bytesPerSample = 1;
             sampleSize = 8;
             break;
+        case PICOOS_ENC_FLOAT:
+            formatTag = FORMAT_TAG_FLOAT;
+            bytesPerSample = 4;
+            sampleSize = 32;
+            break;
         default:
             done = FALSE;
             break;
@@ -1734,12 +1739,14 @@ extern picoos_bool picoos_sdfOpenOut(picoos_Common g, picoos_SDFile * sdFile,
     sdf->sf = sf;
     sdf->enc = enc;
     /* check whether sd file properties are supported */
-    if (PICOOS_ENC_LIN != sdf->enc) {
+    if ((PICOOS_ENC_LIN != sdf->enc) && (PICOOS_ENC_FLOAT != sdf->enc)) {
         done = FALSE;
         picoos_emRaiseWarning(g->em, PICO_EXC_UNEXPECTED_FILE_TYPE, NULL,
                 (picoos_char *) "encoding not supported");
     }
-    if (SAMPLE_FREQ_16KHZ != sdf->sf) {
+    if ((SAMPLE_FREQ_16KHZ != sdf->sf) && (SAMPLE_FREQ_8KHZ != sdf->sf)
+            && (SAMPLE_FREQ_22KHZ != sdf->sf) && (SAMPLE_FREQ_24KHZ != sdf->sf)
+            && (SAMPLE_FREQ_48KHZ != sdf->sf)) {
         done = FALSE;
         picoos_emRaiseWarning(g->em, PICO_EXC_UNEXPECTED_FILE_TYPE, NULL,
                 (picoos_char *) "sample frequency not supported");
@@ -1798,6 +1805,11 @@ static picoos_bool picoos_sdfFlushOutBuf(picoos_SDFile sdFile)
                 done = picoos_WriteBytes(sdFile->file, sdFile->bBuf, &len)
                         && ((nrSamples * 2) == len);
                 break;
+            case PICOOS_ENC_FLOAT:
+                len = (nrSamples * 4);
+                done = picoos_WriteBytes(sdFile->file, sdFile->bBuf, &len)
+                        && ((nrSamples * 4) == len);
+                break;
             case PICOOS_ENC_ULAW:
             case PICOOS_ENC_ALAW:
             default:
@@ -1821,6 +1833,24 @@ extern picoos_bool picoos_sdfFlushOutput(picoos_SDFile sdFile)
 
 
 
+/* puts float 'f' as 4 little endian bytes of a PICOOS_ENC_FLOAT file */
+static void picoos_sdfPutFloat(picoos_SDFile sdFile, picoos_single f)
+{
+    union {
+        picoos_single f;
+        picoos_uint32 u;
+    } v;
+    picoos_uint8 * b;
+
+    v.f = f;
+    b = &(sdFile->bBuf[4 * sdFile->bufPos]);
+    b[0] = (picoos_uint8) (v.u & 0xff);
+    b[1] = (picoos_uint8) ((v.u >> 8) & 0xff);
+    b[2] = (picoos_uint8) ((v.u >> 16) & 0xff);
+    b[3] = (picoos_uint8) (v.u >> 24);
+    sdFile->bufPos++;
+}
+
 extern picoos_bool picoos_sdfPutSamples (picoos_SDFile sdFile, picoos_uint32 nrSamples, picoos_int16 samples[])
 {
     picoos_uint32 i;
@@ -1831,12 +1861,48 @@ extern picoos_bool picoos_sdfPutSamples (picoos_SDFile sdFile, picoos_uint32 nrS
         done = TRUE;
         for (i = 0; i < nrSamples; i++) {
             s = samples[i];
-            if ((s > PICOOS_INT16_MAX)) {
-                s = PICOOS_INT16_MAX;
-            } else if (s < PICOOS_INT16_MIN) {
-                s = PICOOS_INT16_MIN;
+            if (PICOOS_ENC_FLOAT == sdFile->enc) {
+                picoos_sdfPutFloat(sdFile, (picoos_single) s * (1.0f / 32768.0f));
+            } else {
+                if ((s > PICOOS_INT16_MAX)) {
+                    s = PICOOS_INT16_MAX;
+                } else if (s < PICOOS_INT16_MIN) {
+                    s = PICOOS_INT16_MIN;
+                }
+                sdFile->buf[sdFile->bufPos++] = s;
+            }
+            if (sdFile->bufPos >= PICOOS_SDF_BUF_LEN) {
+                done = picoos_sdfFlushOutBuf(sdFile);
+            }
+        }
+    } else {
+        done = FALSE;
+    }
+    return done;
+}
+
+extern picoos_bool picoos_sdfPutFloatSamples (picoos_SDFile sdFile, picoos_uint32 nrSamples, const picoos_single samples[])
+{
+    picoos_uint32 i;
+    picoos_single f;
+    picoos_bool done = FALSE;
+
+    if ((sdFile != NULL) &&  !(sdFile->aborted)) {
+        done = TRUE;
+        for (i = 0; i < nrSamples; i++) {
+            if (PICOOS_ENC_FLOAT == sdFile->enc) {
+                picoos_sdfPutFloat(sdFile, samples[i]);
+            } else {
+                f = samples[i] * 32768.0f;
+                if (f >= PICOOS_INT16_MAX) {
+                    sdFile->buf[sdFile->bufPos++] = PICOOS_INT16_MAX;
+                } else if (f <= PICOOS_INT16_MIN) {
+                    sdFile->buf[sdFile->bufPos++] = PICOOS_INT16_MIN;
+                } else {
+                    sdFile->buf[sdFile->bufPos++] = (picoos_int16)
+                            ((f >= 0) ? (f + 0.5f) : (f - 0.5f));
+                }
             }
-            sdFile->buf[sdFile->bufPos++] = s;
             if (sdFile->bufPos >= PICOOS_SDF_BUF_LEN) {
                 done = picoos_sdfFlushOutBuf(sdFile);
             }
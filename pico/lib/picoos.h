@@ -358,6 +358,12 @@ picoos_bool  picoos_Rename(picoos_char oldName[], picoos_char newName[]);
 /* *****************************************************************/
 
 #define SAMPLE_FREQ_16KHZ (picoos_uint32) 16000
+/* output rates of the signal generation (see picosigrs.h); sampled data
+   files are read at 16kHz only */
+#define SAMPLE_FREQ_8KHZ  (picoos_uint32) 8000
+#define SAMPLE_FREQ_22KHZ (picoos_uint32) 22050
+#define SAMPLE_FREQ_24KHZ (picoos_uint32) 24000
+#define SAMPLE_FREQ_48KHZ (picoos_uint32) 48000
 
 typedef enum {
     FILE_TYPE_WAV,
@@ -368,6 +374,7 @@ typedef enum {
 
 typedef enum {
     FORMAT_TAG_LIN = 1, /**< linear 16-bit encoding */
+    FORMAT_TAG_FLOAT = 3, /**< IEEE float encoding, 32 bit */
     FORMAT_TAG_ALAW = 6, /**< a-law encoding, 8 bit */
     FORMAT_TAG_ULAW = 7 /**< u-law encoding, 8 bit */
     /* there are many more */
@@ -377,6 +384,7 @@ typedef enum {
 typedef enum {
     /* values corresponding RIFF wFormatTag */
     PICOOS_ENC_LIN = FORMAT_TAG_LIN,  /**< linear 16-bit encoding; standard */
+    PICOOS_ENC_FLOAT = FORMAT_TAG_FLOAT, /**< IEEE float, 32 bit, full scale 1.0 */
     PICOOS_ENC_ALAW = FORMAT_TAG_ALAW, /**< a-law encoding, 8 bit */
     PICOOS_ENC_ULAW = FORMAT_TAG_ULAW, /**< u-law encoding, 8 bit */
     /* values outside RIFF wFormatTag values (above 4100) */
@@ -421,11 +429,18 @@ extern picoos_bool picoos_sdfCloseIn (picoos_Common g, picoos_SDFile * sdFile);
 
 /* SDFile output functions*/
 
+/* 'enc' is PICOOS_ENC_LIN or PICOOS_ENC_FLOAT (wav format 3) */
 extern picoos_bool picoos_sdfOpenOut (picoos_Common g, picoos_SDFile * sdFile, picoos_char fileName[], int sf, picoos_encoding_t enc);
 
 
+/* to a float file the samples go scaled to full scale 1.0 */
 extern picoos_bool picoos_sdfPutSamples (picoos_SDFile sdFile, picoos_uint32 nrSamples, picoos_int16 samples[]);
 
+
+/* float samples, full scale 1.0; to a 16 bit file they go rounded and
+   clipped */
+extern picoos_bool picoos_sdfPutFloatSamples (picoos_SDFile sdFile, picoos_uint32 nrSamples, const picoos_single samples[]);
+
 /*
 extern picoos_bool picoos_AbortOutput (picoos_SDFile sdFile);
 
@@ -475,6 +475,7 @@ picopal_double picopal_quick_exp(const picopal_double y) {
 
     } _eco;
     _eco.n.i = (picopal_int32)(1512775.3951951856938297995605697f * y) + 1072632447;
+    _eco.n.j = 0;
     return _eco.d;
 }
 
@@ -547,6 +548,54 @@ void picopal_get_timer(picopal_uint32 * sec, picopal_uint32 * usec)
 #endif /* IMPLEMENT_TIMER */
 }
 
+/* *************************************************/
+/* mutual exclusion                                */
+/* *************************************************/
+
+pico_status_t picopal_mutex_init(picopal_mutex_t * m)
+{
+#if (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+    return (0 == pthread_mutex_init(m, NULL)) ? PICO_OK : PICO_ERR_OTHER;
+#elif PICO_PLATFORM == PICO_Windows
+    InitializeSRWLock((PSRWLOCK) m);
+    return PICO_OK;
+#else
+    *m = NULL;
+    return PICO_OK;
+#endif
+}
+
+void picopal_mutex_lock(picopal_mutex_t * m)
+{
+#if (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+    pthread_mutex_lock(m);
+#elif PICO_PLATFORM == PICO_Windows
+    AcquireSRWLockExclusive((PSRWLOCK) m);
+#else
+    m = m;        /* avoid warning "var not used in this function"*/
+#endif
+}
+
+void picopal_mutex_unlock(picopal_mutex_t * m)
+{
+#if (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+    pthread_mutex_unlock(m);
+#elif PICO_PLATFORM == PICO_Windows
+    ReleaseSRWLockExclusive((PSRWLOCK) m);
+#else
+    m = m;        /* avoid warning "var not used in this function"*/
+#endif
+}
+
+void picopal_mutex_destroy(picopal_mutex_t * m)
+{
+#if (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+    pthread_mutex_destroy(m);
+#else
+    m = m;        /* avoid warning "var not used in this function"*/
+#endif
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -43,6 +43,10 @@
 #include "picopltf.h"
 #include "picodefs.h"
 
+#if (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+#include <pthread.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -281,6 +285,25 @@ picopal_double picopal_quick_exp(const picopal_double y);
 
 extern void picopal_get_timer(picopal_uint32 * sec, picopal_uint32 * usec);
 
+/* *************************************************/
+/* mutual exclusion                                */
+/* *************************************************/
+
+/* Simple non-recursive lock for objects that are shared between engines
+   running in different threads. On platforms without thread support
+   (PICO_GENERIC) all operations are no-ops. */
+
+#if (PICO_PLATFORM == PICO_Linux) || (PICO_PLATFORM == PICO_MacOSX)
+typedef pthread_mutex_t picopal_mutex_t;
+#else
+typedef void * picopal_mutex_t; /* Windows: SRWLOCK */
+#endif
+
+extern pico_status_t picopal_mutex_init(picopal_mutex_t * m);
+extern void picopal_mutex_lock(picopal_mutex_t * m);
+extern void picopal_mutex_unlock(picopal_mutex_t * m);
+extern void picopal_mutex_destroy(picopal_mutex_t * m);
+
 #ifdef __cplusplus
 }
 #endif
@@ -32,6 +32,7 @@
 #include "picodata.h"
 #include "picopam.h"
 #include "picokdt.h"
+#include "picodtcache.h"
 #include "picokpdf.h"
 #include "picoktab.h"
 #include "picokdbg.h"
@@ -168,6 +169,9 @@ typedef struct pam_subobj
     picoos_uint16 outReadPos, outWritePos; /* next pos to read/write from/to outBuf*/
     /*---------------------- adapter working buffers    --------------------*/
     picoos_uint8 *sPhFeats; /*feature vector for a single phone      */
+    picoos_uint8 sSyllTreeV[PICOPAM_INVEC_SIZE]; /*compressed and reorganized
+     vector of the current syllable, common to all its phones */
+    picoos_int16 nTreeVSyllable; /*syllable sSyllTreeV was built for*/
     sFtVect *sSyllFeats; /*Syllable feature vector set for the
      full sentence                          */
     picoos_uint8 *sPhIds; /*phone ids for the full sentence        */
@@ -437,8 +441,9 @@ static pico_status_t pam_adapter_do_pauses(register picodata_ProcessingUnit this
 /*-------------- tree traversal ---------------------------------------*/
 static pico_status_t pam_expand_vector(register picodata_ProcessingUnit this);
 static picoos_uint8 pam_do_tree(register picodata_ProcessingUnit this,
-        const picokdt_DtPAM dtpam, const picoos_uint8 *invec,
-        const picoos_uint8 inveclen, picokdt_classify_result_t *dtres);
+        const picokdt_DtPAM dtpam, const picoos_uint16 treeId,
+        const picoos_uint8 *invec, const picoos_uint8 inveclen,
+        const picoos_uint32 invechash, picokdt_classify_result_t *dtres);
 static pico_status_t pam_get_f0(register picodata_ProcessingUnit this,
         picoos_uint16 *lf0Index, picoos_uint8 nState, picoos_single *phonF0);
 static pico_status_t pam_get_duration(register picodata_ProcessingUnit this,
@@ -594,6 +599,7 @@ static pico_status_t pam_initialize(register picodata_ProcessingUnit this, picoo
 
     for (nI = 0; nI < PICOPAM_VECT_SIZE; nI++)
         pam->sPhFeats[nI] = 0;
+    pam->nTreeVSyllable = -1;
 
     for (nI = 0; nI < PICOPAM_MAX_ITEM_SIZE_PER_SENT; nI++)
         pam->sSyllItems[nI] = 0;
@@ -1601,102 +1607,19 @@ static picoos_uint8 pamCompressComponent(picoos_uint8 inVal)
 }/*pamCompressComponent*/
 
 /**
- * prepares the input vector for tree feeding
- * @param    this : Pam object pointer
- * @return    PICO_OK : vector expanded
- * @return    PICO_ERR_OTHER : errors on expansion or retrieving the PU pointer
- * @remarks Modifies pam->sPhFeats[]
+ * compresses a syllable feature vector for PAM
+ * @param    vect : the vector (PICOPAM_INVEC_SIZE bytes), modified in place
+ * @return    void
+ * @remarks the phone fields P1..P8 are filled per phone, after compression
  * @callgraph
  * @callergraph
  */
-static pico_status_t pam_expand_vector(register picodata_ProcessingUnit this)
+static void pamCompressVector(picoos_uint8 *vect)
 {
-    pam_subobj_t *pam;
-    picoos_uint8 *inVect, *phonVect, *outVect, nI;
-    picoos_int16 nOffs, nOffs1, nLen;
-    pam = (pam_subobj_t *) this->subObj;
-    if (NULL == this || NULL == this->subObj) {
-        return PICODATA_PU_ERROR;
-    }
-    inVect = &(pam->sSyllFeats[pam->nCurrSyllable].phoneV[0]);
-    phonVect = &(pam->sPhIds[0]);
-    outVect = &(pam->sPhFeats[0]);
-    /*just copy back*/
-    for (nI = 0; nI < PICOPAM_INVEC_SIZE; nI++)
-        outVect[nI] = inVect[nI];
-    /*now fill missing fields*/
-    picoos_mem_copy((void*) &(inVect[FID]), &nOffs, sizeof(nOffs));
-    /*offset to first phone of current syllable*/
-    nOffs = nOffs + pam->nSyllPhoneme; /*offset to current phone of current syllable*/
-    nLen = inVect[B3]; /*len of current syllable*/
-    if (pam->nSyllPhoneme >= nLen) {
-        /*error on addressing current phone*/
-        return PICO_ERR_OTHER;
-    }
-    /*previous of the previous phone*/
-    nOffs1 = nOffs - 2;
-    if (nOffs1 >= 0)
-        outVect[P1] = phonVect[nOffs1];
-    else
-        outVect[P1] = PICOPAM_PH_DONT_CARE_VAL;
-    /*previous  phone*/
-    nOffs1 = nOffs - 1;
-    if (nOffs1 >= 0)
-        outVect[P2] = phonVect[nOffs1];
-    else
-        outVect[P2] = PICOPAM_PH_DONT_CARE_VAL;
-    /*^current phone*/
-    outVect[P3] = phonVect[nOffs];
-
-    /*next phone*/
-    nOffs1 = nOffs + 1;
-    if (nOffs1 < pam->nTotalPhonemes)
-        outVect[P4] = phonVect[nOffs1];
-    else
-        outVect[P4] = PICOPAM_PH_DONT_CARE_VAL;
-    /*next of the next phone*/
-    nOffs1 = nOffs + 2;
-    if (nOffs1 < pam->nTotalPhonemes)
-        outVect[P5] = phonVect[nOffs1];
-    else
-        outVect[P5] = PICOPAM_PH_DONT_CARE_VAL;
-    /*pos of curr phone with respect to left syllable boundary*/
-    outVect[P6] = pam->nSyllPhoneme + 1;
-    /*pos of curr phone with respect to right syllable boundary*/
-    outVect[P7] = nLen - pam->nSyllPhoneme;
-    /*is current phone in consonant syllable boundary? (1:yes)*/
-    if (pam->nSyllPhoneme < inVect[P8])
-        outVect[P8] = 1;
-    else
-        outVect[P8] = 0;
-    return PICO_OK;
-}/*pam_expand_vector*/
+    picoos_uint8 nI;
 
-/**
- * compresses the input vector for PAM
- * @param    this : Pam object pointer
- * @return    PICO_OK : compression successful
- * @return    PICO_ERR_OTHER : errors on retrieving the PU pointer
- * @remarks Modifies pam->sPhFeats[]
- * @callgraph
- * @callergraph
- */
-static pico_status_t pamCompressVector(register picodata_ProcessingUnit this)
-{
-    pam_subobj_t *pam;
-    picoos_uint8 *outVect, nI;
-    pam = (pam_subobj_t *) this->subObj;
-    if (NULL == this || NULL == this->subObj) {
-        return PICODATA_PU_ERROR;
-    }
-    outVect = &(pam->sPhFeats[0]);
-    for (nI = 0; nI < PICOPAM_INVEC_SIZE; nI++) {
+    for (nI = P8 + 1; nI < PICOPAM_INVEC_SIZE; nI++) {
         switch (nI) {
-            case P1:
-            case P2:
-            case P3:
-            case P4:
-            case P5:
             case B1:
             case B2:
             case B16:
@@ -1706,34 +1629,26 @@ static pico_status_t pamCompressVector(register picodata_ProcessingUnit this)
                 break;
             default:
                 /*do compression*/
-                if (outVect[nI] != PICOPAM_DONT_CARE_VALUE)
-                    outVect[nI] = pamCompressComponent(outVect[nI]);
+                if (vect[nI] != PICOPAM_DONT_CARE_VALUE)
+                    vect[nI] = pamCompressComponent(vect[nI]);
                 else
-                    outVect[nI] = PICOPAM_DONT_CARE_VAL;
+                    vect[nI] = PICOPAM_DONT_CARE_VAL;
                 break;
         }
     }
-    return PICO_OK;
 }/*pamCompressVector*/
 
 /**
- * reorganizes the input vector for PAM
- * @param    this : Pam object pointer
- * @return    PICO_OK : reorganization successful
- * @return    PICO_ERR_OTHER : errors on retrieving the PU pointer
- * @remarks Modifies pam->sPhFeats[]
+ * reorganizes a compressed syllable feature vector for PAM
+ * @param    outVect : the vector (PICOPAM_INVEC_SIZE bytes), modified in place
+ * @return    void
  * @callgraph
  * @callergraph
  */
-static pico_status_t pamReorgVector(register picodata_ProcessingUnit this)
+static void pamReorgVector(picoos_uint8 *outVect)
 {
-    pam_subobj_t *pam;
-    picoos_uint8 *outVect, inVect[60], nI;
-    pam = (pam_subobj_t *) this->subObj;
-    if (NULL == this || NULL == this->subObj) {
-        return PICODATA_PU_ERROR;
-    }
-    outVect = &(pam->sPhFeats[0]);
+    picoos_uint8 inVect[PICOPAM_INVEC_SIZE], nI;
+
     for (nI = 0; nI < PICOPAM_INVEC_SIZE; nI++) inVect[nI] = outVect[nI];
     /*reorganize*/
     for (nI = T_B1; nI <= T_H5; nI++) {
@@ -1886,9 +1801,90 @@ static pico_status_t pamReorgVector(register picodata_ProcessingUnit this)
                 break;
         }
     }
-    return PICO_OK;
 }/*pamReorgVector*/
 
+/**
+ * prepares the input vector of the current phone for tree feeding
+ * @param    this : Pam object pointer
+ * @return    PICO_OK : vector expanded
+ * @return    PICO_ERR_OTHER : errors on expansion or retrieving the PU pointer
+ * @remarks Modifies pam->sPhFeats[] and, at the first phone of a syllable,
+ *          pam->sSyllTreeV[]
+ * @remarks Apart from P1..P8 all fields of the vector are syllable features;
+ *          they are compressed and reorganized once per syllable into
+ *          pam->sSyllTreeV[], and each phone starts from a copy of it
+ * @callgraph
+ * @callergraph
+ */
+static pico_status_t pam_expand_vector(register picodata_ProcessingUnit this)
+{
+    pam_subobj_t *pam;
+    picoos_uint8 *inVect, *phonVect, *outVect;
+    picoos_int16 nOffs, nOffs1, nLen;
+    pam = (pam_subobj_t *) this->subObj;
+    if (NULL == this || NULL == this->subObj) {
+        return PICODATA_PU_ERROR;
+    }
+    inVect = &(pam->sSyllFeats[pam->nCurrSyllable].phoneV[0]);
+    phonVect = &(pam->sPhIds[0]);
+    outVect = &(pam->sPhFeats[0]);
+    if ((pam->nSyllPhoneme == 0)
+            || (pam->nTreeVSyllable != pam->nCurrSyllable)) {
+        picoos_mem_copy((void*) inVect, pam->sSyllTreeV, PICOPAM_INVEC_SIZE);
+        pamCompressVector(pam->sSyllTreeV);
+        pamReorgVector(pam->sSyllTreeV);
+        pam->nTreeVSyllable = pam->nCurrSyllable;
+    }
+    picoos_mem_copy((void*) pam->sSyllTreeV, outVect, PICOPAM_INVEC_SIZE);
+    nLen = inVect[B3]; /*len of current syllable*/
+    if (pam->nSyllPhoneme >= nLen) {
+        /*error on addressing current phone*/
+        return PICO_ERR_OTHER;
+    }
+
+    /*now fill the phone fields*/
+    picoos_mem_copy((void*) &(inVect[FID]), &nOffs, sizeof(nOffs));
+    /*offset to first phone of current syllable*/
+    nOffs = nOffs + pam->nSyllPhoneme; /*offset to current phone of current syllable*/
+    /*previous of the previous phone*/
+    nOffs1 = nOffs - 2;
+    if (nOffs1 >= 0)
+        outVect[P1] = phonVect[nOffs1];
+    else
+        outVect[P1] = PICOPAM_PH_DONT_CARE_VAL;
+    /*previous  phone*/
+    nOffs1 = nOffs - 1;
+    if (nOffs1 >= 0)
+        outVect[P2] = phonVect[nOffs1];
+    else
+        outVect[P2] = PICOPAM_PH_DONT_CARE_VAL;
+    /*^current phone*/
+    outVect[P3] = phonVect[nOffs];
+
+    /*next phone*/
+    nOffs1 = nOffs + 1;
+    if (nOffs1 < pam->nTotalPhonemes)
+        outVect[P4] = phonVect[nOffs1];
+    else
+        outVect[P4] = PICOPAM_PH_DONT_CARE_VAL;
+    /*next of the next phone*/
+    nOffs1 = nOffs + 2;
+    if (nOffs1 < pam->nTotalPhonemes)
+        outVect[P5] = phonVect[nOffs1];
+    else
+        outVect[P5] = PICOPAM_PH_DONT_CARE_VAL;
+    /*pos of curr phone with respect to left syllable boundary (compressed)*/
+    outVect[P6] = pamCompressComponent((picoos_uint8) (pam->nSyllPhoneme + 1));
+    /*pos of curr phone with respect to right syllable boundary (compressed)*/
+    outVect[P7] = pamCompressComponent((picoos_uint8) (nLen - pam->nSyllPhoneme));
+    /*is current phone in consonant syllable boundary? (1:yes)*/
+    if (pam->nSyllPhoneme < inVect[P8])
+        outVect[P8] = 1;
+    else
+        outVect[P8] = 0;
+    return PICO_OK;
+}/*pam_expand_vector*/
+
 /**
  * puts a PAM item into PU output buffer
  * @param    this : Pam object pointer
@@ -2197,6 +2193,7 @@ static pico_status_t pamPhoneProcess(register picodata_ProcessingUnit this)
     pico_status_t sResult;
     picokdt_classify_result_t dTreeResult;
     picoos_uint8 nI, bWr;
+    picoos_uint32 hash = 0;
 
     pam = (pam_subobj_t *) this->subObj;
     if (NULL == this || NULL == this->subObj) {
@@ -2204,12 +2201,16 @@ static pico_status_t pamPhoneProcess(register picodata_ProcessingUnit this)
     }
     /*expands current phone in current syllable in the corresponding vector pam->sPhFeats[]*/
     sResult = pam_expand_vector(this);
-    sResult = pamCompressVector(this);
-    sResult = pamReorgVector(this);
+
+    /*duration and pitch trees share the vector, so do the cache keys*/
+    if (picodt_cache_is_enabled(this->voice->dtCache)) {
+        hash = picodt_compute_extended_hash(&(pam->sPhFeats[0]),
+                PICOPAM_INVEC_SIZE);
+    }
 
     /*tree traversal for duration*/
-    if (!pam_do_tree(this, pam->dtdur, &(pam->sPhFeats[0]), PICOPAM_INVEC_SIZE,
-            &dTreeResult)) {
+    if (!pam_do_tree(this, pam->dtdur, PICOKNOW_KBID_DT_DUR,
+            &(pam->sPhFeats[0]), PICOPAM_INVEC_SIZE, hash, &dTreeResult)) {
         PICODBG_WARN(("problem using pam tree dtdur, using fallback value"));
         dTreeResult.class = 0;
     }
@@ -2219,8 +2220,8 @@ static pico_status_t pamPhoneProcess(register picodata_ProcessingUnit this)
 
     /*tree traversal for pitch*/
     for (nI = 0; nI < PICOPAM_MAX_STATES_PER_PHONE; nI++) {
-        if (!pam_do_tree(this, pam->dtlfz[nI], &(pam->sPhFeats[0]),
-                PICOPAM_INVEC_SIZE, &dTreeResult)) {
+        if (!pam_do_tree(this, pam->dtlfz[nI], PICOKNOW_KBID_DT_LFZ1 + nI,
+                &(pam->sPhFeats[0]), PICOPAM_INVEC_SIZE, hash, &dTreeResult)) {
             PICODBG_WARN(("problem using pam tree lf0Tree, using fallback value"));
             dTreeResult.class = 0;
         }
@@ -2234,11 +2235,15 @@ static pico_status_t pamPhoneProcess(register picodata_ProcessingUnit this)
 
     /*update vector with duration and pitch for cep tree traversal*/
     sResult = pam_update_vector(this);
+    if (picodt_cache_is_enabled(this->voice->dtCache)) {
+        hash = picodt_compute_extended_hash(&(pam->sPhFeats[0]),
+                PICOPAM_INVEC_SIZE);
+    }
     /*cep tree traversal*/
     for (nI = 0; nI < PICOPAM_MAX_STATES_PER_PHONE; nI++) {
 
-        if (!pam_do_tree(this, pam->dtmgc[nI], &(pam->sPhFeats[0]),
-                PICOPAM_INVEC_SIZE, &dTreeResult)) {
+        if (!pam_do_tree(this, pam->dtmgc[nI], PICOKNOW_KBID_DT_MGC1 + nI,
+                &(pam->sPhFeats[0]), PICOPAM_INVEC_SIZE, hash, &dTreeResult)) {
             PICODBG_WARN(("problem using pam tree lf0Tree, using fallback value"));
             dTreeResult.class = 0;
         }
@@ -2777,18 +2782,31 @@ static picodata_step_result_t pam_step(register picodata_ProcessingUnit this,
  * performs one step of a PamTree
  * @param    this : Pam item subobject pointer
  * @param    dtpam : the Pam decision tree
+ * @param    treeId : knowledge base id of the tree (decision tree cache key)
  * @param    *invec : the input vector pointer
  * @param    inveclen : length of the input vector
+ * @param    invechash : picodt_compute_extended_hash of the input vector
+ *                       (only used with the decision tree cache)
  * @param    *dtres : the classification result
  * @return    dtres->set : the result of tree traversal
  * @callgraph
  * @callergraph
  */
 static picoos_uint8 pam_do_tree(register picodata_ProcessingUnit this,
-        const picokdt_DtPAM dtpam, const picoos_uint8 *invec,
-        const picoos_uint8 inveclen, picokdt_classify_result_t *dtres)
+        const picokdt_DtPAM dtpam, const picoos_uint16 treeId,
+        const picoos_uint8 *invec, const picoos_uint8 inveclen,
+        const picoos_uint32 invechash, picokdt_classify_result_t *dtres)
 {
     picoos_uint8 okay;
+    picodt_cache_t *dtCache = this->voice->dtCache;
+
+    /* the tree output only depends on the input vector */
+    if (picodt_cache_is_enabled(dtCache)) {
+        if (picodt_cache_lookup(dtCache, treeId, invec, inveclen, invechash,
+                dtres, NULL)) {
+            return dtres->set;
+        }
+    }
 
     okay = TRUE;
     /* construct input vector, which is set in dtpam */
@@ -2813,6 +2831,10 @@ static picoos_uint8 pam_do_tree(register picodata_ProcessingUnit this,
         picoos_emRaiseWarning(this->common->em, PICO_WARN_OUTVECTOR, NULL, NULL);
         okay = FALSE;
     }
+    if (okay && picodt_cache_is_enabled(dtCache)) {
+        picodt_cache_insert(dtCache, treeId, invec, inveclen, invechash,
+                dtres, 0);
+    }
 
     PICODBG_TRACE(("dtpam output class: %d", dtres->class));
 
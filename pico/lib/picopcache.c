@@ -0,0 +1,451 @@
+/*
+ * Copyright (C) 2024 PicoTTS Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * @file picopcache.c
+ *
+ * Word pronunciation cache
+ */
+
+#include "picodefs.h"
+#include "picoos.h"
+#include "picodbg.h"
+#include "picopcache.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if 0
+}
+#endif
+
+#define PCACHE_NIL          0xffff
+
+/* cache file: magic, version, voice id, number of entries, then the
+   entries from least to most recently used as
+   keylen key[keylen] plen phones[plen] */
+#define PCACHE_FILE_MAGIC   "PICOPCAC"
+#define PCACHE_FILE_MAGICLEN 8
+#define PCACHE_FILE_VERSION 1
+
+typedef struct {
+    picoos_uint32 hash;
+    picoos_uint16 hnext;    /* next entry in hash chain */
+    picoos_uint16 prev;     /* LRU list, towards most recently used */
+    picoos_uint16 next;     /* LRU list, towards least recently used */
+    picoos_uint8 keylen;
+    picoos_uint8 plen;
+    picoos_uint8 key[PICOPCACHE_MAX_KEYLEN];
+    picoos_uint8 phones[PICOPCACHE_MAX_PHONLEN];
+} picopcache_entry_t;
+
+typedef struct picopcache_pron_cache {
+    picopal_mutex_t mutex;
+    picoos_uint32 voiceId;
+    picoos_uint16 useCount;
+
+    picoos_uint16 maxEntries;
+    picoos_uint16 numEntries;
+    picoos_uint16 hashmask;
+    picoos_uint16 * hashtab;
+    picopcache_entry_t * entries;
+
+    picoos_uint16 mru;     /* most recently used entry */
+    picoos_uint16 lru;     /* least recently used entry */
+
+    picoos_uint32 hits;
+    picoos_uint32 misses;
+} picopcache_pron_cache_t;
+
+
+/* FNV-1a, as for the lexicon hash index */
+static picoos_uint32 pcacheHash(const picoos_uint8 * key, picoos_uint8 keylen)
+{
+    picoos_uint32 h = 2166136261u;
+    picoos_uint8 i;
+
+    for (i = 0; i < keylen; i++) {
+        h = (h ^ key[i]) * 16777619u;
+    }
+    return h;
+}
+
+static void pcacheReset(picopcache_PronCache this)
+{
+    picoos_uint32 i;
+
+    for (i = 0; i <= this->hashmask; i++) {
+        this->hashtab[i] = PCACHE_NIL;
+    }
+    this->numEntries = 0;
+    this->mru = PCACHE_NIL;
+    this->lru = PCACHE_NIL;
+    this->hits = 0;
+    this->misses = 0;
+}
+
+picopcache_PronCache picopcache_newPronCache(picoos_MemoryManager mm,
+        picoos_uint32 maxEntries, picoos_uint32 voiceId)
+{
+    picopcache_PronCache this;
+    picoos_uint32 size;
+
+    if ((0 == maxEntries) || (PICOPCACHE_MAX_ENTRIES < maxEntries)) {
+        return NULL;
+    }
+    this = (picopcache_PronCache) picoos_allocate(mm, sizeof(*this));
+    if (NULL == this) {
+        return NULL;
+    }
+    /* hash table with at least twice as many slots as entries */
+    size = 1;
+    while (size < 2 * maxEntries) {
+        size <<= 1;
+    }
+    this->hashtab = (picoos_uint16 *) picoos_allocate(mm,
+            size * sizeof(picoos_uint16));
+    this->entries = (picopcache_entry_t *) picoos_allocate(mm,
+            maxEntries * sizeof(picopcache_entry_t));
+    if ((NULL == this->hashtab) || (NULL == this->entries)
+            || (PICO_OK != picopal_mutex_init(&this->mutex))) {
+        picoos_deallocate(mm, (void *) &this->entries);
+        picoos_deallocate(mm, (void *) &this->hashtab);
+        picoos_deallocate(mm, (void *) &this);
+        return NULL;
+    }
+    this->voiceId = voiceId;
+    this->useCount = 0;
+    this->maxEntries = (picoos_uint16) maxEntries;
+    this->hashmask = (picoos_uint16) (size - 1);
+    pcacheReset(this);
+    return this;
+}
+
+void picopcache_disposePronCache(picoos_MemoryManager mm,
+        picopcache_PronCache * this)
+{
+    if (NULL != (*this)) {
+        picopal_mutex_destroy(&(*this)->mutex);
+        picoos_deallocate(mm, (void *) &(*this)->entries);
+        picoos_deallocate(mm, (void *) &(*this)->hashtab);
+        picoos_deallocate(mm, (void *) this);
+    }
+}
+
+picoos_uint32 picopcache_getVoiceId(picopcache_PronCache this)
+{
+    return this->voiceId;
+}
+
+void picopcache_attach(picopcache_PronCache this)
+{
+    picopal_mutex_lock(&this->mutex);
+    this->useCount++;
+    picopal_mutex_unlock(&this->mutex);
+}
+
+void picopcache_detach(picopcache_PronCache this)
+{
+    picopal_mutex_lock(&this->mutex);
+    if (this->useCount > 0) {
+        this->useCount--;
+    }
+    picopal_mutex_unlock(&this->mutex);
+}
+
+picoos_bool picopcache_isAttached(picopcache_PronCache this)
+{
+    picoos_bool attached;
+
+    picopal_mutex_lock(&this->mutex);
+    attached = (this->useCount > 0);
+    picopal_mutex_unlock(&this->mutex);
+    return attached;
+}
+
+
+/* ************************************************************/
+/* LRU list and hash chains; callers hold the mutex           */
+/* ************************************************************/
+
+static void pcacheUnlink(picopcache_PronCache this, picoos_uint16 e)
+{
+    picopcache_entry_t * ent = &this->entries[e];
+
+    if (PCACHE_NIL != ent->prev) {
+        this->entries[ent->prev].next = ent->next;
+    } else {
+        this->mru = ent->next;
+    }
+    if (PCACHE_NIL != ent->next) {
+        this->entries[ent->next].prev = ent->prev;
+    } else {
+        this->lru = ent->prev;
+    }
+}
+
+static void pcachePushFront(picopcache_PronCache this, picoos_uint16 e)
+{
+    picopcache_entry_t * ent = &this->entries[e];
+
+    ent->prev = PCACHE_NIL;
+    ent->next = this->mru;
+    if (PCACHE_NIL != this->mru) {
+        this->entries[this->mru].prev = e;
+    } else {
+        this->lru = e;
+    }
+    this->mru = e;
+}
+
+static picoos_uint16 pcacheFind(picopcache_PronCache this,
+        const picoos_uint8 * key, picoos_uint8 keylen, picoos_uint32 hash)
+{
+    picoos_uint16 e;
+    picopcache_entry_t * ent;
+    picoos_uint8 i;
+
+    e = this->hashtab[hash & this->hashmask];
+    while (PCACHE_NIL != e) {
+        ent = &this->entries[e];
+        if ((ent->hash == hash) && (ent->keylen == keylen)) {
+            for (i = 0; (i < keylen) && (ent->key[i] == key[i]); i++) {
+                /* compare */
+            }
+            if (i == keylen) {
+                return e;
+            }
+        }
+        e = ent->hnext;
+    }
+    return PCACHE_NIL;
+}
+
+static void pcacheRemoveFromChain(picopcache_PronCache this, picoos_uint16 e)
+{
+    picoos_uint16 * p;
+
+    p = &this->hashtab[this->entries[e].hash & this->hashmask];
+    while (*p != e) {
+        p = &this->entries[*p].hnext;
+    }
+    *p = this->entries[e].hnext;
+}
+
+static void pcacheInsert(picopcache_PronCache this,
+        const picoos_uint8 * key, picoos_uint8 keylen,
+        const picoos_uint8 * phones, picoos_uint8 plen)
+{
+    picoos_uint32 hash, slot;
+    picoos_uint16 e;
+    picopcache_entry_t * ent;
+
+    hash = pcacheHash(key, keylen);
+    e = pcacheFind(this, key, keylen, hash);
+    if (PCACHE_NIL != e) {
+        pcacheUnlink(this, e);
+    } else {
+        if (this->numEntries < this->maxEntries) {
+            e = this->numEntries++;
+        } else {
+            /* evict least recently used */
+            e = this->lru;
+            pcacheUnlink(this, e);
+            pcacheRemoveFromChain(this, e);
+        }
+        ent = &this->entries[e];
+        ent->hash = hash;
+        ent->keylen = keylen;
+        picoos_mem_copy(key, ent->key, keylen);
+        slot = hash & this->hashmask;
+        ent->hnext = this->hashtab[slot];
+        this->hashtab[slot] = e;
+    }
+    ent = &this->entries[e];
+    ent->plen = plen;
+    picoos_mem_copy(phones, ent->phones, plen);
+    pcachePushFront(this, e);
+}
+
+
+/* ************************************************************/
+/* lookup and insertion                                       */
+/* ************************************************************/
+
+picoos_bool picopcache_lookup(picopcache_PronCache this,
+        const picoos_uint8 * key, picoos_uint8 keylen,
+        picoos_uint8 * phones, picoos_uint16 maxlen, picoos_uint8 * plen)
+{
+    picoos_uint16 e;
+    picopcache_entry_t * ent;
+    picoos_bool found = FALSE;
+
+    if (keylen > PICOPCACHE_MAX_KEYLEN) {
+        return FALSE;
+    }
+    picopal_mutex_lock(&this->mutex);
+    e = pcacheFind(this, key, keylen, pcacheHash(key, keylen));
+    if (PCACHE_NIL != e) {
+        ent = &this->entries[e];
+        if (ent->plen <= maxlen) {
+            pcacheUnlink(this, e);
+            pcachePushFront(this, e);
+            picoos_mem_copy(ent->phones, phones, ent->plen);
+            *plen = ent->plen;
+            found = TRUE;
+        }
+    }
+    if (found) {
+        this->hits++;
+    } else {
+        this->misses++;
+    }
+    picopal_mutex_unlock(&this->mutex);
+    return found;
+}
+
+void picopcache_insert(picopcache_PronCache this,
+        const picoos_uint8 * key, picoos_uint8 keylen,
+        const picoos_uint8 * phones, picoos_uint8 plen)
+{
+    if ((keylen > PICOPCACHE_MAX_KEYLEN) || (plen > PICOPCACHE_MAX_PHONLEN)) {
+        return;
+    }
+    picopal_mutex_lock(&this->mutex);
+    pcacheInsert(this, key, keylen, phones, plen);
+    picopal_mutex_unlock(&this->mutex);
+}
+
+void picopcache_clear(picopcache_PronCache this)
+{
+    picopal_mutex_lock(&this->mutex);
+    pcacheReset(this);
+    picopal_mutex_unlock(&this->mutex);
+}
+
+void picopcache_getStats(picopcache_PronCache this,
+        picoos_uint32 * numEntries, picoos_uint32 * hits,
+        picoos_uint32 * misses)
+{
+    picopal_mutex_lock(&this->mutex);
+    *numEntries = this->numEntries;
+    *hits = this->hits;
+    *misses = this->misses;
+    picopal_mutex_unlock(&this->mutex);
+}
+
+
+/* ************************************************************/
+/* persistence                                                */
+/* ************************************************************/
+
+pico_status_t picopcache_save(picoos_Common common,
+        picopcache_PronCache this, picoos_char * fileName)
+{
+    picoos_File f;
+    picoos_uint16 e;
+    picopcache_entry_t * ent = NULL;
+    picoos_int32 n;
+    picoos_bool done;
+
+    if (!picoos_CreateBinary(common, &f, fileName)) {
+        return picoos_emRaiseException(common->em, PICO_EXC_CANT_OPEN_FILE,
+                NULL, (picoos_char *) "%s", fileName);
+    }
+    picopal_mutex_lock(&this->mutex);
+    n = PCACHE_FILE_MAGICLEN;
+    done = picoos_WriteBytes(f, (picoos_char *) PCACHE_FILE_MAGIC, &n);
+    done = done && picoos_write_le_uint16(f, PCACHE_FILE_VERSION);
+    done = done && picoos_write_le_uint32(f, this->voiceId);
+    done = done && picoos_write_le_uint32(f, this->numEntries);
+    for (e = this->lru; done && (PCACHE_NIL != e); e = ent->prev) {
+        ent = &this->entries[e];
+        done = picoos_WriteByte(f, (picoos_char) ent->keylen);
+        n = ent->keylen;
+        done = done && picoos_WriteBytes(f, (picoos_char *) ent->key, &n);
+        done = done && picoos_WriteByte(f, (picoos_char) ent->plen);
+        n = ent->plen;
+        done = done && picoos_WriteBytes(f, (picoos_char *) ent->phones, &n);
+    }
+    picopal_mutex_unlock(&this->mutex);
+    picoos_CloseBinary(common, &f);
+    if (!done) {
+        return picoos_emRaiseException(common->em, PICO_ERR_OTHER,
+                NULL, (picoos_char *) "error writing %s", fileName);
+    }
+    return PICO_OK;
+}
+
+pico_status_t picopcache_load(picoos_Common common,
+        picopcache_PronCache this, picoos_char * fileName)
+{
+    picoos_File f;
+    picoos_uint8 magic[PCACHE_FILE_MAGICLEN];
+    picoos_uint8 key[PICOPCACHE_MAX_KEYLEN];
+    picoos_uint8 phones[PICOPCACHE_MAX_PHONLEN];
+    picoos_uint8 keylen, plen;
+    picoos_uint16 version;
+    picoos_uint32 voiceId, numEntries, i, n;
+    pico_status_t status = PICO_OK;
+
+    if (!picoos_OpenBinary(common, &f, fileName)) {
+        return picoos_emRaiseException(common->em, PICO_EXC_CANT_OPEN_FILE,
+                NULL, (picoos_char *) "%s", fileName);
+    }
+    n = PCACHE_FILE_MAGICLEN;
+    if (!picoos_ReadBytes(f, magic, &n) || (n != PCACHE_FILE_MAGICLEN)
+            || (0 != picoos_strncmp((picoos_char *) magic,
+                    (picoos_char *) PCACHE_FILE_MAGIC, PCACHE_FILE_MAGICLEN))
+            || (PICO_OK != picoos_read_le_uint16(f, &version))
+            || (PCACHE_FILE_VERSION != version)
+            || (PICO_OK != picoos_read_le_uint32(f, &voiceId))
+            || (PICO_OK != picoos_read_le_uint32(f, &numEntries))) {
+        status = PICO_EXC_FILE_CORRUPT;
+    } else if (voiceId != this->voiceId) {
+        status = PICO_EXC_UNEXPECTED_FILE_TYPE;
+    }
+    picopal_mutex_lock(&this->mutex);
+    for (i = 0; (PICO_OK == status) && (i < numEntries); i++) {
+        if (!picoos_ReadByte(f, &keylen) || (keylen > PICOPCACHE_MAX_KEYLEN)) {
+            status = PICO_EXC_FILE_CORRUPT;
+            break;
+        }
+        n = keylen;
+        if (!picoos_ReadBytes(f, key, &n) || (n != keylen)
+                || !picoos_ReadByte(f, &plen) || (plen > PICOPCACHE_MAX_PHONLEN)) {
+            status = PICO_EXC_FILE_CORRUPT;
+            break;
+        }
+        n = plen;
+        if (!picoos_ReadBytes(f, phones, &n) || (n != plen)) {
+            status = PICO_EXC_FILE_CORRUPT;
+            break;
+        }
+        pcacheInsert(this, key, keylen, phones, plen);
+    }
+    picopal_mutex_unlock(&this->mutex);
+    picoos_CloseBinary(common, &f);
+    if (PICO_OK != status) {
+        return picoos_emRaiseException(common->em, status, NULL,
+                (picoos_char *) "%s", fileName);
+    }
+    return PICO_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/* end */
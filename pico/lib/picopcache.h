@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2024 PicoTTS Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * @file picopcache.h
+ *
+ * Word pronunciation cache
+ *
+ * Maps a word as it enters the lexicon-lookup/G2P stage of the sentence
+ * analysis (item type, POS and graph or lexicon index) to its final
+ * phoneme sequence, i.e. after the word-level transducers have been
+ * applied. Words that recur across requests (product names, user
+ * names, ...) then skip the per-grapheme G2P tree traversals and the
+ * word-level FSTs.
+ *
+ * A cache belongs to a voice definition and is shared by all engines
+ * created for that voice; it can also be shared with voice definitions
+ * of the same resources in other systems, e.g. one system per thread.
+ * Lookups and insertions are serialized with a picopal mutex. Entries
+ * are evicted in least-recently-used order. The cache contents can be
+ * saved to and restored from a file so that a warm cache survives
+ * restarts.
+ *
+ * Caches are only created on request (picoext_createPronCache), there
+ * is no memory overhead otherwise. Each entry takes 112 bytes of
+ * system memory plus 4 to 8 bytes of hash table.
+ */
+
+#ifndef PICOPCACHE_H_
+#define PICOPCACHE_H_
+
+#include "picodefs.h"
+#include "picoos.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if 0
+}
+#endif
+
+/* maximum key and phoneme sequence length; longer words are not cached */
+#define PICOPCACHE_MAX_KEYLEN     48
+#define PICOPCACHE_MAX_PHONLEN    52
+
+/* maximum number of entries of one cache */
+#define PICOPCACHE_MAX_ENTRIES    16384
+
+typedef struct picopcache_pron_cache * picopcache_PronCache;
+
+
+/* create a cache for 'maxEntries' words; 'voiceId' identifies the voice
+   (its resources) and is checked when loading a cache file */
+picopcache_PronCache picopcache_newPronCache(picoos_MemoryManager mm,
+        picoos_uint32 maxEntries, picoos_uint32 voiceId);
+
+void picopcache_disposePronCache(picoos_MemoryManager mm,
+        picopcache_PronCache * this);
+
+picoos_uint32 picopcache_getVoiceId(picopcache_PronCache this);
+
+/* voices and voice definitions of other systems using the cache; a cache
+   must not be disposed while in use */
+void picopcache_attach(picopcache_PronCache this);
+void picopcache_detach(picopcache_PronCache this);
+picoos_bool picopcache_isAttached(picopcache_PronCache this);
+
+/* look up 'key'; on success the phonemes are copied to 'phones' (at
+   most 'maxlen') and TRUE is returned */
+picoos_bool picopcache_lookup(picopcache_PronCache this,
+        const picoos_uint8 * key, picoos_uint8 keylen,
+        picoos_uint8 * phones, picoos_uint16 maxlen, picoos_uint8 * plen);
+
+/* insert (or refresh) 'key', evicting the least recently used entry if
+   the cache is full; keys or phoneme sequences exceeding
+   PICOPCACHE_MAX_KEYLEN/PICOPCACHE_MAX_PHONLEN are ignored */
+void picopcache_insert(picopcache_PronCache this,
+        const picoos_uint8 * key, picoos_uint8 keylen,
+        const picoos_uint8 * phones, picoos_uint8 plen);
+
+/* remove all entries and reset the statistics */
+void picopcache_clear(picopcache_PronCache this);
+
+/* save/load cache contents; loading adds the file's entries to the
+   cache and fails with PICO_EXC_UNEXPECTED_FILE_TYPE if the file was
+   written for a different voice */
+pico_status_t picopcache_save(picoos_Common common,
+        picopcache_PronCache this, picoos_char * fileName);
+pico_status_t picopcache_load(picoos_Common common,
+        picopcache_PronCache this, picoos_char * fileName);
+
+void picopcache_getStats(picopcache_PronCache this,
+        picoos_uint32 * numEntries, picoos_uint32 * hits,
+        picoos_uint32 * misses);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*PICOPCACHE_H_*/
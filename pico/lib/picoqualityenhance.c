@@ -24,95 +24,92 @@
  * - Voice customization (pitch, speed, formant control)
  * - Quality mode presets
  * - Enhanced prosody controls
+ *
+ * All state is in the caller's pico_quality_context_t; the engines get
+ * pitch, formant and noise shaping as voice options.
  */
 
+#include <math.h>
+
 #include "picoqualityenhance.h"
 #include "picoos.h"
 #include "picodefs.h"
+#include "picoextapi.h"
 
 #if PICO_USE_QUALITY_ENHANCE
 
-/*******************************************************************************
- * Global State
- ******************************************************************************/
-
-/* Global quality context */
-static pico_quality_context_t g_quality_ctx = {
-    .initialized = 0
-};
-
-/* Global statistics */
-static pico_quality_stats_t g_quality_stats = {0};
-
 /*******************************************************************************
  * Initialization and Configuration
  ******************************************************************************/
 
-picoos_int32 pico_quality_init(void)
+picoos_int32 pico_quality_init(pico_quality_context_t *ctx)
 {
-    if (g_quality_ctx.initialized) {
-        return PICO_OK;  /* Already initialized */
+    int i;
+
+    if (!ctx) {
+        return PICO_ERR_NULLPTR_ACCESS;
     }
 
     /* Initialize default voice parameters */
-    g_quality_ctx.voice_params.pitch_scale = PICO_DEFAULT_PITCH_SCALE;
-    g_quality_ctx.voice_params.speed_scale = PICO_DEFAULT_SPEED_SCALE;
-    g_quality_ctx.voice_params.formant_shift = PICO_DEFAULT_FORMANT_SHIFT;
-    g_quality_ctx.voice_params.quality_mode = PICO_DEFAULT_QUALITY_MODE;
+    ctx->voice_params.pitch_scale = PICO_DEFAULT_PITCH_SCALE;
+    ctx->voice_params.speed_scale = PICO_DEFAULT_SPEED_SCALE;
+    ctx->voice_params.formant_shift = PICO_DEFAULT_FORMANT_SHIFT;
+    ctx->voice_params.quality_mode = PICO_DEFAULT_QUALITY_MODE;
 
     /* Initialize default prosody parameters */
-    g_quality_ctx.prosody_params.emphasis_scale = PICO_DEFAULT_EMPHASIS_SCALE;
-    g_quality_ctx.prosody_params.pause_scale = PICO_DEFAULT_PAUSE_SCALE;
-    g_quality_ctx.prosody_params.question_boost = PICO_DEFAULT_QUESTION_BOOST;
+    ctx->prosody_params.emphasis_scale = PICO_DEFAULT_EMPHASIS_SCALE;
+    ctx->prosody_params.pause_scale = PICO_DEFAULT_PAUSE_SCALE;
+    ctx->prosody_params.question_boost = PICO_DEFAULT_QUESTION_BOOST;
 
     /* Initialize noise filter */
-    g_quality_ctx.noise_filter.order = PICO_NOISE_FILTER_ORDER;
-    {
-        int i;
-        for (i = 0; i < PICO_NOISE_FILTER_ORDER; i++) {
-            g_quality_ctx.noise_filter.state[i] = 0;
-            /* Default coefficients (simple all-pass initially) */
-            g_quality_ctx.noise_filter.coeffs[i] = 0;
-        }
+    ctx->noise_filter.order = PICO_NOISE_FILTER_ORDER;
+    for (i = 0; i < PICO_NOISE_FILTER_ORDER; i++) {
+        ctx->noise_filter.state[i] = 0;
+        /* Default coefficients (no shaping) */
+        ctx->noise_filter.coeffs[i] = 0;
     }
 
     /* Initialize random seed */
-    g_quality_ctx.random_seed = 12345;
+    ctx->random_seed = 12345;
 
     /* Reset statistics */
-    pico_reset_quality_stats();
+    pico_reset_quality_stats(ctx);
 
-    g_quality_ctx.initialized = 1;
+    ctx->initialized = 1;
 
     return PICO_OK;
 }
 
-picoos_int32 pico_quality_cleanup(void)
+picoos_int32 pico_quality_cleanup(pico_quality_context_t *ctx)
 {
-    if (!g_quality_ctx.initialized) {
-        return PICO_OK;
+    if (!ctx) {
+        return PICO_ERR_NULLPTR_ACCESS;
     }
 
     /* Reset all state */
-    g_quality_ctx.initialized = 0;
+    ctx->initialized = 0;
 
     return PICO_OK;
 }
 
-picoos_int32 pico_set_quality_mode(picoos_int8 mode)
+picoos_int32 pico_set_quality_mode(pico_quality_context_t *ctx, picoos_int8 mode)
 {
+    if (!ctx) {
+        return PICO_ERR_NULLPTR_ACCESS;
+    }
+
     if (mode < PICO_QUALITY_MODE_SPEED || mode > PICO_QUALITY_MODE_QUALITY) {
         return PICO_ERR_OTHER;
     }
 
-    g_quality_ctx.voice_params.quality_mode = mode;
+    ctx->voice_params.quality_mode = mode;
 
     return PICO_OK;
 }
 
-picoos_int8 pico_get_quality_mode(void)
+picoos_int8 pico_get_quality_mode(const pico_quality_context_t *ctx)
 {
-    return g_quality_ctx.voice_params.quality_mode;
+    return ctx ? ctx->voice_params.quality_mode : PICO_DEFAULT_QUALITY_MODE;
 }
 
 /*******************************************************************************
@@ -152,11 +149,12 @@ picoos_int32 pico_validate_voice_params(pico_voice_params_t *params)
     return PICO_OK;
 }
 
-picoos_int32 pico_set_voice_params(pico_voice_params_t *params)
+picoos_int32 pico_set_voice_params(pico_quality_context_t *ctx,
+    pico_voice_params_t *params)
 {
     picoos_int32 result;
 
-    if (!params) {
+    if (!ctx || !params) {
         return PICO_ERR_NULLPTR_ACCESS;
     }
 
@@ -167,28 +165,33 @@ picoos_int32 pico_set_voice_params(pico_voice_params_t *params)
     }
 
     /* Apply parameters */
-    g_quality_ctx.voice_params = *params;
+    ctx->voice_params = *params;
 
     return PICO_OK;
 }
 
-picoos_int32 pico_get_voice_params(pico_voice_params_t *params)
+picoos_int32 pico_get_voice_params(const pico_quality_context_t *ctx,
+    pico_voice_params_t *params)
 {
-    if (!params) {
+    if (!ctx || !params) {
         return PICO_ERR_NULLPTR_ACCESS;
     }
 
-    *params = g_quality_ctx.voice_params;
+    *params = ctx->voice_params;
 
     return PICO_OK;
 }
 
-picoos_int32 pico_reset_voice_params(void)
+picoos_int32 pico_reset_voice_params(pico_quality_context_t *ctx)
 {
-    g_quality_ctx.voice_params.pitch_scale = PICO_DEFAULT_PITCH_SCALE;
-    g_quality_ctx.voice_params.speed_scale = PICO_DEFAULT_SPEED_SCALE;
-    g_quality_ctx.voice_params.formant_shift = PICO_DEFAULT_FORMANT_SHIFT;
-    g_quality_ctx.voice_params.quality_mode = PICO_DEFAULT_QUALITY_MODE;
+    if (!ctx) {
+        return PICO_ERR_NULLPTR_ACCESS;
+    }
+
+    ctx->voice_params.pitch_scale = PICO_DEFAULT_PITCH_SCALE;
+    ctx->voice_params.speed_scale = PICO_DEFAULT_SPEED_SCALE;
+    ctx->voice_params.formant_shift = PICO_DEFAULT_FORMANT_SHIFT;
+    ctx->voice_params.quality_mode = PICO_DEFAULT_QUALITY_MODE;
 
     return PICO_OK;
 }
@@ -197,9 +200,10 @@ picoos_int32 pico_reset_voice_params(void)
  * Prosody Control
  ******************************************************************************/
 
-picoos_int32 pico_set_prosody_params(pico_prosody_params_t *params)
+picoos_int32 pico_set_prosody_params(pico_quality_context_t *ctx,
+    pico_prosody_params_t *params)
 {
-    if (!params) {
+    if (!ctx || !params) {
         return PICO_ERR_NULLPTR_ACCESS;
     }
 
@@ -211,27 +215,32 @@ picoos_int32 pico_set_prosody_params(pico_prosody_params_t *params)
     if (params->question_boost > 100) params->question_boost = 100;
 
     /* Apply parameters */
-    g_quality_ctx.prosody_params = *params;
+    ctx->prosody_params = *params;
 
     return PICO_OK;
 }
 
-picoos_int32 pico_get_prosody_params(pico_prosody_params_t *params)
+picoos_int32 pico_get_prosody_params(const pico_quality_context_t *ctx,
+    pico_prosody_params_t *params)
 {
-    if (!params) {
+    if (!ctx || !params) {
         return PICO_ERR_NULLPTR_ACCESS;
     }
 
-    *params = g_quality_ctx.prosody_params;
+    *params = ctx->prosody_params;
 
     return PICO_OK;
 }
 
-picoos_int32 pico_reset_prosody_params(void)
+picoos_int32 pico_reset_prosody_params(pico_quality_context_t *ctx)
 {
-    g_quality_ctx.prosody_params.emphasis_scale = PICO_DEFAULT_EMPHASIS_SCALE;
-    g_quality_ctx.prosody_params.pause_scale = PICO_DEFAULT_PAUSE_SCALE;
-    g_quality_ctx.prosody_params.question_boost = PICO_DEFAULT_QUESTION_BOOST;
+    if (!ctx) {
+        return PICO_ERR_NULLPTR_ACCESS;
+    }
+
+    ctx->prosody_params.emphasis_scale = PICO_DEFAULT_EMPHASIS_SCALE;
+    ctx->prosody_params.pause_scale = PICO_DEFAULT_PAUSE_SCALE;
+    ctx->prosody_params.question_boost = PICO_DEFAULT_QUESTION_BOOST;
 
     return PICO_OK;
 }
@@ -317,9 +326,6 @@ picoos_int16 pico_generate_shaped_noise(
     /* Store new output */
     filter->state[0] = (picoos_int16)(output >> 8);
 
-    /* Update statistics */
-    g_quality_stats.noise_samples_generated++;
-
     return filter->state[0];
 }
 
@@ -338,12 +344,83 @@ picoos_int32 pico_noise_filter_update(
         filter->coeffs[i] = coeffs[i];
     }
 
-    /* Update statistics */
-    g_quality_stats.filter_updates++;
+    return PICO_OK;
+}
+
+picoos_int32 pico_quality_set_noise_filter(
+    pico_quality_context_t *ctx,
+    picoos_int16 *coeffs,
+    picoos_int8 order)
+{
+    picoos_int32 result;
+
+    if (!ctx) {
+        return PICO_ERR_NULLPTR_ACCESS;
+    }
+
+    result = pico_noise_filter_init(&ctx->noise_filter, coeffs, order);
+    if (result == PICO_OK) {
+        ctx->stats.filter_updates++;
+    }
+
+    return result;
+}
+
+picoos_int32 pico_quality_generate_noise(
+    pico_quality_context_t *ctx,
+    picoos_int16 *out,
+    picoos_int32 n)
+{
+    picoos_int32 i;
+
+    if (!ctx || !out) {
+        return PICO_ERR_NULLPTR_ACCESS;
+    }
+
+    for (i = 0; i < n; i++) {
+        out[i] = pico_generate_shaped_noise(&ctx->noise_filter, &ctx->random_seed);
+    }
+    ctx->stats.noise_samples_generated += n;
 
     return PICO_OK;
 }
 
+picoos_int32 pico_noise_filter_gains(const pico_noise_filter_t *filter)
+{
+    double db[8], mean, re, im, w;
+    picoos_int32 gains, step;
+    int i, k;
+
+    if (!filter) {
+        return 0;
+    }
+
+    /* |H| = 1 / |A| with A(z) = 1 + sum(coeffs[i] / 32768 * z^-(i+1)) */
+    mean = 0;
+    for (k = 0; k < 8; k++) {
+        w = 2.0 * M_PI * (k + 0.5) / 16.0;
+        re = 1.0;
+        im = 0.0;
+        for (i = 0; i < filter->order; i++) {
+            re += filter->coeffs[i] / 32768.0 * cos(w * (i + 1));
+            im -= filter->coeffs[i] / 32768.0 * sin(w * (i + 1));
+        }
+        db[k] = -10.0 * log10(re * re + im * im + 1e-12);
+        mean += db[k] / 8;
+    }
+
+    /* 4 bit steps of 1.5dB relative to the mean, see PICOEXT_VOICEOPT_SIG_NOISE */
+    gains = 0;
+    for (k = 0; k < 8; k++) {
+        step = (picoos_int32) floor((db[k] - mean) / 1.5 + 0.5);
+        if (step < -8) step = -8;
+        if (step > 7) step = 7;
+        gains |= (step & 15) << (4 * k);
+    }
+
+    return gains;
+}
+
 /*******************************************************************************
  * Utility Functions
  ******************************************************************************/
@@ -363,9 +440,6 @@ picoos_int16 pico_apply_pitch_scale(picoos_int16 f0, picoos_single scale)
     if (scaled_f0 < 50.0f) scaled_f0 = 50.0f;
     if (scaled_f0 > 500.0f) scaled_f0 = 500.0f;
 
-    /* Update statistics */
-    g_quality_stats.pitch_adjustments++;
-
     return (picoos_int16)scaled_f0;
 }
 
@@ -384,9 +458,6 @@ picoos_int16 pico_apply_formant_shift(picoos_int16 formant, picoos_single shift)
     if (shifted_formant < 200.0f) shifted_formant = 200.0f;
     if (shifted_formant > 5000.0f) shifted_formant = 5000.0f;
 
-    /* Update statistics */
-    g_quality_stats.formant_shifts++;
-
     return (picoos_int16)shifted_formant;
 }
 
@@ -401,10 +472,18 @@ picoos_single pico_clamp_float(picoos_single value, picoos_single min, picoos_si
  * Preset Voice Profiles
  ******************************************************************************/
 
-picoos_int32 pico_apply_voice_profile(pico_voice_profile_t profile)
+picoos_int32 pico_apply_voice_profile(pico_quality_context_t *ctx,
+    pico_voice_profile_t profile)
 {
-    pico_voice_params_t params = g_quality_ctx.voice_params;
-    pico_prosody_params_t prosody = g_quality_ctx.prosody_params;
+    pico_voice_params_t params;
+    pico_prosody_params_t prosody;
+
+    if (!ctx) {
+        return PICO_ERR_NULLPTR_ACCESS;
+    }
+
+    params = ctx->voice_params;
+    prosody = ctx->prosody_params;
 
     /* Reset to defaults first */
     params.pitch_scale = PICO_DEFAULT_PITCH_SCALE;
@@ -452,33 +531,85 @@ picoos_int32 pico_apply_voice_profile(pico_voice_profile_t profile)
     }
 
     /* Apply the parameters */
-    pico_set_voice_params(&params);
-    pico_set_prosody_params(&prosody);
+    pico_set_voice_params(ctx, &params);
+    pico_set_prosody_params(ctx, &prosody);
 
     return PICO_OK;
 }
 
+/*******************************************************************************
+ * Engine Integration
+ ******************************************************************************/
+
+pico_Status pico_quality_set_voice_options(
+    pico_quality_context_t *ctx,
+    pico_System system,
+    const pico_Char *voiceName)
+{
+    pico_Int32 pitch, formant;
+    pico_Status status;
+
+    if (!ctx) {
+        return PICO_ERR_NULLPTR_ACCESS;
+    }
+
+    /* percent and Hz, see PICOEXT_VOICEOPT_SIG_PITCH and _SIG_FORMANT */
+    pitch = (pico_Int32) floor(ctx->voice_params.pitch_scale * 100.0f + 0.5f);
+    formant = (pico_Int32) floor(ctx->voice_params.formant_shift + 0.5f);
+
+    status = picoext_setVoiceOption(system, voiceName,
+            PICOEXT_VOICEOPT_SIG_PITCH, (pitch == 100) ? 0 : pitch);
+    if (status == PICO_OK) {
+        status = picoext_setVoiceOption(system, voiceName,
+                PICOEXT_VOICEOPT_SIG_FORMANT, formant);
+    }
+    if (status == PICO_OK) {
+        status = picoext_setVoiceOption(system, voiceName,
+                PICOEXT_VOICEOPT_SIG_NOISE,
+                pico_noise_filter_gains(&ctx->noise_filter));
+    }
+    if (status == PICO_OK) {
+        if (pitch != 100) ctx->stats.pitch_adjustments++;
+        if (formant != 0) ctx->stats.formant_shifts++;
+    }
+
+    return status;
+}
+
+picoos_int32 pico_get_speed_level(const pico_quality_context_t *ctx)
+{
+    if (!ctx) {
+        return 100;
+    }
+    return (picoos_int32) floor(ctx->voice_params.speed_scale * 100.0f + 0.5f);
+}
+
 /*******************************************************************************
  * Statistics and Debugging
  ******************************************************************************/
 
-picoos_int32 pico_get_quality_stats(pico_quality_stats_t *stats)
+picoos_int32 pico_get_quality_stats(const pico_quality_context_t *ctx,
+    pico_quality_stats_t *stats)
 {
-    if (!stats) {
+    if (!ctx || !stats) {
         return PICO_ERR_NULLPTR_ACCESS;
     }
 
-    *stats = g_quality_stats;
+    *stats = ctx->stats;
 
     return PICO_OK;
 }
 
-picoos_int32 pico_reset_quality_stats(void)
+picoos_int32 pico_reset_quality_stats(pico_quality_context_t *ctx)
 {
-    g_quality_stats.noise_samples_generated = 0;
-    g_quality_stats.filter_updates = 0;
-    g_quality_stats.pitch_adjustments = 0;
-    g_quality_stats.formant_shifts = 0;
+    if (!ctx) {
+        return PICO_ERR_NULLPTR_ACCESS;
+    }
+
+    ctx->stats.noise_samples_generated = 0;
+    ctx->stats.filter_updates = 0;
+    ctx->stats.pitch_adjustments = 0;
+    ctx->stats.formant_shifts = 0;
 
     return PICO_OK;
 }
@@ -489,17 +620,24 @@ picoos_int32 pico_reset_quality_stats(void)
  * Stub implementations when quality enhancement is disabled
  ******************************************************************************/
 
-picoos_int32 pico_quality_init(void) { return PICO_OK; }
-picoos_int32 pico_quality_cleanup(void) { return PICO_OK; }
-picoos_int32 pico_set_quality_mode(picoos_int8 mode) { (void)mode; return PICO_OK; }
-picoos_int8 pico_get_quality_mode(void) { return PICO_QUALITY_MODE_BALANCED; }
+picoos_int32 pico_quality_init(pico_quality_context_t *ctx) { (void)ctx; return PICO_OK; }
+picoos_int32 pico_quality_cleanup(pico_quality_context_t *ctx) { (void)ctx; return PICO_OK; }
+picoos_int32 pico_set_quality_mode(pico_quality_context_t *ctx, picoos_int8 mode) {
+    (void)ctx; (void)mode;
+    return PICO_OK;
+}
+picoos_int8 pico_get_quality_mode(const pico_quality_context_t *ctx) {
+    (void)ctx;
+    return PICO_QUALITY_MODE_BALANCED;
+}
 
-picoos_int32 pico_set_voice_params(pico_voice_params_t *params) { 
-    (void)params; 
+picoos_int32 pico_set_voice_params(pico_quality_context_t *ctx, pico_voice_params_t *params) { 
+    (void)ctx; (void)params; 
     return PICO_OK; 
 }
 
-picoos_int32 pico_get_voice_params(pico_voice_params_t *params) { 
+picoos_int32 pico_get_voice_params(const pico_quality_context_t *ctx, pico_voice_params_t *params) { 
+    (void)ctx;
     if (params) {
         params->pitch_scale = 1.0f;
         params->speed_scale = 1.0f;
@@ -509,18 +647,19 @@ picoos_int32 pico_get_voice_params(pico_voice_params_t *params) {
     return PICO_OK; 
 }
 
-picoos_int32 pico_reset_voice_params(void) { return PICO_OK; }
+picoos_int32 pico_reset_voice_params(pico_quality_context_t *ctx) { (void)ctx; return PICO_OK; }
 picoos_int32 pico_validate_voice_params(pico_voice_params_t *params) { 
     (void)params; 
     return PICO_OK; 
 }
 
-picoos_int32 pico_set_prosody_params(pico_prosody_params_t *params) { 
-    (void)params; 
+picoos_int32 pico_set_prosody_params(pico_quality_context_t *ctx, pico_prosody_params_t *params) { 
+    (void)ctx; (void)params; 
     return PICO_OK; 
 }
 
-picoos_int32 pico_get_prosody_params(pico_prosody_params_t *params) { 
+picoos_int32 pico_get_prosody_params(const pico_quality_context_t *ctx, pico_prosody_params_t *params) { 
+    (void)ctx;
     if (params) {
         params->emphasis_scale = 1.0f;
         params->pause_scale = 1.0f;
@@ -529,7 +668,7 @@ picoos_int32 pico_get_prosody_params(pico_prosody_params_t *params) {
     return PICO_OK; 
 }
 
-picoos_int32 pico_reset_prosody_params(void) { return PICO_OK; }
+picoos_int32 pico_reset_prosody_params(pico_quality_context_t *ctx) { (void)ctx; return PICO_OK; }
 
 picoos_int32 pico_noise_filter_init(pico_noise_filter_t *f, picoos_int16 *c, picoos_int8 o) {
     (void)f; (void)c; (void)o;
@@ -551,6 +690,26 @@ picoos_int32 pico_noise_filter_update(pico_noise_filter_t *f, picoos_int16 *c) {
     return PICO_OK;
 }
 
+picoos_int32 pico_quality_set_noise_filter(pico_quality_context_t *ctx, picoos_int16 *c, picoos_int8 o) {
+    (void)ctx; (void)c; (void)o;
+    return PICO_OK;
+}
+
+picoos_int32 pico_quality_generate_noise(pico_quality_context_t *ctx, picoos_int16 *out, picoos_int32 n) {
+    picoos_uint32 seed = 12345;
+    picoos_int32 i;
+    (void)ctx;
+    for (i = 0; i < n; i++) {
+        out[i] = pico_generate_white_noise(&seed);
+    }
+    return PICO_OK;
+}
+
+picoos_int32 pico_noise_filter_gains(const pico_noise_filter_t *filter) {
+    (void)filter;
+    return 0;
+}
+
 picoos_int16 pico_apply_pitch_scale(picoos_int16 f0, picoos_single scale) {
     (void)scale;
     return f0;
@@ -567,12 +726,24 @@ picoos_single pico_clamp_float(picoos_single value, picoos_single min, picoos_si
     return value;
 }
 
-picoos_int32 pico_apply_voice_profile(pico_voice_profile_t profile) {
-    (void)profile;
+picoos_int32 pico_apply_voice_profile(pico_quality_context_t *ctx, pico_voice_profile_t profile) {
+    (void)ctx; (void)profile;
+    return PICO_OK;
+}
+
+pico_Status pico_quality_set_voice_options(pico_quality_context_t *ctx, pico_System system,
+    const pico_Char *voiceName) {
+    (void)ctx; (void)system; (void)voiceName;
     return PICO_OK;
 }
 
-picoos_int32 pico_get_quality_stats(pico_quality_stats_t *stats) {
+picoos_int32 pico_get_speed_level(const pico_quality_context_t *ctx) {
+    (void)ctx;
+    return 100;
+}
+
+picoos_int32 pico_get_quality_stats(const pico_quality_context_t *ctx, pico_quality_stats_t *stats) {
+    (void)ctx;
     if (stats) {
         stats->noise_samples_generated = 0;
         stats->filter_updates = 0;
@@ -582,6 +753,6 @@ picoos_int32 pico_get_quality_stats(pico_quality_stats_t *stats) {
     return PICO_OK;
 }
 
-picoos_int32 pico_reset_quality_stats(void) { return PICO_OK; }
+picoos_int32 pico_reset_quality_stats(pico_quality_context_t *ctx) { (void)ctx; return PICO_OK; }
 
 #endif /* PICO_USE_QUALITY_ENHANCE */
@@ -28,6 +28,15 @@
  * - Quality mode presets (speed, balanced, quality)
  * - Enhanced prosody controls
  *
+ * All state is in a pico_quality_context_t owned by the caller, one per
+ * voice or thread; there is no global state. The context is applied to
+ * the engines of a voice definition with pico_quality_set_voice_options:
+ * pitch scale, formant shift and noise shaping become the voice options
+ * PICOEXT_VOICEOPT_SIG_PITCH, _SIG_FORMANT and _SIG_NOISE (see
+ * picoextapi.h), which the signal generation of each engine applies
+ * without an additional pass over the signal. Engines of different voice
+ * definitions can thus run different profiles concurrently.
+ *
  * Phase 3: Quality Improvements
  */
 
@@ -36,6 +45,7 @@
 
 #include "picoos.h"
 #include "picodefs.h"
+#include "picoapi.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -115,6 +125,16 @@ typedef struct pico_noise_filter {
     picoos_int8  order;                             /**< Filter order */
 } pico_noise_filter_t;
 
+/**
+ * Quality enhancement statistics
+ */
+typedef struct pico_quality_stats {
+    picoos_uint32 noise_samples_generated;  /**< Total shaped noise samples */
+    picoos_uint32 filter_updates;           /**< Noise filter coefficient updates */
+    picoos_uint32 pitch_adjustments;        /**< Voices set up with a pitch scale */
+    picoos_uint32 formant_shifts;           /**< Voices set up with a formant shift */
+} pico_quality_stats_t;
+
 /**
  * Quality enhancement context
  * Holds runtime state for quality features
@@ -124,6 +144,7 @@ typedef struct pico_quality_context {
     pico_prosody_params_t prosody_params;  /**< Current prosody parameters */
     pico_noise_filter_t   noise_filter;    /**< Noise shaping filter */
     picoos_uint32         random_seed;     /**< Random number generator seed */
+    pico_quality_stats_t  stats;           /**< Statistics of this context */
     picoos_int8           initialized;     /**< Initialization flag */
 } pico_quality_context_t;
 
@@ -132,34 +153,38 @@ typedef struct pico_quality_context {
  ******************************************************************************/
 
 /**
- * Initialize quality enhancement module
- * Must be called before using any quality features
+ * Initialize a quality enhancement context
+ * Must be called before using the context
  *
+ * @param ctx Context to initialize
  * @return PICO_OK on success, error code otherwise
  */
-picoos_int32 pico_quality_init(void);
+picoos_int32 pico_quality_init(pico_quality_context_t *ctx);
 
 /**
- * Cleanup quality enhancement resources
+ * Cleanup a quality enhancement context
  *
+ * @param ctx Context to clean up
  * @return PICO_OK on success, error code otherwise
  */
-picoos_int32 pico_quality_cleanup(void);
+picoos_int32 pico_quality_cleanup(pico_quality_context_t *ctx);
 
 /**
  * Set quality mode preset
  *
+ * @param ctx Quality context
  * @param mode Quality mode (PICO_QUALITY_MODE_SPEED/BALANCED/QUALITY)
  * @return PICO_OK on success, error code otherwise
  */
-picoos_int32 pico_set_quality_mode(picoos_int8 mode);
+picoos_int32 pico_set_quality_mode(pico_quality_context_t *ctx, picoos_int8 mode);
 
 /**
  * Get current quality mode
  *
+ * @param ctx Quality context
  * @return Current quality mode
  */
-picoos_int8 pico_get_quality_mode(void);
+picoos_int8 pico_get_quality_mode(const pico_quality_context_t *ctx);
 
 /*******************************************************************************
  * Voice Parameter Control
@@ -168,6 +193,7 @@ picoos_int8 pico_get_quality_mode(void);
 /**
  * Set voice customization parameters
  *
+ * @param ctx Quality context
  * @param params Pointer to voice parameters structure
  * @return PICO_OK on success, error code otherwise
  *
@@ -179,25 +205,29 @@ picoos_int8 pico_get_quality_mode(void);
  *     .formant_shift = 100.0f,// Shift formants up
  *     .quality_mode = PICO_QUALITY_MODE_BALANCED
  * };
- * pico_set_voice_params(&params);
+ * pico_set_voice_params(&ctx, &params);
  * @endcode
  */
-picoos_int32 pico_set_voice_params(pico_voice_params_t *params);
+picoos_int32 pico_set_voice_params(pico_quality_context_t *ctx,
+    pico_voice_params_t *params);
 
 /**
  * Get current voice parameters
  *
+ * @param ctx Quality context
  * @param params Pointer to store current parameters
  * @return PICO_OK on success, error code otherwise
  */
-picoos_int32 pico_get_voice_params(pico_voice_params_t *params);
+picoos_int32 pico_get_voice_params(const pico_quality_context_t *ctx,
+    pico_voice_params_t *params);
 
 /**
  * Reset voice parameters to defaults
  *
+ * @param ctx Quality context
  * @return PICO_OK on success, error code otherwise
  */
-picoos_int32 pico_reset_voice_params(void);
+picoos_int32 pico_reset_voice_params(pico_quality_context_t *ctx);
 
 /**
  * Validate voice parameters (check bounds)
@@ -214,6 +244,7 @@ picoos_int32 pico_validate_voice_params(pico_voice_params_t *params);
 /**
  * Set prosody enhancement parameters
  *
+ * @param ctx Quality context
  * @param params Pointer to prosody parameters structure
  * @return PICO_OK on success, error code otherwise
  *
@@ -224,25 +255,29 @@ picoos_int32 pico_validate_voice_params(pico_voice_params_t *params);
  *     .pause_scale = 1.2f,      // Longer pauses
  *     .question_boost = 70      // Stronger questions
  * };
- * pico_set_prosody_params(&params);
+ * pico_set_prosody_params(&ctx, &params);
  * @endcode
  */
-picoos_int32 pico_set_prosody_params(pico_prosody_params_t *params);
+picoos_int32 pico_set_prosody_params(pico_quality_context_t *ctx,
+    pico_prosody_params_t *params);
 
 /**
  * Get current prosody parameters
  *
+ * @param ctx Quality context
  * @param params Pointer to store current parameters
  * @return PICO_OK on success, error code otherwise
  */
-picoos_int32 pico_get_prosody_params(pico_prosody_params_t *params);
+picoos_int32 pico_get_prosody_params(const pico_quality_context_t *ctx,
+    pico_prosody_params_t *params);
 
 /**
  * Reset prosody parameters to defaults
  *
+ * @param ctx Quality context
  * @return PICO_OK on success, error code otherwise
  */
-picoos_int32 pico_reset_prosody_params(void);
+picoos_int32 pico_reset_prosody_params(pico_quality_context_t *ctx);
 
 /*******************************************************************************
  * Excitation Generation (Improved Noise Shaping)
@@ -303,12 +338,56 @@ picoos_int32 pico_noise_filter_update(
     picoos_int16 *coeffs
 );
 
+/**
+ * Set the noise shaping filter of a context
+ * The filter shapes the noise of pico_quality_generate_noise and, through
+ * pico_quality_set_voice_options, the unvoiced excitation of the engines
+ *
+ * @param ctx Quality context
+ * @param coeffs LPC coefficients (Q15 format)
+ * @param order Filter order (1 to PICO_NOISE_FILTER_ORDER)
+ * @return PICO_OK on success, error code otherwise
+ */
+picoos_int32 pico_quality_set_noise_filter(
+    pico_quality_context_t *ctx,
+    picoos_int16 *coeffs,
+    picoos_int8 order
+);
+
+/**
+ * Generate a block of shaped noise with the filter and seed of a context
+ *
+ * @param ctx Quality context
+ * @param out Output samples
+ * @param n Number of samples
+ * @return PICO_OK on success, error code otherwise
+ */
+picoos_int32 pico_quality_generate_noise(
+    pico_quality_context_t *ctx,
+    picoos_int16 *out,
+    picoos_int32 n
+);
+
+/**
+ * Noise shaping gains of a noise filter
+ * Samples the magnitude response of the all-pole filter at the centers
+ * of the eight 1kHz bands, relative to its mean over the bands (so the
+ * noise level stays about the same), in steps of 1.5dB from -12dB to
+ * +10.5dB
+ *
+ * @param filter Pointer to noise filter
+ * @return Value of the voice option PICOEXT_VOICEOPT_SIG_NOISE, 0 for
+ *         a flat filter
+ */
+picoos_int32 pico_noise_filter_gains(const pico_noise_filter_t *filter);
+
 /*******************************************************************************
  * Utility Functions
  ******************************************************************************/
 
 /**
- * Apply pitch scaling to F0 contour
+ * Apply pitch scaling to an F0 value
+ * (the engines scale F0 themselves, see pico_quality_set_voice_options)
  *
  * @param f0 Input F0 value (Hz)
  * @param scale Pitch scale factor (0.5-2.0)
@@ -355,6 +434,7 @@ typedef enum {
 /**
  * Apply voice profile preset
  *
+ * @param ctx Quality context
  * @param profile Voice profile to apply
  * @return PICO_OK on success, error code otherwise
  *
@@ -366,36 +446,63 @@ typedef enum {
  * - SLOW: speed_scale=0.75, pause_scale=1.3
  * - FAST: speed_scale=1.40, pause_scale=0.8
  */
-picoos_int32 pico_apply_voice_profile(pico_voice_profile_t profile);
+picoos_int32 pico_apply_voice_profile(pico_quality_context_t *ctx,
+    pico_voice_profile_t profile);
 
 /*******************************************************************************
- * Statistics and Debugging
+ * Engine Integration
  ******************************************************************************/
 
 /**
- * Get quality enhancement statistics
+ * Apply a context to the engines of a voice definition
+ * Sets the voice options PICOEXT_VOICEOPT_SIG_PITCH (pitch_scale),
+ * PICOEXT_VOICEOPT_SIG_FORMANT (formant_shift) and PICOEXT_VOICEOPT_SIG_NOISE
+ * (pico_noise_filter_gains of the noise filter) of the voice definition;
+ * they take effect for the engines created afterwards
+ *
+ * @param ctx Quality context
+ * @param system The pico system
+ * @param voiceName Name of the voice definition
+ * @return PICO_OK on success, error code of picoext_setVoiceOption otherwise
+ *
+ * The speed scale is not a voice option: use pico_get_speed_level with
+ * the <speed> markup.
  */
-typedef struct pico_quality_stats {
-    picoos_uint32 noise_samples_generated;  /**< Total shaped noise samples */
-    picoos_uint32 filter_updates;           /**< Noise filter coefficient updates */
-    picoos_uint32 pitch_adjustments;        /**< Pitch scaling operations */
-    picoos_uint32 formant_shifts;           /**< Formant shift operations */
-} pico_quality_stats_t;
+pico_Status pico_quality_set_voice_options(
+    pico_quality_context_t *ctx,
+    pico_System system,
+    const pico_Char *voiceName
+);
+
+/**
+ * Speed of a context as level of the <speed> markup
+ *
+ * @param ctx Quality context
+ * @return Speed level in percent (100: normal)
+ */
+picoos_int32 pico_get_speed_level(const pico_quality_context_t *ctx);
+
+/*******************************************************************************
+ * Statistics and Debugging
+ ******************************************************************************/
 
 /**
  * Get quality enhancement statistics
  *
+ * @param ctx Quality context
  * @param stats Pointer to store statistics
  * @return PICO_OK on success, error code otherwise
  */
-picoos_int32 pico_get_quality_stats(pico_quality_stats_t *stats);
+picoos_int32 pico_get_quality_stats(const pico_quality_context_t *ctx,
+    pico_quality_stats_t *stats);
 
 /**
  * Reset quality enhancement statistics
  *
+ * @param ctx Quality context
  * @return PICO_OK on success, error code otherwise
  */
-picoos_int32 pico_reset_quality_stats(void);
+picoos_int32 pico_reset_quality_stats(pico_quality_context_t *ctx);
 
 /*******************************************************************************
  * Default Parameters
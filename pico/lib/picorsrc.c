@@ -38,6 +38,7 @@
 #include "picoktab.h"
 #include "picokpr.h"
 
+#include "picopcache.h"
 #include "picorsrc.h"
 
 #ifdef __cplusplus
@@ -137,6 +138,11 @@ static void picorsrc_initializeVoice(picorsrc_Voice this)
           this->kbArray[i] = NULL;
         }
         this->numResources = 0;
+        this->pronCache = NULL;
+        this->dtCache = NULL;
+        for (i=0; i<PICORSRC_NUM_VOPTS; i++) {
+            this->options[i] = 0;
+        }
         this->next = NULL;
     }
 }
@@ -170,18 +176,26 @@ typedef struct picorsrc_voice_definition {
     picoos_char voiceName[PICO_MAX_VOICE_NAME_SIZE];
     picoos_uint8 numResources;
     picorsrc_resource_name_t resourceName[PICO_MAX_NUM_RSRC_PER_VOICE];
+    picopcache_PronCache pronCache; /* optional, shared by the voice's engines */
+    picoos_uint8 pronCacheShared;   /* pronCache owned by another system */
+    picoos_int32 options[PICORSRC_NUM_VOPTS];
     picorsrc_VoiceDefinition next;
 } picorsrc_voice_definition_t;
 
 
 static picorsrc_VoiceDefinition picorsrc_newVoiceDefinition(picoos_MemoryManager mm)
 {
-    /* picoos_uint8 i; */
+    picoos_uint8 i;
     picorsrc_VoiceDefinition this = (picorsrc_VoiceDefinition) picoos_allocate(mm,sizeof(*this));
     if (NULL != this) {
         /* initialize */
         this->voiceName[0] = NULLC;
         this->numResources = 0;
+        this->pronCache = NULL;
+        this->pronCacheShared = FALSE;
+        for (i = 0; i < PICORSRC_NUM_VOPTS; i++) {
+            this->options[i] = 0;
+        }
         /*
         for (i=0; i < PICO_MAX_NUM_RSRC_PER_VOICE; i++) {
             this->resourceName[i][0] = NULLC;
@@ -839,10 +853,48 @@ pico_status_t picorsrc_addResourceToVoiceDefinition(picorsrc_ResourceManager thi
 }
 
 
+/* cached pronunciations are only valid for the same set of resources;
+   identify it by a hash over the resource names (FNV-1a) */
+static picoos_uint32 vdefPronCacheId(picorsrc_VoiceDefinition vdef)
+{
+    picoos_uint32 voiceId;
+    picoos_uint8 i;
+    picoos_uint8 * p;
+
+    voiceId = 2166136261u;
+    for (i = 0; i < vdef->numResources; i++) {
+        for (p = vdef->resourceName[i]; NULLC != *p; p++) {
+            voiceId = (voiceId ^ *p) * 16777619u;
+        }
+        voiceId = (voiceId ^ '|') * 16777619u;
+    }
+    return voiceId;
+}
+
+/* drop the voice definition's pronunciation cache; an own cache is
+   disposed unless in use by voices or other systems */
+static pico_status_t disposeVdefPronCache(picorsrc_ResourceManager this,
+        picorsrc_VoiceDefinition vdef)
+{
+    if (NULL != vdef->pronCache) {
+        if (vdef->pronCacheShared) {
+            picopcache_detach(vdef->pronCache);
+            vdef->pronCache = NULL;
+            vdef->pronCacheShared = FALSE;
+        } else if (picopcache_isAttached(vdef->pronCache)) {
+            return PICO_EXC_RESOURCE_BUSY;
+        } else {
+            picopcache_disposePronCache(this->common->mm,&vdef->pronCache);
+        }
+    }
+    return PICO_OK;
+}
+
 pico_status_t picorsrc_createVoiceDefinition(picorsrc_ResourceManager this,
         picoos_char * voiceName)
 {
     picorsrc_VoiceDefinition vdef;
+    picoos_uint8 i;
 
     if (NULL == this) {
         PICODBG_ERROR(("this is NULL"));
@@ -863,6 +915,11 @@ pico_status_t picorsrc_createVoiceDefinition(picorsrc_ResourceManager this,
         this->freeVdefs = vdef->next;
         vdef->voiceName[0] = NULLC;
         vdef->numResources = 0;
+        vdef->pronCache = NULL;
+        vdef->pronCacheShared = FALSE;
+        for (i = 0; i < PICORSRC_NUM_VOPTS; i++) {
+            vdef->options[i] = 0;
+        }
         vdef->next = NULL;
     }
     if (NULL == vdef) {
@@ -901,6 +958,9 @@ pico_status_t picorsrc_releaseVoiceDefinition(picorsrc_ResourceManager this,
         v = v->next;
     }
     if (v != NULL) {
+        if (PICO_OK != disposeVdefPronCache(this,v)) {
+            return picoos_emRaiseException(this->common->em,PICO_EXC_RESOURCE_BUSY,NULL,(picoos_char *)"pronunciation cache of voice %s in use",voiceName);
+        }
         /* remove v from vdefs list */
         if (l != NULL) {
             l->next = v->next;
@@ -921,6 +981,128 @@ pico_status_t picorsrc_releaseVoiceDefinition(picorsrc_ResourceManager this,
 
 
 
+/* ******* pronunciation cache of voice definitions **************/
+
+pico_status_t picorsrc_createPronCache(picorsrc_ResourceManager this,
+        picoos_char * voiceName, picoos_uint32 maxEntries)
+{
+    picorsrc_VoiceDefinition vdef;
+
+    if (NULL == this) {
+        return PICO_ERR_NULLPTR_ACCESS;
+    }
+    if (!(PICO_OK == findVoiceDefinition(this,voiceName,&vdef)) || (NULL == vdef)) {
+        return picoos_emRaiseException(this->common->em,PICO_EXC_NAME_UNDEFINED,NULL,(picoos_char *)"voice definition %s",voiceName);
+    }
+    if (NULL != vdef->pronCache) {
+        return picoos_emRaiseException(this->common->em,PICO_EXC_NAME_CONFLICT,NULL,(picoos_char *)"pronunciation cache of voice %s",voiceName);
+    }
+    if ((0 == maxEntries) || (PICOPCACHE_MAX_ENTRIES < maxEntries)) {
+        return picoos_emRaiseException(this->common->em,PICO_ERR_INVALID_ARGUMENT,NULL,(picoos_char *)"no more than %i cache entries",PICOPCACHE_MAX_ENTRIES);
+    }
+    vdef->pronCache = picopcache_newPronCache(this->common->mm, maxEntries, vdefPronCacheId(vdef));
+    if (NULL == vdef->pronCache) {
+        return picoos_emRaiseException(this->common->em,PICO_EXC_OUT_OF_MEM,NULL,NULL);
+    }
+    return PICO_OK;
+}
+
+pico_status_t picorsrc_releasePronCache(picorsrc_ResourceManager this,
+        picoos_char * voiceName)
+{
+    picorsrc_VoiceDefinition vdef;
+
+    if (NULL == this) {
+        return PICO_ERR_NULLPTR_ACCESS;
+    }
+    if (!(PICO_OK == findVoiceDefinition(this,voiceName,&vdef)) || (NULL == vdef)) {
+        return picoos_emRaiseException(this->common->em,PICO_EXC_NAME_UNDEFINED,NULL,(picoos_char *)"voice definition %s",voiceName);
+    }
+    if (PICO_OK != disposeVdefPronCache(this,vdef)) {
+        return picoos_emRaiseException(this->common->em,PICO_EXC_RESOURCE_BUSY,NULL,(picoos_char *)"pronunciation cache of voice %s in use",voiceName);
+    }
+    return PICO_OK;
+}
+
+pico_status_t picorsrc_sharePronCache(picorsrc_ResourceManager this,
+        picoos_char * voiceName, picopcache_PronCache pronCache)
+{
+    picorsrc_VoiceDefinition vdef;
+
+    if ((NULL == this) || (NULL == pronCache)) {
+        return PICO_ERR_NULLPTR_ACCESS;
+    }
+    if (!(PICO_OK == findVoiceDefinition(this,voiceName,&vdef)) || (NULL == vdef)) {
+        return picoos_emRaiseException(this->common->em,PICO_EXC_NAME_UNDEFINED,NULL,(picoos_char *)"voice definition %s",voiceName);
+    }
+    if (NULL != vdef->pronCache) {
+        return picoos_emRaiseException(this->common->em,PICO_EXC_NAME_CONFLICT,NULL,(picoos_char *)"pronunciation cache of voice %s",voiceName);
+    }
+    if (picopcache_getVoiceId(pronCache) != vdefPronCacheId(vdef)) {
+        return picoos_emRaiseException(this->common->em,PICO_ERR_INVALID_ARGUMENT,NULL,(picoos_char *)"pronunciation cache for different resources than voice %s",voiceName);
+    }
+    vdef->pronCache = pronCache;
+    vdef->pronCacheShared = TRUE;
+    picopcache_attach(pronCache);
+    return PICO_OK;
+}
+
+pico_status_t picorsrc_getPronCache(picorsrc_ResourceManager this,
+        picoos_char * voiceName, picopcache_PronCache * pronCache)
+{
+    picorsrc_VoiceDefinition vdef;
+
+    if (NULL == this) {
+        return PICO_ERR_NULLPTR_ACCESS;
+    }
+    if (!(PICO_OK == findVoiceDefinition(this,voiceName,&vdef)) || (NULL == vdef)) {
+        return picoos_emRaiseException(this->common->em,PICO_EXC_NAME_UNDEFINED,NULL,(picoos_char *)"voice definition %s",voiceName);
+    }
+    *pronCache = vdef->pronCache;
+    return PICO_OK;
+}
+
+
+/* ******* options of voice definitions **************************/
+
+pico_status_t picorsrc_setVoiceOption(picorsrc_ResourceManager this,
+        picoos_char * voiceName, picoos_uint8 option, picoos_int32 value)
+{
+    picorsrc_VoiceDefinition vdef;
+
+    if (NULL == this) {
+        return PICO_ERR_NULLPTR_ACCESS;
+    }
+    if (!(PICO_OK == findVoiceDefinition(this,voiceName,&vdef)) || (NULL == vdef)) {
+        return picoos_emRaiseException(this->common->em,PICO_EXC_NAME_UNDEFINED,NULL,(picoos_char *)"voice definition %s",voiceName);
+    }
+    if (PICORSRC_NUM_VOPTS <= option) {
+        return picoos_emRaiseException(this->common->em,PICO_ERR_INVALID_ARGUMENT,NULL,(picoos_char *)"voice option %i",option);
+    }
+    vdef->options[option] = value;
+    return PICO_OK;
+}
+
+pico_status_t picorsrc_getVoiceOption(picorsrc_ResourceManager this,
+        const picoos_char * voiceName, picoos_uint8 option,
+        picoos_int32 * value)
+{
+    picorsrc_VoiceDefinition vdef;
+
+    if (NULL == this) {
+        return PICO_ERR_NULLPTR_ACCESS;
+    }
+    if (!(PICO_OK == findVoiceDefinition(this,voiceName,&vdef)) || (NULL == vdef)) {
+        return picoos_emRaiseException(this->common->em,PICO_EXC_NAME_UNDEFINED,NULL,(picoos_char *)"voice definition %s",voiceName);
+    }
+    if (PICORSRC_NUM_VOPTS <= option) {
+        return picoos_emRaiseException(this->common->em,PICO_ERR_INVALID_ARGUMENT,NULL,(picoos_char *)"voice option %i",option);
+    }
+    *value = vdef->options[option];
+    return PICO_OK;
+}
+
+
 /* ******* accessing voices **************************************/
 
 
@@ -999,6 +1181,29 @@ pico_status_t picorsrc_createVoice(picorsrc_ResourceManager this, const picoos_c
         }
     } /* for */
 
+    /* share the voice definition's pronunciation cache, if any */
+    if (NULL != vdef->pronCache) {
+        (*voice)->pronCache = vdef->pronCache;
+        picopcache_attach(vdef->pronCache);
+    }
+
+    for (i = 0; i < PICORSRC_NUM_VOPTS; i++) {
+        (*voice)->options[i] = vdef->options[i];
+    }
+
+    /* the expanded pdfs belong to the resource and are shared by all its
+       voices; they only save time, so the voice is also fine without */
+    if (vdef->options[PICORSRC_VOPT_PDF_EXPAND]) {
+        if (((NULL != (*voice)->kbArray[PICOKNOW_KBID_PDF_LFZ])
+                && (PICO_OK != picokpdf_expandPdfMUL(
+                        (*voice)->kbArray[PICOKNOW_KBID_PDF_LFZ], this->common)))
+                || ((NULL != (*voice)->kbArray[PICOKNOW_KBID_PDF_MGC])
+                && (PICO_OK != picokpdf_expandPdfMUL(
+                        (*voice)->kbArray[PICOKNOW_KBID_PDF_MGC], this->common)))) {
+            PICODBG_WARN(("pdfs of voice %s not expanded", voiceName));
+        }
+    }
+
     return PICO_OK;
 }
 
@@ -1014,6 +1219,10 @@ pico_status_t picorsrc_releaseVoice(picorsrc_ResourceManager this, picorsrc_Voic
     for (i = 0; i < v->numResources; i++) {
         v->resourceArray[i]->lockCount--;
     }
+    if (NULL != v->pronCache) {
+        picopcache_detach(v->pronCache);
+        v->pronCache = NULL;
+    }
     v->next = this->freeVoices;
     this->freeVoices = v;
     this->numVoices--;
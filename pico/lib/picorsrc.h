@@ -36,6 +36,8 @@
 #include "picodefs.h"
 #include "picoos.h"
 #include "picoknow.h"
+#include "picopcache.h"
+#include "picodtcache.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -151,6 +153,52 @@ pico_status_t picorsrc_releaseVoiceDefinition(picorsrc_ResourceManager this,
 pico_status_t picorsrc_addResourceToVoiceDefinition(picorsrc_ResourceManager this,
         picoos_char * voiceName, picoos_char * resourceName);
 
+/* create a pronunciation cache of 'maxEntries' words for a voice
+   definition. It is shared by all voices (engines) created afterwards
+   from that definition and disposed together with the definition. */
+pico_status_t picorsrc_createPronCache(picorsrc_ResourceManager this,
+        picoos_char * voiceName, picoos_uint32 maxEntries);
+
+/* dispose the pronunciation cache of a voice definition (busy while a
+   voice of that definition exists) */
+pico_status_t picorsrc_releasePronCache(picorsrc_ResourceManager this,
+        picoos_char * voiceName);
+
+/* use the pronunciation cache 'pronCache' of a voice definition in
+   another system (resource manager) for voice definition 'voiceName'; the
+   voice definitions must consist of the same resources. The owning voice
+   definition stays busy until this one is released. */
+pico_status_t picorsrc_sharePronCache(picorsrc_ResourceManager this,
+        picoos_char * voiceName, picopcache_PronCache pronCache);
+
+/* get the pronunciation cache of a voice definition (NULL if none) */
+pico_status_t picorsrc_getPronCache(picorsrc_ResourceManager this,
+        picoos_char * voiceName, picopcache_PronCache * pronCache);
+
+/* options of a voice definition; all options are 0 initially. They are
+   copied to the voices (engines) created afterwards from that definition */
+#define PICORSRC_VOPT_CEP_SOLVER   0  /* MGC trajectory solver, PICOCEP_SOLVER_* */
+#define PICORSRC_VOPT_PDF_EXPAND   1  /* expand the LFZ and MGC pdfs, see picokpdf_expandPdfMUL */
+#define PICORSRC_VOPT_SIG_SILENCE  2  /* silent pause frames in SIG, see sigProcess */
+#define PICORSRC_VOPT_SIG_KERNELS  3  /* SIG vector kernels, PICOSIGK_* */
+#define PICORSRC_VOPT_SIG_FFT      4  /* SIG FFT backend, PICOFFTSG_* */
+#define PICORSRC_VOPT_SIG_BATCH    5  /* SIG frames per batch, see sigProcessBatch */
+#define PICORSRC_VOPT_SIG_RATE     6  /* SIG output rate in Hz, 0: 16kHz, see picosigrs.h */
+#define PICORSRC_VOPT_SIG_FORMAT   7  /* SIG output format PICO_DATA_*, 0: PCM, see picosigenc.h */
+#define PICORSRC_VOPT_SIG_PITCH    8  /* SIG pitch scale in percent, 0: 100 */
+#define PICORSRC_VOPT_SIG_FORMANT  9  /* SIG formant shift in Hz, see sigAllocateVoice */
+#define PICORSRC_VOPT_SIG_NOISE   10  /* SIG noise shaping gains, 0: flat, see sigAllocateVoice */
+#define PICORSRC_VOPT_SIG_TEMPO   11  /* SIG tempo in percent, 0: 100, see picosigts.h */
+#define PICORSRC_VOPT_SIG_MATH    12  /* SIG math profile, PICOSIG_MATH_*, see picosig2.h */
+#define PICORSRC_NUM_VOPTS        13
+
+pico_status_t picorsrc_setVoiceOption(picorsrc_ResourceManager this,
+        picoos_char * voiceName, picoos_uint8 option, picoos_int32 value);
+
+pico_status_t picorsrc_getVoiceOption(picorsrc_ResourceManager this,
+        const picoos_char * voiceName, picoos_uint8 option,
+        picoos_int32 * value);
+
 /* **************************************************************************
  *
  *          voices
@@ -172,6 +220,11 @@ typedef struct picorsrc_voice {
 
     picorsrc_Resource resourceArray[PICO_MAX_NUM_RSRC_PER_VOICE];
 
+    picopcache_PronCache pronCache; /* shared with the voice definition, may be NULL */
+
+    picodt_cache_t * dtCache; /* decision tree cache of the engine, may be NULL */
+
+    picoos_int32 options[PICORSRC_NUM_VOPTS]; /* copied from the voice definition */
 
 } picorsrc_voice_t;
 
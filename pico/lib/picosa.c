@@ -30,11 +30,13 @@
 #include "picodbg.h"
 #include "picobase.h"
 #include "picokdt.h"
+#include "picodtcache.h"
 #include "picoklex.h"
 #include "picoktab.h"
 #include "picokfst.h"
 #include "picotrns.h"
 #include "picodata.h"
+#include "picopcache.h"
 #include "picosa.h"
 
 #ifdef __cplusplus
@@ -171,12 +173,27 @@ extern "C" {
   4. accentuation:
   - number of items unchanged, content unchanged, only head info changes
   -> changed in place in headx
+
+  If the voice has a pronunciation cache, WORDGRAPH and WORDINDEX items
+  are looked up in step 2 with key (type, POS, info2, content). A hit
+  yields the final (transduced) phones, which are not transduced again;
+  after a miss the transduced phones are added to the cache when the
+  item is fed.
 */
 
 
+/* pronunciation cache state of a headx item */
+#define SA_PCACHE_NONE  0   /* not cached */
+#define SA_PCACHE_HIT   1   /* content is final, no transduction */
+#define SA_PCACHE_MISS  2   /* add to cache after transduction */
+
 typedef struct {
     picodata_itemhead_t head;
     picoos_uint16 cind;
+    picoos_uint8 pcstate;  /* SA_PCACHE_* */
+    picoos_uint8 pctype;   /* on miss: original item type ... */
+    picoos_uint8 pcklen;   /* ... and content in cbuf1 */
+    picoos_uint16 pckind;
 } picosa_headx_t;
 
 
@@ -213,6 +230,8 @@ typedef struct sa_subobj {
     picotrns_AltDesc altDescBuf;
     /* the number of AltDesc in the buffer */
     picoos_uint16 maxAltDescLen;
+    /* memoized transductions, NULL if not used */
+    picotrns_TransCache transCache;
 
     /* tab knowledge base */
     picoktab_Graphs tabgraphs;
@@ -225,6 +244,8 @@ typedef struct sa_subobj {
 
     /* dtg2p knowledge base */
     picokdt_DtG2P dtg2p;
+    /* graph attributes of the word in g2p */
+    picokdt_g2p_word_t g2pword;
 
     /* lex knowledge base */
     picoklex_Lex lex;
@@ -238,6 +259,10 @@ typedef struct sa_subobj {
     picokfst_FST fst[PICOKNOW_MAX_NUM_WPHO_FSTS];
     picoos_uint8 curFst; /* the fst to be applied next */
 
+    /* pronunciation cache (shared with other engines), may be NULL */
+    picopcache_PronCache pcache;
+    picoos_uint8 pckey[PICOPCACHE_MAX_KEYLEN];
+    picoos_uint8 pckeyLen; /* key of item being transduced, 0 if none */
 
 } sa_subobj_t;
 
@@ -279,6 +304,7 @@ static pico_status_t saInitialize(register picodata_ProcessingUnit this, picoos_
         sa->headx[i].head.info2 = PICODATA_ITEMINFO2_NA;
         sa->headx[i].head.len = 0;
         sa->headx[i].cind = 0;
+        sa->headx[i].pcstate = SA_PCACHE_NONE;
     }
     for (i = 0; i < PICOSA_MAXSIZE_CBUF; i++) {
         sa->cbuf1[i] = 0;
@@ -294,6 +320,9 @@ static pico_status_t saInitialize(register picodata_ProcessingUnit this, picoos_
     sa->phonWritePos = 0;
     sa->nextReadPos = 0;
 
+    sa->pcache = this->voice->pronCache;
+    sa->pckeyLen = 0;
+
     if (resetMode == PICO_RESET_SOFT) {
         /*following initializations needed only at startup or after a full reset*/
         return PICO_OK;
@@ -434,6 +463,7 @@ static pico_status_t saSubObjDeallocate(register picodata_ProcessingUnit this,
     if (NULL != this) {
         sa = (sa_subobj_t *) this->subObj;
         picotrns_deallocate_alt_desc_buf(mm,&sa->altDescBuf);
+        picotrns_disposeTransCache(mm, &sa->transCache);
         picoos_deallocate(mm, (void *) &this->subObj);
     }
     return PICO_OK;
@@ -474,6 +504,11 @@ picodata_ProcessingUnit picosa_newSentAnaUnit(picoos_MemoryManager mm,
         picoos_deallocate(mm, (void *)&this);
         picoos_emRaiseException(common->em,PICO_EXC_OUT_OF_MEM, NULL, NULL);
     }
+#if defined(PICO_USE_TRNS_CACHE)
+    sa->transCache = picotrns_newTransCache(mm);
+#else
+    sa->transCache = NULL;
+#endif
 
 
     saInitialize(this, PICO_RESET_FULL);
@@ -522,6 +557,11 @@ static pico_status_t saDisambPos(register picodata_ProcessingUnit this,
     picoos_uint8 i;
     picoos_uint16 inval;
     picoos_uint16 fallback;
+    picodt_cache_t *dtCache = this->voice->dtCache;
+    picoos_uint8 dtCached;
+    picoos_uint8 key[2 * PICOKDT_NRATT_POSD];
+    picoos_uint16 keylen = 0;
+    picoos_uint32 hash = 0;
 
     /* set initial values */
     okay = TRUE;
@@ -620,8 +660,18 @@ static pico_status_t saDisambPos(register picodata_ProcessingUnit this,
                        valbuf[3], valbuf[4], valbuf[5], valbuf[6]));
 
         /* no continue so far => POS disambiguation needed */
+        dtCached = FALSE;
+        if (picodt_cache_is_enabled(dtCache)) {
+            for (keylen = 0, i = 0; i < PICOKDT_NRATT_POSD; i++) {
+                keylen = picodt_cache_key_put16(key, keylen, valbuf[i]);
+            }
+            hash = picodt_compute_extended_hash(key, keylen);
+            dtCached = picodt_cache_lookup(dtCache, PICOKNOW_KBID_DT_POSD,
+                                           key, keylen, hash, &dtres,
+                                           &prevout);
+        }
         /* construct input vector, which is set in dtposd */
-        if (!picokdt_dtPosDconstructInVec(sa->dtposd, valbuf)) {
+        if (!dtCached && !picokdt_dtPosDconstructInVec(sa->dtposd, valbuf)) {
             /* error constructing invec */
             PICODBG_WARN(("problem with invec"));
             picoos_emRaiseWarning(this->common->em, PICO_WARN_INVECTOR,
@@ -629,7 +679,8 @@ static pico_status_t saDisambPos(register picodata_ProcessingUnit this,
             okay = FALSE;
         }
         /* classify */
-        if (okay && (!picokdt_dtPosDclassify(sa->dtposd, &prevout))) {
+        if (okay && !dtCached &&
+            (!picokdt_dtPosDclassify(sa->dtposd, &prevout))) {
             /* error doing classification */
             PICODBG_WARN(("problem classifying"));
             picoos_emRaiseWarning(this->common->em, PICO_WARN_CLASSIFICATION,
@@ -637,13 +688,18 @@ static pico_status_t saDisambPos(register picodata_ProcessingUnit this,
             okay = FALSE;
         }
         /* decompose */
-        if (okay && (!picokdt_dtPosDdecomposeOutClass(sa->dtposd, &dtres))) {
+        if (okay && !dtCached &&
+            (!picokdt_dtPosDdecomposeOutClass(sa->dtposd, &dtres))) {
             /* error decomposing */
             PICODBG_WARN(("problem decomposing"));
             picoos_emRaiseWarning(this->common->em, PICO_WARN_OUTVECTOR,
                                   NULL, NULL);
             okay = FALSE;
         }
+        if (okay && !dtCached && picodt_cache_is_enabled(dtCache)) {
+            picodt_cache_insert(dtCache, PICOKNOW_KBID_DT_POSD, key, keylen,
+                                hash, &dtres, prevout);
+        }
         if (okay && dtres.set) {
             PICODBG_DEBUG(("in: %d, out: %d", valbuf[3], dtres.class));
         } else {
@@ -847,10 +903,35 @@ static picoos_uint8 saDoG2P(register picodata_ProcessingUnit this,
     picoos_uint8 ordvow;
     picokdt_classify_vecresult_t dtresv;
     picoos_uint16 i;
+    picoos_uint8 wordok;
+    picoos_uint8 graphnr;
+    picoos_uint8 wordnrvow;
+    picoos_uint8 vowelord[PICOKDT_G2P_MAXWORDGRAPHS];
+    picoos_uint8 cstr[PICOBASE_UTF8_MAXLEN + 1];
 
     *plen = 0;
     okay = TRUE;
 
+    /* map the graph attributes of the whole word and determine the
+       vowel-like graphs once; falls back to per-grapheme input vector
+       construction for words that cannot be prepared */
+    wordok = picokdt_dtG2PprepareWord(sa->dtg2p, &(sa->g2pword), graph,
+                                      graphlen, pos);
+    wordnrvow = 0;
+    graphnr = 0;
+    if (wordok) {
+        utfpos = 0;
+        for (graphnr = 0; graphnr < sa->g2pword.nrgraphs; graphnr++) {
+            picobase_get_next_utf8char(graph, graphlen, &utfpos, cstr);
+            if (picoktab_hasVowellikeProp(sa->tabgraphs, cstr,
+                                          PICOBASE_UTF8_MAXLEN)) {
+                vowelord[graphnr] = ++wordnrvow;
+            } else {
+                vowelord[graphnr] = 0;
+            }
+        }
+    }
+
     /* use sa->tmpbuf[PICOSA_MAXITEMSIZE] to temporarly store the
        phones which are predicted in reverse order. Once all are
        available put them in phones in usuable order. phonesind is
@@ -887,15 +968,30 @@ static picoos_uint8 saDoG2P(register picodata_ProcessingUnit this,
         PICODBG_TRACE(("right-to-left g2p, count: %d", nCount));
         okay = TRUE;
 
-        if (!saGetNrVowel(this, sa, graph, graphlen, nCount-1, &nrvow,
-                          &ordvow)) {
+        if (wordok) {
+            /* graphnr is the current grapheme, counting down */
+            graphnr--;
+            ordvow = vowelord[graphnr];
+            nrvow = (ordvow > 0) ? wordnrvow : 0;
+        } else if (!saGetNrVowel(this, sa, graph, graphlen, nCount-1, &nrvow,
+                                 &ordvow)) {
             nrvow = 0;
             ordvow = 0;
         }
 
         /* prepare input vector, set inside tree object invec,
          * g2pBuildVector will call the constructInVec tree method */
-        if (!picokdt_dtG2PconstructInVec(sa->dtg2p,
+        if (wordok) {
+            if (!picokdt_dtG2PconstructWordInVec(sa->dtg2p, &(sa->g2pword),
+                                                 graphnr, nrvow, ordvow,
+                                                 &nPrimary, outNp1Ch,
+                                                 outNp2Ch, outNp3Ch)) {
+                PICODBG_WARN(("problem with invec"));
+                picoos_emRaiseWarning(this->common->em, PICO_WARN_INVECTOR,
+                                      NULL, NULL);
+                okay = FALSE;
+            }
+        } else if (!picokdt_dtG2PconstructInVec(sa->dtg2p,
                                          graph, /*grapheme start*/
                                          graphlen, /*grapheme length*/
                                          nCount-1, /*grapheme current position*/
@@ -1037,6 +1133,66 @@ static pico_status_t saGraphemeToPhoneme(register picodata_ProcessingUnit this,
 }
 
 
+/* ************** pronunciation cache ***************/
+
+/* key of an item as it enters WPHO: type, POS, info2, content; returns
+   the key length, 0 if the item is too long to be cached */
+static picoos_uint8 saPronCacheKey(register sa_subobj_t *sa,
+                                   picoos_uint8 type,
+                                   picodata_itemhead_t *head,
+                                   picoos_uint16 cind,
+                                   picoos_uint8 len,
+                                   picoos_uint8 *key) {
+    if ((len + 3) > PICOPCACHE_MAX_KEYLEN) {
+        return 0;
+    }
+    key[0] = type;
+    key[1] = head->info1;
+    key[2] = head->info2;
+    picoos_mem_copy(&(sa->cbuf1[cind]), &(key[3]), len);
+    return len + 3;
+}
+
+
+/* item in headx[ind]/cbuf1; on hit, out: modified headx and cbuf2 and
+   TRUE is returned */
+static picoos_uint8 saPronCacheLookup(register picodata_ProcessingUnit this,
+                                      register sa_subobj_t *sa,
+                                      picoos_uint16 ind) {
+    picosa_headx_t *hx = &(sa->headx[ind]);
+    picoos_uint8 klen;
+    picoos_uint8 plen;
+
+    hx->pcstate = SA_PCACHE_NONE;
+    if (NULL == sa->pcache) {
+        return FALSE;
+    }
+    klen = saPronCacheKey(sa, hx->head.type, &(hx->head), hx->cind,
+                          hx->head.len, sa->pckey);
+    if (0 == klen) {
+        return FALSE;
+    }
+    if (picopcache_lookup(sa->pcache, sa->pckey, klen,
+                          &(sa->cbuf2[sa->cbuf2Len]),
+                          (sa->cbuf2BufSize - sa->cbuf2Len), &plen)) {
+        /* set item head, info1, info2 unchanged */
+        hx->head.type = PICODATA_ITEM_WORDPHON;
+        hx->head.len = plen;
+        hx->cind = sa->cbuf2Len;
+        sa->cbuf2Len += plen;
+        hx->pcstate = SA_PCACHE_HIT;
+        PICODBG_DEBUG(("%c item from pronunciation cache, plen: %d",
+                       PICODATA_ITEM_WORDPHON, plen));
+        return TRUE;
+    }
+    hx->pcstate = SA_PCACHE_MISS;
+    hx->pctype = hx->head.type;
+    hx->pckind = hx->cind;
+    hx->pcklen = hx->head.len;
+    return FALSE;
+}
+
+
 /* ***********************************************************************/
 /*                          extract phonemes of an item into a phonBuf   */
 /* ***********************************************************************/
@@ -1426,6 +1582,12 @@ static picodata_step_result_t saStep(register picodata_ProcessingUnit this,
                     /* cbuf2 overflow avoided in saGrapheme*, saLexInd*,
                        saCopyItem*, phones skipped if needed */
                     for (i = 0; i < sa->headxLen; i++) {
+                        sa->headx[i].pcstate = SA_PCACHE_NONE;
+                        if (((sa->headx[i].head.type == PICODATA_ITEM_WORDGRAPH) ||
+                             (sa->headx[i].head.type == PICODATA_ITEM_WORDINDEX)) &&
+                            saPronCacheLookup(this, sa, i)) {
+                            continue;
+                        }
                         switch (sa->headx[i].head.type) {
                             case PICODATA_ITEM_WORDGRAPH:
                                 if (PICO_OK != saGraphemeToPhoneme(this, sa,
@@ -1543,13 +1705,25 @@ static picodata_step_result_t saStep(register picodata_ProcessingUnit this,
                         sa->headx[sa->headxBottom].head.len, sa->tmpbuf,
                         PICOSA_MAXITEMSIZE, &blen);
 
-                if (PICODATA_ITEM_WORDPHON == sa->headx[sa->headxBottom].head.type) {
+                sa->pckeyLen = 0;
+                if (SA_PCACHE_HIT == sa->headx[sa->headxBottom].pcstate) {
+                   PICODBG_DEBUG(("PARSE found cached WORDPHON, just copying"));
+                } else if (PICODATA_ITEM_WORDPHON == sa->headx[sa->headxBottom].head.type) {
                    PICODBG_DEBUG(("PARSE found WORDPHON"));
                    rv = saExtractPhonemes(this, sa, 0, &(sa->headx[sa->headxBottom].head),
                            &(sa->cbuf2[sa->headx[sa->headxBottom].cind]));
                    if (PICO_OK == rv) {
                        PICODBG_DEBUG(("PARSE successfully returned from phoneme extraction"));
                        sa->procState = SA_STEPSTATE_PROCESS_TRNS_FST;
+                       if (SA_PCACHE_MISS == sa->headx[sa->headxBottom].pcstate) {
+                           /* cbuf1 is left untouched until the next COLLECT */
+                           sa->pckeyLen = saPronCacheKey(sa,
+                                   sa->headx[sa->headxBottom].pctype,
+                                   &(sa->headx[sa->headxBottom].head),
+                                   sa->headx[sa->headxBottom].pckind,
+                                   sa->headx[sa->headxBottom].pcklen,
+                                   sa->pckey);
+                       }
                    } else {
                        PICODBG_WARN(("PARSE phone extraction returned exception %i, output WORDPHON untransduced",rv));
                    }
@@ -1637,7 +1811,7 @@ static picodata_step_result_t saStep(register picodata_ProcessingUnit this,
                        PICODBG_INFO_MSG(("\n"));
                    }
 #endif
-                   picotrns_transduce(sa->fst[sa->curFst], FALSE,
+                   picotrns_transduceCached(sa->transCache, sa->fst[sa->curFst], FALSE,
                            picotrns_printSolution, sa->phonBuf, sa->phonWritePos, sa->phonBufOut,
                            &sa->phonWritePos,
                            PICOTRNS_MAX_NUM_POSSYM, sa->altDescBuf,
@@ -1693,6 +1867,13 @@ static picodata_step_result_t saStep(register picodata_ProcessingUnit this,
                        return (picodata_step_result_t)picoos_emRaiseException(this->common->em, PICO_WARN_INCOMPLETE, NULL, NULL);
                    }
                    sa->phonesTransduced = 0;
+                   if ((sa->pckeyLen > 0) &&
+                       ((phonWritePos - PICODATA_ITEM_HEADSIZE) <= PICOPCACHE_MAX_PHONLEN)) {
+                       picopcache_insert(sa->pcache, sa->pckey, sa->pckeyLen,
+                               &(sa->tmpbuf[PICODATA_ITEM_HEADSIZE]),
+                               (picoos_uint8)(phonWritePos - PICODATA_ITEM_HEADSIZE));
+                   }
+                   sa->pckeyLen = 0;
 
                } /* if (sa->phonesTransduced) */
 
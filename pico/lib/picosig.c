@@ -31,8 +31,12 @@
 #include "picosig2.h"
 #include "picodata.h"
 #include "picosig.h"
+#include "picosigrs.h"
+#include "picosigenc.h"
+#include "picosigts.h"
 #include "picodbg.h"
 #include "picokpdf.h"
+#include "picoktab.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -43,6 +47,10 @@ extern "C" {
 
 #define PICOSIG_IN_BUFF_SIZE PICODATA_BUFSIZE_SIG   /*input buffer size for SIG */
 #define PICOSIG_OUT_BUFF_SIZE PICODATA_BUFSIZE_SIG  /*output buffer size for SIG*/
+/*most samples of a FRAME item, also when resampled (see sigPutSamples)*/
+#define PICOSIG_ITEM_SAMPLES (PICODSP_DISPLACE / 2)
+/*most samples of a FRAME item of float samples, the bytes of 16 bit ones*/
+#define PICOSIG_ITEM_FLOATS  (PICOSIG_ITEM_SAMPLES / 2)
 
 #define PICOSIG_COLLECT     0
 #define PICOSIG_SCHEDULE    1
@@ -50,6 +58,14 @@ extern "C" {
 #define PICOSIG_PROCESS     3
 #define PICOSIG_FEED        4
 
+/*next slot of the batched frames, see sigProcessBatch*/
+#define PICOSIG_NEXT_SLOT(s, k) ((((k) + 1) < (s)->nSlots) ? ((k) + 1) : 0)
+
+/*frame energy (E_p) below which a pause is considered silent, see sigProcess*/
+#ifndef PICOSIG_SILENCE_E
+#define PICOSIG_SILENCE_E   0.05f
+#endif
+
 /*----------------------------------------------------------
  // Internal function declarations
  //---------------------------------------------------------*/
@@ -85,20 +101,40 @@ typedef struct sig_subobj
     picoos_bool outSwitch;                  /* output destination switch 0:buffer, 1:file*/
     picoos_char sOutSDFileName[255];        /* output file name */
     picoos_SDFile sOutSDFile;               /* output file handle */
-    picoos_single fSampNorm;                /* running normalization factor */
+    pico_param_t fSampNorm;                 /* running normalization factor */
     picoos_uint32 nNumFrame;                /* running count for frame number in output items */
     /*---------------------- other working variables ---------------------------*/
     picoos_uint8 innerProcState; /*where to take up work at next processing step*/
     /*-----------------------Definition of the local storage for this PU--------*/
     sig_innerobj_t sig_inner;
-    picoos_single pMod; /*pitch modifier*/
-    picoos_single vMod; /*Volume modifier*/
-    picoos_single sMod; /*speaker modifier*/
+    pico_param_t pMod; /*pitch modifier*/
+    pico_param_t pScale; /*voice option PICORSRC_VOPT_SIG_PITCH, applied to pMod*/
+    pico_param_t vMod; /*Volume modifier*/
+    pico_param_t sMod; /*speaker modifier*/
     /*knowledge bases */
     picokpdf_PdfMUL pdflfz, pdfmgc;
     picoos_uint32 scmeanpowLFZ, scmeanpowMGC;
     picoos_uint32 scmeanLFZ, scmeanMGC;
     picokpdf_PdfPHS pdfphs;
+    /*pause frames, see sigProcess*/
+    picoos_uint8 silence;   /*voice option PICORSRC_VOPT_SIG_SILENCE*/
+    picoos_int16 pauseId;   /*phone id of the pause, -1 if unknown*/
+    picoos_uint8 pauseFrame;  /*current frame belongs to a pause*/
+    picoos_uint8 silentFrame; /*current frame is synthesized silent*/
+    picoos_uint8 silenceOn;   /*pause has decayed below PICOSIG_SILENCE_E*/
+    picoos_int32 frameC0;     /*energy coefficient of the current frame*/
+    picoos_int32 silenceC0;   /*... of the frame that switched silenceOn*/
+    /*batches of frames, see sigProcessBatch*/
+    picoos_int16 batch;       /*voice option PICORSRC_VOPT_SIG_BATCH, 1: frame by frame*/
+    picoos_int16 batchFrames; /*frames of the current batch to be synthesized*/
+    picoos_uint16 batchBytes; /*input bytes of the items of the current batch*/
+    /*output rate, see picosigrs.h*/
+    picoos_int32 outRate;     /*voice option PICORSRC_VOPT_SIG_RATE, in Hz*/
+    picosigrs_Resampler resampler; /*NULL: output at PICOSIGRS_IN_RATE*/
+    /*output tempo, see picosigts.h*/
+    picosigts_Stretcher stretcher; /*NULL: at the tempo of the synthesis*/
+    /*output format, see picosigenc.h*/
+    picosigenc_encoder_t encoder; /*voice option PICORSRC_VOPT_SIG_FORMAT*/
 
 } sig_subobj_t;
 
@@ -132,6 +168,18 @@ static pico_status_t sigInitialize(register picodata_ProcessingUnit this, picoos
     sig_subObj->retState = PICOSIG_COLLECT;
     sig_subObj->innerProcState = 0;
     sig_subObj->nNumFrame = 0;
+    sig_subObj->pauseFrame = 0;
+    sig_subObj->silentFrame = 0;
+    sig_subObj->silenceOn = 0;
+    sig_subObj->frameC0 = 0;
+    sig_subObj->silenceC0 = 0;
+    if (NULL != sig_subObj->resampler) {
+        picosigrs_reset(sig_subObj->resampler);
+    }
+    if (NULL != sig_subObj->stretcher) {
+        picosigts_reset(sig_subObj->stretcher);
+    }
+    picosigenc_reset(&(sig_subObj->encoder));
 
     /*-----------------------------------------------------------------
      * MANAGE Item I/O control management
@@ -162,7 +210,42 @@ static pico_status_t sigInitialize(register picodata_ProcessingUnit this, picoos
                 - sig_subObj->pdfmgc->meanpow;
         sig_subObj->scmeanLFZ = (1 << (picoos_uint32) sig_subObj->scmeanpowLFZ);
         sig_subObj->scmeanMGC = (1 << (picoos_uint32) sig_subObj->scmeanpowMGC);
+#if defined(PICO_FIXED_POINT_ENABLED)
+        sig_subObj->fSampNorm = PICO_PARAM_RATIO(914 * sig_subObj->pdfmgc->amplif,
+                10000); /*PICOSIG_NORM1 * amplif*/
+#else
         sig_subObj->fSampNorm = PICOSIG_NORM1 * sig_subObj->pdfmgc->amplif;
+#endif
+        sig_subObj->silence
+                = (this->voice->options[PICORSRC_VOPT_SIG_SILENCE] != 0);
+        /*vector kernels: the requested set, else the scalar reference*/
+        sig_subObj->sig_inner.kernels = picosigk_getKernels(
+                this->voice->options[PICORSRC_VOPT_SIG_KERNELS]);
+        if (NULL == sig_subObj->sig_inner.kernels) {
+            PICODBG_WARN(("SIG kernels %i not available, using the scalar kernels",
+                    this->voice->options[PICORSRC_VOPT_SIG_KERNELS]));
+            sig_subObj->sig_inner.kernels = picosigk_getKernels(PICOSIGK_SCALAR);
+        }
+        /*math profile: the requested one, else the default*/
+        sig_subObj->sig_inner.mathMode = PICOSIG_MATH_DEFAULT;
+        if ((PICOSIG_MATH_PRECISE == this->voice->options[PICORSRC_VOPT_SIG_MATH])
+                || (PICOSIG_MATH_FAST == this->voice->options[PICORSRC_VOPT_SIG_MATH])) {
+            sig_subObj->sig_inner.mathMode
+                    = (picoos_int16) this->voice->options[PICORSRC_VOPT_SIG_MATH];
+        }
+        /*FFT backend: the requested one, else the reference*/
+        sig_subObj->sig_inner.fft = picofftsg_getBackend(
+                this->voice->options[PICORSRC_VOPT_SIG_FFT]);
+        if (NULL == sig_subObj->sig_inner.fft) {
+            PICODBG_WARN(("SIG FFT backend %i not available, using the reference",
+                    this->voice->options[PICORSRC_VOPT_SIG_FFT]));
+            sig_subObj->sig_inner.fft = picofftsg_getBackend(PICOFFTSG_OOURA);
+        }
+        sig_subObj->pauseId = -1;
+        if (NULL != this->voice->kbArray[PICOKNOW_KBID_TAB_PHONES]) {
+            sig_subObj->pauseId = picoktab_getPauseID(picoktab_getPhones(
+                    this->voice->kbArray[PICOKNOW_KBID_TAB_PHONES]));
+        }
         /*-----------------------------------------------------------------
          * Initialize memory for DSP
          * ------------------------------------------------------------------*/
@@ -171,9 +254,14 @@ static pico_status_t sigInitialize(register picodata_ProcessingUnit this, picoos
          * Initialize modifiers
          * ------------------------------------------------------------------*/
         /*pitch , volume , speaker modifiers*/
-        sig_subObj->pMod = 1.0f;
-        sig_subObj->vMod = 0.5f;
-        sig_subObj->sMod = 1.0f;
+        sig_subObj->pScale = PICO_PARAM(1.0f);
+        if (0 != this->voice->options[PICORSRC_VOPT_SIG_PITCH]) {
+            sig_subObj->pScale = PICO_PARAM_RATIO(
+                    this->voice->options[PICORSRC_VOPT_SIG_PITCH], 100);
+        }
+        sig_subObj->pMod = sig_subObj->pScale;
+        sig_subObj->vMod = PICO_PARAM(0.5f);
+        sig_subObj->sMod = PICO_PARAM(1.0f);
     } else {
         /*-----------------------------------------------------------------
          * Initialize memory for DSP
@@ -235,6 +323,8 @@ static pico_status_t sigSubObjDeallocate(register picodata_ProcessingUnit this,
         sig_subObj->sOutSDFileName[0] = '\0';
     }
 
+    picosigts_disposeStretcher(mm, &(sig_subObj->stretcher));
+    picosigrs_disposeResampler(mm, &(sig_subObj->resampler));
     sigDeallocate(mm, &(sig_subObj->sig_inner));
 
     picoos_deallocate(this->common->mm, (void *) &this->subObj);
@@ -242,6 +332,100 @@ static pico_status_t sigSubObjDeallocate(register picodata_ProcessingUnit this,
     return PICO_OK;
 }/*sigSubObjDeallocate*/
 
+/**
+ * output rate of a voice
+ * @param    voice : the voice descriptor object
+ * @return  the output rate in Hz
+ * @remarks the voice option, PICOSIGRS_IN_RATE for 0 and for rates the
+ *          resampler does not support
+ * @callgraph
+ * @callergraph
+ */
+static picoos_int32 sigOutputRate(picorsrc_Voice voice)
+{
+    picoos_int32 rate;
+
+    rate = voice->options[PICORSRC_VOPT_SIG_RATE];
+    return picosigrs_isSupportedRate(rate) ? rate : PICOSIGRS_IN_RATE;
+}/*sigOutputRate*/
+
+/**
+ * output format of a voice
+ * @param    voice : the voice descriptor object
+ * @return  the output format, PICO_DATA_*
+ * @remarks the voice option, PICO_DATA_PCM_16BIT for 0 and for formats
+ *          the encoders do not support
+ * @callgraph
+ * @callergraph
+ */
+static picoos_int16 sigOutputFormat(picorsrc_Voice voice)
+{
+    picoos_int32 format;
+
+    format = voice->options[PICORSRC_VOPT_SIG_FORMAT];
+    return picosigenc_isSupportedFormat(format) ? (picoos_int16) format
+            : PICO_DATA_PCM_16BIT;
+}/*sigOutputFormat*/
+
+/**
+ * output bytes of a frame
+ * @param    rate : the output rate
+ * @param    format : the output format
+ * @return  bytes of the FRAME items of one frame at most
+ * @remarks two items of half a hop each at 16kHz (see sigPutFrame); the
+ *          encoded formats take no more bytes than 16 bit PCM, float twice
+ *          as many in items of PICOSIG_ITEM_FLOATS samples
+ * @callgraph
+ * @callergraph
+ */
+static picoos_uint16 sigFrameOutSize(picoos_int32 rate, picoos_int16 format)
+{
+    picoos_int16 n, sampleSize, itemSamples;
+
+    if (PICO_DATA_FLOAT_32BIT == format) {
+        sampleSize = sizeof(picoos_single);
+        itemSamples = PICOSIG_ITEM_FLOATS;
+    } else {
+        sampleSize = sizeof(picoos_int16);
+        itemSamples = PICOSIG_ITEM_SAMPLES;
+    }
+    n = (rate == PICOSIGRS_IN_RATE) ? PICODSP_DISPLACE
+            : picosigrs_getMaxOutput(rate, PICODSP_DISPLACE);
+    return (picoos_uint16) (n * sampleSize + PICODATA_ITEM_HEADSIZE
+            * ((n + itemSamples - 1) / itemSamples));
+}/*sigFrameOutSize*/
+
+/**
+ * number of frames per batch for a voice
+ * @param    voice : the voice descriptor object
+ * @return  frames per batch, 1 : frame by frame
+ * @remarks the voice option, limited to PICOSIG_MAX_BATCH and to the frames
+ *          whose output fits into the output buffer. Never used together
+ *          with silent pause frames, which depend on the output of the frame
+ *          before
+ * @callgraph
+ * @callergraph
+ */
+static picoos_int16 sigBatchFrames(picorsrc_Voice voice)
+{
+    picoos_int32 batch;
+    picoos_uint16 frameOutSize;
+
+    batch = voice->options[PICORSRC_VOPT_SIG_BATCH];
+    if (batch > PICOSIG_MAX_BATCH) {
+        batch = PICOSIG_MAX_BATCH;
+    }
+    frameOutSize = sigFrameOutSize(sigOutputRate(voice),
+            sigOutputFormat(voice));
+    if (batch > PICOSIG_OUT_BUFF_SIZE / frameOutSize) {
+        batch = PICOSIG_OUT_BUFF_SIZE / frameOutSize;
+    }
+    if ((batch < 1) || (voice->options[PICORSRC_VOPT_SIG_SILENCE] != 0)) {
+        batch = 1;
+    }
+    return (picoos_int16) batch;
+}/*sigBatchFrames*/
+
 /**
  * creates a new sig processing unit
  * @param    mm : the engine memory manager
@@ -259,6 +443,7 @@ picodata_ProcessingUnit picosig_newSigUnit(picoos_MemoryManager mm,
         picodata_CharBuffer cbOut, picorsrc_Voice voice)
 {
     sig_subobj_t *sig_subObj;
+    picoos_int16 batch;
 
     picodata_ProcessingUnit this = picodata_newProcessingUnit(mm, common, cbIn,
             cbOut, voice);
@@ -290,6 +475,26 @@ picodata_ProcessingUnit picosig_newSigUnit(picoos_MemoryManager mm,
          picoos_deallocate(mm, (void *) &this);
         return NULL;
     }
+    /*batches of frames (the engine has memory for them, see
+      picosig_getBatchMemSize), else frame by frame*/
+    batch = sigBatchFrames(voice);
+    if ((batch > 1) && (sigAllocateBatch(mm, &(sig_subObj->sig_inner), batch) != PICO_OK)) {
+        PICODBG_WARN(("no memory for batches of %i frames, processing frame by frame", batch));
+        batch = 1;
+    }
+    sig_subObj->batch = batch;
+    sig_subObj->resampler = NULL;
+    sig_subObj->stretcher = NULL;
+    /*formant shift and noise shaping of the voice (the engine has memory
+      for them, see picosig_getVoiceMemSize)*/
+    if (sigAllocateVoice(mm, &(sig_subObj->sig_inner),
+            voice->options[PICORSRC_VOPT_SIG_FORMANT],
+            voice->options[PICORSRC_VOPT_SIG_NOISE]) != PICO_OK) {
+        PICODBG_ERROR(("no memory for the voice tables"));
+        sigDeallocate(mm, &(sig_subObj->sig_inner));
+        picoos_deallocate(mm, (void *) &this);
+        return NULL;
+    }
 
     /*-----------------------------------------------------------------
      * Initialize memory for DSP (this may be re-used elsewhere, e.g.Reset)
@@ -299,10 +504,73 @@ picodata_ProcessingUnit picosig_newSigUnit(picoos_MemoryManager mm,
         sigDeallocate(mm, &(sig_subObj->sig_inner));
         picoos_deallocate(mm, (void *) &this);
         return NULL;
-    }PICODBG_DEBUG(("SIG PU creation succeded!!"));
+    }
+    /*output rate: resampled with the kernels chosen by sigInitialize (the
+      engine has memory for it, see picosig_getRateMemSize)*/
+    sig_subObj->outRate = sigOutputRate(voice);
+    if (sig_subObj->outRate != PICOSIGRS_IN_RATE) {
+        sig_subObj->resampler = picosigrs_newResampler(mm,
+                sig_subObj->outRate, sig_subObj->sig_inner.kernels);
+        if (NULL == sig_subObj->resampler) {
+            PICODBG_ERROR(("no memory for the resampler to %i Hz",
+                    sig_subObj->outRate));
+            sigDeallocate(mm, &(sig_subObj->sig_inner));
+            picoos_deallocate(mm, (void *) &this);
+            return NULL;
+        }
+    }
+    /*output tempo: time scaled before the resampler (the engine has memory
+      for it, see picosig_getTempoMemSize)*/
+    if (picosigts_isSupportedTempo(voice->options[PICORSRC_VOPT_SIG_TEMPO])) {
+        sig_subObj->stretcher = picosigts_newStretcher(mm,
+                voice->options[PICORSRC_VOPT_SIG_TEMPO],
+                sig_subObj->sig_inner.kernels);
+        if (NULL == sig_subObj->stretcher) {
+            PICODBG_ERROR(("no memory for the stretcher to %i%% tempo",
+                    voice->options[PICORSRC_VOPT_SIG_TEMPO]));
+            picosigrs_disposeResampler(mm, &(sig_subObj->resampler));
+            sigDeallocate(mm, &(sig_subObj->sig_inner));
+            picoos_deallocate(mm, (void *) &this);
+            return NULL;
+        }
+    }
+    /*output format: G.711 with the kernels chosen by sigInitialize*/
+    picosigenc_initialize(&(sig_subObj->encoder), sigOutputFormat(voice),
+            sig_subObj->sig_inner.kernels);
+    PICODBG_DEBUG(("SIG PU creation succeded!!"));
     return this;
 }/*picosig_newSigUnit*/
 
+picoos_objsize_t picosig_getBatchMemSize(picoos_int32 batch)
+{
+    if (batch <= 1) {
+        return 0;
+    }
+    if (batch > PICOSIG_MAX_BATCH) {
+        batch = PICOSIG_MAX_BATCH;
+    }
+    /* buffers of each frame, one more phase history entry per additional
+       frame (see sigAllocateBatch), plus allocation overhead */
+    return batch * (PICOSIG_SLOT_SIZE + 64)
+            + (batch - 1) * (sizeof(picoos_int32) * PICODSP_PHASEORDER + 64);
+}
+
+picoos_objsize_t picosig_getRateMemSize(picoos_int32 rate)
+{
+    return picosigrs_getMemSize(rate);
+}
+
+picoos_objsize_t picosig_getTempoMemSize(picoos_int32 tempo)
+{
+    return picosigts_getMemSize(tempo);
+}
+
+picoos_objsize_t picosig_getVoiceMemSize(picoos_int32 formantShift,
+        picoos_int32 noiseGains)
+{
+    return sigVoiceMemSize(formantShift, noiseGains);
+}
+
 /**
  * pdf access for phase
  * @param    this : sig object pointer
@@ -355,6 +623,419 @@ static pico_status_t getPhsFromPdf(register picodata_ProcessingUnit this,
     return PICO_OK;
 }/*getPhsFromPdf*/
 
+/**
+ * pitch of an LFZ value in the math profile of the engine
+ * @param    sig_subObj : sig sub-object
+ * @param    lfz : the LFZ value, log pitch times scmeanLFZ
+ * @param    quick : the default profile approximates exp as
+ *                   picoos_quick_exp
+ * @return  exp(lfz / scmeanLFZ)
+ * @remarks once per frame, so the fast profile takes the exact exp: an
+ *          approximated pitch moves the pulses by a sample now and then
+ * @callgraph
+ * @callergraph
+ */
+static pico_param_t sigPitchExp(sig_subobj_t *sig_subObj, picoos_int32 lfz,
+        picoos_bool quick)
+{
+#if defined(PICO_FIXED_POINT_ENABLED)
+    if (quick && (PICOSIG_MATH_DEFAULT == sig_subObj->sig_inner.mathMode)) {
+        return pico_fix_exp_quick(lfz, sig_subObj->scmeanpowLFZ, PICO_PARAM_SHIFT);
+    }
+    return pico_fix_exp(lfz, sig_subObj->scmeanpowLFZ, PICO_PARAM_SHIFT);
+#else
+    picoos_single x;
+
+    x = (picoos_single) lfz / sig_subObj->scmeanLFZ;
+    if (quick && (PICOSIG_MATH_DEFAULT == sig_subObj->sig_inner.mathMode)) {
+        return (picoos_single) EXP((double) x);
+    }
+    return (picoos_single) exp(x);
+#endif
+}/*sigPitchExp*/
+
+/**
+ * reads a FRAME_PAR item into the history buffers and the values of the
+ * current frame
+ * @param    this : the PU object pointer
+ * @param    inReadPos : read position of the item in the input buffer
+ * @return  void
+ * @remarks the frame whose spectrum is computed next is the oldest one of
+ *          the history (n_available counts the frames read since reset)
+ * @callgraph
+ * @callergraph
+ */
+static void sigGetFrame(register picodata_ProcessingUnit this,
+        picoos_uint16 inReadPos)
+{
+    register sig_subobj_t * sig_subObj;
+    picoos_int16 cepNew, cepOld, phsNew;
+    picoos_int16 offset;
+    picoos_int32 *tmp1, *tmp2;
+    picoos_uint16 tmp_uint16;
+    picopal_int16 tmp_int16;
+    picoos_uint16 i;
+
+    sig_subObj = (sig_subobj_t *) this->subObj;
+
+    /*---------------------------------------------
+     Advancing the history ring buffers: the slot of the
+     oldest entry takes the newest one
+     ---------------------------------------------*/
+    cepNew = sig_subObj->sig_inner.cepHead;
+    phsNew = sig_subObj->sig_inner.phsHead;
+    sig_subObj->sig_inner.cepHead = CEPST_RING(&(sig_subObj->sig_inner), 1);
+    sig_subObj->sig_inner.phsHead = PHASE_RING(&(sig_subObj->sig_inner), 1);
+    cepOld = sig_subObj->sig_inner.cepHead;
+
+    /*---------------------------------------------
+     Frame related initializations
+     ---------------------------------------------*/
+    sig_subObj->sig_inner.prevVoiced_p = sig_subObj->sig_inner.voiced_p;
+    /*---------------------------------------------
+     Get input data from PU buffer in internal buffers
+     -------------------------------------------------*/
+    /*load the phonetic id code*/
+    picoos_mem_copy((void *) &sig_subObj->inBuf[inReadPos
+            + sizeof(picodata_itemhead_t)],                   /*src*/
+    (void *) &tmp_uint16, sizeof(tmp_uint16));                /*dest+size*/
+    sig_subObj->sig_inner.PhIdBuff[cepNew] = (picoos_int16) tmp_uint16; /*store into newest*/
+    tmp_uint16 = (picoos_int16) sig_subObj->sig_inner.PhIdBuff[cepOld]; /*assign oldest*/
+    sig_subObj->sig_inner.phId_p = (picoos_int16) tmp_uint16;           /*assign oldest*/
+
+    /*load pitch values*/
+    for (i = 0; i < sig_subObj->pdflfz->ceporder; i++) {
+        picoos_mem_copy((void *) &(sig_subObj->inBuf[inReadPos
+                + sizeof(picodata_itemhead_t) + sizeof(tmp_uint16) + 3
+                * i * sizeof(tmp_uint16)]),                   /*src*/
+        (void *) &tmp_uint16, sizeof(tmp_uint16));            /*dest+size*/
+
+        sig_subObj->sig_inner.F0Buff[cepNew] = (picoos_int16) tmp_uint16; /*store into newest*/
+        tmp_uint16 = (picoos_int16) sig_subObj->sig_inner.F0Buff[cepOld]; /*assign oldest*/
+
+        /*F0 = exp(lfz / scmeanLFZ), 0 unvoiced*/
+        sig_subObj->sig_inner.F0_p = (tmp_uint16 ? sigPitchExp(sig_subObj,
+                tmp_uint16, FALSE) : PICO_PARAM(0.0f));
+        /* voicing */
+        picoos_mem_copy((void *) &(sig_subObj->inBuf[inReadPos
+                + sizeof(picodata_itemhead_t) + sizeof(tmp_uint16) + 3
+                * i * sizeof(tmp_uint16) + sizeof(tmp_uint16)]),/*src*/
+        (void *) &tmp_uint16, sizeof(tmp_uint16));              /*dest+size*/
+
+        sig_subObj->sig_inner.VoicingBuff[cepNew] = (picoos_int16) tmp_uint16; /*store into newest*/
+        tmp_uint16 = (picoos_int16) sig_subObj->sig_inner.VoicingBuff[cepOld]; /*assign oldest*/
+
+        sig_subObj->sig_inner.voicing = PICO_PARAM_RATIO((tmp_uint16
+                & 0x01) * 8 + (tmp_uint16 & 0x0e) / 2, 15);
+
+        /* unrectified f0 */
+        picoos_mem_copy((void *) &(sig_subObj->inBuf[inReadPos
+                + sizeof(picodata_itemhead_t) + sizeof(tmp_uint16) + 3
+                * i * sizeof(tmp_uint16) + 2 * sizeof(tmp_uint16)]),/*src*/
+        (void *) &tmp_uint16, sizeof(tmp_uint16));                  /*dest+size*/
+
+        sig_subObj->sig_inner.FuVBuff[cepNew] = (picoos_int16) tmp_uint16; /*store into newest*/
+        tmp_uint16 = (picoos_int16) sig_subObj->sig_inner.FuVBuff[cepOld]; /*assign oldest*/
+
+        sig_subObj->sig_inner.Fuv_p = sigPitchExp(sig_subObj, tmp_uint16, TRUE);
+    }
+    /*load cep values*/
+    offset = inReadPos + sizeof(picodata_itemhead_t)
+            + sizeof(tmp_uint16) +
+            3 * sig_subObj->pdflfz->ceporder * sizeof(tmp_int16);
+
+    tmp1 = sig_subObj->sig_inner.CepBuff[cepNew];   /*store into CURR */
+    tmp2 = sig_subObj->sig_inner.CepBuff[cepOld];   /*assign oldest*/
+
+    for (i = 0; i < sig_subObj->pdfmgc->ceporder; i++) {
+        picoos_mem_copy((void *) &(sig_subObj->inBuf[offset + i
+                * sizeof(tmp_int16)]),                /*src*/
+        (void *) &tmp_int16, sizeof(tmp_int16));    /*dest+size*/
+
+        tmp1 [i] = (picoos_int32) tmp_int16;
+        sig_subObj->sig_inner.wcep_pI[i] = (picoos_int32) tmp2[i];
+    }
+
+    if (sig_subObj->inBuf[inReadPos+ 3] > sig_subObj->inBuf[inReadPos+ 2]*2 + 8) {
+        /*load phase values*/
+        /*get the index*/
+        picoos_mem_copy((void *) &(sig_subObj->inBuf[offset + sig_subObj->pdfmgc->ceporder
+                * sizeof(tmp_int16)]),                /*src*/
+        (void *) &tmp_int16, sizeof(tmp_int16));    /*dest+size*/
+
+        /*store into buffers*/
+        tmp1 = sig_subObj->sig_inner.PhsBuff[phsNew];
+        /*retrieve values from pdf*/
+        getPhsFromPdf(this, tmp_int16, tmp1, &(sig_subObj->sig_inner.VoxBndBuff[phsNew]));
+    } else {
+        /* no support for phase found */
+        sig_subObj->sig_inner.VoxBndBuff[phsNew] = 0;
+    }
+
+    /*pitch modifier*/
+    sig_subObj->sig_inner.F0_p = PICO_PARAM_MULT(sig_subObj->sig_inner.F0_p,
+            sig_subObj->pMod);
+    sig_subObj->sig_inner.Fuv_p = PICO_PARAM_MULT(sig_subObj->sig_inner.Fuv_p,
+            sig_subObj->pMod);
+    if (sig_subObj->sig_inner.F0_p > 0) {
+        sig_subObj->sig_inner.voiced_p = 1;
+    } else {
+        sig_subObj->sig_inner.voiced_p = 0;
+    }
+    sig_subObj->sig_inner.n_available++;
+    if (sig_subObj->sig_inner.n_available>3)  sig_subObj->sig_inner.n_available = 3;
+}/*sigGetFrame*/
+
+/**
+ * scale of the overlap-add buffer to the output
+ * @param    sig_subObj : sig sub-object
+ * @return  the normalization times the volume, in 1/2^14 of a 16 bit
+ *          sample
+ * @callgraph
+ * @callergraph
+ */
+static picoos_int32 sigOutputScale(sig_subobj_t *sig_subObj)
+{
+#if defined(PICO_FIXED_POINT_ENABLED)
+    return (picoos_int32) (((int64_t) sig_subObj->fSampNorm * sig_subObj->vMod
+            * (picoos_int32) (PICODSP_END_FLOAT_NORM)) >> (2 * PICO_PARAM_SHIFT));
+#else
+    return (picoos_int32) ((sig_subObj->fSampNorm * sig_subObj->vMod)
+            * PICODSP_END_FLOAT_NORM);
+#endif
+}/*sigOutputScale*/
+
+/**
+ * converts samples of the overlap-add buffer to 16 bit output samples
+ * @param    sig_subObj : sig sub-object
+ * @param    t1 : samples of the overlap-add buffer
+ * @param    s_data : output samples
+ * @param    n : number of samples
+ * @remarks applies the normalization and the volume, clips to
+ *          PICOSIG_MINAMP..PICOSIG_MAXAMP
+ * @callgraph
+ * @callergraph
+ */
+static void sigNormalize(sig_subobj_t *sig_subObj, const picoos_int32 *t1,
+        picoos_int16 *s_data, picoos_int16 n)
+{
+    picoos_int16 n_i;
+    picoos_int32 f_data, mlt;
+
+    /*range control and clipping*/
+    mlt = sigOutputScale(sig_subObj);
+    for (n_i = 0; n_i < n; n_i++) { /*Normalization*/
+        f_data = *t1++ * mlt;
+        if (f_data >= 0)
+            f_data >>= 14;
+        else
+            f_data = -(-f_data >> 14);
+        if (f_data > PICOSIG_MAXAMP)
+            f_data = PICOSIG_MAXAMP;
+        if (f_data < PICOSIG_MINAMP)
+            f_data = PICOSIG_MINAMP;
+        *s_data = (picoos_int16) (f_data);
+        s_data++;
+    }
+}/*sigNormalize*/
+
+#if !defined(PICO_FIXED_POINT_ENABLED)
+/**
+ * writes samples of the overlap-add buffer as FRAME items of float samples
+ * @param    sig_subObj : sig sub-object
+ * @param    outWritePos : write position in output buffer
+ * @param    t1 : samples of the overlap-add buffer
+ * @param    numSamples : number of samples
+ * @return  number of bytes written to the output buffer
+ * @remarks the float counterpart of sigNormalize and sigPutSamples: the
+ *          normalization and the volume in one pass to full scale 1.0,
+ *          not clipped; also to an output file
+ * @callgraph
+ * @callergraph
+ */
+static picoos_uint16 sigPutFloatSamples(sig_subobj_t *sig_subObj,
+        picoos_uint16 outWritePos, const picoos_int32 *t1,
+        picoos_int16 numSamples)
+{
+    picoos_int16 n, n_i, numBytes;
+    picoos_uint16 numoutb;
+    picoos_single mlt;
+    picoos_single f_data[PICOSIG_ITEM_FLOATS];
+
+    /*the scale of sigNormalize, i.e. the level of 16 bit PCM, 2^14 of its
+      shift and 2^15 of full scale*/
+    mlt = (picoos_single) sigOutputScale(sig_subObj)
+            * (1.0f / (16384.0f * 32768.0f));
+    numoutb = 0;
+    while (numSamples > 0) {
+        n = (numSamples > PICOSIG_ITEM_FLOATS) ? PICOSIG_ITEM_FLOATS : numSamples;
+        for (n_i = 0; n_i < n; n_i++) {
+            f_data[n_i] = (picoos_single) t1[n_i] * mlt;
+        }
+        if ((1 == sig_subObj->outSwitch) && (NULL != sig_subObj->sOutSDFile)
+                && !picoos_sdfPutFloatSamples(sig_subObj->sOutSDFile, n, f_data)) {
+            PICODBG_WARN(("error writing to output file %s",
+                    &(sig_subObj->sOutSDFileName[0])));
+        }
+        numBytes = n * sizeof(picoos_single);
+        sig_subObj->outBuf[outWritePos] = (picoos_uint8) PICODATA_ITEM_FRAME;
+        sig_subObj->outBuf[outWritePos + 1] = (picoos_uint8) n;
+        sig_subObj->outBuf[outWritePos + 2]
+                = (picoos_uint8) (sig_subObj->nNumFrame % PICOSIG_ITEM_SAMPLES);
+        sig_subObj->outBuf[outWritePos + 3] = (picoos_uint8) numBytes;
+        /*items are not aligned to floats in the output buffer*/
+        picoos_mem_copy(f_data, &(sig_subObj->outBuf[outWritePos + 4]), numBytes);
+        sig_subObj->nNumFrame = sig_subObj->nNumFrame + 1;
+        numoutb += numBytes + 4;
+        outWritePos += numBytes + 4;
+        t1 += n;
+        numSamples -= n;
+    }
+    return numoutb;
+}/*sigPutFloatSamples*/
+#endif
+
+/**
+ * writes output samples as FRAME items
+ * @param    sig_subObj : sig sub-object
+ * @param    outWritePos : write position in output buffer
+ * @param    samples : the samples
+ * @param    numSamples : number of samples
+ * @return  number of bytes written to the output buffer
+ * @remarks items of at most PICOSIG_ITEM_SAMPLES samples (PICOSIG_ITEM_FLOATS
+ *          for float), i.e. not more bytes than at 16kHz, so that the output
+ *          fits into the buffers of pico_getData at any output rate
+ * @remarks the items carry the samples in the output format; an output
+ *          file (see PICODATA_ITEMINFO1_CMD_SAVE) gets them as 16 bit PCM
+ *          (a float file for PICO_DATA_FLOAT_32BIT) from here as the items
+ *          are not PCM then
+ * @callgraph
+ * @callergraph
+ */
+static picoos_uint16 sigPutSamples(sig_subobj_t *sig_subObj,
+        picoos_uint16 outWritePos, const picoos_int16 *samples,
+        picoos_int16 numSamples)
+{
+    picoos_int16 n, numBytes, itemSamples;
+    picoos_uint16 numoutb;
+
+    itemSamples = (PICO_DATA_FLOAT_32BIT == sig_subObj->encoder.format)
+            ? PICOSIG_ITEM_FLOATS : PICOSIG_ITEM_SAMPLES;
+    if ((PICO_DATA_PCM_16BIT != sig_subObj->encoder.format)
+            && (1 == sig_subObj->outSwitch) && (NULL != sig_subObj->sOutSDFile)
+            && !picoos_sdfPutSamples(sig_subObj->sOutSDFile, numSamples,
+                    (picoos_int16 *) samples)) {
+        PICODBG_WARN(("error writing to output file %s",
+                &(sig_subObj->sOutSDFileName[0])));
+    }
+    numoutb = 0;
+    while (numSamples > 0) {
+        n = (numSamples > itemSamples) ? itemSamples : numSamples;
+        numBytes = picosigenc_encode(&(sig_subObj->encoder), samples, n,
+                &(sig_subObj->outBuf[outWritePos + 4]));
+        /*IMA ADPCM: a single sample is kept for the next item*/
+        if (numBytes > 0) {
+            sig_subObj->outBuf[outWritePos]
+                    = (picoos_uint8) PICODATA_ITEM_FRAME;
+            sig_subObj->outBuf[outWritePos + 1]
+                    = (picoos_uint8) n;
+            sig_subObj->outBuf[outWritePos + 2]
+                    = (picoos_uint8) (sig_subObj->nNumFrame % PICOSIG_ITEM_SAMPLES);
+            sig_subObj->outBuf[outWritePos + 3]
+                    = (picoos_uint8) numBytes;
+            sig_subObj->nNumFrame = sig_subObj->nNumFrame + 1;
+            numoutb += numBytes + 4;
+            outWritePos += numBytes + 4;
+        }
+        samples += n;
+        numSamples -= n;
+    }
+    return numoutb;
+}/*sigPutSamples*/
+
+/**
+ * writes the next hop of samples of the overlap-add buffer as FRAME items
+ * and shifts the buffer
+ * @param    sig_subObj : sig sub-object
+ * @param    outWritePos : write position in output buffer
+ * @return  number of bytes written to the output buffer
+ * @remarks resampled to the output rate if it is not PICOSIGRS_IN_RATE
+ *          and encoded in the output format if it is not 16 bit PCM; float
+ *          at 16kHz straight from the buffer, see sigPutFloatSamples
+ * @callgraph
+ * @callergraph
+ */
+static picoos_uint16 sigPutFrame(sig_subobj_t *sig_subObj,
+        picoos_uint16 outWritePos)
+{
+    picoos_int16 n_frames, n_count, n_in, n_out;
+    picoos_int16 *s_data;
+    picoos_int32 *tmp1, *tmp2;
+    picoos_uint16 cnt, numoutb;
+    picoos_int16 hop_p_half;
+    picoos_int16 s_hop[PICOSIGRS_MAX_IN];
+    picoos_int16 s_out[PICOSIGRS_MAX_OUT];
+
+    n_frames = 2;
+    numoutb = 0;
+    hop_p_half = (sig_subObj->sig_inner.hop_p) / 2;
+#if !defined(PICO_FIXED_POINT_ENABLED)
+    if ((NULL == sig_subObj->resampler) && (NULL == sig_subObj->stretcher)
+            && (PICO_DATA_FLOAT_32BIT == sig_subObj->encoder.format)) {
+        numoutb = sigPutFloatSamples(sig_subObj, outWritePos,
+                sig_subObj->sig_inner.WavBuff_p, sig_subObj->sig_inner.hop_p);
+    } else
+#endif
+    if ((NULL != sig_subObj->resampler) || (NULL != sig_subObj->stretcher)
+            || (PICO_DATA_PCM_16BIT != sig_subObj->encoder.format)) {
+        sigNormalize(sig_subObj, sig_subObj->sig_inner.WavBuff_p, s_hop,
+                sig_subObj->sig_inner.hop_p);
+        n_in = sig_subObj->sig_inner.hop_p;
+        if (NULL != sig_subObj->stretcher) {
+            /*fewer samples, none at all for some frames*/
+            n_in = picosigts_process(sig_subObj->stretcher, s_hop, n_in, s_hop);
+        }
+        if ((NULL != sig_subObj->resampler) && (n_in > 0)) {
+            n_out = picosigrs_process(sig_subObj->resampler, s_hop,
+                    n_in, s_out);
+            numoutb = sigPutSamples(sig_subObj, outWritePos, s_out, n_out);
+        } else {
+            numoutb = sigPutSamples(sig_subObj, outWritePos, s_hop, n_in);
+        }
+    } else {
+        for (n_count = 0; n_count < n_frames; n_count++) {
+            sig_subObj->outBuf[outWritePos]
+                    = (picoos_uint8) PICODATA_ITEM_FRAME;
+            sig_subObj->outBuf[outWritePos + 1]
+                    = (picoos_uint8) (hop_p_half);
+            sig_subObj->outBuf[outWritePos + 2]
+                    = (picoos_uint8) (sig_subObj->nNumFrame % ((hop_p_half)));
+            sig_subObj->outBuf[outWritePos + 3]
+                    = (picoos_uint8) sig_subObj->sig_inner.hop_p;
+            s_data = (picoos_int16 *) &(sig_subObj->outBuf[outWritePos + 4]);
+            sigNormalize(sig_subObj,
+                    &(sig_subObj->sig_inner.WavBuff_p[n_count * (hop_p_half)]),
+                    s_data, hop_p_half);
+            sig_subObj->nNumFrame = sig_subObj->nNumFrame + 1;
+            numoutb += ((picoos_int16) hop_p_half * sizeof(picoos_int16)) + 4;
+            outWritePos += ((picoos_int16) hop_p_half * sizeof(picoos_int16)) + 4;
+        }/*end for n_count*/
+    }
+    /*Swap remaining buffer*/
+    cnt = sig_subObj->sig_inner.m2_p - sig_subObj->sig_inner.hop_p;
+    tmp1 = sig_subObj->sig_inner.WavBuff_p;
+    tmp2
+            = &(sig_subObj->sig_inner.WavBuff_p[sig_subObj->sig_inner.hop_p]);
+    FAST_DEVICE(cnt,*(tmp1++)=*(tmp2++);)
+    ;
+    cnt = sig_subObj->sig_inner.m2_p - (sig_subObj->sig_inner.m2_p
+            - sig_subObj->sig_inner.hop_p);
+    FAST_DEVICE(cnt,*(tmp1++)=0;)
+    ;
+    sig_subObj->nNumFrame += 2;
+    return numoutb;
+}/*sigPutFrame*/
+
 /**
  * processes one item with sig algo
  * @param    this : the PU object pointer
@@ -377,14 +1058,7 @@ static pico_status_t sigProcess(register picodata_ProcessingUnit this,
 {
 
     register sig_subobj_t * sig_subObj;
-    picoos_int16 n_i;
-    picoos_int16 n_frames, n_count;
-    picoos_int16 *s_data, offset;
-    picoos_int32 f_data, mlt, *t1, *tmp1, *tmp2;
-    picoos_uint16 tmp_uint16;
-    picopal_int16 tmp_int16;
-    picoos_uint16 i, cnt;
-    picoos_int16 hop_p_half;
+    picoos_int16 n_count;
 
     sig_subObj = (sig_subobj_t *) this->subObj;
 
@@ -397,137 +1071,43 @@ static pico_status_t sigProcess(register picodata_ProcessingUnit this,
     switch (sig_subObj->innerProcState) {
 
         case 0:
-            /*---------------------------------------------
-             Shifting old values
-             ---------------------------------------------*/
-            for (n_count = 0; n_count < CEPST_BUFF_SIZE-1; n_count++) {
-                sig_subObj->sig_inner.F0Buff[n_count]=sig_subObj->sig_inner.F0Buff[n_count+1];
-                sig_subObj->sig_inner.PhIdBuff[n_count]=sig_subObj->sig_inner.PhIdBuff[n_count+1];
-                sig_subObj->sig_inner.VoicingBuff[n_count]=sig_subObj->sig_inner.VoicingBuff[n_count+1];
-                sig_subObj->sig_inner.FuVBuff[n_count]=sig_subObj->sig_inner.FuVBuff[n_count+1];
-            }
-            for (n_count = 0; n_count < PHASE_BUFF_SIZE-1; n_count++) {
-                sig_subObj->sig_inner.VoxBndBuff[n_count]=sig_subObj->sig_inner.VoxBndBuff[n_count+1];
-            }
-
-            tmp1 = sig_subObj->sig_inner.CepBuff[0];
-            for (n_count = 0; n_count < CEPST_BUFF_SIZE-1; n_count++) {
-                sig_subObj->sig_inner.CepBuff[n_count]=sig_subObj->sig_inner.CepBuff[n_count+1];
-            }
-            sig_subObj->sig_inner.CepBuff[CEPST_BUFF_SIZE-1]=tmp1;
-
-            tmp1 = sig_subObj->sig_inner.PhsBuff[0];
-            for (n_count = 0; n_count < PHASE_BUFF_SIZE-1; n_count++) {
-                sig_subObj->sig_inner.PhsBuff[n_count]=sig_subObj->sig_inner.PhsBuff[n_count+1];
-            }
-            sig_subObj->sig_inner.PhsBuff[PHASE_BUFF_SIZE-1]=tmp1;
-
-            /*---------------------------------------------
-             Frame related initializations
-             ---------------------------------------------*/
-            sig_subObj->sig_inner.prevVoiced_p = sig_subObj->sig_inner.voiced_p;
-            /*---------------------------------------------
-             Get input data from PU buffer in internal buffers
-             -------------------------------------------------*/
-            /*load the phonetic id code*/
-            picoos_mem_copy((void *) &sig_subObj->inBuf[inReadPos
-                    + sizeof(picodata_itemhead_t)],                   /*src*/
-            (void *) &tmp_uint16, sizeof(tmp_uint16));                /*dest+size*/
-            sig_subObj->sig_inner.PhIdBuff[CEPST_BUFF_SIZE-1] = (picoos_int16) tmp_uint16; /*store into newest*/
-            tmp_uint16 = (picoos_int16) sig_subObj->sig_inner.PhIdBuff[0];                 /*assign oldest*/
-            sig_subObj->sig_inner.phId_p = (picoos_int16) tmp_uint16;                      /*assign oldest*/
-
-            /*load pitch values*/
-            for (i = 0; i < sig_subObj->pdflfz->ceporder; i++) {
-                picoos_mem_copy((void *) &(sig_subObj->inBuf[inReadPos
-                        + sizeof(picodata_itemhead_t) + sizeof(tmp_uint16) + 3
-                        * i * sizeof(tmp_uint16)]),                   /*src*/
-                (void *) &tmp_uint16, sizeof(tmp_uint16));            /*dest+size*/
-
-                sig_subObj->sig_inner.F0Buff[CEPST_BUFF_SIZE-1] = (picoos_int16) tmp_uint16;/*store into newest*/
-                tmp_uint16 = (picoos_int16) sig_subObj->sig_inner.F0Buff[0];                /*assign oldest*/
-
-                /*convert in float*/
-                sig_subObj->sig_inner.F0_p
-                        = (tmp_uint16 ? ((picoos_single) tmp_uint16
-                                / sig_subObj->scmeanLFZ) : (picoos_single) 0.0);
-
-                if (sig_subObj->sig_inner.F0_p != (picoos_single) 0.0f) {
-                    sig_subObj->sig_inner.F0_p = (picoos_single) exp(
-                            (picoos_single) sig_subObj->sig_inner.F0_p);
-
-                }
-                /* voicing */
-                picoos_mem_copy((void *) &(sig_subObj->inBuf[inReadPos
-                        + sizeof(picodata_itemhead_t) + sizeof(tmp_uint16) + 3
-                        * i * sizeof(tmp_uint16) + sizeof(tmp_uint16)]),/*src*/
-                (void *) &tmp_uint16, sizeof(tmp_uint16));              /*dest+size*/
-
-                sig_subObj->sig_inner.VoicingBuff[CEPST_BUFF_SIZE-1] = (picoos_int16) tmp_uint16;/*store into newest*/
-                tmp_uint16 = (picoos_int16) sig_subObj->sig_inner.VoicingBuff[0];                /*assign oldest*/
-
-                sig_subObj->sig_inner.voicing = (picoos_single) ((tmp_uint16
-                        & 0x01) * 8 + (tmp_uint16 & 0x0e) / 2)
-                        / (picoos_single) 15.0f;
-
-                /* unrectified f0 */
-                picoos_mem_copy((void *) &(sig_subObj->inBuf[inReadPos
-                        + sizeof(picodata_itemhead_t) + sizeof(tmp_uint16) + 3
-                        * i * sizeof(tmp_uint16) + 2 * sizeof(tmp_uint16)]),/*src*/
-                (void *) &tmp_uint16, sizeof(tmp_uint16));                  /*dest+size*/
-
-                sig_subObj->sig_inner.FuVBuff[CEPST_BUFF_SIZE-1] = (picoos_int16) tmp_uint16;/*store into newest*/
-                tmp_uint16 = (picoos_int16) sig_subObj->sig_inner.FuVBuff[0];                /*assign oldest*/
-
-                sig_subObj->sig_inner.Fuv_p = (picoos_single) tmp_uint16
-                        / sig_subObj->scmeanLFZ;
-                sig_subObj->sig_inner.Fuv_p = (picoos_single) EXP((double)sig_subObj->sig_inner.Fuv_p);
-            }
-            /*load cep values*/
-            offset = inReadPos + sizeof(picodata_itemhead_t)
-                    + sizeof(tmp_uint16) +
-                    3 * sig_subObj->pdflfz->ceporder * sizeof(tmp_int16);
-
-            tmp1 = sig_subObj->sig_inner.CepBuff[CEPST_BUFF_SIZE-1];   /*store into CURR */
-            tmp2 = sig_subObj->sig_inner.CepBuff[0];                   /*assign oldest*/
-
-            for (i = 0; i < sig_subObj->pdfmgc->ceporder; i++) {
-                picoos_mem_copy((void *) &(sig_subObj->inBuf[offset + i
-                        * sizeof(tmp_int16)]),                /*src*/
-                (void *) &tmp_int16, sizeof(tmp_int16));    /*dest+size*/
-
-                tmp1 [i] = (picoos_int32) tmp_int16;
-                sig_subObj->sig_inner.wcep_pI[i] = (picoos_int32) tmp2[i];
+            sigGetFrame(this, inReadPos);
+            if (sig_subObj->sig_inner.n_available < 3) {
+                return PICO_STEP_BUSY;
             }
 
-            if (sig_subObj->inBuf[inReadPos+ 3] > sig_subObj->inBuf[inReadPos+ 2]*2 + 8) {
-                /*load phase values*/
-                /*get the index*/
-                picoos_mem_copy((void *) &(sig_subObj->inBuf[offset + sig_subObj->pdfmgc->ceporder
-                        * sizeof(tmp_int16)]),                /*src*/
-                (void *) &tmp_int16, sizeof(tmp_int16));    /*dest+size*/
-
-                /*store into buffers*/
-                tmp1 = sig_subObj->sig_inner.PhsBuff[PHASE_BUFF_SIZE-1];
-                /*retrieve values from pdf*/
-                getPhsFromPdf(this, tmp_int16, tmp1, &(sig_subObj->sig_inner.VoxBndBuff[PHASE_BUFF_SIZE-1]));
-            } else {
-                /* no support for phase found */
-                sig_subObj->sig_inner.VoxBndBuff[PHASE_BUFF_SIZE-1] = 0;
+            /*pause frames: the sound preceding the pause decays during its
+              first frames, which are synthesized as usual. Once the energy
+              of a pause frame is below PICOSIG_SILENCE_E, the following
+              frames of the pause are synthesized with zero excitation as
+              long as the energy coefficient of none of the buffered frames
+              rises again (towards the next sound). When in addition the
+              pulses placed before have left the window, the spectral
+              processing is skipped and only the overlap-add tail is output
+              (silence_frame)*/
+            sig_subObj->frameC0 = sig_subObj->sig_inner.wcep_pI[0];
+            sig_subObj->pauseFrame = sig_subObj->silence
+                    && (sig_subObj->sig_inner.phId_p == sig_subObj->pauseId)
+                    && (sig_subObj->sig_inner.voiced_p == 0);
+            if (!sig_subObj->pauseFrame) {
+                sig_subObj->silenceOn = 0;
             }
-
-            /*pitch modifier*/
-            sig_subObj->sig_inner.F0_p *= sig_subObj->pMod;
-            sig_subObj->sig_inner.Fuv_p *= sig_subObj->pMod;
-            if (sig_subObj->sig_inner.F0_p > 0.0f) {
-                sig_subObj->sig_inner.voiced_p = 1;
-            } else {
-                sig_subObj->sig_inner.voiced_p = 0;
+            sig_subObj->silentFrame = sig_subObj->pauseFrame
+                    && sig_subObj->silenceOn;
+            for (n_count = 0; (n_count < CEPST_BUFF_SIZE)
+                    && sig_subObj->silentFrame; n_count++) {
+                /*the pulses of this frame are rendered again by the next
+                  ones, so these must be silent too*/
+                sig_subObj->silentFrame
+                        = (sig_subObj->sig_inner.PhIdBuff[n_count] == sig_subObj->pauseId)
+                        && (sig_subObj->sig_inner.F0Buff[n_count] == 0)
+                        && (sig_subObj->sig_inner.CepBuff[n_count][0] <= sig_subObj->silenceC0);
             }
-            sig_subObj->sig_inner.n_available++;
-            if (sig_subObj->sig_inner.n_available>3)  sig_subObj->sig_inner.n_available = 3;
-
-            if (sig_subObj->sig_inner.n_available < 3) {
+            if (sig_subObj->silentFrame
+                    && (sig_subObj->sig_inner.prevVoiced_p == 0)
+                    && !pulses_pending(&(sig_subObj->sig_inner))) {
+                silence_frame(&(sig_subObj->sig_inner));
+                sig_subObj->innerProcState = 9;
                 return PICO_STEP_BUSY;
             }
 
@@ -556,6 +1136,13 @@ static pico_status_t sigProcess(register picodata_ProcessingUnit this,
         case 6:
             /*Generate the impulse response of the vocal tract */
             impulse_response(&(sig_subObj->sig_inner));
+            if (sig_subObj->silentFrame) {
+                sig_subObj->sig_inner.E_p = 0;
+            } else if (sig_subObj->pauseFrame
+                    && (sig_subObj->sig_inner.E_p < PICO_PARAM(PICOSIG_SILENCE_E))) {
+                sig_subObj->silenceOn = 1;
+                sig_subObj->silenceC0 = sig_subObj->frameC0;
+            }
             sig_subObj->innerProcState += 1;
             return PICO_STEP_BUSY;
 
@@ -576,54 +1163,8 @@ static pico_status_t sigProcess(register picodata_ProcessingUnit this,
              Save the output FRAME item (0:hop-1)
              swap remaining buffer
              ---------------------------------------------*/
-            n_frames = 2;
-            *numoutb = 0;
-            hop_p_half = (sig_subObj->sig_inner.hop_p) / 2;
-            for (n_count = 0; n_count < n_frames; n_count++) {
-                sig_subObj->outBuf[outWritePos]
-                        = (picoos_uint8) PICODATA_ITEM_FRAME;
-                sig_subObj->outBuf[outWritePos + 1]
-                        = (picoos_uint8) (hop_p_half);
-                sig_subObj->outBuf[outWritePos + 2]
-                        = (picoos_uint8) (sig_subObj->nNumFrame % ((hop_p_half)));
-                sig_subObj->outBuf[outWritePos + 3]
-                        = (picoos_uint8) sig_subObj->sig_inner.hop_p;
-                s_data = (picoos_int16 *) &(sig_subObj->outBuf[outWritePos + 4]);
-
-                /*range control and clipping*/
-                mlt = (picoos_int32) ((sig_subObj->fSampNorm * sig_subObj->vMod)
-                        * PICODSP_END_FLOAT_NORM);
-                t1 = &(sig_subObj->sig_inner.WavBuff_p[n_count * (hop_p_half)]);
-                for (n_i = 0; n_i < hop_p_half; n_i++) { /*Normalization*/
-                    f_data = *t1++ * mlt;
-                    if (f_data >= 0)
-                        f_data >>= 14;
-                    else
-                        f_data = -(-f_data >> 14);
-                    if (f_data > PICOSIG_MAXAMP)
-                        f_data = PICOSIG_MAXAMP;
-                    if (f_data < PICOSIG_MINAMP)
-                        f_data = PICOSIG_MINAMP;
-                    *s_data = (picoos_int16) (f_data);
-                    s_data++;
-                }
-                sig_subObj->nNumFrame = sig_subObj->nNumFrame + 1;
-                *numoutb += ((picoos_int16) n_i * sizeof(picoos_int16)) + 4;
-                outWritePos += *numoutb;
-            }/*end for n_count*/
-            /*Swap remaining buffer*/
-            cnt = sig_subObj->sig_inner.m2_p - sig_subObj->sig_inner.hop_p;
-            tmp1 = sig_subObj->sig_inner.WavBuff_p;
-            tmp2
-                    = &(sig_subObj->sig_inner.WavBuff_p[sig_subObj->sig_inner.hop_p]);
-            FAST_DEVICE(cnt,*(tmp1++)=*(tmp2++);)
-            ;
-            cnt = sig_subObj->sig_inner.m2_p - (sig_subObj->sig_inner.m2_p
-                    - sig_subObj->sig_inner.hop_p);
-            FAST_DEVICE(cnt,*(tmp1++)=0;)
-            ;
+            *numoutb = sigPutFrame(sig_subObj, outWritePos);
             sig_subObj->innerProcState = 0; /*reset to step 0*/
-            sig_subObj->nNumFrame += 2;
             return PICO_OK;
         default:
             return PICO_ERR_OTHER;
@@ -631,6 +1172,183 @@ static pico_status_t sigProcess(register picodata_ProcessingUnit this,
     return PICO_ERR_OTHER;
 }/*sigProcess*/
 
+/**
+ * processes a batch of FRAME_PAR items with sig algo
+ * @param    this : the PU object pointer
+ * @param    inReadPos : read position in input buffer
+ * @param    numinb : number of bytes of the items processed (including headers)
+ * @param    outWritePos : write position in output buffer
+ * @param    numoutb : number of bytes produced in output buffer
+ * @return  PICO_OK : processing successful and terminated
+ * @return  PICO_STEP_BUSY : processing successful but still things to do
+ * @return  PICO_ERR_OTHER : errors
+ * @remarks the consecutive FRAME_PAR items at inReadPos, at most batch of
+ *          them, are read first. Each step of sigProcess then runs for all
+ *          frames of the batch before the next step, each frame in its own
+ *          slot (sigSelectFrame). What a step takes over from the frame
+ *          before (the phases left by phase_spec2, the bins env_spec does not
+ *          set, the impulse response for save_transition_frame) is taken
+ *          from the slot of that frame, so the output is the same as with
+ *          sigProcess
+ * @callgraph
+ * @callergraph
+ */
+static pico_status_t sigProcessBatch(register picodata_ProcessingUnit this,
+        picoos_uint16 inReadPos, picoos_uint16 *numinb,
+        picoos_uint16 outWritePos, picoos_uint16 *numoutb)
+{
+    register sig_subobj_t * sig_subObj;
+    sig_innerobj_t *sig_inObj;
+    picoos_int16 n_count, slot, prev, head;
+    picoos_uint16 len;
+
+    sig_subObj = (sig_subobj_t *) this->subObj;
+    sig_inObj = &(sig_subObj->sig_inner);
+
+    /*defaults to 0 for input and output bytes*/
+    *numinb = 0;
+    *numoutb = 0;
+
+    /*slot of the first frame of the batch*/
+    slot = PICOSIG_NEXT_SLOT(sig_inObj, sig_inObj->lastSlot);
+    prev = sig_inObj->lastSlot;
+
+    switch (sig_subObj->innerProcState) {
+
+        case 0:
+            /*read the frames*/
+            sig_subObj->batchBytes = 0;
+            for (n_count = 0; (n_count < sig_subObj->batch)
+                    && (inReadPos < sig_subObj->inWritePos)
+                    && (sig_subObj->inBuf[inReadPos] == PICODATA_ITEM_FRAME_PAR);
+                    n_count++) {
+                sigSelectFrame(sig_inObj, slot, 0);
+                /*as in sigProcess, the first frame after a reset is read
+                  until it fills the history*/
+                do {
+                    sigGetFrame(this, inReadPos);
+                } while (sig_inObj->n_available < 3);
+                sigStoreFrame(sig_inObj, slot);
+                slot = PICOSIG_NEXT_SLOT(sig_inObj, slot);
+                len = PICODATA_ITEM_HEADSIZE + sig_subObj->inBuf[inReadPos + 3];
+                inReadPos += len;
+                sig_subObj->batchBytes += len;
+            }
+            sig_subObj->batchFrames = n_count;
+            sig_subObj->innerProcState = 3;
+            return PICO_STEP_BUSY;
+
+        case 3:
+            /*Convert from mfcc to power spectrum*/
+            for (n_count = 0; n_count < sig_subObj->batchFrames; n_count++) {
+                sigSelectFrame(sig_inObj, slot, 1);
+                mel_2_lin_lookup(sig_inObj, sig_subObj->scmeanpowMGC);
+                slot = PICOSIG_NEXT_SLOT(sig_inObj, slot);
+            }
+            sig_subObj->innerProcState += 1;
+            return PICO_STEP_BUSY;
+
+        case 4:
+            /*Reconstruct PHASE SPECTRUM */
+            for (n_count = 0; n_count < sig_subObj->batchFrames; n_count++) {
+                picoos_mem_copy((void *) sig_inObj->frame[prev].ang,
+                        (void *) sig_inObj->frame[slot].ang,
+                        PICODSP_HFFTSIZE_P1 * sizeof(picoos_int32));
+                sig_inObj->frame[slot].outCos[0] = sig_inObj->frame[prev].outCos[0];
+                sig_inObj->frame[slot].outSin[0] = sig_inObj->frame[prev].outSin[0];
+                sigSelectFrame(sig_inObj, slot, 1);
+                head = sig_inObj->phsHead;
+                sig_inObj->phsHead = sig_inObj->frame[slot].phsHead;
+                phase_spec2(sig_inObj);
+                sig_inObj->phsHead = head;
+                prev = slot;
+                slot = PICOSIG_NEXT_SLOT(sig_inObj, slot);
+            }
+            sig_subObj->innerProcState += 1;
+            return PICO_STEP_BUSY;
+
+        case 5:
+            /*Prepare Envelope spectrum for inverse FFT*/
+            for (n_count = 0; n_count < sig_subObj->batchFrames; n_count++) {
+                sig_inObj->frame[slot].Fr[0] = sig_inObj->frame[prev].Fr[0];
+                sig_inObj->frame[slot].Fi[0] = sig_inObj->frame[prev].Fi[0];
+                sigSelectFrame(sig_inObj, slot, 1);
+                env_spec(sig_inObj);
+                prev = slot;
+                slot = PICOSIG_NEXT_SLOT(sig_inObj, slot);
+            }
+            sig_subObj->innerProcState += 1;
+            return PICO_STEP_BUSY;
+
+        case 6:
+            /*Generate the impulse response of the vocal tract */
+            for (n_count = 0; n_count < sig_subObj->batchFrames; n_count++) {
+                sigSelectFrame(sig_inObj, slot, 1);
+                impulse_response(sig_inObj);
+                sigStoreFrame(sig_inObj, slot);
+                slot = PICOSIG_NEXT_SLOT(sig_inObj, slot);
+            }
+            sig_subObj->innerProcState += 1;
+            return PICO_STEP_BUSY;
+
+        case 7:
+            /*Sum up N impulse responses according to excitation, Ovladd,
+              save the output FRAME items*/
+            for (n_count = 0; n_count < sig_subObj->batchFrames; n_count++) {
+                sigSelectFrame(sig_inObj, slot, 1);
+                sig_inObj->imp_p = sig_inObj->frame[prev].imp;
+                save_transition_frame(sig_inObj);
+                sig_inObj->imp_p = sig_inObj->frame[slot].imp;
+                td_psola2(sig_inObj);
+                overlap_add(sig_inObj);
+                *numoutb += sigPutFrame(sig_subObj, outWritePos + *numoutb);
+                prev = slot;
+                slot = PICOSIG_NEXT_SLOT(sig_inObj, slot);
+            }
+            /*the last frame is the current one for the next batch*/
+            sig_inObj->lastSlot = prev;
+            sigSelectFrame(sig_inObj, prev, 1);
+            *numinb = sig_subObj->batchBytes;
+            sig_subObj->innerProcState = 0; /*reset to step 0*/
+            return PICO_OK;
+        default:
+            return PICO_ERR_OTHER;
+    }
+    return PICO_ERR_OTHER;
+}/*sigProcessBatch*/
+
+/**
+ * checks whether the items collected so far are to be processed
+ * @param    sig_subObj : sig sub-object
+ * @return  TRUE : process the pending items
+ * @return  FALSE : collect more items into the batch
+ * @remarks only FRAME_PAR items are batched; any other item, a full batch or
+ *          a full input buffer end the batch
+ * @callgraph
+ * @callergraph
+ */
+static picoos_bool sigBatchReady(sig_subobj_t *sig_subObj)
+{
+    picoos_uint16 pos;
+    picoos_int16 n_count;
+
+    if (sig_subObj->batch <= 1) {
+        return TRUE;
+    }
+    if ((sig_subObj->inBufSize - sig_subObj->inWritePos) < PICODATA_MAX_ITEMSIZE) {
+        return TRUE;
+    }
+    n_count = 0;
+    for (pos = sig_subObj->inReadPos; pos < sig_subObj->inWritePos;
+            pos += PICODATA_ITEM_HEADSIZE + sig_subObj->inBuf[pos + 3]) {
+        if (sig_subObj->inBuf[pos] != PICODATA_ITEM_FRAME_PAR) {
+            return TRUE;
+        }
+        n_count++;
+    }
+    return (n_count >= sig_subObj->batch);
+}/*sigBatchReady*/
+
 /**
  * selects items to be dealth with by this PU
  * @param    item : pointer to current item head
@@ -736,7 +1454,7 @@ static picodata_step_result_t sigStep(register picodata_ProcessingUnit this,
     picoos_uint32 n_samp, n_i;
     picoos_char s_temp_file_name[255];
     picoos_uint32 n_start, n_fram, n_bytes;
-    picoos_single f_value;
+    pico_param_t f_value;
     picoos_uint16 n_value;
     picoos_uint32 n_pos;
     /*wav file play volume control*/
@@ -745,6 +1463,9 @@ static picodata_step_result_t sigStep(register picodata_ProcessingUnit this,
     picoos_uint32 sf;
     picoos_encoding_t enc;
     picoos_uint32 numSamples;
+    /*wav file play at other output rates*/
+    picoos_int16 s_play[PICOSIGRS_MAX_IN];
+    picoos_int16 s_out[PICOSIGRS_MAX_OUT];
 
     numinb = 0;
     numoutb = 0;
@@ -769,6 +1490,12 @@ static picodata_step_result_t sigStep(register picodata_ProcessingUnit this,
 
             case PICOSIG_COLLECT:
                 /* ************** item collector ***********************************/
+                if ((sig_subObj->inReadPos < sig_subObj->inWritePos)
+                        && sigBatchReady(sig_subObj)) {
+                    /*items left over from the last batch*/
+                    sig_subObj->procState = PICOSIG_SCHEDULE;
+                    return PICODATA_PU_BUSY;
+                }
                 /*collecting items from the PU input buffer*/
                 s_result = picodata_cbGetItem(this->cbIn,
                         &(sig_subObj->inBuf[sig_subObj->inWritePos]),
@@ -777,6 +1504,11 @@ static picodata_step_result_t sigStep(register picodata_ProcessingUnit this,
                 PICODBG_DEBUG(("picosig.sigStep -- got item, status: %d",rv));
 
                 if (s_result == PICO_EOF) {
+                    if (sig_subObj->inReadPos < sig_subObj->inWritePos) {
+                        /*no more items for now : process the incomplete batch*/
+                        sig_subObj->procState = PICOSIG_SCHEDULE;
+                        return PICODATA_PU_BUSY;
+                    }
                     /*no items available : remain in state 0 and return idle*/
                     return PICODATA_PU_IDLE;
                 }
@@ -792,7 +1524,9 @@ static picodata_step_result_t sigStep(register picodata_ProcessingUnit this,
                     /*item ok: it could be sent to schedule state*/
                     sig_subObj->inWritePos += blen;
                     sig_subObj->needMoreInput = FALSE;
-                    sig_subObj->procState = PICOSIG_SCHEDULE;
+                    /*batches of frames are scheduled once complete*/
+                    sig_subObj->procState = sigBatchReady(sig_subObj)
+                            ? PICOSIG_SCHEDULE : PICOSIG_COLLECT;
                     /* uncomment next to split into two steps */
                     return PICODATA_PU_ATOMIC;
                 }
@@ -935,7 +1669,9 @@ static picodata_step_result_t sigStep(register picodata_ProcessingUnit this,
                                     picoos_sdfOpenOut(this->common,
                                             &(sig_subObj->sOutSDFile),
                                             s_temp_file_name,
-                                            SAMPLE_FREQ_16KHZ, PICOOS_ENC_LIN);
+                                            sig_subObj->outRate,
+                                            (PICO_DATA_FLOAT_32BIT == sig_subObj->encoder.format)
+                                                    ? PICOOS_ENC_FLOAT : PICOOS_ENC_LIN);
                                     if (sig_subObj->sOutSDFile == NULL) {
                                         PICODBG_DEBUG(("Error on opening file %s\n", sig_subObj->sOutSDFileName));
                                         sig_subObj->outSwitch = 0;
@@ -989,24 +1725,23 @@ static picodata_step_result_t sigStep(register picodata_ProcessingUnit this,
                                     switch (sig_subObj->inBuf[sig_subObj->inReadPos + 2]) {
                                         case 'a' :
                                         /*absloute modifier*/
-                                        f_value = (picoos_single) n_value
-                                                / (picoos_single) 100.0f;
+                                        f_value = PICO_PARAM_RATIO(n_value, 100);
                                             b_res = TRUE;
                                             break;
                                         case 'r' :
                                             /*relative modifier*/
-                                            f_value = (picoos_single) n_value
-                                                    / (picoos_single) 1000.0f;
+                                            f_value = PICO_PARAM_RATIO(n_value, 1000);
                                             b_res = TRUE;
                                             break;
                                         default :
-                                            f_value = (picoos_single)0; /*avoid warnings*/
+                                            f_value = PICO_PARAM(0); /*avoid warnings*/
                                             break;
                                     }
                                     if (b_res) {
                                         switch (sig_subObj->inBuf[sig_subObj->inReadPos + 1]) {
                                             case PICODATA_ITEMINFO1_CMD_PITCH :
-                                            sig_subObj->pMod = f_value;
+                                            sig_subObj->pMod = PICO_PARAM_MULT(
+                                                    f_value, sig_subObj->pScale);
                                                 break;
                                             case PICODATA_ITEMINFO1_CMD_VOLUME :
                                             sig_subObj->vMod = f_value;
@@ -1015,9 +1750,6 @@ static picodata_step_result_t sigStep(register picodata_ProcessingUnit this,
                                             sig_subObj->sMod = f_value;
                                             sig_subObj->sig_inner.sMod_p
                                                     = sig_subObj->sMod;
-                                            /*call the function needed to initialize the speaker factor*/
-                                            mel_2_lin_init(
-                                                    &(sig_subObj->sig_inner));
                                                  break;
                                             default :
                                                 break;
@@ -1097,12 +1829,18 @@ static picodata_step_result_t sigStep(register picodata_ProcessingUnit this,
 
             case PICOSIG_PROCESS:
                 /* *************** item processing ***********************************/
-                numinb = PICODATA_ITEM_HEADSIZE
-                        + sig_subObj->inBuf[sig_subObj->inReadPos + 3];
-
-                /*Process a full item*/
-                s_result = sigProcess(this, sig_subObj->inReadPos, numinb,
-                        sig_subObj->outWritePos, &numoutb);
+                if (sig_subObj->batch > 1) {
+                    /*Process a batch of items*/
+                    s_result = sigProcessBatch(this, sig_subObj->inReadPos,
+                            &numinb, sig_subObj->outWritePos, &numoutb);
+                } else {
+                    numinb = PICODATA_ITEM_HEADSIZE
+                            + sig_subObj->inBuf[sig_subObj->inReadPos + 3];
+
+                    /*Process a full item*/
+                    s_result = sigProcess(this, sig_subObj->inReadPos, numinb,
+                            sig_subObj->outWritePos, &numoutb);
+                }
 
                 if (s_result == PICO_OK) {
                     sig_subObj->inReadPos += numinb;
@@ -1146,7 +1884,7 @@ static picodata_step_result_t sigStep(register picodata_ProcessingUnit this,
                 /*Volume mod and clipping control    */
                 /*     directly into PU output buffer*/
                 /*-----------------------------------*/
-                sf_mlt = (picoos_int32) ((sig_subObj->vMod) * 16.0f);
+                sf_mlt = PICO_PARAM_TO_INT((sig_subObj->vMod) * 16);
                 s_t1 = &(s_data[0]);
 
                 for (n_i = 0; n_i < n_samp; n_i++) {
@@ -1162,6 +1900,24 @@ static picodata_step_result_t sigStep(register picodata_ProcessingUnit this,
                     }
                     s_t1++;
                 }
+                if ((NULL != sig_subObj->resampler)
+                        || (PICO_DATA_PCM_16BIT != sig_subObj->encoder.format)) {
+                    /*resampled to the output rate or encoded: the items are
+                      written from a copy of the samples*/
+                    picoos_mem_copy(s_data, s_play, n_samp * sizeof(picoos_int16));
+                    if (NULL != sig_subObj->resampler) {
+                        n_samp = picosigrs_process(sig_subObj->resampler, s_play,
+                                (picoos_int16) n_samp, s_out);
+                        sig_subObj->outWritePos += sigPutSamples(sig_subObj,
+                                sig_subObj->outWritePos, s_out, (picoos_int16) n_samp);
+                    } else {
+                        sig_subObj->outWritePos += sigPutSamples(sig_subObj,
+                                sig_subObj->outWritePos, s_play, (picoos_int16) n_samp);
+                    }
+                    sig_subObj->procState = PICOSIG_FEED;
+                    sig_subObj->retState = PICOSIG_PLAY;
+                    break;
+                }
                 /*Add header info*/
                 sig_subObj->outBuf[sig_subObj->outWritePos]
                         = (picoos_uint8) PICODATA_ITEM_FRAME;
@@ -1179,6 +1935,13 @@ static picodata_step_result_t sigStep(register picodata_ProcessingUnit this,
 
             case PICOSIG_FEED:
                 /* ************** item output/feeding ***********************************/
+                if (sig_subObj->outReadPos >= sig_subObj->outWritePos) {
+                    /*no items, e.g. a frame kept by the stretcher*/
+                    sig_subObj->outReadPos = 0;
+                    sig_subObj->outWritePos = 0;
+                    sig_subObj->procState = sig_subObj->retState;
+                    return PICODATA_PU_BUSY;
+                }
                 switch (sig_subObj->outSwitch) {
                     case 0:
                         /*feeding items to PU output buffer*/
@@ -1188,9 +1951,11 @@ static picodata_step_result_t sigStep(register picodata_ProcessingUnit this,
                                 &numoutb);
                         break;
                     case 1:
-                        /*feeding items to file*/
-                        if (sig_subObj->outBuf[sig_subObj->outReadPos]
-                                == PICODATA_ITEM_FRAME) {
+                        /*feeding items to file (encoded samples are written
+                          to it by sigPutSamples)*/
+                        if ((sig_subObj->outBuf[sig_subObj->outReadPos]
+                                == PICODATA_ITEM_FRAME)
+                                && (PICO_DATA_PCM_16BIT == sig_subObj->encoder.format)) {
                             if ((sig_subObj->sOutSDFile) != NULL) {
                                 n_start = (picoos_uint32) (sig_subObj->outReadPos)
                                                 + PICODATA_ITEM_HEADSIZE;
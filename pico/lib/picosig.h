@@ -47,6 +47,42 @@ extern "C" {
 }
 #endif
 
+/* The DSP runs frame by frame by default, i.e. each frame is turned into
+   signal as soon as it arrives. With the voice option PICORSRC_VOPT_SIG_BATCH
+   set to K > 1, up to K frames waiting in the input buffer are processed
+   together, stage by stage (see sigProcessBatch); the output is the same.
+   Each frame of the batch needs its own work buffers, i.e. some 6KB of
+   additional engine memory per frame (see picosig_getBatchMemSize). */
+
+/* additional engine memory needed by batches of 'batch' frames */
+picoos_objsize_t picosig_getBatchMemSize(picoos_int32 batch);
+
+/* The output is at 16kHz by default. With the voice option
+   PICORSRC_VOPT_SIG_RATE set to another supported rate, the samples of
+   each frame are resampled before they are put into the FRAME items (see
+   picosigrs.h); the items then carry up to 32 samples at that rate. */
+
+/* additional engine memory needed by the resampler to output rate 'rate' */
+picoos_objsize_t picosig_getRateMemSize(picoos_int32 rate);
+
+/* With the voice option PICORSRC_VOPT_SIG_TEMPO the samples of each frame
+   are time scaled to that tempo before they are resampled (see
+   picosigts.h); frames then give fewer samples, some none at all. */
+
+/* additional engine memory needed by the stretcher to tempo 'tempo' */
+picoos_objsize_t picosig_getTempoMemSize(picoos_int32 tempo);
+
+/* The voice options PICORSRC_VOPT_SIG_PITCH, PICORSRC_VOPT_SIG_FORMANT and
+   PICORSRC_VOPT_SIG_NOISE change the voice of an engine at no cost per
+   frame: the pitch scale multiplies the pitch modifier, the formant shift
+   and the noise shaping are tables built at creation (see
+   sigAllocateVoice). */
+
+/* additional engine memory needed by the tables of formant shift
+   'formantShift' and noise shaping 'noiseGains' */
+picoos_objsize_t picosig_getVoiceMemSize(picoos_int32 formantShift,
+        picoos_int32 noiseGains);
+
 /* *******************************************************************************
  *   items related to the generic interface
  ********************************************************************************/
@@ -36,16 +36,471 @@ extern "C" {
 #if 0
 }
 #endif
+
+#if defined(PICO_FIXED_POINT_ENABLED)
+/*voiced bins: voxbnd_p * voicing; the voicing is rounded to Q12, the
+  margin keeps integral products integral (voxbnd_p <= 128)*/
+#define SIG_VOXBND(s) \
+    (((s)->voxbnd_p * (s)->voicing + (1 << (PICO_PARAM_SHIFT - 6))) >> PICO_PARAM_SHIFT)
+/*envelope amplitude exp(spect * PICODSP_ENVSPEC_K1 / PICODSP_FIX_SCALE1)*/
+#define SIG_ENV_EXP(x) pico_fix_exp_quick((x), PICODSP_ENVSPEC_SHIFT, 0)
+#define SIG_ENV_EXP_PRECISE(x) pico_fix_exp((x), PICODSP_ENVSPEC_SHIFT, 0)
+#else
+#define SIG_VOXBND(s) ((picoos_int32) ((s)->voxbnd_p * (s)->voicing))
+#define SIG_ENV_EXP(x) ((picoos_int32) EXP((double)(x)*mult))
+#define SIG_ENV_EXP_PRECISE(x) ((picoos_int32) exp((double)(x)*mult))
+#endif
+
 /*---------------------------------------------------------------------------
  * INTERNAL FUNCTIONS DECLARATION
  *---------------------------------------------------------------------------*/
-static void gen_hann2(sig_innerobj_t *sig_inObj);
 static void get_simple_excitation(sig_innerobj_t *sig_inObj,
         picoos_int16 *nextPeak);
-static void enh_wind_init(sig_innerobj_t *sig_inObj);
-static void init_rand(sig_innerobj_t *sig_inObj);
-static void get_trig(picoos_int32 ang, picoos_int32 *table, picoos_int32 *cs,
-        picoos_int32 *sn);
+static void get_trig(picoos_int32 ang, const picoos_int32 *table,
+        picoos_int32 *cs, picoos_int32 *sn);
+
+/*---------------------------------------------------------------------------
+ * CONSTANT TABLES
+ *
+ * The tables do not depend on the voice or on the engine state; they are
+ * shared read-only by all engines instead of being filled into engine
+ * memory when an engine is created.
+ *---------------------------------------------------------------------------*/
+/**
+ * Hanning window (td_psola2) and normalized Hanning window
+ * (impulse_response), fixed point
+ */
+static const picoos_int32 sig_hann_window[PICODSP_FFTSIZE] = {
+       0,    0,    1,    2,    3,    5,    7,    9,
+      12,   15,   18,   21,   25,   29,   34,   38,
+      43,   48,   54,   59,   66,   72,   78,   85,
+      92,  100,  107,  115,  123,  131,  140,  148,
+     157,  166,  176,  185,  195,  205,  215,  225,
+     236,  247,  257,  268,  279,  291,  302,  313,
+     325,  337,  349,  360,  372,  385,  397,  409,
+     421,  434,  446,  458,  471,  483,  496,  508,
+     521,  533,  546,  558,  571,  583,  596,  608,
+     620,  632,  645,  657,  669,  680,  692,  704,
+     715,  727,  738,  749,  760,  771,  782,  792,
+     803,  813,  823,  833,  842,  852,  861,  870,
+     879,  888,  896,  904,  912,  920,  927,  934,
+     941,  948,  954,  961,  966,  972,  977,  982,
+     987,  992,  996, 1000, 1003, 1007, 1010, 1012,
+    1015, 1017, 1019, 1020, 1022, 1023, 1023, 1023,
+    1023, 1023, 1023, 1022, 1020, 1019, 1017, 1015,
+    1012, 1010, 1007, 1003, 1000,  996,  992,  987,
+     982,  977,  972,  966,  961,  954,  948,  941,
+     934,  927,  920,  912,  904,  896,  888,  879,
+     870,  861,  852,  842,  833,  823,  813,  803,
+     792,  782,  771,  760,  749,  738,  727,  715,
+     704,  692,  680,  669,  657,  645,  632,  620,
+     608,  596,  583,  571,  558,  546,  533,  521,
+     508,  496,  483,  471,  458,  446,  434,  421,
+     409,  397,  385,  372,  360,  349,  337,  325,
+     313,  302,  291,  279,  268,  257,  247,  236,
+     225,  215,  205,  195,  185,  176,  166,  157,
+     148,  140,  131,  123,  115,  107,  100,   92,
+      85,   78,   72,   66,   59,   54,   48,   43,
+      38,   34,   29,   25,   21,   18,   15,   12,
+       9,    7,    5,    3,    2,    1,    0,    0
+};
+
+static const picoos_int32 sig_norm_window[PICODSP_FFTSIZE] = {
+        80224,    320832,    721696,   1282560,
+      2003104,   2882880,   3921376,   5117984,
+      6471952,   7982496,   9648720,  11469616,
+     13444080,  15570960,  17848976,  20276752,
+     22852864,  25575744,  28443776,  31455264,
+     34608368,  37901248,  41331904,  44898304,
+     48598304,  52429696,  56390192,  60477408,
+     64688944,  69022240,  73474720,  78043744,
+     82726544,  87520352,  92422272,  97429408,
+    102538752, 107747248, 113051776, 118449184,
+    123936224, 129509648, 135166080, 140902192,
+    146714528, 152599584, 158553904, 164573888,
+    170655936, 176796448, 182991712, 189238064,
+    195531744, 201868992, 208246016, 214659040,
+    221104176, 227577616, 234075488, 240593872,
+    247128912, 253676688, 260233280, 266794768,
+    273357248, 279916768, 286469440, 293011360,
+    299538560, 306047168, 312533312, 318993088,
+    325422656, 331818144, 338175744, 344491680,
+    350762176, 356983424, 363151808, 369263520,
+    375315008, 381302592, 387222720, 393071872,
+    398846528, 404543232, 410158560, 415689216,
+    421131840, 426483200, 431740096, 436899392,
+    441958016, 446912928, 451761152, 456499840,
+    461126080, 465637152, 470030400, 474303104,
+    478452800, 482476960, 486373184, 490139200,
+    493772640, 497271424, 500633440, 503856704,
+    506939200, 509879168, 512674880, 515324544,
+    517826688, 520179776, 522382368, 524433184,
+    526331008, 528074688, 529663200, 531095552,
+    532370944, 533488576, 534447808, 535248000,
+    535888768, 536369664, 536690432, 536850880,
+    536850880, 536690432, 536369664, 535888768,
+    535248000, 534447808, 533488576, 532370944,
+    531095552, 529663200, 528074688, 526331008,
+    524433216, 522382368, 520179776, 517826688,
+    515324544, 512674880, 509879168, 506939200,
+    503856704, 500633472, 497271424, 493772672,
+    490139200, 486373184, 482476992, 478452800,
+    474303104, 470030400, 465637184, 461126080,
+    456499840, 451761152, 446912960, 441958016,
+    436899424, 431740096, 426483200, 421131840,
+    415689216, 410158560, 404543232, 398846528,
+    393071872, 387222720, 381302592, 375315008,
+    369263552, 363151808, 356983456, 350762176,
+    344491712, 338175776, 331818144, 325422656,
+    318993088, 312533312, 306047168, 299538560,
+    293011360, 286469472, 279916800, 273357248,
+    266794784, 260233280, 253676688, 247128928,
+    240593888, 234075488, 227577632, 221104192,
+    214659040, 208246032, 201868992, 195531744,
+    189238080, 182991728, 176796448, 170655952,
+    164573888, 158553920, 152599600, 146714528,
+    140902208, 135166096, 129509648, 123936240,
+    118449184, 113051776, 107747248, 102538752,
+     97429424,  92422288,  87520352,  82726544,
+     78043744,  73474736,  69022240,  64688944,
+     60477424,  56390192,  52429696,  48598304,
+     44898304,  41331904,  37901248,  34608384,
+     31455264,  28443792,  25575744,  22852864,
+     20276752,  17848976,  15570960,  13444080,
+     11469616,   9648720,   7982512,   6471952,
+      5117984,   3921376,   2882880,   2003104,
+      1282560,    721696,    320832,     80224
+};
+
+/**
+ * Non uniform enhancement window (bilinearly mapped hannning window)
+ * in order to reduce the formant enhancement in the high spectrum,
+ * also used as cosine table by get_trig
+ * @remarks the output is based on the matlab script below\n
+ matlab script
+ -------------
+ function makeEnhWind(alpha)
+ N=129; % =HFFTSIZEE_P1
+ s=(bilinmap(alpha,N));
+ h=[hann(N)'];
+ x=(1:N)/N;
+ W=interp1(x,h,s); W(1)=0;
+
+ fid=fopen('enhwind.txt','wt');
+ fprintf(fid,'picoos_int16 enh_wind_init(sig_innerobj_t *sig_inObj) {\n');
+ for i=1:N,
+ fprintf(fid,['   sig_inObj->enhwind[' int2str(i) '] = (picoos_single)' num2str(W(i),'%0.7g') ';\n']);
+ end;
+ fprintf(fid,'   return PICO_OK;\n');
+ fprintf(fid,' }; \n');
+ fclose(fid);
+ %figure(1); plot(x*8,W);
+ */
+static const picoos_int32 sig_cos_table[PICODSP_COS_TABLE_LEN + 1] = {
+    4096, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4094, 4094, 4094, 4093, 4093, 4092, 4092, 4091,
+    4091, 4090, 4089, 4089, 4088, 4087, 4086, 4085,
+    4084, 4083, 4082, 4081, 4080, 4079, 4078, 4077,
+    4076, 4075, 4073, 4072, 4071, 4069, 4068, 4066,
+    4065, 4063, 4062, 4060, 4058, 4057, 4055, 4053,
+    4051, 4049, 4047, 4045, 4043, 4041, 4039, 4037,
+    4035, 4033, 4031, 4029, 4026, 4024, 4022, 4019,
+    4017, 4014, 4012, 4009, 4007, 4004, 4001, 3999,
+    3996, 3993, 3990, 3988, 3985, 3982, 3979, 3976,
+    3973, 3970, 3967, 3963, 3960, 3957, 3954, 3950,
+    3947, 3944, 3940, 3937, 3933, 3930, 3926, 3923,
+    3919, 3915, 3912, 3908, 3904, 3900, 3897, 3893,
+    3889, 3885, 3881, 3877, 3873, 3869, 3864, 3860,
+    3856, 3852, 3848, 3843, 3839, 3834, 3830, 3826,
+    3821, 3816, 3812, 3807, 3803, 3798, 3793, 3789,
+    3784, 3779, 3774, 3769, 3764, 3759, 3754, 3749,
+    3744, 3739, 3734, 3729, 3723, 3718, 3713, 3708,
+    3702, 3697, 3691, 3686, 3680, 3675, 3669, 3664,
+    3658, 3652, 3647, 3641, 3635, 3629, 3624, 3618,
+    3612, 3606, 3600, 3594, 3588, 3582, 3576, 3570,
+    3563, 3557, 3551, 3545, 3538, 3532, 3526, 3519,
+    3513, 3506, 3500, 3493, 3487, 3480, 3473, 3467,
+    3460, 3453, 3447, 3440, 3433, 3426, 3419, 3412,
+    3405, 3398, 3391, 3384, 3377, 3370, 3363, 3356,
+    3348, 3341, 3334, 3326, 3319, 3312, 3304, 3297,
+    3289, 3282, 3274, 3267, 3259, 3252, 3244, 3236,
+    3229, 3221, 3213, 3205, 3197, 3190, 3182, 3174,
+    3166, 3158, 3150, 3142, 3134, 3126, 3117, 3109,
+    3101, 3093, 3085, 3076, 3068, 3060, 3051, 3043,
+    3034, 3026, 3018, 3009, 3000, 2992, 2983, 2975,
+    2966, 2957, 2949, 2940, 2931, 2922, 2914, 2905,
+    2896, 2887, 2878, 2869, 2860, 2851, 2842, 2833,
+    2824, 2815, 2806, 2796, 2787, 2778, 2769, 2760,
+    2750, 2741, 2732, 2722, 2713, 2703, 2694, 2684,
+    2675, 2665, 2656, 2646, 2637, 2627, 2617, 2608,
+    2598, 2588, 2578, 2569, 2559, 2549, 2539, 2529,
+    2519, 2510, 2500, 2490, 2480, 2470, 2460, 2450,
+    2439, 2429, 2419, 2409, 2399, 2389, 2379, 2368,
+    2358, 2348, 2337, 2327, 2317, 2306, 2296, 2286,
+    2275, 2265, 2254, 2244, 2233, 2223, 2212, 2201,
+    2191, 2180, 2170, 2159, 2148, 2138, 2127, 2116,
+    2105, 2094, 2084, 2073, 2062, 2051, 2040, 2029,
+    2018, 2007, 1997, 1986, 1975, 1964, 1952, 1941,
+    1930, 1919, 1908, 1897, 1886, 1875, 1864, 1852,
+    1841, 1830, 1819, 1807, 1796, 1785, 1773, 1762,
+    1751, 1739, 1728, 1717, 1705, 1694, 1682, 1671,
+    1659, 1648, 1636, 1625, 1613, 1602, 1590, 1579,
+    1567, 1555, 1544, 1532, 1520, 1509, 1497, 1485,
+    1474, 1462, 1450, 1438, 1427, 1415, 1403, 1391,
+    1379, 1368, 1356, 1344, 1332, 1320, 1308, 1296,
+    1284, 1272, 1260, 1248, 1237, 1225, 1213, 1201,
+    1189, 1176, 1164, 1152, 1140, 1128, 1116, 1104,
+    1092, 1080, 1068, 1056, 1043, 1031, 1019, 1007,
+     995,  983,  970,  958,  946,  934,  921,  909,
+     897,  885,  872,  860,  848,  836,  823,  811,
+     799,  786,  774,  762,  749,  737,  725,  712,
+     700,  687,  675,  663,  650,  638,  625,  613,
+     601,  588,  576,  563,  551,  538,  526,  513,
+     501,  488,  476,  463,  451,  438,  426,  413,
+     401,  388,  376,  363,  351,  338,  326,  313,
+     301,  288,  276,  263,  251,  238,  226,  213,
+     200,  188,  175,  163,  150,  138,  125,  113,
+     100,   87,   75,   62,   50,   37,   25,   12,
+       0
+};
+
+/**
+ * Large arrays of random phase cosines and sines (phase_spec2)
+ */
+static const picoos_int32 sig_rand_cos[PICODSP_N_RAND_TABLE] = {
+    -2198,  3226,  -845, -1227, -3480, -1325,  2089,  -468,
+      711,  3862,  4054,  2825,  2704,  4081, -3912, -3541,
+     2694,   835, -2578,  3205, -4074,  -183, -2665, -1367,
+    -2266,  3327, -2807, -3175, -4095,  -811,  4082, -2175,
+     3112,  1168,  2659,  4048,  4092, -4036,  1081,  -548,
+     4038,  -511,  3317, -3180,   851,  2458, -1453, -3577,
+    -3708, -3890,  4041, -3511, -1454,  2124, -3159,  2384,
+    -3767, -4063,  3952, -3778,  -301, -4026, -3346, -2426,
+      428,  3968,  2900,  -263,  4083,  2024,  4015, -3971,
+     3785, -3726, -3714,   743,   875,   294,  2611,  2491,
+     1558, -2063,  3809, -2987, -1955,  1980,  -539, -3210,
+     2415,  1587, -3943,  3476,  2253, -2584,  3804, -3637,
+     3289, -1621,  1645, -3471,  4071,  -872, -3897, -3590,
+    -2456, -3004,  2589,  3727,  2992,   794,  -918,  1446,
+     3871,  -612, -1566,   672,  3841,  3545, -1982, -3413,
+    -3265, -2876,  4094,  -269, -4077, -3759,  1639,  3041,
+        5,  2778,  1121,  -455,  3532,  -143, -2357,   458,
+    -2887, -1104, -2104,   126, -3655, -3896, -3874,  4058,
+    -1831,  -255, -1211,   445,  2268, -4010,  2621,  -250,
+    -3409, -2710,  4063, -3611, -3707, -1151,  3976, -1736,
+     3669,  -143, -3879, -2242, -4095, -1159, -3155, -2887,
+    -4095, -3861, -2814, -3680, -4094, -3626,  3403, -1735,
+    -2126,  3183, -3499, -1736,  2592,  3875,  3596,  3915,
+     1570, -3319,  4019,  -187,  1370, -4091,  3626, -2943,
+       56,  2824, -3994,    56, -2045, -3653, -2864, -1996,
+    -4061,   159, -3363, -4074,  2043,  4095, -2107, -1973,
+    -3138, -3625,  2413,   -50,  2813,  -535,  1250,  1670,
+     1945,  -476, -3659,  2745,  -674,  2383,  4086, -4030,
+      768,  3925,   785, -3101,  4030,  3422, -3847,  3902,
+     2114, -2359,  3754, -4095,  2301,  3336, -2045,  -413,
+     1848,  4072,  4069,  1386,   966, -1684,  2953, -3961,
+     3512,  1363,  1883,  2657,  2347, -1635,  3170,  2856,
+      494,  1936,   245, -1211, -3600,  1632,  2341,   186,
+     4011, -3490,   269, -2939,  1600, -3405, -3134,  2642,
+     3629,  3413,  2050,   988,  -660,   978,  1965, -1513,
+    -4076, -4094, -1914,  2006, -1550,  3774, -3958, -3576,
+     -382,  1288, -2965,  1608,  3052,  -622, -3836, -3542,
+    -2648, -1178, -1109,  3910,  1199, -3386, -3453, -2877,
+     4095,  3635, -2134,   613, -2700,  4091,  3989, -2385,
+     4094,  1044, -1734,  1646,   575, -2629,  3266,  4091,
+    -2154,   659, -1785,  -717,  4095, -2963, -2645,  2619,
+     1855, -3726, -3437,  2948, -2125, -1700,  4094,  2084,
+     3225,  2220,  3174,   229, -2381, -3677, -3191,  2465,
+     2681,   975,  2004, -3442,  3676, -3753,  3544,   397,
+     2221,  -302,  4083, -2253, -3038,  2884,  4070, -1072,
+     3831,  3663, -1971,  3226,  -145,  1882,   529,  2637,
+    -4077,  2156, -3276, -2687,  3469, -4093,  -850,  -625,
+     1110, -3078, -2719,   742, -3902,  3888, -4081,  1070,
+     -996,  4041, -2712, -3403, -3320,  3036,  1308,  2256,
+    -1486, -2771, -3883, -3867,  3952,  -789,  1458,  3832,
+    -3001,  3463,  3606,  4023,  3387,  2648,  1370, -3134,
+     4051, -1977,  3160,  4042,  3004,  3370,  -419, -1968,
+    -3705, -3331, -3634, -1981,  4069,  -628, -1900,  1039,
+     2554, -2955,  2286, -1624,  2213, -3989,   192,  -723,
+     2878, -2109,  1463,  -741, -1314,  3115, -3160,  1868,
+     -824,   781, -1257,  3331,  1642,  3748,  -487,  3085,
+     4009, -2308,  3850, -4078,  2989,  3023,  1397,   323,
+      268,  2414,  3876, -3584,  1603, -1502,  1318,  1554,
+     2492, -4093,  4008, -2279,  3013,  2557,  4068,  3324,
+     2653,   796, -1312,  1794, -2347, -4008, -3773,  1609,
+    -1564,  3004,  1258,  3729, -4095, -4093,  1393,   297,
+     2294, -2562, -1716,  2224,  2032, -2968,  2338,  1584,
+    -3072, -1596, -2256,  4095, -1949,  1844, -3375, -1481,
+     3228,  1116, -2783,  3915,   283, -3732,  -433, -3667,
+     3883, -3742,  4093,  3874, -3800, -1257, -1606,  3394,
+     2255, -4094, -3767,  1849, -2883,  3469,  2654,  -239,
+     -651, -1140,   328,  3246,  4026, -2041, -1154, -2710,
+    -2860,  2097,  3492,  3123,  3360,  2498,  3976, -2441,
+     3601, -4008,  1243,  4069, -2031,  4077, -3112,  4087,
+     4087, -3907, -1611,  3066,  2657,  3912, -2531,  3500,
+      -76,  3413, -4071,   828,  3664, -1578,  3555,  3868,
+     4054, -4094, -3820, -3658,  2595,  3354,  -701,  -772,
+     2799, -3632,   310,  3984,  3794, -2419, -3916, -3886,
+    -3299,  -437,  2053,  3987,  -789,  4055, -3894,  4003,
+    -3060, -4009, -1655,  3954,  -773,  -422, -3384,   195,
+     -298, -3988,  2014,  3349,  3800,  3858,  2947, -1483,
+     4056,  2612,  2326, -3545, -1001,  3211, -2717, -3159,
+     2869, -1290,  2479,  3420,  1823,  3368, -3819,  3800,
+     3773,  -189, -4067,  2277, -4089, -3634,  3292,  -530,
+    -3109, -3741, -1903,  3879,  4083, -1148,  2630, -4001,
+    -2295,  1090, -3024,  2728, -3305,    60,  4048,   589,
+    -3867, -2944, -2721,  2928,   801, -3644, -1648,   825,
+    -2036, -1192,  2875, -1831, -2865,  -575, -3870, -4080,
+    -2176, -2986,  3978,  2437, -3528, -3300,  3085, -3700,
+     3216,  4094,  3775,  1097,  -152, -3490,  3747, -1490,
+    -3998,  3726, -1600,   -87,  2538, -4095, -3993,  4051,
+    -1242,  2155,  1270,  1919, -3145,  2475,  2226, -3894,
+     -429, -1346,  1297,  1699, -3375,  1577,   -63,  1215,
+    -1492, -1530,  3442, -3867, -3291, -2253,  -150, -2686,
+     3470, -3826, -3148, -3858, -3844, -3652,  4018,   179,
+     3498, -1999,  3531,  4050, -1639, -3661,  4039,  3561,
+      528,  -634,   364,  2735,  3978, -4073, -3722,  2356,
+    -1125,  4054,  3328,  1439,  1746,  2507,  3839,   488,
+     1187,  2038,  -905,  -236,   208,  1660, -4074, -2304,
+    -2457,  3302,  1778,  2019,  4037, -2365,     5,   160
+};
+
+static const picoos_int32 sig_rand_sin[PICODSP_N_RAND_TABLE] = {
+     3455, -2522,  4007,  3907,  2158, -3875, -3522,  4069,
+    -4033,  1362,  -579,  2965, -3076,   344,  1211,  2058,
+     3084,  4009, -3182,  2550,  -418, -4091, -3110,  3860,
+    -3411, -2387, -2982, -2587,    27, -4014,   332,  3470,
+     2662, -3925,  3115,   622,  -165,   697, -3950,  4059,
+      685,  4063, -2402,  2580, -4006, -3276,  3829,  1995,
+    -1738,  1282,   666, -2108, -3828,  3502,  2606, -3330,
+    -1607,  -513, -1075, -1581, -4084,   751,  2361,  3299,
+    -4073,  1012, -2892,  4087,   322,  3560,   808, -1000,
+    -1564,  1701,  1725,  4027, -4001,  4085,  3155, -3251,
+     3787, -3538, -1505,  2802,  3599, -3585, -4060,  2543,
+    -3308,  3775,  1106,  2165,  3420,  3177, -1518,  1883,
+    -2440,  3761,  3751,  2173,  -449, -4001,  1259,  1970,
+    -3277,  2783,  3173, -1698,  2796, -4018,  3991, -3831,
+    -1338, -4049, -3784, -4040,  1422, -2051, -3584,  2263,
+    -2473, -2915,  -117,  4087,   391,  1626,  3753, -2743,
+     4095, -3009, -3939, -4070,  2073, -4093, -3349,  4070,
+    -2904,  3944, -3513,  4094, -1848,  1263, -1327,   553,
+    -3663, -4088,  3912,  4071,  3410,   833,  3147,  4088,
+    -2269, -3070,   518, -1933, -1741, -3930,  -983,  3709,
+     1820,  4093, -1313, -3427,     0, -3928,  2611, -2904,
+       56, -1364,  2976, -1798,  -107,  1903,  2278, -3710,
+    -3500, -2577,  2128,  3709, -3170,  1326,  1960, -1202,
+     3783, -2400,   787,  4091, -3859,   199,  1904,  2848,
+     4095,  2966,  -904,  4095,  3548,  1850,  2927,  3576,
+      527,  4092,  2336,   421,  3549,   -70, -3512,  3589,
+     2631, -1905,  3309, -4095,  2976, -4060,  3900, -3739,
+    -3604, -4068, -1840,  3039, -4040,  3330,   274,   730,
+    -4023,  1170,  4019, -2675,  -729,  2249,  1403, -1243,
+    -3507,  3348, -1638,   -83, -3388,  2375,  3548, -4075,
+     3655,  -437,  -463, -3854,  3980, -3733,  2837, -1040,
+    -2107,  3862,  3637,  3116, -3356, -3755,  2593,  2935,
+     4066, -3609,  4088, -3912,  1952,  3756,  3360, -4091,
+      829, -2143, -4087,  2852,  3770, -2275, -2636, -3129,
+     1898,  2264,  3545, -3975,  4042, -3977, -3593, -3806,
+      401,   -92,  3621, -3570, -3791, -1591,  1052,  1997,
+     4078,  3888, -2825,  3767, -2731,  4048,  1434,  2056,
+     3124, -3922,  3942,  1217, -3916,  2303,  2202,  2914,
+      -47,  1886, -3495, -4049,  3079,  -195,  -927,  3329,
+     -103, -3960, -3710,  3750,  4055, -3140,  2471,  -194,
+     3483,  4042, -3686, -4032,   -37, -2827, -3126, -3148,
+    -3651,  1699,  2227,  2842,  3501,  3726,  -101, -3525,
+    -2524,  3442,  2588, -4089, -3332, -1803, -2567,  3270,
+    -3096, -3978, -3572, -2219, -1805,  1638,  2053, -4076,
+     3440,  4084,  -323, -3420,  2746,  2908,   454, -3953,
+     1449, -1831,  3590, -2522, -4093, -3637,  4061,  3133,
+      389, -3482,  2458, -3090, -2177,  -139,  4006,  4048,
+    -3942, -2702,  3063,  4028, -1245, -1287,   347,  3953,
+    -3972,  -668,  3069, -2279, -2398, -2749, -3881,  3418,
+     3816, -3015, -1302, -1349, -1075,  4019,  3827, -1446,
+    -2787,  2186,  1942,   764,  2303, -3124, -3860,  2636,
+     -600, -3587,  2605,   659,  2783,  2327, -4074,  3591,
+    -1746, -2383,  1888, -3584,  -469, -4047,  3628, -3961,
+    -3201,  2836, -3398,  3760,  3446,  -926, -4091,  4031,
+     2913,  3511, -3825, -4028, -3879,  2659, -2605,  3644,
+     4012,  4020, -3898, -2382, -3752, -1650, -4066, -2694,
+      839, -3383,  1397,  -374, -2799, -2762, -3850,  4083,
+    -4087,  3308,  1322,  1982,  3769,  3810,  3878, -3789,
+     3250,  -154,   842,  3403,  2774,  3199,   475, -2392,
+    -3120,  4017,  3880,  3681, -3356,  -840, -1592,  3766,
+    -3785,  2784,  3897,  1693,   -28,  -146, -3851, -4085,
+     3393,  3195, -3718, -3439,  3555,  2822,  3363, -3776,
+     2708, -3771, -3418,    89,  3602,  3657,  2319, -3818,
+    -2520,  3940,  3004,  1201,  4086,  1685, -4072,  1823,
+     1300,  1663,  -143,  1328,  1528,  3898,  3767,  2291,
+     3419,   120,  1606, -3654,  2908,  2176,  3119,  4088,
+     4043,  3934, -4082,  2497,  -753, -3550,  3929,  3070,
+     2932,  3517, -2140,  2649,  2342,  3245,   982, -3288,
+     1951,  -842,  3902,   466,  3556,   386, -2663,  -262,
+      266, -1228,  3765, -2715,  3117, -1213, -3220, -2127,
+    -4095, -2264,  -448,  4011,  1830,  3779,  2033, -1345,
+     -580,   124, -1477, -1842,  3168,  2350, -4035, -4022,
+     2990,  1893,  4084,  -947, -1542,  3304,  1200,  1292,
+     2426,  4072, -3544,   937, -4019,  -575,  1270,  -864,
+     2721,   836, -3746, -1067,  4022,  4074,  2306, -4091,
+     4085,   931, -3566, -2357,  1526,  1374,  2844, -3818,
+     -565, -3154,  3371,  2051, -3971,  2541,  3065, -2606,
+    -2922, -3887,  3260,  2252,  3667,  2330, -1480,  1528,
+     1594, -4091,  -485, -3404,  -233,  1889,  2437,  4061,
+     2666,  1667, -3626, -1315,  -315,  3931,  3139,   876,
+    -3392, -3948,  2762, -3054,  2419,  4095,  -620, -4053,
+     1347, -2847,  3060,  2863,  4016,  1870, -3749, -4012,
+    -3553, -3918,  2916, -3663, -2926, -4055,  1340,  -356,
+    -3469, -2803,  -972,  3291,  2080, -2425,  2693, -1756,
+    -2535,   -91, -1589, -3946, -4093,  2142,  1654, -3815,
+     -886, -1700,  3770,  4095, -3214,    52,  -910,   603,
+    -3902,  3482,  3893, -3618,  2623,  3263, -3437, -1269,
+     4073,  3868,  3885,  3726,  2319, -3779,  4095, -3911,
+     3814, -3799,  2218, -1349, -2437, -3420, -4093, -3092,
+     2175, -1461,  2619,  1375, -1412,  1854,  -791, -4092,
+     2129, -3574,  2075,  -606,  3753,  1835,   679,  2023,
+     4061, -4046, -4079,  3048,   973,  -427,  1708, -3350,
+    -3938,   580, -2387, -3834,  3705,  3238, -1427, -4066,
+     3920, -3552, -3994,  4089, -4090,  3744,  -415,  3385,
+     3276,  2423, -3689,  3563,   687,  3343, -4095, -4092
+};
+
+/**
+ * MEL-2_LINEAR LOOKUP TABLE (mel_2_lin_lookup), for the warping factor
+ * PICODSP_FREQ_WARP_FACT
+ *  - A : array of indexes for lookup table implementation
+ *  - D : delta array for lookup table implementation,
+ *    fixed point, scaling factor: 0x20, corresponding bit shift: 5
+ */
+static const picoos_int16 sig_mel2lin_A[PICODSP_HFFTSIZE_P1] = {
+      0,   2,   4,   7,   9,  12,  14,  16,
+     19,  21,  23,  26,  28,  30,  32,  34,
+     36,  38,  40,  42,  44,  46,  48,  50,
+     52,  53,  55,  57,  58,  60,  61,  63,
+     64,  65,  67,  68,  69,  71,  72,  73,
+     74,  75,  77,  78,  79,  80,  81,  82,
+     83,  84,  85,  86,  86,  87,  88,  89,
+     90,  91,  91,  92,  93,  94,  94,  95,
+     96,  97,  97,  98,  99,  99, 100, 101,
+    101, 102, 102, 103, 104, 104, 105, 105,
+    106, 106, 107, 107, 108, 108, 109, 109,
+    110, 110, 111, 111, 112, 112, 113, 113,
+    114, 114, 115, 115, 116, 116, 117, 117,
+    117, 118, 118, 119, 119, 120, 120, 120,
+    121, 121, 122, 122, 123, 123, 123, 124,
+    124, 125, 125, 125, 126, 126, 127, 127,
+    128
+};
+
+static const picoos_int32 sig_mel2lin_D[PICODSP_HFFTSIZE_P1] = {
+     0, 14, 29, 11, 24,  5, 18, 30,  9, 19, 29,  5, 12, 19, 24, 27,
+    30, 31, 31, 29, 26, 22, 17, 10,  2, 24, 13,  1, 20,  5, 21,  4,
+    18, 31, 11, 21, 31,  7, 14, 21, 27, 31,  3,  6,  8, 10, 10, 10,
+     9,  8,  6,  3, 31, 27, 23, 18, 12,  6, 31, 24, 16,  8, 31, 22,
+    13,  3, 25, 14,  3, 24, 13,  1, 21,  8, 27, 14,  1, 19,  6, 24,
+     9, 27, 12, 29, 14, 31, 15, 31, 16, 31, 15, 31, 14, 30, 13, 28,
+    11, 26,  9, 23,  6, 20,  2, 16, 31, 13, 27,  8, 22,  4, 17, 31,
+    13, 26,  8, 21,  2, 15, 29, 10, 23,  4, 17, 31, 12, 25,  6, 19,
+     0
+};
 
 /*---------------------------------------------------------------------------
  * PICO SYSTEM FUNCTIONS
@@ -65,84 +520,59 @@ pico_status_t sigAllocate(picoos_MemoryManager mm, sig_innerobj_t *sig_inObj)
     picoos_int32 *d32;
     picoos_int32 nCount;
 
-    sig_inObj->int_vec22 =
+    sig_inObj->cepHead = 0;
+    sig_inObj->phsHead = 0;
+    sig_inObj->phsSize = PHASE_BUFF_SIZE;
+    sig_inObj->nSlots = 1;
+    sig_inObj->lastSlot = 0;
+    for (nCount = 0; nCount < PICOSIG_MAX_BATCH + 1; nCount++) {
+        sig_inObj->frame[nCount].wcep = sig_inObj->frame[nCount].ang =
+        sig_inObj->frame[nCount].outCos = sig_inObj->frame[nCount].outSin =
+        sig_inObj->frame[nCount].Fr = sig_inObj->frame[nCount].Fi =
+        sig_inObj->frame[nCount].imp = NULL;
+    }
+    for (nCount = 0; nCount < PHASE_RING_SIZE; nCount++) {
+        sig_inObj->int_vec42[nCount] = NULL;
+    }
     sig_inObj->int_vec23 =
     sig_inObj->int_vec24 =
-    sig_inObj->int_vec25 =
     sig_inObj->int_vec26 =
     sig_inObj->int_vec28 =
-    sig_inObj->int_vec29 =
     sig_inObj->int_vec30 =
     sig_inObj->int_vec31 =
     sig_inObj->int_vec32 =
     sig_inObj->int_vec33 =
-    sig_inObj->int_vec34 =
-    sig_inObj->int_vec35 =
     sig_inObj->int_vec36 =
     sig_inObj->int_vec37 =
-    sig_inObj->int_vec38 =
-    sig_inObj->int_vec39 =
-    sig_inObj->int_vec40 = NULL;
+    sig_inObj->int_vec39 = NULL;
 
     sig_inObj->sig_vec1 = NULL;
 
-    sig_inObj->idx_vect1 = sig_inObj->idx_vect2 = sig_inObj->idx_vect4 = NULL;
-    sig_inObj->idx_vect5 = sig_inObj->idx_vect6 = sig_inObj->idx_vect7 =
     sig_inObj->idx_vect8 = sig_inObj->idx_vect9 = NULL;
     sig_inObj->ivalue17 = sig_inObj->ivalue18 = 0;
 
+    /*shared constant tables*/
+    sig_inObj->norm_window_p = sig_norm_window;
+    sig_inObj->window_p = sig_hann_window;
+    sig_inObj->cos_table = sig_cos_table;
+    sig_inObj->randCosTbl = sig_rand_cos;
+    sig_inObj->randSinTbl = sig_rand_sin;
+    sig_inObj->A_p = sig_mel2lin_A;
+    sig_inObj->d_p = sig_mel2lin_D;
+    /*no voice tables until sigAllocateVoice*/
+    sig_inObj->voiceTables = NULL;
+    sig_inObj->noiseGain = NULL;
+
     /*-----------------------------------------------------------------
      * Memory allocations
      * NOTE : it would be far better to do a single allocation
      *          and to do pointer initialization inside this routine
      * ------------------------------------------------------------------*/
-    data_i = (picoos_int16 *) picoos_allocate(mm, sizeof(picoos_int16)
-            * PICODSP_FFTSIZE);
-    if (NULL == data_i) {
-        sigDeallocate(mm, sig_inObj);
-        return PICO_ERR_OTHER;
-    }
-    sig_inObj->idx_vect1 = data_i;
 
-    data_i = (picoos_int16 *) picoos_allocate(mm, sizeof(picoos_int16)
-            * PICODSP_HFFTSIZE_P1);
-    if (NULL == data_i) {
-        sigDeallocate(mm, sig_inObj);
-        return PICO_ERR_OTHER;
-    }
-    sig_inObj->idx_vect2 = data_i;
 
-    data_i = (picoos_int16 *) picoos_allocate(mm, sizeof(picoos_int16)
-            * PICODSP_FFTSIZE);
-    if (NULL == data_i) {
-        sigDeallocate(mm, sig_inObj);
-        return PICO_ERR_OTHER;
-    }
-    sig_inObj->idx_vect4 = data_i;
 
-    data_i = (picoos_int16 *) picoos_allocate(mm, sizeof(picoos_int16)
-            * PICODSP_FFTSIZE);
-    if (NULL == data_i) {
-        sigDeallocate(mm, sig_inObj);
-        return PICO_ERR_OTHER;
-    }
-    sig_inObj->idx_vect5 = data_i;
 
-    data_i = (picoos_int16 *) picoos_allocate(mm, sizeof(picoos_int16)
-            * PICODSP_FFTSIZE);
-    if (NULL == data_i) {
-        sigDeallocate(mm, sig_inObj);
-        return PICO_ERR_OTHER;
-    }
-    sig_inObj->idx_vect6 = data_i;
 
-    data_i = (picoos_int16 *) picoos_allocate(mm, sizeof(picoos_int16)
-            * PICODSP_HFFTSIZE_P1);
-    if (NULL == data_i) {
-        sigDeallocate(mm, sig_inObj);
-        return PICO_ERR_OTHER;
-    }
-    sig_inObj->idx_vect7 = data_i;
 
     data_i = (picoos_int16 *) picoos_allocate(mm, sizeof(picoos_int16)
             * PICODSP_MAX_EX);
@@ -160,13 +590,6 @@ pico_status_t sigAllocate(picoos_MemoryManager mm, sig_innerobj_t *sig_inObj)
     }
     sig_inObj->idx_vect9 = data_i;
 
-    d32 = (picoos_int32 *) picoos_allocate(mm, sizeof(picoos_int32)
-            * PICODSP_FFTSIZE);
-    if (NULL == d32) {
-        sigDeallocate(mm, sig_inObj);
-        return PICO_ERR_OTHER;
-    }
-    sig_inObj->int_vec22 = d32;
     d32 = (picoos_int32 *) picoos_allocate(mm, sizeof(picoos_int32)
             * PICODSP_FFTSIZE);
     if (NULL == d32) {
@@ -181,13 +604,6 @@ pico_status_t sigAllocate(picoos_MemoryManager mm, sig_innerobj_t *sig_inObj)
         return PICO_ERR_OTHER;
     }
     sig_inObj->int_vec24 = d32;
-    d32 = (picoos_int32 *) picoos_allocate(mm, sizeof(picoos_int32)
-            * PICODSP_FFTSIZE);
-    if (NULL == d32) {
-        sigDeallocate(mm, sig_inObj);
-        return PICO_ERR_OTHER;
-    }
-    sig_inObj->int_vec25 = d32;
     d32 = (picoos_int32 *) picoos_allocate(mm, sizeof(picoos_int32)
             * PICODSP_FFTSIZE * 2);
     if (NULL == d32) {
@@ -209,20 +625,6 @@ pico_status_t sigAllocate(picoos_MemoryManager mm, sig_innerobj_t *sig_inObj)
         sigDeallocate(mm, sig_inObj);
         return PICO_ERR_OTHER;
     }
-    sig_inObj->int_vec29 = d32;
-    d32 = (picoos_int32 *) picoos_allocate(mm, sizeof(picoos_int32)
-            * PICODSP_FFTSIZE);
-    if (NULL == d32) {
-        sigDeallocate(mm, sig_inObj);
-        return PICO_ERR_OTHER;
-    }
-    sig_inObj->int_vec38 = d32;
-    d32 = (picoos_int32 *) picoos_allocate(mm, sizeof(picoos_int32)
-            * PICODSP_FFTSIZE);
-    if (NULL == d32) {
-        sigDeallocate(mm, sig_inObj);
-        return PICO_ERR_OTHER;
-    }
     sig_inObj->int_vec30 = d32;
     d32 = (picoos_int32 *) picoos_allocate(mm, sizeof(picoos_int32)
             * PICODSP_FFTSIZE);
@@ -247,28 +649,14 @@ pico_status_t sigAllocate(picoos_MemoryManager mm, sig_innerobj_t *sig_inObj)
     }
     sig_inObj->int_vec33 = d32;
     d32 = (picoos_int32 *) picoos_allocate(mm, sizeof(picoos_int32)
-            * PICODSP_N_RAND_TABLE);
-    if (NULL == d32) {
-        sigDeallocate(mm, sig_inObj);
-        return PICO_ERR_OTHER;
-    }
-    sig_inObj->int_vec34 = d32;
-    d32 = (picoos_int32 *) picoos_allocate(mm, sizeof(picoos_int32)
-            * PICODSP_N_RAND_TABLE);
-    if (NULL == d32) {
-        sigDeallocate(mm, sig_inObj);
-        return PICO_ERR_OTHER;
-    }
-    sig_inObj->int_vec35 = d32;
-    d32 = (picoos_int32 *) picoos_allocate(mm, sizeof(picoos_int32)
-            * PICODSP_N_RAND_TABLE);
+            * PICODSP_HFFTSIZE_P1);
     if (NULL == d32) {
         sigDeallocate(mm, sig_inObj);
         return PICO_ERR_OTHER;
     }
     sig_inObj->int_vec36 = d32;
     d32 = (picoos_int32 *) picoos_allocate(mm, sizeof(picoos_int32)
-            * PICODSP_N_RAND_TABLE);
+            * PICODSP_HFFTSIZE_P1);
     if (NULL == d32) {
         sigDeallocate(mm, sig_inObj);
         return PICO_ERR_OTHER;
@@ -282,13 +670,6 @@ pico_status_t sigAllocate(picoos_MemoryManager mm, sig_innerobj_t *sig_inObj)
         return PICO_ERR_OTHER;
     }
     sig_inObj->int_vec39 = d32;
-    d32 = (picoos_int32 *) picoos_allocate(mm, sizeof(picoos_int32) * (1
-            + PICODSP_COS_TABLE_LEN));
-    if (NULL == d32) {
-        sigDeallocate(mm, sig_inObj);
-        return PICO_ERR_OTHER;
-    }
-    sig_inObj->int_vec40 = d32;
 
     for (nCount = 0; nCount < CEPST_BUFF_SIZE; nCount++) {
         d32 = (picoos_int32 *) picoos_allocate(mm, sizeof(picoos_int32) * (PICODSP_CEPORDER));
@@ -316,9 +697,340 @@ pico_status_t sigAllocate(picoos_MemoryManager mm, sig_innerobj_t *sig_inObj)
     }
     sig_inObj->sig_vec1 = d32;
 
+    /*slot 0 of the batched frames uses the buffers above*/
+    sig_inObj->frame[0].wcep = sig_inObj->wcep_pI;
+    sig_inObj->frame[0].ang = sig_inObj->ang_p;
+    sig_inObj->frame[0].outCos = sig_inObj->outCosTbl;
+    sig_inObj->frame[0].outSin = sig_inObj->outSinTbl;
+    sig_inObj->frame[0].Fr = sig_inObj->F2r_p;
+    sig_inObj->frame[0].Fi = sig_inObj->F2i_p;
+    sig_inObj->frame[0].imp = sig_inObj->imp_p;
+
     return PICO_OK;
 }/*sigAllocate*/
 
+/**
+ * allocation of the DSP memory for batches of frames
+ * @param   mm : memory manager
+ * @param   sig_inObj : sig PU internal object of the sub-object
+ * @param   frames : maximum number of frames of a batch (2..PICOSIG_MAX_BATCH)
+ * @return  PICO_OK : allocation successful
+ * @return  PICO_ERR_OTHER : allocation NOT successful
+ * @remarks called after sigAllocate. frames + 1 slots are used in turn, so
+ *          that the slot of the last frame of a batch, whose phase, spectrum
+ *          and impulse response the next frame starts from, is kept during
+ *          the following batch. The phase history ring grows by frames - 1
+ *          entries since all frames of a batch are read before the first
+ *          one uses its phases
+ * @callgraph
+ * @callergraph
+ */
+pico_status_t sigAllocateBatch(picoos_MemoryManager mm,
+        sig_innerobj_t *sig_inObj, picoos_int16 frames)
+{
+    picoos_int32 *d32;
+    picoos_int32 nCount;
+    sig_frame_t *f;
+
+    for (nCount = PHASE_BUFF_SIZE; nCount < PHASE_BUFF_SIZE + frames - 1; nCount++) {
+        d32 = (picoos_int32 *) picoos_allocate(mm, sizeof(picoos_int32) * (PICODSP_PHASEORDER));
+        if (NULL == d32) {
+            sigDeallocateBatch(mm, sig_inObj);
+            return PICO_ERR_OTHER;
+        }
+        sig_inObj->int_vec42[nCount] = d32;
+    }
+    for (nCount = 1; nCount < frames + 1; nCount++) {
+        f = &(sig_inObj->frame[nCount]);
+        f->wcep = (picoos_int32 *) picoos_allocate(mm, PICOSIG_SLOT_SIZE);
+        if (NULL == f->wcep) {
+            sigDeallocateBatch(mm, sig_inObj);
+            return PICO_ERR_OTHER;
+        }
+        /*one allocation per slot, sizes as in sigAllocate*/
+        f->Fr = f->wcep + PICODSP_FFTSIZE;
+        f->Fi = f->Fr + PICODSP_FFTSIZE;
+        f->imp = f->Fi + PICODSP_FFTSIZE;
+        f->ang = f->imp + PICODSP_FFTSIZE;
+        f->outCos = f->ang + PICODSP_HFFTSIZE_P1;
+        f->outSin = f->outCos + PICODSP_HFFTSIZE_P1;
+    }
+    sig_inObj->phsSize = PHASE_BUFF_SIZE + frames - 1;
+    sig_inObj->nSlots = frames + 1;
+    return PICO_OK;
+}/*sigAllocateBatch*/
+
+/**
+ * frees the DSP memory for batches of frames
+ * @param   mm : memory manager
+ * @param   sig_inObj : sig PU internal object of the sub-object
+ * @return  void
+ * @remarks back to frame by frame processing with the buffers of sigAllocate
+ * @callgraph
+ * @callergraph
+ */
+void sigDeallocateBatch(picoos_MemoryManager mm, sig_innerobj_t *sig_inObj)
+{
+    picoos_int32 nCount;
+
+    if (NULL != sig_inObj->frame[0].wcep) {
+        sigSelectFrame(sig_inObj, 0, 0);
+    }
+    sig_inObj->lastSlot = 0;
+    for (nCount = 1; nCount < PICOSIG_MAX_BATCH + 1; nCount++) {
+        if (NULL != sig_inObj->frame[nCount].wcep) {
+            picoos_deallocate(mm, (void *) &(sig_inObj->frame[nCount].wcep));
+        }
+    }
+    for (nCount = PHASE_BUFF_SIZE; nCount < PHASE_RING_SIZE; nCount++) {
+        if (NULL != sig_inObj->int_vec42[nCount]) {
+            picoos_deallocate(mm, (void *) &(sig_inObj->int_vec42[nCount]));
+        }
+    }
+    sig_inObj->phsSize = PHASE_BUFF_SIZE;
+    sig_inObj->nSlots = 1;
+}/*sigDeallocateBatch*/
+
+/*---------------------------------------------------------------------------
+ * VOICE TABLES
+ *---------------------------------------------------------------------------*/
+/*
+ * The formant shift and the noise shaping of a voice (voice options
+ * PICORSRC_VOPT_SIG_FORMANT and PICORSRC_VOPT_SIG_NOISE) are tables built
+ * once per engine, in integers only:
+ *
+ * - mel_2_lin_lookup reads the envelope of linear bin i at position
+ *   A[i] + D[i] / 32 of the warped (mel) axis, tan(w'/2) = k tan(w/2)
+ *   with k = (1 + a) / (1 - a) for the all-pass warping a =
+ *   PICODSP_FREQ_WARP_FACT. All-pass warpings compose by multiplying k,
+ *   so a formant shift is the same table for another k: k / r, where r
+ *   moves 1kHz by the shift. 0Hz and 8kHz stay fixed and A[i] >= i as
+ *   the in-place interpolation needs (r <= 1.51 < k).
+ * - phase_spec2 multiplies the random phase vectors of the unvoiced bins
+ *   by a gain per bin, which is filtering the noise excitation with that
+ *   magnitude response (its phase is random anyway).
+ */
+
+/*k = (1 + a) / (1 - a) for a = PICODSP_FREQ_WARP_FACT (0.42), Q24*/
+#define SIG_WARP_K        ((picoos_int32) ((142LL << 24) / 58))
+/*frequency that the formant shift moves by the shift, in Hz*/
+#define SIG_FORMANT_REF   1000
+/*CORDIC: angles in units of PI / 2^24, values in Q24*/
+#define SIG_CORDIC_STEPS  24
+#define SIG_CORDIC_GAIN   10188014  /*prod(1 / sqrt(1 + 2^-2j)), Q24*/
+
+static const picoos_int32 sig_cordic_atan[SIG_CORDIC_STEPS] = {
+    4194304, 2476042, 1308273, 664100, 333339, 166832, 83436, 41721,
+      20861,   10430,    5215,   2608,   1304,    652,   326,   163,
+         81,      41,      20,     10,      5,      3,     1,     1
+};
+
+/*noise shaping gains of the signed 4 bit steps -8..7 of 1.5dB, Q12*/
+static const picoos_int32 sig_noise_gain[16] = {
+     1029,  1223,  1453,  1727,  2053,  2440,  2900,  3446,
+     4096,  4868,  5786,  6876,  8173,  9713, 11544, 13720
+};
+
+/**
+ * cosine and sine by CORDIC rotation
+ * @param   ang : angle, 0 to PI / 2 (2^23)
+ * @param   cs, sn : cosine and sine, Q24
+ * @return  void
+ */
+static void sigCordicTrig(picoos_int32 ang, picoos_int32 *cs, picoos_int32 *sn)
+{
+    picoos_int32 x, y, t, j;
+
+    x = SIG_CORDIC_GAIN;
+    y = 0;
+    for (j = 0; j < SIG_CORDIC_STEPS; j++) {
+        t = x;
+        if (ang >= 0) {
+            x -= y >> j;
+            y += t >> j;
+            ang -= sig_cordic_atan[j];
+        } else {
+            x += y >> j;
+            y -= t >> j;
+            ang += sig_cordic_atan[j];
+        }
+    }
+    *cs = x;
+    *sn = y;
+}
+
+/**
+ * atan(y / x) by CORDIC vectoring
+ * @param   x, y : x > 0, y >= 0, less than 2^28
+ * @return  the angle, units of PI / 2^24
+ */
+static picoos_int32 sigCordicAtan(picoos_int32 x, picoos_int32 y)
+{
+    picoos_int32 ang, t, j;
+
+    ang = 0;
+    for (j = 0; j < SIG_CORDIC_STEPS; j++) {
+        t = x;
+        if (y > 0) {
+            x += y >> j;
+            y -= t >> j;
+            ang += sig_cordic_atan[j];
+        } else {
+            x -= y >> j;
+            y += t >> j;
+            ang -= sig_cordic_atan[j];
+        }
+    }
+    return ang;
+}
+
+/**
+ * tan(PI * f / 16000)
+ * @param   f : frequency in Hz, 0 to 8000
+ * @return  the tangent, Q24
+ */
+static picoos_int32 sigHalfTan(picoos_int32 f)
+{
+    picoos_int32 cs, sn;
+
+    sigCordicTrig((picoos_int32) (((int64_t) f << 24) / 16000), &cs, &sn);
+    return (picoos_int32) (((int64_t) sn << 24) / cs);
+}
+
+/**
+ * mel-to-linear tables for a formant shift
+ * @param   shift : formant shift in Hz, not 0
+ * @param   A, D : the tables (PICODSP_HFFTSIZE_P1 entries)
+ * @return  void
+ * @remarks for shift 0 this gives sig_mel2lin_A/D up to 1/32 in one entry
+ */
+static void sigFormantTables(picoos_int32 shift, picoos_int16 *A,
+        picoos_int32 *D)
+{
+    picoos_int32 k, cs, sn, pos, i;
+
+    k = (picoos_int32) ((int64_t) SIG_WARP_K * sigHalfTan(SIG_FORMANT_REF)
+            / sigHalfTan(SIG_FORMANT_REF + shift));
+    A[0] = 0;
+    D[0] = 0;
+    for (i = 1; i < PICODSP_H_FFTSIZE; i++) {
+        /*half the angle of bin i: PI * i / 256*/
+        sigCordicTrig(i << 16, &cs, &sn);
+        pos = sigCordicAtan(cs, (picoos_int32) (((int64_t) k * sn) >> 24));
+        pos = (pos + (1 << 10)) >> 11; /*bins / 32*/
+        A[i] = (picoos_int16) (pos >> 5);
+        D[i] = pos & 31;
+    }
+    A[PICODSP_H_FFTSIZE] = PICODSP_H_FFTSIZE;
+    D[PICODSP_H_FFTSIZE] = 0;
+}
+
+/**
+ * noise shaping gains
+ * @param   gains : voice option PICORSRC_VOPT_SIG_NOISE, not 0
+ * @param   g : gain per bin, Q12 (PICODSP_HFFTSIZE_P1 entries)
+ * @return  void
+ * @remarks band k is centered at bin 16k + 8 ((k + 0.5)kHz)
+ */
+static void sigNoiseGains(picoos_int32 gains, picoos_int32 *g)
+{
+    picoos_int32 band[8], i, k, w;
+
+    for (k = 0; k < 8; k++) {
+        band[k] = sig_noise_gain[(((gains >> (4 * k)) & 15) + 8) & 15];
+    }
+    for (i = 0; i < PICODSP_HFFTSIZE_P1; i++) {
+        if (i <= 8) {
+            g[i] = band[0];
+        } else if (i >= 120) {
+            g[i] = band[7];
+        } else {
+            k = (i - 8) >> 4;
+            w = (i - 8) & 15;
+            g[i] = (band[k] * (16 - w) + band[k + 1] * w + 8) >> 4;
+        }
+    }
+}
+
+/**
+ * engine memory of the voice tables
+ * @param   formantShift : voice option PICORSRC_VOPT_SIG_FORMANT
+ * @param   noiseGains : voice option PICORSRC_VOPT_SIG_NOISE
+ * @return  bytes needed by sigAllocateVoice, with allocation overhead
+ * @callgraph
+ * @callergraph
+ */
+picoos_objsize_t sigVoiceMemSize(picoos_int32 formantShift,
+        picoos_int32 noiseGains)
+{
+    if ((0 == formantShift) && (0 == noiseGains)) {
+        return 0;
+    }
+    return 3 * sizeof(picoos_int32) * PICODSP_HFFTSIZE_P1 + 64;
+}/*sigVoiceMemSize*/
+
+/**
+ * allocation of the voice tables
+ * @param   mm : memory manager
+ * @param   sig_inObj : sig PU internal object of the sub-object
+ * @param   formantShift : voice option PICORSRC_VOPT_SIG_FORMANT, in Hz
+ * @param   noiseGains : voice option PICORSRC_VOPT_SIG_NOISE
+ * @return  PICO_OK : allocation successful (nothing to do for 0, 0)
+ * @return  PICO_ERR_OTHER : allocation NOT successful
+ * @remarks called after sigAllocate. The tables replace the shared
+ *          mel-to-linear tables (formant shift) and enable the noise
+ *          shaping in phase_spec2; see above
+ * @callgraph
+ * @callergraph
+ */
+pico_status_t sigAllocateVoice(picoos_MemoryManager mm,
+        sig_innerobj_t *sig_inObj, picoos_int32 formantShift,
+        picoos_int32 noiseGains)
+{
+    picoos_int32 *d32;
+
+    if ((0 == formantShift) && (0 == noiseGains)) {
+        return PICO_OK;
+    }
+    d32 = (picoos_int32 *) picoos_allocate(mm,
+            3 * sizeof(picoos_int32) * PICODSP_HFFTSIZE_P1);
+    if (NULL == d32) {
+        return PICO_ERR_OTHER;
+    }
+    sig_inObj->voiceTables = d32;
+    if (0 != formantShift) {
+        /*D, then A in the space of another int32 table*/
+        sigFormantTables(formantShift,
+                (picoos_int16 *) (d32 + 2 * PICODSP_HFFTSIZE_P1), d32);
+        sig_inObj->d_p = d32;
+        sig_inObj->A_p = (picoos_int16 *) (d32 + 2 * PICODSP_HFFTSIZE_P1);
+    }
+    if (0 != noiseGains) {
+        sigNoiseGains(noiseGains, d32 + PICODSP_HFFTSIZE_P1);
+        sig_inObj->noiseGain = d32 + PICODSP_HFFTSIZE_P1;
+    }
+    return PICO_OK;
+}/*sigAllocateVoice*/
+
+/**
+ * frees the voice tables
+ * @param   mm : memory manager
+ * @param   sig_inObj : sig PU internal object of the sub-object
+ * @return  void
+ * @remarks back to the shared tables and no noise shaping
+ * @callgraph
+ * @callergraph
+ */
+void sigDeallocateVoice(picoos_MemoryManager mm, sig_innerobj_t *sig_inObj)
+{
+    sig_inObj->A_p = sig_mel2lin_A;
+    sig_inObj->d_p = sig_mel2lin_D;
+    sig_inObj->noiseGain = NULL;
+    if (NULL != sig_inObj->voiceTables) {
+        picoos_deallocate(mm, (void *) &(sig_inObj->voiceTables));
+    }
+}/*sigDeallocateVoice*/
+
 /**
  * frees DSP memory for SIG PU
  * @param   mm : memory manager
@@ -333,39 +1045,21 @@ void sigDeallocate(picoos_MemoryManager mm, sig_innerobj_t *sig_inObj)
     /*-----------------------------------------------------------------
      * Memory de-allocations
      * ------------------------------------------------------------------*/
-    if (NULL != sig_inObj->idx_vect1)
-        picoos_deallocate(mm, (void *) &(sig_inObj->idx_vect1));
-    if (NULL != sig_inObj->idx_vect2)
-        picoos_deallocate(mm, (void *) &(sig_inObj->idx_vect2));
-    if (NULL != sig_inObj->idx_vect4)
-        picoos_deallocate(mm, (void *) &(sig_inObj->idx_vect4));
-    if (NULL != sig_inObj->idx_vect5)
-        picoos_deallocate(mm, (void *) &(sig_inObj->idx_vect5));
-    if (NULL != sig_inObj->idx_vect6)
-        picoos_deallocate(mm, (void *) &(sig_inObj->idx_vect6));
-    if (NULL != sig_inObj->idx_vect7)
-        picoos_deallocate(mm, (void *) &(sig_inObj->idx_vect7));
+    sigDeallocateBatch(mm, sig_inObj);
+    sigDeallocateVoice(mm, sig_inObj);
     if (NULL != sig_inObj->idx_vect8)
         picoos_deallocate(mm, (void *) &(sig_inObj->idx_vect8));
     if (NULL != sig_inObj->idx_vect9)
         picoos_deallocate(mm, (void *) &(sig_inObj->idx_vect9));
 
-    if (NULL != sig_inObj->int_vec22)
-        picoos_deallocate(mm, (void *) &(sig_inObj->int_vec22));
     if (NULL != sig_inObj->int_vec23)
         picoos_deallocate(mm, (void *) &(sig_inObj->int_vec23));
     if (NULL != sig_inObj->int_vec24)
         picoos_deallocate(mm, (void *) &(sig_inObj->int_vec24));
-    if (NULL != sig_inObj->int_vec25)
-        picoos_deallocate(mm, (void *) &(sig_inObj->int_vec25));
     if (NULL != sig_inObj->int_vec26)
         picoos_deallocate(mm, (void *) &(sig_inObj->int_vec26));
     if (NULL != sig_inObj->int_vec28)
         picoos_deallocate(mm, (void *) &(sig_inObj->int_vec28));
-    if (NULL != sig_inObj->int_vec29)
-        picoos_deallocate(mm, (void *) &(sig_inObj->int_vec29));
-    if (NULL != sig_inObj->int_vec38)
-        picoos_deallocate(mm, (void *) &(sig_inObj->int_vec38));
     if (NULL != sig_inObj->int_vec30)
         picoos_deallocate(mm, (void *) &(sig_inObj->int_vec30));
     if (NULL != sig_inObj->int_vec31)
@@ -374,18 +1068,12 @@ void sigDeallocate(picoos_MemoryManager mm, sig_innerobj_t *sig_inObj)
         picoos_deallocate(mm, (void *) &(sig_inObj->int_vec32));
     if (NULL != sig_inObj->int_vec33)
         picoos_deallocate(mm, (void *) &(sig_inObj->int_vec33));
-    if (NULL != sig_inObj->int_vec34)
-        picoos_deallocate(mm, (void *) &(sig_inObj->int_vec34));
-    if (NULL != sig_inObj->int_vec35)
-        picoos_deallocate(mm, (void *) &(sig_inObj->int_vec35));
     if (NULL != sig_inObj->int_vec36)
         picoos_deallocate(mm, (void *) &(sig_inObj->int_vec36));
     if (NULL != sig_inObj->int_vec37)
         picoos_deallocate(mm, (void *) &(sig_inObj->int_vec37));
     if (NULL != sig_inObj->int_vec39)
         picoos_deallocate(mm, (void *) &(sig_inObj->int_vec39));
-    if (NULL != sig_inObj->int_vec40)
-        picoos_deallocate(mm, (void *) &(sig_inObj->int_vec40));
 
     for (nCount = 0; nCount < CEPST_BUFF_SIZE; nCount++) {
         if (NULL != sig_inObj->int_vec41[nCount]) {
@@ -432,6 +1120,12 @@ void sigDspInitialize(sig_innerobj_t *sig_inObj, picoos_int32 resetMode)
     sig_inObj->m2_p = PICODSP_FFTSIZE; /*also initializes windowLen*/
     sig_inObj->framesz_p = PICODSP_DISPLACE; /*1/4th of the frame size = displacement*/
     sig_inObj->hfftsize_p = PICODSP_H_FFTSIZE; /*half of the FFT size*/
+#if defined(PICO_FIXED_POINT_ENABLED)
+    sig_inObj->voxbnd_p = sig_inObj->hfftsize_p * sig_inObj->VCutoff_p
+            / (sig_inObj->Fs_p / 2);
+    sig_inObj->voxbnd2_p = sig_inObj->hfftsize_p * sig_inObj->UVCutoff_p
+            / (sig_inObj->Fs_p / 2);
+#else
     sig_inObj->voxbnd_p = (picoos_int32) ((picoos_single) sig_inObj->hfftsize_p
             / ((picoos_single) sig_inObj->Fs_p / (picoos_single) 2)
             * (picoos_single) sig_inObj->VCutoff_p);
@@ -439,15 +1133,16 @@ void sigDspInitialize(sig_innerobj_t *sig_inObj, picoos_int32 resetMode)
             = (picoos_int32) ((picoos_single) sig_inObj->hfftsize_p
                     / ((picoos_single) sig_inObj->Fs_p / (picoos_single) 2)
                     * (picoos_single) sig_inObj->UVCutoff_p);
+#endif
     sig_inObj->hop_p = sig_inObj->framesz_p;
     sig_inObj->nextPeak_p = (((int) (PICODSP_FFTSIZE))
             / ((int) PICODSP_DISPLACE) - 1) * sig_inObj->hop_p;
     sig_inObj->phId_p = 0; /*phonetic id*/
-    sig_inObj->E_p = (picoos_single) 0.0f;
-    sig_inObj->F0_p = (picoos_single) 0.0f;
+    sig_inObj->E_p = PICO_PARAM(0.0f);
+    sig_inObj->F0_p = PICO_PARAM(0.0f);
     sig_inObj->voiced_p = 0;
     sig_inObj->nV = sig_inObj->nU = 0;
-    sig_inObj->sMod_p = (picoos_single) 1.0f;
+    sig_inObj->sMod_p = PICO_PARAM(1.0f);
 
     /*cleanup vectors*/
     for (i = 0; i < 2 * PICODSP_FFTSIZE; i++) {
@@ -455,14 +1150,15 @@ void sigDspInitialize(sig_innerobj_t *sig_inObj, picoos_int32 resetMode)
         sig_inObj->int_vec26[i] = 0; /*wav buff cleanup */
     }
 
-    for (i = 0; i < PICODSP_FFTSIZE; i++) {
-        sig_inObj->idx_vect1[i] = sig_inObj->idx_vect4[i]
-                = sig_inObj->idx_vect5[i] = sig_inObj->idx_vect6[i] = 0;
-        sig_inObj->int_vec32[i] = sig_inObj->int_vec33[i] = 0;
-    }
-
-    for (i = 0; i < PICODSP_HFFTSIZE_P1; i++) {
-        sig_inObj->idx_vect2[i] = (picoos_int16) 0;
+    for (j = 0; j < sig_inObj->nSlots; j++) {
+        for (i = 0; i < PICODSP_FFTSIZE; i++) {
+            sig_inObj->frame[j].Fr[i] = sig_inObj->frame[j].Fi[i] = 0;
+        }
+        /*bin 0 is never set by phase_spec2, but env_spec reads it in the
+          first unvoiced frame after a voiced one (voxbnd 0)*/
+        for (i = 0; i < PICODSP_HFFTSIZE_P1; i++) {
+            sig_inObj->frame[j].outCos[i] = sig_inObj->frame[j].outSin[i] = 0;
+        }
     }
 
     for (i = 0; i < CEPST_BUFF_SIZE; i++) {
@@ -478,7 +1174,8 @@ void sigDspInitialize(sig_innerobj_t *sig_inObj, picoos_int32 resetMode)
         }
     }
 
-    for (i = 0; i < PHASE_BUFF_SIZE; i++) {
+    for (i = 0; i < sig_inObj->phsSize; i++) {
+        sig_inObj->VoxBndBuff[i] = 0;
         if (NULL != sig_inObj->int_vec42[i]) {
             pnt = sig_inObj->int_vec42[i];
             for (j = 0; j < PICODSP_PHASEORDER; j++) {
@@ -487,19 +1184,68 @@ void sigDspInitialize(sig_innerobj_t *sig_inObj, picoos_int32 resetMode)
         }
     }
     sig_inObj->n_available=0;
-    /*---------------------------------------------
-     Init    formant enhancement window
-     hanning window,
-     Post Filter Hermite's interpolator Matrix
-     Mel-2-Lin lookup tables
-     ---------------------------------------------*/
-    enh_wind_init(sig_inObj); /*creates the formant enhancement window*/
-    init_rand(sig_inObj);
-    gen_hann2(sig_inObj);
-    mel_2_lin_init(sig_inObj);
+    sig_inObj->iRand = 0;
 
 }/*sigDspInitialize*/
 
+/**
+ * makes the buffers (and values) of a batch slot those of the current frame
+ * @param   sig_inObj : sig PU internal object of the sub-object
+ * @param   slot : slot of the frame (0..nSlots-1)
+ * @param   values : also restore the frame values saved by sigStoreFrame
+ * @return  void
+ * @remarks the DSP steps work on the current frame only; with batches each
+ *          frame is selected in turn before every step. The head of the
+ *          phase history is not restored since the next frame read continues
+ *          from the current one, see phsHead of sig_frame
+ * @callgraph
+ * @callergraph
+ */
+void sigSelectFrame(sig_innerobj_t *sig_inObj, picoos_int16 slot,
+        picoos_uint8 values)
+{
+    sig_frame_t *f = &(sig_inObj->frame[slot]);
+
+    sig_inObj->wcep_pI = f->wcep;
+    sig_inObj->ang_p = f->ang;
+    sig_inObj->outCosTbl = f->outCos;
+    sig_inObj->outSinTbl = f->outSin;
+    sig_inObj->F2r_p = f->Fr;
+    sig_inObj->F2i_p = f->Fi;
+    sig_inObj->imp_p = f->imp;
+    if (values) {
+        sig_inObj->F0_p = f->F0;
+        sig_inObj->Fuv_p = f->Fuv;
+        sig_inObj->voicing = f->vcg;
+        sig_inObj->E_p = f->E;
+        sig_inObj->voiced_p = f->voiced;
+        sig_inObj->prevVoiced_p = f->prevVoiced;
+        sig_inObj->phId_p = f->phId;
+    }
+}/*sigSelectFrame*/
+
+/**
+ * saves the values of the current frame into a batch slot
+ * @param   sig_inObj : sig PU internal object of the sub-object
+ * @param   slot : slot of the frame (0..nSlots-1)
+ * @return  void
+ * @callgraph
+ * @callergraph
+ */
+void sigStoreFrame(sig_innerobj_t *sig_inObj, picoos_int16 slot)
+{
+    sig_frame_t *f = &(sig_inObj->frame[slot]);
+
+    f->F0 = sig_inObj->F0_p;
+    f->Fuv = sig_inObj->Fuv_p;
+    f->vcg = sig_inObj->voicing;
+    f->E = sig_inObj->E_p;
+    f->voiced = sig_inObj->voiced_p;
+    f->prevVoiced = sig_inObj->prevVoiced_p;
+    f->phId = sig_inObj->phId_p;
+    f->phsHead = sig_inObj->phsHead;
+}/*sigStoreFrame*/
+
 /*-------------------------------------------------------------------------------
  PROCESSING FUNCTIONS : CALLED WITHIN sigStep (cfr. picosig.c)
  --------------------------------------------------------------------------------*/
@@ -524,14 +1270,17 @@ void sigDspInitialize(sig_innerobj_t *sig_inObj, picoos_int32 resetMode)
 void mel_2_lin_lookup(sig_innerobj_t *sig_inObj, picoos_uint32 scmeanMGC)
 {
     /*Local vars*/
-    picoos_int16 nI, k;
-    picoos_int32 delta, term1, term2;
+    picoos_int16 nI;
 
     /*Local vars to be linked with sig data object*/
     picoos_int32 *c1, *XXr;
+#if !defined(PICO_FIXED_POINT_ENABLED)
     picoos_single K1;
-    picoos_int32 *D, K2, shift;
-    picoos_int16 m1, *A, m2, m4, voiced, i;
+#endif
+    const picoos_int32 *D;
+    picoos_int32 K2, shift;
+    const picoos_int16 *A;
+    picoos_int16 m1, m2, m4, voiced, i;
 
     /*Link local variables with sig data object*/
     c1 = sig_inObj->wcep_pI;
@@ -547,8 +1296,13 @@ void mel_2_lin_lookup(sig_innerobj_t *sig_inObj, picoos_uint32 scmeanMGC)
 
     shift = 27 - scmeanMGC;
     K2 = 1 << shift;
+#if defined(PICO_FIXED_POINT_ENABLED)
+    XXr[0] = (picoos_int32) (((int64_t) c1[0] * K2
+            * PICODSP_START_FIX_NORM) >> 16);
+#else
     K1 = (picoos_single) PICODSP_START_FLOAT_NORM * K2;
     XXr[0] = (picoos_int32) ((picoos_single) c1[0] * K1);
+#endif
     for (nI = 1; nI < m1; nI++) {
         if (c1[nI] >= 0)
           XXr[nI] = c1[nI] << shift;
@@ -557,7 +1311,7 @@ void mel_2_lin_lookup(sig_innerobj_t *sig_inObj, picoos_uint32 scmeanMGC)
     }
     i = sizeof(picoos_int32) * (PICODSP_FFTSIZE - m1);
     picoos_mem_set(XXr + m1, 0, i);
-    dfct_nmf(m4, XXr); /* DFCT directly in fixed point */
+    sig_inObj->fft->dfct(m4, XXr); /* DFCT directly in fixed point */
 
     /* *****************************************************************************************
      Linear frequency scale envelope through interpolation.
@@ -569,13 +1323,7 @@ void mel_2_lin_lookup(sig_innerobj_t *sig_inObj, picoos_uint32 scmeanMGC)
      - get rid of extra -1 operation by adapting the table A[]
 
      *******************************************************************************************/
-    for (nI = 1; nI < PICODSP_H_FFTSIZE; nI++) {
-        k = A[nI];
-        term2 = XXr[k];
-        term1 = XXr[k + 1];
-        delta = term1 - term2;
-        XXr[nI] = term2 + (((picoos_single)D[nI] * (picoos_single)delta) / 32); /* ok because nI<=A[nI] <=B[nI] */
-    }
+    sig_inObj->kernels->melToLin(XXr, A, D, PICODSP_H_FFTSIZE); /* ok because nI<=A[nI] <=B[nI] */
 }/*mel_2_lin_lookup*/
 
 /**
@@ -594,9 +1342,10 @@ void phase_spec2(sig_innerobj_t *sig_inObj)
     picoos_int16 VOXBND_M1;
     picoos_int32 *spect, *ang;
     picoos_int16 voiced, m2;
-    picoos_int32 *co, *so, *c, *s, voxbnd, voxbnd2;
+    picoos_int32 *co, *so, voxbnd, voxbnd2;
+    const picoos_int32 *c, *s;
     picoos_int16 i,j, k, n_comp;
-    picoos_int16 *Pvoxbnd;
+    picoos_int16 Pvoxbnd[PHASE_BUFF_SIZE];
     picoos_int32 *phs_p2, *phs_p1, *phs_n1, *phs_n2;
     picoos_int32 *phs;
 
@@ -604,7 +1353,7 @@ void phase_spec2(sig_innerobj_t *sig_inObj)
     spect = sig_inObj->wcep_pI; /* spect_p;*/
     /* current spect scale : times PICODSP_FIX_SCALE1 */
     ang = sig_inObj->ang_p;
-    voxbnd = (picoos_int32) (sig_inObj->voxbnd_p * sig_inObj->voicing);
+    voxbnd = SIG_VOXBND(sig_inObj);
     voxbnd2 = sig_inObj->voxbnd2_p;
     voiced = sig_inObj->voiced_p;
     m2 = sig_inObj->m2_p;
@@ -614,13 +1363,15 @@ void phase_spec2(sig_innerobj_t *sig_inObj)
     /*code starts here*/
     if (voiced == 1) {
         firstUV = voxbnd;
-        Pvoxbnd =  sig_inObj->VoxBndBuff;
+        for (i = 0; i < PHASE_BUFF_SIZE; i++) {
+            Pvoxbnd[i] = sig_inObj->VoxBndBuff[PHASE_HIST(sig_inObj, i)];
+        }
         n_comp   = Pvoxbnd[2];
-        phs_p2 = sig_inObj->PhsBuff[0];
-        phs_p1 = sig_inObj->PhsBuff[1];
-        phs    = sig_inObj->PhsBuff[2];
-        phs_n1 = sig_inObj->PhsBuff[3];
-        phs_n2 = sig_inObj->PhsBuff[4];
+        phs_p2 = sig_inObj->PhsBuff[PHASE_HIST(sig_inObj, 0)];
+        phs_p1 = sig_inObj->PhsBuff[PHASE_HIST(sig_inObj, 1)];
+        phs    = sig_inObj->PhsBuff[PHASE_HIST(sig_inObj, 2)];
+        phs_n1 = sig_inObj->PhsBuff[PHASE_HIST(sig_inObj, 3)];
+        phs_n2 = sig_inObj->PhsBuff[PHASE_HIST(sig_inObj, 4)];
 
         /* find and smooth components which have full context */
         j = n_comp;
@@ -659,9 +1410,18 @@ void phase_spec2(sig_innerobj_t *sig_inObj)
     s = sig_inObj->randSinTbl + iRand;
     co = sig_inObj->outCosTbl + firstUV;
     so = sig_inObj->outSinTbl + firstUV;
-    for (nI = firstUV; nI < PICODSP_HFFTSIZE_P1 - 1; nI++) {
-        *co++ = *c++;
-        *so++ = *s++;
+    if (NULL != sig_inObj->noiseGain) {
+        /*noise shaping, see sigAllocateVoice*/
+        nI = PICODSP_HFFTSIZE_P1 - 1 - firstUV;
+        sig_inObj->kernels->mulShift(co, c, sig_inObj->noiseGain + firstUV, 12, nI);
+        sig_inObj->kernels->mulShift(so, s, sig_inObj->noiseGain + firstUV, 12, nI);
+        co += nI;
+        so += nI;
+    } else {
+        for (nI = firstUV; nI < PICODSP_HFFTSIZE_P1 - 1; nI++) {
+            *co++ = *c++;
+            *so++ = *s++;
+        }
     }
     *co = 1;
     *so = 0;
@@ -694,12 +1454,16 @@ void env_spec(sig_innerobj_t *sig_inObj)
 {
 
     picoos_int16 nI;
-    picoos_int32 fcX, fsX, fExp, voxbnd;
-    picoos_int32 *spect, *ang, *ctbl;
+    picoos_int32 fcX, fsX, voxbnd;
+    picoos_int32 amp[PICODSP_HFFTSIZE_P1];
+    picoos_int32 *spect, *ang;
+    const picoos_int32 *ctbl;
     picoos_int16 voiced, prev_voiced;
     picoos_int32 *co, *so;
     picoos_int32 *Fr, *Fi;
+#if !defined(PICO_FIXED_POINT_ENABLED)
     picoos_single mult;
+#endif
 
     /*Link local variables to sig object*/
     spect = sig_inObj->wcep_pI; /*spect_p*/
@@ -710,27 +1474,42 @@ void env_spec(sig_innerobj_t *sig_inObj)
     Fi = sig_inObj->F2i_p;
     voiced = sig_inObj->voiced_p;
     prev_voiced = sig_inObj->prevVoiced_p;
-    voxbnd = (picoos_int32) (sig_inObj->voxbnd_p * sig_inObj->voicing);
+    voxbnd = SIG_VOXBND(sig_inObj);
     ctbl = sig_inObj->cos_table;
     /*  ctbl scale : times 4096 */
+#if !defined(PICO_FIXED_POINT_ENABLED)
     mult = PICODSP_ENVSPEC_K1 / PICODSP_FIX_SCALE1;
+#endif
 
     /*remove dc from real part*/
-    if (sig_inObj->F0_p > 120) {
+    if (sig_inObj->F0_p > PICO_PARAM(120)) {
         spect[0] = spect[1] = 0;
         spect[2] /= PICODSP_ENVSPEC_K2;
     } else {
         spect[0] = 0;
     }
 
+    /*amplitudes in the math profile of the engine*/
+    if (PICOSIG_MATH_FAST == sig_inObj->mathMode) {
+        sig_inObj->kernels->expShift(amp, spect, PICODSP_ENVSPEC_SHIFT,
+                PICODSP_HFFTSIZE_P1);
+    } else if (PICOSIG_MATH_PRECISE == sig_inObj->mathMode) {
+        for (nI = 0; nI < PICODSP_HFFTSIZE_P1; nI++) {
+            amp[nI] = SIG_ENV_EXP_PRECISE(spect[nI]);
+        }
+    } else {
+        for (nI = 0; nI < PICODSP_HFFTSIZE_P1; nI++) {
+            amp[nI] = SIG_ENV_EXP(spect[nI]);
+        }
+    }
+
     /* if using rand table, use sin and cos tables as well */
     if (voiced || (prev_voiced)) {
         /*Envelope becomes a complex exponential : F=exp(.5*spect + j*angh);*/
         for (nI = 0; nI < voxbnd; nI++) {
             get_trig(ang[nI], ctbl, &fcX, &fsX);
-            fExp = (picoos_int32) EXP((double)spect[nI]*mult);
-            Fr[nI] = fExp * fcX;
-            Fi[nI] = fExp * fsX;
+            Fr[nI] = amp[nI] * fcX;
+            Fi[nI] = amp[nI] * fsX;
         }
         /*         ao=sig_inObj->ang_p+(picoos_int32)voxbnd; */
         co = sig_inObj->outCosTbl + voxbnd;
@@ -739,9 +1518,8 @@ void env_spec(sig_innerobj_t *sig_inObj)
         for (nI = voxbnd; nI < PICODSP_HFFTSIZE_P1; nI++) {
             fcX = *co++;
             fsX = *so++;
-            fExp = (picoos_int32) EXP((double)spect[nI]*mult);
-            Fr[nI] = fExp * fcX;
-            Fi[nI] = fExp * fsX;
+            Fr[nI] = amp[nI] * fcX;
+            Fi[nI] = amp[nI] * fsX;
         }
     } else {
         /*ao=sig_inObj->ang_p+1;*/
@@ -750,10 +1528,9 @@ void env_spec(sig_innerobj_t *sig_inObj)
         for (nI = 1; nI < PICODSP_HFFTSIZE_P1; nI++) {
             fcX = *co++;
             fsX = *so++;
-            fExp = (picoos_int32) EXP((double)spect[nI]*mult);
 
-            Fr[nI] = fExp * fcX;
-            Fi[nI] = fExp * fsX;
+            Fr[nI] = amp[nI] * fcX;
+            Fi[nI] = amp[nI] * fsX;
         }
     }
 
@@ -775,11 +1552,13 @@ void env_spec(sig_innerobj_t *sig_inObj)
 void impulse_response(sig_innerobj_t *sig_inObj)
 {
     /*Define local variables*/
+#if !defined(PICO_FIXED_POINT_ENABLED)
     picoos_single f;
+#endif
     picoos_int16 nI, nn, m2, m4, voiced;
-    picoos_single *E;
-    picoos_int32 *norm_window; /* - fixed point */
-    picoos_int32 *fr, *Fr, *Fi, *t1, ff; /* - fixed point */
+    pico_param_t *E;
+    const picoos_int32 *norm_window; /* - fixed point */
+    picoos_int32 *fr, *Fr, *Fi, ff; /* - fixed point */
 
     /*Link local variables with sig object*/
     m2 = sig_inObj->m2_p;
@@ -801,20 +1580,30 @@ void impulse_response(sig_innerobj_t *sig_inObj)
         fr[nn] = -Fi[nI]; /* - fixed point */
     }
 
-    rdft(m2, -1, fr);
+    sig_inObj->fft->rdft(m2, -1, fr);
     /*window, normalize and differentiate*/
-    *E = norm_result(m2, fr, norm_window);
+    *E = sig_inObj->kernels->normResult(m2, fr, norm_window);
 
+#if defined(PICO_FIXED_POINT_ENABLED)
+    /*E * PICODSP_FIXRESP_NORM with E in Q12*/
+    if (*E > 0) {
+        ff = (picoos_int32) (((int64_t) *E * (picoos_int32) PICODSP_FIXRESP_NORM)
+                >> PICO_PARAM_SHIFT);
+    } else {
+        ff = 20; /*PICODSP_FIXRESP_NORM*/
+    }
+#else
     if (*E > 0) {
         f = *E * PICODSP_FIXRESP_NORM;
     } else {
         f = 20; /*PICODSP_FIXRESP_NORM*/
     }
     ff = (picoos_int32) f;
+#endif
     if (ff < 1)
         ff = 1;
     /*normalize impulse response*/
-    t1 = fr;FAST_DEVICE(PICODSP_FFTSIZE,*(t1++) /= ff;); /* - fixed point */
+    sig_inObj->kernels->divide(fr, ff, PICODSP_FFTSIZE); /* - fixed point */
 
 } /* impulse_response */
 
@@ -834,8 +1623,8 @@ void td_psola2(sig_innerobj_t *sig_inObj)
     picoos_int32 *t1, *t2;
     picoos_int16 cnt;
     picoos_int32 *fr, *v1, ff, f;
-    picoos_int16 a, i;
-    picoos_int32 *window;
+    picoos_int16 a;
+    const picoos_int32 *window;
     picoos_int16 s = (picoos_int16) 1;
     window = sig_inObj->window_p;
 
@@ -867,7 +1656,7 @@ void td_psola2(sig_innerobj_t *sig_inObj)
             ff = (f * window[sig_inObj->LocV[nI]]) >> PICODSP_SHIFT_FACT1;
             t1 = &(v1[a + sig_inObj->LocV[nI]]);
             t2 = &(fr[a]);
-            if (cnt > 0)FAST_DEVICE(cnt,*(t1++)+=*(t2++)*ff;);
+            sig_inObj->kernels->mac(t1, t2, ff, cnt);
         }
     } else if ((sig_inObj->nV == 0) && (sig_inObj->voiced_p == 0)) {
         /* PURELY UNVOICED*/
@@ -880,14 +1669,14 @@ void td_psola2(sig_innerobj_t *sig_inObj)
                 ff = (f * window[sig_inObj->LocU[nI]]) >> PICODSP_SHIFT_FACT1;
                 t1 = &(v1[a + sig_inObj->LocU[nI]]);
                 t2 = &(fr[a]);
-                if (cnt > 0)FAST_DEVICE(cnt,*(t1++)+=*(t2++)*ff; );
+                sig_inObj->kernels->mac(t1, t2, ff, cnt);
             } else { /*s==-1*/
                 a = 0;
                 cnt = PICODSP_FFTSIZE;
                 ff = (f * window[sig_inObj->LocU[nI]]) >> PICODSP_SHIFT_FACT1;
                 t1 = &(v1[(m2 - 1 - a) + sig_inObj->LocU[nI]]);
                 t2 = &(fr[a]);
-                if (cnt > 0)FAST_DEVICE(cnt,*(t1--)+=*(t2++)*ff; );
+                sig_inObj->kernels->macReverse(t1, t2, ff, cnt);
             }
         }
     } else if (sig_inObj->VoicTrans == 0) {
@@ -899,7 +1688,7 @@ void td_psola2(sig_innerobj_t *sig_inObj)
             ff = (f * window[sig_inObj->LocV[nI]]) >> PICODSP_SHIFT_FACT1;
             t1 = &(v1[a + sig_inObj->LocV[nI]]);
             t2 = &(fr[a]);
-            if (cnt > 0)FAST_DEVICE(cnt,*(t1++)+=*(t2++)*ff;);
+            sig_inObj->kernels->mac(t1, t2, ff, cnt);
         }
         /*add remaining stuff from unvoiced part*/
         for (nI = 0; nI < sig_inObj->nU; nI++) {
@@ -911,14 +1700,14 @@ void td_psola2(sig_innerobj_t *sig_inObj)
                 ff = (f * window[sig_inObj->LocU[nI]]) >> PICODSP_SHIFT_FACT1;
                 t1 = &(v1[a + sig_inObj->LocU[nI]]);
                 t2 = &(sig_inObj->ImpResp_p[a]); /*saved impulse response*/
-                if (cnt > 0)FAST_DEVICE(cnt,*(t1++)+=*(t2++)*ff; );
+                sig_inObj->kernels->mac(t1, t2, ff, cnt);
             } else {
                 a = 0;
                 cnt = PICODSP_FFTSIZE;
                 ff = (f * window[sig_inObj->LocU[nI]]) >> PICODSP_SHIFT_FACT1;
                 t1 = &(v1[(m2 - 1 - a) + sig_inObj->LocU[nI]]);
                 t2 = &(sig_inObj->ImpResp_p[a]);
-                if (cnt > 0)FAST_DEVICE(cnt,*(t1--)+=*(t2++)*ff; );
+                sig_inObj->kernels->macReverse(t1, t2, ff, cnt);
             }
         }
     } else {
@@ -932,14 +1721,14 @@ void td_psola2(sig_innerobj_t *sig_inObj)
                 ff = (f * window[sig_inObj->LocU[nI]]) >> PICODSP_SHIFT_FACT1;
                 t1 = &(v1[a + sig_inObj->LocU[nI]]);
                 t2 = &(fr[a]);
-                if (cnt > 0)FAST_DEVICE(cnt,*(t1++)+=*(t2++)*ff; );
+                sig_inObj->kernels->mac(t1, t2, ff, cnt);
             } else {
                 a = 0;
                 cnt = PICODSP_FFTSIZE;
                 ff = (f * window[sig_inObj->LocU[nI]]) >> PICODSP_SHIFT_FACT1;
                 t1 = &(v1[(m2 - 1 - a) + sig_inObj->LocU[nI]]);
                 t2 = &(fr[a]);
-                if (cnt > 0)FAST_DEVICE(cnt,*(t1--)+=*(t2++)*ff; );
+                sig_inObj->kernels->macReverse(t1, t2, ff, cnt);
             }
         }
         /*add remaining stuff from voiced part*/
@@ -950,17 +1739,12 @@ void td_psola2(sig_innerobj_t *sig_inObj)
             ff = (f * window[sig_inObj->LocV[nI]]) >> PICODSP_SHIFT_FACT1;
             t1 = &(v1[a + sig_inObj->LocV[nI]]);
             t2 = &(sig_inObj->ImpResp_p[a]);
-            if (cnt > 0)FAST_DEVICE(cnt,*(t1++)+=*(t2++)*ff;);
+            sig_inObj->kernels->mac(t1, t2, ff, cnt);
         }
     }
 
-    t1 = sig_inObj->sig_vec1;
-    for (i = 0; i < PICODSP_FFTSIZE; i++, t1++) {
-        if (*t1 >= 0)
-            *t1 >>= PICODSP_SHIFT_FACT5;
-        else
-            *t1 = -((-*t1) >> PICODSP_SHIFT_FACT5);
-    }
+    sig_inObj->kernels->shiftRight(sig_inObj->sig_vec1, PICODSP_SHIFT_FACT5,
+            PICODSP_FFTSIZE);
 
 }/*td_psola2*/
 
@@ -989,2935 +1773,83 @@ void overlap_add(sig_innerobj_t *sig_inObj)
     w = sig_inObj->WavBuff_p;
     v = sig_inObj->sig_vec1;
 
-    FAST_DEVICE(PICODSP_FFTSIZE, 
-        if (*v >= 0)
-          *(w++)+=*(v++)<<PICODSP_SHIFT_FACT6;
-        else
-          *(w++)+=-(-*(v++)<<PICODSP_SHIFT_FACT6);
-        );
+    sig_inObj->kernels->addShiftLeft(w, v, PICODSP_SHIFT_FACT6, PICODSP_FFTSIZE);
 
 }/*overlap_add*/
 
-/*-------------------------------------------------------------------------------
- INITIALIZATION AND INTERNAL    FUNCTIONS
- --------------------------------------------------------------------------------*/
 /**
- * Hanning window initialization
+ * checks whether excitation pulses of non-zero energy are still in the
+ * synthesis window of the next frame
  * @param    sig_inObj : sig PU internal object of the sub-object
- * @return  PICO_OK
- * @callgraph
- * @callergraph
- */
-static void gen_hann2(sig_innerobj_t *sig_inObj)
-{
-    picoos_int32 *hann;
-    picoos_int32 *norm;
-    /*link local variables with sig object*/
-    hann = sig_inObj->window_p;
-    norm = sig_inObj->norm_window_p;
-
-    norm[0] = 80224;
-    norm[1] = 320832;
-    norm[2] = 721696;
-    norm[3] = 1282560;
-    norm[4] = 2003104;
-    norm[5] = 2882880;
-    norm[6] = 3921376;
-    norm[7] = 5117984;
-    norm[8] = 6471952;
-    norm[9] = 7982496;
-    norm[10] = 9648720;
-    norm[11] = 11469616;
-    norm[12] = 13444080;
-    norm[13] = 15570960;
-    norm[14] = 17848976;
-    norm[15] = 20276752;
-    norm[16] = 22852864;
-    norm[17] = 25575744;
-    norm[18] = 28443776;
-    norm[19] = 31455264;
-    norm[20] = 34608368;
-    norm[21] = 37901248;
-    norm[22] = 41331904;
-    norm[23] = 44898304;
-    norm[24] = 48598304;
-    norm[25] = 52429696;
-    norm[26] = 56390192;
-    norm[27] = 60477408;
-    norm[28] = 64688944;
-    norm[29] = 69022240;
-    norm[30] = 73474720;
-    norm[31] = 78043744;
-    norm[32] = 82726544;
-    norm[33] = 87520352;
-    norm[34] = 92422272;
-    norm[35] = 97429408;
-    norm[36] = 102538752;
-    norm[37] = 107747248;
-    norm[38] = 113051776;
-    norm[39] = 118449184;
-    norm[40] = 123936224;
-    norm[41] = 129509648;
-    norm[42] = 135166080;
-    norm[43] = 140902192;
-    norm[44] = 146714528;
-    norm[45] = 152599584;
-    norm[46] = 158553904;
-    norm[47] = 164573888;
-    norm[48] = 170655936;
-    norm[49] = 176796448;
-    norm[50] = 182991712;
-    norm[51] = 189238064;
-    norm[52] = 195531744;
-    norm[53] = 201868992;
-    norm[54] = 208246016;
-    norm[55] = 214659040;
-    norm[56] = 221104176;
-    norm[57] = 227577616;
-    norm[58] = 234075488;
-    norm[59] = 240593872;
-    norm[60] = 247128912;
-    norm[61] = 253676688;
-    norm[62] = 260233280;
-    norm[63] = 266794768;
-    norm[64] = 273357248;
-    norm[65] = 279916768;
-    norm[66] = 286469440;
-    norm[67] = 293011360;
-    norm[68] = 299538560;
-    norm[69] = 306047168;
-    norm[70] = 312533312;
-    norm[71] = 318993088;
-    norm[72] = 325422656;
-    norm[73] = 331818144;
-    norm[74] = 338175744;
-    norm[75] = 344491680;
-    norm[76] = 350762176;
-    norm[77] = 356983424;
-    norm[78] = 363151808;
-    norm[79] = 369263520;
-    norm[80] = 375315008;
-    norm[81] = 381302592;
-    norm[82] = 387222720;
-    norm[83] = 393071872;
-    norm[84] = 398846528;
-    norm[85] = 404543232;
-    norm[86] = 410158560;
-    norm[87] = 415689216;
-    norm[88] = 421131840;
-    norm[89] = 426483200;
-    norm[90] = 431740096;
-    norm[91] = 436899392;
-    norm[92] = 441958016;
-    norm[93] = 446912928;
-    norm[94] = 451761152;
-    norm[95] = 456499840;
-    norm[96] = 461126080;
-    norm[97] = 465637152;
-    norm[98] = 470030400;
-    norm[99] = 474303104;
-    norm[100] = 478452800;
-    norm[101] = 482476960;
-    norm[102] = 486373184;
-    norm[103] = 490139200;
-    norm[104] = 493772640;
-    norm[105] = 497271424;
-    norm[106] = 500633440;
-    norm[107] = 503856704;
-    norm[108] = 506939200;
-    norm[109] = 509879168;
-    norm[110] = 512674880;
-    norm[111] = 515324544;
-    norm[112] = 517826688;
-    norm[113] = 520179776;
-    norm[114] = 522382368;
-    norm[115] = 524433184;
-    norm[116] = 526331008;
-    norm[117] = 528074688;
-    norm[118] = 529663200;
-    norm[119] = 531095552;
-    norm[120] = 532370944;
-    norm[121] = 533488576;
-    norm[122] = 534447808;
-    norm[123] = 535248000;
-    norm[124] = 535888768;
-    norm[125] = 536369664;
-    norm[126] = 536690432;
-    norm[127] = 536850880;
-    norm[128] = 536850880;
-    norm[129] = 536690432;
-    norm[130] = 536369664;
-    norm[131] = 535888768;
-    norm[132] = 535248000;
-    norm[133] = 534447808;
-    norm[134] = 533488576;
-    norm[135] = 532370944;
-    norm[136] = 531095552;
-    norm[137] = 529663200;
-    norm[138] = 528074688;
-    norm[139] = 526331008;
-    norm[140] = 524433216;
-    norm[141] = 522382368;
-    norm[142] = 520179776;
-    norm[143] = 517826688;
-    norm[144] = 515324544;
-    norm[145] = 512674880;
-    norm[146] = 509879168;
-    norm[147] = 506939200;
-    norm[148] = 503856704;
-    norm[149] = 500633472;
-    norm[150] = 497271424;
-    norm[151] = 493772672;
-    norm[152] = 490139200;
-    norm[153] = 486373184;
-    norm[154] = 482476992;
-    norm[155] = 478452800;
-    norm[156] = 474303104;
-    norm[157] = 470030400;
-    norm[158] = 465637184;
-    norm[159] = 461126080;
-    norm[160] = 456499840;
-    norm[161] = 451761152;
-    norm[162] = 446912960;
-    norm[163] = 441958016;
-    norm[164] = 436899424;
-    norm[165] = 431740096;
-    norm[166] = 426483200;
-    norm[167] = 421131840;
-    norm[168] = 415689216;
-    norm[169] = 410158560;
-    norm[170] = 404543232;
-    norm[171] = 398846528;
-    norm[172] = 393071872;
-    norm[173] = 387222720;
-    norm[174] = 381302592;
-    norm[175] = 375315008;
-    norm[176] = 369263552;
-    norm[177] = 363151808;
-    norm[178] = 356983456;
-    norm[179] = 350762176;
-    norm[180] = 344491712;
-    norm[181] = 338175776;
-    norm[182] = 331818144;
-    norm[183] = 325422656;
-    norm[184] = 318993088;
-    norm[185] = 312533312;
-    norm[186] = 306047168;
-    norm[187] = 299538560;
-    norm[188] = 293011360;
-    norm[189] = 286469472;
-    norm[190] = 279916800;
-    norm[191] = 273357248;
-    norm[192] = 266794784;
-    norm[193] = 260233280;
-    norm[194] = 253676688;
-    norm[195] = 247128928;
-    norm[196] = 240593888;
-    norm[197] = 234075488;
-    norm[198] = 227577632;
-    norm[199] = 221104192;
-    norm[200] = 214659040;
-    norm[201] = 208246032;
-    norm[202] = 201868992;
-    norm[203] = 195531744;
-    norm[204] = 189238080;
-    norm[205] = 182991728;
-    norm[206] = 176796448;
-    norm[207] = 170655952;
-    norm[208] = 164573888;
-    norm[209] = 158553920;
-    norm[210] = 152599600;
-    norm[211] = 146714528;
-    norm[212] = 140902208;
-    norm[213] = 135166096;
-    norm[214] = 129509648;
-    norm[215] = 123936240;
-    norm[216] = 118449184;
-    norm[217] = 113051776;
-    norm[218] = 107747248;
-    norm[219] = 102538752;
-    norm[220] = 97429424;
-    norm[221] = 92422288;
-    norm[222] = 87520352;
-    norm[223] = 82726544;
-    norm[224] = 78043744;
-    norm[225] = 73474736;
-    norm[226] = 69022240;
-    norm[227] = 64688944;
-    norm[228] = 60477424;
-    norm[229] = 56390192;
-    norm[230] = 52429696;
-    norm[231] = 48598304;
-    norm[232] = 44898304;
-    norm[233] = 41331904;
-    norm[234] = 37901248;
-    norm[235] = 34608384;
-    norm[236] = 31455264;
-    norm[237] = 28443792;
-    norm[238] = 25575744;
-    norm[239] = 22852864;
-    norm[240] = 20276752;
-    norm[241] = 17848976;
-    norm[242] = 15570960;
-    norm[243] = 13444080;
-    norm[244] = 11469616;
-    norm[245] = 9648720;
-    norm[246] = 7982512;
-    norm[247] = 6471952;
-    norm[248] = 5117984;
-    norm[249] = 3921376;
-    norm[250] = 2882880;
-    norm[251] = 2003104;
-    norm[252] = 1282560;
-    norm[253] = 721696;
-    norm[254] = 320832;
-    norm[255] = 80224;
-    hann[0] = 0;
-    hann[1] = 0;
-    hann[2] = 1;
-    hann[3] = 2;
-    hann[4] = 3;
-    hann[5] = 5;
-    hann[6] = 7;
-    hann[7] = 9;
-    hann[8] = 12;
-    hann[9] = 15;
-    hann[10] = 18;
-    hann[11] = 21;
-    hann[12] = 25;
-    hann[13] = 29;
-    hann[14] = 34;
-    hann[15] = 38;
-    hann[16] = 43;
-    hann[17] = 48;
-    hann[18] = 54;
-    hann[19] = 59;
-    hann[20] = 66;
-    hann[21] = 72;
-    hann[22] = 78;
-    hann[23] = 85;
-    hann[24] = 92;
-    hann[25] = 100;
-    hann[26] = 107;
-    hann[27] = 115;
-    hann[28] = 123;
-    hann[29] = 131;
-    hann[30] = 140;
-    hann[31] = 148;
-    hann[32] = 157;
-    hann[33] = 166;
-    hann[34] = 176;
-    hann[35] = 185;
-    hann[36] = 195;
-    hann[37] = 205;
-    hann[38] = 215;
-    hann[39] = 225;
-    hann[40] = 236;
-    hann[41] = 247;
-    hann[42] = 257;
-    hann[43] = 268;
-    hann[44] = 279;
-    hann[45] = 291;
-    hann[46] = 302;
-    hann[47] = 313;
-    hann[48] = 325;
-    hann[49] = 337;
-    hann[50] = 349;
-    hann[51] = 360;
-    hann[52] = 372;
-    hann[53] = 385;
-    hann[54] = 397;
-    hann[55] = 409;
-    hann[56] = 421;
-    hann[57] = 434;
-    hann[58] = 446;
-    hann[59] = 458;
-    hann[60] = 471;
-    hann[61] = 483;
-    hann[62] = 496;
-    hann[63] = 508;
-    hann[64] = 521;
-    hann[65] = 533;
-    hann[66] = 546;
-    hann[67] = 558;
-    hann[68] = 571;
-    hann[69] = 583;
-    hann[70] = 596;
-    hann[71] = 608;
-    hann[72] = 620;
-    hann[73] = 632;
-    hann[74] = 645;
-    hann[75] = 657;
-    hann[76] = 669;
-    hann[77] = 680;
-    hann[78] = 692;
-    hann[79] = 704;
-    hann[80] = 715;
-    hann[81] = 727;
-    hann[82] = 738;
-    hann[83] = 749;
-    hann[84] = 760;
-    hann[85] = 771;
-    hann[86] = 782;
-    hann[87] = 792;
-    hann[88] = 803;
-    hann[89] = 813;
-    hann[90] = 823;
-    hann[91] = 833;
-    hann[92] = 842;
-    hann[93] = 852;
-    hann[94] = 861;
-    hann[95] = 870;
-    hann[96] = 879;
-    hann[97] = 888;
-    hann[98] = 896;
-    hann[99] = 904;
-    hann[100] = 912;
-    hann[101] = 920;
-    hann[102] = 927;
-    hann[103] = 934;
-    hann[104] = 941;
-    hann[105] = 948;
-    hann[106] = 954;
-    hann[107] = 961;
-    hann[108] = 966;
-    hann[109] = 972;
-    hann[110] = 977;
-    hann[111] = 982;
-    hann[112] = 987;
-    hann[113] = 992;
-    hann[114] = 996;
-    hann[115] = 1000;
-    hann[116] = 1003;
-    hann[117] = 1007;
-    hann[118] = 1010;
-    hann[119] = 1012;
-    hann[120] = 1015;
-    hann[121] = 1017;
-    hann[122] = 1019;
-    hann[123] = 1020;
-    hann[124] = 1022;
-    hann[125] = 1023;
-    hann[126] = 1023;
-    hann[127] = 1023;
-    hann[128] = 1023;
-    hann[129] = 1023;
-    hann[130] = 1023;
-    hann[131] = 1022;
-    hann[132] = 1020;
-    hann[133] = 1019;
-    hann[134] = 1017;
-    hann[135] = 1015;
-    hann[136] = 1012;
-    hann[137] = 1010;
-    hann[138] = 1007;
-    hann[139] = 1003;
-    hann[140] = 1000;
-    hann[141] = 996;
-    hann[142] = 992;
-    hann[143] = 987;
-    hann[144] = 982;
-    hann[145] = 977;
-    hann[146] = 972;
-    hann[147] = 966;
-    hann[148] = 961;
-    hann[149] = 954;
-    hann[150] = 948;
-    hann[151] = 941;
-    hann[152] = 934;
-    hann[153] = 927;
-    hann[154] = 920;
-    hann[155] = 912;
-    hann[156] = 904;
-    hann[157] = 896;
-    hann[158] = 888;
-    hann[159] = 879;
-    hann[160] = 870;
-    hann[161] = 861;
-    hann[162] = 852;
-    hann[163] = 842;
-    hann[164] = 833;
-    hann[165] = 823;
-    hann[166] = 813;
-    hann[167] = 803;
-    hann[168] = 792;
-    hann[169] = 782;
-    hann[170] = 771;
-    hann[171] = 760;
-    hann[172] = 749;
-    hann[173] = 738;
-    hann[174] = 727;
-    hann[175] = 715;
-    hann[176] = 704;
-    hann[177] = 692;
-    hann[178] = 680;
-    hann[179] = 669;
-    hann[180] = 657;
-    hann[181] = 645;
-    hann[182] = 632;
-    hann[183] = 620;
-    hann[184] = 608;
-    hann[185] = 596;
-    hann[186] = 583;
-    hann[187] = 571;
-    hann[188] = 558;
-    hann[189] = 546;
-    hann[190] = 533;
-    hann[191] = 521;
-    hann[192] = 508;
-    hann[193] = 496;
-    hann[194] = 483;
-    hann[195] = 471;
-    hann[196] = 458;
-    hann[197] = 446;
-    hann[198] = 434;
-    hann[199] = 421;
-    hann[200] = 409;
-    hann[201] = 397;
-    hann[202] = 385;
-    hann[203] = 372;
-    hann[204] = 360;
-    hann[205] = 349;
-    hann[206] = 337;
-    hann[207] = 325;
-    hann[208] = 313;
-    hann[209] = 302;
-    hann[210] = 291;
-    hann[211] = 279;
-    hann[212] = 268;
-    hann[213] = 257;
-    hann[214] = 247;
-    hann[215] = 236;
-    hann[216] = 225;
-    hann[217] = 215;
-    hann[218] = 205;
-    hann[219] = 195;
-    hann[220] = 185;
-    hann[221] = 176;
-    hann[222] = 166;
-    hann[223] = 157;
-    hann[224] = 148;
-    hann[225] = 140;
-    hann[226] = 131;
-    hann[227] = 123;
-    hann[228] = 115;
-    hann[229] = 107;
-    hann[230] = 100;
-    hann[231] = 92;
-    hann[232] = 85;
-    hann[233] = 78;
-    hann[234] = 72;
-    hann[235] = 66;
-    hann[236] = 59;
-    hann[237] = 54;
-    hann[238] = 48;
-    hann[239] = 43;
-    hann[240] = 38;
-    hann[241] = 34;
-    hann[242] = 29;
-    hann[243] = 25;
-    hann[244] = 21;
-    hann[245] = 18;
-    hann[246] = 15;
-    hann[247] = 12;
-    hann[248] = 9;
-    hann[249] = 7;
-    hann[250] = 5;
-    hann[251] = 3;
-    hann[252] = 2;
-    hann[253] = 1;
-    hann[254] = 0;
-    hann[255] = 0;
-
-} /* gen_hann2 */
-
-/**
- * Creates the non uniform enhancement window (bilinearly mapped hannning window)
- * in order to reduce the formant enhancement in the high spectrum
- * @param    mm : memory manager
- * @param    sig_inObj : sig PU internal object of the sub-object
- * @return   void
- * @callgraph
- * @callergraph
- * @remarks the outgput is based on the matlab script below\n
- matlab script
- -------------
- function makeEnhWind(alpha)
- N=129; % =HFFTSIZEE_P1
- s=(bilinmap(alpha,N));
- h=[hann(N)'];
- x=(1:N)/N;
- W=interp1(x,h,s); W(1)=0;
-
- fid=fopen('enhwind.txt','wt');
- fprintf(fid,'picoos_int16 enh_wind_init(sig_innerobj_t *sig_inObj) {\n');
- for i=1:N,
- fprintf(fid,['   sig_inObj->enhwind[' int2str(i) '] = (picoos_single)' num2str(W(i),'%0.7g') ';\n']);
- end;
- fprintf(fid,'   return PICO_OK;\n');
- fprintf(fid,' }; \n');
- fclose(fid);
- %figure(1); plot(x*8,W);
- */
-static void enh_wind_init(sig_innerobj_t *sig_inObj)
-{
-    /*     picoos_int16 i; */
-    picoos_int32 *c;
-
-    c = sig_inObj->cos_table;
-
-    c[0] = 4096;
-    c[1] = 4095;
-    c[2] = 4095;
-    c[3] = 4095;
-    c[4] = 4095;
-    c[5] = 4095;
-    c[6] = 4095;
-    c[7] = 4095;
-    c[8] = 4094;
-    c[9] = 4094;
-    c[10] = 4094;
-    c[11] = 4093;
-    c[12] = 4093;
-    c[13] = 4092;
-    c[14] = 4092;
-    c[15] = 4091;
-    c[16] = 4091;
-    c[17] = 4090;
-    c[18] = 4089;
-    c[19] = 4089;
-    c[20] = 4088;
-    c[21] = 4087;
-    c[22] = 4086;
-    c[23] = 4085;
-    c[24] = 4084;
-    c[25] = 4083;
-    c[26] = 4082;
-    c[27] = 4081;
-    c[28] = 4080;
-    c[29] = 4079;
-    c[30] = 4078;
-    c[31] = 4077;
-    c[32] = 4076;
-    c[33] = 4075;
-    c[34] = 4073;
-    c[35] = 4072;
-    c[36] = 4071;
-    c[37] = 4069;
-    c[38] = 4068;
-    c[39] = 4066;
-    c[40] = 4065;
-    c[41] = 4063;
-    c[42] = 4062;
-    c[43] = 4060;
-    c[44] = 4058;
-    c[45] = 4057;
-    c[46] = 4055;
-    c[47] = 4053;
-    c[48] = 4051;
-    c[49] = 4049;
-    c[50] = 4047;
-    c[51] = 4045;
-    c[52] = 4043;
-    c[53] = 4041;
-    c[54] = 4039;
-    c[55] = 4037;
-    c[56] = 4035;
-    c[57] = 4033;
-    c[58] = 4031;
-    c[59] = 4029;
-    c[60] = 4026;
-    c[61] = 4024;
-    c[62] = 4022;
-    c[63] = 4019;
-    c[64] = 4017;
-    c[65] = 4014;
-    c[66] = 4012;
-    c[67] = 4009;
-    c[68] = 4007;
-    c[69] = 4004;
-    c[70] = 4001;
-    c[71] = 3999;
-    c[72] = 3996;
-    c[73] = 3993;
-    c[74] = 3990;
-    c[75] = 3988;
-    c[76] = 3985;
-    c[77] = 3982;
-    c[78] = 3979;
-    c[79] = 3976;
-    c[80] = 3973;
-    c[81] = 3970;
-    c[82] = 3967;
-    c[83] = 3963;
-    c[84] = 3960;
-    c[85] = 3957;
-    c[86] = 3954;
-    c[87] = 3950;
-    c[88] = 3947;
-    c[89] = 3944;
-    c[90] = 3940;
-    c[91] = 3937;
-    c[92] = 3933;
-    c[93] = 3930;
-    c[94] = 3926;
-    c[95] = 3923;
-    c[96] = 3919;
-    c[97] = 3915;
-    c[98] = 3912;
-    c[99] = 3908;
-    c[100] = 3904;
-    c[101] = 3900;
-    c[102] = 3897;
-    c[103] = 3893;
-    c[104] = 3889;
-    c[105] = 3885;
-    c[106] = 3881;
-    c[107] = 3877;
-    c[108] = 3873;
-    c[109] = 3869;
-    c[110] = 3864;
-    c[111] = 3860;
-    c[112] = 3856;
-    c[113] = 3852;
-    c[114] = 3848;
-    c[115] = 3843;
-    c[116] = 3839;
-    c[117] = 3834;
-    c[118] = 3830;
-    c[119] = 3826;
-    c[120] = 3821;
-    c[121] = 3816;
-    c[122] = 3812;
-    c[123] = 3807;
-    c[124] = 3803;
-    c[125] = 3798;
-    c[126] = 3793;
-    c[127] = 3789;
-    c[128] = 3784;
-    c[129] = 3779;
-    c[130] = 3774;
-    c[131] = 3769;
-    c[132] = 3764;
-    c[133] = 3759;
-    c[134] = 3754;
-    c[135] = 3749;
-    c[136] = 3744;
-    c[137] = 3739;
-    c[138] = 3734;
-    c[139] = 3729;
-    c[140] = 3723;
-    c[141] = 3718;
-    c[142] = 3713;
-    c[143] = 3708;
-    c[144] = 3702;
-    c[145] = 3697;
-    c[146] = 3691;
-    c[147] = 3686;
-    c[148] = 3680;
-    c[149] = 3675;
-    c[150] = 3669;
-    c[151] = 3664;
-    c[152] = 3658;
-    c[153] = 3652;
-    c[154] = 3647;
-    c[155] = 3641;
-    c[156] = 3635;
-    c[157] = 3629;
-    c[158] = 3624;
-    c[159] = 3618;
-    c[160] = 3612;
-    c[161] = 3606;
-    c[162] = 3600;
-    c[163] = 3594;
-    c[164] = 3588;
-    c[165] = 3582;
-    c[166] = 3576;
-    c[167] = 3570;
-    c[168] = 3563;
-    c[169] = 3557;
-    c[170] = 3551;
-    c[171] = 3545;
-    c[172] = 3538;
-    c[173] = 3532;
-    c[174] = 3526;
-    c[175] = 3519;
-    c[176] = 3513;
-    c[177] = 3506;
-    c[178] = 3500;
-    c[179] = 3493;
-    c[180] = 3487;
-    c[181] = 3480;
-    c[182] = 3473;
-    c[183] = 3467;
-    c[184] = 3460;
-    c[185] = 3453;
-    c[186] = 3447;
-    c[187] = 3440;
-    c[188] = 3433;
-    c[189] = 3426;
-    c[190] = 3419;
-    c[191] = 3412;
-    c[192] = 3405;
-    c[193] = 3398;
-    c[194] = 3391;
-    c[195] = 3384;
-    c[196] = 3377;
-    c[197] = 3370;
-    c[198] = 3363;
-    c[199] = 3356;
-    c[200] = 3348;
-    c[201] = 3341;
-    c[202] = 3334;
-    c[203] = 3326;
-    c[204] = 3319;
-    c[205] = 3312;
-    c[206] = 3304;
-    c[207] = 3297;
-    c[208] = 3289;
-    c[209] = 3282;
-    c[210] = 3274;
-    c[211] = 3267;
-    c[212] = 3259;
-    c[213] = 3252;
-    c[214] = 3244;
-    c[215] = 3236;
-    c[216] = 3229;
-    c[217] = 3221;
-    c[218] = 3213;
-    c[219] = 3205;
-    c[220] = 3197;
-    c[221] = 3190;
-    c[222] = 3182;
-    c[223] = 3174;
-    c[224] = 3166;
-    c[225] = 3158;
-    c[226] = 3150;
-    c[227] = 3142;
-    c[228] = 3134;
-    c[229] = 3126;
-    c[230] = 3117;
-    c[231] = 3109;
-    c[232] = 3101;
-    c[233] = 3093;
-    c[234] = 3085;
-    c[235] = 3076;
-    c[236] = 3068;
-    c[237] = 3060;
-    c[238] = 3051;
-    c[239] = 3043;
-    c[240] = 3034;
-    c[241] = 3026;
-    c[242] = 3018;
-    c[243] = 3009;
-    c[244] = 3000;
-    c[245] = 2992;
-    c[246] = 2983;
-    c[247] = 2975;
-    c[248] = 2966;
-    c[249] = 2957;
-    c[250] = 2949;
-    c[251] = 2940;
-    c[252] = 2931;
-    c[253] = 2922;
-    c[254] = 2914;
-    c[255] = 2905;
-    c[256] = 2896;
-    c[257] = 2887;
-    c[258] = 2878;
-    c[259] = 2869;
-    c[260] = 2860;
-    c[261] = 2851;
-    c[262] = 2842;
-    c[263] = 2833;
-    c[264] = 2824;
-    c[265] = 2815;
-    c[266] = 2806;
-    c[267] = 2796;
-    c[268] = 2787;
-    c[269] = 2778;
-    c[270] = 2769;
-    c[271] = 2760;
-    c[272] = 2750;
-    c[273] = 2741;
-    c[274] = 2732;
-    c[275] = 2722;
-    c[276] = 2713;
-    c[277] = 2703;
-    c[278] = 2694;
-    c[279] = 2684;
-    c[280] = 2675;
-    c[281] = 2665;
-    c[282] = 2656;
-    c[283] = 2646;
-    c[284] = 2637;
-    c[285] = 2627;
-    c[286] = 2617;
-    c[287] = 2608;
-    c[288] = 2598;
-    c[289] = 2588;
-    c[290] = 2578;
-    c[291] = 2569;
-    c[292] = 2559;
-    c[293] = 2549;
-    c[294] = 2539;
-    c[295] = 2529;
-    c[296] = 2519;
-    c[297] = 2510;
-    c[298] = 2500;
-    c[299] = 2490;
-    c[300] = 2480;
-    c[301] = 2470;
-    c[302] = 2460;
-    c[303] = 2450;
-    c[304] = 2439;
-    c[305] = 2429;
-    c[306] = 2419;
-    c[307] = 2409;
-    c[308] = 2399;
-    c[309] = 2389;
-    c[310] = 2379;
-    c[311] = 2368;
-    c[312] = 2358;
-    c[313] = 2348;
-    c[314] = 2337;
-    c[315] = 2327;
-    c[316] = 2317;
-    c[317] = 2306;
-    c[318] = 2296;
-    c[319] = 2286;
-    c[320] = 2275;
-    c[321] = 2265;
-    c[322] = 2254;
-    c[323] = 2244;
-    c[324] = 2233;
-    c[325] = 2223;
-    c[326] = 2212;
-    c[327] = 2201;
-    c[328] = 2191;
-    c[329] = 2180;
-    c[330] = 2170;
-    c[331] = 2159;
-    c[332] = 2148;
-    c[333] = 2138;
-    c[334] = 2127;
-    c[335] = 2116;
-    c[336] = 2105;
-    c[337] = 2094;
-    c[338] = 2084;
-    c[339] = 2073;
-    c[340] = 2062;
-    c[341] = 2051;
-    c[342] = 2040;
-    c[343] = 2029;
-    c[344] = 2018;
-    c[345] = 2007;
-    c[346] = 1997;
-    c[347] = 1986;
-    c[348] = 1975;
-    c[349] = 1964;
-    c[350] = 1952;
-    c[351] = 1941;
-    c[352] = 1930;
-    c[353] = 1919;
-    c[354] = 1908;
-    c[355] = 1897;
-    c[356] = 1886;
-    c[357] = 1875;
-    c[358] = 1864;
-    c[359] = 1852;
-    c[360] = 1841;
-    c[361] = 1830;
-    c[362] = 1819;
-    c[363] = 1807;
-    c[364] = 1796;
-    c[365] = 1785;
-    c[366] = 1773;
-    c[367] = 1762;
-    c[368] = 1751;
-    c[369] = 1739;
-    c[370] = 1728;
-    c[371] = 1717;
-    c[372] = 1705;
-    c[373] = 1694;
-    c[374] = 1682;
-    c[375] = 1671;
-    c[376] = 1659;
-    c[377] = 1648;
-    c[378] = 1636;
-    c[379] = 1625;
-    c[380] = 1613;
-    c[381] = 1602;
-    c[382] = 1590;
-    c[383] = 1579;
-    c[384] = 1567;
-    c[385] = 1555;
-    c[386] = 1544;
-    c[387] = 1532;
-    c[388] = 1520;
-    c[389] = 1509;
-    c[390] = 1497;
-    c[391] = 1485;
-    c[392] = 1474;
-    c[393] = 1462;
-    c[394] = 1450;
-    c[395] = 1438;
-    c[396] = 1427;
-    c[397] = 1415;
-    c[398] = 1403;
-    c[399] = 1391;
-    c[400] = 1379;
-    c[401] = 1368;
-    c[402] = 1356;
-    c[403] = 1344;
-    c[404] = 1332;
-    c[405] = 1320;
-    c[406] = 1308;
-    c[407] = 1296;
-    c[408] = 1284;
-    c[409] = 1272;
-    c[410] = 1260;
-    c[411] = 1248;
-    c[412] = 1237;
-    c[413] = 1225;
-    c[414] = 1213;
-    c[415] = 1201;
-    c[416] = 1189;
-    c[417] = 1176;
-    c[418] = 1164;
-    c[419] = 1152;
-    c[420] = 1140;
-    c[421] = 1128;
-    c[422] = 1116;
-    c[423] = 1104;
-    c[424] = 1092;
-    c[425] = 1080;
-    c[426] = 1068;
-    c[427] = 1056;
-    c[428] = 1043;
-    c[429] = 1031;
-    c[430] = 1019;
-    c[431] = 1007;
-    c[432] = 995;
-    c[433] = 983;
-    c[434] = 970;
-    c[435] = 958;
-    c[436] = 946;
-    c[437] = 934;
-    c[438] = 921;
-    c[439] = 909;
-    c[440] = 897;
-    c[441] = 885;
-    c[442] = 872;
-    c[443] = 860;
-    c[444] = 848;
-    c[445] = 836;
-    c[446] = 823;
-    c[447] = 811;
-    c[448] = 799;
-    c[449] = 786;
-    c[450] = 774;
-    c[451] = 762;
-    c[452] = 749;
-    c[453] = 737;
-    c[454] = 725;
-    c[455] = 712;
-    c[456] = 700;
-    c[457] = 687;
-    c[458] = 675;
-    c[459] = 663;
-    c[460] = 650;
-    c[461] = 638;
-    c[462] = 625;
-    c[463] = 613;
-    c[464] = 601;
-    c[465] = 588;
-    c[466] = 576;
-    c[467] = 563;
-    c[468] = 551;
-    c[469] = 538;
-    c[470] = 526;
-    c[471] = 513;
-    c[472] = 501;
-    c[473] = 488;
-    c[474] = 476;
-    c[475] = 463;
-    c[476] = 451;
-    c[477] = 438;
-    c[478] = 426;
-    c[479] = 413;
-    c[480] = 401;
-    c[481] = 388;
-    c[482] = 376;
-    c[483] = 363;
-    c[484] = 351;
-    c[485] = 338;
-    c[486] = 326;
-    c[487] = 313;
-    c[488] = 301;
-    c[489] = 288;
-    c[490] = 276;
-    c[491] = 263;
-    c[492] = 251;
-    c[493] = 238;
-    c[494] = 226;
-    c[495] = 213;
-    c[496] = 200;
-    c[497] = 188;
-    c[498] = 175;
-    c[499] = 163;
-    c[500] = 150;
-    c[501] = 138;
-    c[502] = 125;
-    c[503] = 113;
-    c[504] = 100;
-    c[505] = 87;
-    c[506] = 75;
-    c[507] = 62;
-    c[508] = 50;
-    c[509] = 37;
-    c[510] = 25;
-    c[511] = 12;
-    c[512] = 0;
-} /*enh_wind_init*/
-
-/**
- * Initializes a useful large array of random numbers
- * @param  sig_inObj : sig PU internal object of the sub-object
- * @return void
+ * @return  1 : pulses with energy remain after the next shift by hop
+ * @return  0 : all remaining pulses are silent
+ * @remarks pulses already placed are rendered again with the impulse
+ *          responses of the following frames; only when none is left can
+ *          a silent frame skip the spectral processing (see silence_frame)
  * @callgraph
  * @callergraph
  */
-static void init_rand(sig_innerobj_t *sig_inObj)
+picoos_uint8 pulses_pending(sig_innerobj_t *sig_inObj)
 {
-    picoos_int32 *q = sig_inObj->int_vec34;
-    picoos_int32 *r = sig_inObj->int_vec35;
-
-    sig_inObj->iRand = 0;
+    picoos_int16 nI;
 
-    q[0] = -2198;
-    r[0] = 3455;
-    q[1] = 3226;
-    r[1] = -2522;
-    q[2] = -845;
-    r[2] = 4007;
-    q[3] = -1227;
-    r[3] = 3907;
-    q[4] = -3480;
-    r[4] = 2158;
-    q[5] = -1325;
-    r[5] = -3875;
-    q[6] = 2089;
-    r[6] = -3522;
-    q[7] = -468;
-    r[7] = 4069;
-    q[8] = 711;
-    r[8] = -4033;
-    q[9] = 3862;
-    r[9] = 1362;
-    q[10] = 4054;
-    r[10] = -579;
-    q[11] = 2825;
-    r[11] = 2965;
-    q[12] = 2704;
-    r[12] = -3076;
-    q[13] = 4081;
-    r[13] = 344;
-    q[14] = -3912;
-    r[14] = 1211;
-    q[15] = -3541;
-    r[15] = 2058;
-    q[16] = 2694;
-    r[16] = 3084;
-    q[17] = 835;
-    r[17] = 4009;
-    q[18] = -2578;
-    r[18] = -3182;
-    q[19] = 3205;
-    r[19] = 2550;
-    q[20] = -4074;
-    r[20] = -418;
-    q[21] = -183;
-    r[21] = -4091;
-    q[22] = -2665;
-    r[22] = -3110;
-    q[23] = -1367;
-    r[23] = 3860;
-    q[24] = -2266;
-    r[24] = -3411;
-    q[25] = 3327;
-    r[25] = -2387;
-    q[26] = -2807;
-    r[26] = -2982;
-    q[27] = -3175;
-    r[27] = -2587;
-    q[28] = -4095;
-    r[28] = 27;
-    q[29] = -811;
-    r[29] = -4014;
-    q[30] = 4082;
-    r[30] = 332;
-    q[31] = -2175;
-    r[31] = 3470;
-    q[32] = 3112;
-    r[32] = 2662;
-    q[33] = 1168;
-    r[33] = -3925;
-    q[34] = 2659;
-    r[34] = 3115;
-    q[35] = 4048;
-    r[35] = 622;
-    q[36] = 4092;
-    r[36] = -165;
-    q[37] = -4036;
-    r[37] = 697;
-    q[38] = 1081;
-    r[38] = -3950;
-    q[39] = -548;
-    r[39] = 4059;
-    q[40] = 4038;
-    r[40] = 685;
-    q[41] = -511;
-    r[41] = 4063;
-    q[42] = 3317;
-    r[42] = -2402;
-    q[43] = -3180;
-    r[43] = 2580;
-    q[44] = 851;
-    r[44] = -4006;
-    q[45] = 2458;
-    r[45] = -3276;
-    q[46] = -1453;
-    r[46] = 3829;
-    q[47] = -3577;
-    r[47] = 1995;
-    q[48] = -3708;
-    r[48] = -1738;
-    q[49] = -3890;
-    r[49] = 1282;
-    q[50] = 4041;
-    r[50] = 666;
-    q[51] = -3511;
-    r[51] = -2108;
-    q[52] = -1454;
-    r[52] = -3828;
-    q[53] = 2124;
-    r[53] = 3502;
-    q[54] = -3159;
-    r[54] = 2606;
-    q[55] = 2384;
-    r[55] = -3330;
-    q[56] = -3767;
-    r[56] = -1607;
-    q[57] = -4063;
-    r[57] = -513;
-    q[58] = 3952;
-    r[58] = -1075;
-    q[59] = -3778;
-    r[59] = -1581;
-    q[60] = -301;
-    r[60] = -4084;
-    q[61] = -4026;
-    r[61] = 751;
-    q[62] = -3346;
-    r[62] = 2361;
-    q[63] = -2426;
-    r[63] = 3299;
-    q[64] = 428;
-    r[64] = -4073;
-    q[65] = 3968;
-    r[65] = 1012;
-    q[66] = 2900;
-    r[66] = -2892;
-    q[67] = -263;
-    r[67] = 4087;
-    q[68] = 4083;
-    r[68] = 322;
-    q[69] = 2024;
-    r[69] = 3560;
-    q[70] = 4015;
-    r[70] = 808;
-    q[71] = -3971;
-    r[71] = -1000;
-    q[72] = 3785;
-    r[72] = -1564;
-    q[73] = -3726;
-    r[73] = 1701;
-    q[74] = -3714;
-    r[74] = 1725;
-    q[75] = 743;
-    r[75] = 4027;
-    q[76] = 875;
-    r[76] = -4001;
-    q[77] = 294;
-    r[77] = 4085;
-    q[78] = 2611;
-    r[78] = 3155;
-    q[79] = 2491;
-    r[79] = -3251;
-    q[80] = 1558;
-    r[80] = 3787;
-    q[81] = -2063;
-    r[81] = -3538;
-    q[82] = 3809;
-    r[82] = -1505;
-    q[83] = -2987;
-    r[83] = 2802;
-    q[84] = -1955;
-    r[84] = 3599;
-    q[85] = 1980;
-    r[85] = -3585;
-    q[86] = -539;
-    r[86] = -4060;
-    q[87] = -3210;
-    r[87] = 2543;
-    q[88] = 2415;
-    r[88] = -3308;
-    q[89] = 1587;
-    r[89] = 3775;
-    q[90] = -3943;
-    r[90] = 1106;
-    q[91] = 3476;
-    r[91] = 2165;
-    q[92] = 2253;
-    r[92] = 3420;
-    q[93] = -2584;
-    r[93] = 3177;
-    q[94] = 3804;
-    r[94] = -1518;
-    q[95] = -3637;
-    r[95] = 1883;
-    q[96] = 3289;
-    r[96] = -2440;
-    q[97] = -1621;
-    r[97] = 3761;
-    q[98] = 1645;
-    r[98] = 3751;
-    q[99] = -3471;
-    r[99] = 2173;
-    q[100] = 4071;
-    r[100] = -449;
-    q[101] = -872;
-    r[101] = -4001;
-    q[102] = -3897;
-    r[102] = 1259;
-    q[103] = -3590;
-    r[103] = 1970;
-    q[104] = -2456;
-    r[104] = -3277;
-    q[105] = -3004;
-    r[105] = 2783;
-    q[106] = 2589;
-    r[106] = 3173;
-    q[107] = 3727;
-    r[107] = -1698;
-    q[108] = 2992;
-    r[108] = 2796;
-    q[109] = 794;
-    r[109] = -4018;
-    q[110] = -918;
-    r[110] = 3991;
-    q[111] = 1446;
-    r[111] = -3831;
-    q[112] = 3871;
-    r[112] = -1338;
-    q[113] = -612;
-    r[113] = -4049;
-    q[114] = -1566;
-    r[114] = -3784;
-    q[115] = 672;
-    r[115] = -4040;
-    q[116] = 3841;
-    r[116] = 1422;
-    q[117] = 3545;
-    r[117] = -2051;
-    q[118] = -1982;
-    r[118] = -3584;
-    q[119] = -3413;
-    r[119] = 2263;
-    q[120] = -3265;
-    r[120] = -2473;
-    q[121] = -2876;
-    r[121] = -2915;
-    q[122] = 4094;
-    r[122] = -117;
-    q[123] = -269;
-    r[123] = 4087;
-    q[124] = -4077;
-    r[124] = 391;
-    q[125] = -3759;
-    r[125] = 1626;
-    q[126] = 1639;
-    r[126] = 3753;
-    q[127] = 3041;
-    r[127] = -2743;
-    q[128] = 5;
-    r[128] = 4095;
-    q[129] = 2778;
-    r[129] = -3009;
-    q[130] = 1121;
-    r[130] = -3939;
-    q[131] = -455;
-    r[131] = -4070;
-    q[132] = 3532;
-    r[132] = 2073;
-    q[133] = -143;
-    r[133] = -4093;
-    q[134] = -2357;
-    r[134] = -3349;
-    q[135] = 458;
-    r[135] = 4070;
-    q[136] = -2887;
-    r[136] = -2904;
-    q[137] = -1104;
-    r[137] = 3944;
-    q[138] = -2104;
-    r[138] = -3513;
-    q[139] = 126;
-    r[139] = 4094;
-    q[140] = -3655;
-    r[140] = -1848;
-    q[141] = -3896;
-    r[141] = 1263;
-    q[142] = -3874;
-    r[142] = -1327;
-    q[143] = 4058;
-    r[143] = 553;
-    q[144] = -1831;
-    r[144] = -3663;
-    q[145] = -255;
-    r[145] = -4088;
-    q[146] = -1211;
-    r[146] = 3912;
-    q[147] = 445;
-    r[147] = 4071;
-    q[148] = 2268;
-    r[148] = 3410;
-    q[149] = -4010;
-    r[149] = 833;
-    q[150] = 2621;
-    r[150] = 3147;
-    q[151] = -250;
-    r[151] = 4088;
-    q[152] = -3409;
-    r[152] = -2269;
-    q[153] = -2710;
-    r[153] = -3070;
-    q[154] = 4063;
-    r[154] = 518;
-    q[155] = -3611;
-    r[155] = -1933;
-    q[156] = -3707;
-    r[156] = -1741;
-    q[157] = -1151;
-    r[157] = -3930;
-    q[158] = 3976;
-    r[158] = -983;
-    q[159] = -1736;
-    r[159] = 3709;
-    q[160] = 3669;
-    r[160] = 1820;
-    q[161] = -143;
-    r[161] = 4093;
-    q[162] = -3879;
-    r[162] = -1313;
-    q[163] = -2242;
-    r[163] = -3427;
-    q[164] = -4095;
-    r[164] = 0;
-    q[165] = -1159;
-    r[165] = -3928;
-    q[166] = -3155;
-    r[166] = 2611;
-    q[167] = -2887;
-    r[167] = -2904;
-    q[168] = -4095;
-    r[168] = 56;
-    q[169] = -3861;
-    r[169] = -1364;
-    q[170] = -2814;
-    r[170] = 2976;
-    q[171] = -3680;
-    r[171] = -1798;
-    q[172] = -4094;
-    r[172] = -107;
-    q[173] = -3626;
-    r[173] = 1903;
-    q[174] = 3403;
-    r[174] = 2278;
-    q[175] = -1735;
-    r[175] = -3710;
-    q[176] = -2126;
-    r[176] = -3500;
-    q[177] = 3183;
-    r[177] = -2577;
-    q[178] = -3499;
-    r[178] = 2128;
-    q[179] = -1736;
-    r[179] = 3709;
-    q[180] = 2592;
-    r[180] = -3170;
-    q[181] = 3875;
-    r[181] = 1326;
-    q[182] = 3596;
-    r[182] = 1960;
-    q[183] = 3915;
-    r[183] = -1202;
-    q[184] = 1570;
-    r[184] = 3783;
-    q[185] = -3319;
-    r[185] = -2400;
-    q[186] = 4019;
-    r[186] = 787;
-    q[187] = -187;
-    r[187] = 4091;
-    q[188] = 1370;
-    r[188] = -3859;
-    q[189] = -4091;
-    r[189] = 199;
-    q[190] = 3626;
-    r[190] = 1904;
-    q[191] = -2943;
-    r[191] = 2848;
-    q[192] = 56;
-    r[192] = 4095;
-    q[193] = 2824;
-    r[193] = 2966;
-    q[194] = -3994;
-    r[194] = -904;
-    q[195] = 56;
-    r[195] = 4095;
-    q[196] = -2045;
-    r[196] = 3548;
-    q[197] = -3653;
-    r[197] = 1850;
-    q[198] = -2864;
-    r[198] = 2927;
-    q[199] = -1996;
-    r[199] = 3576;
-    q[200] = -4061;
-    r[200] = 527;
-    q[201] = 159;
-    r[201] = 4092;
-    q[202] = -3363;
-    r[202] = 2336;
-    q[203] = -4074;
-    r[203] = 421;
-    q[204] = 2043;
-    r[204] = 3549;
-    q[205] = 4095;
-    r[205] = -70;
-    q[206] = -2107;
-    r[206] = -3512;
-    q[207] = -1973;
-    r[207] = 3589;
-    q[208] = -3138;
-    r[208] = 2631;
-    q[209] = -3625;
-    r[209] = -1905;
-    q[210] = 2413;
-    r[210] = 3309;
-    q[211] = -50;
-    r[211] = -4095;
-    q[212] = 2813;
-    r[212] = 2976;
-    q[213] = -535;
-    r[213] = -4060;
-    q[214] = 1250;
-    r[214] = 3900;
-    q[215] = 1670;
-    r[215] = -3739;
-    q[216] = 1945;
-    r[216] = -3604;
-    q[217] = -476;
-    r[217] = -4068;
-    q[218] = -3659;
-    r[218] = -1840;
-    q[219] = 2745;
-    r[219] = 3039;
-    q[220] = -674;
-    r[220] = -4040;
-    q[221] = 2383;
-    r[221] = 3330;
-    q[222] = 4086;
-    r[222] = 274;
-    q[223] = -4030;
-    r[223] = 730;
-    q[224] = 768;
-    r[224] = -4023;
-    q[225] = 3925;
-    r[225] = 1170;
-    q[226] = 785;
-    r[226] = 4019;
-    q[227] = -3101;
-    r[227] = -2675;
-    q[228] = 4030;
-    r[228] = -729;
-    q[229] = 3422;
-    r[229] = 2249;
-    q[230] = -3847;
-    r[230] = 1403;
-    q[231] = 3902;
-    r[231] = -1243;
-    q[232] = 2114;
-    r[232] = -3507;
-    q[233] = -2359;
-    r[233] = 3348;
-    q[234] = 3754;
-    r[234] = -1638;
-    q[235] = -4095;
-    r[235] = -83;
-    q[236] = 2301;
-    r[236] = -3388;
-    q[237] = 3336;
-    r[237] = 2375;
-    q[238] = -2045;
-    r[238] = 3548;
-    q[239] = -413;
-    r[239] = -4075;
-    q[240] = 1848;
-    r[240] = 3655;
-    q[241] = 4072;
-    r[241] = -437;
-    q[242] = 4069;
-    r[242] = -463;
-    q[243] = 1386;
-    r[243] = -3854;
-    q[244] = 966;
-    r[244] = 3980;
-    q[245] = -1684;
-    r[245] = -3733;
-    q[246] = 2953;
-    r[246] = 2837;
-    q[247] = -3961;
-    r[247] = -1040;
-    q[248] = 3512;
-    r[248] = -2107;
-    q[249] = 1363;
-    r[249] = 3862;
-    q[250] = 1883;
-    r[250] = 3637;
-    q[251] = 2657;
-    r[251] = 3116;
-    q[252] = 2347;
-    r[252] = -3356;
-    q[253] = -1635;
-    r[253] = -3755;
-    q[254] = 3170;
-    r[254] = 2593;
-    q[255] = 2856;
-    r[255] = 2935;
-    q[256] = 494;
-    r[256] = 4066;
-    q[257] = 1936;
-    r[257] = -3609;
-    q[258] = 245;
-    r[258] = 4088;
-    q[259] = -1211;
-    r[259] = -3912;
-    q[260] = -3600;
-    r[260] = 1952;
-    q[261] = 1632;
-    r[261] = 3756;
-    q[262] = 2341;
-    r[262] = 3360;
-    q[263] = 186;
-    r[263] = -4091;
-    q[264] = 4011;
-    r[264] = 829;
-    q[265] = -3490;
-    r[265] = -2143;
-    q[266] = 269;
-    r[266] = -4087;
-    q[267] = -2939;
-    r[267] = 2852;
-    q[268] = 1600;
-    r[268] = 3770;
-    q[269] = -3405;
-    r[269] = -2275;
-    q[270] = -3134;
-    r[270] = -2636;
-    q[271] = 2642;
-    r[271] = -3129;
-    q[272] = 3629;
-    r[272] = 1898;
-    q[273] = 3413;
-    r[273] = 2264;
-    q[274] = 2050;
-    r[274] = 3545;
-    q[275] = 988;
-    r[275] = -3975;
-    q[276] = -660;
-    r[276] = 4042;
-    q[277] = 978;
-    r[277] = -3977;
-    q[278] = 1965;
-    r[278] = -3593;
-    q[279] = -1513;
-    r[279] = -3806;
-    q[280] = -4076;
-    r[280] = 401;
-    q[281] = -4094;
-    r[281] = -92;
-    q[282] = -1914;
-    r[282] = 3621;
-    q[283] = 2006;
-    r[283] = -3570;
-    q[284] = -1550;
-    r[284] = -3791;
-    q[285] = 3774;
-    r[285] = -1591;
-    q[286] = -3958;
-    r[286] = 1052;
-    q[287] = -3576;
-    r[287] = 1997;
-    q[288] = -382;
-    r[288] = 4078;
-    q[289] = 1288;
-    r[289] = 3888;
-    q[290] = -2965;
-    r[290] = -2825;
-    q[291] = 1608;
-    r[291] = 3767;
-    q[292] = 3052;
-    r[292] = -2731;
-    q[293] = -622;
-    r[293] = 4048;
-    q[294] = -3836;
-    r[294] = 1434;
-    q[295] = -3542;
-    r[295] = 2056;
-    q[296] = -2648;
-    r[296] = 3124;
-    q[297] = -1178;
-    r[297] = -3922;
-    q[298] = -1109;
-    r[298] = 3942;
-    q[299] = 3910;
-    r[299] = 1217;
-    q[300] = 1199;
-    r[300] = -3916;
-    q[301] = -3386;
-    r[301] = 2303;
-    q[302] = -3453;
-    r[302] = 2202;
-    q[303] = -2877;
-    r[303] = 2914;
-    q[304] = 4095;
-    r[304] = -47;
-    q[305] = 3635;
-    r[305] = 1886;
-    q[306] = -2134;
-    r[306] = -3495;
-    q[307] = 613;
-    r[307] = -4049;
-    q[308] = -2700;
-    r[308] = 3079;
-    q[309] = 4091;
-    r[309] = -195;
-    q[310] = 3989;
-    r[310] = -927;
-    q[311] = -2385;
-    r[311] = 3329;
-    q[312] = 4094;
-    r[312] = -103;
-    q[313] = 1044;
-    r[313] = -3960;
-    q[314] = -1734;
-    r[314] = -3710;
-    q[315] = 1646;
-    r[315] = 3750;
-    q[316] = 575;
-    r[316] = 4055;
-    q[317] = -2629;
-    r[317] = -3140;
-    q[318] = 3266;
-    r[318] = 2471;
-    q[319] = 4091;
-    r[319] = -194;
-    q[320] = -2154;
-    r[320] = 3483;
-    q[321] = 659;
-    r[321] = 4042;
-    q[322] = -1785;
-    r[322] = -3686;
-    q[323] = -717;
-    r[323] = -4032;
-    q[324] = 4095;
-    r[324] = -37;
-    q[325] = -2963;
-    r[325] = -2827;
-    q[326] = -2645;
-    r[326] = -3126;
-    q[327] = 2619;
-    r[327] = -3148;
-    q[328] = 1855;
-    r[328] = -3651;
-    q[329] = -3726;
-    r[329] = 1699;
-    q[330] = -3437;
-    r[330] = 2227;
-    q[331] = 2948;
-    r[331] = 2842;
-    q[332] = -2125;
-    r[332] = 3501;
-    q[333] = -1700;
-    r[333] = 3726;
-    q[334] = 4094;
-    r[334] = -101;
-    q[335] = 2084;
-    r[335] = -3525;
-    q[336] = 3225;
-    r[336] = -2524;
-    q[337] = 2220;
-    r[337] = 3442;
-    q[338] = 3174;
-    r[338] = 2588;
-    q[339] = 229;
-    r[339] = -4089;
-    q[340] = -2381;
-    r[340] = -3332;
-    q[341] = -3677;
-    r[341] = -1803;
-    q[342] = -3191;
-    r[342] = -2567;
-    q[343] = 2465;
-    r[343] = 3270;
-    q[344] = 2681;
-    r[344] = -3096;
-    q[345] = 975;
-    r[345] = -3978;
-    q[346] = 2004;
-    r[346] = -3572;
-    q[347] = -3442;
-    r[347] = -2219;
-    q[348] = 3676;
-    r[348] = -1805;
-    q[349] = -3753;
-    r[349] = 1638;
-    q[350] = 3544;
-    r[350] = 2053;
-    q[351] = 397;
-    r[351] = -4076;
-    q[352] = 2221;
-    r[352] = 3440;
-    q[353] = -302;
-    r[353] = 4084;
-    q[354] = 4083;
-    r[354] = -323;
-    q[355] = -2253;
-    r[355] = -3420;
-    q[356] = -3038;
-    r[356] = 2746;
-    q[357] = 2884;
-    r[357] = 2908;
-    q[358] = 4070;
-    r[358] = 454;
-    q[359] = -1072;
-    r[359] = -3953;
-    q[360] = 3831;
-    r[360] = 1449;
-    q[361] = 3663;
-    r[361] = -1831;
-    q[362] = -1971;
-    r[362] = 3590;
-    q[363] = 3226;
-    r[363] = -2522;
-    q[364] = -145;
-    r[364] = -4093;
-    q[365] = 1882;
-    r[365] = -3637;
-    q[366] = 529;
-    r[366] = 4061;
-    q[367] = 2637;
-    r[367] = 3133;
-    q[368] = -4077;
-    r[368] = 389;
-    q[369] = 2156;
-    r[369] = -3482;
-    q[370] = -3276;
-    r[370] = 2458;
-    q[371] = -2687;
-    r[371] = -3090;
-    q[372] = 3469;
-    r[372] = -2177;
-    q[373] = -4093;
-    r[373] = -139;
-    q[374] = -850;
-    r[374] = 4006;
-    q[375] = -625;
-    r[375] = 4048;
-    q[376] = 1110;
-    r[376] = -3942;
-    q[377] = -3078;
-    r[377] = -2702;
-    q[378] = -2719;
-    r[378] = 3063;
-    q[379] = 742;
-    r[379] = 4028;
-    q[380] = -3902;
-    r[380] = -1245;
-    q[381] = 3888;
-    r[381] = -1287;
-    q[382] = -4081;
-    r[382] = 347;
-    q[383] = 1070;
-    r[383] = 3953;
-    q[384] = -996;
-    r[384] = -3972;
-    q[385] = 4041;
-    r[385] = -668;
-    q[386] = -2712;
-    r[386] = 3069;
-    q[387] = -3403;
-    r[387] = -2279;
-    q[388] = -3320;
-    r[388] = -2398;
-    q[389] = 3036;
-    r[389] = -2749;
-    q[390] = 1308;
-    r[390] = -3881;
-    q[391] = 2256;
-    r[391] = 3418;
-    q[392] = -1486;
-    r[392] = 3816;
-    q[393] = -2771;
-    r[393] = -3015;
-    q[394] = -3883;
-    r[394] = -1302;
-    q[395] = -3867;
-    r[395] = -1349;
-    q[396] = 3952;
-    r[396] = -1075;
-    q[397] = -789;
-    r[397] = 4019;
-    q[398] = 1458;
-    r[398] = 3827;
-    q[399] = 3832;
-    r[399] = -1446;
-    q[400] = -3001;
-    r[400] = -2787;
-    q[401] = 3463;
-    r[401] = 2186;
-    q[402] = 3606;
-    r[402] = 1942;
-    q[403] = 4023;
-    r[403] = 764;
-    q[404] = 3387;
-    r[404] = 2303;
-    q[405] = 2648;
-    r[405] = -3124;
-    q[406] = 1370;
-    r[406] = -3860;
-    q[407] = -3134;
-    r[407] = 2636;
-    q[408] = 4051;
-    r[408] = -600;
-    q[409] = -1977;
-    r[409] = -3587;
-    q[410] = 3160;
-    r[410] = 2605;
-    q[411] = 4042;
-    r[411] = 659;
-    q[412] = 3004;
-    r[412] = 2783;
-    q[413] = 3370;
-    r[413] = 2327;
-    q[414] = -419;
-    r[414] = -4074;
-    q[415] = -1968;
-    r[415] = 3591;
-    q[416] = -3705;
-    r[416] = -1746;
-    q[417] = -3331;
-    r[417] = -2383;
-    q[418] = -3634;
-    r[418] = 1888;
-    q[419] = -1981;
-    r[419] = -3584;
-    q[420] = 4069;
-    r[420] = -469;
-    q[421] = -628;
-    r[421] = -4047;
-    q[422] = -1900;
-    r[422] = 3628;
-    q[423] = 1039;
-    r[423] = -3961;
-    q[424] = 2554;
-    r[424] = -3201;
-    q[425] = -2955;
-    r[425] = 2836;
-    q[426] = 2286;
-    r[426] = -3398;
-    q[427] = -1624;
-    r[427] = 3760;
-    q[428] = 2213;
-    r[428] = 3446;
-    q[429] = -3989;
-    r[429] = -926;
-    q[430] = 192;
-    r[430] = -4091;
-    q[431] = -723;
-    r[431] = 4031;
-    q[432] = 2878;
-    r[432] = 2913;
-    q[433] = -2109;
-    r[433] = 3511;
-    q[434] = 1463;
-    r[434] = -3825;
-    q[435] = -741;
-    r[435] = -4028;
-    q[436] = -1314;
-    r[436] = -3879;
-    q[437] = 3115;
-    r[437] = 2659;
-    q[438] = -3160;
-    r[438] = -2605;
-    q[439] = 1868;
-    r[439] = 3644;
-    q[440] = -824;
-    r[440] = 4012;
-    q[441] = 781;
-    r[441] = 4020;
-    q[442] = -1257;
-    r[442] = -3898;
-    q[443] = 3331;
-    r[443] = -2382;
-    q[444] = 1642;
-    r[444] = -3752;
-    q[445] = 3748;
-    r[445] = -1650;
-    q[446] = -487;
-    r[446] = -4066;
-    q[447] = 3085;
-    r[447] = -2694;
-    q[448] = 4009;
-    r[448] = 839;
-    q[449] = -2308;
-    r[449] = -3383;
-    q[450] = 3850;
-    r[450] = 1397;
-    q[451] = -4078;
-    r[451] = -374;
-    q[452] = 2989;
-    r[452] = -2799;
-    q[453] = 3023;
-    r[453] = -2762;
-    q[454] = 1397;
-    r[454] = -3850;
-    q[455] = 323;
-    r[455] = 4083;
-    q[456] = 268;
-    r[456] = -4087;
-    q[457] = 2414;
-    r[457] = 3308;
-    q[458] = 3876;
-    r[458] = 1322;
-    q[459] = -3584;
-    r[459] = 1982;
-    q[460] = 1603;
-    r[460] = 3769;
-    q[461] = -1502;
-    r[461] = 3810;
-    q[462] = 1318;
-    r[462] = 3878;
-    q[463] = 1554;
-    r[463] = -3789;
-    q[464] = 2492;
-    r[464] = 3250;
-    q[465] = -4093;
-    r[465] = -154;
-    q[466] = 4008;
-    r[466] = 842;
-    q[467] = -2279;
-    r[467] = 3403;
-    q[468] = 3013;
-    r[468] = 2774;
-    q[469] = 2557;
-    r[469] = 3199;
-    q[470] = 4068;
-    r[470] = 475;
-    q[471] = 3324;
-    r[471] = -2392;
-    q[472] = 2653;
-    r[472] = -3120;
-    q[473] = 796;
-    r[473] = 4017;
-    q[474] = -1312;
-    r[474] = 3880;
-    q[475] = 1794;
-    r[475] = 3681;
-    q[476] = -2347;
-    r[476] = -3356;
-    q[477] = -4008;
-    r[477] = -840;
-    q[478] = -3773;
-    r[478] = -1592;
-    q[479] = 1609;
-    r[479] = 3766;
-    q[480] = -1564;
-    r[480] = -3785;
-    q[481] = 3004;
-    r[481] = 2784;
-    q[482] = 1258;
-    r[482] = 3897;
-    q[483] = 3729;
-    r[483] = 1693;
-    q[484] = -4095;
-    r[484] = -28;
-    q[485] = -4093;
-    r[485] = -146;
-    q[486] = 1393;
-    r[486] = -3851;
-    q[487] = 297;
-    r[487] = -4085;
-    q[488] = 2294;
-    r[488] = 3393;
-    q[489] = -2562;
-    r[489] = 3195;
-    q[490] = -1716;
-    r[490] = -3718;
-    q[491] = 2224;
-    r[491] = -3439;
-    q[492] = 2032;
-    r[492] = 3555;
-    q[493] = -2968;
-    r[493] = 2822;
-    q[494] = 2338;
-    r[494] = 3363;
-    q[495] = 1584;
-    r[495] = -3776;
-    q[496] = -3072;
-    r[496] = 2708;
-    q[497] = -1596;
-    r[497] = -3771;
-    q[498] = -2256;
-    r[498] = -3418;
-    q[499] = 4095;
-    r[499] = 89;
-    q[500] = -1949;
-    r[500] = 3602;
-    q[501] = 1844;
-    r[501] = 3657;
-    q[502] = -3375;
-    r[502] = 2319;
-    q[503] = -1481;
-    r[503] = -3818;
-    q[504] = 3228;
-    r[504] = -2520;
-    q[505] = 1116;
-    r[505] = 3940;
-    q[506] = -2783;
-    r[506] = 3004;
-    q[507] = 3915;
-    r[507] = 1201;
-    q[508] = 283;
-    r[508] = 4086;
-    q[509] = -3732;
-    r[509] = 1685;
-    q[510] = -433;
-    r[510] = -4072;
-    q[511] = -3667;
-    r[511] = 1823;
-    q[512] = 3883;
-    r[512] = 1300;
-    q[513] = -3742;
-    r[513] = 1663;
-    q[514] = 4093;
-    r[514] = -143;
-    q[515] = 3874;
-    r[515] = 1328;
-    q[516] = -3800;
-    r[516] = 1528;
-    q[517] = -1257;
-    r[517] = 3898;
-    q[518] = -1606;
-    r[518] = 3767;
-    q[519] = 3394;
-    r[519] = 2291;
-    q[520] = 2255;
-    r[520] = 3419;
-    q[521] = -4094;
-    r[521] = 120;
-    q[522] = -3767;
-    r[522] = 1606;
-    q[523] = 1849;
-    r[523] = -3654;
-    q[524] = -2883;
-    r[524] = 2908;
-    q[525] = 3469;
-    r[525] = 2176;
-    q[526] = 2654;
-    r[526] = 3119;
-    q[527] = -239;
-    r[527] = 4088;
-    q[528] = -651;
-    r[528] = 4043;
-    q[529] = -1140;
-    r[529] = 3934;
-    q[530] = 328;
-    r[530] = -4082;
-    q[531] = 3246;
-    r[531] = 2497;
-    q[532] = 4026;
-    r[532] = -753;
-    q[533] = -2041;
-    r[533] = -3550;
-    q[534] = -1154;
-    r[534] = 3929;
-    q[535] = -2710;
-    r[535] = 3070;
-    q[536] = -2860;
-    r[536] = 2932;
-    q[537] = 2097;
-    r[537] = 3517;
-    q[538] = 3492;
-    r[538] = -2140;
-    q[539] = 3123;
-    r[539] = 2649;
-    q[540] = 3360;
-    r[540] = 2342;
-    q[541] = 2498;
-    r[541] = 3245;
-    q[542] = 3976;
-    r[542] = 982;
-    q[543] = -2441;
-    r[543] = -3288;
-    q[544] = 3601;
-    r[544] = 1951;
-    q[545] = -4008;
-    r[545] = -842;
-    q[546] = 1243;
-    r[546] = 3902;
-    q[547] = 4069;
-    r[547] = 466;
-    q[548] = -2031;
-    r[548] = 3556;
-    q[549] = 4077;
-    r[549] = 386;
-    q[550] = -3112;
-    r[550] = -2663;
-    q[551] = 4087;
-    r[551] = -262;
-    q[552] = 4087;
-    r[552] = 266;
-    q[553] = -3907;
-    r[553] = -1228;
-    q[554] = -1611;
-    r[554] = 3765;
-    q[555] = 3066;
-    r[555] = -2715;
-    q[556] = 2657;
-    r[556] = 3117;
-    q[557] = 3912;
-    r[557] = -1213;
-    q[558] = -2531;
-    r[558] = -3220;
-    q[559] = 3500;
-    r[559] = -2127;
-    q[560] = -76;
-    r[560] = -4095;
-    q[561] = 3413;
-    r[561] = -2264;
-    q[562] = -4071;
-    r[562] = -448;
-    q[563] = 828;
-    r[563] = 4011;
-    q[564] = 3664;
-    r[564] = 1830;
-    q[565] = -1578;
-    r[565] = 3779;
-    q[566] = 3555;
-    r[566] = 2033;
-    q[567] = 3868;
-    r[567] = -1345;
-    q[568] = 4054;
-    r[568] = -580;
-    q[569] = -4094;
-    r[569] = 124;
-    q[570] = -3820;
-    r[570] = -1477;
-    q[571] = -3658;
-    r[571] = -1842;
-    q[572] = 2595;
-    r[572] = 3168;
-    q[573] = 3354;
-    r[573] = 2350;
-    q[574] = -701;
-    r[574] = -4035;
-    q[575] = -772;
-    r[575] = -4022;
-    q[576] = 2799;
-    r[576] = 2990;
-    q[577] = -3632;
-    r[577] = 1893;
-    q[578] = 310;
-    r[578] = 4084;
-    q[579] = 3984;
-    r[579] = -947;
-    q[580] = 3794;
-    r[580] = -1542;
-    q[581] = -2419;
-    r[581] = 3304;
-    q[582] = -3916;
-    r[582] = 1200;
-    q[583] = -3886;
-    r[583] = 1292;
-    q[584] = -3299;
-    r[584] = 2426;
-    q[585] = -437;
-    r[585] = 4072;
-    q[586] = 2053;
-    r[586] = -3544;
-    q[587] = 3987;
-    r[587] = 937;
-    q[588] = -789;
-    r[588] = -4019;
-    q[589] = 4055;
-    r[589] = -575;
-    q[590] = -3894;
-    r[590] = 1270;
-    q[591] = 4003;
-    r[591] = -864;
-    q[592] = -3060;
-    r[592] = 2721;
-    q[593] = -4009;
-    r[593] = 836;
-    q[594] = -1655;
-    r[594] = -3746;
-    q[595] = 3954;
-    r[595] = -1067;
-    q[596] = -773;
-    r[596] = 4022;
-    q[597] = -422;
-    r[597] = 4074;
-    q[598] = -3384;
-    r[598] = 2306;
-    q[599] = 195;
-    r[599] = -4091;
-    q[600] = -298;
-    r[600] = 4085;
-    q[601] = -3988;
-    r[601] = 931;
-    q[602] = 2014;
-    r[602] = -3566;
-    q[603] = 3349;
-    r[603] = -2357;
-    q[604] = 3800;
-    r[604] = 1526;
-    q[605] = 3858;
-    r[605] = 1374;
-    q[606] = 2947;
-    r[606] = 2844;
-    q[607] = -1483;
-    r[607] = -3818;
-    q[608] = 4056;
-    r[608] = -565;
-    q[609] = 2612;
-    r[609] = -3154;
-    q[610] = 2326;
-    r[610] = 3371;
-    q[611] = -3545;
-    r[611] = 2051;
-    q[612] = -1001;
-    r[612] = -3971;
-    q[613] = 3211;
-    r[613] = 2541;
-    q[614] = -2717;
-    r[614] = 3065;
-    q[615] = -3159;
-    r[615] = -2606;
-    q[616] = 2869;
-    r[616] = -2922;
-    q[617] = -1290;
-    r[617] = -3887;
-    q[618] = 2479;
-    r[618] = 3260;
-    q[619] = 3420;
-    r[619] = 2252;
-    q[620] = 1823;
-    r[620] = 3667;
-    q[621] = 3368;
-    r[621] = 2330;
-    q[622] = -3819;
-    r[622] = -1480;
-    q[623] = 3800;
-    r[623] = 1528;
-    q[624] = 3773;
-    r[624] = 1594;
-    q[625] = -189;
-    r[625] = -4091;
-    q[626] = -4067;
-    r[626] = -485;
-    q[627] = 2277;
-    r[627] = -3404;
-    q[628] = -4089;
-    r[628] = -233;
-    q[629] = -3634;
-    r[629] = 1889;
-    q[630] = 3292;
-    r[630] = 2437;
-    q[631] = -530;
-    r[631] = 4061;
-    q[632] = -3109;
-    r[632] = 2666;
-    q[633] = -3741;
-    r[633] = 1667;
-    q[634] = -1903;
-    r[634] = -3626;
-    q[635] = 3879;
-    r[635] = -1315;
-    q[636] = 4083;
-    r[636] = -315;
-    q[637] = -1148;
-    r[637] = 3931;
-    q[638] = 2630;
-    r[638] = 3139;
-    q[639] = -4001;
-    r[639] = 876;
-    q[640] = -2295;
-    r[640] = -3392;
-    q[641] = 1090;
-    r[641] = -3948;
-    q[642] = -3024;
-    r[642] = 2762;
-    q[643] = 2728;
-    r[643] = -3054;
-    q[644] = -3305;
-    r[644] = 2419;
-    q[645] = 60;
-    r[645] = 4095;
-    q[646] = 4048;
-    r[646] = -620;
-    q[647] = 589;
-    r[647] = -4053;
-    q[648] = -3867;
-    r[648] = 1347;
-    q[649] = -2944;
-    r[649] = -2847;
-    q[650] = -2721;
-    r[650] = 3060;
-    q[651] = 2928;
-    r[651] = 2863;
-    q[652] = 801;
-    r[652] = 4016;
-    q[653] = -3644;
-    r[653] = 1870;
-    q[654] = -1648;
-    r[654] = -3749;
-    q[655] = 825;
-    r[655] = -4012;
-    q[656] = -2036;
-    r[656] = -3553;
-    q[657] = -1192;
-    r[657] = -3918;
-    q[658] = 2875;
-    r[658] = 2916;
-    q[659] = -1831;
-    r[659] = -3663;
-    q[660] = -2865;
-    r[660] = -2926;
-    q[661] = -575;
-    r[661] = -4055;
-    q[662] = -3870;
-    r[662] = 1340;
-    q[663] = -4080;
-    r[663] = -356;
-    q[664] = -2176;
-    r[664] = -3469;
-    q[665] = -2986;
-    r[665] = -2803;
-    q[666] = 3978;
-    r[666] = -972;
-    q[667] = 2437;
-    r[667] = 3291;
-    q[668] = -3528;
-    r[668] = 2080;
-    q[669] = -3300;
-    r[669] = -2425;
-    q[670] = 3085;
-    r[670] = 2693;
-    q[671] = -3700;
-    r[671] = -1756;
-    q[672] = 3216;
-    r[672] = -2535;
-    q[673] = 4094;
-    r[673] = -91;
-    q[674] = 3775;
-    r[674] = -1589;
-    q[675] = 1097;
-    r[675] = -3946;
-    q[676] = -152;
-    r[676] = -4093;
-    q[677] = -3490;
-    r[677] = 2142;
-    q[678] = 3747;
-    r[678] = 1654;
-    q[679] = -1490;
-    r[679] = -3815;
-    q[680] = -3998;
-    r[680] = -886;
-    q[681] = 3726;
-    r[681] = -1700;
-    q[682] = -1600;
-    r[682] = 3770;
-    q[683] = -87;
-    r[683] = 4095;
-    q[684] = 2538;
-    r[684] = -3214;
-    q[685] = -4095;
-    r[685] = 52;
-    q[686] = -3993;
-    r[686] = -910;
-    q[687] = 4051;
-    r[687] = 603;
-    q[688] = -1242;
-    r[688] = -3902;
-    q[689] = 2155;
-    r[689] = 3482;
-    q[690] = 1270;
-    r[690] = 3893;
-    q[691] = 1919;
-    r[691] = -3618;
-    q[692] = -3145;
-    r[692] = 2623;
-    q[693] = 2475;
-    r[693] = 3263;
-    q[694] = 2226;
-    r[694] = -3437;
-    q[695] = -3894;
-    r[695] = -1269;
-    q[696] = -429;
-    r[696] = 4073;
-    q[697] = -1346;
-    r[697] = 3868;
-    q[698] = 1297;
-    r[698] = 3885;
-    q[699] = 1699;
-    r[699] = 3726;
-    q[700] = -3375;
-    r[700] = 2319;
-    q[701] = 1577;
-    r[701] = -3779;
-    q[702] = -63;
-    r[702] = 4095;
-    q[703] = 1215;
-    r[703] = -3911;
-    q[704] = -1492;
-    r[704] = 3814;
-    q[705] = -1530;
-    r[705] = -3799;
-    q[706] = 3442;
-    r[706] = 2218;
-    q[707] = -3867;
-    r[707] = -1349;
-    q[708] = -3291;
-    r[708] = -2437;
-    q[709] = -2253;
-    r[709] = -3420;
-    q[710] = -150;
-    r[710] = -4093;
-    q[711] = -2686;
-    r[711] = -3092;
-    q[712] = 3470;
-    r[712] = 2175;
-    q[713] = -3826;
-    r[713] = -1461;
-    q[714] = -3148;
-    r[714] = 2619;
-    q[715] = -3858;
-    r[715] = 1375;
-    q[716] = -3844;
-    r[716] = -1412;
-    q[717] = -3652;
-    r[717] = 1854;
-    q[718] = 4018;
-    r[718] = -791;
-    q[719] = 179;
-    r[719] = -4092;
-    q[720] = 3498;
-    r[720] = 2129;
-    q[721] = -1999;
-    r[721] = -3574;
-    q[722] = 3531;
-    r[722] = 2075;
-    q[723] = 4050;
-    r[723] = -606;
-    q[724] = -1639;
-    r[724] = 3753;
-    q[725] = -3661;
-    r[725] = 1835;
-    q[726] = 4039;
-    r[726] = 679;
-    q[727] = 3561;
-    r[727] = 2023;
-    q[728] = 528;
-    r[728] = 4061;
-    q[729] = -634;
-    r[729] = -4046;
-    q[730] = 364;
-    r[730] = -4079;
-    q[731] = 2735;
-    r[731] = 3048;
-    q[732] = 3978;
-    r[732] = 973;
-    q[733] = -4073;
-    r[733] = -427;
-    q[734] = -3722;
-    r[734] = 1708;
-    q[735] = 2356;
-    r[735] = -3350;
-    q[736] = -1125;
-    r[736] = -3938;
-    q[737] = 4054;
-    r[737] = 580;
-    q[738] = 3328;
-    r[738] = -2387;
-    q[739] = 1439;
-    r[739] = -3834;
-    q[740] = 1746;
-    r[740] = 3705;
-    q[741] = 2507;
-    r[741] = 3238;
-    q[742] = 3839;
-    r[742] = -1427;
-    q[743] = 488;
-    r[743] = -4066;
-    q[744] = 1187;
-    r[744] = 3920;
-    q[745] = 2038;
-    r[745] = -3552;
-    q[746] = -905;
-    r[746] = -3994;
-    q[747] = -236;
-    r[747] = 4089;
-    q[748] = 208;
-    r[748] = -4090;
-    q[749] = 1660;
-    r[749] = 3744;
-    q[750] = -4074;
-    r[750] = -415;
-    q[751] = -2304;
-    r[751] = 3385;
-    q[752] = -2457;
-    r[752] = 3276;
-    q[753] = 3302;
-    r[753] = 2423;
-    q[754] = 1778;
-    r[754] = -3689;
-    q[755] = 2019;
-    r[755] = 3563;
-    q[756] = 4037;
-    r[756] = 687;
-    q[757] = -2365;
-    r[757] = 3343;
-    q[758] = 5;
-    r[758] = -4095;
-    q[759] = 160;
-    r[759] = -4092;
-
-} /*initRand*/
+    for (nI = 0; nI < sig_inObj->nV; nI++) {
+        if ((sig_inObj->EnV[nI] != 0)
+                && (sig_inObj->LocV[nI] >= sig_inObj->hop_p)) {
+            return 1;
+        }
+    }
+    for (nI = 0; nI < sig_inObj->nU; nI++) {
+        if ((sig_inObj->EnU[nI] != 0)
+                && (sig_inObj->LocU[nI] >= sig_inObj->hop_p)) {
+            return 1;
+        }
+    }
+    return 0;
+}/*pulses_pending*/
 
 /**
- * initializes the MEL-2_LINEAR LOOKUP TABLE
- * @param   sig_inObj : sig PU internal object of the sub-object
+ * synthesizes an unvoiced frame of zero energy without spectral processing
+ * @param    sig_inObj : sig PU internal object of the sub-object
  * @return  void
- * @remarks translated from matlab code to c-code
+ * @remarks replaces the steps from save_transition_frame to overlap_add
+ *          when no pulse with energy is pending (pulses_pending) and the
+ *          frame and the previous one are unvoiced: the excitation points,
+ *          the random phase pointer and the overlap-add tail in sig_vec1
+ *          are advanced as the full processing with E=0 would, so that
+ *          the tail of the preceding sound is still output and the frames
+ *          after the silence are not affected
  * @callgraph
  * @callergraph
- *
- *  input
- *  - bilinTab : base address of bilinTable destination vector
- *  - alpha : warping factor
- *  - size : size of the vectors to be generated
- *  - A,B : base address of array of indexes for lookup table implementation
- *  - D : base address of delta array for lookup table implementation
- *
- *  output
- *  - bilinTab, A, B, D  : initialized vectors
  */
-void mel_2_lin_init(sig_innerobj_t *sig_inObj)
+void silence_frame(sig_innerobj_t *sig_inObj)
 {
+    picoos_int32 *t1, *t2, *v1;
 
-    /*Declare variables tied to  I/O PARAMS formerly passed by value or reference*/
-    picoos_single alpha;
-    picoos_int32 *D;
-    picoos_int32 size;
-    picoos_int16 *A;
-
-    /*Link local variables with sig data object*/
+    /* random phase table pointer, as in phase_spec2 for unvoiced frames */
+    sig_inObj->iRand += (PICODSP_HFFTSIZE_P1 - 1);
+    if (sig_inObj->iRand > PICODSP_N_RAND_TABLE - PICODSP_HFFTSIZE_P1)
+        sig_inObj->iRand = 1 + sig_inObj->iRand + PICODSP_HFFTSIZE_P1
+            - PICODSP_N_RAND_TABLE;
 
-    alpha = sig_inObj->warp_p;
-    size = (sig_inObj->hfftsize_p) + 1;
-    A = sig_inObj->A_p;
-    D = sig_inObj->d_p;
-    /*
-     fixed point interpolation tables
-     scaling factor: 0x20
-     corresponding bit shift: 5
-     */
+    /* shift the signal vector as in td_psola2, no pulse is added */
+    v1 = sig_inObj->sig_vec1;
+    t1 = v1;
+    FAST_DEVICE(PICODSP_FFTSIZE-PICODSP_DISPLACE,*(t1++)=0;);
+    t1 = &(v1[PICODSP_FFTSIZE - PICODSP_DISPLACE]);
+    t2 = &(v1[PICODSP_FFTSIZE]);
+    FAST_DEVICE(PICODSP_FFTSIZE, *(t1++)=*(t2++););
+    t1 = &(v1[2 * PICODSP_FFTSIZE - PICODSP_DISPLACE]);FAST_DEVICE(PICODSP_DISPLACE,*(t1++)=0;);
+    sig_inObj->E_p = 0;
+    get_simple_excitation(sig_inObj, &(sig_inObj->nextPeak_p));
+    sig_inObj->kernels->shiftRight(v1, PICODSP_SHIFT_FACT5, PICODSP_FFTSIZE);
 
-    A[0] = 0;
-    D[0] = 0;
-    A[1] = 2;
-    D[1] = 14;
-    A[2] = 4;
-    D[2] = 29;
-    A[3] = 7;
-    D[3] = 11;
-    A[4] = 9;
-    D[4] = 24;
-    A[5] = 12;
-    D[5] = 5;
-    A[6] = 14;
-    D[6] = 18;
-    A[7] = 16;
-    D[7] = 30;
-    A[8] = 19;
-    D[8] = 9;
-    A[9] = 21;
-    D[9] = 19;
-    A[10] = 23;
-    D[10] = 29;
-    A[11] = 26;
-    D[11] = 5;
-    A[12] = 28;
-    D[12] = 12;
-    A[13] = 30;
-    D[13] = 19;
-    A[14] = 32;
-    D[14] = 24;
-    A[15] = 34;
-    D[15] = 27;
-    A[16] = 36;
-    D[16] = 30;
-    A[17] = 38;
-    D[17] = 31;
-    A[18] = 40;
-    D[18] = 31;
-    A[19] = 42;
-    D[19] = 29;
-    A[20] = 44;
-    D[20] = 26;
-    A[21] = 46;
-    D[21] = 22;
-    A[22] = 48;
-    D[22] = 17;
-    A[23] = 50;
-    D[23] = 10;
-    A[24] = 52;
-    D[24] = 2;
-    A[25] = 53;
-    D[25] = 24;
-    A[26] = 55;
-    D[26] = 13;
-    A[27] = 57;
-    D[27] = 1;
-    A[28] = 58;
-    D[28] = 20;
-    A[29] = 60;
-    D[29] = 5;
-    A[30] = 61;
-    D[30] = 21;
-    A[31] = 63;
-    D[31] = 4;
-    A[32] = 64;
-    D[32] = 18;
-    A[33] = 65;
-    D[33] = 31;
-    A[34] = 67;
-    D[34] = 11;
-    A[35] = 68;
-    D[35] = 21;
-    A[36] = 69;
-    D[36] = 31;
-    A[37] = 71;
-    D[37] = 7;
-    A[38] = 72;
-    D[38] = 14;
-    A[39] = 73;
-    D[39] = 21;
-    A[40] = 74;
-    D[40] = 27;
-    A[41] = 75;
-    D[41] = 31;
-    A[42] = 77;
-    D[42] = 3;
-    A[43] = 78;
-    D[43] = 6;
-    A[44] = 79;
-    D[44] = 8;
-    A[45] = 80;
-    D[45] = 10;
-    A[46] = 81;
-    D[46] = 10;
-    A[47] = 82;
-    D[47] = 10;
-    A[48] = 83;
-    D[48] = 9;
-    A[49] = 84;
-    D[49] = 8;
-    A[50] = 85;
-    D[50] = 6;
-    A[51] = 86;
-    D[51] = 3;
-    A[52] = 86;
-    D[52] = 31;
-    A[53] = 87;
-    D[53] = 27;
-    A[54] = 88;
-    D[54] = 23;
-    A[55] = 89;
-    D[55] = 18;
-    A[56] = 90;
-    D[56] = 12;
-    A[57] = 91;
-    D[57] = 6;
-    A[58] = 91;
-    D[58] = 31;
-    A[59] = 92;
-    D[59] = 24;
-    A[60] = 93;
-    D[60] = 16;
-    A[61] = 94;
-    D[61] = 8;
-    A[62] = 94;
-    D[62] = 31;
-    A[63] = 95;
-    D[63] = 22;
-    A[64] = 96;
-    D[64] = 13;
-    A[65] = 97;
-    D[65] = 3;
-    A[66] = 97;
-    D[66] = 25;
-    A[67] = 98;
-    D[67] = 14;
-    A[68] = 99;
-    D[68] = 3;
-    A[69] = 99;
-    D[69] = 24;
-    A[70] = 100;
-    D[70] = 13;
-    A[71] = 101;
-    D[71] = 1;
-    A[72] = 101;
-    D[72] = 21;
-    A[73] = 102;
-    D[73] = 8;
-    A[74] = 102;
-    D[74] = 27;
-    A[75] = 103;
-    D[75] = 14;
-    A[76] = 104;
-    D[76] = 1;
-    A[77] = 104;
-    D[77] = 19;
-    A[78] = 105;
-    D[78] = 6;
-    A[79] = 105;
-    D[79] = 24;
-    A[80] = 106;
-    D[80] = 9;
-    A[81] = 106;
-    D[81] = 27;
-    A[82] = 107;
-    D[82] = 12;
-    A[83] = 107;
-    D[83] = 29;
-    A[84] = 108;
-    D[84] = 14;
-    A[85] = 108;
-    D[85] = 31;
-    A[86] = 109;
-    D[86] = 15;
-    A[87] = 109;
-    D[87] = 31;
-    A[88] = 110;
-    D[88] = 16;
-    A[89] = 110;
-    D[89] = 31;
-    A[90] = 111;
-    D[90] = 15;
-    A[91] = 111;
-    D[91] = 31;
-    A[92] = 112;
-    D[92] = 14;
-    A[93] = 112;
-    D[93] = 30;
-    A[94] = 113;
-    D[94] = 13;
-    A[95] = 113;
-    D[95] = 28;
-    A[96] = 114;
-    D[96] = 11;
-    A[97] = 114;
-    D[97] = 26;
-    A[98] = 115;
-    D[98] = 9;
-    A[99] = 115;
-    D[99] = 23;
-    A[100] = 116;
-    D[100] = 6;
-    A[101] = 116;
-    D[101] = 20;
-    A[102] = 117;
-    D[102] = 2;
-    A[103] = 117;
-    D[103] = 16;
-    A[104] = 117;
-    D[104] = 31;
-    A[105] = 118;
-    D[105] = 13;
-    A[106] = 118;
-    D[106] = 27;
-    A[107] = 119;
-    D[107] = 8;
-    A[108] = 119;
-    D[108] = 22;
-    A[109] = 120;
-    D[109] = 4;
-    A[110] = 120;
-    D[110] = 17;
-    A[111] = 120;
-    D[111] = 31;
-    A[112] = 121;
-    D[112] = 13;
-    A[113] = 121;
-    D[113] = 26;
-    A[114] = 122;
-    D[114] = 8;
-    A[115] = 122;
-    D[115] = 21;
-    A[116] = 123;
-    D[116] = 2;
-    A[117] = 123;
-    D[117] = 15;
-    A[118] = 123;
-    D[118] = 29;
-    A[119] = 124;
-    D[119] = 10;
-    A[120] = 124;
-    D[120] = 23;
-    A[121] = 125;
-    D[121] = 4;
-    A[122] = 125;
-    D[122] = 17;
-    A[123] = 125;
-    D[123] = 31;
-    A[124] = 126;
-    D[124] = 12;
-    A[125] = 126;
-    D[125] = 25;
-    A[126] = 127;
-    D[126] = 6;
-    A[127] = 127;
-    D[127] = 19;
-    A[128] = 128;
-    D[128] = 0;
-
-}/*mel_2_lin_init*/
+    overlap_add(sig_inObj);
+}/*silence_frame*/
 
+/*-------------------------------------------------------------------------------
+ INITIALIZATION AND INTERNAL    FUNCTIONS
+ --------------------------------------------------------------------------------*/
 /**
  * function to be documented
  * @param    ang : ??
@@ -3928,8 +1860,8 @@ void mel_2_lin_init(sig_innerobj_t *sig_inObj)
  * @callgraph
  * @callergraph
  */
-static void get_trig(picoos_int32 ang, picoos_int32 *table, picoos_int32 *cs,
-        picoos_int32 *sn)
+static void get_trig(picoos_int32 ang, const picoos_int32 *table,
+        picoos_int32 *cs, picoos_int32 *sn)
 {
     picoos_int32 i, j, k;
 
@@ -4017,10 +1949,12 @@ static void get_simple_excitation(sig_innerobj_t *sig_inObj,
     /* picoos_single    InvSqrt3=(picoos_single)2/(picoos_single)sqrt(3.0); *//*constant*/
     picoos_int32 Ti, sqrtTi;
     picoos_int16 hop, winlen, Fs;
-    picoos_single E, F0;
+    pico_param_t E, F0;
     picoos_int16 voiced;
+#if !defined(PICO_FIXED_POINT_ENABLED)
     picoos_single fact; /*normalization factor*/
     picoos_single rounding = 0.5f;
+#endif
 
     /*Link local variables to sig object*/
     hop = sig_inObj->hop_p;
@@ -4030,7 +1964,8 @@ static void get_simple_excitation(sig_innerobj_t *sig_inObj,
     F0 = sig_inObj->F0_p;
     voiced = sig_inObj->voiced_p;
 
-    E = (E > 5) ? 9 : (E > 1) ? 2 * E - 1 : E;
+    E = (E > PICO_PARAM(5)) ? PICO_PARAM(9) : (E > PICO_PARAM(1)) ? 2 * E
+            - PICO_PARAM(1) : E;
 
 
     /* shift previous excitation window by hop samples*/
@@ -4065,13 +2000,29 @@ static void get_simple_excitation(sig_innerobj_t *sig_inObj,
     *nextPeak -= hop;
     k = *nextPeak;
 
+#if defined(PICO_FIXED_POINT_ENABLED)
+    /*period Fs / F and amplitude E * sqrt(Fs / (hop * F)) * 3 * PICODSP_GETEXC_K1,
+      with F the pitch of voiced frames, else the unrectified pitch (Q12)*/
+    F0 = (voiced == 0) ? sig_inObj->Fuv_p : F0;
+    if (F0 < 1) {
+        F0 = 1;
+    }
+    Ti = (((picoos_int32) Fs << PICO_PARAM_SHIFT) + F0 / 2) / F0;
+    sqrtTi = (picoos_int32) pico_fix_sqrt64(((uint64_t) Fs << (3
+            * PICO_PARAM_SHIFT)) / ((uint64_t) hop * F0)); /*Q12*/
+    sqrtTi = (picoos_int32) (((int64_t) E * sqrtTi * 3 * PICODSP_GETEXC_K1)
+            >> (2 * PICO_PARAM_SHIFT));
+#else
     fact = 3;
+#endif
     if (voiced == 0) { /*Unvoiced*/
 
+#if !defined(PICO_FIXED_POINT_ENABLED)
         Ti = (picoos_int32) (rounding + (picoos_single) Fs
                 / (picoos_single) sig_inObj->Fuv_p); /* round Period*/
         sqrtTi = (picoos_int32) (E * sqrt((double) Fs
                 / (hop * sig_inObj->Fuv_p)) * fact * PICODSP_GETEXC_K1);
+#endif
         while (k < winlen) {
             if (k < winlen) {
                 sig_inObj->LocU[sig_inObj->nU] = k;
@@ -4081,12 +2032,14 @@ static void get_simple_excitation(sig_innerobj_t *sig_inObj,
             }
         }
     } else { /*Voiced*/
+#if !defined(PICO_FIXED_POINT_ENABLED)
         Ti
                 = (picoos_int32) (rounding + (picoos_single) Fs
                         / (picoos_single) F0); /*Period*/
         sqrtTi = (picoos_int32) (E
                 * sqrt((double) Fs / (hop * sig_inObj->F0_p)) * fact
                 * PICODSP_GETEXC_K1);
+#endif
         while (k < winlen) {
             sig_inObj->LocV[sig_inObj->nV] = k;
             sig_inObj->EnV[sig_inObj->nV] = sqrtTi;
@@ -31,6 +31,8 @@
 
 #include "picoos.h"
 #include "picodsp.h"
+#include "picosigk.h"
+#include "picofftsg.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -39,6 +41,43 @@ extern "C" {
 }
 #endif
 
+/*math profiles (voice option PICORSRC_VOPT_SIG_MATH): the exponentials
+  of the envelope amplitudes (env_spec) and of the pitch (sigGetFrame) by
+  picoos_quick_exp and exp (fixed point: pico_fix_exp_quick and
+  pico_fix_exp), by exp only (pico_fix_exp), or the amplitudes by the
+  expShift kernel (pico_fix_exp_fast) and the pitch by exp*/
+#define PICOSIG_MATH_DEFAULT 0
+#define PICOSIG_MATH_PRECISE 1
+#define PICOSIG_MATH_FAST    2
+
+/*maximum number of frames processed together, see sigAllocateBatch*/
+#define PICOSIG_MAX_BATCH   8
+/*entries of the phase history ring: PHASE_BUFF_SIZE for every frame of a batch*/
+#define PHASE_RING_SIZE     (PHASE_BUFF_SIZE + PICOSIG_MAX_BATCH - 1)
+/*bytes of the buffers of a batch slot (sig_frame) allocated by sigAllocateBatch*/
+#define PICOSIG_SLOT_SIZE   (sizeof(picoos_int32) \
+        * (4 * PICODSP_FFTSIZE + 3 * PICODSP_HFFTSIZE_P1))
+
+/*----------------------------------------------------------
+ // Name    :   sig_frame
+ // Function:   buffers and values of one frame of a batch: the ones that
+ //             the spectral steps (mel_2_lin_lookup to impulse_response)
+ //             produce and consume for a frame
+ // Shortcut:   sig
+ //---------------------------------------------------------*/
+typedef struct sig_frame
+{
+    picoos_int32 *wcep;     /*wcep_pI*/
+    picoos_int32 *ang;      /*ang_p*/
+    picoos_int32 *outCos;   /*outCosTbl*/
+    picoos_int32 *outSin;   /*outSinTbl*/
+    picoos_int32 *Fr, *Fi;  /*F2r_p, F2i_p*/
+    picoos_int32 *imp;      /*imp_p*/
+    pico_param_t F0, Fuv, vcg, E; /*F0_p, Fuv_p, voicing, E_p*/
+    picoos_int16 voiced, prevVoiced, phId;
+    picoos_int16 phsHead;   /*phsHead when the frame was read, for phase_spec2*/
+} sig_frame_t;
+
 /*----------------------------------------------------------
  // Name    :   sig_innerobj
  // Function:   innerobject definition for the sig processing
@@ -48,57 +87,51 @@ typedef struct sig_innerobj
 {
 
     /*-----------------------Definition of the local storage for this PU--------*/
-    picoos_int16 *idx_vect1; /*reserved for bit reversal tables*/
-    picoos_int16 *idx_vect2; /*reserved for table lookup "A" vector*/
-    picoos_int16 *idx_vect4; /*reserved for max peak index arrax in pchip*/
-    picoos_int16 *idx_vect5; /*reserved for min index arrax in sigana_singleIMF*/
-    picoos_int16 *idx_vect6; /*reserved for max index arrax in sigana_singleIMF*/
-    picoos_int16 *idx_vect7; /*reserved for dispersed phase */
+    const picoos_int16 *idx_vect2; /*reserved for table lookup "A" vector (shared)*/
     picoos_int16 *idx_vect8; /*reserved for LocV*/
     picoos_int16 *idx_vect9; /*reserved for LocU*/
 
-    picoos_int32 *int_vec22; /*reserved for normalized hanning window - fixed point */
+    const picoos_int32 *int_vec22; /*reserved for normalized hanning window - fixed point (shared) */
     picoos_int32 *int_vec23; /*reserved for impresp  - fixed point */
     picoos_int32 *int_vec24; /*reserved for impresp  - fixed point */
-    picoos_int32 *int_vec25; /*reserved for window  - fixed point */
+    const picoos_int32 *int_vec25; /*reserved for window  - fixed point (shared) */
     picoos_int32 *int_vec26; /*reserved for wavBuf  - fixed point */
     picoos_int32 *int_vec28; /*reserved for cepstral vectors input - fixed point */
-    picoos_int32 *int_vec29; /*reserved for cepstral vectors input - fixed point */
-    picoos_int32 *int_vec38; /*reserved for cepstral vectors input - fixed point */
+    const picoos_int32 *int_vec38; /*reserved for table lookup "D" vector - fixed point (shared) */
     picoos_int32 *int_vec30; /*reserved for cepstral vectors input - fixed point */
     picoos_int32 *int_vec31; /*reserved for cepstral vectors input - fixed point */
 
     picoos_int32 *int_vec32; /*reserved for cepstral vectors input - fixed point */
     picoos_int32 *int_vec33; /*reserved for cepstral vectors input - fixed point */
 
-    picoos_int32 *int_vec34; /* reserved for sin table- fixed point */
-    picoos_int32 *int_vec35; /* reserved for cos table - fixed point */
+    const picoos_int32 *int_vec34; /* reserved for random cos table - fixed point (shared) */
+    const picoos_int32 *int_vec35; /* reserved for random sin table - fixed point (shared) */
     picoos_int32 *int_vec36; /* reserved for currently used sin table- fixed point */
     picoos_int32 *int_vec37; /* reserved for currently used cos table - fixed point */
 
     picoos_int32 *int_vec39; /* reserved for ang - fixed point */
-    picoos_int32 *int_vec40; /* reserved for cos table - fixed point */
+    const picoos_int32 *int_vec40; /* reserved for cos table - fixed point (shared) */
 
     picoos_int32 *int_vec41[CEPST_BUFF_SIZE]; /*reserved for phase smoothing - cepstrum buffers */
-    picoos_int32 *int_vec42[PHASE_BUFF_SIZE]; /*reserved for phase smoothing - phase buffers */
+    picoos_int32 *int_vec42[PHASE_RING_SIZE]; /*reserved for phase smoothing - phase buffers */
 
     picoos_int16 idx_vect10[CEPST_BUFF_SIZE]; /*reserved for pitch value buffering before phase smoothing*/
     picoos_int16 idx_vect11[CEPST_BUFF_SIZE]; /*reserved for phonetic value bufferingid before phase smoothing*/
     picoos_int16 idx_vect12[CEPST_BUFF_SIZE]; /*reserved for voicing value bufferingbefore phase smoothing*/
     picoos_int16 idx_vect13[CEPST_BUFF_SIZE]; /*reserved for unrectified pitch value bufferingbefore phase smoothing*/
-    picoos_int16 idx_vect14[PHASE_BUFF_SIZE]; /*reserved for vox_bnd value buffering before phase smoothing*/
+    picoos_int16 idx_vect14[PHASE_RING_SIZE]; /*reserved for vox_bnd value buffering before phase smoothing*/
 
     picoos_int32 *sig_vec1;
 
     picoos_single bvalue1; /*reserved for warp*/
     picoos_int32 ibvalue2; /*reserved for voxbnd*/
     picoos_int32 ibvalue3; /*reserved for voxbnd2*/
-    picoos_single bvalue4; /*reserved for E*/
-    picoos_single bvalue5; /*reserved for F0*/
-    picoos_single bvalue6; /*reserved for sMod*/
+    pico_param_t bvalue4; /*reserved for E*/
+    pico_param_t bvalue5; /*reserved for F0*/
+    pico_param_t bvalue6; /*reserved for sMod*/
 
-    picoos_single bvalue7; /*reserved for voicing*/
-    picoos_single bvalue8; /*reserved for unrectified pitch*/
+    pico_param_t bvalue7; /*reserved for voicing*/
+    pico_param_t bvalue8; /*reserved for unrectified pitch*/
 
     picoos_int16 ivalue1; /*reserved for m1,ceporder*/
     picoos_int16 ivalue2; /*reserved for m2,fftorder,windowlen*/
@@ -123,6 +156,10 @@ typedef struct sig_innerobj
 
     picoos_int16 ivalue20; /*reserved for n_availabe index*/
 
+    picoos_int16 cepHead; /*oldest entry of the CEPST_BUFF_SIZE history buffers*/
+    picoos_int16 phsHead; /*oldest entry of the PHASE_BUFF_SIZE history buffers*/
+    picoos_int16 phsSize; /*entries of these, more than PHASE_BUFF_SIZE with batches*/
+
     picoos_int32 lvalue1; /*reserved for sampling rate*/
     picoos_int32 lvalue2; /*reserved for VCutoff*/
     picoos_int32 lvalue3; /*reserved for UVCutoff*/
@@ -130,6 +167,16 @@ typedef struct sig_innerobj
 
     picoos_int32 iRand; /*reserved for phase random table poointer ())*/
 
+    const picosigk_kernels_t *kernels; /*vector kernels, see picosigk.h*/
+    picoos_int16 mathMode; /*math profile, PICOSIG_MATH_**/
+    const picofftsg_backend_t *fft; /*FFT and DCT backend, see picofftsg.h*/
+    picoos_int32 *voiceTables; /*tables of sigAllocateVoice, NULL if none*/
+    const picoos_int32 *noiseGain; /*noise shaping gain per bin (Q12), NULL: flat*/
+
+    sig_frame_t frame[PICOSIG_MAX_BATCH + 1]; /*slots of batched frames, see sigSelectFrame*/
+    picoos_int16 nSlots; /*number of slots, 1 without batches*/
+    picoos_int16 lastSlot; /*slot of the last frame synthesized*/
+
 } sig_innerobj_t;
 
 /*------------------------------------------------------------------
@@ -140,14 +187,24 @@ extern pico_status_t sigAllocate(picoos_MemoryManager mm,
         sig_innerobj_t *sig_inObj);
 extern void sigDeallocate(picoos_MemoryManager mm, sig_innerobj_t *sig_inObj);
 extern void sigDspInitialize(sig_innerobj_t *sig_inObj, picoos_int32 resetMode);
+extern pico_status_t sigAllocateBatch(picoos_MemoryManager mm,
+        sig_innerobj_t *sig_inObj, picoos_int16 frames);
+extern void sigDeallocateBatch(picoos_MemoryManager mm, sig_innerobj_t *sig_inObj);
+extern picoos_objsize_t sigVoiceMemSize(picoos_int32 formantShift,
+        picoos_int32 noiseGains);
+extern pico_status_t sigAllocateVoice(picoos_MemoryManager mm,
+        sig_innerobj_t *sig_inObj, picoos_int32 formantShift,
+        picoos_int32 noiseGains);
+extern void sigDeallocateVoice(picoos_MemoryManager mm, sig_innerobj_t *sig_inObj);
+extern void sigSelectFrame(sig_innerobj_t *sig_inObj, picoos_int16 slot,
+        picoos_uint8 values);
+extern void sigStoreFrame(sig_innerobj_t *sig_inObj, picoos_int16 slot);
 
 /*------------------------------------------------------------------
  Exported (to picosig.c) Processing routines :
  routine number, name and content can be changed. unique I/O parameter should be  "sig"
  ------------------------------------------------------------------*/
-extern void mel_2_lin_init(sig_innerobj_t *sig_inObj);
 extern void save_transition_frame(sig_innerobj_t *sig_inObj);
-extern void mel_2_lin_init(sig_innerobj_t *sig_inObj);
 extern void post_filter_init(sig_innerobj_t *sig_inObj);
 extern void mel_2_lin_lookup(sig_innerobj_t *sig_inObj, picoos_uint32 mgc);
 extern void post_filter(sig_innerobj_t *sig_inObj);
@@ -157,6 +214,8 @@ extern void save_transition_frame(sig_innerobj_t *sig_inObj);
 extern void td_psola2(sig_innerobj_t *sig_inObj);
 extern void impulse_response(sig_innerobj_t *sig_inObj);
 extern void overlap_add(sig_innerobj_t *sig_inObj);
+extern picoos_uint8 pulses_pending(sig_innerobj_t *sig_inObj);
+extern void silence_frame(sig_innerobj_t *sig_inObj);
 
 /* -------------------------------------------------------------------
  * symbolic vs area assignements
@@ -194,8 +253,8 @@ extern void overlap_add(sig_innerobj_t *sig_inObj);
 #define UVCutoff_p  lvalue3         /*unvoicing cut off frequency in Hz*/
 /* Reusable area */
 #define wcep_pI     int_vec28       /*input step1*/
-#define d_p         int_vec38       /*output mel_2_lin_init  : table lookup  vector D*/
-#define A_p         idx_vect2       /*output mel_2_lin_init  : table lookup  vector A*/
+#define d_p         int_vec38       /*mel_2_lin_lookup : table lookup  vector D*/
+#define A_p         idx_vect2       /*mel_2_lin_lookup : table lookup  vector A*/
 #define ang_p       int_vec39       /*output step4*/
 #define EnV         int_vec30
 #define EnU         int_vec31
@@ -221,6 +280,21 @@ extern void overlap_add(sig_innerobj_t *sig_inObj);
 
 #define n_available   ivalue20      /*variable for indexing the incoming buffers*/
 
+/*The history buffers above are ring buffers: instead of shifting them by
+  one entry per frame, the head moves and the oldest entry is overwritten
+  by the newest. Entry k (0 = oldest) of F0Buff, PhIdBuff, VoicingBuff,
+  FuVBuff and CepBuff is at index CEPST_RING(s, k), entry k of VoxBndBuff
+  and PhsBuff at index PHASE_RING(s, k), s being the sig_innerobj_t. The
+  phase ring is longer with batches (phsSize entries), where the phases
+  of a frame are used after the following frames of the batch have been
+  read: entry k of the PHASE_BUFF_SIZE entries of the current frame is
+  at index PHASE_HIST(s, k)*/
+#define CEPST_RING(s, k) ((((s)->cepHead + (k)) < CEPST_BUFF_SIZE) \
+        ? ((s)->cepHead + (k)) : ((s)->cepHead + (k) - CEPST_BUFF_SIZE))
+#define PHASE_RING(s, k) ((((s)->phsHead + (k)) < (s)->phsSize) \
+        ? ((s)->phsHead + (k)) : ((s)->phsHead + (k) - (s)->phsSize))
+#define PHASE_HIST(s, k) PHASE_RING(s, (s)->phsSize - PHASE_BUFF_SIZE + (k))
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2024 PicoTTS Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * @file picosigenc.c
+ *
+ * Output encoders of the signal generation
+ *
+ * The IMA ADPCM encoder quantizes the difference between a sample and
+ * the predicted one into a sign and three magnitude bits relative to the
+ * current step size; the predictor follows the decoder's reconstruction
+ * and the step index moves through the 89 step sizes by the magnitude.
+ */
+
+#include "picodefs.h"
+#include "picoos.h"
+#include "picodbg.h"
+#include "picosigk.h"
+#include "picosigenc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if 0
+}
+#endif
+
+#define PICOSIGENC_NUM_STEPS    89
+
+static const picoos_int16 sigencStep[PICOSIGENC_NUM_STEPS] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+/* step index change by the three magnitude bits of a code */
+static const picoos_int8 sigencIndexStep[8] = {
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+picoos_bool picosigenc_isSupportedFormat(picoos_int32 format)
+{
+    return (PICO_DATA_PCM_16BIT == format) || (PICO_DATA_ULAW_8BIT == format)
+            || (PICO_DATA_ALAW_8BIT == format)
+            || (PICO_DATA_IMA_ADPCM_4BIT == format)
+#if !defined(PICO_FIXED_POINT_ENABLED)
+            || (PICO_DATA_FLOAT_32BIT == format)
+#endif
+            ;
+}
+
+void picosigenc_initialize(picosigenc_encoder_t *this, picoos_int16 format,
+        const picosigk_kernels_t *kernels)
+{
+    this->format = format;
+    this->kernels = kernels;
+    picosigenc_reset(this);
+}
+
+void picosigenc_reset(picosigenc_encoder_t *this)
+{
+    this->predictor = 0;
+    this->index = 0;
+    this->pending = -1;
+}
+
+/* IMA ADPCM code of sample 's', updates the state */
+static picoos_uint8 sigencAdpcm(picosigenc_encoder_t *this, picoos_int32 s)
+{
+    picoos_int32 step, diff, vpdiff;
+    picoos_uint8 code;
+
+    step = sigencStep[this->index];
+    diff = s - this->predictor;
+    code = 0;
+    if (diff < 0) {
+        code = 8;
+        diff = -diff;
+    }
+    vpdiff = step >> 3;
+    if (diff >= step) {
+        code |= 4;
+        diff -= step;
+        vpdiff += step;
+    }
+    step >>= 1;
+    if (diff >= step) {
+        code |= 2;
+        diff -= step;
+        vpdiff += step;
+    }
+    step >>= 1;
+    if (diff >= step) {
+        code |= 1;
+        vpdiff += step;
+    }
+    if (code & 8) {
+        this->predictor -= vpdiff;
+        if (this->predictor < -32768) {
+            this->predictor = -32768;
+        }
+    } else {
+        this->predictor += vpdiff;
+        if (this->predictor > 32767) {
+            this->predictor = 32767;
+        }
+    }
+    this->index += sigencIndexStep[code & 7];
+    if (this->index < 0) {
+        this->index = 0;
+    } else if (this->index >= PICOSIGENC_NUM_STEPS) {
+        this->index = PICOSIGENC_NUM_STEPS - 1;
+    }
+    return code;
+}
+
+picoos_int16 picosigenc_encode(picosigenc_encoder_t *this,
+        const picoos_int16 *in, picoos_int16 numSamples, picoos_uint8 *out)
+{
+    picoos_int16 i, numBytes;
+    picoos_uint8 code;
+#if !defined(PICO_FIXED_POINT_ENABLED)
+    picoos_single f;
+#endif
+
+    switch (this->format) {
+        case PICO_DATA_ULAW_8BIT:
+            this->kernels->ulaw(in, out, numSamples);
+            return numSamples;
+        case PICO_DATA_ALAW_8BIT:
+            this->kernels->alaw(in, out, numSamples);
+            return numSamples;
+        case PICO_DATA_IMA_ADPCM_4BIT:
+            numBytes = 0;
+            for (i = 0; i < numSamples; i++) {
+                code = sigencAdpcm(this, in[i]);
+                if (this->pending < 0) {
+                    this->pending = code;
+                } else {
+                    out[numBytes++] = (picoos_uint8) (this->pending | (code << 4));
+                    this->pending = -1;
+                }
+            }
+            return numBytes;
+#if !defined(PICO_FIXED_POINT_ENABLED)
+        case PICO_DATA_FLOAT_32BIT:
+            /*items are not aligned to floats in the output buffer*/
+            for (i = 0; i < numSamples; i++) {
+                f = in[i] * (1.0f / 32768.0f);
+                picoos_mem_copy(&f, &(out[i * sizeof(picoos_single)]),
+                        sizeof(picoos_single));
+            }
+            return numSamples * sizeof(picoos_single);
+#endif
+        default:
+            picoos_mem_copy(in, out, numSamples * sizeof(picoos_int16));
+            return numSamples * sizeof(picoos_int16);
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/* end picosigenc.c */
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2024 PicoTTS Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * @file picosigenc.h
+ *
+ * Output encoders of the signal generation
+ *
+ * With the voice option PICORSRC_VOPT_SIG_FORMAT the signal generation
+ * puts G.711 mu-law or A-law bytes (PICO_DATA_ULAW_8BIT,
+ * PICO_DATA_ALAW_8BIT) or IMA ADPCM nibbles (PICO_DATA_IMA_ADPCM_4BIT)
+ * into the FRAME items instead of 16 bit PCM, so no encoding pass is
+ * needed downstream and the items carry a half or a quarter of the
+ * bytes.
+ *
+ * G.711 follows the ITU-T G.191 reference (14 bit mu-law, 13 bit A-law
+ * input) and is done by the ulaw and alaw kernels of the SIG vector
+ * kernels (see picosigk.h): a 256 entry segment table in the scalar
+ * kernels, 16 entry byte shuffle tables in the SSE4.1 and AVX2 kernels
+ * (some 8 and 15 times faster than scalar) and leading zeros in the
+ * NEON kernels.
+ *
+ * IMA ADPCM is the table driven IMA/DVI algorithm with the state
+ * (predictor, step index) carried from item to item; each sample
+ * depends on the one before, so it is not vectorized. Two samples make
+ * a byte: an odd sample at the end of the samples given is kept and
+ * goes out with the next ones.
+ *
+ * 32 bit float (PICO_DATA_FLOAT_32BIT) is not encoded from 16 bit
+ * samples where it can be avoided: at 16kHz the signal generation
+ * scales the overlap-add buffer straight to float, with the volume and
+ * without clipping (see sigPutFrame in picosig.c). The encoder converts
+ * the samples that only exist as 16 bit, i.e. those of the resampler
+ * and of played files. Not in fixed point builds, which have no
+ * floating point in the signal generation.
+ *
+ * Timing against encoding afterwards: picobench encode, picobench float
+ */
+
+#ifndef PICOSIGENC_H_
+#define PICOSIGENC_H_
+
+#include "picodefs.h"
+#include "picoapi.h"
+#include "picoos.h"
+#include "picosigk.h"
+#include "picofixedpoint.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if 0
+}
+#endif
+
+typedef struct picosigenc_encoder {
+    picoos_int16 format;        /* PICO_DATA_* */
+    const picosigk_kernels_t *kernels;
+    /* IMA ADPCM state */
+    picoos_int32 predictor;
+    picoos_int16 index;
+    picoos_int16 pending;       /* low nibble of the next byte, -1 if none */
+} picosigenc_encoder_t;
+
+/* TRUE if 'format' (PICO_DATA_*) is an output format of the signal
+   generation; PICO_DATA_PCM_16BIT is, PICO_DATA_FLOAT_32BIT is not with
+   PICO_FIXED_POINT_ENABLED */
+picoos_bool picosigenc_isSupportedFormat(picoos_int32 format);
+
+/* sets up 'this' for 'format' with the G.711 kernels of 'kernels' and
+   resets it */
+void picosigenc_initialize(picosigenc_encoder_t *this, picoos_int16 format,
+        const picosigk_kernels_t *kernels);
+
+/* resets the ADPCM state and drops a pending sample */
+void picosigenc_reset(picosigenc_encoder_t *this);
+
+/* encodes 'numSamples' samples from 'in' to 'out' and returns the number
+   of bytes written, at most 2 * numSamples (16 bit PCM is copied),
+   4 * numSamples for float */
+picoos_int16 picosigenc_encode(picosigenc_encoder_t *this,
+        const picoos_int16 *in, picoos_int16 numSamples, picoos_uint8 *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*PICOSIGENC_H_*/
@@ -0,0 +1,1203 @@
+/*
+ * Copyright (C) 2024 PicoTTS Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * @file picosigk.c
+ *
+ * Vector kernels of the signal generation
+ *
+ * All kernels compute exactly what the scalar reference computes:
+ * integer products and sums wrap in the same way, the sign-symmetric
+ * shifts are done on absolute values, the division goes through double
+ * precision (exact for int32 operands after truncation) and the
+ * interpolation does the same single precision operations in the same
+ * order. With fixed point (PICO_USE_FIXED_POINT) the interpolation and
+ * the RMS value are integer only, and all sets use the scalar
+ * interpolation.
+ */
+
+#include <math.h>
+
+#include "picodefs.h"
+#include "picoos.h"
+#include "picodsp.h"
+#include "picofftsg.h"
+#include "picosigk.h"
+
+#if defined(PICO_USE_SIG_SIMD) && (defined(__GNUC__) || defined(__clang__)) \
+        && (defined(__x86_64__) || defined(__i386__))
+#define PICOSIGK_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(PICO_USE_SIG_SIMD) && defined(__aarch64__) && defined(__ARM_NEON)
+#define PICOSIGK_ARM_NEON 1
+#include <arm_neon.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if 0
+}
+#endif
+
+/* ****************************************************************************
+ *   scalar reference
+ * ****************************************************************************/
+
+static void sigkMac(picoos_int32 *v, const picoos_int32 *x, picoos_int32 f,
+        picoos_int32 n)
+{
+    if (n > 0) FAST_DEVICE(n, *(v++) += *(x++) * f;);
+}
+
+static void sigkMacReverse(picoos_int32 *v, const picoos_int32 *x,
+        picoos_int32 f, picoos_int32 n)
+{
+    if (n > 0) FAST_DEVICE(n, *(v--) += *(x++) * f;);
+}
+
+static void sigkShiftRight(picoos_int32 *v, picoos_int32 s, picoos_int32 n)
+{
+    picoos_int32 i;
+
+    for (i = 0; i < n; i++, v++) {
+        if (*v >= 0)
+            *v >>= s;
+        else
+            *v = -((-*v) >> s);
+    }
+}
+
+static void sigkAddShiftLeft(picoos_int32 *w, const picoos_int32 *v,
+        picoos_int32 s, picoos_int32 n)
+{
+    if (n > 0) FAST_DEVICE(n,
+        if (*v >= 0)
+          *(w++)+=*(v++)<<s;
+        else
+          *(w++)+=-(-*(v++)<<s);
+        );
+}
+
+static void sigkDivide(picoos_int32 *v, picoos_int32 d, picoos_int32 n)
+{
+    if (n > 0) FAST_DEVICE(n, *(v++) /= d;);
+}
+
+static pico_param_t sigkNormResult(picoos_int32 n, picoos_int32 *x,
+        const picoos_int32 *window)
+{
+    return norm_result(n, x, window);
+}
+
+static void sigkMelToLin(picoos_int32 *x, const picoos_int16 *A,
+        const picoos_int32 *D, picoos_int32 n)
+{
+    picoos_int32 i, k, term1, term2, delta;
+
+    for (i = 1; i < n; i++) {
+        k = A[i];
+        term2 = x[k];
+        term1 = x[k + 1];
+        delta = term1 - term2;
+#if defined(PICO_FIXED_POINT_ENABLED)
+        x[i] = term2 + (picoos_int32)(((int64_t)D[i] * delta) / 32);
+#else
+        x[i] = term2 + (((picoos_single)D[i] * (picoos_single)delta) / 32);
+#endif
+    }
+}
+
+static void sigkMulShift(picoos_int32 *y, const picoos_int32 *x,
+        const picoos_int32 *g, picoos_int32 s, picoos_int32 n)
+{
+    picoos_int32 i, p;
+
+    for (i = 0; i < n; i++) {
+        p = x[i] * g[i];
+        y[i] = (p >= 0) ? (p >> s) : -((-p) >> s);
+    }
+}
+
+static picoos_int32 sigkDot16(const picoos_int16 *x, const picoos_int16 *h,
+        picoos_int32 n)
+{
+    picoos_int32 i, acc;
+
+    acc = 0;
+    for (i = 0; i < n; i++) {
+        acc += (picoos_int32) x[i] * h[i];
+    }
+    return acc;
+}
+
+static void sigkExpShift(picoos_int32 *y, const picoos_int32 *x,
+        picoos_int32 s, picoos_int32 n)
+{
+    picoos_int32 i, a, t, e, f, p;
+
+    /* pico_fix_exp_fast without the cases of s < 13 and of overflow:
+       2^n < 2^29 */
+    for (i = 0; i < n; i++) {
+        a = ((x[i] >> (s - 13)) + 1) >> 1;
+        a = (a > PICO_FIX_EXP_FAST_MAX) ? PICO_FIX_EXP_FAST_MAX : a;
+        a = (a < -PICO_FIX_EXP_FAST_MAX) ? -PICO_FIX_EXP_FAST_MAX : a;
+        t = a * 23637 + ((a * 473) >> 12);
+        f = (t & 0x3FFFFFF) >> 11;
+        p = ((PICO_FIX_EXP_FAST_C3 * f + 16384) >> 15) + PICO_FIX_EXP_FAST_C2;
+        p = ((p * f + 16384) >> 15) + PICO_FIX_EXP_FAST_C1;
+        p = ((p * f + 16384) >> 15) + 32768;
+        e = (t >> 26) - 15;
+        y[i] = (e >= 0) ? (p << e) : ((e <= -31) ? 0 : (p >> -e));
+    }
+}
+
+/* G.711 segment of a magnitude shifted right by 5 (mu-law, 14 bit) or 4
+   (A-law, 13 bit): 0 for 0 and 1, else the position of the highest bit */
+static const picoos_uint8 sigkSegment[256] = {
+    0, 0, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+    5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7
+};
+
+static void sigkUlaw(const picoos_int16 *x, picoos_uint8 *y, picoos_int32 n)
+{
+    picoos_int32 i, s, sign, seg;
+
+    for (i = 0; i < n; i++) {
+        s = x[i] >> 2;
+        sign = 0x00;
+        if (s < 0) {
+            sign = 0x80;
+            s = -s;
+        }
+        if (s > 8158) {
+            s = 8158;
+        }
+        s += 33;
+        seg = sigkSegment[s >> 5];
+        y[i] = (picoos_uint8) ~(sign | (seg << 4) | ((s >> (seg + 1)) & 0x0f));
+    }
+}
+
+static void sigkAlaw(const picoos_int16 *x, picoos_uint8 *y, picoos_int32 n)
+{
+    picoos_int32 i, s, mask, seg;
+
+    for (i = 0; i < n; i++) {
+        s = x[i] >> 3;
+        mask = 0xd5;
+        if (s < 0) {
+            mask = 0x55;
+            s = ~s;
+        }
+        seg = sigkSegment[s >> 4];
+        y[i] = (picoos_uint8) (((seg << 4) | ((s >> ((seg > 0) ? seg : 1)) & 0x0f)) ^ mask);
+    }
+}
+
+#if defined(PICOSIGK_X86) || defined(PICOSIGK_ARM_NEON)
+/* RMS value from the energy sum of the vector kernels, as in norm_result */
+static pico_param_t sigkRms(picoos_int32 E, picoos_int32 n)
+{
+    if (E > 0) {
+#if defined(PICO_FIXED_POINT_ENABLED)
+        return (pico_param_t)(pico_fix_sqrt64((uint64_t)E << 20)/n);
+#else
+        return (picoos_single)sqrt((double)E/16.0)/n;
+#endif
+    }
+    return 0;
+}
+#endif
+
+/* with fixed point all kernel sets interpolate in integers (sigkMelToLin),
+   the vector versions work in single precision */
+#if defined(PICO_FIXED_POINT_ENABLED)
+#define SIGK_MELTOLIN(f) sigkMelToLin
+#else
+#define SIGK_MELTOLIN(f) f
+#endif
+
+static const picosigk_kernels_t sigkScalar = {
+    "scalar",
+    sigkMac,
+    sigkMacReverse,
+    sigkShiftRight,
+    sigkAddShiftLeft,
+    sigkDivide,
+    sigkNormResult,
+    sigkMelToLin,
+    sigkMulShift,
+    sigkDot16,
+    sigkUlaw,
+    sigkAlaw,
+    sigkExpShift
+};
+
+#if defined(PICOSIGK_X86)
+
+/* ****************************************************************************
+ *   SSE4.1
+ * ****************************************************************************/
+
+#define SIGK_SSE41 __attribute__((target("sse4.1")))
+
+SIGK_SSE41 static void sigkMacSse41(picoos_int32 *v, const picoos_int32 *x,
+        picoos_int32 f, picoos_int32 n)
+{
+    __m128i vf = _mm_set1_epi32(f);
+    picoos_int32 i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m128i p = _mm_mullo_epi32(_mm_loadu_si128((const __m128i *)(x + i)), vf);
+        _mm_storeu_si128((__m128i *)(v + i),
+                _mm_add_epi32(_mm_loadu_si128((const __m128i *)(v + i)), p));
+    }
+    for (; i < n; i++) {
+        v[i] += x[i] * f;
+    }
+}
+
+SIGK_SSE41 static void sigkMacReverseSse41(picoos_int32 *v,
+        const picoos_int32 *x, picoos_int32 f, picoos_int32 n)
+{
+    __m128i vf = _mm_set1_epi32(f);
+    picoos_int32 i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m128i p = _mm_mullo_epi32(_mm_loadu_si128((const __m128i *)(x + i)), vf);
+        p = _mm_shuffle_epi32(p, _MM_SHUFFLE(0, 1, 2, 3));
+        _mm_storeu_si128((__m128i *)(v - i - 3),
+                _mm_add_epi32(_mm_loadu_si128((const __m128i *)(v - i - 3)), p));
+    }
+    for (; i < n; i++) {
+        v[-i] += x[i] * f;
+    }
+}
+
+SIGK_SSE41 static void sigkShiftRightSse41(picoos_int32 *v, picoos_int32 s,
+        picoos_int32 n)
+{
+    __m128i cnt = _mm_cvtsi32_si128(s);
+    picoos_int32 i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(v + i));
+        __m128i r = _mm_srl_epi32(_mm_abs_epi32(a), cnt);
+        _mm_storeu_si128((__m128i *)(v + i), _mm_sign_epi32(r, a));
+    }
+    sigkShiftRight(v + i, s, n - i);
+}
+
+SIGK_SSE41 static void sigkAddShiftLeftSse41(picoos_int32 *w,
+        const picoos_int32 *v, picoos_int32 s, picoos_int32 n)
+{
+    __m128i cnt = _mm_cvtsi32_si128(s);
+    picoos_int32 i;
+
+    /* -((-v) << s) is v << s in two's complement */
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m128i a = _mm_sll_epi32(_mm_loadu_si128((const __m128i *)(v + i)), cnt);
+        _mm_storeu_si128((__m128i *)(w + i),
+                _mm_add_epi32(_mm_loadu_si128((const __m128i *)(w + i)), a));
+    }
+    sigkAddShiftLeft(w + i, v + i, s, n - i);
+}
+
+SIGK_SSE41 static void sigkDivideSse41(picoos_int32 *v, picoos_int32 d,
+        picoos_int32 n)
+{
+    __m128d vd = _mm_set1_pd((double) d);
+    picoos_int32 i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(v + i));
+        __m128i lo = _mm_cvttpd_epi32(_mm_div_pd(_mm_cvtepi32_pd(a), vd));
+        __m128i hi = _mm_cvttpd_epi32(_mm_div_pd(
+                _mm_cvtepi32_pd(_mm_unpackhi_epi64(a, a)), vd));
+        _mm_storeu_si128((__m128i *)(v + i), _mm_unpacklo_epi64(lo, hi));
+    }
+    for (; i < n; i++) {
+        v[i] /= d;
+    }
+}
+
+SIGK_SSE41 static pico_param_t sigkNormResultSse41(picoos_int32 n,
+        picoos_int32 *x, const picoos_int32 *window)
+{
+    __m128i acc = _mm_setzero_si128();
+    picoos_int32 i, E;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m128i t = _mm_loadu_si128((const __m128i *)(x + i));
+        __m128i w = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)(window + i)), 18);
+        __m128i a = _mm_mullo_epi32(w, _mm_sign_epi32(_mm_srli_epi32(_mm_abs_epi32(t), 11), t));
+        __m128i b = _mm_srli_epi32(_mm_abs_epi32(a), 18);
+        _mm_storeu_si128((__m128i *)(x + i), a);
+        acc = _mm_add_epi32(acc, _mm_mullo_epi32(b, b));
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    E = _mm_cvtsi128_si32(acc);
+    for (; i < n; i++) {
+        picoos_int32 a, b;
+        a = (window[i]>>18) * ((x[i]>0) ? x[i]>>11 : -((-x[i])>>11));
+        x[i] = a;
+        b = (a>=0?a:-a)  >> 18;
+        E += (b*b);
+    }
+    return sigkRms(E, n);
+}
+
+#if !defined(PICO_FIXED_POINT_ENABLED)
+SIGK_SSE41 static void sigkMelToLinSse41(picoos_int32 *x, const picoos_int16 *A,
+        const picoos_int32 *D, picoos_int32 n)
+{
+    const __m128 v32 = _mm_set1_ps(32.0f);
+    picoos_int32 i;
+
+    /* x[i] is only read at indexes >= i: all reads of a block see the
+       values before the block is written, as in the scalar loop */
+    for (i = 1; i + 4 <= n; i += 4) {
+        __m128i t2 = _mm_setr_epi32(x[A[i]], x[A[i + 1]], x[A[i + 2]], x[A[i + 3]]);
+        __m128i t1 = _mm_setr_epi32(x[A[i] + 1], x[A[i + 1] + 1], x[A[i + 2] + 1],
+                x[A[i + 3] + 1]);
+        __m128 p = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)(D + i))),
+                _mm_cvtepi32_ps(_mm_sub_epi32(t1, t2)));
+        __m128 r = _mm_add_ps(_mm_cvtepi32_ps(t2), _mm_div_ps(p, v32));
+        _mm_storeu_si128((__m128i *)(x + i), _mm_cvttps_epi32(r));
+    }
+    for (; i < n; i++) {
+        picoos_int32 k = A[i], term2 = x[k], delta = x[k + 1] - term2;
+        x[i] = term2 + (((picoos_single)D[i] * (picoos_single)delta) / 32);
+    }
+}
+#endif
+
+SIGK_SSE41 static void sigkMulShiftSse41(picoos_int32 *y,
+        const picoos_int32 *x, const picoos_int32 *g, picoos_int32 s,
+        picoos_int32 n)
+{
+    __m128i cnt = _mm_cvtsi32_si128(s);
+    picoos_int32 i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m128i p = _mm_mullo_epi32(_mm_loadu_si128((const __m128i *)(x + i)),
+                _mm_loadu_si128((const __m128i *)(g + i)));
+        __m128i r = _mm_srl_epi32(_mm_abs_epi32(p), cnt);
+        _mm_storeu_si128((__m128i *)(y + i), _mm_sign_epi32(r, p));
+    }
+    sigkMulShift(y + i, x + i, g + i, s, n - i);
+}
+
+SIGK_SSE41 static picoos_int32 sigkDot16Sse41(const picoos_int16 *x,
+        const picoos_int16 *h, picoos_int32 n)
+{
+    __m128i acc = _mm_setzero_si128();
+    picoos_int32 i, r;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(
+                _mm_loadu_si128((const __m128i *)(x + i)),
+                _mm_loadu_si128((const __m128i *)(h + i))));
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4e));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xb1));
+    r = _mm_cvtsi128_si32(acc);
+    for (; i < n; i++) {
+        r += (picoos_int32) x[i] * h[i];
+    }
+    return r;
+}
+
+/* G.711 with 16 entry tables (pshufb): the segment of a magnitude is
+   the larger one looked up by its 4 bits above the lowest segment
+   (sigkSegment) and by the bits above those (sigkSegmentHigh); the
+   mantissa is the magnitude shifted right by segment + 1 (mu-law) or by
+   the segment but at least 1 (A-law), i.e. the high half of its product
+   with a power of two whose high byte is looked up by the segment */
+static const picoos_uint8 sigkSegmentHigh[16] = {
+    0, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7, 7, 7, 7, 7
+};
+static const picoos_uint8 sigkUlawMult[16] = {
+    0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01, 0, 0, 0, 0, 0, 0, 0, 0
+};
+static const picoos_uint8 sigkAlawMult[16] = {
+    0x80, 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/* segment and mantissa of 8 magnitudes, the 4 bits above the lowest
+   segment starting at bit 'lo' */
+SIGK_SSE41 static inline __m128i sigkG711Sse41(__m128i mag, int lo,
+        const picoos_uint8 *mult)
+{
+    __m128i seg, m;
+
+    seg = _mm_max_epi16(
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) sigkSegmentHigh),
+                    _mm_srl_epi16(mag, _mm_cvtsi32_si128(lo + 4))),
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) sigkSegment),
+                    _mm_and_si128(_mm_srl_epi16(mag, _mm_cvtsi32_si128(lo)),
+                            _mm_set1_epi16(0x0f))));
+    m = _mm_slli_epi16(_mm_shuffle_epi8(
+            _mm_loadu_si128((const __m128i *) mult), seg), 8);
+    return _mm_or_si128(_mm_slli_epi16(seg, 4),
+            _mm_and_si128(_mm_mulhi_epu16(mag, m), _mm_set1_epi16(0x0f)));
+}
+
+/* mu-law codes of 8 samples in the low bytes of the lanes */
+SIGK_SSE41 static inline __m128i sigkUlaw8Sse41(__m128i x)
+{
+    __m128i mag, r;
+
+    mag = _mm_add_epi16(_mm_min_epi16(_mm_abs_epi16(_mm_srai_epi16(x, 2)),
+            _mm_set1_epi16(8158)), _mm_set1_epi16(33));
+    r = _mm_or_si128(sigkG711Sse41(mag, 5, sigkUlawMult),
+            _mm_and_si128(_mm_srai_epi16(x, 15), _mm_set1_epi16(0x80)));
+    return _mm_xor_si128(r, _mm_set1_epi16(0xff));
+}
+
+/* A-law codes of 8 samples in the low bytes of the lanes */
+SIGK_SSE41 static inline __m128i sigkAlaw8Sse41(__m128i x)
+{
+    __m128i neg, mag;
+
+    neg = _mm_srai_epi16(x, 15);
+    mag = _mm_xor_si128(_mm_srai_epi16(x, 3), neg);
+    return _mm_xor_si128(sigkG711Sse41(mag, 4, sigkAlawMult),
+            _mm_xor_si128(_mm_set1_epi16(0xd5),
+                    _mm_and_si128(neg, _mm_set1_epi16(0x80))));
+}
+
+SIGK_SSE41 static void sigkUlawSse41(const picoos_int16 *x, picoos_uint8 *y,
+        picoos_int32 n)
+{
+    picoos_int32 i;
+
+    for (i = 0; i + 16 <= n; i += 16) {
+        _mm_storeu_si128((__m128i *)(y + i), _mm_packus_epi16(
+                sigkUlaw8Sse41(_mm_loadu_si128((const __m128i *)(x + i))),
+                sigkUlaw8Sse41(_mm_loadu_si128((const __m128i *)(x + i + 8)))));
+    }
+    sigkUlaw(x + i, y + i, n - i);
+}
+
+SIGK_SSE41 static void sigkAlawSse41(const picoos_int16 *x, picoos_uint8 *y,
+        picoos_int32 n)
+{
+    picoos_int32 i;
+
+    for (i = 0; i + 16 <= n; i += 16) {
+        _mm_storeu_si128((__m128i *)(y + i), _mm_packus_epi16(
+                sigkAlaw8Sse41(_mm_loadu_si128((const __m128i *)(x + i))),
+                sigkAlaw8Sse41(_mm_loadu_si128((const __m128i *)(x + i + 8)))));
+    }
+    sigkAlaw(x + i, y + i, n - i);
+}
+
+#if !defined(PICO_FIXED_POINT_ENABLED)
+/* p * 2^(n - 15) as the float with exponent n and mantissa p - 2^15
+   (2^15 <= p < 2^16), truncated to int as the shifts of sigkExpShift */
+SIGK_SSE41 static void sigkExpShiftSse41(picoos_int32 *y,
+        const picoos_int32 *x, picoos_int32 s, picoos_int32 n)
+{
+    const __m128i vMax = _mm_set1_epi32(PICO_FIX_EXP_FAST_MAX);
+    const __m128i vMin = _mm_set1_epi32(-PICO_FIX_EXP_FAST_MAX);
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i half = _mm_set1_epi32(16384);
+    __m128i cnt = _mm_cvtsi32_si128(s - 13);
+    picoos_int32 i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m128i a, t, f, p, b;
+        a = _mm_sra_epi32(_mm_loadu_si128((const __m128i *)(x + i)), cnt);
+        a = _mm_srai_epi32(_mm_add_epi32(a, one), 1);
+        a = _mm_max_epi32(_mm_min_epi32(a, vMax), vMin);
+        t = _mm_add_epi32(_mm_mullo_epi32(a, _mm_set1_epi32(23637)),
+                _mm_srai_epi32(_mm_mullo_epi32(a, _mm_set1_epi32(473)), 12));
+        f = _mm_srli_epi32(_mm_and_si128(t, _mm_set1_epi32(0x3FFFFFF)), 11);
+        p = _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32(
+                _mm_set1_epi32(PICO_FIX_EXP_FAST_C3), f), half), 15),
+                _mm_set1_epi32(PICO_FIX_EXP_FAST_C2));
+        p = _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32(p, f), half), 15),
+                _mm_set1_epi32(PICO_FIX_EXP_FAST_C1));
+        p = _mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32(p, f), half), 15);
+        b = _mm_add_epi32(_mm_slli_epi32(_mm_add_epi32(_mm_srai_epi32(t, 26),
+                _mm_set1_epi32(127)), 23), _mm_slli_epi32(p, 8));
+        _mm_storeu_si128((__m128i *)(y + i), _mm_cvttps_epi32(_mm_castsi128_ps(b)));
+    }
+    sigkExpShift(y + i, x + i, s, n - i);
+}
+#define SIGK_EXPSHIFT_SSE41 sigkExpShiftSse41
+#else
+/* with fixed point no floats: scalar */
+#define SIGK_EXPSHIFT_SSE41 sigkExpShift
+#endif
+
+static const picosigk_kernels_t sigkSse41 = {
+    "sse4.1",
+    sigkMacSse41,
+    sigkMacReverseSse41,
+    sigkShiftRightSse41,
+    sigkAddShiftLeftSse41,
+    sigkDivideSse41,
+    sigkNormResultSse41,
+    SIGK_MELTOLIN(sigkMelToLinSse41),
+    sigkMulShiftSse41,
+    sigkDot16Sse41,
+    sigkUlawSse41,
+    sigkAlawSse41,
+    SIGK_EXPSHIFT_SSE41
+};
+
+/* ****************************************************************************
+ *   AVX2
+ * ****************************************************************************/
+
+#define SIGK_AVX2 __attribute__((target("avx2")))
+
+SIGK_AVX2 static void sigkMacAvx2(picoos_int32 *v, const picoos_int32 *x,
+        picoos_int32 f, picoos_int32 n)
+{
+    __m256i vf = _mm256_set1_epi32(f);
+    picoos_int32 i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m256i p = _mm256_mullo_epi32(_mm256_loadu_si256((const __m256i *)(x + i)), vf);
+        _mm256_storeu_si256((__m256i *)(v + i),
+                _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(v + i)), p));
+    }
+    for (; i < n; i++) {
+        v[i] += x[i] * f;
+    }
+}
+
+SIGK_AVX2 static void sigkMacReverseAvx2(picoos_int32 *v,
+        const picoos_int32 *x, picoos_int32 f, picoos_int32 n)
+{
+    const __m256i rev = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    __m256i vf = _mm256_set1_epi32(f);
+    picoos_int32 i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m256i p = _mm256_mullo_epi32(_mm256_loadu_si256((const __m256i *)(x + i)), vf);
+        p = _mm256_permutevar8x32_epi32(p, rev);
+        _mm256_storeu_si256((__m256i *)(v - i - 7),
+                _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(v - i - 7)), p));
+    }
+    for (; i < n; i++) {
+        v[-i] += x[i] * f;
+    }
+}
+
+SIGK_AVX2 static void sigkShiftRightAvx2(picoos_int32 *v, picoos_int32 s,
+        picoos_int32 n)
+{
+    __m128i cnt = _mm_cvtsi32_si128(s);
+    picoos_int32 i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(v + i));
+        __m256i r = _mm256_srl_epi32(_mm256_abs_epi32(a), cnt);
+        _mm256_storeu_si256((__m256i *)(v + i), _mm256_sign_epi32(r, a));
+    }
+    sigkShiftRight(v + i, s, n - i);
+}
+
+SIGK_AVX2 static void sigkAddShiftLeftAvx2(picoos_int32 *w,
+        const picoos_int32 *v, picoos_int32 s, picoos_int32 n)
+{
+    __m128i cnt = _mm_cvtsi32_si128(s);
+    picoos_int32 i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m256i a = _mm256_sll_epi32(_mm256_loadu_si256((const __m256i *)(v + i)), cnt);
+        _mm256_storeu_si256((__m256i *)(w + i),
+                _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(w + i)), a));
+    }
+    sigkAddShiftLeft(w + i, v + i, s, n - i);
+}
+
+SIGK_AVX2 static void sigkDivideAvx2(picoos_int32 *v, picoos_int32 d,
+        picoos_int32 n)
+{
+    __m256d vd = _mm256_set1_pd((double) d);
+    picoos_int32 i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m128i lo = _mm_loadu_si128((const __m128i *)(v + i));
+        __m128i hi = _mm_loadu_si128((const __m128i *)(v + i + 4));
+        lo = _mm256_cvttpd_epi32(_mm256_div_pd(_mm256_cvtepi32_pd(lo), vd));
+        hi = _mm256_cvttpd_epi32(_mm256_div_pd(_mm256_cvtepi32_pd(hi), vd));
+        _mm_storeu_si128((__m128i *)(v + i), lo);
+        _mm_storeu_si128((__m128i *)(v + i + 4), hi);
+    }
+    for (; i < n; i++) {
+        v[i] /= d;
+    }
+}
+
+SIGK_AVX2 static pico_param_t sigkNormResultAvx2(picoos_int32 n,
+        picoos_int32 *x, const picoos_int32 *window)
+{
+    __m256i acc = _mm256_setzero_si256();
+    __m128i acc4;
+    picoos_int32 i, E;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m256i t = _mm256_loadu_si256((const __m256i *)(x + i));
+        __m256i w = _mm256_srai_epi32(_mm256_loadu_si256((const __m256i *)(window + i)), 18);
+        __m256i a = _mm256_mullo_epi32(w,
+                _mm256_sign_epi32(_mm256_srli_epi32(_mm256_abs_epi32(t), 11), t));
+        __m256i b = _mm256_srli_epi32(_mm256_abs_epi32(a), 18);
+        _mm256_storeu_si256((__m256i *)(x + i), a);
+        acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(b, b));
+    }
+    acc4 = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    acc4 = _mm_add_epi32(acc4, _mm_shuffle_epi32(acc4, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc4 = _mm_add_epi32(acc4, _mm_shuffle_epi32(acc4, _MM_SHUFFLE(2, 3, 0, 1)));
+    E = _mm_cvtsi128_si32(acc4);
+    for (; i < n; i++) {
+        picoos_int32 a, b;
+        a = (window[i]>>18) * ((x[i]>0) ? x[i]>>11 : -((-x[i])>>11));
+        x[i] = a;
+        b = (a>=0?a:-a)  >> 18;
+        E += (b*b);
+    }
+    return sigkRms(E, n);
+}
+
+#if !defined(PICO_FIXED_POINT_ENABLED)
+SIGK_AVX2 static void sigkMelToLinAvx2(picoos_int32 *x, const picoos_int16 *A,
+        const picoos_int32 *D, picoos_int32 n)
+{
+    const __m256 v32 = _mm256_set1_ps(32.0f);
+    picoos_int32 i;
+
+    for (i = 1; i + 8 <= n; i += 8) {
+        __m256i k = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(A + i)));
+        __m256i t2 = _mm256_i32gather_epi32((const int *) x, k, 4);
+        __m256i t1 = _mm256_i32gather_epi32((const int *) (x + 1), k, 4);
+        __m256 p = _mm256_mul_ps(
+                _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i *)(D + i))),
+                _mm256_cvtepi32_ps(_mm256_sub_epi32(t1, t2)));
+        __m256 r = _mm256_add_ps(_mm256_cvtepi32_ps(t2), _mm256_div_ps(p, v32));
+        _mm256_storeu_si256((__m256i *)(x + i), _mm256_cvttps_epi32(r));
+    }
+    for (; i < n; i++) {
+        picoos_int32 k = A[i], term2 = x[k], delta = x[k + 1] - term2;
+        x[i] = term2 + (((picoos_single)D[i] * (picoos_single)delta) / 32);
+    }
+}
+#endif
+
+SIGK_AVX2 static void sigkMulShiftAvx2(picoos_int32 *y,
+        const picoos_int32 *x, const picoos_int32 *g, picoos_int32 s,
+        picoos_int32 n)
+{
+    __m128i cnt = _mm_cvtsi32_si128(s);
+    picoos_int32 i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m256i p = _mm256_mullo_epi32(_mm256_loadu_si256((const __m256i *)(x + i)),
+                _mm256_loadu_si256((const __m256i *)(g + i)));
+        __m256i r = _mm256_srl_epi32(_mm256_abs_epi32(p), cnt);
+        _mm256_storeu_si256((__m256i *)(y + i), _mm256_sign_epi32(r, p));
+    }
+    sigkMulShift(y + i, x + i, g + i, s, n - i);
+}
+
+SIGK_AVX2 static picoos_int32 sigkDot16Avx2(const picoos_int16 *x,
+        const picoos_int16 *h, picoos_int32 n)
+{
+    __m256i acc = _mm256_setzero_si256();
+    __m128i s;
+    picoos_int32 i, r;
+
+    for (i = 0; i + 16 <= n; i += 16) {
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(
+                _mm256_loadu_si256((const __m256i *)(x + i)),
+                _mm256_loadu_si256((const __m256i *)(h + i))));
+    }
+    s = _mm_add_epi32(_mm256_castsi256_si128(acc),
+            _mm256_extracti128_si256(acc, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4e));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xb1));
+    r = _mm_cvtsi128_si32(s);
+    for (; i < n; i++) {
+        r += (picoos_int32) x[i] * h[i];
+    }
+    return r;
+}
+
+/* 16 magnitudes at a time, see sigkG711Sse41 */
+SIGK_AVX2 static inline __m256i sigkG711Avx2(__m256i mag, int lo,
+        const picoos_uint8 *mult)
+{
+    __m256i seg, m;
+
+    seg = _mm256_max_epi16(
+            _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(
+                    _mm_loadu_si128((const __m128i *) sigkSegmentHigh)),
+                    _mm256_srl_epi16(mag, _mm_cvtsi32_si128(lo + 4))),
+            _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(
+                    _mm_loadu_si128((const __m128i *) sigkSegment)),
+                    _mm256_and_si256(_mm256_srl_epi16(mag, _mm_cvtsi32_si128(lo)),
+                            _mm256_set1_epi16(0x0f))));
+    m = _mm256_slli_epi16(_mm256_shuffle_epi8(_mm256_broadcastsi128_si256(
+            _mm_loadu_si128((const __m128i *) mult)), seg), 8);
+    return _mm256_or_si256(_mm256_slli_epi16(seg, 4),
+            _mm256_and_si256(_mm256_mulhi_epu16(mag, m), _mm256_set1_epi16(0x0f)));
+}
+
+/* 16 samples at a time, see sigkUlaw8Sse41 */
+SIGK_AVX2 static inline __m256i sigkUlaw16Avx2(__m256i x)
+{
+    __m256i mag, r;
+
+    mag = _mm256_add_epi16(_mm256_min_epi16(_mm256_abs_epi16(_mm256_srai_epi16(x, 2)),
+            _mm256_set1_epi16(8158)), _mm256_set1_epi16(33));
+    r = _mm256_or_si256(sigkG711Avx2(mag, 5, sigkUlawMult),
+            _mm256_and_si256(_mm256_srai_epi16(x, 15), _mm256_set1_epi16(0x80)));
+    return _mm256_xor_si256(r, _mm256_set1_epi16(0xff));
+}
+
+/* 16 samples at a time, see sigkAlaw8Sse41 */
+SIGK_AVX2 static inline __m256i sigkAlaw16Avx2(__m256i x)
+{
+    __m256i neg, mag;
+
+    neg = _mm256_srai_epi16(x, 15);
+    mag = _mm256_xor_si256(_mm256_srai_epi16(x, 3), neg);
+    return _mm256_xor_si256(sigkG711Avx2(mag, 4, sigkAlawMult),
+            _mm256_xor_si256(_mm256_set1_epi16(0xd5),
+                    _mm256_and_si256(neg, _mm256_set1_epi16(0x80))));
+}
+
+/* the bytes of the 128 bit halves are packed separately: reorder the
+   64 bit blocks */
+SIGK_AVX2 static void sigkUlawAvx2(const picoos_int16 *x, picoos_uint8 *y,
+        picoos_int32 n)
+{
+    picoos_int32 i;
+
+    for (i = 0; i + 32 <= n; i += 32) {
+        __m256i r = _mm256_packus_epi16(
+                sigkUlaw16Avx2(_mm256_loadu_si256((const __m256i *)(x + i))),
+                sigkUlaw16Avx2(_mm256_loadu_si256((const __m256i *)(x + i + 16))));
+        _mm256_storeu_si256((__m256i *)(y + i), _mm256_permute4x64_epi64(r, 0xd8));
+    }
+    sigkUlaw(x + i, y + i, n - i);
+}
+
+SIGK_AVX2 static void sigkAlawAvx2(const picoos_int16 *x, picoos_uint8 *y,
+        picoos_int32 n)
+{
+    picoos_int32 i;
+
+    for (i = 0; i + 32 <= n; i += 32) {
+        __m256i r = _mm256_packus_epi16(
+                sigkAlaw16Avx2(_mm256_loadu_si256((const __m256i *)(x + i))),
+                sigkAlaw16Avx2(_mm256_loadu_si256((const __m256i *)(x + i + 16))));
+        _mm256_storeu_si256((__m256i *)(y + i), _mm256_permute4x64_epi64(r, 0xd8));
+    }
+    sigkAlaw(x + i, y + i, n - i);
+}
+
+SIGK_AVX2 static void sigkExpShiftAvx2(picoos_int32 *y,
+        const picoos_int32 *x, picoos_int32 s, picoos_int32 n)
+{
+    const __m256i vMax = _mm256_set1_epi32(PICO_FIX_EXP_FAST_MAX);
+    const __m256i vMin = _mm256_set1_epi32(-PICO_FIX_EXP_FAST_MAX);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i half = _mm256_set1_epi32(16384);
+    const __m256i zero = _mm256_setzero_si256();
+    __m128i cnt = _mm_cvtsi32_si128(s - 13);
+    picoos_int32 i;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        __m256i a, t, f, p, e;
+        a = _mm256_sra_epi32(_mm256_loadu_si256((const __m256i *)(x + i)), cnt);
+        a = _mm256_srai_epi32(_mm256_add_epi32(a, one), 1);
+        a = _mm256_max_epi32(_mm256_min_epi32(a, vMax), vMin);
+        t = _mm256_add_epi32(_mm256_mullo_epi32(a, _mm256_set1_epi32(23637)),
+                _mm256_srai_epi32(_mm256_mullo_epi32(a, _mm256_set1_epi32(473)), 12));
+        f = _mm256_srli_epi32(_mm256_and_si256(t, _mm256_set1_epi32(0x3FFFFFF)), 11);
+        p = _mm256_add_epi32(_mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(
+                _mm256_set1_epi32(PICO_FIX_EXP_FAST_C3), f), half), 15),
+                _mm256_set1_epi32(PICO_FIX_EXP_FAST_C2));
+        p = _mm256_add_epi32(_mm256_srai_epi32(_mm256_add_epi32(
+                _mm256_mullo_epi32(p, f), half), 15),
+                _mm256_set1_epi32(PICO_FIX_EXP_FAST_C1));
+        p = _mm256_add_epi32(_mm256_srai_epi32(_mm256_add_epi32(
+                _mm256_mullo_epi32(p, f), half), 15), _mm256_set1_epi32(32768));
+        /* shifts by 32 or more give 0 */
+        e = _mm256_sub_epi32(_mm256_srai_epi32(t, 26), _mm256_set1_epi32(15));
+        p = _mm256_sllv_epi32(p, _mm256_max_epi32(e, zero));
+        p = _mm256_srlv_epi32(p, _mm256_max_epi32(_mm256_sub_epi32(zero, e), zero));
+        _mm256_storeu_si256((__m256i *)(y + i), p);
+    }
+    sigkExpShift(y + i, x + i, s, n - i);
+}
+
+static const picosigk_kernels_t sigkAvx2 = {
+    "avx2",
+    sigkMacAvx2,
+    sigkMacReverseAvx2,
+    sigkShiftRightAvx2,
+    sigkAddShiftLeftAvx2,
+    sigkDivideAvx2,
+    sigkNormResultAvx2,
+    SIGK_MELTOLIN(sigkMelToLinAvx2),
+    sigkMulShiftAvx2,
+    sigkDot16Avx2,
+    sigkUlawAvx2,
+    sigkAlawAvx2,
+    sigkExpShiftAvx2
+};
+
+#endif /* PICOSIGK_X86 */
+
+#if defined(PICOSIGK_ARM_NEON)
+
+/* ****************************************************************************
+ *   NEON (AArch64)
+ * ****************************************************************************/
+
+/* sign(a) * r for r >= 0 */
+static int32x4_t sigkSignNeon(int32x4_t r, int32x4_t a)
+{
+    return vbslq_s32(vcltq_s32(a, vdupq_n_s32(0)), vnegq_s32(r), r);
+}
+
+static void sigkMacNeon(picoos_int32 *v, const picoos_int32 *x,
+        picoos_int32 f, picoos_int32 n)
+{
+    picoos_int32 i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        vst1q_s32(v + i, vmlaq_n_s32(vld1q_s32(v + i), vld1q_s32(x + i), f));
+    }
+    for (; i < n; i++) {
+        v[i] += x[i] * f;
+    }
+}
+
+static void sigkMacReverseNeon(picoos_int32 *v, const picoos_int32 *x,
+        picoos_int32 f, picoos_int32 n)
+{
+    picoos_int32 i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        int32x4_t p = vrev64q_s32(vmulq_n_s32(vld1q_s32(x + i), f));
+        p = vcombine_s32(vget_high_s32(p), vget_low_s32(p));
+        vst1q_s32(v - i - 3, vaddq_s32(vld1q_s32(v - i - 3), p));
+    }
+    for (; i < n; i++) {
+        v[-i] += x[i] * f;
+    }
+}
+
+static void sigkShiftRightNeon(picoos_int32 *v, picoos_int32 s,
+        picoos_int32 n)
+{
+    int32x4_t cnt = vdupq_n_s32(-s);
+    picoos_int32 i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        int32x4_t a = vld1q_s32(v + i);
+        uint32x4_t r = vshlq_u32(vreinterpretq_u32_s32(vabsq_s32(a)), cnt);
+        vst1q_s32(v + i, sigkSignNeon(vreinterpretq_s32_u32(r), a));
+    }
+    sigkShiftRight(v + i, s, n - i);
+}
+
+static void sigkAddShiftLeftNeon(picoos_int32 *w, const picoos_int32 *v,
+        picoos_int32 s, picoos_int32 n)
+{
+    int32x4_t cnt = vdupq_n_s32(s);
+    picoos_int32 i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        vst1q_s32(w + i, vaddq_s32(vld1q_s32(w + i), vshlq_s32(vld1q_s32(v + i), cnt)));
+    }
+    sigkAddShiftLeft(w + i, v + i, s, n - i);
+}
+
+static void sigkDivideNeon(picoos_int32 *v, picoos_int32 d, picoos_int32 n)
+{
+    float64x2_t vd = vdupq_n_f64((double) d);
+    picoos_int32 i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        int32x4_t a = vld1q_s32(v + i);
+        float64x2_t lo = vdivq_f64(vcvtq_f64_s64(vmovl_s32(vget_low_s32(a))), vd);
+        float64x2_t hi = vdivq_f64(vcvtq_f64_s64(vmovl_s32(vget_high_s32(a))), vd);
+        vst1q_s32(v + i, vcombine_s32(vmovn_s64(vcvtq_s64_f64(lo)),
+                vmovn_s64(vcvtq_s64_f64(hi))));
+    }
+    for (; i < n; i++) {
+        v[i] /= d;
+    }
+}
+
+static pico_param_t sigkNormResultNeon(picoos_int32 n, picoos_int32 *x,
+        const picoos_int32 *window)
+{
+    int32x4_t acc = vdupq_n_s32(0);
+    picoos_int32 i, E;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        int32x4_t t = vld1q_s32(x + i);
+        int32x4_t w = vshrq_n_s32(vld1q_s32(window + i), 18);
+        int32x4_t r = vreinterpretq_s32_u32(vshrq_n_u32(
+                vreinterpretq_u32_s32(vabsq_s32(t)), 11));
+        int32x4_t a = vmulq_s32(w, sigkSignNeon(r, t));
+        int32x4_t b = vreinterpretq_s32_u32(vshrq_n_u32(
+                vreinterpretq_u32_s32(vabsq_s32(a)), 18));
+        vst1q_s32(x + i, a);
+        acc = vmlaq_s32(acc, b, b);
+    }
+    E = vaddvq_s32(acc);
+    for (; i < n; i++) {
+        picoos_int32 a, b;
+        a = (window[i]>>18) * ((x[i]>0) ? x[i]>>11 : -((-x[i])>>11));
+        x[i] = a;
+        b = (a>=0?a:-a)  >> 18;
+        E += (b*b);
+    }
+    return sigkRms(E, n);
+}
+
+#if !defined(PICO_FIXED_POINT_ENABLED)
+static void sigkMelToLinNeon(picoos_int32 *x, const picoos_int16 *A,
+        const picoos_int32 *D, picoos_int32 n)
+{
+    const float32x4_t v32 = vdupq_n_f32(32.0f);
+    picoos_int32 t1[4], t2[4];
+    picoos_int32 i, j;
+
+    for (i = 1; i + 4 <= n; i += 4) {
+        int32x4_t v1, v2;
+        float32x4_t p;
+        for (j = 0; j < 4; j++) {
+            t2[j] = x[A[i + j]];
+            t1[j] = x[A[i + j] + 1];
+        }
+        v2 = vld1q_s32(t2);
+        v1 = vld1q_s32(t1);
+        p = vmulq_f32(vcvtq_f32_s32(vld1q_s32(D + i)), vcvtq_f32_s32(vsubq_s32(v1, v2)));
+        vst1q_s32(x + i, vcvtq_s32_f32(vaddq_f32(vcvtq_f32_s32(v2), vdivq_f32(p, v32))));
+    }
+    for (; i < n; i++) {
+        picoos_int32 k = A[i], term2 = x[k], delta = x[k + 1] - term2;
+        x[i] = term2 + (((picoos_single)D[i] * (picoos_single)delta) / 32);
+    }
+}
+#endif
+
+static void sigkMulShiftNeon(picoos_int32 *y, const picoos_int32 *x,
+        const picoos_int32 *g, picoos_int32 s, picoos_int32 n)
+{
+    int32x4_t cnt = vdupq_n_s32(-s);
+    picoos_int32 i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        int32x4_t p = vmulq_s32(vld1q_s32(x + i), vld1q_s32(g + i));
+        uint32x4_t r = vshlq_u32(vreinterpretq_u32_s32(vabsq_s32(p)), cnt);
+        vst1q_s32(y + i, sigkSignNeon(vreinterpretq_s32_u32(r), p));
+    }
+    sigkMulShift(y + i, x + i, g + i, s, n - i);
+}
+
+static picoos_int32 sigkDot16Neon(const picoos_int16 *x,
+        const picoos_int16 *h, picoos_int32 n)
+{
+    int32x4_t acc = vdupq_n_s32(0);
+    picoos_int32 i, r;
+
+    for (i = 0; i + 8 <= n; i += 8) {
+        int16x8_t a = vld1q_s16(x + i), b = vld1q_s16(h + i);
+        acc = vmlal_s16(acc, vget_low_s16(a), vget_low_s16(b));
+        acc = vmlal_high_s16(acc, a, b);
+    }
+    r = vaddvq_s32(acc);
+    for (; i < n; i++) {
+        r += (picoos_int32) x[i] * h[i];
+    }
+    return r;
+}
+
+/* mu-law codes of 8 samples: the segment is 10 minus the leading zeros
+   of the biased magnitude, at least 0 */
+static inline uint16x8_t sigkUlaw8Neon(int16x8_t x)
+{
+    uint16x8_t mag, seg, r;
+
+    mag = vaddq_u16(vminq_u16(vreinterpretq_u16_s16(vabsq_s16(vshrq_n_s16(x, 2))),
+            vdupq_n_u16(8158)), vdupq_n_u16(33));
+    seg = vqsubq_u16(vdupq_n_u16(10), vclzq_u16(mag));
+    r = vshlq_u16(mag, vnegq_s16(vreinterpretq_s16_u16(vaddq_u16(seg, vdupq_n_u16(1)))));
+    r = vorrq_u16(vshlq_n_u16(seg, 4), vandq_u16(r, vdupq_n_u16(0x0f)));
+    r = vorrq_u16(r, vandq_u16(vreinterpretq_u16_s16(vshrq_n_s16(x, 15)),
+            vdupq_n_u16(0x80)));
+    return veorq_u16(r, vdupq_n_u16(0xff));
+}
+
+/* A-law codes of 8 samples: the segment is 11 minus the leading zeros of
+   the magnitude, at least 0 */
+static inline uint16x8_t sigkAlaw8Neon(int16x8_t x)
+{
+    uint16x8_t neg, mag, seg, r;
+
+    neg = vreinterpretq_u16_s16(vshrq_n_s16(x, 15));
+    mag = veorq_u16(vreinterpretq_u16_s16(vshrq_n_s16(x, 3)), neg);
+    seg = vqsubq_u16(vdupq_n_u16(11), vclzq_u16(mag));
+    r = vshlq_u16(mag, vnegq_s16(vreinterpretq_s16_u16(vmaxq_u16(seg, vdupq_n_u16(1)))));
+    r = vorrq_u16(vshlq_n_u16(seg, 4), vandq_u16(r, vdupq_n_u16(0x0f)));
+    return veorq_u16(r, veorq_u16(vdupq_n_u16(0xd5), vandq_u16(neg, vdupq_n_u16(0x80))));
+}
+
+static void sigkUlawNeon(const picoos_int16 *x, picoos_uint8 *y,
+        picoos_int32 n)
+{
+    picoos_int32 i;
+
+    for (i = 0; i + 16 <= n; i += 16) {
+        vst1q_u8(y + i, vcombine_u8(vmovn_u16(sigkUlaw8Neon(vld1q_s16(x + i))),
+                vmovn_u16(sigkUlaw8Neon(vld1q_s16(x + i + 8)))));
+    }
+    sigkUlaw(x + i, y + i, n - i);
+}
+
+static void sigkAlawNeon(const picoos_int16 *x, picoos_uint8 *y,
+        picoos_int32 n)
+{
+    picoos_int32 i;
+
+    for (i = 0; i + 16 <= n; i += 16) {
+        vst1q_u8(y + i, vcombine_u8(vmovn_u16(sigkAlaw8Neon(vld1q_s16(x + i))),
+                vmovn_u16(sigkAlaw8Neon(vld1q_s16(x + i + 8)))));
+    }
+    sigkAlaw(x + i, y + i, n - i);
+}
+
+static void sigkExpShiftNeon(picoos_int32 *y, const picoos_int32 *x,
+        picoos_int32 s, picoos_int32 n)
+{
+    const int32x4_t vMax = vdupq_n_s32(PICO_FIX_EXP_FAST_MAX);
+    const int32x4_t vMin = vdupq_n_s32(-PICO_FIX_EXP_FAST_MAX);
+    const int32x4_t half = vdupq_n_s32(16384);
+    int32x4_t cnt = vdupq_n_s32(13 - s);
+    picoos_int32 i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        int32x4_t a, t, f, p, e;
+        a = vshlq_s32(vld1q_s32(x + i), cnt);
+        a = vshrq_n_s32(vaddq_s32(a, vdupq_n_s32(1)), 1);
+        a = vmaxq_s32(vminq_s32(a, vMax), vMin);
+        t = vaddq_s32(vmulq_n_s32(a, 23637), vshrq_n_s32(vmulq_n_s32(a, 473), 12));
+        f = vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(
+                vandq_s32(t, vdupq_n_s32(0x3FFFFFF))), 11));
+        p = vaddq_s32(vshrq_n_s32(vaddq_s32(vmulq_n_s32(f, PICO_FIX_EXP_FAST_C3),
+                half), 15), vdupq_n_s32(PICO_FIX_EXP_FAST_C2));
+        p = vaddq_s32(vshrq_n_s32(vaddq_s32(vmulq_s32(p, f), half), 15),
+                vdupq_n_s32(PICO_FIX_EXP_FAST_C1));
+        p = vaddq_s32(vshrq_n_s32(vaddq_s32(vmulq_s32(p, f), half), 15),
+                vdupq_n_s32(32768));
+        /* negative shifts are right shifts, by 32 or more they give 0 */
+        e = vsubq_s32(vshrq_n_s32(t, 26), vdupq_n_s32(15));
+        vst1q_s32(y + i, vshlq_s32(p, e));
+    }
+    sigkExpShift(y + i, x + i, s, n - i);
+}
+
+static const picosigk_kernels_t sigkNeon = {
+    "neon",
+    sigkMacNeon,
+    sigkMacReverseNeon,
+    sigkShiftRightNeon,
+    sigkAddShiftLeftNeon,
+    sigkDivideNeon,
+    sigkNormResultNeon,
+    SIGK_MELTOLIN(sigkMelToLinNeon),
+    sigkMulShiftNeon,
+    sigkDot16Neon,
+    sigkUlawNeon,
+    sigkAlawNeon,
+    sigkExpShiftNeon
+};
+
+#endif /* PICOSIGK_ARM_NEON */
+
+/* ****************************************************************************
+ *   selection
+ * ****************************************************************************/
+
+const picosigk_kernels_t *picosigk_getKernels(picoos_int32 isa)
+{
+    switch (isa) {
+        case PICOSIGK_AUTO:
+#if defined(PICOSIGK_X86)
+            if (NULL != picosigk_getKernels(PICOSIGK_AVX2)) {
+                return &sigkAvx2;
+            }
+            if (NULL != picosigk_getKernels(PICOSIGK_SSE41)) {
+                return &sigkSse41;
+            }
+#elif defined(PICOSIGK_ARM_NEON)
+            return &sigkNeon;
+#endif
+            return &sigkScalar;
+        case PICOSIGK_SCALAR:
+            return &sigkScalar;
+#if defined(PICOSIGK_X86)
+        case PICOSIGK_SSE41:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse4.1") ? &sigkSse41 : NULL;
+        case PICOSIGK_AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") ? &sigkAvx2 : NULL;
+#endif
+#if defined(PICOSIGK_ARM_NEON)
+        case PICOSIGK_NEON:
+            return &sigkNeon;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/* end picosigk.c */
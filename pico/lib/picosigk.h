@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2024 PicoTTS Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * @file picosigk.h
+ *
+ * Vector kernels of the signal generation
+ *
+ * The per-frame loops of picosig2 over the FFT-sized int32 buffers
+ * (TD-PSOLA accumulation, scaling, overlap-add, impulse response
+ * normalization, mel-to-linear interpolation, noise shaping, envelope
+ * amplitudes of the fast math profile), the FIR
+ * filter of the output resampler and the G.711 output encoders are
+ * called through a table of kernels. The scalar kernels are the
+ * reference; the SSE4.1, AVX2 and NEON kernels give bit-identical
+ * results.
+ *
+ * The kernel set is chosen when the signal generation is initialized:
+ * by default the best set the CPU supports, or the set requested with
+ * the voice option PICORSRC_VOPT_SIG_KERNELS (the scalar kernels if it
+ * is not available).
+ *
+ * The vector kernels need GCC or Clang (x86: compiled for the target
+ * ISA per function and selected by CPUID, ARM: NEON must be enabled for
+ * the whole build). Without PICO_USE_SIG_SIMD only the scalar kernels
+ * exist.
+ *
+ * Usage:
+ *   Enable with: -DPICO_USE_SIG_SIMD=1
+ *   Kernel timing and comparison: picobench sigkernels
+ */
+
+#ifndef PICOSIGK_H_
+#define PICOSIGK_H_
+
+#include "picodefs.h"
+#include "picoos.h"
+#include "picofixedpoint.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if 0
+}
+#endif
+
+#define PICOSIGK_AUTO    0  /* best kernels supported by the CPU */
+#define PICOSIGK_SCALAR  1
+#define PICOSIGK_SSE41   2
+#define PICOSIGK_AVX2    3
+#define PICOSIGK_NEON    4
+#define PICOSIGK_NUM     5
+
+typedef struct picosigk_kernels {
+    const char *name;
+
+    /* v[i] += x[i] * f for i = 0..n-1 */
+    void (*mac)(picoos_int32 *v, const picoos_int32 *x, picoos_int32 f,
+            picoos_int32 n);
+
+    /* v[-i] += x[i] * f for i = 0..n-1, i.e. x added in reverse order
+       ending at v */
+    void (*macReverse)(picoos_int32 *v, const picoos_int32 *x,
+            picoos_int32 f, picoos_int32 n);
+
+    /* v[i] = sign(v[i]) * (|v[i]| >> s) */
+    void (*shiftRight)(picoos_int32 *v, picoos_int32 s, picoos_int32 n);
+
+    /* w[i] += sign(v[i]) * (|v[i]| << s) */
+    void (*addShiftLeft)(picoos_int32 *w, const picoos_int32 *v,
+            picoos_int32 s, picoos_int32 n);
+
+    /* v[i] /= d, d > 0 */
+    void (*divide)(picoos_int32 *v, picoos_int32 d, picoos_int32 n);
+
+    /* windows and normalizes the impulse response x in place and returns
+       its RMS value, see norm_result */
+    pico_param_t (*normResult)(picoos_int32 n, picoos_int32 *x,
+            const picoos_int32 *window);
+
+    /* linear interpolation of the mel-to-linear mapping in place:
+       x[i] = x[A[i]] + D[i] * (x[A[i] + 1] - x[A[i]]) / 32 for
+       i = 1..n-1, with i <= A[i] */
+    void (*melToLin)(picoos_int32 *x, const picoos_int16 *A,
+            const picoos_int32 *D, picoos_int32 n);
+
+    /* y[i] = sign(p) * (|p| >> s) with p = x[i] * g[i] (the noise shaping
+       of the unvoiced excitation, see sigAllocateVoice) */
+    void (*mulShift)(picoos_int32 *y, const picoos_int32 *x,
+            const picoos_int32 *g, picoos_int32 s, picoos_int32 n);
+
+    /* returns the sum of x[i] * h[i] for i = 0..n-1 (the FIR filter of
+       the output resampler, see picosigrs.h) */
+    picoos_int32 (*dot16)(const picoos_int16 *x, const picoos_int16 *h,
+            picoos_int32 n);
+
+    /* y[i] = G.711 mu-law code of x[i] (output encoder, see picosigenc.h) */
+    void (*ulaw)(const picoos_int16 *x, picoos_uint8 *y, picoos_int32 n);
+
+    /* y[i] = G.711 A-law code of x[i] */
+    void (*alaw)(const picoos_int16 *x, picoos_uint8 *y, picoos_int32 n);
+
+    /* y[i] = pico_fix_exp_fast(x[i], s, 0) for s >= 13 (the envelope
+       amplitudes of the fast math profile, see picosig2.h) */
+    void (*expShift)(picoos_int32 *y, const picoos_int32 *x, picoos_int32 s,
+            picoos_int32 n);
+} picosigk_kernels_t;
+
+/* returns the kernels of set 'isa' (PICOSIGK_*), or the best supported
+   set for PICOSIGK_AUTO; NULL if the set is not compiled in or the CPU
+   does not support it */
+const picosigk_kernels_t *picosigk_getKernels(picoos_int32 isa);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*PICOSIGK_H_*/
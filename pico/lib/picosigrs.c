@@ -0,0 +1,372 @@
+/*
+ * Copyright (C) 2024 PicoTTS Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * @file picosigrs.c
+ *
+ * Output resampler of the signal generation
+ *
+ * Output sample n is at input time i + p / L with i = (n * M) / L and
+ * phase p = (n * M) % L. It is the dot product of the input samples
+ * i + 1 - K .. i + K with the taps of phase p; tap k of phase p is the
+ * prototype filter at distance (K - 1 - k) + p / L input samples,
+ * stretched by L / M when downsampling. The input is kept in a linear
+ * history buffer from which the samples no longer needed are dropped
+ * after each call.
+ */
+
+#include "picodefs.h"
+#include "picoos.h"
+#include "picodbg.h"
+#include "picosigk.h"
+#include "picosigrs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if 0
+}
+#endif
+
+#define PICOSIGRS_ZEROS     16  /* length of the prototype in input samples */
+#define PICOSIGRS_OVER      64  /* prototype entries per input sample */
+#define PICOSIGRS_SHIFT     14  /* taps in Q14 */
+
+/* prototype filter: the Kaiser (beta 7) windowed sinc 0.92 * sinc(0.92 t)
+   in Q15 for t = 0, 1/64, .. 16 input samples */
+static const picoos_int16 sigrsProto[PICOSIGRS_ZEROS * PICOSIGRS_OVER + 1] = {
+    30147, 30136, 30105, 30054, 29981, 29889, 29776, 29642, 29489, 29316,
+    29123, 28911, 28680, 28430, 28161, 27874, 27569, 27247, 26908, 26552,
+    26179, 25791, 25388, 24970, 24538, 24092, 23632, 23160, 22676, 22181,
+    21674, 21157, 20631, 20095, 19551, 19000, 18441, 17876, 17304, 16728,
+    16147, 15563, 14975, 14385, 13793, 13200, 12607, 12013, 11421, 10830,
+    10241, 9655, 9072, 8494, 7920, 7351, 6788, 6232, 5682, 5140,
+    4606, 4081, 3565, 3058, 2561, 2075, 1600, 1136, 683, 243,
+    -184, -599, -1001, -1390, -1764, -2125, -2472, -2805, -3122, -3426,
+    -3714, -3987, -4246, -4489, -4717, -4930, -5128, -5310, -5478, -5630,
+    -5767, -5890, -5998, -6091, -6169, -6233, -6283, -6320, -6342, -6351,
+    -6348, -6331, -6301, -6260, -6207, -6142, -6065, -5978, -5881, -5773,
+    -5656, -5529, -5394, -5250, -5099, -4939, -4773, -4600, -4421, -4236,
+    -4045, -3850, -3651, -3447, -3241, -3031, -2818, -2604, -2388, -2171,
+    -1953, -1734, -1516, -1299, -1082, -867, -653, -442, -233, -27,
+    176, 375, 571, 762, 948, 1130, 1306, 1478, 1643, 1803,
+    1956, 2104, 2244, 2378, 2505, 2626, 2739, 2844, 2943, 3034,
+    3117, 3193, 3261, 3322, 3375, 3420, 3458, 3488, 3511, 3526,
+    3533, 3534, 3527, 3513, 3492, 3464, 3429, 3388, 3341, 3287,
+    3227, 3162, 3090, 3014, 2932, 2846, 2754, 2658, 2559, 2455,
+    2347, 2236, 2122, 2005, 1885, 1763, 1639, 1513, 1386, 1257,
+    1128, 997, 867, 736, 605, 475, 345, 216, 88, -38,
+    -163, -286, -407, -525, -642, -755, -865, -973, -1077, -1178,
+    -1275, -1368, -1457, -1543, -1624, -1701, -1774, -1842, -1905, -1964,
+    -2018, -2068, -2112, -2152, -2187, -2217, -2242, -2262, -2278, -2288,
+    -2294, -2295, -2291, -2283, -2270, -2253, -2231, -2204, -2174, -2139,
+    -2101, -2058, -2012, -1962, -1909, -1853, -1793, -1730, -1664, -1596,
+    -1525, -1452, -1377, -1299, -1220, -1139, -1057, -973, -889, -803,
+    -717, -630, -543, -455, -368, -281, -194, -108, -22, 63,
+    146, 229, 310, 389, 467, 544, 618, 690, 760, 828,
+    893, 956, 1016, 1074, 1128, 1180, 1229, 1275, 1317, 1357,
+    1393, 1426, 1456, 1482, 1506, 1526, 1542, 1555, 1565, 1572,
+    1575, 1575, 1572, 1565, 1556, 1543, 1527, 1508, 1487, 1462,
+    1435, 1405, 1373, 1338, 1301, 1261, 1220, 1176, 1130, 1082,
+    1033, 982, 929, 876, 821, 764, 707, 649, 590, 531,
+    471, 411, 350, 290, 229, 169, 109, 49, -10, -69,
+    -127, -184, -240, -295, -348, -401, -452, -502, -550, -597,
+    -641, -685, -726, -765, -802, -838, -871, -902, -931, -958,
+    -982, -1004, -1024, -1042, -1057, -1070, -1081, -1089, -1095, -1099,
+    -1100, -1099, -1096, -1091, -1083, -1073, -1061, -1048, -1032, -1014,
+    -994, -972, -949, -924, -897, -869, -839, -808, -775, -742,
+    -707, -670, -633, -595, -557, -517, -477, -436, -395, -353,
+    -311, -269, -226, -184, -142, -100, -58, -16, 25, 66,
+    106, 145, 184, 222, 259, 296, 331, 365, 398, 430,
+    461, 490, 519, 545, 571, 595, 617, 638, 658, 676,
+    692, 707, 720, 731, 741, 749, 756, 761, 764, 766,
+    766, 765, 762, 757, 751, 744, 735, 724, 712, 699,
+    685, 669, 652, 634, 615, 595, 574, 551, 528, 504,
+    480, 454, 428, 401, 374, 346, 318, 290, 261, 232,
+    203, 173, 144, 115, 85, 56, 27, -1, -30, -58,
+    -85, -112, -139, -165, -190, -215, -239, -262, -284, -306,
+    -327, -347, -365, -383, -400, -416, -431, -445, -458, -469,
+    -480, -490, -498, -505, -511, -516, -520, -523, -525, -525,
+    -525, -523, -520, -517, -512, -506, -499, -492, -483, -474,
+    -463, -452, -440, -427, -414, -399, -385, -369, -353, -336,
+    -319, -301, -283, -265, -246, -227, -208, -188, -169, -149,
+    -129, -109, -89, -69, -49, -30, -10, 9, 28, 47,
+    65, 84, 101, 119, 135, 152, 168, 183, 198, 212,
+    226, 239, 251, 263, 274, 284, 293, 302, 310, 318,
+    324, 330, 335, 340, 343, 346, 348, 350, 350, 350,
+    350, 348, 346, 343, 339, 335, 330, 324, 318, 312,
+    304, 296, 288, 279, 270, 260, 250, 239, 229, 217,
+    206, 194, 182, 169, 157, 144, 131, 118, 105, 92,
+    79, 66, 53, 40, 27, 14, 1, -11, -24, -36,
+    -48, -60, -71, -82, -93, -103, -114, -123, -133, -142,
+    -150, -158, -166, -173, -180, -187, -193, -198, -203, -207,
+    -211, -215, -218, -220, -222, -224, -225, -225, -225, -225,
+    -224, -223, -221, -219, -216, -213, -209, -206, -201, -197,
+    -192, -187, -181, -175, -169, -163, -156, -149, -142, -135,
+    -127, -119, -112, -104, -96, -87, -79, -71, -63, -54,
+    -46, -38, -30, -21, -13, -5, 3, 11, 18, 26,
+    33, 40, 47, 54, 61, 67, 73, 79, 85, 90,
+    95, 100, 105, 109, 113, 117, 120, 123, 126, 129,
+    131, 133, 134, 136, 137, 137, 138, 138, 137, 137,
+    136, 135, 134, 132, 130, 128, 126, 124, 121, 118,
+    115, 111, 108, 104, 100, 96, 92, 88, 83, 79,
+    74, 69, 65, 60, 55, 50, 45, 40, 35, 30,
+    25, 20, 15, 11, 6, 1, -4, -8, -13, -17,
+    -21, -25, -29, -33, -37, -41, -44, -48, -51, -54,
+    -57, -59, -62, -64, -66, -68, -70, -72, -73, -75,
+    -76, -77, -77, -78, -78, -79, -79, -78, -78, -78,
+    -77, -76, -76, -74, -73, -72, -71, -69, -67, -65,
+    -64, -62, -59, -57, -55, -53, -50, -48, -45, -43,
+    -40, -37, -35, -32, -29, -26, -24, -21, -18, -15,
+    -13, -10, -7, -5, -2, 1, 3, 5, 8, 10,
+    12, 15, 17, 19, 21, 23, 24, 26, 28, 29,
+    31, 32, 33, 34, 36, 36, 37, 38, 39, 39,
+    40, 40, 40, 41, 41, 41, 41, 40, 40, 40,
+    39, 39, 38, 38, 37, 36, 36, 35, 34, 33,
+    32, 31, 29, 28, 27, 26, 24, 23, 22, 21,
+    19, 18, 16, 15, 14, 12, 11, 10, 8, 7,
+    6, 4, 3, 2, 0, -1, -2, -3, -4, -5,
+    -6, -7, -8, -9, -10, -11, -12, -13, -13, -14,
+    -14, -15, -16, -16, -16, -17, -17, -17, -18, -18,
+    -18, -18, -18, -18, -18, -18, -18, -18, -18, -17,
+    -17, -17, -17, -16, -16, -15, -15, -15, -14, -14,
+    -13, -13, -12, -12, -11, -10, -10, -9, -9, -8,
+    -8, -7, -6, -6, -5, -5, -4, -4, -3, -2,
+    -2, -1, -1, 0, 0, 1, 1, 1, 2, 2,
+    3, 3, 3, 4, 4, 4, 4, 5, 5, 5,
+    5, 5, 6, 6, 6, 6, 6, 6, 6, 6,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 5,
+    5, 5, 5, 5, 5, 5, 4, 4, 4, 4,
+    4, 4, 3, 3, 3
+};
+
+typedef struct picosigrs_resampler {
+    const picosigk_kernels_t *kernels;
+    picoos_int32 rate;      /* output rate */
+    picoos_int16 L, M;      /* conversion ratio L/M */
+    picoos_int16 K;         /* half the number of taps */
+    picoos_int16 *taps;     /* L phases of 2K taps */
+    picoos_int16 *hist;     /* input history, 2K - 1 + PICOSIGRS_MAX_IN */
+    picoos_int16 numHist;   /* samples in hist */
+    picoos_int16 pos;       /* index i in hist of the next output sample */
+    picoos_int16 phase;     /* phase p of the next output sample */
+} picosigrs_resampler_t;
+
+/* a / b rounded to nearest, halves away from zero, b > 0 */
+static picoos_int32 sigrsDivRound(picoos_int32 a, picoos_int32 b)
+{
+    return (a >= 0) ? ((a + b / 2) / b) : -((-a + b / 2) / b);
+}
+
+static picoos_int32 sigrsGcd(picoos_int32 a, picoos_int32 b)
+{
+    picoos_int32 t;
+
+    while (b != 0) {
+        t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/* conversion ratio L/M and half the number of taps K (a multiple of 4,
+   so the number of taps is one of 8) for output rate 'rate' */
+static picoos_bool sigrsRatio(picoos_int32 rate, picoos_int16 *L,
+        picoos_int16 *M, picoos_int16 *K)
+{
+    picoos_int32 g, D;
+
+    if (!picosigrs_isSupportedRate(rate)) {
+        return FALSE;
+    }
+    g = sigrsGcd(rate, PICOSIGRS_IN_RATE);
+    *L = (picoos_int16) (rate / g);
+    *M = (picoos_int16) (PICOSIGRS_IN_RATE / g);
+    D = (*L > *M) ? *L : *M;
+    *K = (picoos_int16) ((PICOSIGRS_ZEROS * D + *L - 1) / *L);
+    *K = (*K + 3) & ~3;
+    return TRUE;
+}
+
+picoos_bool picosigrs_isSupportedRate(picoos_int32 rate)
+{
+    switch (rate) {
+        case 8000:
+        case 22050:
+        case 24000:
+        case 48000:
+            return TRUE;
+        default:
+            return FALSE;
+    }
+}
+
+picoos_int16 picosigrs_getMaxOutput(picoos_int32 rate, picoos_int16 numIn)
+{
+    /* output samples per call differ by one at most from the average */
+    return (picoos_int16) (((picoos_int32) numIn * rate
+            + PICOSIGRS_IN_RATE - 1) / PICOSIGRS_IN_RATE + 1);
+}
+
+picoos_objsize_t picosigrs_getMemSize(picoos_int32 rate)
+{
+    picoos_int16 L, M, K;
+
+    if (!sigrsRatio(rate, &L, &M, &K)) {
+        return 0;
+    }
+    /* object, taps and history, plus allocation overhead */
+    return sizeof(picosigrs_resampler_t)
+            + (L * 2 * K + 2 * K + PICOSIGRS_MAX_IN) * sizeof(picoos_int16)
+            + 3 * 64;
+}
+
+/* samples the prototype for all phases, normalized to unity gain */
+static void sigrsInitTaps(picosigrs_Resampler this)
+{
+    picoos_int32 p, k, d, D, idx, rem, sum, T;
+    picoos_int16 *h;
+
+    T = 2 * this->K;
+    D = (this->L > this->M) ? this->L : this->M;
+    for (p = 0; p < this->L; p++) {
+        h = &(this->taps[p * T]);
+        sum = 0;
+        for (k = 0; k < T; k++) {
+            /* distance in 1/L input samples, position in the prototype */
+            d = (this->K - 1 - k) * this->L + p;
+            if (d < 0) {
+                d = -d;
+            }
+            idx = (d * PICOSIGRS_OVER) / D;
+            rem = (d * PICOSIGRS_OVER) % D;
+            if (idx >= PICOSIGRS_ZEROS * PICOSIGRS_OVER) {
+                h[k] = 0;
+                continue;
+            }
+            /* linear interpolation, scaled by L/D (the stretch when
+               downsampling) */
+            d = sigrsDivRound(sigrsProto[idx] * (D - rem)
+                    + sigrsProto[idx + 1] * rem, D);
+            h[k] = (picoos_int16) sigrsDivRound(d * this->L, D);
+            sum += h[k];
+        }
+        for (k = 0; k < T; k++) {
+            h[k] = (picoos_int16) sigrsDivRound(h[k] << PICOSIGRS_SHIFT, sum);
+        }
+    }
+}
+
+picosigrs_Resampler picosigrs_newResampler(picoos_MemoryManager mm,
+        picoos_int32 rate, const picosigk_kernels_t *kernels)
+{
+    picosigrs_Resampler this;
+    picoos_int16 L, M, K;
+
+    if (!sigrsRatio(rate, &L, &M, &K)) {
+        return NULL;
+    }
+    this = (picosigrs_Resampler) picoos_allocate(mm, sizeof(*this));
+    if (NULL == this) {
+        return NULL;
+    }
+    this->kernels = kernels;
+    this->rate = rate;
+    this->L = L;
+    this->M = M;
+    this->K = K;
+    this->taps = (picoos_int16 *) picoos_allocate(mm,
+            L * 2 * K * sizeof(picoos_int16));
+    this->hist = (picoos_int16 *) picoos_allocate(mm,
+            (2 * K + PICOSIGRS_MAX_IN) * sizeof(picoos_int16));
+    if ((NULL == this->taps) || (NULL == this->hist)) {
+        picosigrs_disposeResampler(mm, &this);
+        return NULL;
+    }
+    sigrsInitTaps(this);
+    picosigrs_reset(this);
+    PICODBG_DEBUG(("resampler to %i Hz: %i/%i, %i taps", rate, L, M, 2 * K));
+    return this;
+}
+
+void picosigrs_disposeResampler(picoos_MemoryManager mm,
+        picosigrs_Resampler *this)
+{
+    if (NULL != *this) {
+        if (NULL != (*this)->taps) {
+            picoos_deallocate(mm, (void *) &((*this)->taps));
+        }
+        if (NULL != (*this)->hist) {
+            picoos_deallocate(mm, (void *) &((*this)->hist));
+        }
+        picoos_deallocate(mm, (void *) this);
+    }
+}
+
+void picosigrs_reset(picosigrs_Resampler this)
+{
+    /* K - 1 zeros before the first input sample at index K - 1 */
+    picoos_mem_set(this->hist, 0, (this->K - 1) * sizeof(picoos_int16));
+    this->numHist = this->K - 1;
+    this->pos = this->K - 1;
+    this->phase = 0;
+}
+
+picoos_int16 picosigrs_process(picosigrs_Resampler this,
+        const picoos_int16 *in, picoos_int16 numIn, picoos_int16 *out)
+{
+    picoos_int16 numOut, T, drop;
+    picoos_int32 acc;
+
+    T = 2 * this->K;
+    picoos_mem_copy(in, &(this->hist[this->numHist]),
+            numIn * sizeof(picoos_int16));
+    this->numHist += numIn;
+
+    numOut = 0;
+    while (this->pos + this->K < this->numHist) {
+        acc = this->kernels->dot16(&(this->hist[this->pos + 1 - this->K]),
+                &(this->taps[this->phase * T]), T);
+        acc = (acc + (1 << (PICOSIGRS_SHIFT - 1))) >> PICOSIGRS_SHIFT;
+        if (acc > 32767) {
+            acc = 32767;
+        } else if (acc < -32768) {
+            acc = -32768;
+        }
+        out[numOut++] = (picoos_int16) acc;
+        this->phase += this->M;
+        while (this->phase >= this->L) {
+            this->phase -= this->L;
+            this->pos++;
+        }
+    }
+
+    /* keep the 2K - 1 samples at most needed by the next output sample */
+    drop = this->pos + 1 - this->K;
+    if (drop > 0) {
+        this->numHist -= drop;
+        this->pos -= drop;
+        picoos_mem_copy(&(this->hist[drop]), this->hist,
+                this->numHist * sizeof(picoos_int16));
+    }
+    return numOut;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/* end picosigrs.c */
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2024 PicoTTS Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * @file picosigrs.h
+ *
+ * Output resampler of the signal generation
+ *
+ * The signal generation works at 16kHz. With the voice option
+ * PICORSRC_VOPT_SIG_RATE the samples of each frame are converted to
+ * 8, 22.05, 24 or 48kHz before they are put into the FRAME items, so
+ * no resampling pass is needed downstream.
+ *
+ * The conversion by L/M (1/2, 441/320, 3/2, 3/1) is a polyphase FIR
+ * filter: a Kaiser windowed sinc (beta 7, 16 input samples on each
+ * side, cutoff at 0.92 of the lower Nyquist frequency), sampled for
+ * the L phases when the resampler is created, in integers only (Q14,
+ * each phase normalized to unity gain). Each output sample is one dot
+ * product over 32 taps of the int16 input (64 taps for 8kHz), done by
+ * the dot16 kernel of the SIG vector kernels (see picosigk.h). The filter delays the output by 16 input
+ * samples (1ms, 2ms for 8kHz); output sample n is at the exact input
+ * time n * M / L.
+ *
+ * The tables take some 28KB for 22.05kHz and less than 200 bytes for
+ * the other rates (see picosigrs_getMemSize).
+ *
+ * Timing against resampling afterwards: picobench resample
+ */
+
+#ifndef PICOSIGRS_H_
+#define PICOSIGRS_H_
+
+#include "picodefs.h"
+#include "picoos.h"
+#include "picosigk.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if 0
+}
+#endif
+
+/* sample rate of the signal generation */
+#define PICOSIGRS_IN_RATE   16000
+
+/* maximum number of input samples per call of picosigrs_process, and
+   of output samples at the highest output rate (48kHz) */
+#define PICOSIGRS_MAX_IN    64
+#define PICOSIGRS_MAX_OUT   (3 * PICOSIGRS_MAX_IN + 1)
+
+typedef struct picosigrs_resampler * picosigrs_Resampler;
+
+/* TRUE if 'rate' (Hz) is an output rate of the resampler; 16000 is not */
+picoos_bool picosigrs_isSupportedRate(picoos_int32 rate);
+
+/* upper bound of the number of output samples for 'numIn' input samples
+   at output rate 'rate' */
+picoos_int16 picosigrs_getMaxOutput(picoos_int32 rate, picoos_int16 numIn);
+
+/* engine memory needed by a resampler to 'rate', 0 for unsupported
+   rates */
+picoos_objsize_t picosigrs_getMemSize(picoos_int32 rate);
+
+/* creates a resampler from 16kHz to 'rate' whose filter uses the dot16
+   kernel of 'kernels'; NULL if 'rate' is not supported or out of
+   memory */
+picosigrs_Resampler picosigrs_newResampler(picoos_MemoryManager mm,
+        picoos_int32 rate, const picosigk_kernels_t *kernels);
+
+void picosigrs_disposeResampler(picoos_MemoryManager mm,
+        picosigrs_Resampler *this);
+
+/* clears the filter history */
+void picosigrs_reset(picosigrs_Resampler this);
+
+/* resamples 'numIn' (at most PICOSIGRS_MAX_IN) samples from 'in' to 'out'
+   and returns the number of output samples, at most
+   picosigrs_getMaxOutput(rate, numIn) */
+picoos_int16 picosigrs_process(picosigrs_Resampler this,
+        const picoos_int16 *in, picoos_int16 numIn, picoos_int16 *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*PICOSIGRS_H_*/
@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2024 PicoTTS Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * @file picosigts.c
+ *
+ * Time scale modification of the signal generation output (WSOLA)
+ *
+ * With 50% overlap of Hann windows, each output hop is the cross-fade
+ * of the second half of the last segment (its tail) into the first half
+ * of the next one, and the tail is also the natural continuation the
+ * next segment is compared with. The input is kept in a linear buffer
+ * that starts at the search range of the next segment; the nominal
+ * position of the next segment in the buffer is kept in 1/100 samples,
+ * so any tempo in percent is exact over time. Output hops go to a FIFO,
+ * from which no more samples are taken per call than are put in, so the
+ * output of a frame never takes more bytes than at the tempo of the
+ * synthesis.
+ */
+
+#include "picodefs.h"
+#include "picoos.h"
+#include "picodbg.h"
+#include "picosigk.h"
+#include "picosigts.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if 0
+}
+#endif
+
+#define PICOSIGTS_SEG       320 /* segment length, 20ms */
+#define PICOSIGTS_HOP       160 /* output hop, half a segment */
+#define PICOSIGTS_DELTA     128 /* largest shift from the nominal position, 8ms */
+#define PICOSIGTS_COARSE    4   /* shifts between the correlations of the first search */
+#define PICOSIGTS_REF_MAX   128 /* reference magnitude limit: no int32 overflow of the
+                                   dot products of PICOSIGTS_HOP samples */
+
+#define PICOSIGTS_BUF       (2 * PICOSIGTS_DELTA + PICOSIGTS_SEG + PICOSIGTS_MAX_IN)
+#define PICOSIGTS_FIFO      (2 * PICOSIGTS_HOP + PICOSIGTS_MAX_IN)
+
+/* rising half of the Hann window of a segment in Q15; the falling half is
+   32768 minus it, so that the cross-fades have unity gain */
+static const picoos_uint16 sigtsWindow[PICOSIGTS_HOP] = {
+    0, 3, 13, 28, 51, 79, 114, 155, 202, 255,
+    315, 381, 453, 531, 615, 705, 802, 904, 1013, 1127,
+    1247, 1373, 1505, 1643, 1786, 1935, 2089, 2249, 2414, 2585,
+    2761, 2943, 3129, 3321, 3517, 3719, 3926, 4137, 4353, 4574,
+    4799, 5028, 5263, 5501, 5743, 5990, 6241, 6495, 6754, 7016,
+    7282, 7551, 7823, 8099, 8378, 8661, 8946, 9234, 9525, 9818,
+    10114, 10413, 10713, 11016, 11321, 11628, 11937, 12247, 12559, 12873,
+    13188, 13504, 13821, 14139, 14458, 14778, 15099, 15419, 15741, 16062,
+    16384, 16706, 17027, 17349, 17669, 17990, 18310, 18629, 18947, 19264,
+    19580, 19895, 20209, 20521, 20831, 21140, 21447, 21752, 22055, 22355,
+    22654, 22950, 23243, 23534, 23822, 24107, 24390, 24669, 24945, 25217,
+    25486, 25752, 26014, 26273, 26527, 26778, 27025, 27267, 27505, 27740,
+    27969, 28194, 28415, 28631, 28842, 29049, 29251, 29447, 29639, 29825,
+    30007, 30183, 30354, 30519, 30679, 30833, 30982, 31125, 31263, 31395,
+    31521, 31641, 31755, 31864, 31966, 32063, 32153, 32237, 32315, 32387,
+    32453, 32513, 32566, 32613, 32654, 32689, 32717, 32740, 32755, 32765
+};
+
+typedef struct picosigts_stretcher {
+    const picosigk_kernels_t *kernels;
+    picoos_int32 tempo;     /* percent */
+    picoos_int32 nom;       /* nominal position of the next segment in buf,
+                               in 1/100 samples */
+    picoos_int32 skip;      /* input samples to drop before buf starts */
+    picoos_int16 numBuf;    /* samples in buf */
+    picoos_int16 numFifo;   /* samples in fifo */
+    picoos_bool refOn;      /* ref is not silent */
+    picoos_int16 buf[PICOSIGTS_BUF];    /* input */
+    picoos_int16 tail[PICOSIGTS_HOP];   /* second half of the last segment */
+    picoos_int16 ref[PICOSIGTS_HOP];    /* tail scaled below PICOSIGTS_REF_MAX */
+    picoos_int16 fifo[PICOSIGTS_FIFO];  /* output */
+} picosigts_stretcher_t;
+
+picoos_bool picosigts_isSupportedTempo(picoos_int32 tempo)
+{
+    return (tempo >= PICOSIGTS_MIN_TEMPO) && (tempo <= PICOSIGTS_MAX_TEMPO);
+}
+
+picoos_objsize_t picosigts_getMemSize(picoos_int32 tempo)
+{
+    if (!picosigts_isSupportedTempo(tempo)) {
+        return 0;
+    }
+    /* object, plus allocation overhead */
+    return sizeof(picosigts_stretcher_t) + 64;
+}
+
+picosigts_Stretcher picosigts_newStretcher(picoos_MemoryManager mm,
+        picoos_int32 tempo, const picosigk_kernels_t *kernels)
+{
+    picosigts_Stretcher this;
+
+    if (!picosigts_isSupportedTempo(tempo)) {
+        return NULL;
+    }
+    this = (picosigts_Stretcher) picoos_allocate(mm, sizeof(*this));
+    if (NULL == this) {
+        return NULL;
+    }
+    this->kernels = kernels;
+    this->tempo = tempo;
+    picosigts_reset(this);
+    PICODBG_DEBUG(("stretcher to %i%% tempo", tempo));
+    return this;
+}
+
+void picosigts_disposeStretcher(picoos_MemoryManager mm,
+        picosigts_Stretcher *this)
+{
+    if (NULL != *this) {
+        picoos_deallocate(mm, (void *) this);
+    }
+}
+
+void picosigts_reset(picosigts_Stretcher this)
+{
+    /* the first segment fades in from silence at the first input sample */
+    picoos_mem_set(this->tail, 0, sizeof(this->tail));
+    this->refOn = FALSE;
+    this->nom = 0;
+    this->skip = 0;
+    this->numBuf = 0;
+    this->numFifo = 0;
+}
+
+/* the tail scaled for the dot products of the search */
+static void sigtsScaleRef(picosigts_Stretcher this)
+{
+    picoos_int32 i, m, s;
+
+    m = 0;
+    for (i = 0; i < PICOSIGTS_HOP; i++) {
+        if (this->tail[i] > m) {
+            m = this->tail[i];
+        } else if (-this->tail[i] > m) {
+            m = -this->tail[i];
+        }
+    }
+    s = 0;
+    while ((m >> s) >= PICOSIGTS_REF_MAX) {
+        s++;
+    }
+    for (i = 0; i < PICOSIGTS_HOP; i++) {
+        this->ref[i] = (picoos_int16) (this->tail[i] >> s);
+    }
+    this->refOn = ((m >> s) != 0);
+}
+
+/* shift of the segment at 'pos' in buf (-PICOSIGTS_DELTA..PICOSIGTS_DELTA,
+   not before the buffer) whose first half correlates best with the tail;
+   0 for silent tails and on ties */
+static picoos_int32 sigtsSearch(picosigts_Stretcher this, picoos_int32 pos)
+{
+    picoos_int32 lo, from, to, d, coarse, best, c, cBest;
+
+    if (!this->refOn) {
+        return 0;
+    }
+    lo = (pos < PICOSIGTS_DELTA) ? -pos : -PICOSIGTS_DELTA;
+    best = 0;
+    cBest = this->kernels->dot16(&(this->buf[pos]), this->ref, PICOSIGTS_HOP);
+    for (d = lo; d <= PICOSIGTS_DELTA; d += PICOSIGTS_COARSE) {
+        c = this->kernels->dot16(&(this->buf[pos + d]), this->ref, PICOSIGTS_HOP);
+        if (c > cBest) {
+            cBest = c;
+            best = d;
+        }
+    }
+    coarse = best;
+    from = coarse - (PICOSIGTS_COARSE - 1);
+    to = coarse + (PICOSIGTS_COARSE - 1);
+    from = (from < lo) ? lo : from;
+    to = (to > PICOSIGTS_DELTA) ? PICOSIGTS_DELTA : to;
+    for (d = from; d <= to; d++) {
+        if (d != coarse) {
+            c = this->kernels->dot16(&(this->buf[pos + d]), this->ref,
+                    PICOSIGTS_HOP);
+            if (c > cBest) {
+                cBest = c;
+                best = d;
+            }
+        }
+    }
+    return best;
+}
+
+/* the next output hop; buf holds the search range of the segment */
+static void sigtsSegment(picosigts_Stretcher this)
+{
+    picoos_int32 i, pos, drop;
+    const picoos_int16 *seg;
+    picoos_int16 *out;
+
+    pos = this->nom / 100;
+    seg = &(this->buf[pos + sigtsSearch(this, pos)]);
+
+    out = &(this->fifo[this->numFifo]);
+    for (i = 0; i < PICOSIGTS_HOP; i++) {
+        out[i] = (picoos_int16) (((picoos_int32) this->tail[i]
+                * (32768 - sigtsWindow[i])
+                + (picoos_int32) seg[i] * sigtsWindow[i] + (1 << 14)) >> 15);
+    }
+    this->numFifo += PICOSIGTS_HOP;
+    picoos_mem_copy(&(seg[PICOSIGTS_HOP]), this->tail,
+            PICOSIGTS_HOP * sizeof(picoos_int16));
+    sigtsScaleRef(this);
+
+    /* keep the input from the search range of the next segment on */
+    this->nom += PICOSIGTS_HOP * this->tempo;
+    drop = this->nom / 100 - PICOSIGTS_DELTA;
+    if (drop > 0) {
+        this->nom -= drop * 100;
+        if (drop > this->numBuf) {
+            this->skip += drop - this->numBuf;
+            drop = this->numBuf;
+        }
+        this->numBuf -= (picoos_int16) drop;
+        picoos_mem_copy(&(this->buf[drop]), this->buf,
+                this->numBuf * sizeof(picoos_int16));
+    }
+}
+
+picoos_int16 picosigts_process(picosigts_Stretcher this,
+        const picoos_int16 *in, picoos_int16 numIn, picoos_int16 *out)
+{
+    picoos_int16 numOut, n;
+
+    numOut = numIn;
+    n = (this->skip < numIn) ? (picoos_int16) this->skip : numIn;
+    this->skip -= n;
+    picoos_mem_copy(&(in[n]), &(this->buf[this->numBuf]),
+            (numIn - n) * sizeof(picoos_int16));
+    this->numBuf += numIn - n;
+
+    while (this->numBuf >= this->nom / 100 + PICOSIGTS_DELTA + PICOSIGTS_SEG) {
+        sigtsSegment(this);
+    }
+
+    if (numOut > this->numFifo) {
+        numOut = this->numFifo;
+    }
+    picoos_mem_copy(this->fifo, out, numOut * sizeof(picoos_int16));
+    this->numFifo -= numOut;
+    picoos_mem_copy(&(this->fifo[numOut]), this->fifo,
+            this->numFifo * sizeof(picoos_int16));
+    return numOut;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/* end picosigts.c */
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2024 PicoTTS Contributors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * @file picosigts.h
+ *
+ * Time scale modification of the signal generation output (WSOLA)
+ *
+ * With the voice option PICORSRC_VOPT_SIG_TEMPO the 16kHz samples of
+ * each frame are played faster by 101 to 400 percent before they are
+ * resampled and encoded. Unlike <speed> markup, the durations predicted
+ * by PAM and the cepstral trajectories are left as they are; pauses are
+ * shortened by the same factor as speech and the pitch is unchanged.
+ *
+ * WSOLA: output segments of 20ms (Hann window, 10ms hop) are taken from
+ * the input at the nominal position, 10ms times the tempo apart, moved
+ * by up to 8ms so that their first half is most similar (cross
+ * correlation) to the natural continuation of the segment before, which
+ * it is cross-faded with. The search is done on every fourth shift, then
+ * refined around the best one, by the dot16 kernel of the SIG vector
+ * kernels (see picosigk.h), with the reference scaled to 8 bits. In
+ * integers only; some 70 multiply-adds per output sample.
+ *
+ * The signal generation still synthesizes every frame, so this takes
+ * more CPU than the same tempo by <speed> markup, which synthesizes fewer
+ * frames (picobench tempo compares both).
+ *
+ * The output is delayed by 28ms of input at most; at a reset (of the
+ * engine) the delayed samples, part of the final pause, are dropped.
+ * The stretcher takes some 2.7KB of engine memory.
+ */
+
+#ifndef PICOSIGTS_H_
+#define PICOSIGTS_H_
+
+#include "picodefs.h"
+#include "picoos.h"
+#include "picosigk.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if 0
+}
+#endif
+
+/* tempo range in percent; 100 is the tempo of the synthesis */
+#define PICOSIGTS_MIN_TEMPO 101
+#define PICOSIGTS_MAX_TEMPO 400
+
+/* maximum number of input samples per call of picosigts_process */
+#define PICOSIGTS_MAX_IN    64
+
+typedef struct picosigts_stretcher * picosigts_Stretcher;
+
+/* TRUE if 'tempo' (percent) is a tempo of the stretcher; 100 is not */
+picoos_bool picosigts_isSupportedTempo(picoos_int32 tempo);
+
+/* engine memory needed by a stretcher to 'tempo', 0 for unsupported
+   tempos */
+picoos_objsize_t picosigts_getMemSize(picoos_int32 tempo);
+
+/* creates a stretcher to 'tempo' whose search uses the dot16 kernel of
+   'kernels'; NULL if 'tempo' is not supported or out of memory */
+picosigts_Stretcher picosigts_newStretcher(picoos_MemoryManager mm,
+        picoos_int32 tempo, const picosigk_kernels_t *kernels);
+
+void picosigts_disposeStretcher(picoos_MemoryManager mm,
+        picosigts_Stretcher *this);
+
+/* drops the delayed samples */
+void picosigts_reset(picosigts_Stretcher this);
+
+/* time scales 'numIn' (at most PICOSIGTS_MAX_IN) samples from 'in' to
+   'out' (which may be 'in') and returns the number of output samples, at
+   most 'numIn' */
+picoos_int16 picosigts_process(picosigts_Stretcher this,
+        const picoos_int16 *in, picoos_int16 numIn, picoos_int16 *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*PICOSIGTS_H_*/
@@ -196,6 +196,8 @@ typedef struct spho_subobj {
     picotrns_AltDesc altDescBuf;
     /* the number of AltDesc in the buffer */
     picoos_uint16 maxAltDescLen;
+    /* memoized transductions, NULL if not used */
+    picotrns_TransCache transCache;
 
     /* the input to a transducer should not be larger than PICOTRNS_MAX_NUM_POSSYM
      * so the output may expand (up to 4*PICOTRNS_MAX_NUM_POSSYM) */
@@ -350,6 +352,7 @@ static pico_status_t sphoSubObjDeallocate(register picodata_ProcessingUnit this,
         if (NULL != this->subObj) {
             spho = (spho_subobj_t *) (this->subObj);
             picotrns_deallocate_alt_desc_buf(spho->common->mm,&spho->altDescBuf);
+            picotrns_disposeTransCache(spho->common->mm, &spho->transCache);
             picoos_deallocate(mm, (void *) &this->subObj);
         }
     }
@@ -391,6 +394,11 @@ picodata_ProcessingUnit picospho_newSentPhoUnit(picoos_MemoryManager mm,
         picoos_emRaiseException(spho->common->em,PICO_EXC_OUT_OF_MEM, NULL,NULL);
         return NULL;
     }
+#if defined(PICO_USE_TRNS_CACHE)
+    spho->transCache = picotrns_newTransCache(spho->common->mm);
+#else
+    spho->transCache = NULL;
+#endif
 
     sphoInitialize(this, PICO_RESET_FULL);
     return this;
@@ -1231,7 +1239,7 @@ static picodata_step_result_t sphoStep(register picodata_ProcessingUnit this,
                         PICODBG_INFO_MSG(("\n"));
                     }
 #endif
-                    rv = picotrns_transduce(spho->fst[spho->curFst], FALSE,
+                    rv = picotrns_transduceCached(spho->transCache, spho->fst[spho->curFst], FALSE,
                     picotrns_printSolution, spho->phonBuf, spho->phonWritePos, spho->phonBufOut,
                             &spho->phonWritePos,
                             4*PICOTRNS_MAX_NUM_POSSYM, spho->altDescBuf,
@@ -1299,11 +1299,10 @@ static void tok_treatMarkup (picodata_ProcessingUnit this, tok_subobj_t * tok)
 
 static void tok_treatChar (picodata_ProcessingUnit this, tok_subobj_t * tok, picoos_uchar ch, picoos_bool markupHandling)
 {
-    picoos_int32 i, id;
-    picoos_uint8 uval8;
+    picoos_int32 i;
+    picoktab_graph_props_t props;
     pico_tokenType type = PICODATA_ITEMINFO1_TOKTYPE_UNDEFINED;
     pico_tokenSubType subtype = -1;
-    picoos_bool dummy;
     utf8char0c utf2;
     picoos_int32 utf2pos;
 
@@ -1321,15 +1320,12 @@ static void tok_treatChar (picodata_ProcessingUnit this, tok_subobj_t * tok, pic
             break;
         case UTF_CHAR_COMPLETE:
             markupHandling = (markupHandling && (tok->markupHandlingMode == MARKUP_HANDLING_ENABLED));
-            id = picoktab_graphOffset(tok->graphTab, tok->utf);
-            if (id > 0) {
-                if (picoktab_getIntPropTokenType(tok->graphTab, id, &uval8)) {
-                    type = (pico_tokenType)uval8;
-                    if (type == PICODATA_ITEMINFO1_TOKTYPE_LETTERV) {
-                        type = PICODATA_ITEMINFO1_TOKTYPE_LETTER;
-                    }
+            if (picoktab_getGraphProps(tok->graphTab, tok->utf, &props)) {
+                type = (pico_tokenType)props.tokenType;
+                if (type == PICODATA_ITEMINFO1_TOKTYPE_LETTERV) {
+                    type = PICODATA_ITEMINFO1_TOKTYPE_LETTER;
                 }
-                dummy = picoktab_getIntPropTokenSubType(tok->graphTab, id, &subtype);
+                subtype = (pico_tokenSubType)props.tokenSubType;
             } else if (tok->utf[tok->utfpos-1] <= (picoos_uchar)' ') {
                 type = PICODATA_ITEMINFO1_TOKTYPE_SPACE;
                 subtype =  -1;
@@ -595,6 +595,135 @@ pico_status_t picotrns_transduce (picokfst_FST fst, picoos_bool firstSolOnly,
 }
 
 
+/* ******** transduction cache **********/
+
+typedef struct {
+    picokfst_FST fst;                 /* NULL if entry unused */
+    picoos_uint8 firstSolOnly;
+    picoos_uint8 inLen;
+    picoos_uint8 outLen;
+    picoos_int16 inSym[PICOTRNS_CACHE_MAX_INLEN];
+    picoos_int16 outSym[PICOTRNS_CACHE_MAX_OUTLEN];
+    picoos_int8 outRef[PICOTRNS_CACHE_MAX_OUTLEN]; /* input index of output pos, or PICOTRNS_POS_INSERT */
+} trns_cache_entry_t;
+
+typedef struct picotrns_trans_cache {
+    trns_cache_entry_t entry[PICOTRNS_CACHE_ENTRIES];
+    picotrns_possym_t inSeq[PICOTRNS_CACHE_MAX_INLEN]; /* input with positions replaced by indices */
+    picoos_uint32 hits;
+    picoos_uint32 misses;
+} picotrns_trans_cache_t;
+
+
+picotrns_TransCache picotrns_newTransCache(picoos_MemoryManager mm)
+{
+    picotrns_TransCache this;
+    picoos_uint16 i;
+
+    this = (picotrns_TransCache) picoos_allocate(mm, sizeof(picotrns_trans_cache_t));
+    if (NULL != this) {
+        for (i = 0; i < PICOTRNS_CACHE_ENTRIES; i++) {
+            this->entry[i].fst = NULL;
+        }
+        this->hits = 0;
+        this->misses = 0;
+    }
+    return this;
+}
+
+void picotrns_disposeTransCache(picoos_MemoryManager mm, picotrns_TransCache * this)
+{
+    picoos_deallocate(mm, (void *) this);
+}
+
+void picotrns_getTransCacheStats(picotrns_TransCache this, picoos_uint32 * hits, picoos_uint32 * misses)
+{
+    if (NULL == this) {
+        *hits = 0;
+        *misses = 0;
+    } else {
+        *hits = this->hits;
+        *misses = this->misses;
+    }
+}
+
+/* see description in header */
+pico_status_t picotrns_transduceCached(picotrns_TransCache this,
+                                       picokfst_FST fst, picoos_bool firstSolOnly,
+                                       picotrns_printSolutionFct printSolution,
+                                       const picotrns_possym_t inSeq[], picoos_uint16 inSeqLen,
+                                       picotrns_possym_t outSeq[], picoos_uint16 * outSeqLen, picoos_uint16 maxOutSeqLen,
+                                       picotrns_AltDesc altDescBuf, picoos_uint16 maxAltDescLen,
+                                       picoos_uint32 *nrSteps)
+{
+    trns_cache_entry_t * e;
+    picoos_uint32 h;
+    picoos_uint16 i;
+    picoos_int16 ref;
+    pico_status_t status;
+
+    if ((NULL == this) || (inSeqLen > PICOTRNS_CACHE_MAX_INLEN)) {
+        return picotrns_transduce(fst, firstSolOnly, printSolution, inSeq, inSeqLen,
+                                  outSeq, outSeqLen, maxOutSeqLen,
+                                  altDescBuf, maxAltDescLen, nrSteps);
+    }
+
+    /* FNV-1a over the FST and the input symbols */
+    h = 2166136261u ^ (picoos_uint32) (picoos_ptrdiff_t) fst;
+    for (i = 0; i < inSeqLen; i++) {
+        h = (h ^ (picoos_uint16) inSeq[i].sym) * 16777619u;
+    }
+    e = &this->entry[(h ^ (h >> 16)) % PICOTRNS_CACHE_ENTRIES];
+
+    if ((e->fst == fst) && (e->inLen == inSeqLen) && (e->firstSolOnly == firstSolOnly)
+            && (e->outLen <= maxOutSeqLen)) {
+        for (i = 0; (i < inSeqLen) && (e->inSym[i] == inSeq[i].sym); i++) {
+            /* compare */
+        }
+        if (i == inSeqLen) {
+            for (i = 0; i < e->outLen; i++) {
+                outSeq[i].sym = e->outSym[i];
+                ref = e->outRef[i];
+                outSeq[i].pos = (ref >= 0) ? inSeq[ref].pos : ref;
+            }
+            *outSeqLen = e->outLen;
+            *nrSteps = 0;
+            this->hits++;
+            return PICO_OK;
+        }
+    }
+    this->misses++;
+
+    /* transduce with positions replaced by input indices so that the
+       result does not depend on the input positions */
+    for (i = 0; i < inSeqLen; i++) {
+        this->inSeq[i].sym = inSeq[i].sym;
+        this->inSeq[i].pos = i;
+    }
+    status = picotrns_transduce(fst, firstSolOnly, printSolution, this->inSeq, inSeqLen,
+                                outSeq, outSeqLen, maxOutSeqLen,
+                                altDescBuf, maxAltDescLen, nrSteps);
+    if ((PICO_OK == status) && (*outSeqLen <= PICOTRNS_CACHE_MAX_OUTLEN)) {
+        e->fst = fst;
+        e->firstSolOnly = firstSolOnly;
+        e->inLen = (picoos_uint8) inSeqLen;
+        e->outLen = (picoos_uint8) (*outSeqLen);
+        for (i = 0; i < inSeqLen; i++) {
+            e->inSym[i] = inSeq[i].sym;
+        }
+        for (i = 0; i < e->outLen; i++) {
+            e->outSym[i] = outSeq[i].sym;
+            e->outRef[i] = (picoos_int8) outSeq[i].pos;
+        }
+    }
+    for (i = 0; i < *outSeqLen; i++) {
+        ref = outSeq[i].pos;
+        outSeq[i].pos = ((ref >= 0) && (ref < inSeqLen)) ? inSeq[ref].pos : ref;
+    }
+    return status;
+}
+
+
 /**
  * Data structure for picotrns_SimpleTransducer object.
  */
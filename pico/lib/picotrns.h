@@ -145,6 +145,49 @@ pico_status_t picotrns_transduce_sequence(picokfst_FST fst, const picotrns_possy
         picotrns_possym_t outSeq[], picoos_uint16 * outSeqLen);
 */
 
+/* ************************************************************/
+/* transduction cache */
+/* ************************************************************/
+
+/* A transduction cache memoizes the results of picotrns_transduce for
+   (FST, input symbol sequence) in a small direct-mapped table, so that
+   the word-level FSTs of SA and the phoneme FSTs of SPHO are not rerun
+   for recurring words and phrases. The output positions are kept
+   relative to the input, so the input positions are not part of the
+   key. Only sequences of up to PICOTRNS_CACHE_MAX_INLEN input and
+   PICOTRNS_CACHE_MAX_OUTLEN output symbols are cached.
+
+   SA and SPHO each create a cache (about 10KB of engine memory) only
+   when PICO_USE_TRNS_CACHE is defined; the engine memory is enlarged
+   accordingly (PICOCTRL_DEFAULT_ENGINE_SIZE). Without a cache they
+   run uncached.
+   Enable with: -DPICO_USE_TRNS_CACHE=1 */
+
+#define PICOTRNS_CACHE_ENTRIES     64
+#define PICOTRNS_CACHE_MAX_INLEN   24
+#define PICOTRNS_CACHE_MAX_OUTLEN  32
+
+typedef struct picotrns_trans_cache * picotrns_TransCache;
+
+/* returns a new, empty cache or NULL if there is not enough memory */
+picotrns_TransCache picotrns_newTransCache(picoos_MemoryManager mm);
+
+void picotrns_disposeTransCache(picoos_MemoryManager mm, picotrns_TransCache * this);
+
+/* same as picotrns_transduce, using and updating cache 'this' if not NULL;
+   '*nrSteps' is 0 if the result was taken from the cache */
+pico_status_t picotrns_transduceCached(picotrns_TransCache this,
+                                       picokfst_FST fst, picoos_bool firstSolOnly,
+                                       picotrns_printSolutionFct printSolution,
+                                       const picotrns_possym_t inSeq[], picoos_uint16 inSeqLen,
+                                       picotrns_possym_t outSeq[], picoos_uint16 * outSeqLen, picoos_uint16 maxOutSeqLen,
+                                       picotrns_AltDesc altDescBuf, picoos_uint16 maxAltDescLen,
+                                       picoos_uint32 *nrSteps);
+
+/* number of lookups answered from and not found in the cache */
+void picotrns_getTransCacheStats(picotrns_TransCache this, picoos_uint32 * hits, picoos_uint32 * misses);
+
+
 /* copy elements from inSeq to outSeq, ignoring elements with epsilon symbol */
 pico_status_t picotrns_eliminate_epsilons(const picotrns_possym_t inSeq[], picoos_uint16 inSeqLen,
         picotrns_possym_t outSeq[], picoos_uint16 * outSeqLen, picoos_uint16 maxOutSeqLen);
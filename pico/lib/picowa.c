@@ -32,6 +32,7 @@
 #include "picowa.h"
 #include "picoklex.h"
 #include "picokdt.h"
+#include "picodtcache.h"
 #include "picoktab.h"
 
 #ifdef __cplusplus
@@ -196,9 +197,20 @@ static picoos_uint8 waClassifyPos(register picodata_ProcessingUnit this,
     picokdt_classify_result_t dtres;
     picoos_uint8 specchar;
     picoos_uint16 i;
+    picodt_cache_t *dtCache = this->voice->dtCache;
+    picoos_uint8 dtCached;
+    picoos_uint32 hash = 0;
 
     PICODBG_DEBUG(("graphlen %d", graphlen));
 
+    /* the input vector only depends on the graph (specchar included) */
+    dtCached = FALSE;
+    if (picodt_cache_is_enabled(dtCache)) {
+        hash = picodt_compute_extended_hash(graph, graphlen);
+        dtCached = picodt_cache_lookup(dtCache, PICOKNOW_KBID_DT_POSP, graph,
+                                       graphlen, hash, &dtres, NULL);
+    }
+
     /* check existence of special char (e.g. hyphen) in graph:
        for now, check existence of hard-coded ascii hyphen,
        ie. preproc needs to match all UTF8 hyphens to the ascii
@@ -213,7 +225,8 @@ static picoos_uint8 waClassifyPos(register picodata_ProcessingUnit this,
     }
 
     /* construct input vector, which is set in dtposp */
-    if (!picokdt_dtPosPconstructInVec(wa->dtposp, graph, graphlen, specchar)) {
+    if (!dtCached &&
+        !picokdt_dtPosPconstructInVec(wa->dtposp, graph, graphlen, specchar)) {
         /* error constructing invec */
         PICODBG_WARN(("problem with invec"));
         picoos_emRaiseWarning(this->common->em, PICO_WARN_INVECTOR, NULL, NULL);
@@ -221,7 +234,7 @@ static picoos_uint8 waClassifyPos(register picodata_ProcessingUnit this,
     }
 
     /* classify */
-    if (!picokdt_dtPosPclassify(wa->dtposp)) {
+    if (!dtCached && !picokdt_dtPosPclassify(wa->dtposp)) {
         /* error doing classification */
         PICODBG_WARN(("problem classifying"));
         picoos_emRaiseWarning(this->common->em, PICO_WARN_CLASSIFICATION,
@@ -230,13 +243,17 @@ static picoos_uint8 waClassifyPos(register picodata_ProcessingUnit this,
     }
 
     /* decompose */
-    if (!picokdt_dtPosPdecomposeOutClass(wa->dtposp, &dtres)) {
+    if (!dtCached && !picokdt_dtPosPdecomposeOutClass(wa->dtposp, &dtres)) {
         /* error decomposing */
         PICODBG_WARN(("problem decomposing"));
         picoos_emRaiseWarning(this->common->em, PICO_WARN_OUTVECTOR,
                               NULL, NULL);
         return PICODATA_ITEMINFO1_ERR;
     }
+    if (!dtCached && picodt_cache_is_enabled(dtCache)) {
+        picodt_cache_insert(dtCache, PICOKNOW_KBID_DT_POSP, graph, graphlen,
+                            hash, &dtres, 0);
+    }
 
     if (dtres.set) {
         PICODBG_DEBUG(("class %d", dtres.class));
@@ -45,6 +45,7 @@
 #include <cutils/jstring.h>
 #include <picoapi.h>
 #include <picodefs.h>
+#include <picoextapi.h>
 
 #include "svox_ssml_parser.h"
 
@@ -65,6 +66,8 @@ using namespace android;
 #define PICO_MAX_VOLUME     500
 #define PICO_DEF_VOLUME     100
 
+#define PICO_DEF_OUTPUT_RATE    16000
+
 /* string constants */
 #define MAX_OUTBUF_SIZE     128
 const char * PICO_SYSTEM_LINGWARE_PATH      = "/system/tts/lang_pico/";
@@ -114,6 +117,7 @@ char *  picoProp_currLang   = NULL;                 /* current language */
 int     picoProp_currRate   = PICO_DEF_RATE;        /* current rate     */
 int     picoProp_currPitch  = PICO_DEF_PITCH;       /* current pitch    */
 int     picoProp_currVolume = PICO_DEF_VOLUME;      /* current volume   */
+int     picoOutputRate      = PICO_DEF_OUTPUT_RATE; /* output sample rate */
 
 int picoCurrentLangIndex = -1;
 
@@ -477,6 +481,16 @@ static tts_result doLanguageSwitchFromLangIndex( int langIndex )
         return TTS_FAILURE;
     }
 
+    /* Set the output sample rate. */
+    ret = picoext_setVoiceOption( picoSystem, (const pico_Char *) PICO_VOICE_NAME,
+            PICOEXT_VOICEOPT_SIG_RATE, picoOutputRate );
+    if (PICO_OK != ret) {
+        ALOGE("Failed to set the output rate %d for %s [%d]", picoOutputRate, picoSupportedLang[langIndex], ret);
+        cleanResources();
+        cleanFiles();
+        return TTS_FAILURE;
+    }
+
     ret = pico_newEngine( picoSystem, (const pico_Char *) PICO_VOICE_NAME, &picoEngine );
     if (PICO_OK != ret) {
         ALOGE("Failed to create engine for %s [%d]", picoSupportedLang[langIndex], ret);
@@ -493,6 +507,45 @@ static tts_result doLanguageSwitchFromLangIndex( int langIndex )
 }
 
 
+/** doOutputRateSwitch
+ *  Switch to the requested output sample rate.
+ *  The engine of a loaded locale is re-created with the new rate, else the rate
+ *  takes effect when a locale is loaded.
+ *  @rate -  the output sample rate: 8000, 16000, 22050, 24000 or 48000
+ *  return TTS_SUCCESS or TTS_FAILURE
+*/
+static tts_result doOutputRateSwitch( int rate )
+{
+    int ret;                                        /* function result code */
+
+    if ((rate != 8000) && (rate != 16000) && (rate != 22050) && (rate != 24000)
+            && (rate != 48000)) {
+        return TTS_FAILURE;
+    }
+    if (rate == picoOutputRate) {
+        return TTS_SUCCESS;
+    }
+    picoOutputRate = rate;
+    if (picoEngine == NULL) {
+        return TTS_SUCCESS;
+    }
+
+    pico_disposeEngine( picoSystem, &picoEngine );
+    ret = picoext_setVoiceOption( picoSystem, (const pico_Char *) PICO_VOICE_NAME,
+            PICOEXT_VOICEOPT_SIG_RATE, picoOutputRate );
+    if (PICO_OK == ret) {
+        ret = pico_newEngine( picoSystem, (const pico_Char *) PICO_VOICE_NAME, &picoEngine );
+    }
+    if (PICO_OK != ret) {
+        ALOGE("Failed to create engine with output rate %d [%d]", picoOutputRate, ret);
+        cleanResources();
+        cleanFiles();
+        return TTS_FAILURE;
+    }
+    return TTS_SUCCESS;
+}
+
+
 /** doLanguageSwitch
  *  Switch to the requested locale.
  *  If this locale is already loaded, it returns immediately.
@@ -1293,9 +1346,12 @@ tts_result TtsEngine::getLanguage(char *language, char *country, char *variant)
 tts_result TtsEngine::setAudioFormat(tts_audio_format& encoding, uint32_t& rate,
             int& channels)
 {
-    // ignore the input parameters, the enforced audio parameters are fixed here
+    // the encoding and channels are fixed here; the rate is used if supported
     encoding = TTS_AUDIO_FORMAT_PCM_16_BIT;
-    rate = 16000;
+    if ((doOutputRateSwitch(rate) != TTS_SUCCESS) && (rate == picoOutputRate)) {
+        return TTS_FAILURE;     /* supported rate, but the engine failed */
+    }
+    rate = picoOutputRate;
     channels = 1;
     return TTS_SUCCESS;
 }
@@ -1585,7 +1641,7 @@ tts_result TtsEngine::synthesizeText( const char * text, int8_t * buffer, size_t
                     bufused += bytes_recv;
                 } else {
                     /* The buffer filled; pass this on to the callback function.    */
-                    cbret = picoSynthDoneCBPtr(userdata, 16000, TTS_AUDIO_FORMAT_PCM_16_BIT, 1, buffer,
+                    cbret = picoSynthDoneCBPtr(userdata, picoOutputRate, TTS_AUDIO_FORMAT_PCM_16_BIT, 1, buffer,
                             bufused, TTS_SYNTH_PENDING);
                     if (cbret == TTS_CALLBACK_HALT) {
                         ALOGI("Halt requested by caller. Halting.");
@@ -1601,9 +1657,9 @@ tts_result TtsEngine::synthesizeText( const char * text, int8_t * buffer, size_t
         } while (PICO_STEP_BUSY == ret);
 
         /* This chunk of synthesis is finished; pass the remaining samples.
-           Use 16 KHz, 16-bit samples.                                              */
+           Use 16-bit samples at the output rate.                                   */
         if (!picoSynthAbort) {
-            picoSynthDoneCBPtr( userdata, 16000, TTS_AUDIO_FORMAT_PCM_16_BIT, 1, buffer, bufused,
+            picoSynthDoneCBPtr( userdata, picoOutputRate, TTS_AUDIO_FORMAT_PCM_16_BIT, 1, buffer, bufused,
                     TTS_SYNTH_PENDING);
         }
         picoSynthAbort = 0;
@@ -1616,7 +1672,7 @@ tts_result TtsEngine::synthesizeText( const char * text, int8_t * buffer, size_t
                 free(local_text);
             }
             ALOGV("Synth loop: sending TTS_SYNTH_DONE after error");
-            picoSynthDoneCBPtr( userdata, 16000, TTS_AUDIO_FORMAT_PCM_16_BIT, 1, buffer, bufused,
+            picoSynthDoneCBPtr( userdata, picoOutputRate, TTS_AUDIO_FORMAT_PCM_16_BIT, 1, buffer, bufused,
                     TTS_SYNTH_DONE);
             pico_resetEngine( picoEngine, PICO_RESET_SOFT );
             return TTS_FAILURE;
@@ -1625,7 +1681,7 @@ tts_result TtsEngine::synthesizeText( const char * text, int8_t * buffer, size_t
 
     /* Synthesis is done; notify the caller */
     ALOGV("Synth loop: sending TTS_SYNTH_DONE after all done, or was asked to stop");
-    picoSynthDoneCBPtr( userdata, 16000, TTS_AUDIO_FORMAT_PCM_16_BIT, 1, buffer, bufused,
+    picoSynthDoneCBPtr( userdata, picoOutputRate, TTS_AUDIO_FORMAT_PCM_16_BIT, 1, buffer, bufused,
             TTS_SYNTH_DONE);
 
     if (local_text) {